@@ -160,6 +160,8 @@ struct _TAG_OA_HASH_DCPT
     // fields updated by the TCPIP_OAHASH_Initialize()
     // and maintained by the hash itself  
     size_t                  fullSlots;  // number of elements/slots having valid data                         
+    size_t                  maxProbes;  // highest probeCount of the entries inserted
+                                        // a look up stops after that many probes
 };
 
 
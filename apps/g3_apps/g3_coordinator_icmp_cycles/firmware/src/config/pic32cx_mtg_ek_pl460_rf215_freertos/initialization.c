@@ -340,6 +340,26 @@ const TCPIP_IPV6_MODULE_CONFIG  tcpipIPv6InitData =
 
 
 
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+const TCPIP_STACK_HEAP_SLAB_ENTRY tcpipHeapSlabEntries[] =
+{
+    { .blockSize = TCPIP_STACK_HEAP_SLAB_SMALL_SIZE, .nBlocks = TCPIP_STACK_HEAP_SLAB_SMALL_BLOCKS },
+    { .blockSize = TCPIP_STACK_HEAP_SLAB_MEDIUM_SIZE, .nBlocks = TCPIP_STACK_HEAP_SLAB_MEDIUM_BLOCKS },
+    { .blockSize = TCPIP_STACK_HEAP_SLAB_LARGE_SIZE, .nBlocks = TCPIP_STACK_HEAP_SLAB_LARGE_BLOCKS },
+};
+
+TCPIP_STACK_HEAP_SLAB_CONFIG tcpipHeapConfig =
+{
+    .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB,
+    .heapFlags = TCPIP_STACK_HEAP_USE_FLAGS,
+    .heapUsage = TCPIP_STACK_HEAP_USAGE_CONFIG,
+    .malloc_fnc = TCPIP_STACK_MALLOC_FUNC,
+    .free_fnc = TCPIP_STACK_FREE_FUNC,
+    .heapSize = TCPIP_STACK_DRAM_SIZE,
+    .nSlabEntries = sizeof(tcpipHeapSlabEntries) / sizeof(*tcpipHeapSlabEntries),
+    .pSlabEntries = tcpipHeapSlabEntries,
+};
+#else
 TCPIP_STACK_HEAP_INTERNAL_CONFIG tcpipHeapConfig =
 {
     .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP,
@@ -349,6 +369,7 @@ TCPIP_STACK_HEAP_INTERNAL_CONFIG tcpipHeapConfig =
     .free_fnc = TCPIP_STACK_FREE_FUNC,
     .heapSize = TCPIP_STACK_DRAM_SIZE,
 };
+#endif  // defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
 
 
 const TCPIP_NETWORK_CONFIG __attribute__((unused))  TCPIP_HOSTS_CONFIGURATION[] =
@@ -76,6 +76,26 @@ static void _APP_CYCLES_NextPacket(void);
 // *****************************************************************************
 // *****************************************************************************
 
+#if SYS_CONSOLE_DEVICE_MAX_INSTANCES > 0U
+static void _APP_CYCLES_ShowHeapUsage(void)
+{
+    TCPIP_STACK_HEAP_HANDLE heapH;
+
+    heapH = TCPIP_STACK_HeapHandleGet(TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP, 0);
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+    if (heapH == 0)
+    {
+        heapH = TCPIP_STACK_HeapHandleGet(TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB, 0);
+    }
+#endif
+
+    SYS_DEBUG_PRINT(SYS_ERROR_INFO, "APP_CYCLES: TCP/IP heap free %u bytes (max block %u, "
+            "watermark %u, fragmentation %u %%)\r\n",
+            (unsigned int)TCPIP_STACK_HEAP_FreeSize(heapH), (unsigned int)TCPIP_STACK_HEAP_MaxSize(heapH),
+            (unsigned int)TCPIP_STACK_HEAP_HighWatermark(heapH), TCPIP_STACK_HEAP_FragmentationIndex(heapH));
+}
+#endif
+
 #if SYS_CONSOLE_DEVICE_MAX_INSTANCES > 0U
 static void _APP_CYCLES_ShowReport(void)
 {
@@ -84,6 +104,7 @@ static void _APP_CYCLES_ShowReport(void)
             app_cyclesData.cycleIndex, SYS_TIME_CountToMS(app_cyclesData.timeCountTotalCycle),
             SYS_TIME_CountToMS(app_cyclesData.timeCountTotal / (app_cyclesData.cycleIndex + 1)),
             SYS_TIME_CountToMS(app_cyclesData.timeCountTotalCycle / app_cyclesData.numDevicesJoined));
+    _APP_CYCLES_ShowHeapUsage();
 
     /* Print summary of each device in tasks to avoid console buffer to be
      * full */
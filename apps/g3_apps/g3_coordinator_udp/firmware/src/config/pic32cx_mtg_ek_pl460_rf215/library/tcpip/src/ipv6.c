@@ -211,6 +211,11 @@ static void TCPIP_IPV6_ProcessPackets(void);
 
 static void TCPIP_IPV6_Process (TCPIP_NET_IF * pNetIf, TCPIP_MAC_PACKET* pRxPkt);
 
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+static IPV6_TX_TEMPLATE*    TCPIP_IPV6_TxTemplateFind(IPV6_PACKET * ptrPacket, const IPV6_ADDR * dest);
+static IPV6_TX_TEMPLATE*    TCPIP_IPV6_TxTemplateStore(IPV6_PACKET * ptrPacket, const IPV6_ADDR * dest);
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+
 
 // ipv6_manager.h
 bool TCPIP_IPV6_Initialize(const TCPIP_STACK_MODULE_CTRL* const pStackInit, const TCPIP_IPV6_MODULE_CONFIG* pIpv6Init)
@@ -403,6 +408,7 @@ void TCPIP_IPV6_Deinitialize(const TCPIP_STACK_MODULE_CTRL* const stackCtrl)
     {
         pNetIf = stackCtrl->pNetIf;
         TCPIP_IPV6_InitializeStop (pNetIf);
+        TCPIP_NDP_CacheIndexClear (pNetIf);
         TCPIP_IPV6_FreeConfigLists (ipv6Config + stackCtrl->netIx);
         pNetIf->Flags.bIPv6Enabled = false;
 
@@ -526,6 +532,7 @@ static void TCPIP_IPV6_InitializeTask (void)
                     TCPIP_IPV6_InitializeStop (pNetIf);
                     break;
                 case IPV6_INIT_STATE_FAIL:
+                    TCPIP_NDP_CacheIndexClear (pNetIf);
                     TCPIP_IPV6_FreeConfigLists (pIpv6Config);
                     TCPIP_IPV6_InitializeStop (pNetIf);
                     pNetIf->Flags.bIPv6Enabled = 0;
@@ -1074,6 +1081,78 @@ unsigned short TCPIP_IPV6_PseudoHeaderChecksumGet (IPV6_PACKET * ptrPacket)
     return 0;
 }
 
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+// TX header templates
+// A template is selected by the last 2 bytes of the destination address
+// (the G3-PLC short address) and the upper layer protocol.
+// A template is valid as long as the unicast address list of the interface
+// is not changed; any change invalidates all the interface templates.
+static IPV6_TX_TEMPLATE* TCPIP_IPV6_TxTemplateSlot(IPV6_PACKET * ptrPacket, const IPV6_ADDR * dest)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = ipv6Config + TCPIP_STACK_NetIxGet((TCPIP_NET_IF*)ptrPacket->netIfH);
+    uint32_t slotIx = (((uint32_t)dest->v[14] << 8) | dest->v[15]) + ptrPacket->upperLayerHeaderType;
+
+    return pIpv6Config->txTemplate + (slotIx % TCPIP_IPV6_TX_TEMPLATE_ENTRIES);
+}
+
+// returns the valid template matching this packet
+// or NULL if the source address selection has to be run
+static IPV6_TX_TEMPLATE* TCPIP_IPV6_TxTemplateFind(IPV6_PACKET * ptrPacket, const IPV6_ADDR * dest)
+{
+    IPV6_TX_TEMPLATE* pTmpl = TCPIP_IPV6_TxTemplateSlot(ptrPacket, dest);
+
+    if (pTmpl->inUse == 0 || pTmpl->nextHeader != ptrPacket->upperLayerHeaderType)
+    {
+        return NULL;
+    }
+
+    if (pTmpl->addGen != (ipv6Config + TCPIP_STACK_NetIxGet((TCPIP_NET_IF*)ptrPacket->netIfH))->addGen)
+    {   // the address list changed
+        pTmpl->inUse = 0;
+        return NULL;
+    }
+
+    if (memcmp(&pTmpl->destAddress, dest, sizeof (IPV6_ADDR)) != 0)
+    {
+        return NULL;
+    }
+
+    if (ptrPacket->flags.sourceSpecified)
+    {   // the requested source has to match the template one
+        if (ptrPacket->flags.useUnspecAddr || memcmp(&pTmpl->sourceAddress, TCPIP_IPV6_SourceAddressGet(ptrPacket), sizeof (IPV6_ADDR)) != 0)
+        {
+            return NULL;
+        }
+    }
+
+    return pTmpl;
+}
+
+// stores the selected source address and the pseudo header sum
+// of the fixed fields for this packet destination
+static IPV6_TX_TEMPLATE* TCPIP_IPV6_TxTemplateStore(IPV6_PACKET * ptrPacket, const IPV6_ADDR * dest)
+{
+    IPV6_PSEUDO_HEADER pseudoHeader;
+    IPV6_TX_TEMPLATE* pTmpl = TCPIP_IPV6_TxTemplateSlot(ptrPacket, dest);
+
+    memcpy(&pTmpl->destAddress, dest, sizeof (IPV6_ADDR));
+    memcpy(&pTmpl->sourceAddress, TCPIP_IPV6_SourceAddressGet(ptrPacket), sizeof (IPV6_ADDR));
+    pTmpl->nextHeader = ptrPacket->upperLayerHeaderType;
+    pTmpl->addGen = (ipv6Config + TCPIP_STACK_NetIxGet((TCPIP_NET_IF*)ptrPacket->netIfH))->addGen;
+
+    pseudoHeader.zero1 = 0;
+    pseudoHeader.zero2 = 0;
+    pseudoHeader.PacketLength = 0;
+    pseudoHeader.NextHeader = pTmpl->nextHeader;
+    memcpy((void *)&pseudoHeader.SourceAddress, (void *)&pTmpl->sourceAddress, sizeof (IPV6_ADDR));
+    memcpy((void *)&pseudoHeader.DestAddress, (void *)&pTmpl->destAddress, sizeof (IPV6_ADDR));
+    pTmpl->pseudoSum = ~TCPIP_Helper_CalcIPChecksum ((void *)&pseudoHeader, sizeof (pseudoHeader), 0);
+    pTmpl->inUse = 1;
+
+    return pTmpl;
+}
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+
 
 // ipv6_manager.h
 void TCPIP_IPV6_HopLimitSet(IPV6_PACKET * ptrPacket, uint8_t hopLimit)
@@ -1180,6 +1259,11 @@ int TCPIP_IPV6_Flush (IPV6_PACKET * ptrPacket)
     uint16_t *  checksumPointer;
     bool        toTxPkt = false;
     bool        mcastPkt = false;
+    bool        srcSelect = true;
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+    IPV6_TX_TEMPLATE* pTmpl;
+    bool        tmplStore;
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
 
     if(ptrPacket == 0 || ptrPacket->flags.addressType != IP_ADDRESS_TYPE_IPV6)
     {
@@ -1201,8 +1285,22 @@ int TCPIP_IPV6_Flush (IPV6_PACKET * ptrPacket)
     if (ptrIpHeader->HopLimit == 0)
         ptrIpHeader->HopLimit = (ipv6Config + TCPIP_STACK_NetIxGet((TCPIP_NET_IF*)ptrPacket->netIfH))->curHopLimit;
 
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+    if ((pTmpl = TCPIP_IPV6_TxTemplateFind(ptrPacket, destinationAddress)) != NULL)
+    {   // source address already selected for this destination
+        if (!ptrPacket->flags.sourceSpecified)
+        {
+            TCPIP_IPV6_SourceAddressSet(ptrPacket, &pTmpl->sourceAddress);
+        }
+        srcSelect = false;
+    }
+    // only the default source selection is stored; a source specified
+    // by the caller is matched against the template but never replaces it
+    tmplStore = srcSelect && !ptrPacket->flags.sourceSpecified;
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+
     // Check to see if a source address was specified
-    if (ptrPacket->flags.sourceSpecified)
+    if (srcSelect && ptrPacket->flags.sourceSpecified)
     {
         if (ptrPacket->flags.useUnspecAddr)
         {
@@ -1219,7 +1317,7 @@ int TCPIP_IPV6_Flush (IPV6_PACKET * ptrPacket)
         }
     }
 
-    if (!ptrPacket->flags.sourceSpecified)
+    if (srcSelect && !ptrPacket->flags.sourceSpecified)
     {
         sourceAddress = TCPIP_IPV6_DASSourceAddressSelect (ptrPacket->netIfH, destinationAddress, NULL);
         if (sourceAddress != NULL)
@@ -1235,6 +1333,13 @@ int TCPIP_IPV6_Flush (IPV6_PACKET * ptrPacket)
         }
     }
 
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+    if (tmplStore)
+    {
+        pTmpl = TCPIP_IPV6_TxTemplateStore(ptrPacket, destinationAddress);
+    }
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+
     if (ptrPacket->upperLayerChecksumOffset != IPV6_NO_UPPER_LAYER_CHECKSUM)
     {
         checksumPointer = TCPIP_IPV6_DataSegmentContentsGetByType (ptrPacket, TYPE_IPV6_UPPER_LAYER_HEADER);
@@ -1243,7 +1348,17 @@ int TCPIP_IPV6_Flush (IPV6_PACKET * ptrPacket)
             if((((TCPIP_NET_IF*)ptrPacket->netIfH)->txOffload & TCPIP_MAC_CHECKSUM_IPV6) == 0)
             {
                 checksumPointer = (uint16_t *)(((uint8_t *)checksumPointer) + ptrPacket->upperLayerChecksumOffset);
-                *checksumPointer = ~TCPIP_IPV6_PseudoHeaderChecksumGet (ptrPacket);
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+                if (pTmpl != NULL)
+                {   // only the length is added to the template sum
+                    uint16_t pktLen = TCPIP_Helper_htons (ptrPacket->upperLayerHeaderLen + ptrPacket->payloadLen);
+                    *checksumPointer = ~TCPIP_Helper_CalcIPChecksum ((uint8_t*)&pktLen, sizeof (pktLen), pTmpl->pseudoSum);
+                }
+                else
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+                {
+                    *checksumPointer = ~TCPIP_IPV6_PseudoHeaderChecksumGet (ptrPacket);
+                }
                 *checksumPointer = TCPIP_IPV6_PayloadChecksumCalculate (ptrPacket);
             }
             else
@@ -1792,6 +1907,7 @@ void TCPIP_IPV6_FreeConfigLists (IPV6_INTERFACE_CONFIG * pNetIf)
     TCPIP_IPV6_DoubleListFree(&pNetIf->listIpv6UnicastAddresses);
     TCPIP_IPV6_DoubleListFree(&pNetIf->listIpv6MulticastAddresses);
     TCPIP_IPV6_DoubleListFree(&pNetIf->listIpv6TentativeAddresses);
+    pNetIf->addGen++;
 }
 
 
@@ -3070,9 +3186,10 @@ void TCPIP_IPV6_TimestampsTaskUpdate (void)
                 {
                     ptrAddress->preferredLifetime -= timeElapsed;
                 }
-                else
-                {
+                else if (ptrAddress->preferredLifetime != 0)
+                {   // address becomes deprecated
                     ptrAddress->preferredLifetime = 0;
+                    pIpv6Config->addGen++;
                 }
                 if (timeElapsed < ptrAddress->validLifetime)
                 {
@@ -137,6 +137,11 @@ TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_Create(const TCPIP_STACK_HEAP_CONFIG* initDat
                 return TCPIP_HEAP_CreateInternalPool((const TCPIP_STACK_HEAP_POOL_CONFIG*)initData, pRes);
 #endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
 
+#if defined (TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+            case TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB:
+                return TCPIP_HEAP_CreateInternalSlab((const TCPIP_STACK_HEAP_SLAB_CONFIG*)initData, pRes);
+#endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+
             default:
                 break;
         }
@@ -176,6 +181,12 @@ size_t TCPIP_HEAP_FreeOutline(TCPIP_STACK_HEAP_HANDLE h, const void* ptr)
     #undef  _TCPIP_STACK_DRAM_TRACE_ENABLE
 #endif
 
+#if defined(_TCPIP_STACK_DRAM_TRACE_ENABLE) && defined(TCPIP_STACK_DRAM_TRACE_LOG_SIZE) && (TCPIP_STACK_DRAM_TRACE_LOG_SIZE != 0)
+    #define _TCPIP_STACK_DRAM_TRACE_LOG_ENABLE
+#else
+    #undef  _TCPIP_STACK_DRAM_TRACE_LOG_ENABLE
+#endif
+
 #if defined(TCPIP_STACK_DRAM_DIST_ENABLE) 
     #define _TCPIP_STACK_DRAM_DIST_ENABLE
 
@@ -203,6 +214,12 @@ typedef struct
 #if defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
     TCPIP_HEAP_TRACE_ENTRY      _heapTraceTbl[TCPIP_STACK_DRAM_TRACE_SLOTS];
 #endif
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+    TCPIP_HEAP_TRACE_RECORD     _heapTraceLog[TCPIP_STACK_DRAM_TRACE_LOG_SIZE];
+    uint32_t                    logWrIx;        // total number of records written
+    uint32_t                    logRdIx;        // total number of records read
+    uint32_t                    logLost;        // records dropped because the log was full
+#endif
 #if defined(_TCPIP_STACK_DRAM_DIST_ENABLE)
     TCPIP_HEAP_DIST_ENTRY _tcpip_heap_dist_array[sizeof(_tcpip_heap_dist_sizes)/sizeof(*_tcpip_heap_dist_sizes) - 1];
 #endif
@@ -220,6 +237,10 @@ static TCPIP_HEAP_DBG_DCPT      _tcpipHeapDbgDcpt[TCPIP_STACK_SUPPORTED_HEAPS] =
     static void TCPIP_HEAP_RemoveFromEntry(TCPIP_HEAP_DBG_DCPT* hDcpt, int moduleId, size_t nBytes);
 #endif  // defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
 
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+    static void TCPIP_HEAP_TraceLogAdd(TCPIP_HEAP_DBG_DCPT* hDcpt, TCPIP_HEAP_TRACE_OP op, int moduleId, int lineNo, size_t nBytes, const void* ptr);
+#endif  // defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+
 #if defined(_TCPIP_STACK_DRAM_DIST_ENABLE)
 static int TCPIP_HEAP_DistCompare(const void *a, const void *b);
 static void TCPIP_HEAP_DistAdd(TCPIP_HEAP_DBG_DCPT* hDcpt, int moduleId, size_t nBytes);
@@ -262,6 +283,13 @@ TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_Create(const TCPIP_STACK_HEAP_CONFIG* initDat
             break;
 #endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
 
+#if defined (TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+        case TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB:
+            newH = TCPIP_HEAP_CreateInternalSlab((const TCPIP_STACK_HEAP_SLAB_CONFIG*)initData, pRes);
+            flags = initData->heapFlags;
+            break;
+#endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+
         default:
             return 0;
     }
@@ -280,6 +308,9 @@ TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_Create(const TCPIP_STACK_HEAP_CONFIG* initDat
 #if defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
                 memset(pDcpt->_heapTraceTbl, 0, sizeof(pDcpt->_heapTraceTbl)); // clear entries
 #endif
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+                pDcpt->logWrIx = pDcpt->logRdIx = pDcpt->logLost = 0;
+#endif
 #if defined(_TCPIP_STACK_DRAM_DIST_ENABLE)
                 // initialize the distribution sizes array
                 int ix;
@@ -370,6 +401,9 @@ void* TCPIP_HEAP_MallocDebug(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes, int m
         {
             nBytes = (*hObj->TCPIP_HEAP_AllocSize)(hObj, ptr);
         }
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+        TCPIP_HEAP_TraceLogAdd(pDcpt, ptr != 0 ? TCPIP_HEAP_TRACE_OP_ALLOC : TCPIP_HEAP_TRACE_OP_FAIL, moduleId, lineNo, nBytes, ptr);
+#endif  // defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
         TCPIP_HEAP_AddToEntry(pDcpt, moduleId, nBytes, ptr);
     }
 #endif  // defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
@@ -415,6 +449,9 @@ void* TCPIP_HEAP_CallocDebug(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_
         {
             nBytes = (*hObj->TCPIP_HEAP_AllocSize)(hObj, ptr);
         }
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+        TCPIP_HEAP_TraceLogAdd(pDcpt, ptr != 0 ? TCPIP_HEAP_TRACE_OP_ALLOC : TCPIP_HEAP_TRACE_OP_FAIL, moduleId, lineNo, nBytes, ptr);
+#endif  // defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
         TCPIP_HEAP_AddToEntry(pDcpt, moduleId, nBytes, ptr);
     }
 #endif  // defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
@@ -442,6 +479,9 @@ size_t TCPIP_HEAP_FreeDebug(TCPIP_STACK_HEAP_HANDLE heapH,  const void* pBuff, i
     if(pDcpt && nBytes)
     {
         TCPIP_HEAP_RemoveFromEntry(pDcpt, moduleId, nBytes);
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+        TCPIP_HEAP_TraceLogAdd(pDcpt, TCPIP_HEAP_TRACE_OP_FREE, moduleId, 0, nBytes, pBuff);
+#endif  // defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
     }
 #endif  // defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
 #if defined(_TCPIP_STACK_DRAM_DIST_ENABLE)
@@ -512,6 +552,10 @@ static void TCPIP_HEAP_AddToEntry(TCPIP_HEAP_DBG_DCPT* hDcpt, int moduleId, size
         {   // successful
             pEntry->totAllocated += nBytes;
             pEntry->currAllocated += nBytes;
+            if(pEntry->currAllocated > pEntry->peakAllocated)
+            {
+                pEntry->peakAllocated = pEntry->currAllocated;
+            }
         }
         else
         {
@@ -602,6 +646,78 @@ unsigned int TCPIP_HEAP_TraceGetEntriesNo(TCPIP_STACK_HEAP_HANDLE heapH, bool ge
 
 #endif  // defined(_TCPIP_STACK_DRAM_TRACE_ENABLE)
 
+#if defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+// nBytes is the block size for alloc and free operations, the requested size for a failed one
+static void TCPIP_HEAP_TraceLogAdd(TCPIP_HEAP_DBG_DCPT* hDcpt, TCPIP_HEAP_TRACE_OP op, int moduleId, int lineNo, size_t nBytes, const void* ptr)
+{
+    TCPIP_HEAP_TRACE_RECORD* pRec;
+
+    // the log is shared by all the heap users; the heap lock is already released here
+    OSAL_CRITSECT_DATA_TYPE status = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    if(hDcpt->logWrIx - hDcpt->logRdIx >= sizeof(hDcpt->_heapTraceLog)/sizeof(*hDcpt->_heapTraceLog))
+    {   // full; drop it so that the log stays a replayable sequence
+        hDcpt->logLost++;
+    }
+    else
+    {
+        pRec = hDcpt->_heapTraceLog + (hDcpt->logWrIx % (sizeof(hDcpt->_heapTraceLog)/sizeof(*hDcpt->_heapTraceLog)));
+        pRec->op = (uint8_t)op;
+        pRec->moduleId = (uint8_t)moduleId;
+        pRec->lineNo = (uint16_t)lineNo;
+        pRec->nBytes = nBytes > 0xffff ? 0xffff : (uint16_t)nBytes;
+        pRec->blockOffset = ptr == 0 ? 0 : (uint16_t)(((uintptr_t)ptr - (uintptr_t)hDcpt->heapH) >> 2);
+        hDcpt->logWrIx++;
+    }
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, status);
+}
+
+unsigned int TCPIP_HEAP_TraceLogRead(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int nRecords, uint32_t* pLost)
+{
+    unsigned int nRead;
+    TCPIP_HEAP_DBG_DCPT* pDcpt = _TCPIP_HEAP_FindDcpt(heapH);
+
+    if(pDcpt == 0)
+    {
+        if(pLost)
+        {
+            *pLost = 0;
+        }
+        return 0;
+    }
+
+    OSAL_CRITSECT_DATA_TYPE status = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    for(nRead = 0; nRead < nRecords && pDcpt->logRdIx != pDcpt->logWrIx; nRead++, pDcpt->logRdIx++)
+    {
+        *pRecords++ = pDcpt->_heapTraceLog[pDcpt->logRdIx % (sizeof(pDcpt->_heapTraceLog)/sizeof(*pDcpt->_heapTraceLog))];
+    }
+
+    if(pLost)
+    {
+        *pLost = pDcpt->logLost;
+        pDcpt->logLost = 0;
+    }
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, status);
+
+    return nRead;
+}
+
+#else
+
+unsigned int TCPIP_HEAP_TraceLogRead(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int nRecords, uint32_t* pLost)
+{
+    if(pLost)
+    {
+        *pLost = 0;
+    }
+    return 0;
+}
+
+#endif  // defined(_TCPIP_STACK_DRAM_TRACE_LOG_ENABLE)
+
 
 #if defined (_TCPIP_STACK_DRAM_DIST_ENABLE)
 bool TCPIP_HEAP_DistGetEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_DIST_ENTRY* pEntry)
@@ -401,6 +401,31 @@ typedef struct
                                             // for the flags that are touched, according to the mask 
 }UDP_OPTION_MULTICAST_DATA;
 
+// *****************************************************************************
+/*
+  Structure:
+    TCPIP_UDP_BATCH_ITEM
+
+  Summary:
+    Descriptor of a datagram to be sent with TCPIP_UDP_BatchSend.
+
+  Description:
+    Each item describes one datagram: the remote host, the remote port
+    and the payload to be sent.
+
+  Remarks:
+    The address type of the destAddress has to match the socket address type.
+*/
+//
+typedef struct
+{
+    IP_MULTI_ADDRESS    destAddress;    // destination address of the datagram
+    UDP_PORT            destPort;       // destination port of the datagram;
+                                        // 0 means use the socket current remote port
+    uint16_t            dataLen;        // size of the payload
+    const uint8_t*      pData;          // payload to be sent
+}TCPIP_UDP_BATCH_ITEM;
+
 // *****************************************************************************
 /*
   Enumeration:
@@ -1337,6 +1362,54 @@ uint16_t            TCPIP_UDP_Flush(UDP_SOCKET hUDP);
 
 // *****************************************************************************
 
+/*
+  Function:
+    uint16_t TCPIP_UDP_BatchSend(UDP_SOCKET hUDP, const TCPIP_UDP_BATCH_ITEM* pItems, uint16_t nItems)
+
+  Summary:
+    Transmits a list of datagrams, each to its own destination, over a socket.
+    
+  Description:
+    This function sends each item of the list as a separate datagram,
+    in order, using the same socket.
+    It is the equivalent of a TCPIP_UDP_DestinationIPAddressSet,
+    TCPIP_UDP_DestinationPortSet, TCPIP_UDP_ArrayPut, TCPIP_UDP_Flush
+    sequence for each item but the socket is validated just once
+    for the whole list.
+
+  Precondition:
+    UDP socket should have been opened with TCPIP_UDP_ServerOpen/TCPIP_UDP_ClientOpen.
+    hUDP - valid socket
+
+  Parameters:
+    hUDP    - UDP socket handle
+    pItems  - list of datagrams to be sent
+    nItems  - number of items in the list
+    
+  Returns:
+    The number of items that have been flushed.
+    0 if the socket is invalid or it has pending (not flushed) TX data.
+    The processing stops at the first item that cannot be sent:
+    - the socket TX queue limit is reached or out of memory
+    - the item payload does not fit in the socket TX buffer
+    - the item address type does not match the socket
+    - no route to the remote host could be found
+
+  Remarks:
+    The remaining items can be sent with a new call, when the socket
+    has TX space again (see TCPIP_UDP_SIGNAL_TX_DONE).
+
+    After the call the socket remote address and port are
+    the ones of the last item sent.
+
+    The packets are allocated as for a regular TCPIP_UDP_Flush.
+    The socket TX queue limit (UDP_OPTION_TX_QUEUE_LIMIT) and
+    the UDP buffer pool (UDP_OPTION_BUFFER_POOL) apply.
+  */
+uint16_t            TCPIP_UDP_BatchSend(UDP_SOCKET hUDP, const TCPIP_UDP_BATCH_ITEM* pItems, uint16_t nItems);
+
+// *****************************************************************************
+
 /*
   Function:
     uint16_t TCPIP_UDP_Put(UDP_SOCKET hUDP, uint8_t v)
@@ -129,6 +129,8 @@ extern "C" {
 #define DRV_PLC_THMON_PIN                     SYS_PORT_PIN_PB15
 #define DRV_PLC_CSR_INDEX                     0
 #define DRV_PLC_SPI_CLK                       8000000
+#define DRV_PLC_BOOT_FRAGS_PER_TASK           2U
+#define DRV_PLC_BOOT_RESIDENT_CHECK           1U
 
 /* PLC MAC RT Driver RTOS Configuration Options */
 #define DRV_PLC_RTOS_STACK_SIZE               320
@@ -137,6 +139,7 @@ extern "C" {
 /* PLC MAC RT Driver Identification */
 #define DRV_G3_MACRT_INDEX                   0U
 #define DRV_G3_MACRT_INSTANCES_NUMBER        1U
+#define DRV_G3_MACRT_RX_QUEUE_SIZE           8U
 #define DRV_G3_MACRT_HOST_DESC               "PIC32CX2051MTG128"
 /* RF215 Driver Configuration Options */
 #define DRV_RF215_INDEX_0                     0U
@@ -235,6 +238,15 @@ extern "C" {
 #define TCPIP_IPV6_NDP_VALID_LIFETIME_TWO_HOURS 	(60 * 60 * 2)
 #define TCPIP_IPV6_MTU_INCREASE_TIMEOUT 			600
 #define TCPIP_IPV6_NDP_TASK_TIMER_RATE 				32
+/* Number of hash index slots for the neighbor cache/destination cache
+ * lookups, per interface. 0 disables the index (linear list search).
+ * Entries that do not fit in the index are still found, by a list search.
+ * The index is linearly probed and slows down above 75% of its slots in use:
+ * size it to the G3 devices the coordinator talks to divided by 0.75,
+ * rounded up to a prime. Each slot takes 8 bytes of the TCP/IP heap.
+ * 127 slots: up to 95 devices, 1016 bytes per cache. */
+#define TCPIP_IPV6_NDP_NC_HASH_ENTRIES 				127
+#define TCPIP_IPV6_NDP_DC_HASH_ENTRIES 				127
 
 
 /* Network Configuration Index 0 */
@@ -267,7 +279,7 @@ extern "C" {
 #define TCPIP_IPV6_DEFAULT_CUR_HOP_LIMIT 				64
 #define TCPIP_IPV6_DEFAULT_BASE_REACHABLE_TIME 			30
 #define TCPIP_IPV6_DEFAULT_RETRANSMIT_TIME 				1000
-#define TCPIP_IPV6_QUEUE_NEIGHBOR_PACKET_LIMIT 			1
+#define TCPIP_IPV6_QUEUE_NEIGHBOR_PACKET_LIMIT 			4
 #define TCPIP_IPV6_NEIGHBOR_CACHE_ENTRY_STALE_TIMEOUT 	600
 #define TCPIP_IPV6_QUEUE_MCAST_PACKET_LIMIT 			4
 #define TCPIP_IPV6_QUEUED_MCAST_PACKET_TIMEOUT 			10
@@ -278,10 +290,12 @@ extern "C" {
 #define TCPIP_IPV6_ULA_NTP_VALID_WINDOW 				1000
 #define TCPIP_IPV6_FRAGMENT_PKT_TIMEOUT 				60
 #define TCPIP_IPV6_RX_FRAGMENTED_BUFFER_SIZE 			1280
+#define TCPIP_IPV6_TX_TEMPLATE_ENTRIES 				16
 #define TCPIP_IPV6_EXTERN_PACKET_PROCESS   false
 
 
 #define TCPIP_IPV6_G3_PLC_SUPPORT                       true
+#define TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR           true
 
 #define TCPIP_IPV6_G3_PLC_BORDER_ROUTER                 true
 
@@ -292,6 +306,19 @@ extern "C" {
 #define TCPIP_STACK_DRAM_SIZE                       14336
 #define TCPIP_STACK_DRAM_RUN_LIMIT                  2048
 
+/* Slab heap size classes, carved from TCPIP_STACK_DRAM_SIZE. The space left
+ * is used as a first fit heap. Define TCPIP_STACK_USE_INTERNAL_HEAP_SLAB
+ * instead of TCPIP_STACK_USE_INTERNAL_HEAP to use the slab heap.
+ * The first fit heap stays the default: with classes not sized for the
+ * traffic the slab heap fails more allocations. Size them from a heap trace
+ * log with tools/host_tests/heap_replay -s before selecting the slab heap */
+#define TCPIP_STACK_HEAP_SLAB_SMALL_SIZE            64
+#define TCPIP_STACK_HEAP_SLAB_SMALL_BLOCKS          16
+#define TCPIP_STACK_HEAP_SLAB_MEDIUM_SIZE           256
+#define TCPIP_STACK_HEAP_SLAB_MEDIUM_BLOCKS         8
+#define TCPIP_STACK_HEAP_SLAB_LARGE_SIZE            1408
+#define TCPIP_STACK_HEAP_SLAB_LARGE_BLOCKS          4
+
 #define TCPIP_STACK_MALLOC_FUNC                     malloc
 
 #define TCPIP_STACK_CALLOC_FUNC                     calloc
@@ -306,6 +333,12 @@ extern "C" {
 
 #define TCPIP_STACK_SUPPORTED_HEAPS                  1
 
+/* Heap profiling. Define TCPIP_STACK_DRAM_DEBUG_ENABLE and
+ * TCPIP_STACK_DRAM_TRACE_ENABLE to record per module usage and a log of
+ * TCPIP_STACK_DRAM_TRACE_LOG_SIZE records that can be replayed on a host */
+#define TCPIP_STACK_DRAM_TRACE_SLOTS                 20
+#define TCPIP_STACK_DRAM_TRACE_LOG_SIZE              256
+
 
 
 
@@ -348,7 +381,9 @@ extern "C" {
 
 
 /*** UDP Configuration ***/
-#define TCPIP_UDP_MAX_SOCKETS		                	2
+#define TCPIP_UDP_MAX_SOCKETS		                	24
+/* Local port index used to match the RX packets to sockets; 0 disables it */
+#define TCPIP_UDP_PORT_HASH_BUCKETS		                8
 #define TCPIP_UDP_SOCKET_DEFAULT_TX_SIZE		    	1200
 #define TCPIP_UDP_SOCKET_DEFAULT_TX_QUEUE_LIMIT    	 	3
 #define TCPIP_UDP_SOCKET_DEFAULT_RX_QUEUE_LIMIT			3
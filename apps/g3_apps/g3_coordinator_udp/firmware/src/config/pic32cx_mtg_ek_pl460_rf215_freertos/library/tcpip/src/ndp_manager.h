@@ -235,6 +235,11 @@ void TCPIP_NDP_Task (void);
 void TCPIP_NDP_LinkedListEntryInsert (TCPIP_NET_IF * pNetIf, void * entry, uint8_t type);
 void * TCPIP_NDP_LinkedListEntryRemove (TCPIP_NET_IF * pNetIf, void * entry, uint8_t type);
 
+// clears the neighbor/destination cache index of an interface
+// should be called before the NC/DC lists are freed by other means
+// than TCPIP_NDP_LinkedListEntryRemove()
+void TCPIP_NDP_CacheIndexClear (TCPIP_NET_IF * pNetIf);
+
 IPV6_ADDR_STRUCT * TCPIP_NDP_UnicastAddressMove (TCPIP_NET_IF * pNetIf, IPV6_ADDR_STRUCT * entryLocation, IPV6_ADDR_STRUCT * previousEntryLocation);
 
 void TCPIP_NDP_NborCacheLinkLayerAddressUpdate (TCPIP_NET_IF * pNetIf, IPV6_HEAP_NDP_NC_ENTRY * neighborPointer, TCPIP_MAC_ADDR * linkLayerAddr, uint8_t reachability);
@@ -57,7 +57,10 @@ static __inline__ void __attribute__((always_inline)) _OAHashRemoveEntry(OA_HASH
     if(pOE->flags.busy)
     {
         pOE->flags.busy = 0;
-        pOH->fullSlots--;
+        if(--pOH->fullSlots == 0)
+        {   // empty hash; restart the probe count
+            pOH->maxProbes = 0;
+        }
     }
 }
 
@@ -94,6 +97,7 @@ void TCPIP_OAHASH_Initialize(OA_HASH_DCPT* pOH)
     size_t  ix;
 
     pOH->fullSlots = 0; 
+    pOH->maxProbes = 0;
     
     pHE = (OA_HASH_ENTRY*)pOH->memBlk;
     for(ix = 0; ix < pOH->hEntries; ix++)
@@ -120,7 +124,8 @@ OA_HASH_ENTRY* TCPIP_OAHASH_EntryLookup(OA_HASH_DCPT* pOH, const void* key)
     bktIx = TCPIP_OAHASH_KeyHash(pOH, key);
 #endif  // defined ( OA_HASH_DYNAMIC_KEY_MANIPULATION )
 
-    while(bkts < pOH->hEntries)
+    // an entry is never placed further than maxProbes from its hash slot
+    while(bkts <= pOH->maxProbes && bkts < pOH->hEntries)
     {
         pBkt = (OA_HASH_ENTRY*)((uint8_t*)(pOH->memBlk) + bktIx * pOH->hEntrySize);
 #if defined ( OA_HASH_DYNAMIC_KEY_MANIPULATION )
@@ -303,6 +308,10 @@ static OA_HASH_ENTRY* _OAHashFindBkt(OA_HASH_DCPT* pOH, const void* key)
 #endif  // defined ( OA_HASH_DYNAMIC_KEY_MANIPULATION )
             pBkt->probeCount = bkts;
             pOH->fullSlots++;
+            if(bkts > pOH->maxProbes)
+            {
+                pOH->maxProbes = bkts;
+            }
             return pBkt;
         }
 
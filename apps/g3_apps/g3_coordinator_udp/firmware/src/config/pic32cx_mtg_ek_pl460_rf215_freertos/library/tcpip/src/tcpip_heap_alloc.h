@@ -62,10 +62,36 @@ typedef struct
     int32_t     nFrees;             // total number of free operations
     int32_t     totAllocated;       // total number of bytes allocated successfully by this module
     int32_t     currAllocated;      // number of bytes still allocated by this module
+    int32_t     peakAllocated;      // maximum value reached by currAllocated
     int32_t     totFailed;          // total number of bytes that failed for this module
     int32_t     maxFailed;          // maximum number of bytes that could not be allocated
 }TCPIP_HEAP_TRACE_ENTRY;
 
+// heap trace log operation
+typedef enum
+{
+    TCPIP_HEAP_TRACE_OP_NONE    = 0,    // invalid record
+    TCPIP_HEAP_TRACE_OP_ALLOC,          // successful allocation
+    TCPIP_HEAP_TRACE_OP_FREE,           // block released
+    TCPIP_HEAP_TRACE_OP_FAIL,           // failed allocation
+}TCPIP_HEAP_TRACE_OP;
+
+// heap trace log record
+// only if TCPIP_STACK_DRAM_DEBUG_ENABLE and TCPIP_STACK_DRAM_TRACE_ENABLE are enabled
+// and TCPIP_STACK_DRAM_TRACE_LOG_SIZE != 0
+// Compact 8 bytes record describing a heap operation.
+// A sequence of records can be dumped and replayed on a host
+// against a heap built with a different configuration.
+typedef struct
+{
+    uint8_t     op;                 // a TCPIP_HEAP_TRACE_OP value
+    uint8_t     moduleId;           // module performing the operation
+    uint16_t    lineNo;             // source line of the allocation call; 0 for a free operation
+    uint16_t    nBytes;             // block size for alloc/free, requested bytes for fail
+    uint16_t    blockOffset;        // block offset from the heap handle, in 4 bytes units
+                                    // matches an alloc to its free; 0 for a failed allocation
+}TCPIP_HEAP_TRACE_RECORD;
+
 // heap distribution entry
 // useful for checking the distribution of allocated memory blocks in the heap
 // only if TCPIP_STACK_DRAM_DEBUG_ENABLE and TCPIP_STACK_DRAM_DIST_ENABLE are enabled
@@ -398,6 +424,35 @@ bool  TCPIP_HEAP_TraceGetEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entry
  ********************************************************************/
 unsigned int     TCPIP_HEAP_TraceGetEntriesNo(TCPIP_STACK_HEAP_HANDLE heapH, bool getUsed);
 
+/*********************************************************************
+ * Function:      unsigned int  TCPIP_HEAP_TraceLogRead(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int nRecords, uint32_t* pLost)
+ *
+ * PreCondition:    None
+ *
+ * Input:           heapH       - handle of a heap
+ *                  pRecords    - address to store the trace log records
+ *                  nRecords    - maximum number of records to be stored
+ *                  pLost       - address to store the number of records that were
+ *                                dropped because the log was full. Can be NULL.
+ *
+ * Output:          number of records copied to pRecords
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The function extracts the oldest records from the heap trace log.
+ *                  The records are removed from the log.
+ *
+ * Note:            
+ *                  Trace log records are stored only when
+ *                  TCPIP_STACK_DRAM_DEBUG_ENABLE and TCPIP_STACK_DRAM_TRACE_ENABLE are enabled
+ *                  and TCPIP_STACK_DRAM_TRACE_LOG_SIZE != 0.
+ *
+ *                  When the log is full new records are dropped, so the
+ *                  records read are always a replayable prefix of the heap activity.
+ *                  The lost counter is cleared after it is reported.
+ ********************************************************************/
+unsigned int     TCPIP_HEAP_TraceLogRead(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int nRecords, uint32_t* pLost);
+
 
 /*********************************************************************
  * Function:      bool  TCPIP_HEAP_DistGetEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_DIST_ENTRY* pEntry)
@@ -577,6 +632,29 @@ int     TCPIP_HEAP_POOL_Entries(TCPIP_STACK_HEAP_HANDLE heapH);
 bool TCPIP_HEAP_POOL_EntryList(TCPIP_STACK_HEAP_HANDLE heapH, int entryIx, TCPIP_HEAP_POOL_ENTRY_LIST* pList);
 
 
+// slab heap specific functionality for monitoring the size classes
+
+// slab entry list describing the entry usage
+typedef struct
+{
+    int blockSize;
+    int nBlocks;
+    int freeBlocks;
+    // max number of blocks simultaneously allocated
+    int highWatermark;
+    // allocations that found this entry exhausted
+    int failCount;
+}TCPIP_HEAP_SLAB_ENTRY_LIST;
+
+// returns the number of entries in the slab heap
+// 0 if not a slab heap
+int     TCPIP_HEAP_SLAB_Entries(TCPIP_STACK_HEAP_HANDLE heapH);
+
+
+// lists a slab entry identified by its index
+bool TCPIP_HEAP_SLAB_EntryList(TCPIP_STACK_HEAP_HANDLE heapH, int entryIx, TCPIP_HEAP_SLAB_ENTRY_LIST* pList);
+
+
 
 // *****************************************************************************
 // supported heap creation functions
@@ -590,5 +668,8 @@ extern TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateExternal(const TCPIP_STACK_HEAP_
 // pool heap - internal
 TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateInternalPool(const TCPIP_STACK_HEAP_POOL_CONFIG* pHeapConfig, TCPIP_STACK_HEAP_RES* pRes);
 
+// slab heap - internal
+TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateInternalSlab(const TCPIP_STACK_HEAP_SLAB_CONFIG* pHeapConfig, TCPIP_STACK_HEAP_RES* pRes);
+
 #endif  // _TCPIP_HEAP_ALLOC_H_
 
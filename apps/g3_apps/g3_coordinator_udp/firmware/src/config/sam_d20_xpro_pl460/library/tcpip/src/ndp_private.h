@@ -70,6 +70,47 @@ Microchip or any third party.
 #define TCPIP_IPV6_MIN_RTR_ADV_INTERVAL             200         // seconds
 #define TCPIP_IPV6_MAX_RTR_ADV_INTERVAL             600         // seconds
 
+// Neighbor/destination cache hash index
+// Number of slots of the per interface hash index for the neighbor cache
+// and destination cache lists.
+// A value of 0 disables the index and the lists are searched linearly.
+#if !defined(TCPIP_IPV6_NDP_NC_HASH_ENTRIES)
+#define TCPIP_IPV6_NDP_NC_HASH_ENTRIES              0
+#endif
+#if !defined(TCPIP_IPV6_NDP_DC_HASH_ENTRIES)
+#define TCPIP_IPV6_NDP_DC_HASH_ENTRIES              0
+#endif
+
+// G3-PLC: treat the addresses with an on-link prefix and a
+// 'PAN_id:00ff:fe00:xxxx' interface ID as neighbors, like the link-local ones
+#if !defined(TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR)
+#define TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR       0
+#endif
+
+#if (TCPIP_IPV6_NDP_NC_HASH_ENTRIES != 0) || (TCPIP_IPV6_NDP_DC_HASH_ENTRIES != 0)
+#define _TCPIP_NDP_CACHE_HASH_ENABLE
+#endif
+
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+// hash entry: maps a remote IPv6 address to its NC/DC list node
+// the key is the remoteIPAddress of the node, it is not copied:
+// an index slot takes 8 bytes of the heap on a 32 bit target
+typedef struct
+{
+    OA_HASH_ENTRY           hEntry;         // hash header
+    void*                   pNode;          // IPV6_HEAP_NDP_NC_ENTRY/IPV6_HEAP_NDP_DC_ENTRY
+}NDP_HASH_ENTRY;
+
+// per interface cache index
+typedef struct
+{
+    OA_HASH_DCPT*           ncHash;         // neighbor cache index
+    OA_HASH_DCPT*           dcHash;         // destination cache index
+    uint8_t                 ncPartial;      // neighbor cache has nodes that are not indexed
+    uint8_t                 dcPartial;      // destination cache has nodes that are not indexed
+}NDP_CACHE_INDEX;
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+
 //**************
 // Private APIs
 //**************
@@ -4726,6 +4726,19 @@ size_t TCPIP_STACK_HEAP_HighWatermark(TCPIP_STACK_HEAP_HANDLE heapH)
     return heapH ? TCPIP_HEAP_HighWatermark(heapH) : 0;
 }
 
+unsigned int TCPIP_STACK_HEAP_FragmentationIndex(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    size_t freeSize, maxSize;
+
+    if(heapH == 0 || (freeSize = TCPIP_HEAP_FreeSize(heapH)) == 0)
+    {
+        return 0;
+    }
+
+    maxSize = TCPIP_HEAP_MaxSize(heapH);
+    return maxSize >= freeSize ? 0 : 100 - (unsigned int)((maxSize * 100) / freeSize);
+}
+
 
 TCPIP_STACK_HEAP_RES TCPIP_STACK_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH)
 {
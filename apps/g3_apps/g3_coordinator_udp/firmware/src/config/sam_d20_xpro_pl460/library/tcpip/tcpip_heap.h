@@ -134,6 +134,16 @@ typedef enum
        protection if needed */
     TCPIP_STACK_HEAP_TYPE_EXTERNAL_HEAP,              
 
+    /* internally implemented slab heap */
+    /* Blocks of a few size classes are carved from the heap space */
+    /* Constant time allocation and deallocation without fragmentation */
+    /* for the sizes that match a class. */
+    /* The space left is a first fit heap used for larger blocks */
+    /* and when the classes are exhausted. */
+    /* Note: this is a private TCPIP heap */
+    /* and multi-threaded protection is provided internally. */
+    TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB,
+
     /* number of supported heap types */
     TCPIP_STACK_HEAP_TYPES
 
@@ -298,6 +308,8 @@ typedef enum
     // strictly from the pool entry that matches the requested size.
     // Otherwise, all the pool entries that have blocks larger than the requested size
     // will be tried.
+    // Also used by the TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB type:
+    // the larger classes are not tried when the matching class is exhausted.
     TCPIP_STACK_HEAP_FLAG_POOL_STRICT       = 0x08,
 
 
@@ -464,6 +476,49 @@ typedef struct
                                             // an entry runs out of blocks and nExpBlks != 0.
 }TCPIP_STACK_HEAP_POOL_CONFIG;
 
+//*******************************************************************************
+/* Internal Slab Heap Configuration Data
+
+  Summary:
+    Defines the data required to initialize the TCP/IP stack internal slab heap.
+
+  Description:
+    This data type defines the data required to initialize the TCP/IP stack internal slab heap.
+
+  Remarks:
+    Slab entries should have distinct, ascending and non zero block sizes.
+    Block sizes are rounded up to the heap alignment.
+    The space left in heapSize after the slab entries is used as a first fit heap
+    for the blocks larger than the largest entry and when the entries are exhausted.
+    It should be large enough for the stack initialization structures.
+    If these conditions are not observed the heap creation will fail!
+*/
+
+typedef struct
+{
+    // size of the blocks in this slab entry
+    uint16_t    blockSize;
+    // number of blocks to carve for this entry
+    uint16_t    nBlocks;
+}TCPIP_STACK_HEAP_SLAB_ENTRY;
+
+typedef struct
+{
+    // the TCPIP_STACK_HEAP_CONFIG members
+    TCPIP_STACK_HEAP_TYPE   heapType;       // type of this heap: TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB
+    TCPIP_STACK_HEAP_FLAGS  heapFlags;      // heap creation flags
+                                            // TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED will be always internally set 
+                                            //
+    TCPIP_STACK_HEAP_USAGE  heapUsage;      // currently not used                                            
+    void* (*malloc_fnc)(size_t bytes);      // malloc style function for allocating the slab heap itself
+    void  (*free_fnc)(void* ptr);           // free style function for releasing the allocated slab heap
+    // specific slab heap parameters
+    size_t                  heapSize;       // size of the heap to be created: slab entries and first fit space
+    uint16_t                nSlabEntries;   // number of slab entries
+    const TCPIP_STACK_HEAP_SLAB_ENTRY *pSlabEntries;  // pointer to array of TCPIP_STACK_HEAP_SLAB_ENTRY specifying
+                                            // each entry size and blocks
+}TCPIP_STACK_HEAP_SLAB_CONFIG;
+
 //*******************************************************************************
 /*
   Function:
@@ -598,6 +653,33 @@ size_t                 TCPIP_STACK_HEAP_FreeSize(TCPIP_STACK_HEAP_HANDLE heapH);
 */ 
 size_t                 TCPIP_STACK_HEAP_HighWatermark(TCPIP_STACK_HEAP_HANDLE heapH);
 
+//*****************************************************************************
+/* Function:
+    unsigned int TCPIP_STACK_HEAP_FragmentationIndex(TCPIP_STACK_HEAP_HANDLE heapH);
+     
+   Summary:
+    Returns the current heap fragmentation index.
+   
+   Description:
+    The function returns how much of the free space in the heap cannot be
+    obtained with a single allocation, as a percentage:
+    100 * (1 - MaxSize / FreeSize).
+    0 means that all the free space is one contiguous block.
+   
+   Preconditions:
+    heapH       - valid heap handle
+   
+   Parameters:
+    heapH       - handle to a heap
+   
+   Returns:
+    The fragmentation index, 0 to 100.
+   
+   Remarks:
+    It calls TCPIP_STACK_HEAP_MaxSize so the same cost considerations apply.
+*/ 
+unsigned int           TCPIP_STACK_HEAP_FragmentationIndex(TCPIP_STACK_HEAP_HANDLE heapH);
+
 //*****************************************************************************
 /* Function:      
     TCPIP_STACK_HEAP_RES TCPIP_STACK_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH)
@@ -329,25 +329,16 @@ static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_Delete(TCPIP_STACK_HEAP_HANDLE heapH)
 }
 
 
-static void* _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+// first fit allocation of a block
+// the heap semaphore should be taken by the caller
+static void* _TCPIP_HEAP_AllocBlock(TCPIP_HEAP_DCPT* hDcpt, size_t nBytes)
 {
     _headNode   *ptr,*prev;
     size_t      nunits;
-    TCPIP_HEAP_DCPT*  hDcpt;
-
 
-    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
-
-    if(hDcpt == 0 || nBytes == 0)
-    {
-        return 0;
-    }
-    
     nunits=(nBytes+sizeof(_headNode)-1)/sizeof(_headNode)+1;    // allocate units   
     prev=0;
 
-    (void)OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
-
     for(ptr = hDcpt->_heapHead; ptr != 0; prev = ptr, ptr = ptr->next)
     {
         if(ptr->units >= nunits)
@@ -385,16 +376,37 @@ static void* _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
             {
                 hDcpt->_heapWatermark = hDcpt->_heapAllocatedUnits;
             }
-            (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
             return ptr + 1;
         }
     }
 
-    hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_NO_MEM;
-    (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
     return 0;
 }
 
+static void* _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    TCPIP_HEAP_DCPT*  hDcpt;
+    void*       ptr;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt == 0 || nBytes == 0)
+    {
+        return 0;
+    }
+
+    (void)OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+
+    ptr = _TCPIP_HEAP_AllocBlock(hDcpt, nBytes);
+    if(ptr == 0)
+    {
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_NO_MEM;
+    }
+
+    (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+    return ptr;
+}
+
 static void* _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
 {
     void* pBuff = _TCPIP_HEAP_Malloc(heapH, nElems * elemSize);
@@ -407,29 +419,20 @@ static void* _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, si
 
 }
 
-static size_t _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+// returns a block to the first fit free list
+// the heap semaphore should be taken by the caller
+static size_t _TCPIP_HEAP_FreeBlock(TCPIP_HEAP_DCPT* hDcpt, const void* pBuff)
 {  
-    TCPIP_HEAP_DCPT*  hDcpt;
     _headNode   *hdr,*ptr;
     int         fail;
     size_t      freedUnits;
 
-    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
-
-    if(hDcpt == 0 || pBuff == 0)
-    {
-        return 0;
-    }
-
     ptr = (_headNode*)pBuff-1;
 
-    (void)OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
-
 #ifdef TCPIP_STACK_DRAM_DEBUG_ENABLE
     if(ptr < hDcpt->_heapStart || ptr+ptr->units > hDcpt->_heapEnd)
     {
         hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_PTR_ERR;   // not one of our pointers!!!
-        (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
         return 0;
     }
 #endif
@@ -531,15 +534,32 @@ static size_t _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
     if(fail)
     {
         hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_PTR_ERR;   // corrupted pointer!!!
-        (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
         return 0;
     }
     
     hDcpt->_heapAllocatedUnits -= freedUnits;
-    (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
     return freedUnits * sizeof(_headNode);
 }
 
+static size_t _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{  
+    TCPIP_HEAP_DCPT*  hDcpt;
+    size_t      freedSize;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt == 0 || pBuff == 0)
+    {
+        return 0;
+    }
+
+    (void)OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
+    freedSize = _TCPIP_HEAP_FreeBlock(hDcpt, pBuff);
+    (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
+
+    return freedSize;
+}
+
 
 static size_t _TCPIP_HEAP_Size(TCPIP_STACK_HEAP_HANDLE heapH)
 {
@@ -582,30 +602,42 @@ static size_t _TCPIP_HEAP_HighWatermark(TCPIP_STACK_HEAP_HANDLE heapH)
     return 0;
 }
 
-static size_t _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+// largest free block in the first fit free list
+// the heap semaphore should be taken by the caller
+static size_t _TCPIP_HEAP_MaxBlock(TCPIP_HEAP_DCPT* hDcpt)
 {
-    TCPIP_HEAP_DCPT   *hDcpt;
     _headNode   *ptr;
     size_t      max_nunits;
 
     max_nunits = 0;
 
+    for(ptr = hDcpt->_heapHead; ptr != 0; ptr = ptr->next)
+    {
+        if(ptr->units >= max_nunits)
+        {   // found block
+            max_nunits = ptr->units;
+        }
+    }
+
+    return max_nunits * sizeof(_headNode);   
+}
+
+static size_t _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_DCPT   *hDcpt;
+    size_t      maxSize;
+
+    maxSize = 0;
+
     hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
     if(hDcpt)
     {
         (void)OSAL_SEM_Pend(&hDcpt->_heapSemaphore, OSAL_WAIT_FOREVER);
-
-        for(ptr = hDcpt->_heapHead; ptr != 0; ptr = ptr->next)
-        {
-            if(ptr->units >= max_nunits)
-            {   // found block
-                max_nunits = ptr->units;
-            }
-        }
+        maxSize = _TCPIP_HEAP_MaxBlock(hDcpt);
         (void)OSAL_SEM_Post(&hDcpt->_heapSemaphore);
     }
 
-    return max_nunits * sizeof(_headNode);   
+    return maxSize;
 
 }
 
@@ -642,3 +674,602 @@ static size_t _TCPIP_HEAP_AllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* p
 #endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
 
 
+
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+// slab heap
+// Blocks of the configured size classes are carved from the heap buffer.
+// Free blocks of a class are kept in a LIFO list: no headers, no fragmentation
+// and allocation/deallocation in constant time.
+// A bitmap per class marks the allocated blocks, so that a pointer that is not
+// the start of an allocated block is rejected instead of corrupting the free list.
+// The space left after the classes is a first fit area used for the blocks
+// larger than the largest class and when the classes are exhausted.
+
+typedef struct _tag_slabBlock
+{
+    struct _tag_slabBlock*  next;
+}_slabBlock;
+
+typedef struct
+{
+    uint8_t*        slabStart;          // first block of this class
+    uint8_t*        slabEnd;            // end of the blocks of this class
+    _slabBlock*     freeList;           // free blocks of this class
+    uint32_t*       inUseMap;           // allocated blocks of this class, 1 bit per block
+    uint16_t        blockSize;          // size of the blocks, multiple of _headNode
+    uint16_t        nBlocks;            // number of blocks in this class
+    uint16_t        freeBlocks;         // currently free blocks
+    uint16_t        minFreeBlocks;      // low watermark of the free blocks
+    uint32_t        failCount;          // allocations that found this class exhausted
+}TCPIP_HEAP_SLAB_ENTRY;
+
+typedef struct
+{
+    TCPIP_HEAP_DCPT         ffDcpt;             // first fit area; its semaphore protects the whole heap
+    TCPIP_HEAP_SLAB_ENTRY*  pEntries;           // slab classes, ascending block size
+    uint8_t*                slabStart;          // start of the slab area
+    uint8_t*                slabEnd;            // end of the slab area
+    size_t                  slabSize;           // size of the slab area
+    size_t                  slabAllocatedSize;  // allocated from the slab area
+    size_t                  heapWatermark;      // max allocated size, slab and first fit areas
+    uint16_t                nEntries;           // number of slab classes
+    TCPIP_STACK_HEAP_FLAGS  heapFlags;          // heap flags
+}TCPIP_HEAP_SLAB_DCPT; // descriptor of a slab heap
+
+typedef struct
+{
+    TCPIP_HEAP_OBJECT       heapObj;    // heap object API
+    TCPIP_HEAP_SLAB_DCPT    slabDcpt;   // private heap object data
+    // TCPIP_HEAP_SLAB_ENTRY    entries[nEntries];  // the slab classes
+    // uint32_t                 inUseMaps[];        // the in use bitmaps of the classes
+    // slab area
+    // first fit area
+}TCPIP_HEAP_SLAB_OBJ_INSTANCE;
+
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_SlabDelete(TCPIP_STACK_HEAP_HANDLE heapH);
+static void*            _TCPIP_HEAP_SlabMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes);
+static void*            _TCPIP_HEAP_SlabCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize);
+static size_t           _TCPIP_HEAP_SlabFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff);
+
+static size_t           _TCPIP_HEAP_SlabSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_SlabMaxSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_SlabFreeSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_SlabHighWatermark(TCPIP_STACK_HEAP_HANDLE heapH);
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_SlabLastError(TCPIP_STACK_HEAP_HANDLE heapH);
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+static size_t           _TCPIP_HEAP_SlabAllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr);
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+
+// the slab heap object
+static const TCPIP_HEAP_OBJECT      _tcpip_heap_slab_object = 
+{
+    .TCPIP_HEAP_Delete = _TCPIP_HEAP_SlabDelete,
+    .TCPIP_HEAP_Malloc = _TCPIP_HEAP_SlabMalloc,
+    .TCPIP_HEAP_Calloc = _TCPIP_HEAP_SlabCalloc,
+    .TCPIP_HEAP_Free = _TCPIP_HEAP_SlabFree,
+    .TCPIP_HEAP_Size = _TCPIP_HEAP_SlabSize,
+    .TCPIP_HEAP_MaxSize = _TCPIP_HEAP_SlabMaxSize,
+    .TCPIP_HEAP_FreeSize = _TCPIP_HEAP_SlabFreeSize,
+    .TCPIP_HEAP_HighWatermark = _TCPIP_HEAP_SlabHighWatermark,
+    .TCPIP_HEAP_LastError = _TCPIP_HEAP_SlabLastError,
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+    .TCPIP_HEAP_AllocSize = _TCPIP_HEAP_SlabAllocSize,
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+};
+
+// returns the TCPIP_HEAP_SLAB_DCPT associated with a heap handle
+// null if invalid
+static __inline__ TCPIP_HEAP_SLAB_DCPT* __attribute__((always_inline)) _TCPIP_HEAP_SlabObjDcpt(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+    if(heapH)
+    {
+        TCPIP_HEAP_SLAB_OBJ_INSTANCE* pInst = (TCPIP_HEAP_SLAB_OBJ_INSTANCE*)heapH;
+        if(pInst->heapObj.TCPIP_HEAP_Delete == _TCPIP_HEAP_SlabDelete)
+        {
+            return &pInst->slabDcpt;
+        }
+    }
+    return 0;
+#else
+    return (heapH == 0) ? 0 : &((TCPIP_HEAP_SLAB_OBJ_INSTANCE*)heapH)->slabDcpt;
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+}
+
+// returns the slab class a slab area pointer belongs to
+static TCPIP_HEAP_SLAB_ENTRY* _TCPIP_HEAP_SlabEntry(TCPIP_HEAP_SLAB_DCPT* sDcpt, const void* ptr)
+{
+    int ix;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry = sDcpt->pEntries;
+
+    for(ix = 0; ix < sDcpt->nEntries; ix++, pEntry++)
+    {
+        if((const uint8_t*)ptr < pEntry->slabEnd)
+        {
+            return pEntry;
+        }
+    }
+
+    return 0;
+}
+
+TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateInternalSlab(const TCPIP_STACK_HEAP_SLAB_CONFIG* pHeapConfig, TCPIP_STACK_HEAP_RES* pRes)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_HEAP_DCPT* hDcpt;
+    TCPIP_HEAP_SLAB_OBJ_INSTANCE* hInst;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry;
+    const TCPIP_STACK_HEAP_SLAB_ENTRY* pCfgEntry;
+    size_t          heapSize, heapUnits, headerSize, slabSize, blockSize, mapWords;
+    uint32_t*       pMap;
+    uint8_t*        allocatedHeapBuffer;
+    uint8_t*        alignHeapBuffer;
+    size_t          heapBufferSize;
+    uintptr_t       alignBuffer;
+    uint8_t*        slabPtr;
+    int             ix, blkIx;
+    TCPIP_STACK_HEAP_RES  res;
+
+    while(true)
+    {
+        hInst = 0;
+        
+        if( pHeapConfig == 0 || pHeapConfig->malloc_fnc == 0 || pHeapConfig->free_fnc == 0 || pHeapConfig->heapSize == 0 ||
+            pHeapConfig->nSlabEntries == 0 || pHeapConfig->pSlabEntries == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+            break;
+        }
+
+        // slab classes should have ascending, distinct block sizes
+        slabSize = 0;
+        blockSize = 0;
+        mapWords = 0;
+        pCfgEntry = pHeapConfig->pSlabEntries;
+        for(ix = 0; ix < pHeapConfig->nSlabEntries; ix++, pCfgEntry++)
+        {
+            if(pCfgEntry->blockSize <= blockSize || pCfgEntry->nBlocks == 0)
+            {
+                break;
+            }
+            blockSize = pCfgEntry->blockSize;
+            slabSize += (((blockSize + sizeof(_headNode) - 1) / sizeof(_headNode)) * sizeof(_headNode)) * pCfgEntry->nBlocks;
+            mapWords += (pCfgEntry->nBlocks + 31) / 32;
+        }
+
+        if(ix != pHeapConfig->nSlabEntries)
+        {
+            res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+            break;
+        }
+
+        heapBufferSize = pHeapConfig->heapSize;
+        allocatedHeapBuffer = (uint8_t*)(*pHeapConfig->malloc_fnc)(heapBufferSize);
+
+        if(allocatedHeapBuffer == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_CREATE_ERR;
+            break;
+        }
+
+        // align properly: round up and truncate
+        alignBuffer = ((uintptr_t)allocatedHeapBuffer + sizeof(_heap_Align)-1 ) & ~(sizeof(_heap_Align)-1);
+        heapBufferSize -= (uint8_t*)alignBuffer - allocatedHeapBuffer ;
+        heapBufferSize &= ~(sizeof(_heap_Align)-1) ;
+        alignHeapBuffer = (uint8_t*)alignBuffer;
+
+        headerSize = sizeof(TCPIP_HEAP_SLAB_OBJ_INSTANCE) + pHeapConfig->nSlabEntries * sizeof(TCPIP_HEAP_SLAB_ENTRY) + mapWords * sizeof(uint32_t);
+        headerSize = ((headerSize + sizeof(_headNode) - 1) / sizeof(_headNode)) * sizeof(_headNode);
+
+        // what's left after the slab classes is the first fit area
+        heapSize = (heapBufferSize > headerSize + slabSize) ? heapBufferSize - headerSize - slabSize : 0;
+        heapUnits = heapSize / sizeof(_headNode);
+
+        if(heapUnits < _TCPIP_HEAP_MIN_BLKS_)
+        {
+            (*pHeapConfig->free_fnc)(allocatedHeapBuffer);
+            res = TCPIP_STACK_HEAP_RES_BUFF_SIZE_ERR;
+            break;
+        }
+
+        // check if mapping needed; always alloc uncached!
+        {
+            alignHeapBuffer = (uint8_t*)_TCPIP_HEAP_BufferMapNonCached(alignHeapBuffer, heapBufferSize);
+        }
+        hInst = (TCPIP_HEAP_SLAB_OBJ_INSTANCE*)alignHeapBuffer;
+        hInst->heapObj = _tcpip_heap_slab_object;
+        sDcpt = &hInst->slabDcpt;
+        sDcpt->pEntries = (TCPIP_HEAP_SLAB_ENTRY*)(hInst + 1);
+        sDcpt->nEntries = pHeapConfig->nSlabEntries;
+        sDcpt->slabStart = alignHeapBuffer + headerSize;
+        sDcpt->slabEnd = sDcpt->slabStart + slabSize;
+        sDcpt->slabSize = slabSize;
+        sDcpt->slabAllocatedSize = 0;
+        sDcpt->heapWatermark = 0;
+        sDcpt->heapFlags = pHeapConfig->heapFlags;
+
+        // carve the slab classes
+        slabPtr = sDcpt->slabStart;
+        pEntry = sDcpt->pEntries;
+        pMap = (uint32_t*)(sDcpt->pEntries + sDcpt->nEntries);
+        memset(pMap, 0, mapWords * sizeof(uint32_t));
+        pCfgEntry = pHeapConfig->pSlabEntries;
+        for(ix = 0; ix < pHeapConfig->nSlabEntries; ix++, pEntry++, pCfgEntry++)
+        {
+            blockSize = ((pCfgEntry->blockSize + sizeof(_headNode) - 1) / sizeof(_headNode)) * sizeof(_headNode);
+            pEntry->slabStart = slabPtr;
+            pEntry->blockSize = (uint16_t)blockSize;
+            pEntry->nBlocks = pCfgEntry->nBlocks;
+            pEntry->freeBlocks = pCfgEntry->nBlocks;
+            pEntry->minFreeBlocks = pCfgEntry->nBlocks;
+            pEntry->failCount = 0;
+            pEntry->freeList = 0;
+            pEntry->inUseMap = pMap;
+            pMap += (pCfgEntry->nBlocks + 31) / 32;
+            // push in reverse order so that the first allocations come from the class start
+            for(blkIx = pCfgEntry->nBlocks - 1; blkIx >= 0; blkIx--)
+            {
+                _slabBlock* pBlk = (_slabBlock*)(slabPtr + blkIx * blockSize);
+                pBlk->next = pEntry->freeList;
+                pEntry->freeList = pBlk;
+            }
+            slabPtr += blockSize * pCfgEntry->nBlocks;
+            pEntry->slabEnd = slabPtr;
+        }
+
+        // the first fit area
+        hDcpt = &sDcpt->ffDcpt;
+        hDcpt->_heapHead = (_headNode*)sDcpt->slabEnd;
+        hDcpt->_heapHead->units = heapUnits;
+        hDcpt->_heapHead->next = 0;
+        hDcpt->_heapTail = hDcpt->_heapHead;
+        hDcpt->_heapUnits = heapUnits;
+        hDcpt->_heapAllocatedUnits = 0;
+        hDcpt->_heapWatermark = 0;
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_OK;
+        hDcpt->_heapFlags = pHeapConfig->heapFlags;
+        hDcpt->allocatedBuffer = allocatedHeapBuffer;
+        hDcpt->free_fnc = pHeapConfig->free_fnc;
+#ifdef TCPIP_STACK_DRAM_DEBUG_ENABLE
+        hDcpt->_heapStart = hDcpt->_heapHead;
+        hDcpt->_heapEnd = hDcpt->_heapHead + heapUnits;
+#endif
+        if(OSAL_SEM_Create(&hDcpt->_heapSemaphore, OSAL_SEM_TYPE_BINARY, 1, 1) != OSAL_RESULT_TRUE)
+        {
+            (*pHeapConfig->free_fnc)(allocatedHeapBuffer);
+            hInst = 0;
+            res = TCPIP_STACK_HEAP_RES_SYNCH_ERR;
+            break;
+        }
+
+        res = TCPIP_STACK_HEAP_RES_OK;
+        break;
+    }
+
+    if(pRes)
+    {
+        *pRes = res;
+    }
+
+    return hInst;
+}
+
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_SlabDelete(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_OBJ_INSTANCE* hInst;
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_HEAP_DCPT*   hDcpt;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt == 0)
+    {
+        return TCPIP_STACK_HEAP_RES_NO_HEAP; 
+    }
+
+    hInst = (TCPIP_HEAP_SLAB_OBJ_INSTANCE*)heapH;
+    hDcpt = &sDcpt->ffDcpt;
+
+    if(sDcpt->slabAllocatedSize != 0 || hDcpt->_heapAllocatedUnits != 0)
+    {
+        //  deallocating a heap not completely de-allocated
+        return (hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_IN_USE); 
+    }
+
+    OSAL_SEM_Delete(&hDcpt->_heapSemaphore);
+    // invalidate it
+    memset(&hInst->heapObj, 0, sizeof(hInst->heapObj));
+    (*hDcpt->free_fnc)(hDcpt->allocatedBuffer);
+
+    return TCPIP_STACK_HEAP_RES_OK;
+}
+
+static void* _TCPIP_HEAP_SlabMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry;
+    TCPIP_HEAP_SLAB_ENTRY* pEnd;
+    _slabBlock* pBlk;
+    void*       ptr;
+    size_t      allocatedSize, blkIx;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt == 0 || nBytes == 0)
+    {
+        return 0;
+    }
+
+    ptr = 0;
+    pEnd = sDcpt->pEntries + sDcpt->nEntries;
+
+    (void)OSAL_SEM_Pend(&sDcpt->ffDcpt._heapSemaphore, OSAL_WAIT_FOREVER);
+
+    // find the smallest class that fits
+    for(pEntry = sDcpt->pEntries; pEntry != pEnd; pEntry++)
+    {
+        if(nBytes <= pEntry->blockSize)
+        {
+            break;
+        }
+    }
+
+    if(pEntry != pEnd && pEntry->freeList == 0)
+    {   // class exhausted; try the larger ones
+        pEntry->failCount++;
+        if((sDcpt->heapFlags & TCPIP_STACK_HEAP_FLAG_POOL_STRICT) != 0)
+        {
+            pEntry = pEnd;
+        }
+        else
+        {
+            while(++pEntry != pEnd && pEntry->freeList == 0);
+        }
+    }
+
+    if(pEntry != pEnd)
+    {
+        pBlk = pEntry->freeList;
+        pEntry->freeList = pBlk->next;
+        blkIx = ((uint8_t*)pBlk - pEntry->slabStart) / pEntry->blockSize;
+        pEntry->inUseMap[blkIx / 32] |= 1UL << (blkIx % 32);
+        if(--pEntry->freeBlocks < pEntry->minFreeBlocks)
+        {
+            pEntry->minFreeBlocks = pEntry->freeBlocks;
+        }
+        sDcpt->slabAllocatedSize += pEntry->blockSize;
+        ptr = pBlk;
+    }
+    else
+    {   // larger than the largest class or no free blocks: use the first fit area
+        ptr = _TCPIP_HEAP_AllocBlock(&sDcpt->ffDcpt, nBytes);
+    }
+
+    if(ptr == 0)
+    {
+        sDcpt->ffDcpt._lastHeapErr = TCPIP_STACK_HEAP_RES_NO_MEM;
+    }
+    else
+    {
+        allocatedSize = sDcpt->slabAllocatedSize + sDcpt->ffDcpt._heapAllocatedUnits * sizeof(_headNode);
+        if(allocatedSize > sDcpt->heapWatermark)
+        {
+            sDcpt->heapWatermark = allocatedSize;
+        }
+    }
+
+    (void)OSAL_SEM_Post(&sDcpt->ffDcpt._heapSemaphore);
+    return ptr;
+}
+
+static void* _TCPIP_HEAP_SlabCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* pBuff = _TCPIP_HEAP_SlabMalloc(heapH, nElems * elemSize);
+    if(pBuff)
+    {
+        memset(pBuff, 0, nElems * elemSize);
+    }
+
+    return pBuff;
+}
+
+static size_t _TCPIP_HEAP_SlabFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{  
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry;
+    _slabBlock* pBlk;
+    size_t      freedSize, blkOffset, blkIx;
+    uint32_t    blkMask;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt == 0 || pBuff == 0)
+    {
+        return 0;
+    }
+
+    (void)OSAL_SEM_Pend(&sDcpt->ffDcpt._heapSemaphore, OSAL_WAIT_FOREVER);
+
+    freedSize = 0;
+    if((const uint8_t*)pBuff >= sDcpt->slabStart && (const uint8_t*)pBuff < sDcpt->slabEnd)
+    {
+        pEntry = _TCPIP_HEAP_SlabEntry(sDcpt, pBuff);
+        blkOffset = (const uint8_t*)pBuff - pEntry->slabStart;
+        blkIx = blkOffset / pEntry->blockSize;
+        blkMask = 1UL << (blkIx % 32);
+        // should be the start of an allocated block
+        if((blkOffset % pEntry->blockSize) == 0 && (pEntry->inUseMap[blkIx / 32] & blkMask) != 0)
+        {
+            pEntry->inUseMap[blkIx / 32] &= ~blkMask;
+            pBlk = (_slabBlock*)pBuff;
+            pBlk->next = pEntry->freeList;
+            pEntry->freeList = pBlk;
+            pEntry->freeBlocks++;
+            sDcpt->slabAllocatedSize -= pEntry->blockSize;
+            freedSize = pEntry->blockSize;
+        }
+    }
+    else if((const _headNode*)pBuff > (const _headNode*)sDcpt->slabEnd &&
+            (const _headNode*)pBuff < (const _headNode*)sDcpt->slabEnd + sDcpt->ffDcpt._heapUnits)
+    {   // first fit area
+        freedSize = _TCPIP_HEAP_FreeBlock(&sDcpt->ffDcpt, pBuff);
+    }
+
+    if(freedSize == 0)
+    {
+        sDcpt->ffDcpt._lastHeapErr = TCPIP_STACK_HEAP_RES_PTR_ERR;   // not one of our pointers or already freed!!!
+    }
+
+    (void)OSAL_SEM_Post(&sDcpt->ffDcpt._heapSemaphore);
+
+    _TCPIPStack_Assert(freedSize != 0, __FILE__, __func__, __LINE__);
+    return freedSize;
+}
+
+static size_t _TCPIP_HEAP_SlabSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt)
+    {
+        return sDcpt->slabSize + sDcpt->ffDcpt._heapUnits * sizeof(_headNode);
+    }
+
+    return 0;
+}
+
+static size_t _TCPIP_HEAP_SlabFreeSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt)
+    {
+        return (sDcpt->slabSize - sDcpt->slabAllocatedSize) +
+               (sDcpt->ffDcpt._heapUnits - sDcpt->ffDcpt._heapAllocatedUnits) * sizeof(_headNode);
+    }
+    return 0;
+}
+
+static size_t _TCPIP_HEAP_SlabHighWatermark(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt)
+    {
+        return sDcpt->heapWatermark;
+    }
+    return 0;
+}
+
+static size_t _TCPIP_HEAP_SlabMaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry;
+    size_t      maxSize;
+    int         ix;
+
+    maxSize = 0;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+    if(sDcpt)
+    {
+        (void)OSAL_SEM_Pend(&sDcpt->ffDcpt._heapSemaphore, OSAL_WAIT_FOREVER);
+
+        maxSize = _TCPIP_HEAP_MaxBlock(&sDcpt->ffDcpt);
+        // first fit blocks carry a header
+        maxSize = (maxSize != 0) ? maxSize - sizeof(_headNode) : 0;
+        pEntry = sDcpt->pEntries;
+        for(ix = 0; ix < sDcpt->nEntries; ix++, pEntry++)
+        {
+            if(pEntry->freeList != 0 && pEntry->blockSize > maxSize)
+            {
+                maxSize = pEntry->blockSize;
+            }
+        }
+
+        (void)OSAL_SEM_Post(&sDcpt->ffDcpt._heapSemaphore);
+    }
+
+    return maxSize;
+}
+
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_SlabLastError(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt;
+    TCPIP_STACK_HEAP_RES  res;
+
+    sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt)
+    {
+        res = sDcpt->ffDcpt._lastHeapErr;
+        sDcpt->ffDcpt._lastHeapErr = TCPIP_STACK_HEAP_RES_OK;
+        return res;
+    }
+
+    return TCPIP_STACK_HEAP_RES_NO_HEAP;
+}
+
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
+static size_t _TCPIP_HEAP_SlabAllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    TCPIP_HEAP_SLAB_DCPT* sDcpt = _TCPIP_HEAP_SlabObjDcpt(heapH);
+
+    if(sDcpt && ptr)
+    {
+        if((const uint8_t*)ptr >= sDcpt->slabStart && (const uint8_t*)ptr < sDcpt->slabEnd)
+        {
+            return _TCPIP_HEAP_SlabEntry(sDcpt, ptr)->blockSize;
+        }
+
+        return ((_headNode*)ptr - 1)->units * sizeof(_headNode);
+    }
+
+    return 0;
+}
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+int TCPIP_HEAP_SLAB_Entries(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_SLAB_OBJ_INSTANCE* hInst = (TCPIP_HEAP_SLAB_OBJ_INSTANCE*)heapH;
+
+    if(hInst != 0 && hInst->heapObj.TCPIP_HEAP_Delete == _TCPIP_HEAP_SlabDelete)
+    {
+        return hInst->slabDcpt.nEntries;
+    }
+
+    return 0;
+}
+
+bool TCPIP_HEAP_SLAB_EntryList(TCPIP_STACK_HEAP_HANDLE heapH, int entryIx, TCPIP_HEAP_SLAB_ENTRY_LIST* pList)
+{
+    TCPIP_HEAP_SLAB_OBJ_INSTANCE* hInst = (TCPIP_HEAP_SLAB_OBJ_INSTANCE*)heapH;
+    TCPIP_HEAP_SLAB_ENTRY* pEntry;
+
+    if(hInst == 0 || hInst->heapObj.TCPIP_HEAP_Delete != _TCPIP_HEAP_SlabDelete || entryIx < 0 || entryIx >= hInst->slabDcpt.nEntries)
+    {
+        return false;
+    }
+
+    if(pList)
+    {
+        pEntry = hInst->slabDcpt.pEntries + entryIx;
+        (void)OSAL_SEM_Pend(&hInst->slabDcpt.ffDcpt._heapSemaphore, OSAL_WAIT_FOREVER);
+        pList->blockSize = pEntry->blockSize;
+        pList->nBlocks = pEntry->nBlocks;
+        pList->freeBlocks = pEntry->freeBlocks;
+        pList->highWatermark = pEntry->nBlocks - pEntry->minFreeBlocks;
+        pList->failCount = pEntry->failCount;
+        (void)OSAL_SEM_Post(&hInst->slabDcpt.ffDcpt._heapSemaphore);
+    }
+
+    return true;
+}
+
+#endif  // defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
@@ -88,6 +88,22 @@ typedef struct
 // default TTL for multicast traffic
 #define UDP_MULTICAST_DEFAULT_TTL       1
 
+// number of buckets of the local port index used to match the incoming packets
+// 0 disables the index and all sockets are searched
+#if !defined(TCPIP_UDP_PORT_HASH_BUCKETS)
+#define TCPIP_UDP_PORT_HASH_BUCKETS     0
+#endif
+
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+// iterator over the sockets of a local port index bucket
+typedef struct
+{
+    const uint32_t* pMap;       // bucket bitmap: 1 bit per socket
+    uint32_t        sktMask;    // bits of the current word not yet returned
+    int             wordIx;     // current word in the bitmap
+}UDP_PORT_MAP_ITER;
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+
 // incoming packet match flags
 typedef enum
 {
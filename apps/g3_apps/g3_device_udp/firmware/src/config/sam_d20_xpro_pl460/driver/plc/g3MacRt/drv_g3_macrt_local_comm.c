@@ -67,12 +67,16 @@ static DRV_G3_MACRT_OBJ *gG3MacRtObj = NULL;
 /* Buffer definition to communicate with G3 MAC RT device */
 static CACHE_ALIGN uint8_t gG3StatusInfo[CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_STATUS_LENGTH)];
 static CACHE_ALIGN uint8_t gG3TxData[CACHE_ALIGNED_SIZE_GET((DRV_G3_MACRT_DATA_MAX_SIZE + 2))];
-static CACHE_ALIGN uint8_t gG3RxData[2][CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_DATA_MAX_SIZE)];
-static CACHE_ALIGN uint8_t gG3RxParameters[2][CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_RX_PAR_SIZE)];
+static CACHE_ALIGN uint8_t gG3RxData[DRV_G3_MACRT_RX_QUEUE_SIZE][CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_DATA_MAX_SIZE)];
+static CACHE_ALIGN uint8_t gG3RxParameters[DRV_G3_MACRT_RX_QUEUE_SIZE][CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_RX_PAR_SIZE)];
 static CACHE_ALIGN uint8_t gG3CommStatus[CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_COMM_STATUS_SIZE)];
 static CACHE_ALIGN uint8_t gG3TxConfirm[CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_TX_CFM_SIZE)];
 static CACHE_ALIGN uint8_t gG3RegResponse[CACHE_ALIGNED_SIZE_GET(DRV_G3_MACRT_REG_PKT_SIZE)];
 
+/* RX queue: length of the data and RX parameters flag of each frame */
+static uint16_t gG3RxDataLength[DRV_G3_MACRT_RX_QUEUE_SIZE];
+static bool gG3RxParamsValid[DRV_G3_MACRT_RX_QUEUE_SIZE];
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File scope functions
@@ -238,18 +242,20 @@ void DRV_G3_MACRT_Init(DRV_G3_MACRT_OBJ *g3MacRt)
     gG3MacRtObj = g3MacRt;
 
     /* Clear PLC events information */
-    gG3MacRtObj->evDataIndLength[0] = 0;
-    gG3MacRtObj->evDataIndLength[1] = 0;
     gG3MacRtObj->evRegRspLength = 0;
     gG3MacRtObj->evMacSnifLength = 0;
     gG3MacRtObj->evPhySnifLength = 0;
     gG3MacRtObj->evCommStatus = false;
-    gG3MacRtObj->evRxParams[0] = false;
-    gG3MacRtObj->evRxParams[1] = false;
+    gG3MacRtObj->evRxParams = false;
     gG3MacRtObj->evResetTxCfm = false;
     gG3MacRtObj->evTxCfm = false;
-    gG3MacRtObj->evDataIndLengthIndex = 0;
-    gG3MacRtObj->evRxParamsIndex = 0;
+
+    /* Clear RX queue */
+    gG3MacRtObj->rxQueueIn = 0;
+    gG3MacRtObj->rxQueueOut = 0;
+    gG3MacRtObj->rxQueueNum = 0;
+    gG3MacRtObj->rxStats.rxQueueOverflows = 0;
+    gG3MacRtObj->rxStats.rxQueueMaxLevel = 0;
 
     /* Enable external interrupt from PLC */
     gG3MacRtObj->plcHal->enableExtInt(true);
@@ -294,66 +300,38 @@ void DRV_G3_MACRT_Task(void)
         gG3MacRtObj->state = DRV_G3_MACRT_STATE_READY;
     }
 
-    if (gG3MacRtObj->evRxParams[0])
+    /* Report received frames in order: RX parameters, then data */
+    while (gG3MacRtObj->rxQueueNum > 0U)
     {
-        /* Reset event flag */
-        gG3MacRtObj->evRxParams[0] = false;
+        uint8_t index = gG3MacRtObj->rxQueueOut;
 
-        /* Report to upper layer */
-        if (gG3MacRtObj->rxParamsIndCallback != NULL)
+        if ((gG3RxParamsValid[index]) && (gG3MacRtObj->rxParamsIndCallback != NULL))
         {
+            /* Report to upper layer */
             /* MISRA C-2012 deviation block start */
             /* MISRA C-2012 Rule 11.3 deviated once. Deviation record ID - H3_MISRAC_2012_R_11_3_DR_1 */
-            gG3MacRtObj->rxParamsIndCallback((MAC_RT_RX_PARAMETERS_OBJ *)gG3RxParameters[0]);
+            gG3MacRtObj->rxParamsIndCallback((MAC_RT_RX_PARAMETERS_OBJ *)gG3RxParameters[index]);
             /* MISRA C-2012 deviation block end */
         }
-    }
-    else
-    {
-        if (gG3MacRtObj->evRxParams[1])
-        {
-            /* Reset event flag */
-            gG3MacRtObj->evRxParams[1] = false;
-
-            /* Report to upper layer */
-            if (gG3MacRtObj->rxParamsIndCallback != NULL)
-            {
-                /* MISRA C-2012 deviation block start */
-                /* MISRA C-2012 Rule 11.3 deviated once. Deviation record ID - H3_MISRAC_2012_R_11_3_DR_1 */
-                gG3MacRtObj->rxParamsIndCallback((MAC_RT_RX_PARAMETERS_OBJ *)gG3RxParameters[1]);
-                /* MISRA C-2012 deviation block end */
-            }
-        }
-    }
-
-    if (gG3MacRtObj->evDataIndLength[0] > 0U)
-    {
-        uint16_t evDataLength = gG3MacRtObj->evDataIndLength[0];
-
-        /* Reset event flag */
-        gG3MacRtObj->evDataIndLength[0] = 0U;
 
         if (gG3MacRtObj->dataIndCallback != NULL)
         {
             /* Report to upper layer */
-            gG3MacRtObj->dataIndCallback(gG3RxData[0], evDataLength);
+            gG3MacRtObj->dataIndCallback(gG3RxData[index], gG3RxDataLength[index]);
         }
-    }
-    else
-    {
-        if (gG3MacRtObj->evDataIndLength[1] > 0U)
+
+        /* Release queue entry */
+        index++;
+        if (index == DRV_G3_MACRT_RX_QUEUE_SIZE)
         {
-            uint16_t evDataLength = gG3MacRtObj->evDataIndLength[1];
+            index = 0;
+        }
 
-            /* Reset event flag */
-            gG3MacRtObj->evDataIndLength[1] = 0U;
+        gG3MacRtObj->rxQueueOut = index;
 
-            if (gG3MacRtObj->dataIndCallback != NULL)
-            {
-                /* Report to upper layer */
-                gG3MacRtObj->dataIndCallback(gG3RxData[1], evDataLength);
-            }
-        }
+        gG3MacRtObj->plcHal->enableExtInt(false);
+        gG3MacRtObj->rxQueueNum--;
+        gG3MacRtObj->plcHal->enableExtInt(true);
     }
 
     if (gG3MacRtObj->evMacSnifLength > 0U)
@@ -601,6 +579,16 @@ uint32_t DRV_G3_MACRT_GetTimerReference(const DRV_HANDLE handle)
     return timerReference;
 }
 
+void DRV_G3_MACRT_GetRxStats(const DRV_HANDLE handle, DRV_G3_MACRT_RX_STATS *pStats)
+{
+    if ((handle != DRV_HANDLE_INVALID) && (handle == 0U))
+    {
+        gG3MacRtObj->plcHal->enableExtInt(false);
+        *pStats = gG3MacRtObj->rxStats;
+        gG3MacRtObj->plcHal->enableExtInt(true);
+    }
+}
+
 void DRV_G3_MACRT_ExternalInterruptHandler(uintptr_t context)
 {
     /* Avoid warning */
@@ -628,18 +616,20 @@ void DRV_G3_MACRT_ExternalInterruptHandler(uintptr_t context)
         /* Check RX paramenters indication event */
         if (evObj.evRxParInd)
         {
-            lDRV_G3_MACRT_COMM_SpiReadCmd(RX_PAR_IND_ID, gG3RxParameters[gG3MacRtObj->evRxParamsIndex],
-                    (uint16_t)DRV_G3_MACRT_RX_PAR_SIZE);
-            /* update event flag */
-            gG3MacRtObj->evRxParams[gG3MacRtObj->evRxParamsIndex] = true;
-
-            if (gG3MacRtObj->evRxParamsIndex == 1U)
+            if (gG3MacRtObj->rxQueueNum < DRV_G3_MACRT_RX_QUEUE_SIZE)
             {
-                gG3MacRtObj->evRxParamsIndex = 0;
+                /* Parameters of a frame without data are overwritten */
+                lDRV_G3_MACRT_COMM_SpiReadCmd(RX_PAR_IND_ID, gG3RxParameters[gG3MacRtObj->rxQueueIn],
+                        (uint16_t)DRV_G3_MACRT_RX_PAR_SIZE);
+                /* update event flag */
+                gG3MacRtObj->evRxParams = true;
             }
             else
             {
-                gG3MacRtObj->evRxParamsIndex = 1;
+                uint8_t dummyData;
+
+                /* RX queue full: discard parameters */
+                lDRV_G3_MACRT_COMM_SpiReadCmd(RX_PAR_IND_ID, &dummyData, 1U);
             }
         }
 
@@ -651,19 +641,43 @@ void DRV_G3_MACRT_ExternalInterruptHandler(uintptr_t context)
             {
                 evObj.rcvDataLength = 1U;
             }
-            lDRV_G3_MACRT_COMM_SpiReadCmd(DATA_IND_ID, gG3RxData[gG3MacRtObj->evDataIndLengthIndex],
-                    evObj.rcvDataLength);
-            /* update event flag */
-            gG3MacRtObj->evDataIndLength[gG3MacRtObj->evDataIndLengthIndex] = evObj.rcvDataLength;
 
-            if (gG3MacRtObj->evDataIndLengthIndex == 1U)
+            if (gG3MacRtObj->rxQueueNum < DRV_G3_MACRT_RX_QUEUE_SIZE)
             {
-                gG3MacRtObj->evDataIndLengthIndex = 0;
+                uint8_t index = gG3MacRtObj->rxQueueIn;
+
+                lDRV_G3_MACRT_COMM_SpiReadCmd(DATA_IND_ID, gG3RxData[index],
+                        evObj.rcvDataLength);
+
+                /* Store frame in RX queue */
+                gG3RxDataLength[index] = evObj.rcvDataLength;
+                gG3RxParamsValid[index] = gG3MacRtObj->evRxParams;
+
+                index++;
+                if (index == DRV_G3_MACRT_RX_QUEUE_SIZE)
+                {
+                    index = 0;
+                }
+
+                gG3MacRtObj->rxQueueIn = index;
+                gG3MacRtObj->rxQueueNum++;
+
+                if (gG3MacRtObj->rxQueueNum > gG3MacRtObj->rxStats.rxQueueMaxLevel)
+                {
+                    gG3MacRtObj->rxStats.rxQueueMaxLevel = gG3MacRtObj->rxQueueNum;
+                }
             }
             else
             {
-                gG3MacRtObj->evDataIndLengthIndex = 1;
+                uint8_t dummyData;
+
+                /* RX queue full: count overflow and discard data */
+                gG3MacRtObj->rxStats.rxQueueOverflows++;
+                lDRV_G3_MACRT_COMM_SpiReadCmd(DATA_IND_ID, &dummyData, 1U);
             }
+
+            /* RX parameters are linked to this frame */
+            gG3MacRtObj->evRxParams = false;
         }
 
         /* Check MAC Sniffer event */
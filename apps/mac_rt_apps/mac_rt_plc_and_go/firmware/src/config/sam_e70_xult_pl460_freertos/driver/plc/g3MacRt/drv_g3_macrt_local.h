@@ -150,9 +150,6 @@ typedef struct
     /* Application Exception Callback */
     DRV_G3_MACRT_EXCEPTION_CALLBACK           exceptionCallback;
 
-    /* Event detection flag: data of new reception */
-    volatile uint16_t                         evDataIndLength[2];
-
     /* Event detection flag: length of the response with register content */
     volatile uint16_t                         evRegRspLength;
 
@@ -171,12 +168,20 @@ typedef struct
     /* Event detection flag: Comm Status */
     volatile bool                             evCommStatus;
 
-    /* Event detection flag: RX parameters */
-    volatile bool                             evRxParams[2];
+    /* Event detection flag: RX parameters waiting for the data of the frame */
+    volatile bool                             evRxParams;
+
+    /* Index of the RX queue entry where the next frame is received */
+    volatile uint8_t                          rxQueueIn;
+
+    /* Index of the oldest frame waiting in the RX queue */
+    volatile uint8_t                          rxQueueOut;
+
+    /* Number of frames waiting in the RX queue */
+    volatile uint8_t                          rxQueueNum;
 
-    /* Indices to control in which buffer to receive data and parameters */
-    uint8_t                                   evDataIndLengthIndex;
-    uint8_t                                   evRxParamsIndex;
+    /* RX queue statistics */
+    DRV_G3_MACRT_RX_STATS                     rxStats;
 
     /* Pointer to MAC Sniffer Data Buffer */
     uint8_t                                   *pMacDataSniffer;
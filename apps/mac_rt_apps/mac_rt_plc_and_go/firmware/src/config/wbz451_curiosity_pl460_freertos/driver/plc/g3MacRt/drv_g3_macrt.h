@@ -294,6 +294,30 @@ typedef void ( *DRV_G3_MACRT_DATA_IND_CALLBACK )( uint8_t *pData, uint16_t lengt
 
 typedef void ( *DRV_G3_MACRT_RX_PARAMS_IND_CALLBACK )( MAC_RT_RX_PARAMETERS_OBJ *pParameters );
 
+// *****************************************************************************
+/* G3 MAC RT Driver Reception Statistics
+
+  Summary:
+    Statistics of the reception queue of the G3 MAC RT driver.
+
+  Description:
+    This data type holds the counters of the frames received from PLC
+    transceiver and not reported to the client.
+
+  Remarks:
+    Counters are cleared when the PLC transceiver firmware is started.
+*/
+
+typedef struct
+{
+    /* Frames discarded because the reception queue was full */
+    uint32_t rxQueueOverflows;
+
+    /* Maximum number of frames waiting in the reception queue */
+    uint8_t rxQueueMaxLevel;
+
+} DRV_G3_MACRT_RX_STATS;
+
 // *****************************************************************************
 /* G3 MAC RT Sniffer Event Handler Function Pointer
 
@@ -832,6 +856,49 @@ MAC_RT_STATUS DRV_G3_MACRT_PIBSet(const DRV_HANDLE handle, MAC_RT_PIB_OBJ *pibOb
 */
 uint32_t DRV_G3_MACRT_GetTimerReference(const DRV_HANDLE handle);
 
+// *****************************************************************************
+/* Function:
+    void DRV_G3_MACRT_GetRxStats(const DRV_HANDLE handle,
+        DRV_G3_MACRT_RX_STATS *pStats);
+
+  Summary:
+    Gets the statistics of the reception queue.
+
+  Description:
+    Received frames are kept in a queue of DRV_G3_MACRT_RX_QUEUE_SIZE entries
+    until they are reported to the client from the driver tasks. This function
+    allows to check if frames were lost because the client did not run the
+    driver tasks fast enough.
+
+  Precondition:
+    DRV_G3_MACRT_Open must have been called to obtain a valid opened device
+    handle.
+
+  Parameters:
+    handle - A valid open-instance handle, returned from the driver's open
+             routine.
+
+    pStats - Pointer to the object where the statistics are stored.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_G3_MACRT_RX_STATS rxStats;
+
+    DRV_G3_MACRT_GetRxStats(handle, &rxStats);
+    if (rxStats.rxQueueOverflows > 0U)
+    {
+
+    }
+    </code>
+
+  Remarks:
+    None.
+*/
+void DRV_G3_MACRT_GetRxStats(const DRV_HANDLE handle, DRV_G3_MACRT_RX_STATS *pStats);
+
 // *****************************************************************************
 /* Function:
     void DRV_G3_MACRT_InitCallbackRegister(
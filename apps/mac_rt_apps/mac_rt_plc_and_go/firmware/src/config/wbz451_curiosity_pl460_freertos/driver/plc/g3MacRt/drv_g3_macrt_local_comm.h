@@ -66,6 +66,12 @@ Microchip or any third party.
 #define DRV_G3_MACRT_RX_PAR_SIZE           sizeof(MAC_RT_RX_PARAMETERS_OBJ)
 #define DRV_G3_MACRT_REG_PKT_SIZE          sizeof(MAC_RT_PIB_OBJ)
 
+/* Number of received frames (RX parameters and data) kept until they are
+   reported from DRV_G3_MACRT_Task */
+#ifndef DRV_G3_MACRT_RX_QUEUE_SIZE
+#define DRV_G3_MACRT_RX_QUEUE_SIZE         2U
+#endif
+
 /* FLAG MASKs for set events */
 #define DRV_G3_MACRT_EV_TX_CFM_FLAG_MASK                 (1U << 0)
 #define DRV_G3_MACRT_EV_DATA_IND_FLAG_MASK               (1U << 1)
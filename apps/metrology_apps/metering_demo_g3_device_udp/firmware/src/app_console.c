@@ -52,6 +52,9 @@ Microchip or any third party.
 
 #include "definitions.h"
 #include "app_console.h"
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) && defined(TCPIP_STACK_DRAM_TRACE_ENABLE)
+#include "tcpip/src/tcpip_heap_alloc.h"
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -71,6 +74,12 @@ typedef struct
 #define CONSOLE_TASK_DEFAULT_DELAY_MS_BETWEEN_STATES   10
 #define CONSOLE_TASK_DELAY_MS_BETWEEN_REGS_PRINT       30
 
+/* Maximum harmonic order analyzed by the THD command */
+#define CONSOLE_HARMONIC_BATCH_MAX_ORDER               31
+
+/* Maximum number of load profile records (one day of 15-minute records) */
+#define CONSOLE_LOAD_PROFILE_MAX_RECORDS               96
+
 
 // *****************************************************************************
 /* Application Data
@@ -98,6 +107,9 @@ const APP_CONSOLE_STORAGE_DATA CACHE_ALIGN app_defaultConsoleStorageData = {{'1'
 static APP_ENERGY_ACCUMULATORS energyData;
 static APP_ENERGY_MAX_DEMAND maxDemandLocalObject;
 static DRV_METROLOGY_HARMONICS_RMS harmonicAnalysisRMSData;
+static DRV_METROLOGY_HARMONICS_RMS harmonicBatchRMSData[CONSOLE_HARMONIC_BATCH_MAX_ORDER];
+static DRV_METROLOGY_HARMONICS_THD harmonicBatchTHDData;
+static APP_ENERGY_PROFILE_RECORD loadProfileData[CONSOLE_LOAD_PROFILE_MAX_RECORDS];
 
 /* Local Queue element to request Datalog operations */
 APP_DATALOG_QUEUE_DATA datalogQueueElement;
@@ -130,13 +142,21 @@ static void _commandDCR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandDCS (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandDCW (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandDSR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandDWR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandDWW (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandENC (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandENR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandEVEC(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandEVER(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandEVCR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandEVCW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandHAR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandHPL (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandHPR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandHRR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandHTR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandIDR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandLPR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandIDW (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandMDC (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandMDR (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
@@ -145,6 +165,10 @@ static void _commandRTCR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandRTCW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandTOUR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandTOUW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandTOUCR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandTOUHW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandTOUPW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+static void _commandTOUSW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandRST (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandRLD (SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
 static void _commandHELP(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
@@ -165,14 +189,22 @@ static const SYS_CMD_DESCRIPTOR appCmdTbl[]=
     {"DCS", _commandDCS, ": Save metrology constants to non volatile memory"},
     {"DCW", _commandDCW, ": Write DSP_CONTROL register"},
     {"DSR", _commandDSR, ": Read DSP_ST register"},
+    {"DWR", _commandDWR, ": Read max demand window"},
+    {"DWW", _commandDWW, ": Write max demand window (subinterval minutes, number of subintervals, sliding 0/1)"},
     {"ENC", _commandENC, ": Clear all energy"},
     {"ENR", _commandENR, ": Read energy"},
     {"EVEC",_commandEVEC, ": Clear all event record"},
     {"EVER",_commandEVER, ": Read single event record"},
+    {"EVCR",_commandEVCR, ": Read event detection settings"},
+    {"EVCW",_commandEVCW, ": Write event detection settings"},
     {"HAR", _commandHAR, ": Read harmonic register"},
+    {"HPL", _commandHPL, ": Dump TCP/IP heap trace log (8 bytes records in hex, for host replay)"},
+    {"HPR", _commandHPR, ": Read TCP/IP heap usage and per module trace"},
     {"HRR", _commandHRR, ": Read harmonic Irms/Vrms"},
+    {"HTR", _commandHTR, ": Read THD of all harmonics up to the given order (31 by default)"},
     {"IDR", _commandIDR, ": Read meter id"},
     {"IDW", _commandIDW, ": Write meter id (id length limited to 6 characters)"},
+    {"LPR", _commandLPR, ": Read load profile of the given last hours (24 by default)"},
     {"MDC", _commandMDC, ": Clear all maxim demand and happen time"},
     {"MDR", _commandMDR, ": Read maxim demand"},
     {"PAR", _commandPAR, ": Read measure parameter"},
@@ -180,6 +212,10 @@ static const SYS_CMD_DESCRIPTOR appCmdTbl[]=
     {"RTCW",_commandRTCW, ": Write meter RTC"},
     {"TOUR",_commandTOUR, ": Read meter TOU"},
     {"TOUW",_commandTOUW, ": Write meter TOU"},
+    {"TOUCR",_commandTOUCR, ": Read TOU calendar (day profiles, seasons and holidays)"},
+    {"TOUHW",_commandTOUHW, ": Write TOU holiday (month 0 removes it)"},
+    {"TOUPW",_commandTOUPW, ": Write TOU day profile 1 to 3 (day profile 0 is written with TOUW)"},
+    {"TOUSW",_commandTOUSW, ": Write TOU season (month 0 removes it)"},
     {"RST", _commandRST, ": System reset"},
     {"RLD", _commandRLD, ": Reload Metrology Coprocessor"},
     {"HELP",_commandHELP, ": Help on commands"}
@@ -321,6 +357,25 @@ static void _harmonicAnalysisCallback(uint8_t harmonicNum)
     app_consoleData.state = APP_CONSOLE_STATE_PRINT_HARMONIC_ANALYSIS;
 }
 
+static void _harmonicBatchCallback(uint8_t numHarmonics)
+{
+    app_consoleData.harmonicNumRequest = numHarmonics;
+    app_consoleData.harmonicNumPrint = 0;
+    app_consoleData.state = APP_CONSOLE_STATE_PRINT_HARMONIC_THD;
+}
+
+static void _loadProfileCallback(uint16_t numRecords, bool dataValid)
+{
+    if (!dataValid)
+    {
+        numRecords = 0;
+    }
+
+    app_consoleData.profileNumRecords = numRecords;
+    app_consoleData.profileNumPrint = 0;
+    app_consoleData.state = APP_CONSOLE_STATE_PRINT_LOAD_PROFILE;
+}
+
 static void _calibrationCallback(bool result)
 {
     app_consoleData.calibrationResult = result;
@@ -330,11 +385,73 @@ static void _calibrationCallback(bool result)
 // *****************************************************************************
 // COMMANDS
 // *****************************************************************************
+static TCPIP_STACK_HEAP_HANDLE _getTcpipHeap(void)
+{
+    TCPIP_STACK_HEAP_HANDLE heapH;
+
+    heapH = TCPIP_STACK_HeapHandleGet(TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP, 0);
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_SLAB)
+    if (heapH == 0)
+    {
+        heapH = TCPIP_STACK_HeapHandleGet(TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB, 0);
+    }
+#endif
+
+    return heapH;
+}
+
 static inline void _removePrompt(void)
 {
     SYS_CMD_MESSAGE("\b");
 }
 
+static void _flushDatalog(void)
+{
+    // Store completed events not stored yet
+    APP_EVENTS_StoreEvents();
+
+    // Write cached datalog records
+    datalogQueueElement.userId = APP_DATALOG_USER_CONSOLE;
+    datalogQueueElement.operation = APP_DATALOG_FLUSH;
+    datalogQueueElement.endCallback = NULL;
+    datalogQueueElement.date.year = APP_DATALOG_INVALID_YEAR; /* Not used */
+    datalogQueueElement.date.month = APP_DATALOG_INVALID_MONTH; /* Not used */
+    datalogQueueElement.dataLen = 0;
+    datalogQueueElement.pData = NULL;
+    // Put it in queue
+    APP_DATALOG_SendDatalogData(&datalogQueueElement);
+}
+
+static APP_EVENTS_EVENT_ID _getEventId(char *arg)
+{
+    if (strcmp(arg, "UA") == 0)
+    {
+        return SAG_UA_EVENT_ID;
+    }
+    else if (strcmp(arg, "UB") == 0)
+    {
+        return SAG_UB_EVENT_ID;
+    }
+    else if (strcmp(arg, "UC") == 0)
+    {
+        return SAG_UC_EVENT_ID;
+    }
+    else if (strcmp(arg, "PA") == 0)
+    {
+        return POW_UA_EVENT_ID;
+    }
+    else if (strcmp(arg, "PB") == 0)
+    {
+        return POW_UB_EVENT_ID;
+    }
+    else if (strcmp(arg, "PC") == 0)
+    {
+        return POW_UC_EVENT_ID;
+    }
+
+    return EVENT_INVALID_ID;
+}
+
 static void _commandHELP(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 2)
@@ -1055,6 +1172,54 @@ static void _commandDSR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static void _commandDWR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    if (argc == 1)
+    {
+        // Go to state to read max demand window
+        app_consoleData.state = APP_CONSOLE_STATE_READ_DEMAND_CONFIG;
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    else
+    {
+        // Incorrect param number
+        SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+    }
+}
+
+static void _commandDWW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_ENERGY_DEMAND_CONFIG config;
+    bool parseError = true;
+
+    if (argc == 5)
+    {
+        // Check password from parameters
+        if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
+        {
+            // Correct password, write max demand window
+            config.subintervalMin = (uint8_t)strtol(argv[2], NULL, 10);
+            config.numSubintervals = (uint8_t)strtol(argv[3], NULL, 10);
+            config.sliding = (strtol(argv[4], NULL, 10) != 0);
+            parseError = !APP_ENERGY_SetDemandConfig(&config);
+        }
+    }
+
+    if (parseError)
+    {
+        SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+    }
+    else
+    {
+        SYS_CMD_MESSAGE("Set max demand window is Ok !\r\n");
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+}
+
 static void _commandENC(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 2)
@@ -1157,30 +1322,7 @@ static void _commandEVER(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     if (argc == 3)
     {
         // Extract event id from parameters
-        if (strcmp(argv[1], "UA") == 0)
-        {
-            app_consoleData.eventIdRequest = SAG_UA_EVENT_ID;
-        }
-        else if (strcmp(argv[1], "UB") == 0)
-        {
-            app_consoleData.eventIdRequest = SAG_UB_EVENT_ID;
-        }
-        else if (strcmp(argv[1], "UC") == 0)
-        {
-            app_consoleData.eventIdRequest = SAG_UC_EVENT_ID;
-        }
-        else if (strcmp(argv[1], "PA") == 0)
-        {
-            app_consoleData.eventIdRequest = POW_UA_EVENT_ID;
-        }
-        else if (strcmp(argv[1], "PB") == 0)
-        {
-            app_consoleData.eventIdRequest = POW_UB_EVENT_ID;
-        }
-        else if (strcmp(argv[1], "PC") == 0)
-        {
-            app_consoleData.eventIdRequest = POW_UC_EVENT_ID;
-        }
+        app_consoleData.eventIdRequest = _getEventId(argv[1]);
 
         if (app_consoleData.eventIdRequest != EVENT_INVALID_ID)
         {
@@ -1205,6 +1347,91 @@ static void _commandEVER(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static void _commandEVCR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_EVENTS_EVENT_ID eventId;
+    APP_EVENTS_EVENT_CONFIG config;
+    uint16_t dropped;
+
+    if (argc == 2)
+    {
+        // Extract event id from parameters
+        eventId = _getEventId(argv[1]);
+
+        if (APP_EVENTS_GetEventConfig(eventId, &config))
+        {
+            APP_EVENTS_GetDroppedEvents(eventId, &dropped);
+
+            // Show settings on console (thresholds in V, 0: AFE flag)
+            SYS_CMD_PRINT("%s start=%u.%04uV end=%u.%04uV startPeriods=%u endPeriods=%u dropped=%u\r\n",
+                argv[1],
+                (unsigned int)(config.startThreshold / 10000), (unsigned int)(config.startThreshold % 10000),
+                (unsigned int)(config.endThreshold / 10000), (unsigned int)(config.endThreshold % 10000),
+                config.minStartPeriods, config.minEndPeriods, dropped);
+
+            /* Show console communication icon */
+            APP_DISPLAY_SetSerialCommunication();
+        }
+        else
+        {
+            // Invalid Command
+            SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+        }
+    }
+    else
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+    }
+}
+
+static void _commandEVCW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_EVENTS_EVENT_ID eventId;
+    APP_EVENTS_EVENT_CONFIG config;
+    double startV, endV;
+
+    if (argc == 7)
+    {
+        // Check password from parameters
+        if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
+        {
+            // Extract event id and settings from parameters
+            eventId = _getEventId(argv[2]);
+            startV = strtod(argv[3], NULL);
+            endV = strtod(argv[4], NULL);
+            config.startThreshold = (uint32_t)(startV * 10000);
+            config.endThreshold = (uint32_t)(endV * 10000);
+            config.minStartPeriods = (uint8_t)strtol(argv[5], NULL, 10);
+            config.minEndPeriods = (uint8_t)strtol(argv[6], NULL, 10);
+
+            if ((startV >= 0) && (endV >= 0) && APP_EVENTS_SetEventConfig(eventId, &config))
+            {
+                // Show response on console
+                SYS_CMD_MESSAGE("Set Event Config is Ok !\r\n");
+
+                /* Show console communication icon */
+                APP_DISPLAY_SetSerialCommunication();
+            }
+            else
+            {
+                // Invalid Command
+                SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+            }
+        }
+        else
+        {
+            // Invalid password
+            SYS_CMD_MESSAGE("Invalid password\r\n");
+        }
+    }
+    else
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+    }
+}
+
 static void _commandHAR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     uint8_t idx;
@@ -1269,6 +1496,78 @@ static void _commandHRR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static void _commandHTR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    uint8_t harmonicNum = CONSOLE_HARMONIC_BATCH_MAX_ORDER;
+
+    if (argc > 2)
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+        return;
+    }
+
+    if (argc == 2)
+    {
+        // Extract maximum harmonic number from parameters
+        harmonicNum = (uint8_t)strtol(argv[1], NULL, 10);
+        if ((harmonicNum < 2) || (harmonicNum > CONSOLE_HARMONIC_BATCH_MAX_ORDER))
+        {
+            SYS_CMD_PRINT("Harmonic order must be between 2 and %d\r\n", CONSOLE_HARMONIC_BATCH_MAX_ORDER);
+            return;
+        }
+    }
+
+    // Request fundamental and all harmonics up to harmonicNum in a single batch
+    if (APP_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1, harmonicNum)) == false)
+    {
+        SYS_CMD_MESSAGE("Previous harmonic analysis is running\r\n");
+    }
+    else
+    {
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    // Response will be provided on _harmonicBatchCallback function
+}
+
+static void _commandHPR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    if (argc == 1)
+    {
+        // Print heap usage, the trace entries are printed from the first one
+        app_consoleData.heapTraceIx = 0;
+        app_consoleData.state = APP_CONSOLE_STATE_PRINT_HEAP_INFO;
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    else
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+    }
+}
+
+static void _commandHPL(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    if (argc == 1)
+    {
+        // Dump heap trace log records
+        app_consoleData.heapLogCount = 0;
+        app_consoleData.heapLogLost = 0;
+        app_consoleData.state = APP_CONSOLE_STATE_PRINT_HEAP_LOG;
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    else
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+    }
+}
+
 static void _commandIDR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 1)
@@ -1323,6 +1622,56 @@ static void _commandIDW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static void _commandLPR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    struct tm sysTime;
+    uint32_t hours = 24;
+    uint32_t timeEnd;
+    uint32_t timeStart;
+
+    if (argc > 2)
+    {
+        // Incorrect parameter number
+        SYS_CMD_MESSAGE("Incorrect param number\r\n");
+        return;
+    }
+
+    if (argc == 2)
+    {
+        // Extract number of hours from parameters
+        hours = (uint32_t)strtol(argv[1], NULL, 10);
+        if (hours == 0)
+        {
+            SYS_CMD_MESSAGE("Incorrect param\r\n");
+            return;
+        }
+    }
+
+    // Get time range from current time
+    RTC_TimeGet(&sysTime);
+    timeEnd = APP_ENERGY_GetTimeStamp(&sysTime);
+    if (timeEnd > (hours * 3600))
+    {
+        timeStart = timeEnd - (hours * 3600);
+    }
+    else
+    {
+        timeStart = 0;
+    }
+
+    // Get load profile from energy app
+    if (APP_ENERGY_GetProfile(timeStart, timeEnd) == false)
+    {
+        SYS_CMD_MESSAGE("Energy app is busy\r\n");
+    }
+    else
+    {
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    // Response will be provided on _loadProfileCallback function
+}
+
 static void _commandMDC(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 2)
@@ -1561,6 +1910,56 @@ static void _commandRTCW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static bool _parseTOUTimeZones(int argc, char** argv, int firstArg, APP_ENERGY_TOU_TIME_ZONE *timeZone)
+{
+    char *p;
+    uint8_t idx;
+    int argIdx;
+
+    for (idx = 0; idx < APP_ENERGY_TOU_MAX_ZONES; idx++)
+    {
+        // Check whether there are arguments left to write
+        argIdx = firstArg + (idx << 1);
+        if (argc > argIdx)
+        {
+            // Extract hour, minute and rate
+            p = argv[argIdx];
+            // Extract hour from argument
+            timeZone[idx].hour = (uint8_t)strtol(p, NULL, 10);
+            // Look for ":" char and advance to next char
+            p = strstr(p, ":");
+            if (p != NULL)
+            {
+                p++;
+                // Extract minute from argument
+                timeZone[idx].minute = (uint8_t)strtol(p, NULL, 10);
+                // Extract rate from next argument
+                timeZone[idx].tariff = (uint8_t)strtol(argv[argIdx + 1], NULL, 10);
+            }
+            else
+            {
+                return false;
+            }
+
+            if ((timeZone[idx].hour > 23) ||
+                (timeZone[idx].minute > 59) ||
+                (timeZone[idx].tariff > TARIFF_4))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // No more arguments, fill TOU index with invalid data
+            timeZone[idx].hour = 0;
+            timeZone[idx].minute = 0;
+            timeZone[idx].tariff = TARIFF_INVALID;
+        }
+    }
+
+    return true;
+}
+
 static void _commandTOUR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 1)
@@ -1580,9 +1979,7 @@ static void _commandTOUR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 
 static void _commandTOUW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
-    char *p;
     APP_ENERGY_TOU_TIME_ZONE timeZone[APP_ENERGY_TOU_MAX_ZONES];
-    uint8_t idx, argIdx;
     bool parseError = false;
 
     if ((argc > 3) && ((argc - 2) % 2 == 0))
@@ -1591,48 +1988,7 @@ static void _commandTOUW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
         if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
         {
              // Correct password, write TOW
-             for (idx = 0; idx < APP_ENERGY_TOU_MAX_ZONES; idx++)
-             {
-                // Check whether there are arguments left to write
-                argIdx = ((idx << 1) + 2);
-                if (argc > argIdx)
-                {
-                    // Extract hour, minute and rate
-                    p = argv[argIdx];
-                    // Extract hour from argument
-                    timeZone[idx].hour = (uint8_t)strtol(p, NULL, 10);
-                    // Look for ":" char and advance to next char
-                    p = strstr(p, ":");
-                    if (p != NULL)
-                    {
-                        p++;
-                        // Extract minute from argument
-                        timeZone[idx].minute = (uint8_t)strtol(p, NULL, 10);
-                        // Extract rate from next argument
-                        timeZone[idx].tariff = (uint8_t)strtol(argv[argIdx + 1], NULL, 10);
-                    }
-                    else
-                    {
-                        parseError = true;
-                        break;
-                    }
-
-                    if ((timeZone[idx].hour > 23) ||
-                        (timeZone[idx].minute > 59) ||
-                        (timeZone[idx].tariff > TARIFF_4))
-                    {
-                            parseError = true;
-                            break;
-                    }
-                }
-                else
-                {
-                    // No more arguments, fill TOU index with invalid data
-                    timeZone[idx].hour = 0;
-                    timeZone[idx].minute = 0;
-                    timeZone[idx].tariff = TARIFF_INVALID;
-                }
-             }
+             parseError = !_parseTOUTimeZones(argc, argv, 2, timeZone);
         }
         else
         {
@@ -1665,6 +2021,148 @@ static void _commandTOUW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
     }
 }
 
+static void _commandTOUCR(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    if (argc == 1)
+    {
+        // Go to state to read TOU calendar
+        app_consoleData.calendarNumPrint = 0;
+        app_consoleData.state = APP_CONSOLE_STATE_READ_TOU_CALENDAR;
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+    else
+    {
+        // Incorrect param number
+        SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+    }
+}
+
+static void _setTOUCalendar(APP_ENERGY_TOU_CALENDAR *calendar, bool parseError)
+{
+    if ((parseError) || (APP_ENERGY_SetTOUCalendar(calendar) == false))
+    {
+        SYS_CMD_MESSAGE("Unsupported Command !\r\n");
+    }
+    else
+    {
+        // Clear No-persistent energy/demand data
+        APP_ENERGY_ClearEnergy(false);
+        APP_ENERGY_ClearMaxDemand(false);
+
+        SYS_CMD_MESSAGE("Set TOU calendar is Ok !\r\n");
+
+        /* Show console communication icon */
+        APP_DISPLAY_SetSerialCommunication();
+    }
+}
+
+static void _commandTOUPW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_ENERGY_TOU_CALENDAR calendar;
+    uint8_t profile;
+    bool parseError = true;
+
+    if ((argc > 4) && ((argc - 3) % 2 == 0))
+    {
+        // Check password from parameters
+        if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
+        {
+            // Correct password, write day profile. Day profile 0 is TOUW table
+            profile = (uint8_t)strtol(argv[2], NULL, 10);
+            if ((profile > 0) && (profile < APP_ENERGY_TOU_MAX_DAY_PROFILES))
+            {
+                calendar = *APP_ENERGY_GetTOUCalendar();
+                parseError = !_parseTOUTimeZones(argc, argv, 3, calendar.dayProfile[profile - 1]);
+            }
+        }
+    }
+
+    _setTOUCalendar(&calendar, parseError);
+}
+
+static void _commandTOUSW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_ENERGY_TOU_CALENDAR calendar;
+    APP_ENERGY_TOU_SEASON *pSeason;
+    uint8_t season, dayType;
+    bool parseError = true;
+
+    // Season, start month and day, and day profile of workdays, saturdays and
+    // sundays. Only season and month 0 to remove the season
+    if ((argc == 8) || (argc == 4))
+    {
+        // Check password from parameters
+        if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
+        {
+            // Correct password, write season
+            season = (uint8_t)strtol(argv[2], NULL, 10);
+            if ((season > 0) && (season <= APP_ENERGY_TOU_MAX_SEASONS))
+            {
+                calendar = *APP_ENERGY_GetTOUCalendar();
+                pSeason = &calendar.season[season - 1];
+                memset(pSeason, 0, sizeof(APP_ENERGY_TOU_SEASON));
+                pSeason->month = (uint8_t)strtol(argv[3], NULL, 10);
+                if (argc == 8)
+                {
+                    pSeason->day = (uint8_t)strtol(argv[4], NULL, 10);
+                    for (dayType = 0; dayType < APP_ENERGY_DAY_TYPE_NUM; dayType++)
+                    {
+                        pSeason->dayProfile[dayType] = (uint8_t)strtol(argv[5 + dayType], NULL, 10);
+                    }
+                    parseError = (pSeason->month == 0);
+                }
+                else
+                {
+                    parseError = (pSeason->month != 0);
+                }
+            }
+        }
+    }
+
+    _setTOUCalendar(&calendar, parseError);
+}
+
+static void _commandTOUHW(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    APP_ENERGY_TOU_CALENDAR calendar;
+    APP_ENERGY_TOU_HOLIDAY *pHoliday;
+    uint8_t holiday;
+    bool parseError = true;
+
+    // Holiday, month, day and day profile. Only holiday and month 0 to remove
+    // the holiday
+    if ((argc == 6) || (argc == 4))
+    {
+        // Check password from parameters
+        if (strncmp(argv[1], metPwd, APP_CONSOLE_MET_PWD_SIZE) == 0)
+        {
+            // Correct password, write holiday
+            holiday = (uint8_t)strtol(argv[2], NULL, 10);
+            if ((holiday > 0) && (holiday <= APP_ENERGY_TOU_MAX_HOLIDAYS))
+            {
+                calendar = *APP_ENERGY_GetTOUCalendar();
+                pHoliday = &calendar.holiday[holiday - 1];
+                memset(pHoliday, 0, sizeof(APP_ENERGY_TOU_HOLIDAY));
+                pHoliday->month = (uint8_t)strtol(argv[3], NULL, 10);
+                if (argc == 6)
+                {
+                    pHoliday->day = (uint8_t)strtol(argv[4], NULL, 10);
+                    pHoliday->dayProfile = (uint8_t)strtol(argv[5], NULL, 10);
+                    parseError = (pHoliday->month == 0);
+                }
+                else
+                {
+                    parseError = (pHoliday->month != 0);
+                }
+            }
+        }
+    }
+
+    _setTOUCalendar(&calendar, parseError);
+}
+
 static void _commandRST(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
 {
     if (argc == 2)
@@ -1795,9 +2293,12 @@ void APP_CONSOLE_Tasks ( void )
                 /* Initialize Energy App callbacks */
                 APP_ENERGY_SetMonthEnergyCallback(_monthlyEnergyCallback, &energyData);
                 APP_ENERGY_SetMaxDemandCallback(_maxDemandCallback, &maxDemandLocalObject);
+                APP_ENERGY_SetProfileCallback(_loadProfileCallback, loadProfileData, CONSOLE_LOAD_PROFILE_MAX_RECORDS);
 
                 /* Initialize Metrology App callbacks */
                 APP_METROLOGY_SetHarmonicAnalysisCallback(_harmonicAnalysisCallback, &harmonicAnalysisRMSData);
+                APP_METROLOGY_SetHarmonicBatchCallback(_harmonicBatchCallback, harmonicBatchRMSData,
+                        CONSOLE_HARMONIC_BATCH_MAX_ORDER, &harmonicBatchTHDData);
                 APP_METROLOGY_SetCalibrationCallback(_calibrationCallback);
 
                 app_consoleData.currentWaitForDatalogReady = 0;
@@ -2412,6 +2913,91 @@ void APP_CONSOLE_Tasks ( void )
             break;
         }
 
+        case APP_CONSOLE_STATE_READ_TOU_CALENDAR:
+        {
+            APP_ENERGY_TOU_CALENDAR * calendar;
+            APP_ENERGY_TOU_TIME_ZONE * timeZone;
+            uint8_t profile, idx;
+
+            calendar = APP_ENERGY_GetTOUCalendar();
+
+            if (app_consoleData.calendarNumPrint == 0)
+            {
+                // Remove Prompt symbol
+                _removePrompt();
+
+                SYS_CMD_MESSAGE("TOU calendar is (day profile 0 is TOU table):\r\n");
+                for (profile = 1; profile < APP_ENERGY_TOU_MAX_DAY_PROFILES; profile++)
+                {
+                    SYS_CMD_PRINT("P%d: ", profile);
+                    timeZone = calendar->dayProfile[profile - 1];
+                    for (idx = 0; idx < APP_ENERGY_TOU_MAX_ZONES; idx++, timeZone++)
+                    {
+                        if (timeZone->tariff != TARIFF_INVALID)
+                        {
+                            SYS_CMD_PRINT("TOU%d=%02d:%02d T%d ",
+                                (idx + 1), timeZone->hour, timeZone->minute, timeZone->tariff);
+                        }
+                    }
+                    SYS_CMD_MESSAGE("\r\n");
+                }
+            }
+            else
+            {
+                SYS_CMD_MESSAGE("Seasons (month/day workday saturday sunday):\r\n");
+                for (idx = 0; idx < APP_ENERGY_TOU_MAX_SEASONS; idx++)
+                {
+                    if (calendar->season[idx].month != 0)
+                    {
+                        SYS_CMD_PRINT("S%d=%02d/%02d P%d P%d P%d ", (idx + 1),
+                            calendar->season[idx].month, calendar->season[idx].day,
+                            calendar->season[idx].dayProfile[APP_ENERGY_DAY_TYPE_WORKDAY],
+                            calendar->season[idx].dayProfile[APP_ENERGY_DAY_TYPE_SATURDAY],
+                            calendar->season[idx].dayProfile[APP_ENERGY_DAY_TYPE_SUNDAY]);
+                    }
+                }
+                SYS_CMD_MESSAGE("\r\n");
+                SYS_CMD_MESSAGE("Holidays (month/day profile):\r\n");
+                for (idx = 0; idx < APP_ENERGY_TOU_MAX_HOLIDAYS; idx++)
+                {
+                    if (calendar->holiday[idx].month != 0)
+                    {
+                        SYS_CMD_PRINT("H%d=%02d/%02d P%d ", (idx + 1),
+                            calendar->holiday[idx].month, calendar->holiday[idx].day,
+                            calendar->holiday[idx].dayProfile);
+                    }
+                }
+                SYS_CMD_MESSAGE("\r\n");
+
+                // Go back to IDLE
+                app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+            }
+
+            app_consoleData.calendarNumPrint++;
+            app_consoleData.nextState = app_consoleData.state;
+            app_consoleData.state = APP_CONSOLE_STATE_DELAY;
+            app_consoleData.delayMs = CONSOLE_TASK_DELAY_MS_BETWEEN_REGS_PRINT;
+            break;
+        }
+
+        case APP_CONSOLE_STATE_READ_DEMAND_CONFIG:
+        {
+            APP_ENERGY_DEMAND_CONFIG config;
+
+            APP_ENERGY_GetDemandConfig(&config);
+
+            // Remove Prompt symbol
+            _removePrompt();
+
+            SYS_CMD_PRINT("Max demand window is: %d x %d min %s\r\n",
+                config.numSubintervals, config.subintervalMin,
+                config.sliding ? "sliding" : "block");
+
+            // Go back to IDLE
+            app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+            break;
+        }
+
         case APP_CONSOLE_STATE_PRINT_HARMONIC_ANALYSIS:
         {
             if (app_consoleData.harmonicNumPrint == 0)
@@ -2448,6 +3034,85 @@ void APP_CONSOLE_Tasks ( void )
             break;
         }
 
+        case APP_CONSOLE_STATE_PRINT_HARMONIC_THD:
+        {
+            if (app_consoleData.harmonicNumPrint == 0)
+            {
+                // Remove Prompt symbol
+                _removePrompt();
+
+                // Show received data on console
+                SYS_CMD_PRINT("The calculated THD (%d harmonics):\r\n", app_consoleData.harmonicNumRequest);
+
+                SYS_CMD_MESSAGE("Ithd_A(%)          Ithd_B(%)          Ithd_C(%)\r\n");
+                SYS_CMD_PRINT("%-19.3f%-19.3f%-19.3f\r\n", harmonicBatchTHDData.Ithd_A,
+                        harmonicBatchTHDData.Ithd_B, harmonicBatchTHDData.Ithd_C);
+            }
+            else if (app_consoleData.harmonicNumPrint == 1)
+            {
+                SYS_CMD_MESSAGE("Ithd_N(%)          Vthd_A(%)          Vthd_B(%)\r\n");
+                SYS_CMD_PRINT("%-19.3f%-19.3f%-19.3f\r\n", harmonicBatchTHDData.Ithd_N,
+                        harmonicBatchTHDData.Vthd_A, harmonicBatchTHDData.Vthd_B);
+            }
+            else if (app_consoleData.harmonicNumPrint == 2)
+            {
+                SYS_CMD_MESSAGE("Vthd_C(%)\r\n");
+                SYS_CMD_PRINT("%-19.3f\r\n", harmonicBatchTHDData.Vthd_C);
+
+                // Go back to IDLE
+                app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+            }
+
+            app_consoleData.harmonicNumPrint++;
+            app_consoleData.nextState = app_consoleData.state;
+            app_consoleData.state = APP_CONSOLE_STATE_DELAY;
+            app_consoleData.delayMs = CONSOLE_TASK_DELAY_MS_BETWEEN_REGS_PRINT;
+            break;
+        }
+
+        case APP_CONSOLE_STATE_PRINT_LOAD_PROFILE:
+        {
+            APP_ENERGY_PROFILE_RECORD *pRecord;
+            uint64_t total = 0;
+            uint32_t minutes;
+            int8_t idx;
+
+            if (app_consoleData.profileNumPrint == 0)
+            {
+                // Remove Prompt symbol
+                _removePrompt();
+
+                SYS_CMD_PRINT("Load profile (%d records):\r\n", app_consoleData.profileNumRecords);
+            }
+
+            if (app_consoleData.profileNumPrint < app_consoleData.profileNumRecords)
+            {
+                pRecord = &loadProfileData[app_consoleData.profileNumPrint];
+                for (idx = 0; idx < TARIFF_NUM_TYPE; idx ++)
+                {
+                    total += pRecord->energy.tariff[idx];
+                }
+
+                // Time stamps are in seconds, show time of the day
+                minutes = (pRecord->timeStamp % 86400) / 60;
+                SYS_CMD_PRINT("%02u:%02u Demand=%.3fkW TT=%.2fkWh\r\n", minutes / 60, minutes % 60,
+                        (float)pRecord->demand/1000, (float)total/10000000);
+
+                app_consoleData.profileNumPrint++;
+            }
+
+            if (app_consoleData.profileNumPrint >= app_consoleData.profileNumRecords)
+            {
+                // Go back to IDLE
+                app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+            }
+
+            app_consoleData.nextState = app_consoleData.state;
+            app_consoleData.state = APP_CONSOLE_STATE_DELAY;
+            app_consoleData.delayMs = CONSOLE_TASK_DELAY_MS_BETWEEN_REGS_PRINT;
+            break;
+        }
+
         case APP_CONSOLE_STATE_PRINT_MONTHLY_ENERGY:
         {
             uint64_t total = 0;
@@ -2820,6 +3485,121 @@ void APP_CONSOLE_Tasks ( void )
             break;
         }
 
+        case APP_CONSOLE_STATE_PRINT_HEAP_INFO:
+        {
+            TCPIP_STACK_HEAP_HANDLE heapH = _getTcpipHeap();
+
+            if (app_consoleData.heapTraceIx == 0)
+            {
+                // Remove Prompt symbol
+                _removePrompt();
+
+                if (heapH == 0)
+                {
+                    SYS_CMD_MESSAGE("TCP/IP heap is not available\r\n");
+                    app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+                    break;
+                }
+
+                SYS_CMD_PRINT("TCP/IP heap size: %u, free: %u, max block: %u, high watermark: %u, fragmentation: %u%%\r\n",
+                        (unsigned int)TCPIP_STACK_HEAP_Size(heapH), (unsigned int)TCPIP_STACK_HEAP_FreeSize(heapH),
+                        (unsigned int)TCPIP_STACK_HEAP_MaxSize(heapH), (unsigned int)TCPIP_STACK_HEAP_HighWatermark(heapH),
+                        TCPIP_STACK_HEAP_FragmentationIndex(heapH));
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) && defined(TCPIP_STACK_DRAM_TRACE_ENABLE)
+                SYS_CMD_MESSAGE("Module\tAllocs\tFrees\tCurrent\tPeak\tTotal\tFailed\tMaxFail\r\n");
+#else
+                SYS_CMD_MESSAGE("Heap trace is disabled\r\n");
+                app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+                break;
+#endif
+            }
+
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) && defined(TCPIP_STACK_DRAM_TRACE_ENABLE)
+            {
+                TCPIP_HEAP_TRACE_ENTRY tEntry;
+                uint8_t numEntries = 0;
+                unsigned int maxEntries = TCPIP_HEAP_TraceGetEntriesNo(heapH, false);
+
+                while ((numEntries < 4) && (app_consoleData.heapTraceIx < maxEntries))
+                {
+                    if (TCPIP_HEAP_TraceGetEntry(heapH, app_consoleData.heapTraceIx, &tEntry))
+                    {
+                        SYS_CMD_PRINT("%d\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\r\n", tEntry.moduleId,
+                                (long)tEntry.nAllocs, (long)tEntry.nFrees, (long)tEntry.currAllocated,
+                                (long)tEntry.peakAllocated, (long)tEntry.totAllocated, (long)tEntry.totFailed,
+                                (long)tEntry.maxFailed);
+                        numEntries++;
+                    }
+                    app_consoleData.heapTraceIx++;
+                }
+
+                if (app_consoleData.heapTraceIx >= maxEntries)
+                {
+                    // All entries have been printed
+                    app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+                    break;
+                }
+            }
+
+            app_consoleData.nextState = app_consoleData.state;
+            app_consoleData.state = APP_CONSOLE_STATE_DELAY;
+            app_consoleData.delayMs = CONSOLE_TASK_DEFAULT_DELAY_MS_BETWEEN_STATES;
+#endif
+            break;
+        }
+
+        case APP_CONSOLE_STATE_PRINT_HEAP_LOG:
+        {
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) && defined(TCPIP_STACK_DRAM_TRACE_ENABLE)
+            TCPIP_HEAP_TRACE_RECORD records[4];
+            uint8_t *pData;
+            uint32_t lost;
+            unsigned int numRecords, idx;
+            char hexLine[sizeof(records) * 2 + 1];
+
+            if (app_consoleData.heapLogCount == 0)
+            {
+                // Remove Prompt symbol
+                _removePrompt();
+            }
+
+            // Do not chase the records that keep arriving while dumping
+            numRecords = 0;
+            if (app_consoleData.heapLogCount < TCPIP_STACK_DRAM_TRACE_LOG_SIZE)
+            {
+                numRecords = TCPIP_HEAP_TraceLogRead(_getTcpipHeap(), records, sizeof(records) / sizeof(*records), &lost);
+                app_consoleData.heapLogLost += lost;
+            }
+
+            if (numRecords == 0)
+            {
+                SYS_CMD_PRINT("Heap trace log: %u records, %lu lost\r\n",
+                        app_consoleData.heapLogCount, (unsigned long)app_consoleData.heapLogLost);
+                app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+                break;
+            }
+
+            pData = (uint8_t *)records;
+            for (idx = 0; idx < numRecords * sizeof(*records); idx++)
+            {
+                sprintf(&hexLine[idx * 2], "%02X", pData[idx]);
+            }
+            SYS_CMD_PRINT("%s\r\n", hexLine);
+            app_consoleData.heapLogCount += numRecords;
+
+            app_consoleData.nextState = app_consoleData.state;
+            app_consoleData.state = APP_CONSOLE_STATE_DELAY;
+            app_consoleData.delayMs = CONSOLE_TASK_DEFAULT_DELAY_MS_BETWEEN_STATES;
+#else
+            // Remove Prompt symbol
+            _removePrompt();
+
+            SYS_CMD_MESSAGE("Heap trace is disabled\r\n");
+            app_consoleData.state = APP_CONSOLE_STATE_PROMPT;
+#endif
+            break;
+        }
+
         case APP_CONSOLE_STATE_PRINT_HELP:
         {
             uint8_t idx;
@@ -2862,6 +3642,9 @@ void APP_CONSOLE_Tasks ( void )
             // Update display info
             APP_DISPLAY_ShowLowPowerMode();
 
+            // Write pending data before entering Low Power mode
+            _flushDatalog();
+
             app_consoleData.nextState = app_consoleData.state;
             app_consoleData.state = APP_CONSOLE_STATE_DELAY;
             app_consoleData.delayMs = 100;
@@ -2870,6 +3653,9 @@ void APP_CONSOLE_Tasks ( void )
 
         case APP_CONSOLE_STATE_SW_RESET:
         {
+            // Write pending data before reset
+            _flushDatalog();
+
             /* Wait time to show message through the Console */
             app_consoleData.nextState = app_consoleData.state;
             app_consoleData.state = APP_CONSOLE_STATE_DELAY;
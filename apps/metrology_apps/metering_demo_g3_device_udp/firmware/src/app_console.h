@@ -109,8 +109,12 @@ typedef enum
     APP_CONSOLE_STATE_READ_ALL_HARMONICS_REGS,
     APP_CONSOLE_STATE_READ_METER_ID,
     APP_CONSOLE_STATE_READ_TOU,
+    APP_CONSOLE_STATE_READ_TOU_CALENDAR,
+    APP_CONSOLE_STATE_READ_DEMAND_CONFIG,
     APP_CONSOLE_STATE_READ_RTC,
     APP_CONSOLE_STATE_PRINT_HARMONIC_ANALYSIS,
+    APP_CONSOLE_STATE_PRINT_HARMONIC_THD,
+    APP_CONSOLE_STATE_PRINT_LOAD_PROFILE,
     APP_CONSOLE_STATE_PRINT_MONTHLY_ENERGY,
     APP_CONSOLE_STATE_PRINT_MONTHLY_ENERGY_NEXT,
     APP_CONSOLE_STATE_PRINT_EVENT,
@@ -125,6 +129,8 @@ typedef enum
     APP_CONSOLE_STATE_PRINT_ANGLE,
     APP_CONSOLE_STATE_PRINT_WAVEFORM_DATA,
     APP_CONSOLE_STATE_PRINT_CALIBRATION_RESULT,
+    APP_CONSOLE_STATE_PRINT_HEAP_INFO,
+    APP_CONSOLE_STATE_PRINT_HEAP_LOG,
     APP_CONSOLE_STATE_PRINT_HELP,
     APP_CONSOLE_STATE_LOW_POWER_MODE,
     APP_CONSOLE_STATE_SW_RESET,
@@ -173,10 +179,16 @@ typedef struct
     uint32_t currentWaitForDatalogReady;
     uint8_t harmonicNumRequest;
     uint8_t harmonicNumPrint;
+    uint16_t profileNumRecords;
+    uint16_t profileNumPrint;
+    uint8_t calendarNumPrint;
     bool calibrationResult;
     int8_t numCommands;
     int8_t cmdNumToShowHelp;
     SYS_CMD_DESCRIPTOR *pCmdDescToShowHelp;
+    uint8_t heapTraceIx;
+    uint16_t heapLogCount;
+    uint32_t heapLogLost;
     uint8_t requestCounter;
     SYS_TIME_HANDLE timer;
     uint32_t delayMs;
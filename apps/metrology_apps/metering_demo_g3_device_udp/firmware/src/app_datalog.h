@@ -71,6 +71,24 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 
+/* Number of datalog files kept open between requests.
+ * Must be lower than SYS_FS_MAX_FILES to leave handles for directory accesses */
+#define APP_DATALOG_FILE_HANDLES_NUM          3
+/* Size (in bytes) of the RAM write-back cache used by append operations */
+#define APP_DATALOG_CACHE_SIZE                512
+/* Cached records are flushed to the media once this fill level is reached */
+#define APP_DATALOG_CACHE_FLUSH_THRESHOLD     384
+/* Max time (in ms) that appended records are kept in RAM before being flushed */
+#define APP_DATALOG_CACHE_FLUSH_INTERVAL_MS   60000
+/* Marker used to delimit records in append-only files */
+#define APP_DATALOG_RECORD_MARKER             0xA55A
+/* Number of records per block of the time-series index */
+#define APP_DATALOG_TS_BLOCK_RECORDS          16
+/* Max number of indexed blocks (a month of 15-minute records fits in 186 blocks) */
+#define APP_DATALOG_TS_MAX_BLOCKS             192
+/* Extension of the file where the time-series index of a file is stored */
+#define APP_DATALOG_TS_INDEX_EXTENSION        ".idx"
+
 // *****************************************************************************
 /* Application states
 
@@ -104,8 +122,8 @@ typedef enum
     /* The app writes data to a file from the beginning */
     APP_DATALOG_STATE_WRITE_TO_FILE,
 
-    /* The app closes the file. */
-    APP_DATALOG_STATE_CLOSE_FILE,
+    /* The app commits file data to the media. */
+    APP_DATALOG_STATE_SYNC_FILE,
 
     /* The app reports the result from file operation. */
     APP_DATALOG_STATE_REPORT_RESULT,
@@ -161,6 +179,9 @@ typedef enum
     /* Demand data */
     APP_DATALOG_USER_DEMAND,
 
+    /* Load profile data */
+    APP_DATALOG_USER_PROFILE,
+
     /* Last value used to get number of Users */
     APP_DATALOG_USER_NUM
 
@@ -183,8 +204,17 @@ typedef enum
     /* Append operation */
     APP_DATALOG_APPEND,
 
-    /* Read operation */
-    APP_DATALOG_WRITE
+    /* Write operation */
+    APP_DATALOG_WRITE,
+
+    /* Flush cached records operation */
+    APP_DATALOG_FLUSH,
+
+    /* Read records in a time range operation */
+    APP_DATALOG_READ_RANGE,
+
+    /* Remove all files of the user operation */
+    APP_DATALOG_CLEAR
 
 } APP_DATALOG_OPERATION;
 
@@ -239,6 +269,75 @@ typedef struct
 } APP_DATALOG_DATE;
 
 
+// *****************************************************************************
+/* Application Datalog Record Header
+
+  Summary:
+    Header placed before every record of an append-only file
+
+  Description:
+    Data provided through APP_DATALOG_APPEND operations is stored as a sequence
+    of records. Each record is made of this header followed by the record data.
+    The marker, length and CRC allow detecting records torn by a power loss,
+    which are removed the first time the file is appended after start-up.
+
+  Remarks:
+    CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) of the record data.
+ */
+
+typedef struct
+{
+    // Record marker (APP_DATALOG_RECORD_MARKER)
+    uint16_t marker;
+
+    // Length of record data
+    uint16_t length;
+
+    // CRC of record data
+    uint16_t crc;
+
+} APP_DATALOG_RECORD_HEADER;
+
+
+// *****************************************************************************
+/* Application Datalog Time Range Query
+
+  Summary:
+    Defines a query of records in a time range
+
+  Description:
+    Time-series files are append-only files made of fixed-size records, whose
+    first field is a uint32_t time stamp. APP_DATALOG_READ_RANGE operations use
+    this structure (pointed by pData) to get the records whose time stamp is
+    within the given range.
+
+  Remarks:
+    Records are returned in file order.
+ */
+
+typedef struct
+{
+    // First time stamp of the range
+    uint32_t timeStart;
+
+    // Last time stamp of the range (included)
+    uint32_t timeEnd;
+
+    // Pointer to buffer to store the records found
+    uint8_t *pRecords;
+
+    // Length of every record
+    uint16_t recordLen;
+
+    // Max number of records to store in the buffer
+    uint16_t maxRecords;
+
+    // Number of records found
+    uint16_t numRecords;
+
+} APP_DATALOG_RANGE_QUERY;
+
+
 // *****************************************************************************
 /* Callback to report Datalog Operation end and its result
 
@@ -265,7 +364,7 @@ typedef struct
     // Datalog User ID
     APP_DATALOG_USER userId;
 
-    // Read/ReadPrevious/Write/Append operation
+    // Read/Write/Append/Flush/ReadRange/Clear operation
     APP_DATALOG_OPERATION operation;
 
     // Callback to be invoked at the end of Datalog operation
@@ -317,6 +416,165 @@ typedef struct
 
 } APP_DATALOG_DATA_IN_PROCESS;
 
+// *****************************************************************************
+/* Application Datalog Open File
+
+  Summary:
+    Defines a file kept open between Datalog requests
+
+  Description:
+    Files are opened on their first access and kept open to avoid paying the
+    open/close and directory lookup costs on every request. When all entries are
+    in use, the least recently used one is closed.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    // File Handle (SYS_FS_HANDLE_INVALID if entry is not in use)
+    SYS_FS_HANDLE fileHandle;
+
+    // File Name
+    char fileName[32];
+
+    // Counter value of the last access, used for LRU replacement
+    uint32_t lastAccess;
+
+    // Flag to indicate whether the record sequence has been checked
+    bool recordsChecked;
+
+} APP_DATALOG_OPEN_FILE;
+
+// *****************************************************************************
+/* Application Datalog Write-back Cache
+
+  Summary:
+    Holds appended records pending to be written to the media
+
+  Description:
+    Records appended to the same file are batched in RAM and written with a
+    single file write. The cache is flushed when its fill level reaches
+    APP_DATALOG_CACHE_FLUSH_THRESHOLD, when records have been cached for
+    APP_DATALOG_CACHE_FLUSH_INTERVAL_MS, or before any other access to the file.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    // Cached records
+    uint8_t data[APP_DATALOG_CACHE_SIZE];
+
+    // Number of cached bytes
+    uint16_t size;
+
+    // Index of the open file the cached records belong to
+    uint8_t fileIndex;
+
+    // SYS_TIME counter value when the first record was cached
+    uint64_t timeStamp;
+
+} APP_DATALOG_CACHE;
+
+// *****************************************************************************
+/* Application Datalog Time-series Block
+
+  Summary:
+    Time range covered by a block of records
+
+  Description:
+    Records of time-series files are grouped in blocks of
+    APP_DATALOG_TS_BLOCK_RECORDS records. Blocks whose time range does not
+    overlap the requested one are skipped without being read.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    // Lowest time stamp in the block
+    uint32_t timeMin;
+
+    // Highest time stamp in the block
+    uint32_t timeMax;
+
+} APP_DATALOG_TS_BLOCK;
+
+// *****************************************************************************
+/* Application Datalog Time-series Index
+
+  Summary:
+    Sparse time index of a time-series file
+
+  Description:
+    The index is built on the first range query to a file and it is kept up to
+    date by the following appends to the same file.
+
+    The index is stored next to the indexed file, with the same name and
+    APP_DATALOG_TS_INDEX_EXTENSION extension. When a file is queried again
+    after a reset or after a query to another file, the stored index is
+    loaded and only the records appended after it was stored are read.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    // Time range of every block
+    APP_DATALOG_TS_BLOCK block[APP_DATALOG_TS_MAX_BLOCKS];
+
+    // Name of the indexed file
+    char fileName[32];
+
+    // Number of indexed records
+    uint32_t numRecords;
+
+    // Number of indexed records in the stored index
+    uint32_t savedRecords;
+
+    // Length of every record
+    uint16_t recordLen;
+
+    // Flag to indicate whether the index is valid
+    bool valid;
+
+} APP_DATALOG_TS_INDEX;
+
+// *****************************************************************************
+/* Application Datalog Stored Time-series Index Header
+
+  Summary:
+    Header of a stored time-series index
+
+  Description:
+    The header is followed by the time range of the blocks covering numRecords
+    records. The CRC covers the block data.
+
+  Remarks:
+    None.
+ */
+
+typedef struct
+{
+    // Index marker (APP_DATALOG_RECORD_MARKER)
+    uint16_t marker;
+
+    // Length of every record of the indexed file
+    uint16_t recordLen;
+
+    // Number of indexed records
+    uint32_t numRecords;
+
+    // CRC of block data
+    uint16_t crc;
+
+} APP_DATALOG_TS_INDEX_HEADER;
+
 // *****************************************************************************
 /* Application Data
 
@@ -359,6 +617,18 @@ typedef struct
     /* SYS FS File status structure used in clear data routine */
     SYS_FS_FSTAT stat;
 
+    /* Files kept open between requests */
+    APP_DATALOG_OPEN_FILE openFiles[APP_DATALOG_FILE_HANDLES_NUM];
+
+    /* Access counter used to find the least recently used file */
+    uint32_t accessCounter;
+
+    /* Write-back cache for append operations */
+    APP_DATALOG_CACHE cache;
+
+    /* Time index of the last queried time-series file */
+    APP_DATALOG_TS_INDEX tsIndex;
+
 #if SYS_FS_AUTOMOUNT_ENABLE
     /* The application's next state */
     APP_CONSOLE_STATES nextState;
@@ -537,6 +807,9 @@ bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date);
     This routine clears all data for a given user id.
     As users ids have their own directory, it clear all files in it.
 
+    The request is queued as an APP_DATALOG_CLEAR operation and the files are
+    removed by the Datalog task, after the requests queued before it.
+
   Precondition:
     None.
 
@@ -570,6 +843,10 @@ void APP_DATALOG_ClearData(APP_DATALOG_USER userId);
     The insertion of the new item in the internal queue is done by copying data.
     All items included in the internal queue are processed by the Datalog task.
 
+    APP_DATALOG_APPEND operations store the data as a new record in the
+    write-back cache and the end callback is invoked once the record is cached.
+    Use APP_DATALOG_FLUSH to force cached records to be written to the media.
+
   Precondition:
     None.
 
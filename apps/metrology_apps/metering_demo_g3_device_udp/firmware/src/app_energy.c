@@ -62,6 +62,11 @@ Microchip or any third party.
 extern APP_DATALOG_QUEUE appDatalogQueue;
 APP_DATALOG_QUEUE_DATA appEnergyDatalogQueueData;
 
+/* Load profile record to be stored and time range query of records */
+static APP_ENERGY_PROFILE_RECORD appEnergyProfileRecord;
+static APP_DATALOG_RANGE_QUERY appEnergyProfileQuery;
+static APP_DATALOG_DATE appEnergyProfileDate;
+
 /* Define a queue to signal the Energy Tasks to process new energy measurement */
 APP_ENERGY_QUEUE appEnergyQueue;
 
@@ -100,6 +105,7 @@ APP_ENERGY_DATA app_energyData;
 const uint8_t app_energyDayTbl[12] = {0x31, 0x28, 0x31, 0x30, 0x31, 0x30, 0x31, 0x31, 0x30, 0x31, 0x30, 0x31};
 const char app_energyMonthTbl[12][3] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 const uint8_t app_energyDayWeekTbl[12] = {6, 2, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+const uint16_t app_energyDaysBeforeMonthTbl[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
 
 const APP_ENERGY_TOU_TIME_ZONE gAppEnergyTOUDefault[APP_ENERGY_TOU_MAX_ZONES] =
 {
@@ -200,6 +206,18 @@ void _APP_ENERGY_GetDemandDataLogCallback(APP_DATALOG_RESULT result)
     }
 }
 
+void _APP_ENERGY_GetProfileDataLogCallback(APP_DATALOG_RESULT result)
+{
+    if (result == APP_DATALOG_RESULT_SUCCESS)
+    {
+        app_energyData.dataIsRdy = true;
+        app_energyData.profileNumRecords += appEnergyProfileQuery.numRecords;
+    }
+
+    /* Handle Task state */
+    app_energyData.state = APP_ENERGY_STATE_RESPONSE_PROFILE;
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Local Functions
@@ -240,54 +258,207 @@ static bool _APP_ENERGY_ReceiveEnergyData(APP_ENERGY_QUEUE_DATA *energyData)
     return false;
 }
 
-static uint8_t _APP_ENERGY_getTOUIndex(struct tm * time)
+static uint8_t _APP_ENERGY_CompileDayProfile(APP_ENERGY_TOU_TIME_ZONE *pZones,
+        APP_ENERGY_TOU_TRANSITION *pTransitions)
+{
+    APP_ENERGY_TOU_TRANSITION transition;
+    uint8_t numTransitions = 0;
+    uint8_t index, pos;
+
+    for (index = 0; index < APP_ENERGY_TOU_MAX_ZONES; index++)
+    {
+        if ((pZones[index].tariff < TARIFF_1) || (pZones[index].tariff > TARIFF_NUM_TYPE) ||
+            (pZones[index].hour > 23) || (pZones[index].minute > 59))
+        {
+            continue;
+        }
+
+        /* The start minute of a zone still belongs to the previous zone, as
+           the minute event at hh:mm closes the previous minute */
+        transition.minute = ((pZones[index].hour * 60) + pZones[index].minute + 1) % APP_ENERGY_TOU_MINUTES_DAY;
+        transition.tariffIndex = pZones[index].tariff - 1;
+
+        /* Insert sorted by minute of the day */
+        pos = numTransitions;
+        while ((pos > 0) && (pTransitions[pos - 1].minute > transition.minute))
+        {
+            pTransitions[pos] = pTransitions[pos - 1];
+            pos--;
+        }
+
+        pTransitions[pos] = transition;
+        numTransitions++;
+    }
+
+    return numTransitions;
+}
+
+static void _APP_ENERGY_CompileTOU(void)
 {
-    uint32_t value, slotValue;
+    APP_ENERGY_TOU_SCHEDULE *pSchedule = &app_energyData.touSchedule;
     uint8_t index;
-    uint8_t counterZones;
-    uint8_t result = 0;
 
-    counterZones = app_energyData.tou.usedZones;
-    result = counterZones - 1;
+    pSchedule->numTransitions[0] = _APP_ENERGY_CompileDayProfile(app_energyData.tou.timeZone,
+            pSchedule->transition[0]);
 
-    value = (time->tm_hour * 100) + time->tm_min;
-    for (index = 0; index < counterZones; index++)
+    for (index = 1; index < APP_ENERGY_TOU_MAX_DAY_PROFILES; index++)
     {
-        slotValue = (app_energyData.tou.timeZone[index].hour * 100) + app_energyData.tou.timeZone[index].minute;
-        if (value < slotValue)
-        {
-            if (index != 0)
-            {
-                result = index - 1;
-            }
+        pSchedule->numTransitions[index] = _APP_ENERGY_CompileDayProfile(app_energyData.tou.calendar.dayProfile[index - 1],
+                pSchedule->transition[index]);
+    }
+
+    /* Force a new lookup of the day profile */
+    pSchedule->dayKey = UINT32_MAX;
+}
 
+static uint8_t _APP_ENERGY_GetDayProfile(struct tm * time)
+{
+    APP_ENERGY_TOU_CALENDAR *pCalendar = &app_energyData.tou.calendar;
+    uint16_t dateKey, seasonKey;
+    uint16_t seasonStartKey = 0;
+    uint16_t lastStartKey = 0;
+    uint8_t index, dayType;
+    uint8_t profile = 0;
+    int8_t season = -1;
+    int8_t lastSeason = -1;
+    bool holiday = false;
+
+    dateKey = ((time->tm_mon + 1) << 5) | time->tm_mday;
+
+    /* Holidays override the day profile of the season */
+    for (index = 0; index < APP_ENERGY_TOU_MAX_HOLIDAYS; index++)
+    {
+        if ((pCalendar->holiday[index].month != 0) &&
+            (((pCalendar->holiday[index].month << 5) | pCalendar->holiday[index].day) == dateKey))
+        {
+            profile = pCalendar->holiday[index].dayProfile;
+            holiday = true;
             break;
         }
     }
 
-    if ((app_energyData.tou.timeZone[result].hour == time->tm_hour) &&
-        (app_energyData.tou.timeZone[result].minute == time->tm_min))
+    if (!holiday)
     {
-        if (result == 0)
+        if (time->tm_wday == 6)
+        {
+            dayType = APP_ENERGY_DAY_TYPE_SATURDAY;
+        }
+        else if (time->tm_wday == 0)
         {
-            result = counterZones - 1;
+            dayType = APP_ENERGY_DAY_TYPE_SUNDAY;
         }
         else
         {
-            result--;
+            dayType = APP_ENERGY_DAY_TYPE_WORKDAY;
+        }
+
+        /* Current season has the latest start date not after today. Before the
+           first start date of the year, the last season of the previous year applies */
+        for (index = 0; index < APP_ENERGY_TOU_MAX_SEASONS; index++)
+        {
+            if (pCalendar->season[index].month == 0)
+            {
+                continue;
+            }
+
+            seasonKey = (pCalendar->season[index].month << 5) | pCalendar->season[index].day;
+            if ((seasonKey <= dateKey) && ((season < 0) || (seasonKey >= seasonStartKey)))
+            {
+                season = index;
+                seasonStartKey = seasonKey;
+            }
+
+            if ((lastSeason < 0) || (seasonKey >= lastStartKey))
+            {
+                lastSeason = index;
+                lastStartKey = seasonKey;
+            }
         }
 
+        if (season < 0)
+        {
+            season = lastSeason;
+        }
+
+        if (season >= 0)
+        {
+            profile = pCalendar->season[season].dayProfile[dayType];
+        }
     }
 
-    return result;
+    /* Day profiles without valid zones fall back to the default day profile */
+    if ((profile >= APP_ENERGY_TOU_MAX_DAY_PROFILES) ||
+        (app_energyData.touSchedule.numTransitions[profile] == 0))
+    {
+        profile = 0;
+    }
+
+    return profile;
 }
 
 static APP_ENERGY_TARIFF_TYPE _APP_ENERGY_getTariffIndex(struct tm * time)
 {
-    uint8_t touIndex;
+    APP_ENERGY_TOU_SCHEDULE *pSchedule = &app_energyData.touSchedule;
+    APP_ENERGY_TOU_TRANSITION *pTransitions;
+    uint32_t dayKey;
+    uint16_t minute;
+    uint8_t numTransitions;
+    uint8_t index;
+
+    dayKey = ((uint32_t)time->tm_year << 9) | ((time->tm_mon + 1) << 5) | time->tm_mday;
+    minute = (time->tm_hour * 60) + time->tm_min;
+
+    /* Tariff is kept until the next transition of the day is reached */
+    if ((dayKey == pSchedule->dayKey) && (minute >= pSchedule->currentMinute) &&
+        (minute < pSchedule->nextMinute))
+    {
+        return (APP_ENERGY_TARIFF_TYPE)pSchedule->tariffIndex;
+    }
+
+    if (dayKey != pSchedule->dayKey)
+    {
+        pSchedule->dayKey = dayKey;
+        pSchedule->dayProfile = _APP_ENERGY_GetDayProfile(time);
+    }
 
-    touIndex = _APP_ENERGY_getTOUIndex(time);
-    return (app_energyData.tou.timeZone[touIndex].tariff - 1);
+    pTransitions = pSchedule->transition[pSchedule->dayProfile];
+    numTransitions = pSchedule->numTransitions[pSchedule->dayProfile];
+
+    if (numTransitions == 0)
+    {
+        /* No valid zones at all */
+        pSchedule->tariffIndex = 0;
+        pSchedule->currentMinute = 0;
+        pSchedule->nextMinute = APP_ENERGY_TOU_MINUTES_DAY;
+    }
+    else if (minute < pTransitions[0].minute)
+    {
+        /* Before the first transition, the last zone of the day applies */
+        pSchedule->tariffIndex = pTransitions[numTransitions - 1].tariffIndex;
+        pSchedule->currentMinute = 0;
+        pSchedule->nextMinute = pTransitions[0].minute;
+    }
+    else
+    {
+        index = 0;
+        while (((index + 1) < numTransitions) && (pTransitions[index + 1].minute <= minute))
+        {
+            index++;
+        }
+
+        pSchedule->tariffIndex = pTransitions[index].tariffIndex;
+        pSchedule->currentMinute = pTransitions[index].minute;
+        if ((index + 1) < numTransitions)
+        {
+            pSchedule->nextMinute = pTransitions[index + 1].minute;
+        }
+        else
+        {
+            pSchedule->nextMinute = APP_ENERGY_TOU_MINUTES_DAY;
+        }
+    }
+
+    return (APP_ENERGY_TARIFF_TYPE)pSchedule->tariffIndex;
 }
 
 static bool _APP_ENERGY_CheckRTCFromReset(void)
@@ -362,16 +533,80 @@ static bool _APP_ENERGY_InitializeRTC(bool dataValid)
     return rtcBuildValue;
 }
 
-static void _APP_ENERGY_InitializeTOU(bool dataValid)
+static void _APP_ENERGY_SetDefaultTOUCalendar(void)
+{
+    APP_ENERGY_TOU_CALENDAR *pCalendar = &app_energyData.tou.calendar;
+    uint8_t profile, index;
+
+    /* No seasons nor holidays: default day profile applies every day */
+    memset(pCalendar, 0, sizeof(APP_ENERGY_TOU_CALENDAR));
+    for (profile = 0; profile < (APP_ENERGY_TOU_MAX_DAY_PROFILES - 1); profile++)
+    {
+        for (index = 0; index < APP_ENERGY_TOU_MAX_ZONES; index++)
+        {
+            pCalendar->dayProfile[profile][index].tariff = TARIFF_INVALID;
+        }
+    }
+
+    pCalendar->marker = APP_ENERGY_TOU_CALENDAR_MARKER;
+}
+
+static bool _APP_ENERGY_CheckDemandConfig(APP_ENERGY_DEMAND_CONFIG *config)
+{
+    uint32_t windowMin;
+
+    /* Subintervals must be aligned to the hour */
+    if ((config->subintervalMin == 0) || ((60 % config->subintervalMin) != 0) ||
+        (config->numSubintervals == 0) ||
+        (config->numSubintervals > APP_ENERGY_DEMAND_MAX_SUBINTERVALS))
+    {
+        return false;
+    }
+
+    /* Block windows must be aligned to the hour */
+    windowMin = (uint32_t)config->subintervalMin * config->numSubintervals;
+    if ((!config->sliding) && ((windowMin > 60) || ((60 % windowMin) != 0)))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static void _APP_ENERGY_SetDefaultDemandConfig(void)
+{
+    /* Max demand by default: 15 minutes block window */
+    app_energyData.tou.demandConfig.subintervalMin = 15;
+    app_energyData.tou.demandConfig.numSubintervals = 1;
+    app_energyData.tou.demandConfig.sliding = false;
+}
+
+static bool _APP_ENERGY_InitializeTOU(bool dataValid)
 {
     struct tm time;
     uint8_t counterZones = 0;
     uint8_t index;
+    bool updated = false;
 
     if (!dataValid)
     {
         /* Set TOU by default */
         memcpy(&app_energyData.tou.timeZone, &gAppEnergyTOUDefault, sizeof(app_energyData.tou.timeZone));
+        updated = true;
+    }
+
+    if ((!dataValid) || (app_energyData.tou.calendar.marker != APP_ENERGY_TOU_CALENDAR_MARKER))
+    {
+        /* TOU data stored without calendar */
+        _APP_ENERGY_SetDefaultTOUCalendar();
+        updated = true;
+    }
+
+    if ((!dataValid) || (!_APP_ENERGY_CheckDemandConfig(&app_energyData.tou.demandConfig)))
+    {
+        /* TOU data stored without demand window */
+        _APP_ENERGY_SetDefaultDemandConfig();
+        updated = true;
     }
 
     /* Count used zones */
@@ -384,18 +619,25 @@ static void _APP_ENERGY_InitializeTOU(bool dataValid)
     }
     app_energyData.tou.usedZones = counterZones;
 
+    /* Build TOU schedule */
+    _APP_ENERGY_CompileTOU();
+
     /* Update current Tariff Type */
     RTC_TimeGet(&time);
     app_energyData.currentTariffIndex = _APP_ENERGY_getTariffIndex(&time);
+
+    return updated;
 }
 
 static bool _APP_ENERGY_UpdateDemand(uint32_t demand, struct tm * time)
 {
+    APP_ENERGY_DEMAND_CONFIG *pConfig = &app_energyData.tou.demandConfig;
+    APP_ENERGY_DEMAND *pDemand = &app_energyData.demand;
     uint32_t demandPeriod = 0;
     uint32_t demandMax = 0;
     uint8_t index = 0;
-    uint8_t winStartOffset = 0;
     uint8_t minIndex = 0;
+    bool evaluate = false;
     bool update = false;
 
     demandPeriod = demand / app_energyData.counterIntegrationPeriods;
@@ -412,50 +654,70 @@ static bool _APP_ENERGY_UpdateDemand(uint32_t demand, struct tm * time)
 
     app_energyData.demand.window[minIndex] = demandPeriod;
 
-    /* Get Max Demand : averaged over 15 minutes window */
-    if (minIndex >= 45)
-    {
-        winStartOffset = 45;
-    }
-    else if (time->tm_min >= 30)
+    /* Get average demand of the load profile period. Units are 0.1W, so divided by 10 */
+    if (((minIndex + 1) % APP_ENERGY_PROFILE_PERIOD_MIN) == 0)
     {
-        winStartOffset = 30;
-    }
-    else if (time->tm_min >= 15)
-    {
-        winStartOffset = 15;
-    }
-
-    for (index = 0; index < 15; index++)
-    {
-        demandMax += app_energyData.demand.window[winStartOffset + index];
+        app_energyData.profileDemand = 0;
+        for (index = minIndex + 1 - APP_ENERGY_PROFILE_PERIOD_MIN; index <= minIndex; index++)
+        {
+            app_energyData.profileDemand += app_energyData.demand.window[index];
+        }
+        app_energyData.profileDemand /= (APP_ENERGY_PROFILE_PERIOD_MIN * 10);
     }
 
-    /* Divided by 15. Units are 0.1W, so divided by 10 */
-    demandMax /= 150;
+    /* Accumulate demand of the current subinterval */
+    pDemand->subintervalSum += demandPeriod;
 
-    /* Update Demand Max according TOU Zone */
-    if (app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].value < demandMax)
+    if (((minIndex + 1) % pConfig->subintervalMin) == 0)
     {
-        app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].value = demandMax;
-        app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].month = time->tm_mon;
-        app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].day = time->tm_mday;
-        app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].hour = time->tm_hour;
-        app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].minute = time->tm_min;
+        /* End of subinterval: replace the oldest subinterval of the window */
+        pDemand->windowSum -= pDemand->subinterval[pDemand->subintervalIndex];
+        pDemand->subinterval[pDemand->subintervalIndex] = pDemand->subintervalSum;
+        pDemand->windowSum += pDemand->subintervalSum;
+        pDemand->subintervalSum = 0;
+
+        pDemand->subintervalIndex++;
+        if (pDemand->subintervalIndex >= pConfig->numSubintervals)
+        {
+            pDemand->subintervalIndex = 0;
+        }
 
-        update = true;
+        /* Sliding windows are evaluated every subinterval, block windows at the end of the block */
+        if ((pConfig->sliding) ||
+            (((minIndex + 1) % (pConfig->subintervalMin * pConfig->numSubintervals)) == 0))
+        {
+            /* Average over the window. Units are 0.1W, so divided by 10 */
+            demandMax = (uint32_t)(pDemand->windowSum /
+                    ((uint32_t)pConfig->subintervalMin * pConfig->numSubintervals * 10));
+            evaluate = true;
+        }
     }
 
-    /* Update Demand Max in total */
-    if (app_energyData.demand.maxDemand.maxDemad.value < demandMax)
+    if (evaluate)
     {
-        app_energyData.demand.maxDemand.maxDemad.value = demandMax;
-        app_energyData.demand.maxDemand.maxDemad.month = time->tm_mon;
-        app_energyData.demand.maxDemand.maxDemad.day = time->tm_mday;
-        app_energyData.demand.maxDemand.maxDemad.hour = time->tm_hour;
-        app_energyData.demand.maxDemand.maxDemad.minute = time->tm_min;
+        /* Update Demand Max according TOU Zone */
+        if (app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].value < demandMax)
+        {
+            app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].value = demandMax;
+            app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].month = time->tm_mon;
+            app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].day = time->tm_mday;
+            app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].hour = time->tm_hour;
+            app_energyData.demand.maxDemand.tariff[app_energyData.currentTariffIndex].minute = time->tm_min;
+
+            update = true;
+        }
+
+        /* Update Demand Max in total */
+        if (app_energyData.demand.maxDemand.maxDemad.value < demandMax)
+        {
+            app_energyData.demand.maxDemand.maxDemad.value = demandMax;
+            app_energyData.demand.maxDemand.maxDemad.month = time->tm_mon;
+            app_energyData.demand.maxDemand.maxDemad.day = time->tm_mday;
+            app_energyData.demand.maxDemand.maxDemad.hour = time->tm_hour;
+            app_energyData.demand.maxDemand.maxDemad.minute = time->tm_min;
 
-        update = true;
+            update = true;
+        }
     }
 
     // Clean Demand Window
@@ -571,6 +833,71 @@ static void _APP_ENERGY_StoreDemandDataInMemory(struct tm * time, void *pData)
     APP_DATALOG_SendDatalogData(&appEnergyDatalogQueueData);
 }
 
+static void _APP_ENERGY_StoreProfileDataInMemory(struct tm * time)
+{
+    appEnergyProfileRecord.timeStamp = APP_ENERGY_GetTimeStamp(time);
+    appEnergyProfileRecord.demand = app_energyData.profileDemand;
+    appEnergyProfileRecord.energy = app_energyData.energyAccumulator;
+
+    appEnergyDatalogQueueData.userId = APP_DATALOG_USER_PROFILE;
+    appEnergyDatalogQueueData.operation = APP_DATALOG_APPEND;
+    appEnergyDatalogQueueData.pData = (uint8_t *)&appEnergyProfileRecord;
+    appEnergyDatalogQueueData.dataLen = sizeof(APP_ENERGY_PROFILE_RECORD);
+    appEnergyDatalogQueueData.date.month = time->tm_mon + 1;
+    appEnergyDatalogQueueData.date.year = time->tm_year - 100;
+    appEnergyDatalogQueueData.endCallback = NULL;
+
+    APP_DATALOG_SendDatalogData(&appEnergyDatalogQueueData);
+}
+
+static void _APP_ENERGY_LoadProfileDataFromMemory(APP_DATALOG_DATE * date)
+{
+    appEnergyProfileQuery.timeStart = app_energyData.profileTimeStart;
+    appEnergyProfileQuery.timeEnd = app_energyData.profileTimeEnd;
+    appEnergyProfileQuery.pRecords = (uint8_t *)&app_energyData.pProfileResponse[app_energyData.profileNumRecords];
+    appEnergyProfileQuery.recordLen = sizeof(APP_ENERGY_PROFILE_RECORD);
+    appEnergyProfileQuery.maxRecords = app_energyData.profileMaxRecords - app_energyData.profileNumRecords;
+    appEnergyProfileQuery.numRecords = 0;
+
+    appEnergyDatalogQueueData.userId = APP_DATALOG_USER_PROFILE;
+    appEnergyDatalogQueueData.operation = APP_DATALOG_READ_RANGE;
+    appEnergyDatalogQueueData.pData = (uint8_t *)&appEnergyProfileQuery;
+    appEnergyDatalogQueueData.dataLen = sizeof(APP_DATALOG_RANGE_QUERY);
+    appEnergyDatalogQueueData.date = *date;
+    appEnergyDatalogQueueData.endCallback = _APP_ENERGY_GetProfileDataLogCallback;
+
+    APP_DATALOG_SendDatalogData(&appEnergyDatalogQueueData);
+}
+
+static void _APP_ENERGY_GetDateFromTimeStamp(uint32_t timeStamp, APP_DATALOG_DATE * date)
+{
+    uint32_t days = timeStamp / 86400;
+    uint16_t daysYear;
+    uint8_t month;
+    uint8_t leap;
+
+    /* Years from 2000 */
+    date->year = 0;
+    daysYear = 366;
+    while (days >= daysYear)
+    {
+        days -= daysYear;
+        date->year++;
+        daysYear = ((date->year % 4) == 0) ? 366 : 365;
+    }
+
+    /* Month (range 1-12) */
+    leap = ((date->year % 4) == 0) ? 1 : 0;
+    for (month = 11; month > 0; month--)
+    {
+        if (days >= (app_energyDaysBeforeMonthTbl[month] + ((month > 1) ? leap : 0)))
+        {
+            break;
+        }
+    }
+    date->month = month + 1;
+}
+
 static void _APP_ENERGY_CheckTamperDetection(void)
 {
     /* Check the Tamper Event Counter value */
@@ -607,6 +934,7 @@ void APP_ENERGY_Initialize (void)
      /* Initialize Energy callbacks */
     app_energyData.maxDemandCallback = NULL;
     app_energyData.monthEnergyCallback = NULL;
+    app_energyData.profileCallback = NULL;
 
     /* Clear RTC TIME & CALENDAR events */
     app_energyData.eventMinute = false;
@@ -621,6 +949,9 @@ void APP_ENERGY_Initialize (void)
     /* Clear Demand data */
     memset(&app_energyData.demand, 0, sizeof(APP_ENERGY_DEMAND));
 
+    /* Max demand by default, until TOU data is read from memory */
+    _APP_ENERGY_SetDefaultDemandConfig();
+
     /* Clear the counter of integration periods */
     app_energyData.counterIntegrationPeriods = 0;
 
@@ -719,11 +1050,9 @@ void APP_ENERGY_Tasks (void)
 
         case APP_ENERGY_STATE_SET_TOU:
         {
-            _APP_ENERGY_InitializeTOU(app_energyData.dataIsRdy);
-
-            if (app_energyData.dataIsRdy == false)
+            if (_APP_ENERGY_InitializeTOU(app_energyData.dataIsRdy))
             {
-                /* There is no valid data in memory. Create TOU Data in memory. */
+                /* There is no valid or complete data in memory. Create TOU Data in memory. */
                 _APP_ENERGY_StoreTOUDataInMemory();
             }
 
@@ -828,6 +1157,12 @@ void APP_ENERGY_Tasks (void)
                     app_energyData.demandAccumulator = 0;
                     app_energyData.counterIntegrationPeriods = 0;
 
+                    /* Store load profile record at the end of every period */
+                    if ((app_energyData.time.tm_min % APP_ENERGY_PROFILE_PERIOD_MIN) == 0)
+                    {
+                        _APP_ENERGY_StoreProfileDataInMemory(&app_energyData.time);
+                    }
+
                     /* Update ENERGY DATALOG once per hour. Ensure SST endurance. */
                     if (app_energyData.time.tm_min == 0)
                     {
@@ -952,6 +1287,57 @@ void APP_ENERGY_Tasks (void)
             break;
         }
 
+        case APP_ENERGY_STATE_GET_PROFILE:
+        {
+            /* Records of every month are stored in a different file */
+            if (APP_DATALOG_FileExists(APP_DATALOG_USER_PROFILE, &appEnergyProfileDate))
+            {
+                /* PROFILE data exists */
+                _APP_ENERGY_LoadProfileDataFromMemory(&appEnergyProfileDate);
+                /* Wait for loading data from memory */
+                app_energyData.state = APP_ENERGY_STATE_WAIT_DATA;
+            }
+            else
+            {
+                app_energyData.state = APP_ENERGY_STATE_RESPONSE_PROFILE;
+            }
+
+            break;
+        }
+
+        case APP_ENERGY_STATE_RESPONSE_PROFILE:
+        {
+            APP_DATALOG_DATE dateEnd;
+
+            _APP_ENERGY_GetDateFromTimeStamp(app_energyData.profileTimeEnd, &dateEnd);
+
+            if ((app_energyData.profileNumRecords < app_energyData.profileMaxRecords) &&
+                ((appEnergyProfileDate.year < dateEnd.year) ||
+                 ((appEnergyProfileDate.year == dateEnd.year) && (appEnergyProfileDate.month < dateEnd.month))))
+            {
+                /* Continue with the next month */
+                if (appEnergyProfileDate.month == 12)
+                {
+                    appEnergyProfileDate.month = 1;
+                    appEnergyProfileDate.year++;
+                }
+                else
+                {
+                    appEnergyProfileDate.month++;
+                }
+
+                app_energyData.state = APP_ENERGY_STATE_GET_PROFILE;
+            }
+            else
+            {
+                app_energyData.profileCallback(app_energyData.profileNumRecords, app_energyData.dataIsRdy);
+
+                app_energyData.state = APP_ENERGY_STATE_RUNNING;
+            }
+
+            break;
+        }
+
         case APP_ENERGY_STATE_WAIT_DATA:
         {
             /* Waiting Data from DataLog */
@@ -981,6 +1367,82 @@ void APP_ENERGY_SetTOUTimeZone(APP_ENERGY_TOU_TIME_ZONE *timeZone)
     _APP_ENERGY_StoreTOUDataInMemory();
 }
 
+APP_ENERGY_TOU_CALENDAR * APP_ENERGY_GetTOUCalendar(void)
+{
+    return &app_energyData.tou.calendar;
+}
+
+bool APP_ENERGY_SetTOUCalendar(APP_ENERGY_TOU_CALENDAR *calendar)
+{
+    uint8_t index, dayType;
+
+    /* Check calendar entries */
+    for (index = 0; index < APP_ENERGY_TOU_MAX_SEASONS; index++)
+    {
+        if (calendar->season[index].month == 0)
+        {
+            continue;
+        }
+
+        if ((calendar->season[index].month > 12) || (calendar->season[index].day == 0) ||
+            (calendar->season[index].day > 31))
+        {
+            return false;
+        }
+
+        for (dayType = 0; dayType < APP_ENERGY_DAY_TYPE_NUM; dayType++)
+        {
+            if (calendar->season[index].dayProfile[dayType] >= APP_ENERGY_TOU_MAX_DAY_PROFILES)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (index = 0; index < APP_ENERGY_TOU_MAX_HOLIDAYS; index++)
+    {
+        if ((calendar->holiday[index].month != 0) &&
+            ((calendar->holiday[index].month > 12) || (calendar->holiday[index].day == 0) ||
+             (calendar->holiday[index].day > 31) ||
+             (calendar->holiday[index].dayProfile >= APP_ENERGY_TOU_MAX_DAY_PROFILES)))
+        {
+            return false;
+        }
+    }
+
+    /* Set TOU calendar */
+    memcpy(&app_energyData.tou.calendar, calendar, sizeof(APP_ENERGY_TOU_CALENDAR));
+    app_energyData.tou.calendar.marker = APP_ENERGY_TOU_CALENDAR_MARKER;
+    _APP_ENERGY_InitializeTOU(true);
+    _APP_ENERGY_StoreTOUDataInMemory();
+
+    return true;
+}
+
+void APP_ENERGY_GetDemandConfig(APP_ENERGY_DEMAND_CONFIG *config)
+{
+    *config = app_energyData.tou.demandConfig;
+}
+
+bool APP_ENERGY_SetDemandConfig(APP_ENERGY_DEMAND_CONFIG *config)
+{
+    if (!_APP_ENERGY_CheckDemandConfig(config))
+    {
+        return false;
+    }
+
+    app_energyData.tou.demandConfig = *config;
+    _APP_ENERGY_StoreTOUDataInMemory();
+
+    /* Restart demand window */
+    memset(app_energyData.demand.subinterval, 0, sizeof(app_energyData.demand.subinterval));
+    app_energyData.demand.windowSum = 0;
+    app_energyData.demand.subintervalSum = 0;
+    app_energyData.demand.subintervalIndex = 0;
+
+    return true;
+}
+
 void APP_ENERGY_SetMonthEnergyCallback(APP_ENERGY_MONTH_CALLBACK callback,
         APP_ENERGY_ACCUMULATORS * pMonthEnergyResponse)
 {
@@ -1012,13 +1474,59 @@ void APP_ENERGY_ClearEnergy(bool clearPersistentData)
 {
     if (clearPersistentData)
     {
-        /* Erase all the energy records stored in non volatile memory */
+        /* Erase all the energy and load profile records stored in non volatile memory */
         APP_DATALOG_ClearData(APP_DATALOG_USER_ENERGY);
+        APP_DATALOG_ClearData(APP_DATALOG_USER_PROFILE);
     }
     /* Clear Energy Accumulators */
     memset(&app_energyData.energyAccumulator, 0, sizeof(APP_ENERGY_ACCUMULATORS));
 }
 
+uint32_t APP_ENERGY_GetTimeStamp(struct tm * time)
+{
+    uint32_t years;
+    uint32_t days;
+
+    /* Seconds since 01/01/2000 00:00:00 (valid until 2099) */
+    years = time->tm_year - 100;
+    days = (years * 365) + ((years + 3) / 4);
+    days += app_energyDaysBeforeMonthTbl[time->tm_mon];
+    if (((years % 4) == 0) && (time->tm_mon > 1))
+    {
+        days++;
+    }
+    days += time->tm_mday - 1;
+
+    return (((days * 24) + time->tm_hour) * 60 + time->tm_min) * 60 + time->tm_sec;
+}
+
+void APP_ENERGY_SetProfileCallback(APP_ENERGY_PROFILE_CALLBACK callback,
+        APP_ENERGY_PROFILE_RECORD * pProfileResponse, uint16_t maxRecords)
+{
+    app_energyData.profileCallback = callback;
+    app_energyData.pProfileResponse = pProfileResponse;
+    app_energyData.profileMaxRecords = maxRecords;
+}
+
+bool APP_ENERGY_GetProfile(uint32_t timeStart, uint32_t timeEnd)
+{
+    if ((app_energyData.profileCallback) && (app_energyData.state == APP_ENERGY_STATE_RUNNING) &&
+        (timeStart <= timeEnd))
+    {
+        app_energyData.profileTimeStart = timeStart;
+        app_energyData.profileTimeEnd = timeEnd;
+        app_energyData.profileNumRecords = 0;
+        /* Reset flag to request data to datalog app */
+        app_energyData.dataIsRdy = false;
+        /* Start looking for records in the month of the first time stamp */
+        _APP_ENERGY_GetDateFromTimeStamp(timeStart, &appEnergyProfileDate);
+        app_energyData.state = APP_ENERGY_STATE_GET_PROFILE;
+        return true;
+    }
+
+    return false;
+}
+
 void APP_ENERGY_SetMaxDemandCallback(APP_ENERGY_MAXDEMAND_CALLBACK callback,
         APP_ENERGY_MAX_DEMAND * pMaxDemandResponse)
 {
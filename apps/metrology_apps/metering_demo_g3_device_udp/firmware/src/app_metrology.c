@@ -67,6 +67,12 @@ extern APP_EVENTS_QUEUE appEventsQueue;
 
 extern DRV_METROLOGY_INIT drvMetrologyInitData;
 
+/* Compressed waveform window and start of every chunk in it */
+static uint8_t appMetrologyWaveformData[APP_METROLOGY_WAVEFORM_BUFFER_SIZE];
+static uint16_t appMetrologyWaveformChunk[APP_METROLOGY_WAVEFORM_MAX_CHUNKS + 1];
+static uint32_t appMetrologyWaveformSamples[APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES * APP_METROLOGY_WAVEFORM_MAX_CHANNELS];
+static uint8_t appMetrologyWaveformBlock[APP_METROLOGY_WAVEFORM_BLOCK_MAX_SIZE];
+
 const char * _met_control_desc[] =
 {
   "00 STATE_CTRL",
@@ -298,6 +304,249 @@ static void _APP_METROLOGY_StoreControlInMemory(DRV_METROLOGY_REGS_CONTROL * con
     APP_DATALOG_SendDatalogData(&appMetrologyDatalogQueueData);
 }
 
+static uint8_t _APP_METROLOGY_PutVarint(uint8_t *pData, uint32_t value)
+{
+    uint8_t length = 0;
+
+    while (value >= 0x80)
+    {
+        pData[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    pData[length++] = (uint8_t)value;
+
+    return length;
+}
+
+static uint16_t _APP_METROLOGY_EncodeWaveformBlock(uint8_t *pData, uint32_t *pSamples,
+        uint8_t numChannels, uint16_t numSamples)
+{
+    uint32_t sample, residual;
+    uint32_t prev1 = 0;
+    uint32_t prev2 = 0;
+    uint16_t length = 0;
+    uint16_t index;
+    uint8_t channel;
+
+    for (channel = 0; channel < numChannels; channel++)
+    {
+        for (index = 0; index < numSamples; index++)
+        {
+            sample = pSamples[(index * numChannels) + channel];
+
+            if (index == 0)
+            {
+                /* First sample is coded as is, and the second one as a delta */
+                prev1 = sample;
+                prev2 = sample;
+                residual = sample;
+            }
+            else
+            {
+                /* Second order prediction. Modulo 2^32 arithmetic is lossless */
+                residual = sample - (2U * prev1) + prev2;
+                prev2 = prev1;
+                prev1 = sample;
+            }
+
+            /* Zigzag and variable-length coding */
+            length += _APP_METROLOGY_PutVarint(&pData[length],
+                    (residual << 1) ^ (0U - (residual >> 31)));
+        }
+    }
+
+    return length;
+}
+
+static uint32_t _APP_METROLOGY_GetWaveformElapsedSamples(void)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    uint64_t elapsedMs;
+    uint32_t sampleRate;
+
+    if (pWaveform->source == CAPTURE_SOURCE_16KHZ)
+    {
+        sampleRate = 16000;
+    }
+    else
+    {
+        sampleRate = 4000;
+    }
+
+    elapsedMs = (SYS_TIME_Counter64Get() - pWaveform->triggerTime) / SYS_TIME_MSToCount(1);
+
+    /* Round up to be on the safe side */
+    return (uint32_t)(((elapsedMs + 1) * sampleRate) / 1000);
+}
+
+static void _APP_METROLOGY_TriggerWaveform(void)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    uint32_t offset;
+    bool wrapped;
+
+    offset = DRV_METROLOGY_GetCaptureOffset(&wrapped);
+
+    /* Pre-trigger samples are limited by the samples captured so far */
+    pWaveform->triggerPreSamples = APP_METROLOGY_WAVEFORM_PRE_SAMPLES;
+    if ((wrapped == false) && ((offset / pWaveform->numChannels) < APP_METROLOGY_WAVEFORM_PRE_SAMPLES))
+    {
+        pWaveform->triggerPreSamples = offset / pWaveform->numChannels;
+    }
+
+    pWaveform->triggerOffset = offset;
+    pWaveform->triggerTime = SYS_TIME_Counter64Get();
+    pWaveform->state = APP_METROLOGY_WAVEFORM_TRIGGERED;
+}
+
+static void _APP_METROLOGY_CompressWaveform(void)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    APP_METROLOGY_WAVEFORM_INFO *pInfo = &pWaveform->info;
+    uint32_t bufferSize = DRV_METROLOGY_GetCaptureBufferSize();
+    uint32_t offset;
+    uint16_t numSamples, sample, blockSamples;
+    uint16_t blockLength, chunkLength;
+    uint16_t length = 0;
+    uint16_t numChunks = 0;
+    uint8_t numChannels = pWaveform->numChannels;
+
+    /* The previous window is not valid while the new one is compressed */
+    pInfo->captureId = 0;
+
+    numSamples = pWaveform->triggerPreSamples + APP_METROLOGY_WAVEFORM_POST_SAMPLES;
+    offset = (pWaveform->triggerOffset + bufferSize -
+            ((uint32_t)pWaveform->triggerPreSamples * numChannels)) % bufferSize;
+
+    chunkLength = 0;
+    for (sample = 0; sample < numSamples; sample += blockSamples)
+    {
+        blockSamples = numSamples - sample;
+        if (blockSamples > APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES)
+        {
+            blockSamples = APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES;
+        }
+
+        DRV_METROLOGY_GetCaptureData(offset + ((uint32_t)sample * numChannels),
+                appMetrologyWaveformSamples, (uint32_t)blockSamples * numChannels);
+        blockLength = _APP_METROLOGY_EncodeWaveformBlock(appMetrologyWaveformBlock,
+                appMetrologyWaveformSamples, numChannels, blockSamples);
+
+        if ((numChunks == 0) || ((chunkLength + blockLength) > APP_METROLOGY_WAVEFORM_CHUNK_SIZE))
+        {
+            /* Window is truncated if the compressed data does not fit */
+            if ((numChunks == APP_METROLOGY_WAVEFORM_MAX_CHUNKS) ||
+                ((length + sizeof(sample) + blockLength) > APP_METROLOGY_WAVEFORM_BUFFER_SIZE))
+            {
+                break;
+            }
+
+            /* Every chunk starts with the index of its first sample */
+            appMetrologyWaveformChunk[numChunks++] = length;
+            memcpy(&appMetrologyWaveformData[length], &sample, sizeof(sample));
+            length += sizeof(sample);
+            chunkLength = sizeof(sample);
+        }
+        else if ((length + blockLength) > APP_METROLOGY_WAVEFORM_BUFFER_SIZE)
+        {
+            break;
+        }
+
+        memcpy(&appMetrologyWaveformData[length], appMetrologyWaveformBlock, blockLength);
+        length += blockLength;
+        chunkLength += blockLength;
+    }
+
+    appMetrologyWaveformChunk[numChunks] = length;
+
+    pInfo->numSamples = sample;
+    pInfo->preSamples = pWaveform->triggerPreSamples;
+    pInfo->numChunks = numChunks;
+    pInfo->channels = pWaveform->channels;
+    pInfo->source = (uint8_t)pWaveform->source;
+}
+
+static void _APP_METROLOGY_CheckWaveformEvents(void)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    DRV_METROLOGY_AFE_EVENTS events;
+    bool eventActive;
+
+    if ((pWaveform->state == APP_METROLOGY_WAVEFORM_STOPPED) || (pWaveform->eventTrigger == false))
+    {
+        return;
+    }
+
+    DRV_METROLOGY_GetEventsData(&events);
+    eventActive = (events.sagA || events.sagB || events.sagC ||
+            events.swellA || events.swellB || events.swellC);
+
+    /* Trigger at the beginning of sag/swell events */
+    if ((eventActive == true) && (pWaveform->eventActive == false))
+    {
+        pWaveform->triggerRequest = true;
+    }
+
+    pWaveform->eventActive = eventActive;
+}
+
+static void _APP_METROLOGY_WaveformTasks(void)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    uint32_t bufferSamples, offset, writtenSamples;
+
+    if ((pWaveform->state == APP_METROLOGY_WAVEFORM_ARMED) && (pWaveform->triggerRequest == true))
+    {
+        pWaveform->triggerRequest = false;
+        _APP_METROLOGY_TriggerWaveform();
+    }
+
+    if (pWaveform->state != APP_METROLOGY_WAVEFORM_TRIGGERED)
+    {
+        return;
+    }
+
+    bufferSamples = DRV_METROLOGY_GetCaptureBufferSize() / pWaveform->numChannels;
+
+    /* Check that the pre-trigger samples have not been overwritten yet */
+    if ((_APP_METROLOGY_GetWaveformElapsedSamples() + pWaveform->triggerPreSamples) >= bufferSamples)
+    {
+        pWaveform->info.lostCount++;
+        pWaveform->state = APP_METROLOGY_WAVEFORM_ARMED;
+        return;
+    }
+
+    /* Wait for the post-trigger samples */
+    offset = DRV_METROLOGY_GetCaptureOffset(NULL);
+    writtenSamples = ((offset + DRV_METROLOGY_GetCaptureBufferSize() - pWaveform->triggerOffset) %
+            DRV_METROLOGY_GetCaptureBufferSize()) / pWaveform->numChannels;
+    if (writtenSamples < APP_METROLOGY_WAVEFORM_POST_SAMPLES)
+    {
+        return;
+    }
+
+    _APP_METROLOGY_CompressWaveform();
+
+    /* Capture continues while compressing: check the window is still valid */
+    if ((_APP_METROLOGY_GetWaveformElapsedSamples() + pWaveform->triggerPreSamples) >= bufferSamples)
+    {
+        pWaveform->info.lostCount++;
+    }
+    else
+    {
+        pWaveform->captureCounter++;
+        if (pWaveform->captureCounter == 0)
+        {
+            pWaveform->captureCounter = 1;
+        }
+
+        pWaveform->info.captureId = pWaveform->captureCounter;
+    }
+
+    pWaveform->state = APP_METROLOGY_WAVEFORM_ARMED;
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Callback Functions
@@ -340,6 +589,15 @@ static void _APP_METROLOGY_HarmonicAnalysisCallback(uint8_t harmonicNum)
     }
 }
 
+static void _APP_METROLOGY_HarmonicBatchCallback(uint8_t numHarmonics)
+{
+    if (app_metrologyData.pHarmonicBatchCallback)
+    {
+        app_metrologyData.harmonicAnalysisPending = false;
+        app_metrologyData.pHarmonicBatchCallback(numHarmonics);
+    }
+}
+
 static void _APP_METROLOGY_GetNVMDataCallback(APP_DATALOG_RESULT result)
 {
     if (result == APP_DATALOG_RESULT_SUCCESS)
@@ -386,8 +644,6 @@ void APP_METROLOGY_Initialize (void)
     /* Get Pointers to metrology data regions */
     app_metrologyData.pMetControl = DRV_METROLOGY_GetControlData();
     app_metrologyData.pMetStatus = DRV_METROLOGY_GetStatusData();
-    app_metrologyData.pMetAccData = DRV_METROLOGY_GetAccData();
-    app_metrologyData.pMetHarData = DRV_METROLOGY_GetHarData();
 
     /* Set Callback for each metrology integration process */
     DRV_METROLOGY_IntegrationCallbackRegister(_APP_METROLOGY_IntegrationCallback);
@@ -395,16 +651,25 @@ void APP_METROLOGY_Initialize (void)
     DRV_METROLOGY_CalibrationCallbackRegister(_APP_METROLOGY_CalibrationCallback);
     /* Set Callback for harmonic analysis process */
     DRV_METROLOGY_HarmonicAnalysisCallbackRegister(_APP_METROLOGY_HarmonicAnalysisCallback);
+    /* Set Callback for batch harmonic analysis process */
+    DRV_METROLOGY_HarmonicBatchCallbackRegister(_APP_METROLOGY_HarmonicBatchCallback);
 
     /* Clear Harmonic Analysis Data */
     app_metrologyData.harmonicAnalysisPending = false;
     app_metrologyData.pHarmonicAnalysisCallback = NULL;
     app_metrologyData.pHarmonicAnalysisResponse = NULL;
+    app_metrologyData.pHarmonicBatchCallback = NULL;
+    app_metrologyData.pHarmonicBatchTable = NULL;
+    app_metrologyData.harmonicBatchTableSize = 0;
+    app_metrologyData.pHarmonicBatchThd = NULL;
 
     /* Clear Calibration Data */
     app_metrologyData.pCalibrationCallback = NULL;
     app_metrologyData.calibrationFlag = false;
 
+    /* Waveform capture is started on demand */
+    memset(&app_metrologyData.waveform, 0, sizeof(APP_METROLOGY_WAVEFORM));
+
     /* Initialize integration Flag */
     app_metrologyData.integrationFlag = false;
     app_metrologyData.dataFlag = false;
@@ -532,12 +797,21 @@ void APP_METROLOGY_Tasks (void)
                 // Send new Events to the Events Task
                 RTC_TimeGet(&newEvent.eventTime);
                 DRV_METROLOGY_GetEventsData(&newEvent.eventFlags);
+                newEvent.rmsUA = DRV_METROLOGY_GetRMSValue(RMS_UA);
+                newEvent.rmsUB = DRV_METROLOGY_GetRMSValue(RMS_UB);
+                newEvent.rmsUC = DRV_METROLOGY_GetRMSValue(RMS_UC);
                 if (APP_EVENTS_SendEventsData(&newEvent) == false)
                 {
                     SYS_CMD_MESSAGE("EVENTS Queue is FULL!!!\r\n");
                 }
+
+                // Check waveform capture triggers
+                _APP_METROLOGY_CheckWaveformEvents();
             }
 
+            // Handle waveform capture
+            _APP_METROLOGY_WaveformTasks();
+
             break;
         }
 
@@ -636,7 +910,7 @@ bool APP_METROLOGY_GetAccumulatorRegister(ACCUMULATOR_REG_ID regId, uint64_t * r
         return false;
     }
 
-    pData = (uint64_t *)app_metrologyData.pMetAccData;
+    pData = (uint64_t *)DRV_METROLOGY_GetAccData();
     pData += regId;
     *regValue = *pData;
 
@@ -657,7 +931,7 @@ bool APP_METROLOGY_GetHarmonicsRegister(HARMONICS_REG_ID regId, uint32_t * regVa
         return false;
     }
 
-    pData = (uint32_t *)app_metrologyData.pMetHarData;
+    pData = (uint32_t *)DRV_METROLOGY_GetHarData();
     pData += regId;
     *regValue = *pData;
 
@@ -685,6 +959,11 @@ bool APP_METROLOGY_GetRMS(DRV_METROLOGY_RMS_TYPE rmsId, uint32_t * rmsValue, DRV
     return true;
 }
 
+bool APP_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot)
+{
+    return DRV_METROLOGY_GetSnapshot(snapshot);
+}
+
 void APP_METROLOGY_SetControlByDefault(void)
 {
     DRV_METROLOGY_REGS_CONTROL *pSrc;
@@ -739,6 +1018,91 @@ size_t APP_METROLOGY_GetWaveformCaptureData(uint32_t *address)
     return (size_t)app_metrologyData.pMetControl->CAPTURE_BUFF_SIZE;
 }
 
+bool APP_METROLOGY_StartWaveformCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source, bool eventTrigger)
+{
+    APP_METROLOGY_WAVEFORM *pWaveform = &app_metrologyData.waveform;
+    uint8_t numChannels = 0;
+    uint8_t index;
+
+    if (((channels & DRV_METROLOGY_CAPTURE_CH_MASK) == 0) || (source >= CAPTURE_SOURCE_NUM))
+    {
+        return false;
+    }
+
+    for (index = 0; index < APP_METROLOGY_WAVEFORM_MAX_CHANNELS; index++)
+    {
+        if (channels & (1U << index))
+        {
+            numChannels++;
+        }
+    }
+
+    pWaveform->state = APP_METROLOGY_WAVEFORM_STOPPED;
+    pWaveform->channels = channels & DRV_METROLOGY_CAPTURE_CH_MASK;
+    pWaveform->numChannels = numChannels;
+    pWaveform->source = source;
+    pWaveform->eventTrigger = eventTrigger;
+    pWaveform->eventActive = false;
+    pWaveform->triggerRequest = false;
+
+    DRV_METROLOGY_StartCapture(pWaveform->channels, source);
+
+    pWaveform->state = APP_METROLOGY_WAVEFORM_ARMED;
+
+    return true;
+}
+
+void APP_METROLOGY_StopWaveformCapture(void)
+{
+    app_metrologyData.waveform.state = APP_METROLOGY_WAVEFORM_STOPPED;
+    DRV_METROLOGY_StopCapture();
+}
+
+bool APP_METROLOGY_TriggerWaveformCapture(void)
+{
+    if (app_metrologyData.waveform.state == APP_METROLOGY_WAVEFORM_STOPPED)
+    {
+        return false;
+    }
+
+    /* Trigger is handled by the metrology task */
+    app_metrologyData.waveform.triggerRequest = true;
+
+    return true;
+}
+
+void APP_METROLOGY_GetWaveformInfo(APP_METROLOGY_WAVEFORM_INFO * info)
+{
+    *info = app_metrologyData.waveform.info;
+}
+
+uint16_t APP_METROLOGY_GetWaveformChunk(uint32_t captureId, uint16_t chunkIndex, uint8_t * pData, uint16_t maxSize)
+{
+    APP_METROLOGY_WAVEFORM_INFO *pInfo = &app_metrologyData.waveform.info;
+    uint16_t length;
+
+    if ((captureId == 0) || (pInfo->captureId != captureId) || (chunkIndex >= pInfo->numChunks))
+    {
+        return 0;
+    }
+
+    length = appMetrologyWaveformChunk[chunkIndex + 1] - appMetrologyWaveformChunk[chunkIndex];
+    if (length > maxSize)
+    {
+        return 0;
+    }
+
+    memcpy(pData, &appMetrologyWaveformData[appMetrologyWaveformChunk[chunkIndex]], length);
+
+    /* A new window may have been compressed meanwhile */
+    if (pInfo->captureId != captureId)
+    {
+        return 0;
+    }
+
+    return length;
+}
+
 bool APP_METROLOGY_StartHarmonicAnalysis(uint8_t harmonicNum)
 {
     if (app_metrologyData.harmonicAnalysisPending)
@@ -770,6 +1134,38 @@ void APP_METROLOGY_SetHarmonicAnalysisCallback(DRV_METROLOGY_HARMONICS_CALLBACK
     app_metrologyData.pHarmonicAnalysisResponse = pHarmonicAnalysisResponse;
 }
 
+bool APP_METROLOGY_StartHarmonicAnalysisBatch(uint64_t harmonicBitmap)
+{
+    if (app_metrologyData.harmonicAnalysisPending)
+    {
+        return false;
+    }
+
+    if (app_metrologyData.pHarmonicBatchCallback == NULL)
+    {
+        return false;
+    }
+
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(harmonicBitmap, app_metrologyData.pHarmonicBatchTable,
+            app_metrologyData.harmonicBatchTableSize, app_metrologyData.pHarmonicBatchThd) != DRV_METROLOGY_SUCCESS)
+    {
+        return false;
+    }
+
+    app_metrologyData.harmonicAnalysisPending = true;
+
+    return true;
+}
+
+void APP_METROLOGY_SetHarmonicBatchCallback(DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback,
+        DRV_METROLOGY_HARMONICS_RMS * pHarmonicTable, uint8_t tableSize, DRV_METROLOGY_HARMONICS_THD * pThd)
+{
+    app_metrologyData.pHarmonicBatchCallback = callback;
+    app_metrologyData.pHarmonicBatchTable = pHarmonicTable;
+    app_metrologyData.harmonicBatchTableSize = tableSize;
+    app_metrologyData.pHarmonicBatchThd = pThd;
+}
+
 void APP_METROLOGY_Restart (void)
 {
     DRV_METROLOGY_RESULT result;
@@ -165,7 +165,7 @@ extern "C" {
 /* RF215 Driver Configuration Options */
 #define DRV_RF215_INDEX_0                     0U
 #define DRV_RF215_CLIENTS_NUMBER              1U
-#define DRV_RF215_TX_BUFFERS_NUMBER           1U
+#define DRV_RF215_TX_BUFFERS_NUMBER           3U
 #define DRV_RF215_EXT_INT_PIN                 SYS_PORT_PIN_PB25
 #define DRV_RF215_RESET_PIN                   SYS_PORT_PIN_PB26
 #define DRV_RF215_LED_TX_PIN                  SYS_PORT_PIN_PC21
@@ -176,6 +176,12 @@ extern "C" {
 #define DRV_RF215_MAX_TX_TIME_DELAY_ERROR_US  9000U
 #define DRV_RF215_TIME_SYNC_EXECUTION_CYCLES  180U
 #define DRV_RF215_TX_COMMAND_EXECUTION_CYCLES 1400U
+#define DRV_RF215_PHY_PROFILES_NUMBER         4U
+#define DRV_RF215_RX_STREAM_CHUNK_US          200U
+#define DRV_RF215_TX_SCHEDULE_ENABLE          1U
+#define DRV_RF215_ED_CACHE_CHANNELS           0U
+#define DRV_RF215_ED_CACHE_VALID_US           2000U
+#define DRV_RF215_ED_SCAN_PERIOD_US           0U
 
 
 /* Memory Driver Instance 0 Configuration */
@@ -222,6 +228,8 @@ extern "C" {
 #define DRV_METROLOGY_CONF_WAVEFORM           0xf00UL
 /* Metrology Default Config: Capture Buffer Size */
 #define DRV_METROLOGY_CAPTURE_BUF_SIZE        32000UL
+/* Metrology Computation Engine: 0 = Double precision, 1 = Fixed point */
+#define DRV_METROLOGY_FIXED_POINT_CALC        0U
 
 
 /* SST26 Driver Instance Configuration */
@@ -309,6 +317,11 @@ extern "C" {
 #define TCPIP_IPV6_NDP_VALID_LIFETIME_TWO_HOURS 	(60 * 60 * 2)
 #define TCPIP_IPV6_MTU_INCREASE_TIMEOUT 			600
 #define TCPIP_IPV6_NDP_TASK_TIMER_RATE 				32
+/* Number of hash index slots for the neighbor cache/destination cache
+ * lookups, per interface. 0 disables the index (linear list search).
+ * Entries that do not fit in the index are still found, by a list search. */
+#define TCPIP_IPV6_NDP_NC_HASH_ENTRIES 				11
+#define TCPIP_IPV6_NDP_DC_HASH_ENTRIES 				11
 
 
 /* Network Configuration Index 0 */
@@ -341,7 +354,7 @@ extern "C" {
 #define TCPIP_IPV6_DEFAULT_CUR_HOP_LIMIT 				64
 #define TCPIP_IPV6_DEFAULT_BASE_REACHABLE_TIME 			30
 #define TCPIP_IPV6_DEFAULT_RETRANSMIT_TIME 				1000
-#define TCPIP_IPV6_QUEUE_NEIGHBOR_PACKET_LIMIT 			1
+#define TCPIP_IPV6_QUEUE_NEIGHBOR_PACKET_LIMIT 			4
 #define TCPIP_IPV6_NEIGHBOR_CACHE_ENTRY_STALE_TIMEOUT 	600
 #define TCPIP_IPV6_QUEUE_MCAST_PACKET_LIMIT 			4
 #define TCPIP_IPV6_QUEUED_MCAST_PACKET_TIMEOUT 			10
@@ -352,10 +365,12 @@ extern "C" {
 #define TCPIP_IPV6_ULA_NTP_VALID_WINDOW 				1000
 #define TCPIP_IPV6_FRAGMENT_PKT_TIMEOUT 				60
 #define TCPIP_IPV6_RX_FRAGMENTED_BUFFER_SIZE 			1280
+#define TCPIP_IPV6_TX_TEMPLATE_ENTRIES 				8
 #define TCPIP_IPV6_EXTERN_PACKET_PROCESS   false
 
 
 #define TCPIP_IPV6_G3_PLC_SUPPORT                       true
+#define TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR           true
 
 #define TCPIP_IPV6_G3_PLC_BORDER_ROUTER                 false
 
@@ -366,6 +381,19 @@ extern "C" {
 #define TCPIP_STACK_DRAM_SIZE                       14336
 #define TCPIP_STACK_DRAM_RUN_LIMIT                  2048
 
+/* Slab heap size classes, carved from TCPIP_STACK_DRAM_SIZE. The space left
+ * is used as a first fit heap. Define TCPIP_STACK_USE_INTERNAL_HEAP_SLAB
+ * instead of TCPIP_STACK_USE_INTERNAL_HEAP to use the slab heap.
+ * The first fit heap stays the default: with classes not sized for the
+ * traffic the slab heap fails more allocations. Size them from a heap trace
+ * log with tools/host_tests/heap_replay -s before selecting the slab heap */
+#define TCPIP_STACK_HEAP_SLAB_SMALL_SIZE            64
+#define TCPIP_STACK_HEAP_SLAB_SMALL_BLOCKS          16
+#define TCPIP_STACK_HEAP_SLAB_MEDIUM_SIZE           256
+#define TCPIP_STACK_HEAP_SLAB_MEDIUM_BLOCKS         8
+#define TCPIP_STACK_HEAP_SLAB_LARGE_SIZE            1408
+#define TCPIP_STACK_HEAP_SLAB_LARGE_BLOCKS          4
+
 #define TCPIP_STACK_MALLOC_FUNC                     malloc
 
 #define TCPIP_STACK_CALLOC_FUNC                     calloc
@@ -380,6 +408,12 @@ extern "C" {
 
 #define TCPIP_STACK_SUPPORTED_HEAPS                  1
 
+/* Heap profiling. Define TCPIP_STACK_DRAM_DEBUG_ENABLE and
+ * TCPIP_STACK_DRAM_TRACE_ENABLE to record per module usage and a log of
+ * TCPIP_STACK_DRAM_TRACE_LOG_SIZE records that can be replayed on a host */
+#define TCPIP_STACK_DRAM_TRACE_SLOTS                 20
+#define TCPIP_STACK_DRAM_TRACE_LOG_SIZE              256
+
 
 
 
@@ -419,7 +453,9 @@ extern "C" {
 
 
 /*** UDP Configuration ***/
-#define TCPIP_UDP_MAX_SOCKETS		                	2
+#define TCPIP_UDP_MAX_SOCKETS		                	3
+/* Local port index used to match the RX packets to sockets; 0 disables it */
+#define TCPIP_UDP_PORT_HASH_BUCKETS		                8
 #define TCPIP_UDP_SOCKET_DEFAULT_TX_SIZE		    	1200
 #define TCPIP_UDP_SOCKET_DEFAULT_TX_QUEUE_LIMIT    	 	3
 #define TCPIP_UDP_SOCKET_DEFAULT_RX_QUEUE_LIMIT			3
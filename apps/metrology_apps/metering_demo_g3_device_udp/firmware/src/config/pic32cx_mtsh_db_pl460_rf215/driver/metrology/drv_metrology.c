@@ -155,6 +155,174 @@ static double lDRV_Metrology_GetDouble(int64_t value)
     return (double)value;
 }
 
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+/* CORDIC arctangent table: atan(2^-i) in degrees, scaled by 10^5 and in Q8 format */
+static const int32_t lDRV_Metrology_FxAtanTable[DRV_METROLOGY_FX_CORDIC_ITERATIONS] =
+{
+    1152000000L, 680065310L, 359327833L, 182400419L, 91554160L, 45821712L,
+    22916447L, 11458923L, 5729549L, 2864785L, 1432394L, 716197L,
+    358099L, 179049L, 89525L, 44762L, 22381L, 11191L,
+    5595L, 2798L, 1399L, 699L, 350L, 175L
+};
+
+/* Reciprocal square root seeds: 2^30 / sqrt((i + 16.5) / 64), for the 6 most
+   significant bits of a radicand normalized to [2^30, 2^32) */
+static const uint32_t lDRV_Metrology_FxRsqrtTable[48] =
+{
+    2114695713UL, 2053387115UL, 1997119227UL, 1945237133UL, 1897199172UL, 1852552937UL,
+    1810917218UL, 1771968208UL, 1735428857UL, 1701060526UL, 1668656406UL, 1638036256UL,
+    1609042172UL, 1581535151UL, 1555392273UL, 1530504391UL, 1506774204UL, 1484114654UL,
+    1462447584UL, 1441702596UL, 1421816090UL, 1402730445UL, 1384393311UL, 1366757007UL,
+    1349778000UL, 1333416450UL, 1317635818UL, 1302402522UL, 1287685637UL, 1273456629UL,
+    1259689126UL, 1246358707UL, 1233442724UL, 1220920139UL, 1208771378UL, 1196978204UL,
+    1185523604UL, 1174391680UL, 1163567563UL, 1153037323UL, 1142787899UL, 1132807028UL,
+    1123083182UL, 1113605518UL, 1104363818UL, 1095348453UL, 1086550331UL, 1077960865UL
+};
+
+/* Number of significant bits of value */
+static uint32_t lDRV_Metrology_FxBitLength(uint64_t value)
+{
+    uint32_t hi = (uint32_t)(value >> 32);
+
+    if (hi != 0U)
+    {
+        return 64U - (uint32_t)__CLZ(hi);
+    }
+
+    return 32U - (uint32_t)__CLZ((uint32_t)value);
+}
+
+static uint64_t lDRV_Metrology_FxGetAbs(int64_t value)
+{
+    if (value < 0)
+    {
+        return (uint64_t)(-(value + 1)) + 1U;
+    }
+
+    return (uint64_t)value;
+}
+
+/* Get floor(sqrt(value)). The radicand is normalized to [2^62, 2^64) and its
+   reciprocal square root refined by Newton from the seed table, using 32x32
+   bit multiplications only. The result is then corrected to the exact floor */
+static uint32_t lDRV_Metrology_FxSqrt(uint64_t value)
+{
+    uint64_t a, y, res;
+    uint32_t shift, i;
+
+    if (value == 0U)
+    {
+        return 0U;
+    }
+
+    shift = (64U - lDRV_Metrology_FxBitLength(value)) & ~1U;
+    value <<= shift;
+
+    /* y = 2^30 / sqrt(a / 2^32), 6 bits from the table, 24 after 3 steps */
+    a = value >> 32;
+    y = lDRV_Metrology_FxRsqrtTable[(a >> 26) - 16U];
+    for (i = 0U; i < 3U; i++)
+    {
+        y = (y * ((3ULL << 30) - ((a * ((y * y) >> 30)) >> 32))) >> 31;
+    }
+
+    /* sqrt(a * 2^32) = a * y / 2^30, a few units off */
+    res = (a * y) >> 30;
+    if (res > 0xFFFFFFFFULL)
+    {
+        res = 0xFFFFFFFFULL;
+    }
+
+    while ((res * res) > value)
+    {
+        res--;
+    }
+
+    while ((res < 0xFFFFFFFFULL) && (((res + 1U) * (res + 1U)) <= value))
+    {
+        res++;
+    }
+
+    return (uint32_t)(res >> (shift >> 1));
+}
+
+/* Get (a * b) >> shift using a 96-bit intermediate. Result must fit in 64 bits */
+static uint64_t lDRV_Metrology_FxMulShr(uint64_t a, uint32_t b, uint32_t shift)
+{
+    uint64_t lo, hi;
+
+    lo = (a & 0xFFFFFFFFULL) * (uint64_t)b;
+    hi = (a >> 32) * (uint64_t)b;
+    hi += lo >> 32;
+    lo &= 0xFFFFFFFFULL;
+
+    if (shift >= 32U)
+    {
+        return hi >> (shift - 32U);
+    }
+
+    return (hi << (32U - shift)) | (lo >> shift);
+}
+
+/* Get sqrt(value / n / 2^q) * 2^scale, normalizing the radicand to keep precision */
+static uint64_t lDRV_Metrology_FxSqrtQ(uint64_t value, uint32_t n, uint32_t q, uint32_t *scale)
+{
+    uint32_t norm = 0U;
+
+    /* Shift left by an even amount while keeping 2 bits of headroom */
+    if (value != 0U)
+    {
+        norm = (64U - lDRV_Metrology_FxBitLength(value)) >> 1;
+        value <<= (norm << 1);
+    }
+
+    /* sqrt(value * 4^norm / n) = sqrt(value / n) * 2^norm */
+    *scale = norm + (q >> 1);
+
+    return (uint64_t)lDRV_Metrology_FxSqrt(value / n);
+}
+
+/* Get sqrt(a^2 + b^2) avoiding overflow of the 64-bit square sum */
+static uint64_t lDRV_Metrology_FxHypot(uint64_t a, uint64_t b)
+{
+    uint32_t shift = lDRV_Metrology_FxBitLength(a | b);
+
+    /* Keep both below 2^31 */
+    if (shift > 31U)
+    {
+        shift -= 31U;
+        a >>= shift;
+        b >>= shift;
+    }
+    else
+    {
+        shift = 0U;
+    }
+
+    return ((uint64_t)lDRV_Metrology_FxSqrt((a * a) + (b * b))) << shift;
+}
+
+/* Get P/Q in 0.1 W/VAr units with DRV_METROLOGY_FX_PQ_FRAC fractional bits */
+static uint64_t lDRV_Metrology_FxGetPQ(int64_t val, uint32_t k_ix, uint32_t k_vx)
+{
+    uint64_t m;
+    uint32_t n = gDrvMetObj.metRegisters->MET_STATUS.N;
+
+    if (n == 0U)
+    {
+        return 0U;
+    }
+
+    /* m = |val| / N * k_i * k_v * 10 / (2^RMS_Q * 2^(2*GAIN_VI_Q)) */
+    m = lDRV_Metrology_FxGetAbs(val) / n;
+    m = lDRV_Metrology_FxMulShr(m, k_ix, 20U);
+    m = lDRV_Metrology_FxMulShr(m, k_vx, 20U);
+    m = lDRV_Metrology_FxMulShr(m, 10U, (RMS_Q + (2U * GAIN_VI_Q)) - 40U - DRV_METROLOGY_FX_PQ_FRAC);
+
+    return m;
+}
+#endif
+
 void IPC1_InterruptHandler (void)
 {
     uint32_t status = IPC1_REGS->IPC_ISR;
@@ -172,10 +340,16 @@ void IPC1_InterruptHandler (void)
     {
         if (gDrvMetObj.metRegisters->MET_STATUS.STATUS == STATUS_STATUS_DSP_RUNNING)
         {
-            /* Update Accumulators Data */
-            (void) memcpy(&gDrvMetObj.metAccData, &gDrvMetObj.metRegisters->MET_ACCUMULATORS, sizeof(DRV_METROLOGY_REGS_ACCUMULATORS));
-            /* Update Harmonics Data */
-            (void) memcpy(&gDrvMetObj.metHarData, &gDrvMetObj.metRegisters->MET_HARMONICS, sizeof(DRV_METROLOGY_REGS_HARMONICS));
+            /* Accumulators and Harmonics Data are copied by the driver task.
+               Check if the previous integration period has not been processed yet */
+            if (gDrvMetObj.integrationCount != gDrvMetObj.processedCount)
+            {
+                gDrvMetObj.integrationStats.missedCount++;
+            }
+
+            /* Record the integration period */
+            gDrvMetObj.intervalNum = gDrvMetObj.metRegisters->MET_STATUS.INTERVAL_NUM;
+            gDrvMetObj.integrationCount++;
         }
 
         gDrvMetObj.integrationFlag = true;
@@ -238,6 +412,23 @@ static double lDRV_Metrology_GetHarmonicRMS(int32_t real, int32_t imag)
 
 static uint32_t lDRV_Metrology_GetVIRMS(uint64_t val, uint32_t k_x)
 {
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    uint64_t m;
+    uint32_t n = gDrvMetObj.metRegisters->MET_STATUS.N;
+    uint32_t scale;
+
+    if (n == 0U)
+    {
+        return 0UL;
+    }
+
+    /* m = sqrt(val / N / 2^RMS_Q) * k_x / 2^GAIN_VI_Q * 10000 */
+    m = lDRV_Metrology_FxSqrtQ(val, n, RMS_Q, &scale);
+    m = m * (uint64_t)k_x;
+    m = lDRV_Metrology_FxMulShr(m, 10000U, scale + GAIN_VI_Q);
+
+    return ((uint32_t)(m));
+#else
     double m;
 
     m = (double)val;
@@ -255,10 +446,27 @@ static uint32_t lDRV_Metrology_GetVIRMS(uint64_t val, uint32_t k_x)
     }
 
     return ((uint32_t)(m));
+#endif
 }
 
 static uint32_t lDRV_Metrology_GetInxRMS(uint64_t val)
 {
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    uint64_t m;
+    uint32_t n = gDrvMetObj.metRegisters->MET_STATUS.N;
+    uint32_t scale;
+
+    if (n == 0U)
+    {
+        return 0UL;
+    }
+
+    /* m = sqrt(val / N / 2^RMS_Inx_Q) * 10000 */
+    m = lDRV_Metrology_FxSqrtQ(val, n, RMS_Inx_Q, &scale);
+    m = lDRV_Metrology_FxMulShr(m, 10000U, scale);
+
+    return ((uint32_t)(m));
+#else
     double m;
 
     m = (double)val;
@@ -275,10 +483,14 @@ static uint32_t lDRV_Metrology_GetInxRMS(uint64_t val)
     }
 
     return ((uint32_t)(m));
+#endif
 }
 
 static uint32_t lDRV_Metrology_GetPQRMS(int64_t val, uint32_t k_ix, uint32_t k_vx)
 {
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    return (uint32_t)(lDRV_Metrology_FxGetPQ(val, k_ix, k_vx) >> DRV_METROLOGY_FX_PQ_FRAC);
+#else
     double m;
     double divisor, mult;
 
@@ -292,6 +504,7 @@ static uint32_t lDRV_Metrology_GetPQRMS(int64_t val, uint32_t k_ix, uint32_t k_v
     m = m * 10.0;
 
     return ((uint32_t)(m));
+#endif
 }
 
 static unsigned char lDRV_Metrology_CheckPQDir(int64_t val)
@@ -308,6 +521,14 @@ static unsigned char lDRV_Metrology_CheckPQDir(int64_t val)
 
 static uint32_t lDRV_Metrology_GetSRMS(int64_t pv, int64_t qv, uint32_t k_ix, uint32_t k_vx)
 {
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    uint64_t m, n;
+
+    m = lDRV_Metrology_FxGetPQ(pv, k_ix, k_vx);
+    n = lDRV_Metrology_FxGetPQ(qv, k_ix, k_vx);
+
+    return (uint32_t)(lDRV_Metrology_FxHypot(m, n) >> DRV_METROLOGY_FX_PQ_FRAC);
+#else
     double m, n;
     double divisor, mult;
 
@@ -334,13 +555,75 @@ static uint32_t lDRV_Metrology_GetSRMS(int64_t pv, int64_t qv, uint32_t k_ix, ui
     m = sqrt(m + n);
 
     return ((uint32_t)(m));
+#endif
 }
 
 static uint32_t lDRV_Metrology_GetAngleRMS(int64_t p, int64_t q)
 {
-    double m, pd, qd;
     int32_t n;
     uint32_t angle;
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    int64_t x, y, xNext, z;
+    uint64_t ax, ay;
+    uint32_t i, len;
+
+    if ((p == 0) && (q == 0))
+    {
+        return 0UL;
+    }
+
+    /* Move the vector to the right half plane: angle starts at +/-180 degrees */
+    z = 0;
+    if (p < 0)
+    {
+        z = (q < 0) ? -(int64_t)DRV_METROLOGY_FX_ANGLE_180 : (int64_t)DRV_METROLOGY_FX_ANGLE_180;
+        p = (p == INT64_MIN) ? INT64_MAX : -p;
+        q = (q == INT64_MIN) ? INT64_MAX : -q;
+    }
+
+    /* Scale to [2^59, 2^60) so CORDIC gain (1.647) can not overflow. Shift
+       the magnitudes, so that values are truncated towards zero */
+    ax = lDRV_Metrology_FxGetAbs(p);
+    ay = lDRV_Metrology_FxGetAbs(q);
+    len = lDRV_Metrology_FxBitLength(ax | ay);
+    if (len > 60U)
+    {
+        ax >>= len - 60U;
+        ay >>= len - 60U;
+    }
+    else
+    {
+        ax <<= 60U - len;
+        ay <<= 60U - len;
+    }
+
+    /* p is not negative here */
+    x = (int64_t)ax;
+    y = (q < 0) ? -(int64_t)ay : (int64_t)ay;
+
+    /* CORDIC vectoring mode: rotate until y = 0, accumulating the angle */
+    for (i = 0U; (i < DRV_METROLOGY_FX_CORDIC_ITERATIONS) && (y != 0); i++)
+    {
+        if (y > 0)
+        {
+            xNext = x + (y >> i);
+            y -= x >> i;
+            z += lDRV_Metrology_FxAtanTable[i];
+        }
+        else
+        {
+            xNext = x - (y >> i);
+            y += x >> i;
+            z -= lDRV_Metrology_FxAtanTable[i];
+        }
+
+        x = xNext;
+    }
+
+    /* Remove Q8 format (truncate towards zero as the double path does) */
+    n = (int32_t)(z / 256);
+#else
+    double m, pd, qd;
 
     pd = (double)p;
     qd = (double)q;
@@ -349,6 +632,7 @@ static uint32_t lDRV_Metrology_GetAngleRMS(int64_t p, int64_t q)
     m = m * 100000.0;
     m = m / CONST_Pi;
     n = (int32_t)m;
+#endif
 
     if (n < 0)
     {
@@ -367,6 +651,40 @@ static uint32_t lDRV_Metrology_GetAngleRMS(int64_t p, int64_t q)
 
 static uint32_t lDRV_Metrology_GetPQEnergy(DRV_METROLOGY_ENERGY_TYPE id)
 {
+#if (DRV_METROLOGY_FIXED_POINT_CALC == 1)
+    DRV_METROLOGY_REGS_CONTROL *pControl = &gDrvMetObj.metRegisters->MET_CONTROL;
+    int64_t acc[3];
+    uint64_t m, k;
+    uint32_t i;
+    uint32_t ki[3] = {pControl->K_IA, pControl->K_IB, pControl->K_IC};
+    uint32_t kv[3] = {pControl->K_VA, pControl->K_VB, pControl->K_VC};
+
+    if (id == PENERGY)
+    {
+        acc[0] = gDrvMetObj.pMetAccData->P_A;
+        acc[1] = gDrvMetObj.pMetAccData->P_B;
+        acc[2] = gDrvMetObj.pMetAccData->P_C;
+    }
+    else
+    {
+        acc[0] = gDrvMetObj.pMetAccData->Q_A;
+        acc[1] = gDrvMetObj.pMetAccData->Q_B;
+        acc[2] = gDrvMetObj.pMetAccData->Q_C;
+    }
+
+    /* k = sum(|acc| * k_i * k_v / 2^(2*GAIN_VI_Q) / 2^RMS_Q) / fs / 3600 * 10000.
+       Keep 20 fractional bits until the final division (fs * 3600 / 10000 = 1440) */
+    k = 0U;
+    for (i = 0U; i < 3U; i++)
+    {
+        m = lDRV_Metrology_FxMulShr(lDRV_Metrology_FxGetAbs(acc[i]), ki[i], 20U);
+        k += lDRV_Metrology_FxMulShr(m, kv[i], (RMS_Q + (2U * GAIN_VI_Q)) - 40U);
+    }
+
+    k = (k / 1440U) >> 20;
+
+    return ((uint32_t)(k));  /* xxxx (kWh/kVarh) */
+#else
     double m, k;
     double divisor;
     double ki, kv;
@@ -376,21 +694,21 @@ static uint32_t lDRV_Metrology_GetPQEnergy(DRV_METROLOGY_ENERGY_TYPE id)
     /* Calculated as absolute values */
     if (id == PENERGY)
     {
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.P_A);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->P_A);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IA;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VA;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
         m = m / (double)RMS_DIV_Q;      /* k =k/2^40 */
         k = m / 4000.0;                 /* k =k/fs */
 
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.P_B);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->P_B);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IB;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VB;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
         m = m / (double)RMS_DIV_Q;      /* k =k/2^40 */
         k += m / 4000.0;                 /* k =k/fs */
 
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.P_C);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->P_C);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IC;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VC;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
@@ -400,21 +718,21 @@ static uint32_t lDRV_Metrology_GetPQEnergy(DRV_METROLOGY_ENERGY_TYPE id)
     else
     {
         /* reactive energy */
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.Q_A);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->Q_A);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IA;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VA;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
         m = m / (double)RMS_DIV_Q;      /* k =k/2^40 */
         k = m / 4000.0;                 /* k =k/fs */
 
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.Q_B);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->Q_B);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IB;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VB;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
         m = m / (double)RMS_DIV_Q;      /* k =k/2^40 */
         k += m / 4000.0;                 /* k =k/fs */
 
-        m = lDRV_Metrology_GetDouble(gDrvMetObj.metAccData.Q_C);
+        m = lDRV_Metrology_GetDouble(gDrvMetObj.pMetAccData->Q_C);
         ki = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_IC;
         kv = (double)gDrvMetObj.metRegisters->MET_CONTROL.K_VC;
         m = (m * ki * kv) / divisor;    /* m =m*k_v*k_i */
@@ -426,6 +744,7 @@ static uint32_t lDRV_Metrology_GetPQEnergy(DRV_METROLOGY_ENERGY_TYPE id)
     k = k * 10000.0;        /* *10000 (kWh/kVarh) */
 
     return ((uint32_t)(k));  /* xxxx (kWh/kVarh) */
+#endif
 }
 
 static void lDRV_Metrology_IpcInitialize (void)
@@ -479,11 +798,47 @@ static uint32_t lDRV_Metrology_CorrectCalibrationAngle (uint32_t measured, doubl
     return (uint32_t)correction_angle;
 }
 
+static void lDRV_METROLOGY_UpdateSnapshot(uint32_t energy)
+{
+    DRV_METROLOGY_SNAPSHOT *snapshot;
+    uint32_t sequence;
+    uint32_t value;
+    uint8_t type;
+
+    /* Update the other snapshot. Readers copy the last complete one
+     * meanwhile. Odd count while updating */
+    sequence = gDrvMetObj.metSnapshot[(gDrvMetObj.snapshotCount >> 1) & 1U].sequence;
+    snapshot = &gDrvMetObj.metSnapshot[((gDrvMetObj.snapshotCount >> 1) + 1U) & 1U];
+    gDrvMetObj.snapshotCount++;
+    __DMB();
+
+    snapshot->sequence = sequence + 1U;
+    snapshot->energy = energy;
+    snapshot->afeEvents = gDrvMetObj.metAFEData.afeEvents;
+
+    for (type = 0U; type < (uint8_t)RMS_TYPE_NUM; type++)
+    {
+        value = DRV_METROLOGY_GetRMSValue((DRV_METROLOGY_RMS_TYPE)type);
+        if (DRV_METROLOGY_GetRMSSign((DRV_METROLOGY_RMS_TYPE)type) == RMS_SIGN_NEGATIVE)
+        {
+            snapshot->RMS[type] = -(int32_t)value;
+        }
+        else
+        {
+            snapshot->RMS[type] = (int32_t)value;
+        }
+    }
+
+    __DMB();
+    gDrvMetObj.snapshotCount++;
+}
+
 static void lDRV_METROLOGY_UpdateMeasurements(void)
 {
     uint32_t *afeRMS = NULL;
     uint32_t stateFlagReg;
     uint32_t freq;
+    uint32_t energy;
 
     /* Get State Flag Register */
     stateFlagReg = gDrvMetObj.metRegisters->MET_STATUS.STATE_FLAG;
@@ -492,52 +847,53 @@ static void lDRV_METROLOGY_UpdateMeasurements(void)
     /* Update RMS values */
     afeRMS = gDrvMetObj.metAFEData.RMS;
 
-    afeRMS[RMS_UA] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.V_A, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
-    afeRMS[RMS_UB] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.V_B, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
-    afeRMS[RMS_UC] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.V_C, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
+    afeRMS[RMS_UA] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->V_A, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
+    afeRMS[RMS_UB] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->V_B, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
+    afeRMS[RMS_UC] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->V_C, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
 
-    afeRMS[RMS_IA] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.I_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA);
-    afeRMS[RMS_IB] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.I_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB);
-    afeRMS[RMS_IC] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.I_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC);
+    afeRMS[RMS_IA] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->I_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA);
+    afeRMS[RMS_IB] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->I_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB);
+    afeRMS[RMS_IC] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->I_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC);
 
-    afeRMS[RMS_INI] = lDRV_Metrology_GetInxRMS(gDrvMetObj.metAccData.I_Ni);
-    afeRMS[RMS_INM] = lDRV_Metrology_GetVIRMS(gDrvMetObj.metAccData.I_Nm, gDrvMetObj.metRegisters->MET_CONTROL.K_IN);
-    afeRMS[RMS_INMI] = lDRV_Metrology_GetInxRMS(gDrvMetObj.metAccData.I_Nmi);
+    afeRMS[RMS_INI] = lDRV_Metrology_GetInxRMS(gDrvMetObj.pMetAccData->I_Ni);
+    afeRMS[RMS_INM] = lDRV_Metrology_GetVIRMS(gDrvMetObj.pMetAccData->I_Nm, gDrvMetObj.metRegisters->MET_CONTROL.K_IN);
+    afeRMS[RMS_INMI] = lDRV_Metrology_GetInxRMS(gDrvMetObj.pMetAccData->I_Nmi);
 
-    afeRMS[RMS_PA]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.P_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
-    gDrvMetObj.metAFEData.afeEvents.paDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.P_A);
-    afeRMS[RMS_PB]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.P_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
-    gDrvMetObj.metAFEData.afeEvents.pbDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.P_B);
-    afeRMS[RMS_PC]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.P_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
-    gDrvMetObj.metAFEData.afeEvents.pcDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.P_C);
+    afeRMS[RMS_PA]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->P_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
+    gDrvMetObj.metAFEData.afeEvents.paDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->P_A);
+    afeRMS[RMS_PB]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->P_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
+    gDrvMetObj.metAFEData.afeEvents.pbDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->P_B);
+    afeRMS[RMS_PC]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->P_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
+    gDrvMetObj.metAFEData.afeEvents.pcDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->P_C);
 
-    afeRMS[RMS_QA]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.Q_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
-    gDrvMetObj.metAFEData.afeEvents.qaDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.Q_A);
-    afeRMS[RMS_QB]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.Q_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
-    gDrvMetObj.metAFEData.afeEvents.qbDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.Q_B);
-    afeRMS[RMS_QC]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.metAccData.Q_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
-    gDrvMetObj.metAFEData.afeEvents.qcDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.Q_C);
+    afeRMS[RMS_QA]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->Q_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
+    gDrvMetObj.metAFEData.afeEvents.qaDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->Q_A);
+    afeRMS[RMS_QB]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->Q_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
+    gDrvMetObj.metAFEData.afeEvents.qbDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->Q_B);
+    afeRMS[RMS_QC]  = lDRV_Metrology_GetPQRMS(gDrvMetObj.pMetAccData->Q_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
+    gDrvMetObj.metAFEData.afeEvents.qcDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->Q_C);
 
-    afeRMS[RMS_SA]  = lDRV_Metrology_GetSRMS(gDrvMetObj.metAccData.P_A, gDrvMetObj.metAccData.Q_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
-    afeRMS[RMS_SB]  = lDRV_Metrology_GetSRMS(gDrvMetObj.metAccData.P_B, gDrvMetObj.metAccData.Q_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
-    afeRMS[RMS_SC]  = lDRV_Metrology_GetSRMS(gDrvMetObj.metAccData.P_C, gDrvMetObj.metAccData.Q_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
+    afeRMS[RMS_SA]  = lDRV_Metrology_GetSRMS(gDrvMetObj.pMetAccData->P_A, gDrvMetObj.pMetAccData->Q_A, gDrvMetObj.metRegisters->MET_CONTROL.K_IA, gDrvMetObj.metRegisters->MET_CONTROL.K_VA);
+    afeRMS[RMS_SB]  = lDRV_Metrology_GetSRMS(gDrvMetObj.pMetAccData->P_B, gDrvMetObj.pMetAccData->Q_B, gDrvMetObj.metRegisters->MET_CONTROL.K_IB, gDrvMetObj.metRegisters->MET_CONTROL.K_VB);
+    afeRMS[RMS_SC]  = lDRV_Metrology_GetSRMS(gDrvMetObj.pMetAccData->P_C, gDrvMetObj.pMetAccData->Q_C, gDrvMetObj.metRegisters->MET_CONTROL.K_IC, gDrvMetObj.metRegisters->MET_CONTROL.K_VC);
 
     afeRMS[RMS_PT]  = afeRMS[RMS_PA] + afeRMS[RMS_PB] + afeRMS[RMS_PC];
-    gDrvMetObj.metAFEData.afeEvents.ptDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.P_A + gDrvMetObj.metAccData.P_B + gDrvMetObj.metAccData.P_C);
+    gDrvMetObj.metAFEData.afeEvents.ptDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->P_A + gDrvMetObj.pMetAccData->P_B + gDrvMetObj.pMetAccData->P_C);
 
     afeRMS[RMS_QT]  = afeRMS[RMS_QA] + afeRMS[RMS_QB] + afeRMS[RMS_QC];
-    gDrvMetObj.metAFEData.afeEvents.qtDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.metAccData.Q_A + gDrvMetObj.metAccData.Q_B + gDrvMetObj.metAccData.Q_C);
+    gDrvMetObj.metAFEData.afeEvents.qtDir = lDRV_Metrology_CheckPQDir(gDrvMetObj.pMetAccData->Q_A + gDrvMetObj.pMetAccData->Q_B + gDrvMetObj.pMetAccData->Q_C);
 
     afeRMS[RMS_ST]  = afeRMS[RMS_SA] + afeRMS[RMS_SB] + afeRMS[RMS_SC];
 
     afeRMS[RMS_FREQ]  = (freq * 100U) >> FREQ_Q;
 
-    afeRMS[RMS_ANGLEA]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.metAccData.P_A, gDrvMetObj.metAccData.Q_A);
-    afeRMS[RMS_ANGLEB]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.metAccData.P_B, gDrvMetObj.metAccData.Q_B);
-    afeRMS[RMS_ANGLEC]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.metAccData.P_C, gDrvMetObj.metAccData.Q_C);
-    afeRMS[RMS_ANGLEN]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.metAccData.P_N, gDrvMetObj.metAccData.Q_N);
+    afeRMS[RMS_ANGLEA]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.pMetAccData->P_A, gDrvMetObj.pMetAccData->Q_A);
+    afeRMS[RMS_ANGLEB]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.pMetAccData->P_B, gDrvMetObj.pMetAccData->Q_B);
+    afeRMS[RMS_ANGLEC]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.pMetAccData->P_C, gDrvMetObj.pMetAccData->Q_C);
+    afeRMS[RMS_ANGLEN]  = lDRV_Metrology_GetAngleRMS(gDrvMetObj.pMetAccData->P_N, gDrvMetObj.pMetAccData->Q_N);
 
-    gDrvMetObj.metAFEData.energy += lDRV_Metrology_GetPQEnergy(PENERGY);
+    energy = lDRV_Metrology_GetPQEnergy(PENERGY);
+    gDrvMetObj.metAFEData.energy += energy;
 
     /* Update Swell/Sag events */
     gDrvMetObj.metAFEData.afeEvents.sagA = (stateFlagReg & STATUS_STATE_FLAG_SAG_DET_VA_Msk) > 0U? 1U : 0U;
@@ -547,6 +903,8 @@ static void lDRV_METROLOGY_UpdateMeasurements(void)
     gDrvMetObj.metAFEData.afeEvents.swellB = (stateFlagReg & STATUS_STATE_FLAG_SWELL_DET_VB_Msk) > 0U? 1U : 0U;
     gDrvMetObj.metAFEData.afeEvents.swellC = (stateFlagReg & STATUS_STATE_FLAG_SWELL_DET_VC_Msk) > 0U? 1U : 0U;
 
+    /* Publish all the quantities of this integration period */
+    lDRV_METROLOGY_UpdateSnapshot(energy);
 }
 
 static bool lDRV_METROLOGY_UpdateCalibrationValues(void)
@@ -555,7 +913,7 @@ static bool lDRV_METROLOGY_UpdateCalibrationValues(void)
     DRV_METROLOGY_REGS_ACCUMULATORS * pMetAccRegs;
 
     pCalibrationData = &gDrvMetObj.calibrationData;
-    pMetAccRegs = &gDrvMetObj.metAccData;
+    pMetAccRegs = gDrvMetObj.pMetAccData;
 
     if (pCalibrationData->numIntegrationPeriods != 0U)
     {
@@ -715,7 +1073,7 @@ static bool lDRV_METROLOGY_UpdateHarmonicAnalysisValues(void)
         DRV_METROLOGY_HARMONICS_RMS *pHarmonicsRsp = gDrvMetObj.harmonicAnalysisData.pHarmonicAnalysisResponse;
         int32_t harTemp[14];
 
-        (void) memcpy((void *)harTemp, (void *)&gDrvMetObj.metHarData, sizeof(harTemp));
+        (void) memcpy((void *)harTemp, (void *)gDrvMetObj.pMetHarData, sizeof(harTemp));
 
         pHarmonicsRsp->Irms_A_m = lDRV_Metrology_GetHarmonicRMS(harTemp[0], harTemp[7]);
         pHarmonicsRsp->Irms_B_m = lDRV_Metrology_GetHarmonicRMS(harTemp[2], harTemp[9]);
@@ -740,6 +1098,149 @@ static bool lDRV_METROLOGY_UpdateHarmonicAnalysisValues(void)
     }
 }
 
+static void lDRV_METROLOGY_RequestHarmonic(uint8_t harmonicNum)
+{
+    gDrvMetObj.harmonicAnalysisData.integrationPeriods = 2;
+
+    /* Set Number of Harmonic for Analysis */
+    gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 &= ~(FEATURE_CTRL1_HARMONIC_m_REQ_Msk);
+    gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 |= FEATURE_CTRL1_HARMONIC_m_REQ(harmonicNum);
+
+    /* Enable Harmonic Analysis */
+    gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 |= FEATURE_CTRL1_HARMONIC_EN_Msk;
+}
+
+static uint8_t lDRV_METROLOGY_GetNextHarmonic(uint64_t bitmap)
+{
+    uint8_t harmonicNum = 1U;
+
+    while ((bitmap & (1ULL << harmonicNum)) == 0U)
+    {
+        harmonicNum++;
+    }
+
+    return harmonicNum;
+}
+
+static double lDRV_METROLOGY_GetThd(double squareSum, double fundamental)
+{
+    if (fundamental > 0.0)
+    {
+        return (sqrt(squareSum) * 100.0) / fundamental;
+    }
+
+    return 0.0;
+}
+
+static bool lDRV_METROLOGY_UpdateHarmonicBatch(void)
+{
+    DRV_METROLOGY_HARMONIC_ANALYSIS *pHarData = &gDrvMetObj.harmonicAnalysisData;
+    DRV_METROLOGY_HARMONICS_RMS *pRms = pHarData->pHarmonicAnalysisResponse;
+    DRV_METROLOGY_HARMONICS_RMS *pSum = &pHarData->batchSquareSum;
+
+    /* Accumulate the harmonic contribution to the THD */
+    if (pHarData->harmonicNum == 1U)
+    {
+        pHarData->batchFundamental = (int8_t)pHarData->batchCount;
+    }
+    else
+    {
+        pSum->Irms_A_m += pRms->Irms_A_m * pRms->Irms_A_m;
+        pSum->Irms_B_m += pRms->Irms_B_m * pRms->Irms_B_m;
+        pSum->Irms_C_m += pRms->Irms_C_m * pRms->Irms_C_m;
+        pSum->Irms_N_m += pRms->Irms_N_m * pRms->Irms_N_m;
+        pSum->Vrms_A_m += pRms->Vrms_A_m * pRms->Vrms_A_m;
+        pSum->Vrms_B_m += pRms->Vrms_B_m * pRms->Vrms_B_m;
+        pSum->Vrms_C_m += pRms->Vrms_C_m * pRms->Vrms_C_m;
+    }
+
+    pHarData->batchCount++;
+    pHarData->batchPending &= ~(1ULL << pHarData->harmonicNum);
+
+    if (pHarData->batchPending != 0U)
+    {
+        /* Request next harmonic without client intervention */
+        pHarData->pHarmonicAnalysisResponse = &pHarData->pBatchTable[pHarData->batchCount];
+        lDRV_METROLOGY_RequestHarmonic(lDRV_METROLOGY_GetNextHarmonic(pHarData->batchPending));
+        return false;
+    }
+
+    if ((pHarData->pBatchThd != NULL) && (pHarData->batchFundamental >= 0))
+    {
+        DRV_METROLOGY_HARMONICS_RMS *pFund = &pHarData->pBatchTable[pHarData->batchFundamental];
+        DRV_METROLOGY_HARMONICS_THD *pThd = pHarData->pBatchThd;
+
+        pThd->Ithd_A = lDRV_METROLOGY_GetThd(pSum->Irms_A_m, pFund->Irms_A_m);
+        pThd->Ithd_B = lDRV_METROLOGY_GetThd(pSum->Irms_B_m, pFund->Irms_B_m);
+        pThd->Ithd_C = lDRV_METROLOGY_GetThd(pSum->Irms_C_m, pFund->Irms_C_m);
+        pThd->Ithd_N = lDRV_METROLOGY_GetThd(pSum->Irms_N_m, pFund->Irms_N_m);
+        pThd->Vthd_A = lDRV_METROLOGY_GetThd(pSum->Vrms_A_m, pFund->Vrms_A_m);
+        pThd->Vthd_B = lDRV_METROLOGY_GetThd(pSum->Vrms_B_m, pFund->Vrms_B_m);
+        pThd->Vthd_C = lDRV_METROLOGY_GetThd(pSum->Vrms_C_m, pFund->Vrms_C_m);
+    }
+
+    return true;
+}
+
+static void lDRV_METROLOGY_ResetIntegrationData(void)
+{
+    (void) memset(gDrvMetObj.metAccBuffer, 0, sizeof(gDrvMetObj.metAccBuffer));
+    (void) memset(gDrvMetObj.metHarBuffer, 0, sizeof(gDrvMetObj.metHarBuffer));
+    (void) memset((void *)&gDrvMetObj.integrationStats, 0, sizeof(DRV_METROLOGY_INTEGRATION_STATS));
+    (void) memset(gDrvMetObj.metSnapshot, 0, sizeof(gDrvMetObj.metSnapshot));
+
+    gDrvMetObj.metBufferIdx = 0U;
+    gDrvMetObj.pMetAccData = &gDrvMetObj.metAccBuffer[0];
+    gDrvMetObj.pMetHarData = &gDrvMetObj.metHarBuffer[0];
+    gDrvMetObj.integrationCount = 0U;
+    gDrvMetObj.processedCount = 0U;
+    gDrvMetObj.intervalNum = 0U;
+    gDrvMetObj.snapshotCount = 0U;
+}
+
+static bool lDRV_METROLOGY_UpdateIntegrationData(void)
+{
+    uint32_t count;
+    uint8_t attempts;
+    uint8_t idx;
+
+    /* Fill the buffer not currently exposed to the clients */
+    idx = gDrvMetObj.metBufferIdx ^ 1U;
+
+    for (attempts = 0U; attempts < DRV_METROLOGY_COPY_ATTEMPTS; attempts++)
+    {
+        count = gDrvMetObj.integrationCount;
+        if (count == gDrvMetObj.processedCount)
+        {
+            /* No new data from the metrology library */
+            return true;
+        }
+
+        /* Metrology library does not update the shared memory again until
+           the next integration period */
+        (void) memcpy(&gDrvMetObj.metAccBuffer[idx], &gDrvMetObj.metRegisters->MET_ACCUMULATORS, sizeof(DRV_METROLOGY_REGS_ACCUMULATORS));
+        (void) memcpy(&gDrvMetObj.metHarBuffer[idx], &gDrvMetObj.metRegisters->MET_HARMONICS, sizeof(DRV_METROLOGY_REGS_HARMONICS));
+
+        if ((gDrvMetObj.integrationCount == count) &&
+            (gDrvMetObj.metRegisters->MET_STATUS.INTERVAL_NUM == gDrvMetObj.intervalNum))
+        {
+            /* Publish the stable buffer */
+            gDrvMetObj.metBufferIdx = idx;
+            gDrvMetObj.pMetAccData = &gDrvMetObj.metAccBuffer[idx];
+            gDrvMetObj.pMetHarData = &gDrvMetObj.metHarBuffer[idx];
+            gDrvMetObj.processedCount = count;
+            gDrvMetObj.integrationStats.processedCount++;
+            return true;
+        }
+
+        /* The next integration period has ended during the copy: the IPC
+           interrupt counts the torn one as missed. Copy the new one */
+        gDrvMetObj.integrationStats.tornCount++;
+    }
+
+    return false;
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Driver Common Interface Implementation
@@ -795,8 +1296,7 @@ SYS_MODULE_OBJ DRV_METROLOGY_Initialize (SYS_MODULE_INIT * init, uint32_t resetC
     gDrvMetObj.inUse = true;
     gDrvMetObj.integrationCallback = NULL;
 
-    (void) memset(&gDrvMetObj.metAccData, 0, sizeof(DRV_METROLOGY_REGS_ACCUMULATORS));
-    (void) memset(&gDrvMetObj.metHarData, 0, sizeof(DRV_METROLOGY_REGS_HARMONICS));
+    lDRV_METROLOGY_ResetIntegrationData();
     (void) memset(&gDrvMetObj.calibrationData, 0, sizeof(DRV_METROLOGY_CALIBRATION));
     (void) memset(&gDrvMetObj.metAFEData, 0, sizeof(DRV_METROLOGY_AFE_DATA));
 
@@ -846,8 +1346,7 @@ SYS_MODULE_OBJ DRV_METROLOGY_Reinitialize (SYS_MODULE_INIT * init)
     /* Initialization of the interface with Metrology Lib */
     gDrvMetObj.metRegisters = (MET_REGISTERS *)metInit->regBaseAddress;
 
-    (void) memset(&gDrvMetObj.metAccData, 0, sizeof(DRV_METROLOGY_REGS_ACCUMULATORS));
-    (void) memset(&gDrvMetObj.metHarData, 0, sizeof(DRV_METROLOGY_REGS_HARMONICS));
+    lDRV_METROLOGY_ResetIntegrationData();
     (void) memset(&gDrvMetObj.calibrationData, 0, sizeof(DRV_METROLOGY_CALIBRATION));
     (void) memset(&gDrvMetObj.metAFEData, 0, sizeof(DRV_METROLOGY_AFE_DATA));
 
@@ -1006,6 +1505,19 @@ DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicAnalysisCallbackRegister (
     return DRV_METROLOGY_SUCCESS;
 }
 
+DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicBatchCallbackRegister (
+    DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback
+)
+{
+    if (callback == NULL)
+    {
+        return DRV_METROLOGY_ERROR;
+    }
+
+    gDrvMetObj.harmonicBatchCallback = callback;
+    return DRV_METROLOGY_SUCCESS;
+}
+
 void DRV_METROLOGY_Tasks(SYS_MODULE_OBJ object)
 {
     if (object == SYS_MODULE_OBJ_INVALID)
@@ -1027,6 +1539,12 @@ void DRV_METROLOGY_Tasks(SYS_MODULE_OBJ object)
     {
         gDrvMetObj.integrationFlag = false;
 
+        /* Get data of the last integration period */
+        if (lDRV_METROLOGY_UpdateIntegrationData() == false)
+        {
+            return;
+        }
+
         if (gDrvMetObj.harmonicAnalysisData.integrationPeriods > 0U)
         {
             gDrvMetObj.harmonicAnalysisData.integrationPeriods--;
@@ -1061,12 +1579,29 @@ void DRV_METROLOGY_Tasks(SYS_MODULE_OBJ object)
             {
                 if (lDRV_METROLOGY_UpdateHarmonicAnalysisValues() == true)
                 {
-                    gDrvMetObj.harmonicAnalysisData.running = false;
-
-                    /* Launch calibration callback */
-                    if (gDrvMetObj.harmonicAnalysisCallback != NULL)
+                    if (gDrvMetObj.harmonicAnalysisData.batch == true)
                     {
-                        gDrvMetObj.harmonicAnalysisCallback(gDrvMetObj.harmonicAnalysisData.harmonicNum);
+                        if (lDRV_METROLOGY_UpdateHarmonicBatch() == true)
+                        {
+                            gDrvMetObj.harmonicAnalysisData.running = false;
+                            gDrvMetObj.harmonicAnalysisData.batch = false;
+
+                            /* Launch batch harmonic analysis callback */
+                            if (gDrvMetObj.harmonicBatchCallback != NULL)
+                            {
+                                gDrvMetObj.harmonicBatchCallback(gDrvMetObj.harmonicAnalysisData.batchCount);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        gDrvMetObj.harmonicAnalysisData.running = false;
+
+                        /* Launch calibration callback */
+                        if (gDrvMetObj.harmonicAnalysisCallback != NULL)
+                        {
+                            gDrvMetObj.harmonicAnalysisCallback(gDrvMetObj.harmonicAnalysisData.harmonicNum);
+                        }
                     }
                 }
             }
@@ -1094,12 +1629,116 @@ DRV_METROLOGY_REGS_CONTROL * DRV_METROLOGY_GetControlByDefault (void)
 
 DRV_METROLOGY_REGS_ACCUMULATORS * DRV_METROLOGY_GetAccData (void)
 {
-    return &gDrvMetObj.metAccData;
+    return gDrvMetObj.pMetAccData;
 }
 
 DRV_METROLOGY_REGS_HARMONICS * DRV_METROLOGY_GetHarData (void)
 {
-    return &gDrvMetObj.metHarData;
+    return gDrvMetObj.pMetHarData;
+}
+
+void DRV_METROLOGY_GetIntegrationStats (DRV_METROLOGY_INTEGRATION_STATS * stats)
+{
+    bool intStatus;
+
+    /* Critical region to get consistent counters */
+    intStatus = SYS_INT_SourceDisable(IPC1_IRQn);
+    stats->processedCount = gDrvMetObj.integrationStats.processedCount;
+    stats->missedCount = gDrvMetObj.integrationStats.missedCount;
+    stats->tornCount = gDrvMetObj.integrationStats.tornCount;
+    SYS_INT_SourceRestore(IPC1_IRQn, intStatus);
+}
+
+bool DRV_METROLOGY_GetSnapshot (DRV_METROLOGY_SNAPSHOT * snapshot)
+{
+    uint32_t count;
+    uint32_t maxUpdates;
+    uint8_t retries;
+
+    for (retries = 0U; retries < 3U; retries++)
+    {
+        /* Last complete snapshot. If the other one is being updated, it is
+         * the one of the previous integration period */
+        count = gDrvMetObj.snapshotCount;
+        __DMB();
+        (void) memcpy(snapshot, &gDrvMetObj.metSnapshot[(count >> 1) & 1U], sizeof(DRV_METROLOGY_SNAPSHOT));
+        __DMB();
+
+        /* The copied snapshot is only overwritten after the other one has
+         * been completed: the copy is consistent unless the driver task has
+         * run meanwhile for more than one integration period */
+        maxUpdates = ((count & 1U) != 0U) ? 1U : 2U;
+        if ((gDrvMetObj.snapshotCount - count) <= maxUpdates)
+        {
+            /* There is no data until the first integration period */
+            return (snapshot->sequence != 0U);
+        }
+    }
+
+    return false;
+}
+
+void DRV_METROLOGY_StartCapture (uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source)
+{
+    DRV_METROLOGY_REGS_CONTROL * pMetControlRegs = &gDrvMetObj.metRegisters->MET_CONTROL;
+
+    /* Continuous capture: the buffer is filled in circular-buffer fashion */
+    pMetControlRegs->CAPTURE_CTRL = CAPTURE_CTRL_CAPTURE_TYPE(CAPTURE_CTRL_CAPTURE_TYPE_CONTINUOS_Val) |
+            CAPTURE_CTRL_CAPTURE_SOURCE(source) |
+            ((uint32_t)(channels & DRV_METROLOGY_CAPTURE_CH_MASK) << CAPTURE_CTRL_CH_SEL_IA_Pos) |
+            CAPTURE_CTRL_CAPTURE_EN(CAPTURE_CTRL_CAPTURE_EN_ENABLED_Val);
+}
+
+void DRV_METROLOGY_StopCapture (void)
+{
+    gDrvMetObj.metRegisters->MET_CONTROL.CAPTURE_CTRL &= ~CAPTURE_CTRL_CAPTURE_EN_Msk;
+}
+
+uint32_t DRV_METROLOGY_GetCaptureOffset (bool * wrapped)
+{
+    uint32_t status = gDrvMetObj.metRegisters->MET_STATUS.CAPTURE_STATUS;
+
+    if (wrapped != NULL)
+    {
+        *wrapped = ((status & CAPTURE_STATUS_CAPTURE_WRAP_Msk) != 0U);
+    }
+
+    return ((status & CAPTURE_STATUS_CAPTURE_OFFSET_Msk) >> CAPTURE_STATUS_CAPTURE_OFFSET_Pos);
+}
+
+uint32_t DRV_METROLOGY_GetCaptureBufferSize (void)
+{
+    return MET_CAPTURE_BUF_SIZE;
+}
+
+uint32_t DRV_METROLOGY_GetCaptureData (uint32_t offset, uint32_t * pData, uint32_t numWords)
+{
+    uint32_t firstWords;
+
+    if (numWords > MET_CAPTURE_BUF_SIZE)
+    {
+        numWords = MET_CAPTURE_BUF_SIZE;
+    }
+
+    offset %= MET_CAPTURE_BUF_SIZE;
+
+    /* Copy up to the end of the buffer, then from the beginning */
+    firstWords = MET_CAPTURE_BUF_SIZE - offset;
+    if (firstWords > numWords)
+    {
+        firstWords = numWords;
+    }
+
+    DCACHE_INVALIDATE_BY_ADDR(&sCaptureBuffer[offset], (int32_t)(firstWords * sizeof(uint32_t)));
+    (void) memcpy(pData, &sCaptureBuffer[offset], firstWords * sizeof(uint32_t));
+
+    if (numWords > firstWords)
+    {
+        DCACHE_INVALIDATE_BY_ADDR(&sCaptureBuffer[0], (int32_t)((numWords - firstWords) * sizeof(uint32_t)));
+        (void) memcpy(&pData[firstWords], &sCaptureBuffer[0], (numWords - firstWords) * sizeof(uint32_t));
+    }
+
+    return numWords;
 }
 
 DRV_METROLOGY_CALIBRATION_REFS * DRV_METROLOGY_GetCalibrationReferences (void)
@@ -1379,16 +2018,60 @@ void DRV_METROLOGY_StartHarmonicAnalysis(uint8_t harmonicNum, DRV_METROLOGY_HARM
     if (gDrvMetObj.harmonicAnalysisData.running == false)
     {
         gDrvMetObj.harmonicAnalysisData.running = true;
-        gDrvMetObj.harmonicAnalysisData.integrationPeriods = 2;
+        gDrvMetObj.harmonicAnalysisData.batch = false;
 
         /* Set Data pointer to store the Harmonic data result */
         gDrvMetObj.harmonicAnalysisData.pHarmonicAnalysisResponse = pHarmonicResponse;
 
-        /* Set Number of Harmonic for Analysis */
-        gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 &= ~(FEATURE_CTRL1_HARMONIC_m_REQ_Msk);
-        gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 |= FEATURE_CTRL1_HARMONIC_m_REQ(harmonicNum);
+        lDRV_METROLOGY_RequestHarmonic(harmonicNum);
+    }
+}
+
+DRV_METROLOGY_RESULT DRV_METROLOGY_StartHarmonicAnalysisBatch(uint64_t harmonicBitmap,
+        DRV_METROLOGY_HARMONICS_RMS *pHarmonicTable, uint8_t tableSize, DRV_METROLOGY_HARMONICS_THD *pThd)
+{
+    DRV_METROLOGY_HARMONIC_ANALYSIS *pHarData = &gDrvMetObj.harmonicAnalysisData;
+    uint64_t bitmap;
+    uint8_t numHarmonics = 0U;
 
-        /* Enable Harmonic Analysis */
-        gDrvMetObj.metRegisters->MET_CONTROL.FEATURE_CTRL1 |= FEATURE_CTRL1_HARMONIC_EN_Msk;
+    if ((pHarData->running == true) || (pHarmonicTable == NULL))
+    {
+        return DRV_METROLOGY_ERROR;
+    }
+
+    /* Only orders from 1 to DRV_METROLOGY_HARMONIC_ORDER_MAX are valid */
+    harmonicBitmap &= DRV_METROLOGY_HARMONICS_RANGE(1U, DRV_METROLOGY_HARMONIC_ORDER_MAX);
+
+    bitmap = harmonicBitmap;
+    while (bitmap != 0U)
+    {
+        bitmap &= bitmap - 1U;
+        numHarmonics++;
+    }
+
+    if ((numHarmonics == 0U) || (numHarmonics > tableSize))
+    {
+        return DRV_METROLOGY_ERROR;
     }
+
+    pHarData->running = true;
+    pHarData->batch = true;
+    pHarData->batchPending = harmonicBitmap;
+    pHarData->pBatchTable = pHarmonicTable;
+    pHarData->batchCount = 0U;
+    pHarData->pBatchThd = pThd;
+    pHarData->batchFundamental = -1;
+    (void) memset(&pHarData->batchSquareSum, 0, sizeof(DRV_METROLOGY_HARMONICS_RMS));
+
+    if (pThd != NULL)
+    {
+        (void) memset(pThd, 0, sizeof(DRV_METROLOGY_HARMONICS_THD));
+    }
+
+    /* Set Data pointer to store the first Harmonic data result */
+    pHarData->pHarmonicAnalysisResponse = pHarmonicTable;
+
+    lDRV_METROLOGY_RequestHarmonic(lDRV_METROLOGY_GetNextHarmonic(harmonicBitmap));
+
+    return DRV_METROLOGY_SUCCESS;
 }
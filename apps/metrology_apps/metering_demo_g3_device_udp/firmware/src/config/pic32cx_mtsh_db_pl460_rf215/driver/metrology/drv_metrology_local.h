@@ -103,15 +103,44 @@ typedef struct
     /* Metrology Control interface */
     MET_REGISTERS *                               metRegisters;
 
-    /* Metrology Accumulated Output Data */
-    DRV_METROLOGY_REGS_ACCUMULATORS               metAccData;
+    /* Metrology Accumulated Output Data (ping-pong buffers) */
+    DRV_METROLOGY_REGS_ACCUMULATORS               metAccBuffer[2];
 
-    /* Metrology Harmonic Analysis Output Data */
-    DRV_METROLOGY_REGS_HARMONICS                  metHarData;
+    /* Metrology Harmonic Analysis Output Data (ping-pong buffers) */
+    DRV_METROLOGY_REGS_HARMONICS                  metHarBuffer[2];
+
+    /* Index of the ping-pong buffer in use by the driver task and the clients.
+       The driver task fills the other one */
+    uint8_t                                       metBufferIdx;
+
+    /* Pointer to the last stable Accumulated Output Data */
+    DRV_METROLOGY_REGS_ACCUMULATORS *             pMetAccData;
+
+    /* Pointer to the last stable Harmonic Analysis Output Data */
+    DRV_METROLOGY_REGS_HARMONICS *                pMetHarData;
+
+    /* Number of integration periods signaled by the IPC interrupt */
+    volatile uint32_t                             integrationCount;
+
+    /* Value of integrationCount of the last processed integration period */
+    volatile uint32_t                             processedCount;
+
+    /* Interval number of the last integration period signaled by the IPC interrupt */
+    volatile uint32_t                             intervalNum;
+
+    /* Integration periods handoff statistics */
+    volatile DRV_METROLOGY_INTEGRATION_STATS      integrationStats;
 
     /* Metrology Analog Front End Data */
     DRV_METROLOGY_AFE_DATA                        metAFEData;
 
+    /* Snapshots of the quantities of the last two integration periods */
+    DRV_METROLOGY_SNAPSHOT                        metSnapshot[2];
+
+    /* Snapshot update counter. Odd while a snapshot is being updated. Bit 1
+     * is the index of the last complete snapshot */
+    volatile uint32_t                             snapshotCount;
+
     /* Metrology Calibration interface */
     DRV_METROLOGY_CALIBRATION                     calibrationData;
 
@@ -127,6 +156,9 @@ typedef struct
     /* Harmonic Analysis Callback */
     DRV_METROLOGY_HARMONICS_CALLBACK              harmonicAnalysisCallback;
 
+    /* Batch Harmonic Analysis Callback */
+    DRV_METROLOGY_HARMONICS_BATCH_CALLBACK        harmonicBatchCallback;
+
 } DRV_METROLOGY_OBJ;
 
 #ifdef __cplusplus
@@ -982,6 +982,62 @@ DRV_RF215_PIB_RESULT DRV_RF215_SetPib (
     void* value
 );
 
+// *****************************************************************************
+/* Function:
+    DRV_RF215_PIB_RESULT DRV_RF215_PhyProfileLoad (
+        DRV_HANDLE drvHandle,
+        DRV_RF215_PHY_BAND_OPM bandOpMode,
+        uint16_t channelNum
+    )
+
+  Summary:
+    Resolves the register values of a PHY configuration in advance.
+
+  Description:
+    This routine allows a client to compute and store the RF215 register
+    values for a frequency band / operating mode and channel, without changing
+    the PHY configuration in use. A later change to that configuration (by
+    RF215_PIB_PHY_BAND_OPERATING_MODE or RF215_PIB_PHY_CHANNEL_NUM) takes the
+    stored register values and only writes the registers that differ.
+
+  Precondition:
+    DRV_RF215_Open must have been called to obtain a valid opened driver handle.
+
+  Parameters:
+    drvHandle  - A valid open-instance handle, returned from the driver's open
+                 routine.
+    bandOpMode - Frequency band and operating mode (see DRV_RF215_PHY_BAND_OPM).
+    channelNum - Frequency channel number. 0 for the first valid channel.
+
+  Returns:
+    Result of loading the profile (see DRV_RF215_PIB_RESULT).
+
+  Example:
+    <code>
+    DRV_HANDLE drvRf215Handle;
+    DRV_RF215_PIB_RESULT pibResult;
+
+    pibResult = DRV_RF215_PhyProfileLoad(drvRf215Handle,
+        SUN_FSK_BAND_863_OPM1, 10);
+
+    if (pibResult == RF215_PIB_RESULT_SUCCESS)
+    {
+
+    }
+    </code>
+
+  Remarks:
+    The number of profiles per transceiver is DRV_RF215_PHY_PROFILES_NUMBER.
+    When all profiles are in use, the oldest one is replaced. If the profile
+    cache is disabled, the configuration is only validated.
+*/
+
+DRV_RF215_PIB_RESULT DRV_RF215_PhyProfileLoad (
+    DRV_HANDLE drvHandle,
+    DRV_RF215_PHY_BAND_OPM bandOpMode,
+    uint16_t channelNum
+);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
@@ -68,6 +68,28 @@ Microchip or any third party.
 /* SPI transfer pool size: Maximum number of SPI transfers that can be queued */
 #define RF215_SPI_TRANSFER_POOL_SIZE  20U
 
+/* Maximum number of unused registers that can be read in between two queued
+ * read accesses to coalesce them in the same SPI transfer. Every SPI transfer
+ * costs 2 command bytes plus DMA interrupt and restart latency (roughly the
+ * duration of 2 more bytes) */
+#define RF215_SPI_BURST_MAX_GAP       4U
+
+/* Lowest register address that can be read in between two coalesced read
+ * accesses. IRQS registers (0x0000 - 0x0003) are cleared on read */
+#define RF215_SPI_BURST_GAP_MIN_ADDR  0x0004U
+
+/* SPI transfer owner for common registers (IRQS and RF_) */
+#define RF215_SPI_TRX_COMMON          0xFFU
+
+#if (DRV_RF215_NUM_TRX == 2U)
+/* Frame buffer writes are split in up to RF215_SPI_FB_WRITE_CHUNKS_MAX SPI
+ * transfers of at least RF215_SPI_FB_WRITE_CHUNK_MIN bytes, so register
+ * accesses of the other transceiver can be inserted in between */
+#define RF215_SPI_FB_WRITE_CHUNK_MIN  64U
+#define RF215_SPI_FB_WRITE_CHUNKS_MAX 9U
+
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File Scope Data
@@ -77,7 +99,7 @@ Microchip or any third party.
 /* RF215 HAL object */
 static RF215_HAL_OBJ rf215HalObj = {0};
 
-/* SPI transfer pool */
+/* SPI transfer queue (circular buffer) */
 static RF215_SPI_TRANSFER_OBJ halSpiTransferPool[RF215_SPI_TRANSFER_POOL_SIZE] = {0};
 
 /* DMA buffers for SPI transmit and receive */
@@ -123,12 +145,108 @@ static inline void lRF215_HAL_RestoreIntSources(bool dmaIntStatus, bool timeIntS
     SYS_INT_SourceRestore(rf215HalObj.plcExtIntSource, plcExtIntStatus);
 }
 
-static void lRF215_HAL_SpiTransferStart (
+static inline void lRF215_HAL_SpiQueueClear(void)
+{
+    rf215HalObj.spiQueueHead = 0U;
+    rf215HalObj.spiQueueNum = 0U;
+    rf215HalObj.spiQueueRelease = 0U;
+    rf215HalObj.spiQueueBytes = 0U;
+}
+
+static inline uint8_t lRF215_HAL_SpiQueueIndex(uint8_t index)
+{
+    if (index >= RF215_SPI_TRANSFER_POOL_SIZE)
+    {
+        index -= RF215_SPI_TRANSFER_POOL_SIZE;
+    }
+
+    return index;
+}
+
+static inline bool lRF215_HAL_SpiHoldsExtInt(RF215_SPI_TRANSFER_MODE mode, uint16_t regAddr)
+{
+#if (DRV_RF215_NUM_TRX == 2U)
+    if ((mode == RF215_SPI_WRITE) && (regAddr >= RF215_BASE_ADDR_FRAME_BUF_BBC0))
+    {
+        /* Frame buffer writes don't keep the external interrupt disabled, so
+         * the IRQS read can be inserted ahead of them */
+        return false;
+    }
+
+#endif
+    return true;
+}
+
+static inline uint8_t lRF215_HAL_SpiTrxIndex(uint16_t regAddr)
+{
+    if (regAddr >= RF215_BASE_ADDR_FRAME_BUF_BBC0)
+    {
+        /* Frame buffer: BBC0 (0x2000 - 0x2FFF), BBC1 (0x3000 - 0x3FFF) */
+        return (uint8_t)((regAddr - RF215_BASE_ADDR_FRAME_BUF_BBC0) >> 12);
+    }
+
+    if (regAddr >= RF215_BASE_ADDR_RF09)
+    {
+        /* RF09 (0x01xx), RF24 (0x02xx), BBC0 (0x03xx), BBC1 (0x04xx) */
+        return (uint8_t)(((regAddr - RF215_BASE_ADDR_RF09) >> 8) & 1U);
+    }
+
+    return RF215_SPI_TRX_COMMON;
+}
+
+#if (DRV_RF215_NUM_TRX == 2U)
+static uint8_t lRF215_HAL_SpiQueuePosition (
     RF215_SPI_TRANSFER_MODE mode,
     uint16_t regAddr,
-    void* pData,
-    size_t size
+    bool fromTasks
 )
+{
+    RF215_SPI_TRANSFER_OBJ* burst;
+    RF215_HAL_OBJ* hObj = &rf215HalObj;
+    uint8_t trxIdx = lRF215_HAL_SpiTrxIndex(regAddr);
+    uint8_t position = hObj->spiQueueNum;
+    uint8_t pos;
+
+    if ((hObj->spiQueueNum == 0U) || (fromTasks == true) ||
+            ((mode == RF215_SPI_WRITE) && (regAddr >= RF215_BASE_ADDR_FRAME_BUF_BBC0)))
+    {
+        /* Frame buffer writes and from-tasks accesses are always added at the
+         * end */
+        return position;
+    }
+
+    /* Register accesses and frame buffer reads can be inserted ahead of the
+     * frame buffer writes of the other transceiver at the end of the queue. The first SPI transfer is
+     * in progress (or about to start from tasks) */
+    pos = halSpiTransferPool[hObj->spiQueueHead].burstNum;
+    while (pos < hObj->spiQueueNum)
+    {
+        burst = &halSpiTransferPool[lRF215_HAL_SpiQueueIndex(hObj->spiQueueHead + pos)];
+        if ((burst->mode != RF215_SPI_WRITE) ||
+                (burst->regAddr < RF215_BASE_ADDR_FRAME_BUF_BBC0) ||
+                (lRF215_HAL_SpiTrxIndex(burst->regAddr) == trxIdx))
+        {
+            /* Order of accesses of the same transceiver is kept */
+            position = hObj->spiQueueNum;
+        }
+        else if (position == hObj->spiQueueNum)
+        {
+            position = pos;
+        }
+        else
+        {
+            /* Frame buffer write after another one */
+        }
+
+        pos += burst->burstNum;
+    }
+
+    return position;
+}
+
+#endif
+
+static void lRF215_HAL_SpiTransferStart(RF215_SPI_TRANSFER_OBJ* burst)
 {
     size_t transferSize;
     uint16_t cmd;
@@ -138,17 +256,27 @@ static void lRF215_HAL_SpiTransferStart (
 
     /* Build 16 bits corresponding to COMMAND
      * COMMAND[15:14] = MODE[1:0]; COMMAND[13:0] = ADDRESS[13:0] */
-    cmd = regAddr | (uint16_t)mode;
-    transferSize = size + RF215_SPI_CMD_SIZE;
+    cmd = burst->regAddr | (uint16_t)burst->mode;
+    transferSize = burst->burstSize + RF215_SPI_CMD_SIZE;
 
     /* Write COMMAND to SPI transmit buffer (MSB first) */
     *pTxData++ = (uint8_t)(cmd >> 8);
     *pTxData++ = (uint8_t)cmd;
 
-    if (mode == RF215_SPI_WRITE)
+    if (burst->mode == RF215_SPI_WRITE)
     {
-        /* Copy data to SPI transmit buffer */
-        (void) memcpy((void*)pTxData, pData, size);
+        RF215_SPI_TRANSFER_OBJ* transfer = burst;
+        uint8_t index = (uint8_t)(burst - halSpiTransferPool);
+
+        /* Copy data of all coalesced transfers to SPI transmit buffer. Write
+         * transfers are only coalesced if addresses are consecutive */
+        for (uint8_t num = burst->burstNum; num > 0U; num--)
+        {
+            (void) memcpy((void*)&pTxData[transfer->regAddr - burst->regAddr],
+                    transfer->pData, transfer->size);
+            index = lRF215_HAL_SpiQueueIndex(index + 1U);
+            transfer = &halSpiTransferPool[index];
+        }
     }
 
     /* Disable all interrupts for a while to avoid delays between SPI transfer
@@ -161,6 +289,68 @@ static void lRF215_HAL_SpiTransferStart (
     /* Read SYS_TIME counter just after SPI transfer is launched */
     hObj->sysTimeTransfer = SYS_TIME_Counter64Get();
     SYS_INT_Restore(intStatus);
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    hObj->spiStats.bursts++;
+#endif
+}
+
+static bool lRF215_HAL_SpiTransferCoalesce (
+    RF215_SPI_TRANSFER_MODE mode,
+    uint16_t regAddr,
+    size_t size,
+    bool fromTasks
+)
+{
+    RF215_SPI_TRANSFER_OBJ* burst;
+    uint16_t burstEnd;
+    uint16_t gap;
+
+    if (rf215HalObj.spiQueueLastBurst == rf215HalObj.spiQueueHead)
+    {
+        /* Last SPI transfer already started (or about to start from tasks) */
+        return false;
+    }
+
+#if (DRV_RF215_NUM_TRX == 2U)
+    if ((mode == RF215_SPI_WRITE) && (regAddr >= RF215_BASE_ADDR_FRAME_BUF_BBC0))
+    {
+        /* Frame buffer writes are split on purpose */
+        return false;
+    }
+
+#endif
+    burst = &halSpiTransferPool[rf215HalObj.spiQueueLastBurst];
+    burstEnd = burst->regAddr + (uint16_t)burst->burstSize;
+    if ((burst->mode != mode) || (burst->fromTasks != fromTasks) || (regAddr < burstEnd))
+    {
+        return false;
+    }
+
+    /* Registers in between are only read, and only if it is worth it */
+    gap = regAddr - burstEnd;
+    if ((gap != 0U) && ((mode == RF215_SPI_WRITE) ||
+            (gap > RF215_SPI_BURST_MAX_GAP) || (burstEnd < RF215_SPI_BURST_GAP_MIN_ADDR)))
+    {
+        return false;
+    }
+
+    if ((burst->burstSize + gap + size) > DRV_RF215_MAX_PSDU_LEN)
+    {
+        /* It doesn't fit in SPI DMA buffers */
+        return false;
+    }
+
+    /* Extend last SPI transfer */
+    burst->burstSize += gap + size;
+    burst->burstNum++;
+    rf215HalObj.spiQueueBytes += gap + size;
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    rf215HalObj.spiStats.coalesced++;
+#endif
+
+    return true;
 }
 
 static void lRF215_HAL_SpiTransfer (
@@ -175,130 +365,276 @@ static void lRF215_HAL_SpiTransfer (
 {
     bool dmaIntStatus, timeIntStatus, plcExtIntStatus;
     RF215_SPI_TRANSFER_OBJ* transfer;
-    RF215_SPI_TRANSFER_OBJ* transferPoolEdge;
+    RF215_HAL_OBJ* hObj = &rf215HalObj;
+    uint8_t queuePos;
+    uint8_t index;
 
     /* Critical region to avoid conflict in SPI transfer queue */
     dmaIntStatus = lRF215_HAL_DisableIntSources(&timeIntStatus, &plcExtIntStatus);
     lRF215_HAL_ExtIntDisable();
 
-    /* Look for a free transfer object in the pool */
-    transferPoolEdge = &halSpiTransferPool[RF215_SPI_TRANSFER_POOL_SIZE];
-    for (transfer = halSpiTransferPool; transfer < transferPoolEdge; transfer++)
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    uint8_t trxIdx = lRF215_HAL_SpiTrxIndex(regAddr);
+    hObj->spiStats.accesses++;
+    if (trxIdx < DRV_RF215_NUM_TRX)
+    {
+        hObj->spiStats.trxAccesses[trxIdx]++;
+    }
+#endif
+
+    /* Check free space in the queue. Elements pending of callback (removed
+     * from the queue in the DMA handler) can't be overwritten yet */
+    if ((hObj->spiQueueNum + hObj->spiQueueRelease) < RF215_SPI_TRANSFER_POOL_SIZE)
     {
-        if (transfer->inUse == false)
+#if (DRV_RF215_NUM_TRX == 2U)
+        /* Make room in the queue if the transfer is inserted ahead of frame
+         * buffer writes of the other transceiver */
+        queuePos = lRF215_HAL_SpiQueuePosition(mode, regAddr, fromTasks);
+        for (uint8_t pos = hObj->spiQueueNum; pos > queuePos; pos--)
+        {
+            halSpiTransferPool[lRF215_HAL_SpiQueueIndex(hObj->spiQueueHead + pos)] =
+                    halSpiTransferPool[lRF215_HAL_SpiQueueIndex(hObj->spiQueueHead + pos - 1U)];
+        }
+#else
+        /* Add transfer at the end of the queue */
+        queuePos = hObj->spiQueueNum;
+#endif
+
+        index = lRF215_HAL_SpiQueueIndex(hObj->spiQueueHead + queuePos);
+        transfer = &halSpiTransferPool[index];
+        transfer->pData = pData;
+        transfer->callback = callback;
+        transfer->context = context;
+        transfer->size = size;
+        transfer->mode = mode;
+        transfer->regAddr = regAddr;
+        transfer->fromTasks = fromTasks;
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+        transfer->timeQueued = SYS_TIME_Counter64Get();
+#endif
+
+        if (queuePos < hObj->spiQueueNum)
+        {
+            /* New SPI transfer (burst) inserted. Last one moved a position */
+            transfer->burstSize = size;
+            transfer->burstNum = 1U;
+            hObj->spiQueueLastBurst = lRF215_HAL_SpiQueueIndex(hObj->spiQueueLastBurst + 1U);
+            hObj->spiQueueBytes += size + RF215_SPI_CMD_SIZE;
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+            hObj->spiStats.bypassed++;
+#endif
+        }
+        else if ((hObj->spiQueueNum == 0U) ||
+                (lRF215_HAL_SpiTransferCoalesce(mode, regAddr, size, fromTasks) == false))
+        {
+            /* New SPI transfer (burst) */
+            transfer->burstSize = size;
+            transfer->burstNum = 1U;
+            hObj->spiQueueLastBurst = index;
+            hObj->spiQueueBytes += size + RF215_SPI_CMD_SIZE;
+        }
+
+        hObj->spiQueueNum++;
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+        if (hObj->spiQueueNum > hObj->spiStats.queueNumMax)
+        {
+            hObj->spiStats.queueNumMax = hObj->spiQueueNum;
+        }
+#endif
+
+        /* External interrupt kept disabled until SPI transfer finishes */
+        if (lRF215_HAL_SpiHoldsExtInt(mode, regAddr) == false)
         {
-            /* Copy transfer parameters */
-            transfer->next = NULL;
-            transfer->pData = pData;
-            transfer->callback = callback;
-            transfer->context = context;
-            transfer->size = size;
-            transfer->mode = mode;
-            transfer->regAddr = regAddr;
-            transfer->inUse = true;
-            transfer->fromTasks = fromTasks;
-
-            if (rf215HalObj.spiQueueFirst == NULL)
+            lRF215_HAL_ExtIntEnable();
+        }
+
+        if (hObj->spiQueueNum == 1U)
+        {
+            /* This transfer is the first in the queue so it can be started */
+            if (fromTasks == false)
             {
-                /* No SPI transfers in the queue */
-                rf215HalObj.spiQueueFirst = transfer;
-                rf215HalObj.spiQueueLast = transfer;
+                lRF215_HAL_SpiTransferStart(transfer);
             }
             else
             {
-                /* Add SPI transfer to the queue */
-                rf215HalObj.spiQueueLast->next = transfer;
-                rf215HalObj.spiQueueLast = transfer;
+                hObj->spiTransferFromTasks = true;
             }
-
-            break;
         }
     }
-
-    /* External interrupt kept disabled until SPI transfer finishes */
-    if (rf215HalObj.spiQueueFirst == transfer)
+    else
     {
-        /* This transfer is the first in the queue so it can be started */
-        if (fromTasks == false)
-        {
-            lRF215_HAL_SpiTransferStart(mode, regAddr, pData, size);
-        }
-        else
-        {
-            rf215HalObj.spiTransferFromTasks = true;
-        }
+        /* Access discarded: No callback will enable external interrupt */
+        lRF215_HAL_ExtIntEnable();
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+        hObj->spiStats.dropped++;
+#endif
     }
 
     /* Leave critical region */
     lRF215_HAL_RestoreIntSources(dmaIntStatus, timeIntStatus, plcExtIntStatus);
 }
 
-static void lRF215_HAL_SpiTransferFinished(RF215_SPI_TRANSFER_OBJ* transfer)
+#if (DRV_RF215_NUM_TRX == 2U)
+static void lRF215_HAL_SpiWriteFrameBuffer(uint16_t addr, uint8_t* pData, size_t size)
 {
-    uint64_t callbackTime;
-    uintptr_t callbackContext;
-    void* callbackData;
-    RF215_SPI_TRANSFER_OBJ* next;
-    RF215_SPI_TRANSFER_CALLBACK callback;
+    bool dmaIntStatus, timeIntStatus, plcExtIntStatus;
+    RF215_HAL_OBJ* hObj = &rf215HalObj;
+    uint16_t chunkAddr = addr;
+    uint8_t* pChunk = pData;
+    size_t pending = size;
+    size_t chunkSize = DIV_CEIL(size, RF215_SPI_FB_WRITE_CHUNKS_MAX);
 
-    if (transfer->mode == RF215_SPI_READ)
+    if (chunkSize < RF215_SPI_FB_WRITE_CHUNK_MIN)
     {
-        /* Copy SPI received data to buffer from upper layer */
-        (void) memcpy(transfer->pData, (void*)&halSpiRxData[RF215_SPI_CMD_SIZE], transfer->size);
+        chunkSize = RF215_SPI_FB_WRITE_CHUNK_MIN;
     }
 
-    /* Copy needed data to local variables */
-    callback = transfer->callback;
-    callbackContext = transfer->context;
-    callbackData = transfer->pData;
-    callbackTime = rf215HalObj.sysTimeTransfer;
+    /* Critical region to queue all chunks together */
+    dmaIntStatus = lRF215_HAL_DisableIntSources(&timeIntStatus, &plcExtIntStatus);
 
-    /* The transfer object can now be freed */
-    transfer->inUse = false;
+    if ((hObj->spiQueueNum + hObj->spiQueueRelease + DIV_CEIL(size, chunkSize)) > RF215_SPI_TRANSFER_POOL_SIZE)
+    {
+        /* Not enough room in the queue: Don't split */
+        chunkSize = size;
+    }
 
-    /* Check next transfer */
-    next = transfer->next;
-    if (next != NULL)
+    while (pending > chunkSize)
     {
-        /* Move queue start to next transfer */
-        rf215HalObj.spiQueueFirst = next;
+        lRF215_HAL_SpiTransfer(RF215_SPI_WRITE, chunkAddr, pChunk, chunkSize, false, NULL, 0);
+        chunkAddr += (uint16_t)chunkSize;
+        pChunk += chunkSize;
+        pending -= chunkSize;
     }
-    else
+
+    lRF215_HAL_SpiTransfer(RF215_SPI_WRITE, chunkAddr, pChunk, pending, false, NULL, 0);
+
+    /* Leave critical region */
+    lRF215_HAL_RestoreIntSources(dmaIntStatus, timeIntStatus, plcExtIntStatus);
+}
+
+#endif
+
+static void lRF215_HAL_SpiTransferFinished(void)
+{
+    uint64_t callbackTime;
+    uint64_t burstTime;
+    uintptr_t callbackContext;
+    void* callbackData;
+    RF215_SPI_TRANSFER_OBJ* burst;
+    RF215_SPI_TRANSFER_OBJ* transfer;
+    RF215_SPI_TRANSFER_CALLBACK callback;
+    RF215_HAL_OBJ* hObj = &rf215HalObj;
+    uint8_t burstIndex = hObj->spiQueueHead;
+    bool holdsExtInt;
+    uint8_t burstNum;
+    uint16_t burstAddr;
+    uint8_t index;
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    uint64_t timeNow = SYS_TIME_Counter64Get();
+#endif
+
+    burst = &halSpiTransferPool[burstIndex];
+    burstNum = burst->burstNum;
+    burstAddr = burst->regAddr;
+    burstTime = hObj->sysTimeTransfer;
+
+    /* Copy SPI received data to buffers from upper layer */
+    index = burstIndex;
+    transfer = burst;
+    for (uint8_t num = burstNum; num > 0U; num--)
     {
-        /* No more SPI transfers in the queue */
-        rf215HalObj.spiQueueFirst = NULL;
-        rf215HalObj.spiQueueLast = NULL;
+        if (transfer->mode == RF215_SPI_READ)
+        {
+            size_t offset = RF215_SPI_CMD_SIZE + transfer->regAddr - burstAddr;
+            (void) memcpy(transfer->pData, (void*)&halSpiRxData[offset], transfer->size);
+        }
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+        uint32_t latency = (uint32_t)(timeNow - transfer->timeQueued);
+        uint8_t trxIdx = lRF215_HAL_SpiTrxIndex(transfer->regAddr);
+        hObj->spiStats.latencySum += latency;
+        if (latency > hObj->spiStats.latencyMax)
+        {
+            hObj->spiStats.latencyMax = latency;
+        }
+
+        if ((trxIdx < DRV_RF215_NUM_TRX) && (latency > hObj->spiStats.trxLatencyMax[trxIdx]))
+        {
+            hObj->spiStats.trxLatencyMax[trxIdx] = latency;
+        }
+#endif
+
+        index = lRF215_HAL_SpiQueueIndex(index + 1U);
+        transfer = &halSpiTransferPool[index];
     }
 
-    if (next != NULL)
+    /* Remove SPI transfer from the queue. Elements are released one by one
+     * after their callback, so they can't be overwritten before */
+    hObj->spiQueueBytes -= burst->burstSize + RF215_SPI_CMD_SIZE;
+    hObj->spiQueueHead = index;
+    hObj->spiQueueNum -= burstNum;
+    hObj->spiQueueRelease = burstNum;
+
+    if (hObj->spiQueueNum > 0U)
     {
         /* Start next SPI transfer */
-        if (next->fromTasks == false)
+        transfer = &halSpiTransferPool[index];
+        if (transfer->fromTasks == false)
         {
-            lRF215_HAL_SpiTransferStart(next->mode, next->regAddr, next->pData, next->size);
+            lRF215_HAL_SpiTransferStart(transfer);
         }
         else
         {
-            rf215HalObj.spiTransferFromTasks = true;
+            hObj->spiTransferFromTasks = true;
         }
     }
 
-    if (callback != NULL)
+    /* Notify upper layer via callbacks. Stop if the queue is cleared by
+     * RF215_HAL_Reset from a callback (pending transfers aborted) */
+    index = burstIndex;
+    while (hObj->spiQueueRelease > 0U)
     {
-        /* Notify upper layer via callback */
-        callback(callbackContext, callbackData, callbackTime);
-    }
+        /* Copy needed data to local variables */
+        transfer = &halSpiTransferPool[index];
+        callback = transfer->callback;
+        callbackContext = transfer->context;
+        callbackData = transfer->pData;
+        callbackTime = burstTime;
+        holdsExtInt = lRF215_HAL_SpiHoldsExtInt(transfer->mode, transfer->regAddr);
+
+        if (transfer->regAddr != burstAddr)
+        {
+            /* Coalesced transfer: Compensate SPI duration of previous bytes */
+            uint64_t offsetUSq5 = (uint64_t)(transfer->regAddr - burstAddr) * RF215_SPI_BYTE_DURATION_US_Q5;
+            callbackTime += (offsetUSq5 * SYS_TIME_FrequencyGet()) / 32000000U;
+        }
 
-    /* External interrupt can now be enabled */
-    lRF215_HAL_ExtIntEnable();
+        /* The transfer object can now be freed */
+        hObj->spiQueueRelease--;
+        index = lRF215_HAL_SpiQueueIndex(index + 1U);
+
+        if (callback != NULL)
+        {
+            callback(callbackContext, callbackData, callbackTime);
+        }
+
+        /* External interrupt disabled when the access was queued can now be
+         * enabled */
+        if (holdsExtInt == true)
+        {
+            lRF215_HAL_ExtIntEnable();
+        }
+    }
 }
 
 static void lRF215_HAL_SpiDmaHandler(uintptr_t ctxt)
 {
     bool dmaIntStatus, timeIntStatus, plcExtIntStatus;
-    RF215_SPI_TRANSFER_OBJ* transfer = rf215HalObj.spiQueueFirst;
 
-    if (transfer == NULL)
+    if (rf215HalObj.spiQueueNum == 0U)
     {
         /* Empty SPI transfer queue, probably because of RF215_HAL_Reset */
         return;
@@ -309,7 +645,7 @@ static void lRF215_HAL_SpiDmaHandler(uintptr_t ctxt)
     lRF215_HAL_ExtIntDisable();
 
     /* SPI transfer finished successfully */
-    lRF215_HAL_SpiTransferFinished(transfer);
+    lRF215_HAL_SpiTransferFinished();
 
     /* Leave critical region */
     lRF215_HAL_ExtIntEnable();
@@ -354,15 +690,13 @@ void RF215_HAL_Initialize(const DRV_RF215_INIT * const init)
     rf215HalObj.firstReset = true;
 
     /* Zero initialization */
-    rf215HalObj.spiQueueFirst = NULL;
-    rf215HalObj.spiQueueLast = NULL;
+    lRF215_HAL_SpiQueueClear();
     rf215HalObj.spiTransferFromTasks = false;
     rf215HalObj.ledRxOnCount = 0;
     rf215HalObj.ledTxOnCount = 0;
-    for (uint8_t idx = 0; idx < RF215_SPI_TRANSFER_POOL_SIZE; idx++)
-    {
-        halSpiTransferPool[idx].inUse = false;
-    }
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    (void) memset(&rf215HalObj.spiStats, 0, sizeof(RF215_HAL_SPI_STATS));
+#endif
 }
 
 void RF215_HAL_Deinitialize(void)
@@ -376,13 +710,8 @@ void RF215_HAL_Deinitialize(void)
     /* Push reset pin */
     SYS_PORT_PinClear(DRV_RF215_RESET_PIN);
 
-    /* Clear SPI transfer pool */
-    rf215HalObj.spiQueueFirst = NULL;
-    rf215HalObj.spiQueueLast = NULL;
-    for (uint8_t idx = 0; idx < RF215_SPI_TRANSFER_POOL_SIZE; idx++)
-    {
-        halSpiTransferPool[idx].inUse = false;
-    }
+    /* Clear SPI transfer queue */
+    lRF215_HAL_SpiQueueClear();
 
     /* Leave critical region. External interrupt disabled */
     lRF215_HAL_RestoreIntSources(dmaIntStatus, timeIntStatus, plcExtIntStatus);
@@ -400,7 +729,7 @@ void RF215_HAL_Reset(void)
         lRF215_HAL_ExtIntDisable();
     }
 
-    if (rf215HalObj.spiQueueFirst != NULL)
+    if (rf215HalObj.spiQueueNum != 0U)
     {
         /* Wait to SPI transfer to finish */
         while(rf215HalObj.spiPlibIsBusy() == true){}
@@ -409,15 +738,10 @@ void RF215_HAL_Reset(void)
     /* Push reset pin */
     SYS_PORT_PinClear(DRV_RF215_RESET_PIN);
 
-    /* Clear SPI transfer pool. Pending SPI transfers aborted */
-    rf215HalObj.spiQueueFirst = NULL;
-    rf215HalObj.spiQueueLast = NULL;
+    /* Clear SPI transfer queue. Pending SPI transfers aborted */
+    lRF215_HAL_SpiQueueClear();
     rf215HalObj.spiTransferFromTasks = false;
     rf215HalObj.firstReset = false;
-    for (uint8_t idx = 0; idx < RF215_SPI_TRANSFER_POOL_SIZE; idx++)
-    {
-        halSpiTransferPool[idx].inUse = false;
-    }
 
     /* Perform reset pulse delay (SYS_TIME interrupt has to be enabled) */
     SYS_INT_SourceEnable(rf215HalObj.sysTimeIntSource);
@@ -440,9 +764,7 @@ void RF215_HAL_Tasks(void)
 
     if (rf215HalObj.spiTransferFromTasks == true)
     {
-        RF215_SPI_TRANSFER_OBJ* transfer = rf215HalObj.spiQueueFirst;
-
-        if (transfer != NULL)
+        if (rf215HalObj.spiQueueNum != 0U)
         {
             bool dmaIntStatus, timeIntStatus, plcExtIntStatus;
 
@@ -450,7 +772,7 @@ void RF215_HAL_Tasks(void)
             dmaIntStatus = lRF215_HAL_DisableIntSources(&timeIntStatus, &plcExtIntStatus);
 
             /* Start SPI transfer from tasks */
-            lRF215_HAL_SpiTransferStart(transfer->mode, transfer->regAddr, transfer->pData, transfer->size);
+            lRF215_HAL_SpiTransferStart(&halSpiTransferPool[rf215HalObj.spiQueueHead]);
 
             /* Leave critical region */
             lRF215_HAL_RestoreIntSources(dmaIntStatus, timeIntStatus, plcExtIntStatus);
@@ -467,7 +789,7 @@ bool RF215_HAL_SpiLock(void)
     hObj->dmaIntStatus = lRF215_HAL_DisableIntSources(&hObj->sysTimeIntStatus, &hObj->plcExtIntStatus);
     lRF215_HAL_ExtIntDisable();
 
-    if (hObj->spiQueueFirst == NULL)
+    if (hObj->spiQueueNum == 0U)
     {
         /* SPI is free */
         return true;
@@ -539,6 +861,16 @@ void RF215_HAL_SpiWrite (
     size_t size
 )
 {
+#if (DRV_RF215_NUM_TRX == 2U)
+    if ((addr >= RF215_BASE_ADDR_FRAME_BUF_BBC0) && (size > RF215_SPI_FB_WRITE_CHUNK_MIN))
+    {
+        /* Long frame buffer write: Split it to limit delay of the other
+         * transceiver's accesses */
+        lRF215_HAL_SpiWriteFrameBuffer(addr, pData, size);
+        return;
+    }
+
+#endif
     lRF215_HAL_SpiTransfer(RF215_SPI_WRITE, addr, pData, size, false, NULL, 0);
 }
 
@@ -601,18 +933,29 @@ void RF215_HAL_SpiWriteUpdate (
 
 size_t RF215_HAL_GetSpiQueueSize(void)
 {
-    size_t queueSize = 0;
-    RF215_SPI_TRANSFER_OBJ* transfer = rf215HalObj.spiQueueFirst;
+    return rf215HalObj.spiQueueBytes;
+}
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+void RF215_HAL_GetSpiStats(RF215_HAL_SPI_STATS* stats, bool reset)
+{
+    bool dmaIntStatus, timeIntStatus, plcExtIntStatus;
 
-    while (transfer != NULL)
+    /* Critical region to get consistent statistics */
+    dmaIntStatus = lRF215_HAL_DisableIntSources(&timeIntStatus, &plcExtIntStatus);
+
+    *stats = rf215HalObj.spiStats;
+    if (reset == true)
     {
-        queueSize += transfer->size + RF215_SPI_CMD_SIZE;
-        transfer = transfer->next;
+        (void) memset(&rf215HalObj.spiStats, 0, sizeof(RF215_HAL_SPI_STATS));
     }
 
-    return queueSize;
+    /* Leave critical region */
+    lRF215_HAL_RestoreIntSources(dmaIntStatus, timeIntStatus, plcExtIntStatus);
 }
 
+#endif
+
 void RF215_HAL_LedRx(bool on)
 {
     if (on == true)
@@ -285,6 +285,109 @@ Microchip or any third party.
 #define BBC_FSKPHRRX_FEC_ON       (RF215_BBCn_FSKPHRRX_SFD_1 | \
     BBC_FSKPHRRX_COMMON)
 
+// *****************************************************************************
+/* RF215 PHY Configuration Profiles
+
+  Summary:
+    Number of PHY configuration profiles kept per transceiver.
+
+  Remarks:
+    0 disables the profile cache.
+*/
+
+#ifndef DRV_RF215_PHY_PROFILES_NUMBER
+#define DRV_RF215_PHY_PROFILES_NUMBER     0U
+#endif
+
+// *****************************************************************************
+/* RF215 RX Streaming
+
+  Summary:
+    Reception time in us covered by every chunk of PSDU read from the RX Frame
+    Buffer while the frame is being received.
+
+  Remarks:
+    The FBLI interrupt is programmed again after every chunk, so only the last
+    chunk is read after RXFE interrupt. The chunk size in bytes depends on the
+    PHY mode, with a minimum of RF215_RX_STREAM_CHUNK_MIN bytes.
+    0 disables streaming: the PSDU is read in one FBLI interrupt and at RXFE.
+*/
+
+#ifndef DRV_RF215_RX_STREAM_CHUNK_US
+#define DRV_RF215_RX_STREAM_CHUNK_US      0U
+#endif
+
+#define RF215_RX_STREAM_CHUNK_MIN         16U
+
+// *****************************************************************************
+/* RF215 TX Scheduling Queue
+
+  Summary:
+    Enables the per-transceiver queue of scheduled transmissions.
+
+  Remarks:
+    Pending transmissions are kept ordered by TX time and only the first one
+    has a SYS_TIME timer running, so several timed transmissions can be
+    requested without waiting for the previous TX confirm. A request whose
+    PPDU (plus turnaround time) overlaps with a queued transmission is rejected
+    with RF215_TX_BUSY_TX.
+    0 disables the queue: every TX buffer has its own timer.
+*/
+
+#ifndef DRV_RF215_TX_SCHEDULE_ENABLE
+#define DRV_RF215_TX_SCHEDULE_ENABLE      0U
+#endif
+
+// *****************************************************************************
+/* RF215 Channel Occupancy Cache
+
+  Summary:
+    Number of channels kept in the channel occupancy cache of each transceiver.
+
+  Remarks:
+    Every entry keeps, for one channel frequency, the last Energy Detection (ED)
+    value and its time, the busy/idle history of the last ED measurements and
+    the end time of the last received frame. It is filled by CCA, received
+    frames and the background channel scan. A transmission with ED based CCA
+    uses it as follows:
+    - If the last ED of the channel was busy less than
+      DRV_RF215_ED_CACHE_VALID_US ago, the transmission is not attempted and
+      RF215_TX_BUSY_CHN is reported (MAC backs off without occupying the TRX).
+    - If the last RF215_ED_CACHE_IDLE_HISTORY measurements were idle, the last
+      one less than DRV_RF215_ED_CACHE_VALID_US ago, and no frame has been
+      received since then, ED duration is reduced to the AGC update time.
+    When the least recently updated entry is needed for a new channel, it is
+    replaced. 0 disables the cache.
+*/
+
+#ifndef DRV_RF215_ED_CACHE_CHANNELS
+#define DRV_RF215_ED_CACHE_CHANNELS       0U
+#endif
+
+#ifndef DRV_RF215_ED_CACHE_VALID_US
+#define DRV_RF215_ED_CACHE_VALID_US       2000U
+#endif
+
+#define RF215_ED_CACHE_IDLE_HISTORY       4U
+
+// *****************************************************************************
+/* RF215 Background Channel Scan
+
+  Summary:
+    Period in us of the background ED measurements used to fill the channel
+    occupancy cache.
+
+  Remarks:
+    A single ED measurement (with the CCA ED duration) is started every period
+    if the transceiver is listening and no transmission is being prepared.
+    Reception is not affected. Only used if DRV_RF215_ED_CACHE_CHANNELS is not
+    0. 0 disables the background scan.
+*/
+
+#ifndef DRV_RF215_ED_SCAN_PERIOD_US
+#define DRV_RF215_ED_SCAN_PERIOD_US       0U
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
@@ -591,6 +694,40 @@ typedef struct
 
 } RF215_PHY_REGS_OBJ;
 
+// *****************************************************************************
+/* RF215 Driver PHY Configuration Profile Object
+
+  Summary:
+    Object used to keep the register values resolved for a PHY configuration
+    and channel.
+
+  Remarks:
+    Profiles are kept per transceiver. The number of profiles is configured
+    with DRV_RF215_PHY_PROFILES_NUMBER (0 disables the profile cache).
+*/
+
+typedef struct
+{
+    /* PHY configuration of the profile */
+    DRV_RF215_PHY_CFG_OBJ           phyConfig;
+
+    /* Register values resolved for the PHY configuration and channel */
+    RF215_PHY_REGS_OBJ              regs;
+
+    /* Channel frequency in Hz resolved by the PLL registers */
+    uint32_t                        chnFreq;
+
+    /* Turnaround time in us, as defined in 802.15.4 */
+    uint16_t                        turnaroundTimeUS;
+
+    /* Frequency channel number of the profile */
+    uint16_t                        channelNum;
+
+    /* Flag to indicate that the profile is in use */
+    bool                            inUse;
+
+} RF215_PHY_PROFILE_OBJ;
+
 // *****************************************************************************
 /* RF215 Driver PHY Statistics Object
 
@@ -628,6 +765,38 @@ typedef struct
 
 } RF215_PHY_STATISTICS_OBJ;
 
+// *****************************************************************************
+/* RF215 Driver PHY TX Scheduling Statistics
+
+  Summary:
+    Statistics of the TX scheduling queue of one transceiver.
+
+  Remarks:
+    Only available if DRV_RF215_TX_SCHEDULE_ENABLE is not 0.
+*/
+
+typedef struct
+{
+    /* Number of transmissions inserted in the queue */
+    uint32_t                        txQueued;
+
+    /* Number of requests rejected because of overlap with a queued TX */
+    uint32_t                        txConflict;
+
+    /* Number of transmissions whose timer started after preparation time */
+    uint32_t                        txLateStart;
+
+    /* Number of queued transmissions cancelled or refused by RX in progress */
+    uint32_t                        txAbortedByRx;
+
+    /* Number of queued transmissions not sent because of busy channel (CCA) */
+    uint32_t                        txCcaBusy;
+
+    /* Maximum number of transmissions in the queue */
+    uint8_t                         queueNumMax;
+
+} RF215_PHY_TX_SCHED_STATS;
+
 // *****************************************************************************
 /* RF215 Driver PHY Instance Object
 
@@ -663,6 +832,38 @@ typedef struct
     /* Pointer to TX buffer pending to be transmitted */
     DRV_RF215_TX_BUFFER_OBJ*        txBufObjPending;
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    /* TX scheduling queue statistics */
+    RF215_PHY_TX_SCHED_STATS        txSchedStats;
+
+    /* TX scheduling queue: Pending TX buffers ordered by TX time */
+    DRV_RF215_TX_BUFFER_OBJ*        txSchedQueue[DRV_RF215_TX_BUFFERS_NUMBER];
+
+    /* End of PPDU plus turnaround time of every queued TX, in SYS_TIME count */
+    uint64_t                        txSchedEnd[DRV_RF215_TX_BUFFERS_NUMBER];
+
+    /* Number of TX buffers in the TX scheduling queue */
+    uint8_t                         txSchedNum;
+
+#endif
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    /* Channel occupancy cache */
+    DRV_RF215_CHN_OCCUPANCY_OBJ     edCache[DRV_RF215_ED_CACHE_CHANNELS];
+
+#if (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    /* Background channel scan timer */
+    SYS_TIME_HANDLE                 edScanTimeHandle;
+
+    /* Background ED measurement in progress */
+    bool                            edScanInProgress;
+
+#endif
+    /* RFn_EDV value read after ED measurement */
+    uint8_t                         edCacheEDV;
+
+#endif
+
     /* Frequency band / operating mode (simplified PHY configuration) in use */
     DRV_RF215_PHY_BAND_OPM          bandOpMode;
 
@@ -681,6 +882,9 @@ typedef struct
     /* Delay between TX/EDM_SINGLE command and TX start time in us Qx.5  */
     uint32_t                        txCmdDelayUSq5;
 
+    /* ED duration in us for the CCA of the TX in progress */
+    uint16_t                        txCcaEdDurationUS;
+
     /* Turnaround time in us, as defined in 802.15.4 */
     uint16_t                        turnaroundTimeUS;
 
@@ -696,6 +900,15 @@ typedef struct
     /* Number of payload symbols of the PPDU being received */
     uint16_t                        rxPaySymbols;
 
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+    /* RX streaming chunk size in bytes for the PPDU being received */
+    uint16_t                        rxStreamChunk;
+
+    /* Maximum Frame Buffer Level to program a new FBLI interrupt */
+    uint16_t                        rxStreamLimit;
+
+#endif
+
     /* Number of payload symbols of the last transmitted PPDU */
     uint16_t                        txPaySymbols;
 
@@ -772,6 +985,14 @@ DRV_RF215_TX_RESULT RF215_PHY_TxRequest(DRV_RF215_TX_BUFFER_OBJ* txBufObj);
 
 void RF215_PHY_TxCancel(DRV_RF215_TX_BUFFER_OBJ* txBufObj);
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+void RF215_PHY_GetTxSchedStats (
+    uint8_t trxIndex,
+    RF215_PHY_TX_SCHED_STATS* stats,
+    bool reset
+);
+
+#endif
 void RF215_PHY_SetTxCfm (
     DRV_RF215_TX_BUFFER_OBJ* txBufObj,
     DRV_RF215_TX_RESULT result
@@ -789,6 +1010,12 @@ DRV_RF215_PIB_RESULT RF215_PHY_SetPib (
     void* value
 );
 
+DRV_RF215_PIB_RESULT RF215_PHY_ProfileLoad (
+    uint8_t trxIndex,
+    DRV_RF215_PHY_BAND_OPM bandOpMode,
+    uint16_t channelNum
+);
+
 void RF215_PHY_Reset(uint8_t trxIndex);
 
 void RF215_PHY_DeviceReset(void);
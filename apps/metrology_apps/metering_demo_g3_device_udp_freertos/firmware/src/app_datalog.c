@@ -95,7 +95,7 @@ uint8_t CACHE_ALIGN work[SYS_FS_FAT_MAX_SS];
 QueueHandle_t appDatalogQueueID = NULL;
 
 /* Buffer to get a string name from User IDs */
-static char *userToString[APP_DATALOG_USER_NUM] = {"metrology", "calibration", "tou", "rtc", "console", "events", "energy", "demand"};
+static char *userToString[APP_DATALOG_USER_NUM] = {"metrology", "calibration", "tou", "rtc", "console", "events", "energy", "demand", "profile"};
 
 // *****************************************************************************
 // *****************************************************************************
@@ -109,6 +109,734 @@ static char *userToString[APP_DATALOG_USER_NUM] = {"metrology", "calibration", "
 // Section: Application Local Functions
 // *****************************************************************************
 // *****************************************************************************
+
+static uint16_t _APP_DATALOG_UpdateCrc16(uint16_t crc, const uint8_t *pData, size_t length)
+{
+    uint8_t bit;
+
+    // CRC-16/CCITT, polynomial 0x1021
+    while (length--)
+    {
+        crc ^= (uint16_t)(*pData++) << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x8000)
+            {
+                crc = (crc << 1) ^ 0x1021;
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+static void _APP_DATALOG_GetIndexFileName(const char *fileName, char *indexName)
+{
+    sprintf(indexName, "%s%s", fileName, APP_DATALOG_TS_INDEX_EXTENSION);
+}
+
+static void _APP_DATALOG_InvalidateIndex(char *fileName)
+{
+    char indexName[32];
+
+    if ((fileName == NULL) || (strcmp(app_datalogData.tsIndex.fileName, fileName) == 0))
+    {
+        app_datalogData.tsIndex.valid = false;
+    }
+
+    if (fileName != NULL)
+    {
+        // Stored index does not match the file content anymore
+        _APP_DATALOG_GetIndexFileName(fileName, indexName);
+        SYS_FS_FileDirectoryRemove(indexName);
+    }
+}
+
+static void _APP_DATALOG_SaveIndex(void)
+{
+    APP_DATALOG_TS_INDEX *pIndex = &app_datalogData.tsIndex;
+    APP_DATALOG_TS_INDEX_HEADER header;
+    SYS_FS_HANDLE fileHandle;
+    char indexName[32];
+    size_t blocksSize;
+
+    if ((pIndex->valid == false) || (pIndex->savedRecords == pIndex->numRecords))
+    {
+        // Nothing new to store
+        return;
+    }
+
+    blocksSize = ((pIndex->numRecords + APP_DATALOG_TS_BLOCK_RECORDS - 1) / APP_DATALOG_TS_BLOCK_RECORDS) *
+                 sizeof(APP_DATALOG_TS_BLOCK);
+
+    memset(&header, 0, sizeof(header));
+    header.marker = APP_DATALOG_RECORD_MARKER;
+    header.recordLen = pIndex->recordLen;
+    header.numRecords = pIndex->numRecords;
+    header.crc = _APP_DATALOG_UpdateCrc16(0xFFFF, (uint8_t *)pIndex->block, blocksSize);
+
+    _APP_DATALOG_GetIndexFileName(pIndex->fileName, indexName);
+    fileHandle = SYS_FS_FileOpen(indexName, SYS_FS_FILE_OPEN_WRITE);
+    if (fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        // Index is kept in RAM only
+        return;
+    }
+
+    if ((SYS_FS_FileWrite(fileHandle, &header, sizeof(header)) == sizeof(header)) &&
+        (SYS_FS_FileWrite(fileHandle, pIndex->block, blocksSize) == blocksSize))
+    {
+        pIndex->savedRecords = pIndex->numRecords;
+    }
+
+    SYS_FS_FileClose(fileHandle);
+}
+
+static bool _APP_DATALOG_LoadIndex(uint8_t fileIndex, uint16_t recordLen)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+    APP_DATALOG_TS_INDEX *pIndex = &app_datalogData.tsIndex;
+    APP_DATALOG_TS_INDEX_HEADER header;
+    SYS_FS_HANDLE fileHandle;
+    char indexName[32];
+    size_t blocksSize = 0;
+    uint32_t numRecords;
+    int32_t fileSize;
+    bool valid = false;
+
+    pIndex->valid = false;
+
+    fileSize = SYS_FS_FileSize(pFile->fileHandle);
+    if (fileSize == -1)
+    {
+        return false;
+    }
+
+    // Records stored in the media, the last one may be incomplete
+    numRecords = (uint32_t)fileSize / (sizeof(APP_DATALOG_RECORD_HEADER) + recordLen);
+
+    _APP_DATALOG_GetIndexFileName(pFile->fileName, indexName);
+    fileHandle = SYS_FS_FileOpen(indexName, SYS_FS_FILE_OPEN_READ);
+    if (fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        // Index not stored yet
+        return false;
+    }
+
+    // Stored index can not cover records that are not in the file
+    if ((SYS_FS_FileRead(fileHandle, &header, sizeof(header)) == sizeof(header)) &&
+        (header.marker == APP_DATALOG_RECORD_MARKER) && (header.recordLen == recordLen) &&
+        (header.numRecords <= numRecords) &&
+        (header.numRecords <= (APP_DATALOG_TS_MAX_BLOCKS * APP_DATALOG_TS_BLOCK_RECORDS)))
+    {
+        blocksSize = ((header.numRecords + APP_DATALOG_TS_BLOCK_RECORDS - 1) / APP_DATALOG_TS_BLOCK_RECORDS) *
+                     sizeof(APP_DATALOG_TS_BLOCK);
+
+        if ((SYS_FS_FileRead(fileHandle, pIndex->block, blocksSize) == blocksSize) &&
+            (_APP_DATALOG_UpdateCrc16(0xFFFF, (uint8_t *)pIndex->block, blocksSize) == header.crc))
+        {
+            valid = true;
+        }
+    }
+
+    SYS_FS_FileClose(fileHandle);
+
+    if (valid == true)
+    {
+        strcpy(pIndex->fileName, pFile->fileName);
+        pIndex->recordLen = recordLen;
+        pIndex->numRecords = header.numRecords;
+        pIndex->savedRecords = header.numRecords;
+        pIndex->valid = true;
+    }
+
+    return valid;
+}
+
+static void _APP_DATALOG_AddIndexRecord(uint32_t timeStamp)
+{
+    APP_DATALOG_TS_INDEX *pIndex = &app_datalogData.tsIndex;
+    APP_DATALOG_TS_BLOCK *pBlock;
+    uint32_t blockIndex;
+
+    blockIndex = pIndex->numRecords / APP_DATALOG_TS_BLOCK_RECORDS;
+    if (blockIndex >= APP_DATALOG_TS_MAX_BLOCKS)
+    {
+        // File is too long to be indexed
+        pIndex->valid = false;
+        return;
+    }
+
+    pBlock = &pIndex->block[blockIndex];
+    if ((pIndex->numRecords % APP_DATALOG_TS_BLOCK_RECORDS) == 0)
+    {
+        // First record of the block
+        pBlock->timeMin = timeStamp;
+        pBlock->timeMax = timeStamp;
+    }
+    else if (timeStamp < pBlock->timeMin)
+    {
+        pBlock->timeMin = timeStamp;
+    }
+    else if (timeStamp > pBlock->timeMax)
+    {
+        pBlock->timeMax = timeStamp;
+    }
+
+    pIndex->numRecords++;
+}
+
+static void _APP_DATALOG_InitOpenFiles(void)
+{
+    uint8_t idx;
+
+    // Handles are not valid anymore after an unmount, so files are not closed
+    for (idx = 0; idx < APP_DATALOG_FILE_HANDLES_NUM; idx++)
+    {
+        app_datalogData.openFiles[idx].fileHandle = SYS_FS_HANDLE_INVALID;
+        app_datalogData.openFiles[idx].recordsChecked = false;
+    }
+
+    app_datalogData.accessCounter = 0;
+
+    // Time index is rebuilt on next query
+    _APP_DATALOG_InvalidateIndex(NULL);
+
+    // Cached records are lost
+    app_datalogData.cache.size = 0;
+    app_datalogData.cache.fileIndex = APP_DATALOG_FILE_HANDLES_NUM;
+}
+
+static uint8_t _APP_DATALOG_FindOpenFile(char *fileName)
+{
+    uint8_t idx;
+
+    for (idx = 0; idx < APP_DATALOG_FILE_HANDLES_NUM; idx++)
+    {
+        if ((app_datalogData.openFiles[idx].fileHandle != SYS_FS_HANDLE_INVALID) &&
+            (strcmp(app_datalogData.openFiles[idx].fileName, fileName) == 0))
+        {
+            return idx;
+        }
+    }
+
+    return APP_DATALOG_FILE_HANDLES_NUM;
+}
+
+static bool _APP_DATALOG_FlushCache(void)
+{
+    APP_DATALOG_OPEN_FILE *pFile;
+
+    if (app_datalogData.cache.size == 0)
+    {
+        return true;
+    }
+
+    pFile = &app_datalogData.openFiles[app_datalogData.cache.fileIndex];
+
+    // Write all cached records at once and commit them to the media
+    if (SYS_FS_FileSeek(pFile->fileHandle, 0, SYS_FS_SEEK_END) == -1)
+    {
+        return false;
+    }
+
+    if (SYS_FS_FileWrite(pFile->fileHandle, app_datalogData.cache.data, app_datalogData.cache.size) != app_datalogData.cache.size)
+    {
+        return false;
+    }
+
+    if (SYS_FS_FileSync(pFile->fileHandle) != SYS_FS_RES_SUCCESS)
+    {
+        return false;
+    }
+
+    app_datalogData.cache.size = 0;
+
+    return true;
+}
+
+static void _APP_DATALOG_CloseFile(uint8_t fileIndex)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+
+    if (pFile->fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return;
+    }
+
+    if (app_datalogData.cache.fileIndex == fileIndex)
+    {
+        // Cached records are discarded if they can not be written
+        if (_APP_DATALOG_FlushCache() == false)
+        {
+            _APP_DATALOG_InvalidateIndex(pFile->fileName);
+        }
+        app_datalogData.cache.size = 0;
+        app_datalogData.cache.fileIndex = APP_DATALOG_FILE_HANDLES_NUM;
+    }
+
+    SYS_FS_FileClose(pFile->fileHandle);
+    pFile->fileHandle = SYS_FS_HANDLE_INVALID;
+}
+
+static uint8_t _APP_DATALOG_OpenFile(char *fileName, bool create)
+{
+    APP_DATALOG_OPEN_FILE *pFile;
+    uint8_t idx;
+    uint8_t fileIndex;
+
+    fileIndex = _APP_DATALOG_FindOpenFile(fileName);
+
+    if (fileIndex == APP_DATALOG_FILE_HANDLES_NUM)
+    {
+        // Look for a free entry or the least recently used one
+        fileIndex = 0;
+        for (idx = 0; idx < APP_DATALOG_FILE_HANDLES_NUM; idx++)
+        {
+            if (app_datalogData.openFiles[idx].fileHandle == SYS_FS_HANDLE_INVALID)
+            {
+                fileIndex = idx;
+                break;
+            }
+
+            if ((app_datalogData.accessCounter - app_datalogData.openFiles[idx].lastAccess) >
+                (app_datalogData.accessCounter - app_datalogData.openFiles[fileIndex].lastAccess))
+            {
+                fileIndex = idx;
+            }
+        }
+
+        _APP_DATALOG_CloseFile(fileIndex);
+
+        pFile = &app_datalogData.openFiles[fileIndex];
+
+        // Open existing file without truncating it
+        pFile->fileHandle = SYS_FS_FileOpen(fileName, SYS_FS_FILE_OPEN_READ_PLUS);
+        if ((pFile->fileHandle == SYS_FS_HANDLE_INVALID) && create)
+        {
+            // File does not exist, create it
+            pFile->fileHandle = SYS_FS_FileOpen(fileName, SYS_FS_FILE_OPEN_WRITE_PLUS);
+        }
+
+        if (pFile->fileHandle == SYS_FS_HANDLE_INVALID)
+        {
+            return APP_DATALOG_FILE_HANDLES_NUM;
+        }
+
+        strcpy(pFile->fileName, fileName);
+        pFile->recordsChecked = false;
+    }
+
+    app_datalogData.openFiles[fileIndex].lastAccess = app_datalogData.accessCounter++;
+
+    return fileIndex;
+}
+
+static bool _APP_DATALOG_CheckRecords(uint8_t fileIndex, int32_t startOffset)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+    APP_DATALOG_RECORD_HEADER header;
+    int32_t fileSize;
+    int32_t offset;
+    uint16_t length;
+    uint16_t chunk;
+    uint16_t crc;
+    bool valid;
+
+    // Cache data buffer is used to read records, so it must be empty
+    if (_APP_DATALOG_FlushCache() == false)
+    {
+        return false;
+    }
+
+    fileSize = SYS_FS_FileSize(pFile->fileHandle);
+    if ((startOffset < 0) || (startOffset > fileSize))
+    {
+        startOffset = 0;
+    }
+
+    if ((fileSize == -1) || (SYS_FS_FileSeek(pFile->fileHandle, startOffset, SYS_FS_SEEK_SET) == -1))
+    {
+        return false;
+    }
+
+    // Look for the end of the last complete record. Records before the start
+    // offset are known to be complete.
+    offset = startOffset;
+    valid = true;
+    while (valid && ((fileSize - offset) >= (int32_t)sizeof(header)))
+    {
+        valid = false;
+
+        if (SYS_FS_FileRead(pFile->fileHandle, &header, sizeof(header)) != sizeof(header))
+        {
+            break;
+        }
+
+        if ((header.marker != APP_DATALOG_RECORD_MARKER) ||
+            ((fileSize - offset - (int32_t)sizeof(header)) < header.length))
+        {
+            break;
+        }
+
+        crc = 0xFFFF;
+        length = header.length;
+        while (length > 0)
+        {
+            chunk = (length > APP_DATALOG_CACHE_SIZE) ? APP_DATALOG_CACHE_SIZE : length;
+            if (SYS_FS_FileRead(pFile->fileHandle, app_datalogData.cache.data, chunk) != chunk)
+            {
+                break;
+            }
+
+            crc = _APP_DATALOG_UpdateCrc16(crc, app_datalogData.cache.data, chunk);
+            length -= chunk;
+        }
+
+        if ((length == 0) && (crc == header.crc))
+        {
+            offset += sizeof(header) + header.length;
+            valid = true;
+        }
+    }
+
+    if (offset < fileSize)
+    {
+        if (startOffset == 0)
+        {
+            _APP_DATALOG_InvalidateIndex(pFile->fileName);
+        }
+
+        // Remove the record torn by a power loss
+        if ((SYS_FS_FileSeek(pFile->fileHandle, offset, SYS_FS_SEEK_SET) == -1) ||
+            (SYS_FS_FileTruncate(pFile->fileHandle) != SYS_FS_RES_SUCCESS) ||
+            (SYS_FS_FileSync(pFile->fileHandle) != SYS_FS_RES_SUCCESS))
+        {
+            return false;
+        }
+    }
+
+    pFile->recordsChecked = true;
+
+    return true;
+}
+
+static bool _APP_DATALOG_AppendRecord(uint8_t fileIndex, uint8_t *pData, uint16_t dataLen)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+    APP_DATALOG_RECORD_HEADER header;
+    size_t recordLen = sizeof(header) + dataLen;
+
+    header.marker = APP_DATALOG_RECORD_MARKER;
+    header.length = dataLen;
+    header.crc = _APP_DATALOG_UpdateCrc16(0xFFFF, pData, dataLen);
+
+    // Records of a single file are batched in the cache
+    if ((app_datalogData.cache.fileIndex != fileIndex) ||
+        ((app_datalogData.cache.size + recordLen) > APP_DATALOG_CACHE_SIZE))
+    {
+        if (_APP_DATALOG_FlushCache() == false)
+        {
+            return false;
+        }
+    }
+
+    if (recordLen > APP_DATALOG_CACHE_SIZE)
+    {
+        // Record does not fit in the cache, write it through
+        _APP_DATALOG_InvalidateIndex(pFile->fileName);
+        if ((SYS_FS_FileSeek(pFile->fileHandle, 0, SYS_FS_SEEK_END) == -1) ||
+            (SYS_FS_FileWrite(pFile->fileHandle, &header, sizeof(header)) != sizeof(header)) ||
+            (SYS_FS_FileWrite(pFile->fileHandle, pData, dataLen) != dataLen))
+        {
+            return false;
+        }
+
+        return (SYS_FS_FileSync(pFile->fileHandle) == SYS_FS_RES_SUCCESS);
+    }
+
+    if (app_datalogData.cache.size == 0)
+    {
+        app_datalogData.cache.timeStamp = SYS_TIME_Counter64Get();
+    }
+
+    app_datalogData.cache.fileIndex = fileIndex;
+    memcpy(&app_datalogData.cache.data[app_datalogData.cache.size], &header, sizeof(header));
+    app_datalogData.cache.size += sizeof(header);
+    memcpy(&app_datalogData.cache.data[app_datalogData.cache.size], pData, dataLen);
+    app_datalogData.cache.size += dataLen;
+
+    // Keep time index up to date
+    if ((app_datalogData.tsIndex.valid == true) && (strcmp(app_datalogData.tsIndex.fileName, pFile->fileName) == 0))
+    {
+        if ((dataLen == app_datalogData.tsIndex.recordLen) && (dataLen >= sizeof(uint32_t)))
+        {
+            uint32_t timeStamp;
+
+            memcpy(&timeStamp, pData, sizeof(timeStamp));
+            _APP_DATALOG_AddIndexRecord(timeStamp);
+        }
+        else
+        {
+            app_datalogData.tsIndex.valid = false;
+        }
+    }
+
+    if (app_datalogData.cache.size >= APP_DATALOG_CACHE_FLUSH_THRESHOLD)
+    {
+        return _APP_DATALOG_FlushCache();
+    }
+
+    return true;
+}
+
+static void _APP_DATALOG_CheckCacheTimeout(void)
+{
+    uint64_t elapsedMs;
+
+    if (app_datalogData.cache.size == 0)
+    {
+        return;
+    }
+
+    // Interval in counts may not fit in 32 bits, so compare in milliseconds
+    elapsedMs = (SYS_TIME_Counter64Get() - app_datalogData.cache.timeStamp) / SYS_TIME_MSToCount(1);
+    if (elapsedMs >= APP_DATALOG_CACHE_FLUSH_INTERVAL_MS)
+    {
+        if (_APP_DATALOG_FlushCache() == false)
+        {
+            // Retry on next interval
+            app_datalogData.cache.timeStamp = SYS_TIME_Counter64Get();
+        }
+    }
+}
+
+static bool _APP_DATALOG_BuildIndex(uint8_t fileIndex, uint16_t recordLen)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+    APP_DATALOG_TS_INDEX *pIndex = &app_datalogData.tsIndex;
+    APP_DATALOG_RECORD_HEADER header;
+    uint32_t recordSize = sizeof(header) + recordLen;
+    uint32_t numRecords;
+    uint32_t idx;
+    uint32_t timeStamp;
+    int32_t fileSize;
+
+    if (recordLen < sizeof(timeStamp))
+    {
+        pIndex->valid = false;
+        return false;
+    }
+
+    // Cached records of this file must be read from the media
+    if ((app_datalogData.cache.fileIndex == fileIndex) && (_APP_DATALOG_FlushCache() == false))
+    {
+        pIndex->valid = false;
+        return false;
+    }
+
+    // Time-series files are only made of records of the same length
+    fileSize = SYS_FS_FileSize(pFile->fileHandle);
+    if ((fileSize == -1) || (((uint32_t)fileSize % recordSize) != 0))
+    {
+        pIndex->valid = false;
+        return false;
+    }
+
+    // Extend the index loaded from the media, if any
+    numRecords = (uint32_t)fileSize / recordSize;
+    if ((pIndex->valid == false) || (pIndex->recordLen != recordLen) ||
+        (strcmp(pIndex->fileName, pFile->fileName) != 0) || (pIndex->numRecords > numRecords))
+    {
+        strcpy(pIndex->fileName, pFile->fileName);
+        pIndex->recordLen = recordLen;
+        pIndex->numRecords = 0;
+        pIndex->savedRecords = 0;
+        pIndex->valid = true;
+    }
+
+    // Read the time stamp of every record not indexed yet
+    for (idx = pIndex->numRecords; (idx < numRecords) && (pIndex->valid == true); idx++)
+    {
+        if ((SYS_FS_FileSeek(pFile->fileHandle, idx * recordSize, SYS_FS_SEEK_SET) == -1) ||
+            (SYS_FS_FileRead(pFile->fileHandle, &header, sizeof(header)) != sizeof(header)) ||
+            (SYS_FS_FileRead(pFile->fileHandle, &timeStamp, sizeof(timeStamp)) != sizeof(timeStamp)) ||
+            (header.marker != APP_DATALOG_RECORD_MARKER) || (header.length != recordLen))
+        {
+            pIndex->valid = false;
+            break;
+        }
+
+        _APP_DATALOG_AddIndexRecord(timeStamp);
+    }
+
+    return pIndex->valid;
+}
+
+static bool _APP_DATALOG_ReadRange(uint8_t fileIndex, APP_DATALOG_RANGE_QUERY *pQuery)
+{
+    APP_DATALOG_OPEN_FILE *pFile = &app_datalogData.openFiles[fileIndex];
+    APP_DATALOG_TS_INDEX *pIndex = &app_datalogData.tsIndex;
+    APP_DATALOG_RECORD_HEADER header;
+    uint32_t recordSize = sizeof(header) + pQuery->recordLen;
+    uint32_t blockIndex;
+    uint32_t idx;
+    uint32_t last;
+    uint32_t timeStamp;
+    uint8_t *pRecord;
+    bool indexed;
+
+    pQuery->numRecords = 0;
+
+    indexed = ((pIndex->valid == true) && (pIndex->recordLen == pQuery->recordLen) &&
+               (strcmp(pIndex->fileName, pFile->fileName) == 0));
+
+    if (indexed == false)
+    {
+        // Start from the index stored next to the file, if any
+        (void) _APP_DATALOG_LoadIndex(fileIndex, pQuery->recordLen);
+    }
+
+    // Remove records torn by a power loss before indexing the file.
+    // Records covered by the index are complete and are not checked again.
+    if ((pFile->recordsChecked == false) &&
+        (_APP_DATALOG_CheckRecords(fileIndex, (pIndex->valid == true) ? (int32_t)(pIndex->numRecords * recordSize) : 0) == false))
+    {
+        return false;
+    }
+
+    if (indexed == false)
+    {
+        if (_APP_DATALOG_BuildIndex(fileIndex, pQuery->recordLen) == false)
+        {
+            return false;
+        }
+    }
+
+    // Cached records are already indexed but must be read from the media
+    if ((app_datalogData.cache.fileIndex == fileIndex) && (_APP_DATALOG_FlushCache() == false))
+    {
+        return false;
+    }
+
+    // Index matches the media content, store it for next queries
+    _APP_DATALOG_SaveIndex();
+
+    for (blockIndex = 0; (blockIndex * APP_DATALOG_TS_BLOCK_RECORDS) < pIndex->numRecords; blockIndex++)
+    {
+        // Skip blocks out of the requested time range
+        if ((pIndex->block[blockIndex].timeMax < pQuery->timeStart) ||
+            (pIndex->block[blockIndex].timeMin > pQuery->timeEnd))
+        {
+            continue;
+        }
+
+        idx = blockIndex * APP_DATALOG_TS_BLOCK_RECORDS;
+        last = idx + APP_DATALOG_TS_BLOCK_RECORDS;
+        if (last > pIndex->numRecords)
+        {
+            last = pIndex->numRecords;
+        }
+
+        if (SYS_FS_FileSeek(pFile->fileHandle, idx * recordSize, SYS_FS_SEEK_SET) == -1)
+        {
+            return false;
+        }
+
+        // Records of the block are read sequentially
+        for (; idx < last; idx++)
+        {
+            if (pQuery->numRecords == pQuery->maxRecords)
+            {
+                return true;
+            }
+
+            pRecord = &pQuery->pRecords[pQuery->numRecords * pQuery->recordLen];
+            if ((SYS_FS_FileRead(pFile->fileHandle, &header, sizeof(header)) != sizeof(header)) ||
+                (SYS_FS_FileRead(pFile->fileHandle, pRecord, pQuery->recordLen) != pQuery->recordLen) ||
+                (header.marker != APP_DATALOG_RECORD_MARKER) || (header.length != pQuery->recordLen))
+            {
+                _APP_DATALOG_InvalidateIndex(pFile->fileName);
+                return false;
+            }
+
+            memcpy(&timeStamp, pRecord, sizeof(timeStamp));
+            if ((timeStamp >= pQuery->timeStart) && (timeStamp <= pQuery->timeEnd))
+            {
+                pQuery->numRecords++;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void _APP_DATALOG_ClearUserData(APP_DATALOG_USER userId)
+{
+    SYS_FS_HANDLE dirHandle;
+    size_t dirLen;
+    uint8_t idx;
+    bool eod = false;
+
+    // Close user files kept open, as open files can not be removed
+    dirLen = strlen(userToString[userId]);
+    for (idx = 0; idx < APP_DATALOG_FILE_HANDLES_NUM; idx++)
+    {
+        if ((app_datalogData.openFiles[idx].fileHandle != SYS_FS_HANDLE_INVALID) &&
+            (strncmp(app_datalogData.openFiles[idx].fileName, userToString[userId], dirLen) == 0) &&
+            (app_datalogData.openFiles[idx].fileName[dirLen] == '/'))
+        {
+            if (app_datalogData.cache.fileIndex == idx)
+            {
+                // Cached records are cleared too
+                app_datalogData.cache.size = 0;
+            }
+
+            _APP_DATALOG_InvalidateIndex(app_datalogData.openFiles[idx].fileName);
+
+            _APP_DATALOG_CloseFile(idx);
+        }
+    }
+
+    // Open directory
+    dirHandle = SYS_FS_DirOpen(userToString[userId]);
+
+    // Stat struct has to be initialized to NULL before calling the API
+    memset(&app_datalogData.stat, 0, sizeof(SYS_FS_FSTAT));
+
+    if (dirHandle != SYS_FS_HANDLE_INVALID)
+    {
+        while (!eod)
+        {
+            // Directory open is successful
+            if(SYS_FS_DirRead(dirHandle, &app_datalogData.stat) == SYS_FS_RES_FAILURE)
+            {
+                // Directory read failed.
+                eod = true;
+            }
+            else
+            {
+                // Directory read succeeded.
+                if (app_datalogData.stat.fname[0] == '\0')
+                {
+                    // Reached the end of the directory.
+                    eod = true;
+                }
+                else
+                {
+                    // Remove next found file
+                    sprintf(app_datalogData.filePath, "%s/%s", userToString[userId], app_datalogData.stat.fname);
+                    SYS_FS_FileDirectoryRemove(app_datalogData.filePath);
+                }
+            }
+        }
+    }
+}
+
 #if SYS_FS_AUTOMOUNT_ENABLE
 static void APP_DATALOG_SysFSEventHandler(SYS_FS_EVENT event, void* eventData, uintptr_t context)
 {
@@ -138,6 +866,9 @@ static void APP_DATALOG_SysFSEventHandler(SYS_FS_EVENT event, void* eventData, u
                 app_datalogData.diskMounted = false;
                 app_datalogData.diskFormatRequired = false;
 
+                // Open files and cached records are lost
+                _APP_DATALOG_InitOpenFiles();
+
                 if (app_datalogData.state == APP_DATALOG_STATE_READY)
                 {
                     app_datalogData.state = APP_DATALOG_STATE_MOUNT_WAIT;
@@ -205,7 +936,8 @@ APP_DATALOG_STATES APP_DATALOG_GetStatus(void)
 
 bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date)
 {
-    SYS_FS_HANDLE fileHandle;
+    char fileName[32];
+    SYS_FS_FSTAT stat;
 
     // If Filesystem not yet ready, return false
     if (app_datalogData.state <= APP_DATALOG_STATE_CHECK_DIRECTORIES)
@@ -214,15 +946,14 @@ bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date)
     }
 
     // Get file name from parameters
-    APP_DATALOG_GetFileNameByDate(userId, date, app_datalogData.fileName);
-
-    // Check whether file exist trying to open it
-    fileHandle = SYS_FS_FileOpen(app_datalogData.fileName, (SYS_FS_FILE_OPEN_READ));
+    APP_DATALOG_GetFileNameByDate(userId, date, fileName);
 
-    if (fileHandle != SYS_FS_HANDLE_INVALID)
+    // Check whether file exists. Files kept open by the Datalog task can not be
+    // opened again, so look for the directory entry instead.
+    memset(&stat, 0, sizeof(SYS_FS_FSTAT));
+    if (SYS_FS_FileStat(fileName, &stat) == SYS_FS_RES_SUCCESS)
     {
-        // File exists, close it and return true
-        SYS_FS_FileClose(fileHandle);
+        // File exists
         return true;
     }
     else
@@ -242,42 +973,18 @@ bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date)
 
 void APP_DATALOG_ClearData(APP_DATALOG_USER userId)
 {
-    SYS_FS_HANDLE dirHandle;
-    bool eod = false;
-
-    // Open directory
-    dirHandle = SYS_FS_DirOpen(userToString[userId]);
-
-    // Stat struct has to be initialized to NULL before calling the API
-    memset(&app_datalogData.stat, 0, sizeof(SYS_FS_FSTAT));
-
-    if (dirHandle != SYS_FS_HANDLE_INVALID)
-    {
-        while (!eod)
-        {
-            // Directory open is successful
-            if(SYS_FS_DirRead(dirHandle, &app_datalogData.stat) == SYS_FS_RES_FAILURE)
-            {
-                // Directory read failed.
-                eod = true;
-            }
-            else
-            {
-                // Directory read succeeded.
-                if (app_datalogData.stat.fname[0] == '\0')
-                {
-                    // Reached the end of the directory.
-                    eod = true;
-                }
-                else
-                {
-                    // Remove next found file
-                    sprintf(app_datalogData.filePath, "%s/%s", userToString[userId], app_datalogData.stat.fname);
-                    SYS_FS_FileDirectoryRemove(app_datalogData.filePath);
-                }
-            }
-        }
-    }
+    APP_DATALOG_QUEUE_DATA datalogQueueData;
+
+    datalogQueueData.userId = userId;
+    datalogQueueData.operation = APP_DATALOG_CLEAR;
+    datalogQueueData.endCallback = NULL;
+    datalogQueueData.date.month = APP_DATALOG_INVALID_MONTH;
+    datalogQueueData.date.year = APP_DATALOG_INVALID_YEAR;
+    datalogQueueData.dataLen = 0;
+    datalogQueueData.pData = NULL;
+
+    // Files are removed by the Datalog task, which owns the open files
+    xQueueSend(appDatalogQueueID, &datalogQueueData, (TickType_t) 0);
 }
 
 /*******************************************************************************
@@ -302,6 +1009,9 @@ void APP_DATALOG_Initialize ( void )
     app_datalogData.state = APP_DATALOG_STATE_MOUNT_DISK;
 #endif
 
+    /* Init open files and write-back cache */
+    _APP_DATALOG_InitOpenFiles();
+
     // Create a queue capable of containing 10 queue data elements.
     appDatalogQueueID = xQueueCreate(10, sizeof(APP_DATALOG_QUEUE_DATA));
 
@@ -427,8 +1137,9 @@ void APP_DATALOG_Tasks(void)
 
         case APP_DATALOG_STATE_READY:
         {
-            // Wait messages in queue
-            if (xQueueReceive(appDatalogQueueID, &app_datalogData.newData.data, portMAX_DELAY))
+            // Wait messages in queue. While records are cached, wake up to flush them.
+            if (xQueueReceive(appDatalogQueueID, &app_datalogData.newData.data,
+                              (app_datalogData.cache.size > 0) ? (APP_DATALOG_CACHE_FLUSH_INTERVAL_MS / portTICK_PERIOD_MS) : portMAX_DELAY))
             {
                 // Get file name
                 if ((app_datalogData.newData.data.date.year == APP_DATALOG_INVALID_YEAR) ||
@@ -442,7 +1153,8 @@ void APP_DATALOG_Tasks(void)
                 }
 
                 // Check Read/Write operation
-                if (app_datalogData.newData.data.operation == APP_DATALOG_READ)
+                if ((app_datalogData.newData.data.operation == APP_DATALOG_READ) ||
+                    (app_datalogData.newData.data.operation == APP_DATALOG_READ_RANGE))
                 {
                     // Go to Read state
                     app_datalogData.state = APP_DATALOG_STATE_READ_FROM_FILE;
@@ -453,8 +1165,33 @@ void APP_DATALOG_Tasks(void)
                     // Go to Write state
                     app_datalogData.state = APP_DATALOG_STATE_WRITE_TO_FILE;
                 }
+                else if (app_datalogData.newData.data.operation == APP_DATALOG_FLUSH)
+                {
+                    // Write cached records to the media
+                    if (_APP_DATALOG_FlushCache())
+                    {
+                        app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
+                    }
+                    else
+                    {
+                        app_datalogData.result = APP_DATALOG_RESULT_ERROR;
+                    }
+                    // Go to report state
+                    app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
+                }
+                else if (app_datalogData.newData.data.operation == APP_DATALOG_CLEAR)
+                {
+                    // Remove all files of the user
+                    _APP_DATALOG_ClearUserData(app_datalogData.newData.data.userId);
+                    app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
+                    // Go to report state
+                    app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
+                }
             }
 
+            // Flush cached records once flush interval expires
+            _APP_DATALOG_CheckCacheTimeout();
+
             // Yield to other tasks
             vTaskDelay(DATALOG_TASK_DELAY_MS_BETWEEN_STATES / portTICK_PERIOD_MS);
 
@@ -463,98 +1200,129 @@ void APP_DATALOG_Tasks(void)
 
         case APP_DATALOG_STATE_READ_FROM_FILE:
         {
+            uint8_t fileIndex;
+
+            // Open file
+            fileIndex = _APP_DATALOG_OpenFile(app_datalogData.newData.fileName, false);
+            if (fileIndex == APP_DATALOG_FILE_HANDLES_NUM)
+            {
+                // File open failed.
+                app_datalogData.result = APP_DATALOG_RESULT_ERROR;
+                // Go to report state
+                app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
+
+                // Yield to other tasks
+                vTaskDelay(DATALOG_TASK_DELAY_MS_BETWEEN_STATES / portTICK_PERIOD_MS);
+                break;
+            }
+
+            app_datalogData.newData.fileHandle = app_datalogData.openFiles[fileIndex].fileHandle;
+
             if (app_datalogData.newData.data.operation == APP_DATALOG_READ)
             {
-                // Read operation
-                app_datalogData.newData.fileHandle = SYS_FS_FileOpen(app_datalogData.newData.fileName, (SYS_FS_FILE_OPEN_READ));
-                if(app_datalogData.newData.fileHandle != SYS_FS_HANDLE_INVALID)
+                // Read operation. Cached records of this file must be read from the media.
+                if ((app_datalogData.cache.fileIndex == fileIndex) &&
+                    (_APP_DATALOG_FlushCache() == false))
                 {
-                    // File open succeeded. Read Data.
-                    if (SYS_FS_FileRead(app_datalogData.newData.fileHandle, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) != -1)
-                    {
-                        // Read success
-                        app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
-                    }
-                    else
-                    {
-                        // Read error
-                        app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    }
-                    // Go to Close state
-                    app_datalogData.state = APP_DATALOG_STATE_CLOSE_FILE;
+                    // Records not written yet, file data is not up to date
+                    app_datalogData.result = APP_DATALOG_RESULT_ERROR;
+                }
+                // Read Data from the beginning
+                else if ((SYS_FS_FileSeek(app_datalogData.newData.fileHandle, 0, SYS_FS_SEEK_SET) != -1) &&
+                    (SYS_FS_FileRead(app_datalogData.newData.fileHandle, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) != -1))
+                {
+                    // Read success
+                    app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
                 }
                 else
                 {
-                    // File open failed.
+                    // Read error
+                    app_datalogData.result = APP_DATALOG_RESULT_ERROR;
+                }
+            }
+            else if (app_datalogData.newData.data.operation == APP_DATALOG_READ_RANGE)
+            {
+                // Read range operation
+                if (_APP_DATALOG_ReadRange(fileIndex, (APP_DATALOG_RANGE_QUERY *)app_datalogData.newData.data.pData))
+                {
+                    // Read success
+                    app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
+                }
+                else
+                {
+                    // Read error
                     app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    // Go to report state
-                    app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
                 }
             }
 
+            // File is kept open, go to report state
+            app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
+
             // Yield to other tasks
             vTaskDelay(DATALOG_TASK_DELAY_MS_BETWEEN_STATES / portTICK_PERIOD_MS);
-
             break;
         }
 
         case APP_DATALOG_STATE_WRITE_TO_FILE:
         {
+            uint8_t fileIndex;
+
+            // Open file, creating it if it does not exist
+            fileIndex = _APP_DATALOG_OpenFile(app_datalogData.newData.fileName, true);
+            if (fileIndex == APP_DATALOG_FILE_HANDLES_NUM)
+            {
+                // File open failed.
+                app_datalogData.result = APP_DATALOG_RESULT_ERROR;
+                // Go to report state
+                app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
+                break;
+            }
+
+            app_datalogData.newData.fileHandle = app_datalogData.openFiles[fileIndex].fileHandle;
+
             if (app_datalogData.newData.data.operation == APP_DATALOG_APPEND)
             {
-                // Append operation
-                app_datalogData.newData.fileHandle = SYS_FS_FileOpen(app_datalogData.newData.fileName, (SYS_FS_FILE_OPEN_APPEND));
-                if(app_datalogData.newData.fileHandle != SYS_FS_HANDLE_INVALID)
+                // Append operation. Remove records torn by a power loss on first access.
+                if (((app_datalogData.openFiles[fileIndex].recordsChecked == true) ||
+                     (_APP_DATALOG_CheckRecords(fileIndex, 0) == true)) &&
+                    (_APP_DATALOG_AppendRecord(fileIndex, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) == true))
                 {
-                    // File open succeeded. Append Data.
-                    if (SYS_FS_FileWrite(app_datalogData.newData.fileHandle, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) != -1)
-                    {
-                        // Write success
-                        app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
-                    }
-                    else
-                    {
-                        // Write error
-                        app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    }
-                    // Go to Close state
-                    app_datalogData.state = APP_DATALOG_STATE_CLOSE_FILE;
+                    // Record cached or written
+                    app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
                 }
                 else
                 {
-                    // File open failed.
+                    // Write error
                     app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    // Go to report state
-                    app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
                 }
+                // Go to report state
+                app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
             }
             else if (app_datalogData.newData.data.operation == APP_DATALOG_WRITE)
             {
-                // Write operation
-                app_datalogData.newData.fileHandle = SYS_FS_FileOpen(app_datalogData.newData.fileName, (SYS_FS_FILE_OPEN_WRITE));
-                if(app_datalogData.newData.fileHandle != SYS_FS_HANDLE_INVALID)
+                // Write operation. Cached records of this file are overwritten.
+                if (app_datalogData.cache.fileIndex == fileIndex)
                 {
-                    // File open succeeded. Write Data.
-                    if (SYS_FS_FileWrite(app_datalogData.newData.fileHandle, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) != -1)
-                    {
-                        // Write success
-                        app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
-                    }
-                    else
-                    {
-                        // Write error
-                        app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    }
-                    // Go to Close state
-                    app_datalogData.state = APP_DATALOG_STATE_CLOSE_FILE;
+                    app_datalogData.cache.size = 0;
+                }
+
+                _APP_DATALOG_InvalidateIndex(app_datalogData.newData.fileName);
+
+                // Write Data from the beginning and discard previous content
+                if ((SYS_FS_FileSeek(app_datalogData.newData.fileHandle, 0, SYS_FS_SEEK_SET) != -1) &&
+                    (SYS_FS_FileWrite(app_datalogData.newData.fileHandle, app_datalogData.newData.data.pData, app_datalogData.newData.data.dataLen) != -1) &&
+                    (SYS_FS_FileTruncate(app_datalogData.newData.fileHandle) == SYS_FS_RES_SUCCESS))
+                {
+                    // Write success
+                    app_datalogData.result = APP_DATALOG_RESULT_SUCCESS;
                 }
                 else
                 {
-                    // File open failed.
+                    // Write error
                     app_datalogData.result = APP_DATALOG_RESULT_ERROR;
-                    // Go to report state
-                    app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
                 }
+                // Go to Sync state
+                app_datalogData.state = APP_DATALOG_STATE_SYNC_FILE;
             }
 
             // Yield to other tasks
@@ -563,10 +1331,10 @@ void APP_DATALOG_Tasks(void)
             break;
         }
 
-        case APP_DATALOG_STATE_CLOSE_FILE:
+        case APP_DATALOG_STATE_SYNC_FILE:
         {
-            // Close current file
-            if (SYS_FS_FileClose(app_datalogData.newData.fileHandle) == SYS_FS_RES_SUCCESS)
+            // Commit file data, file is kept open for next requests
+            if (SYS_FS_FileSync(app_datalogData.newData.fileHandle) == SYS_FS_RES_SUCCESS)
             {
                 // Go to report state
                 app_datalogData.state = APP_DATALOG_STATE_REPORT_RESULT;
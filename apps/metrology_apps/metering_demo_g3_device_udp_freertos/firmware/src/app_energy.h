@@ -91,12 +91,85 @@ typedef struct {
 } APP_ENERGY_TOU_TIME_ZONE;
 
 #define APP_ENERGY_TOU_MAX_ZONES             8
+#define APP_ENERGY_TOU_MAX_DAY_PROFILES      4
+#define APP_ENERGY_TOU_MAX_SEASONS           4
+#define APP_ENERGY_TOU_MAX_HOLIDAYS          16
+#define APP_ENERGY_TOU_CALENDAR_MARKER       0x43554F54UL
 
+/* Day types used to select the day profile inside a season */
+typedef enum {
+  APP_ENERGY_DAY_TYPE_WORKDAY = 0,
+  APP_ENERGY_DAY_TYPE_SATURDAY,
+  APP_ENERGY_DAY_TYPE_SUNDAY,
+  APP_ENERGY_DAY_TYPE_NUM
+} APP_ENERGY_DAY_TYPE;
+
+/* Season: applies from its start date until the start date of the next season.
+   month = 0 means that the season is not used */
+typedef struct {
+  uint8_t month;
+  uint8_t day;
+  uint8_t dayProfile[APP_ENERGY_DAY_TYPE_NUM];
+} APP_ENERGY_TOU_SEASON;
+
+/* Holiday: recurring every year, overrides the season day profile.
+   month = 0 means that the holiday is not used */
+typedef struct {
+  uint8_t month;
+  uint8_t day;
+  uint8_t dayProfile;
+} APP_ENERGY_TOU_HOLIDAY;
+
+/* TOU calendar. Day profile 0 is APP_ENERGY_TOU.timeZone, so profiles 1 to
+   APP_ENERGY_TOU_MAX_DAY_PROFILES - 1 are stored here */
+typedef struct {
+  uint32_t marker;
+  APP_ENERGY_TOU_TIME_ZONE dayProfile[APP_ENERGY_TOU_MAX_DAY_PROFILES - 1][APP_ENERGY_TOU_MAX_ZONES];
+  APP_ENERGY_TOU_SEASON season[APP_ENERGY_TOU_MAX_SEASONS];
+  APP_ENERGY_TOU_HOLIDAY holiday[APP_ENERGY_TOU_MAX_HOLIDAYS];
+} APP_ENERGY_TOU_CALENDAR;
+
+#define APP_ENERGY_DEMAND_MAX_SUBINTERVALS   15
+
+/* Demand window: numSubintervals subintervals of subintervalMin minutes.
+   Block windows are aligned to the hour and evaluated once per window. Sliding
+   windows are evaluated at the end of every subinterval */
+typedef struct {
+  uint8_t subintervalMin;
+  uint8_t numSubintervals;
+  bool sliding;
+} APP_ENERGY_DEMAND_CONFIG;
+
+/* TOU data stored in memory. The demand window is stored along with the
+   tariffs, as both define how max demand is recorded */
 typedef struct {
   APP_ENERGY_TOU_TIME_ZONE timeZone[APP_ENERGY_TOU_MAX_ZONES];
     uint32_t usedZones;
+  APP_ENERGY_TOU_CALENDAR calendar;
+  APP_ENERGY_DEMAND_CONFIG demandConfig;
 } APP_ENERGY_TOU;
 
+/* Tariff transition of a compiled day profile */
+typedef struct {
+  uint16_t minute;
+  uint8_t tariffIndex;
+} APP_ENERGY_TOU_TRANSITION;
+
+#define APP_ENERGY_TOU_MINUTES_DAY           1440
+
+/* TOU schedule compiled from the TOU calendar. Transitions of every day
+   profile are sorted by minute of the day, so the current tariff only has to
+   be looked up again when the cached next transition is reached */
+typedef struct {
+  APP_ENERGY_TOU_TRANSITION transition[APP_ENERGY_TOU_MAX_DAY_PROFILES][APP_ENERGY_TOU_MAX_ZONES];
+  uint8_t numTransitions[APP_ENERGY_TOU_MAX_DAY_PROFILES];
+  uint32_t dayKey;
+  uint8_t dayProfile;
+  uint8_t tariffIndex;
+  uint16_t currentMinute;
+  uint16_t nextMinute;
+} APP_ENERGY_TOU_SCHEDULE;
+
 typedef struct {
     uint32_t value;
     uint8_t month;
@@ -113,14 +186,32 @@ typedef struct {
 typedef struct {
     APP_ENERGY_MAX_DEMAND maxDemand;
     uint32_t window[60];
+    uint32_t subinterval[APP_ENERGY_DEMAND_MAX_SUBINTERVALS];
+    uint64_t windowSum;
+    uint32_t subintervalSum;
+    uint8_t subintervalIndex;
 } APP_ENERGY_DEMAND;
 
 typedef struct {
     uint64_t tariff[TARIFF_NUM_TYPE];
 } APP_ENERGY_ACCUMULATORS;
 
+/* Load profile record, stored every 15 minutes */
+typedef struct {
+    /* Seconds since 01/01/2000 00:00:00 at the end of the period */
+    uint32_t timeStamp;
+    /* Average demand in the period */
+    uint32_t demand;
+    /* Energy accumulators at the end of the period */
+    APP_ENERGY_ACCUMULATORS energy;
+} APP_ENERGY_PROFILE_RECORD;
+
+#define APP_ENERGY_PROFILE_PERIOD_MIN     15
+
 typedef void (* APP_ENERGY_MAXDEMAND_CALLBACK) (struct tm * time, bool dataValid);
 typedef void (* APP_ENERGY_MONTH_CALLBACK) (struct tm * time, bool dataValid);
+
+typedef void (* APP_ENERGY_PROFILE_CALLBACK) (uint16_t numRecords, bool dataValid);
 // *****************************************************************************
 /* Application states
 
@@ -144,6 +235,7 @@ typedef enum
     APP_ENERGY_STATE_RUNNING,
     APP_ENERGY_STATE_GET_MAX_DEMAND,
     APP_ENERGY_STATE_GET_MONTH_ENERGY,
+    APP_ENERGY_STATE_GET_PROFILE,
     APP_ENERGY_STATE_ERROR
 
 } APP_ENERGY_STATES;
@@ -175,6 +267,8 @@ typedef struct
 
     APP_ENERGY_TOU tou;
 
+    APP_ENERGY_TOU_SCHEDULE touSchedule;
+
     APP_ENERGY_DEMAND demand;
 
     APP_ENERGY_ACCUMULATORS energyAccumulator;
@@ -196,6 +290,13 @@ typedef struct
     APP_ENERGY_MONTH_CALLBACK monthEnergyCallback;
 
     APP_ENERGY_ACCUMULATORS * pMonthEnergyResponse;
+    APP_ENERGY_PROFILE_CALLBACK profileCallback;
+    APP_ENERGY_PROFILE_RECORD * pProfileResponse;
+    uint16_t profileMaxRecords;
+    uint16_t profileNumRecords;
+    uint32_t profileTimeStart;
+    uint32_t profileTimeEnd;
+    uint32_t profileDemand;
 
     struct tm timeResponse;
 
@@ -288,6 +389,10 @@ void APP_ENERGY_Tasks(void);
 
 APP_ENERGY_TOU_TIME_ZONE * APP_ENERGY_GetTOUTimeZone(void);
 void APP_ENERGY_SetTOUTimeZone(APP_ENERGY_TOU_TIME_ZONE *timeZone);
+APP_ENERGY_TOU_CALENDAR * APP_ENERGY_GetTOUCalendar(void);
+bool APP_ENERGY_SetTOUCalendar(APP_ENERGY_TOU_CALENDAR *calendar);
+void APP_ENERGY_GetDemandConfig(APP_ENERGY_DEMAND_CONFIG *config);
+bool APP_ENERGY_SetDemandConfig(APP_ENERGY_DEMAND_CONFIG *config);
 void APP_ENERGY_SetMonthEnergyCallback(APP_ENERGY_MONTH_CALLBACK callback,
         APP_ENERGY_ACCUMULATORS * pMonthEnergyResponse);
 bool APP_ENERGY_GetMonthEnergy(struct tm * time);
@@ -298,6 +403,10 @@ void APP_ENERGY_SetMaxDemandCallback(APP_ENERGY_MAXDEMAND_CALLBACK callback,
 bool APP_ENERGY_GetMonthMaxDemand(struct tm * time);
 void APP_ENERGY_GetCurrentMaxDemand(APP_ENERGY_MAX_DEMAND * pMaxDemand);
 void APP_ENERGY_ClearMaxDemand(bool clearPersistentData);
+uint32_t APP_ENERGY_GetTimeStamp(struct tm * time);
+void APP_ENERGY_SetProfileCallback(APP_ENERGY_PROFILE_CALLBACK callback,
+        APP_ENERGY_PROFILE_RECORD * pProfileResponse, uint16_t maxRecords);
+bool APP_ENERGY_GetProfile(uint32_t timeStart, uint32_t timeEnd);
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
@@ -117,7 +117,7 @@ static void _APP_EVENTS_LoadEvenstDataFromMemory(void)
     appEventsDatalogQueueData.userId = APP_DATALOG_USER_EVENTS;
     appEventsDatalogQueueData.operation = APP_DATALOG_READ;
     appEventsDatalogQueueData.pData = (uint8_t *)&app_eventsData.events;
-    appEventsDatalogQueueData.dataLen = sizeof(APP_EVENTS_DATA);
+    appEventsDatalogQueueData.dataLen = sizeof(APP_EVENTS_EVENTS);
     appEventsDatalogQueueData.endCallback = _APP_EVENTS_GetDataLogCallback;
     appEventsDatalogQueueData.date.month = APP_DATALOG_INVALID_MONTH;
     appEventsDatalogQueueData.date.year = APP_DATALOG_INVALID_YEAR;
@@ -127,15 +127,119 @@ static void _APP_EVENTS_LoadEvenstDataFromMemory(void)
 
 static void _APP_EVENTS_StoreEventsDataInMemory(void)
 {
-    appEventsDatalogQueueData.userId = APP_DATALOG_USER_EVENTS;
-    appEventsDatalogQueueData.operation = APP_DATALOG_WRITE;
-    appEventsDatalogQueueData.pData = (uint8_t *)&app_eventsData.events;
-    appEventsDatalogQueueData.dataLen = sizeof(APP_EVENTS_DATA);
-    appEventsDatalogQueueData.endCallback = NULL;
-    appEventsDatalogQueueData.date.month = APP_DATALOG_INVALID_MONTH;
-    appEventsDatalogQueueData.date.year = APP_DATALOG_INVALID_YEAR;
+    APP_DATALOG_QUEUE_DATA datalogQueueData;
+
+    /* Local queue data: also called from APP_EVENTS_StoreEvents */
+    datalogQueueData.userId = APP_DATALOG_USER_EVENTS;
+    datalogQueueData.operation = APP_DATALOG_WRITE;
+    datalogQueueData.pData = (uint8_t *)&app_eventsData.events;
+    datalogQueueData.dataLen = sizeof(APP_EVENTS_EVENTS);
+    datalogQueueData.endCallback = NULL;
+    datalogQueueData.date.month = APP_DATALOG_INVALID_MONTH;
+    datalogQueueData.date.year = APP_DATALOG_INVALID_YEAR;
+
+    xQueueSend(appDatalogQueueID, &datalogQueueData, (TickType_t) 0);
+}
 
-    xQueueSend(appDatalogQueueID, &appEventsDatalogQueueData, (TickType_t) 0);
+static bool _APP_EVENTS_CheckConfig(APP_EVENTS_EVENT_ID eventId, APP_EVENTS_EVENT_CONFIG *config)
+{
+    if ((config->minStartPeriods == 0) || (config->minEndPeriods == 0))
+    {
+        return false;
+    }
+
+    /* End threshold must give some hysteresis */
+    if (config->startThreshold != 0)
+    {
+        if ((eventId <= SAG_UC_EVENT_ID) && (config->endThreshold < config->startThreshold))
+        {
+            return false;
+        }
+
+        if ((eventId > SAG_UC_EVENT_ID) && (config->endThreshold > config->startThreshold))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void _APP_EVENTS_SetDefaultConfig(void)
+{
+    uint8_t index;
+
+    /* Events follow the metrology AFE flags by default */
+    for (index = 0; index < EVENTS_NUM_ID; index++)
+    {
+        app_eventsData.events.config[index].startThreshold = 0;
+        app_eventsData.events.config[index].endThreshold = 0;
+        app_eventsData.events.config[index].minStartPeriods = EVENT_HOLDING_START_COUNTER;
+        app_eventsData.events.config[index].minEndPeriods = EVENT_HOLDING_END_COUNTER;
+    }
+
+    memset(app_eventsData.events.dropped, 0, sizeof(app_eventsData.events.dropped));
+    app_eventsData.events.marker = APP_EVENTS_CONFIG_MARKER;
+}
+
+static bool _APP_EVENTS_InitializeConfig(bool dataValid)
+{
+    uint8_t index;
+
+    if ((dataValid) && (app_eventsData.events.marker == APP_EVENTS_CONFIG_MARKER))
+    {
+        for (index = 0; index < EVENTS_NUM_ID; index++)
+        {
+            if (!_APP_EVENTS_CheckConfig((APP_EVENTS_EVENT_ID)index, &app_eventsData.events.config[index]))
+            {
+                break;
+            }
+        }
+
+        if (index == EVENTS_NUM_ID)
+        {
+            return false;
+        }
+    }
+
+    /* Events data stored without valid settings */
+    _APP_EVENTS_SetDefaultConfig();
+
+    return true;
+}
+
+static bool _APP_EVENTS_CheckCondition(APP_EVENTS_EVENT_ID type, bool afeFlag, uint32_t rmsValue)
+{
+    APP_EVENTS_EVENT_CONFIG * eventConfig;
+    APP_EVENTS_EVENT_STATUS status;
+    uint32_t threshold;
+
+    eventConfig = &app_eventsData.events.config[type];
+
+    if (eventConfig->startThreshold == 0)
+    {
+        return afeFlag;
+    }
+
+    /* Once the event has started, the end threshold applies (hysteresis) */
+    status = app_eventsData.events.event[type].status;
+    if ((status == EVENT_START) || (status == EVENT_HOLDING_END))
+    {
+        threshold = eventConfig->endThreshold;
+    }
+    else
+    {
+        threshold = eventConfig->startThreshold;
+    }
+
+    if (type <= SAG_UC_EVENT_ID)
+    {
+        return (rmsValue < threshold);
+    }
+    else
+    {
+        return (rmsValue > threshold);
+    }
 }
 
 static bool _APP_EVENTS_RegisterEvent(APP_EVENTS_EVENT_ID type, bool enabled, struct tm * timeEvent)
@@ -153,7 +257,7 @@ static bool _APP_EVENTS_RegisterEvent(APP_EVENTS_EVENT_ID type, bool enabled, st
             {
                 /* Start Holding Start time */
                 eventData->status = EVENT_HOLDING_START;
-                eventData->holdingCounter = EVENT_HOLDING_START_COUNTER;
+                eventData->holdingCounter = app_eventsData.events.config[type].minStartPeriods;
             }
             break;
         }
@@ -194,7 +298,7 @@ static bool _APP_EVENTS_RegisterEvent(APP_EVENTS_EVENT_ID type, bool enabled, st
             {
                 /* Start Holding End time */
                 eventData->status = EVENT_HOLDING_END;
-                eventData->holdingCounter = EVENT_HOLDING_END_COUNTER;
+                eventData->holdingCounter = app_eventsData.events.config[type].minEndPeriods;
             }
             break;
         }
@@ -223,6 +327,17 @@ static bool _APP_EVENTS_RegisterEvent(APP_EVENTS_EVENT_ID type, bool enabled, st
                     eventData->counter++;
                     eventData->status = NO_EVENT;
 
+                    /* The log keeps EVENT_LOG_MAX_NUMBER - 1 completed events. Beyond
+                       that, a completed event not stored yet has been overwritten */
+                    if (app_eventsData.pending[type] < (EVENT_LOG_MAX_NUMBER - 1))
+                    {
+                        app_eventsData.pending[type]++;
+                    }
+                    else
+                    {
+                        app_eventsData.events.dropped[type]++;
+                    }
+
                     /* Register event is completed */
                     registered = true;
                 }
@@ -244,32 +359,44 @@ static bool _APP_EVENTS_UpdateEvents(APP_EVENTS_QUEUE_DATA * newEvent)
 {
     bool update = false;
 
-    if (_APP_EVENTS_RegisterEvent(SAG_UA_EVENT_ID, newEvent->eventFlags.sagA, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(SAG_UA_EVENT_ID,
+            _APP_EVENTS_CheckCondition(SAG_UA_EVENT_ID, newEvent->eventFlags.sagA, newEvent->rmsUA),
+            &newEvent->eventTime))
     {
         update = true;
     }
 
-    if (_APP_EVENTS_RegisterEvent(SAG_UB_EVENT_ID, newEvent->eventFlags.sagB, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(SAG_UB_EVENT_ID,
+            _APP_EVENTS_CheckCondition(SAG_UB_EVENT_ID, newEvent->eventFlags.sagB, newEvent->rmsUB),
+            &newEvent->eventTime))
     {
         update = true;
     }
 
-    if (_APP_EVENTS_RegisterEvent(SAG_UC_EVENT_ID, newEvent->eventFlags.sagC, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(SAG_UC_EVENT_ID,
+            _APP_EVENTS_CheckCondition(SAG_UC_EVENT_ID, newEvent->eventFlags.sagC, newEvent->rmsUC),
+            &newEvent->eventTime))
     {
         update = true;
     }
 
-    if (_APP_EVENTS_RegisterEvent(POW_UA_EVENT_ID, newEvent->eventFlags.swellA, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(POW_UA_EVENT_ID,
+            _APP_EVENTS_CheckCondition(POW_UA_EVENT_ID, newEvent->eventFlags.swellA, newEvent->rmsUA),
+            &newEvent->eventTime))
     {
         update = true;
     }
 
-    if (_APP_EVENTS_RegisterEvent(POW_UB_EVENT_ID, newEvent->eventFlags.swellB, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(POW_UB_EVENT_ID,
+            _APP_EVENTS_CheckCondition(POW_UB_EVENT_ID, newEvent->eventFlags.swellB, newEvent->rmsUB),
+            &newEvent->eventTime))
     {
         update = true;
     }
 
-    if (_APP_EVENTS_RegisterEvent(POW_UC_EVENT_ID, newEvent->eventFlags.swellC, &newEvent->eventTime))
+    if (_APP_EVENTS_RegisterEvent(POW_UC_EVENT_ID,
+            _APP_EVENTS_CheckCondition(POW_UC_EVENT_ID, newEvent->eventFlags.swellC, newEvent->rmsUC),
+            &newEvent->eventTime))
     {
         update = true;
     }
@@ -293,6 +420,31 @@ static bool _APP_EVENTS_UpdateEvents(APP_EVENTS_QUEUE_DATA * newEvent)
     return update;
 }
 
+static bool _APP_EVENTS_CheckStore(bool update)
+{
+    /* The first event completed after a quiet period is stored right away.
+       Events completed after it are stored all at once, at most once every
+       APP_EVENTS_STORE_PERIODS, so a disturbed grid cannot flood the datalog */
+    if (update)
+    {
+        app_eventsData.storePending = true;
+    }
+
+    if (app_eventsData.storePeriods > 0)
+    {
+        app_eventsData.storePeriods--;
+    }
+
+    return ((app_eventsData.storePending) && (app_eventsData.storePeriods == 0));
+}
+
+static void _APP_EVENTS_ClearPending(void)
+{
+    memset(app_eventsData.pending, 0, sizeof(app_eventsData.pending));
+    app_eventsData.storePending = false;
+    app_eventsData.storePeriods = APP_EVENTS_STORE_PERIODS;
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Initialization and State Machine Functions
@@ -314,6 +466,9 @@ void APP_EVENTS_Initialize ( void )
 
     /* Initialize Events data */
     memset(&app_eventsData.events, 0, sizeof(APP_EVENTS_EVENTS));
+    _APP_EVENTS_SetDefaultConfig();
+    _APP_EVENTS_ClearPending();
+    app_eventsData.storePeriods = 0;
 
     /* Create the Switches Semaphore. */
     if (OSAL_SEM_Create(&appEventsSemID, OSAL_SEM_TYPE_BINARY, 0, 0) == OSAL_RESULT_FALSE)
@@ -370,6 +525,12 @@ void APP_EVENTS_Tasks ( void )
                 _APP_EVENTS_LoadEvenstDataFromMemory();
                 /* Wait for the semaphore to load data from memory */
                 OSAL_SEM_Pend(&appEventsSemID, OSAL_WAIT_FOREVER);
+
+                /* Settings missing in memory or not valid: store the defaults */
+                if (_APP_EVENTS_InitializeConfig(app_eventsData.dataIsRdy))
+                {
+                    _APP_EVENTS_StoreEventsDataInMemory();
+                }
             }
             else
             {
@@ -387,9 +548,10 @@ void APP_EVENTS_Tasks ( void )
         {
             if (xQueueReceive(appEventsQueueID, &app_eventsData.newEvent, portMAX_DELAY) == pdPASS)
             {
-                if (_APP_EVENTS_UpdateEvents(&app_eventsData.newEvent))
+                if (_APP_EVENTS_CheckStore(_APP_EVENTS_UpdateEvents(&app_eventsData.newEvent)))
                 {
                     _APP_EVENTS_StoreEventsDataInMemory();
+                    _APP_EVENTS_ClearPending();
                 }
             }
         }
@@ -409,8 +571,12 @@ void APP_EVENTS_ClearEvents(void)
     /* Erase all the event records stored in non volatile memory */
     APP_DATALOG_ClearData(APP_DATALOG_USER_EVENTS);
 
-    /* Clear all events data */
-    memset(&app_eventsData.events, 0, sizeof(APP_EVENTS_EVENTS));
+    /* Clear all events data. Settings are kept and stored again */
+    memset(app_eventsData.events.event, 0, sizeof(app_eventsData.events.event));
+    memset(app_eventsData.events.dropped, 0, sizeof(app_eventsData.events.dropped));
+    _APP_EVENTS_ClearPending();
+    app_eventsData.storePending = true;
+    app_eventsData.storePeriods = 0;
 }
 
 bool APP_EVENTS_GetNumEvents(APP_EVENTS_EVENT_ID eventId, uint8_t * counter)
@@ -462,6 +628,61 @@ void APP_EVENTS_GetLastEventFlags(APP_EVENTS_FLAGS *eventFlags)
     }
 }
 
+bool APP_EVENTS_GetEventConfig(APP_EVENTS_EVENT_ID eventId, APP_EVENTS_EVENT_CONFIG *config)
+{
+    if (eventId >= EVENTS_NUM_ID)
+    {
+        return false;
+    }
+
+    *config = app_eventsData.events.config[eventId];
+
+    return true;
+}
+
+bool APP_EVENTS_SetEventConfig(APP_EVENTS_EVENT_ID eventId, APP_EVENTS_EVENT_CONFIG *config)
+{
+    if (eventId >= EVENTS_NUM_ID)
+    {
+        return false;
+    }
+
+    if (!_APP_EVENTS_CheckConfig(eventId, config))
+    {
+        return false;
+    }
+
+    app_eventsData.events.config[eventId] = *config;
+
+    /* Settings are stored by the events task in the next integration period */
+    app_eventsData.storePending = true;
+    app_eventsData.storePeriods = 0;
+
+    return true;
+}
+
+bool APP_EVENTS_GetDroppedEvents(APP_EVENTS_EVENT_ID eventId, uint16_t * counter)
+{
+    if (eventId >= EVENTS_NUM_ID)
+    {
+        return false;
+    }
+
+    *counter = app_eventsData.events.dropped[eventId];
+
+    return true;
+}
+
+void APP_EVENTS_StoreEvents(void)
+{
+    /* Store the completed events not stored yet, i.e. before a reset */
+    if (app_eventsData.storePending)
+    {
+        _APP_EVENTS_StoreEventsDataInMemory();
+        _APP_EVENTS_ClearPending();
+    }
+}
+
 
 /*******************************************************************************
  End of File
@@ -73,6 +73,11 @@ extern "C" {
 #define EVENT_LOG_MAX_NUMBER                 10
 #define EVENT_HOLDING_START_COUNTER          10//60
 #define EVENT_HOLDING_END_COUNTER            10//60
+/* Minimum number of integration periods between two writes of the events in
+   memory. The first event completed after that time is stored right away */
+#define APP_EVENTS_STORE_PERIODS             60
+
+#define APP_EVENTS_CONFIG_MARKER             0x47464345UL
 
 typedef enum
 {
@@ -109,9 +114,31 @@ typedef struct
 	uint8_t dataIndex;
 } APP_EVENTS_EVENT_DATA;
 
+/* Event detection settings.
+   startThreshold = 0: the event follows the metrology AFE flag.
+   Otherwise the RMS voltage of the phase is compared with the thresholds
+   (0.0001 V units): a sag starts below startThreshold and ends above
+   endThreshold, a swell starts above startThreshold and ends below
+   endThreshold. The event starts / ends when the condition still holds
+   minStartPeriods / minEndPeriods integration periods after the one it is
+   first seen in. */
+typedef struct
+{
+    uint32_t startThreshold;
+    uint32_t endThreshold;
+    uint8_t minStartPeriods;
+    uint8_t minEndPeriods;
+} APP_EVENTS_EVENT_CONFIG;
+
+/* Events data stored in memory. Detection settings and drop counters follow
+   the event logs, marker tells whether they have been stored */
 typedef struct
 {
     APP_EVENTS_EVENT_DATA event[EVENTS_NUM_ID];
+    uint32_t marker;
+    APP_EVENTS_EVENT_CONFIG config[EVENTS_NUM_ID];
+    /* Completed events overwritten before being stored in memory */
+    uint16_t dropped[EVENTS_NUM_ID];
 } APP_EVENTS_EVENTS;
 
 typedef struct
@@ -122,6 +149,11 @@ typedef struct
     // Time stamp when events have been detected
     struct tm eventTime;
 
+    // RMS voltages of the integration period
+    uint32_t rmsUA;
+    uint32_t rmsUB;
+    uint32_t rmsUC;
+
 } APP_EVENTS_QUEUE_DATA;
 
 typedef struct {
@@ -185,6 +217,15 @@ typedef struct
 
     APP_EVENTS_FLAGS flags;
 
+    /* Completed events not stored in memory yet */
+    uint8_t pending[EVENTS_NUM_ID];
+
+    /* Integration periods until events can be stored in memory again */
+    uint16_t storePeriods;
+
+    /* Events data has to be stored in memory */
+    bool storePending;
+
     bool dataIsRdy;
 
 } APP_EVENTS_DATA;
@@ -274,6 +315,10 @@ void APP_EVENTS_ClearEvents(void);
 bool APP_EVENTS_GetNumEvents(APP_EVENTS_EVENT_ID eventId, uint8_t * counter);
 bool APP_EVENTS_GetEventInfo(APP_EVENTS_EVENT_ID eventId, uint8_t offset, APP_EVENTS_EVENT_INFO *eventInfo);
 void APP_EVENTS_GetLastEventFlags(APP_EVENTS_FLAGS *eventFlags);
+bool APP_EVENTS_GetEventConfig(APP_EVENTS_EVENT_ID eventId, APP_EVENTS_EVENT_CONFIG *config);
+bool APP_EVENTS_SetEventConfig(APP_EVENTS_EVENT_ID eventId, APP_EVENTS_EVENT_CONFIG *config);
+bool APP_EVENTS_GetDroppedEvents(APP_EVENTS_EVENT_ID eventId, uint16_t * counter);
+void APP_EVENTS_StoreEvents(void);
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
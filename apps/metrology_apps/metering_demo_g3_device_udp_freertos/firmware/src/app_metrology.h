@@ -274,6 +274,59 @@ typedef struct
     DRV_METROLOGY_PHASE_ID lineId;
 } APP_METROLOGY_CALIBRATION;
 
+/* Waveform capture window: samples per channel before and after the trigger */
+#define APP_METROLOGY_WAVEFORM_PRE_SAMPLES        160
+#define APP_METROLOGY_WAVEFORM_POST_SAMPLES       640
+/* Samples per channel compressed together. Prediction restarts every block */
+#define APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES      16
+#define APP_METROLOGY_WAVEFORM_MAX_CHANNELS       6
+/* Worst case: 5 bytes per sample */
+#define APP_METROLOGY_WAVEFORM_BLOCK_MAX_SIZE     (APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES * APP_METROLOGY_WAVEFORM_MAX_CHANNELS * 5)
+/* Compressed window is split in chunks that can be decoded alone */
+#define APP_METROLOGY_WAVEFORM_CHUNK_SIZE         512
+#define APP_METROLOGY_WAVEFORM_MAX_CHUNKS         48
+#define APP_METROLOGY_WAVEFORM_BUFFER_SIZE        12288
+/* Polling period of the capture buffer while waiting for post-trigger samples */
+#define APP_METROLOGY_WAVEFORM_POLL_MS            10
+
+typedef enum
+{
+    APP_METROLOGY_WAVEFORM_STOPPED = 0,
+    APP_METROLOGY_WAVEFORM_ARMED,
+    APP_METROLOGY_WAVEFORM_TRIGGERED,
+} APP_METROLOGY_WAVEFORM_STATE;
+
+typedef struct
+{
+    /* Identifier of the compressed window. 0 if there is no window */
+    uint32_t captureId;
+    /* Samples per channel in the window and before the trigger */
+    uint16_t numSamples;
+    uint16_t preSamples;
+    uint16_t numChunks;
+    /* Windows overwritten in the capture buffer before being compressed */
+    uint16_t lostCount;
+    /* DRV_METROLOGY_CAPTURE_CH_xx bitmap */
+    uint8_t channels;
+    uint8_t source;
+} APP_METROLOGY_WAVEFORM_INFO;
+
+typedef struct
+{
+    APP_METROLOGY_WAVEFORM_STATE state;
+    APP_METROLOGY_WAVEFORM_INFO info;
+    uint8_t channels;
+    uint8_t numChannels;
+    DRV_METROLOGY_CAPTURE_SOURCE source;
+    bool eventTrigger;
+    bool eventActive;
+    volatile bool triggerRequest;
+    uint32_t triggerOffset;
+    uint16_t triggerPreSamples;
+    uint64_t triggerTime;
+    uint32_t captureCounter;
+} APP_METROLOGY_WAVEFORM;
+
 // *****************************************************************************
 /* Application states
 
@@ -320,15 +373,20 @@ typedef struct
 
     DRV_METROLOGY_REGS_CONTROL * pMetControl;
     DRV_METROLOGY_REGS_STATUS * pMetStatus;
-    DRV_METROLOGY_REGS_ACCUMULATORS * pMetAccData;
-    DRV_METROLOGY_REGS_HARMONICS * pMetHarData;
 
     bool harmonicAnalysisPending;
     DRV_METROLOGY_HARMONICS_RMS * pHarmonicAnalysisResponse;
     DRV_METROLOGY_HARMONICS_CALLBACK pHarmonicAnalysisCallback;
 
+    DRV_METROLOGY_HARMONICS_RMS * pHarmonicBatchTable;
+    uint8_t harmonicBatchTableSize;
+    DRV_METROLOGY_HARMONICS_THD * pHarmonicBatchThd;
+    DRV_METROLOGY_HARMONICS_BATCH_CALLBACK pHarmonicBatchCallback;
+
     DRV_METROLOGY_CALIBRATION_CALLBACK pCalibrationCallback;
 
+    APP_METROLOGY_WAVEFORM waveform;
+
     uint32_t queueFree;
 
     bool setConfiguration;
@@ -423,15 +481,24 @@ bool APP_METROLOGY_GetStatusRegister(STATUS_REG_ID regId, uint32_t * regValue, c
 bool APP_METROLOGY_GetAccumulatorRegister(ACCUMULATOR_REG_ID regId, uint64_t * regValue, char *regName);
 bool APP_METROLOGY_GetHarmonicsRegister(HARMONICS_REG_ID regId, uint32_t * regValue, char *regName);
 bool APP_METROLOGY_GetRMS(DRV_METROLOGY_RMS_TYPE rmsId, uint32_t * rmsValue, DRV_METROLOGY_RMS_SIGN * sign);
+bool APP_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot);
 void APP_METROLOGY_SetControlByDefault(void);
 void APP_METROLOGY_StoreMetrologyData(void);
 void APP_METROLOGY_SetConfiguration(DRV_METROLOGY_CONFIGURATION * config);
 void APP_METROLOGY_StartCalibration(APP_METROLOGY_CALIBRATION * calibration);
 void APP_METROLOGY_SetCalibrationCallback(DRV_METROLOGY_CALIBRATION_CALLBACK callback);
 size_t APP_METROLOGY_GetWaveformCaptureData(uint32_t *pData);
+bool APP_METROLOGY_StartWaveformCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source, bool eventTrigger);
+void APP_METROLOGY_StopWaveformCapture(void);
+bool APP_METROLOGY_TriggerWaveformCapture(void);
+void APP_METROLOGY_GetWaveformInfo(APP_METROLOGY_WAVEFORM_INFO * info);
+uint16_t APP_METROLOGY_GetWaveformChunk(uint32_t captureId, uint16_t chunkIndex, uint8_t * pData, uint16_t maxSize);
 bool APP_METROLOGY_StartHarmonicAnalysis(uint8_t harmonicNum);
 void APP_METROLOGY_SetHarmonicAnalysisCallback(DRV_METROLOGY_HARMONICS_CALLBACK callback,
         DRV_METROLOGY_HARMONICS_RMS * pHarmonicAnalysisResponse);
+bool APP_METROLOGY_StartHarmonicAnalysisBatch(uint64_t harmonicBitmap);
+void APP_METROLOGY_SetHarmonicBatchCallback(DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback,
+        DRV_METROLOGY_HARMONICS_RMS * pHarmonicTable, uint8_t tableSize, DRV_METROLOGY_HARMONICS_THD * pThd);
 void APP_METROLOGY_Restart(void);
 void APP_METROLOGY_SetLowPowerMode (void);
 bool APP_METROLOGY_CheckPhaseEnabled (APP_METROLOGY_PHASE_ID phase);
@@ -53,6 +53,434 @@
 
 APP_UDP_METROLOGY_DATA app_udp_metrologyData;
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static bool _APP_UDP_METROLOGY_GetMetrologyData(APP_UDP_METROLOGY_RESPONSE_DATA *pMetData)
+{
+    DRV_METROLOGY_SNAPSHOT snapshot;
+
+    /* All the quantities are read at once from the same integration period */
+    if (APP_METROLOGY_GetSnapshot(&snapshot) == false)
+    {
+        return false;
+    }
+
+    /* Fields of the response follow the order of DRV_METROLOGY_RMS_TYPE */
+    memcpy(pMetData, snapshot.RMS, sizeof(APP_UDP_METROLOGY_RESPONSE_DATA));
+
+    return true;
+}
+
+static void _APP_UDP_METROLOGY_GetMetrologyValues(APP_UDP_METROLOGY_RESPONSE_DATA *pMetData)
+{
+    int32_t values[APP_UDP_METROLOGY_QUANTITIES_NUM];
+    DRV_METROLOGY_RMS_SIGN rmsSign;
+    uint32_t value;
+    uint8_t idx;
+
+    /* Values read one by one, as before the snapshot */
+    for (idx = 0; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        APP_METROLOGY_GetRMS((DRV_METROLOGY_RMS_TYPE)idx, &value, &rmsSign);
+        if (rmsSign == RMS_SIGN_NEGATIVE)
+        {
+            values[idx] = -(int32_t)value;
+        }
+        else
+        {
+            values[idx] = (int32_t)value;
+        }
+    }
+
+    memcpy(pMetData, values, sizeof(APP_UDP_METROLOGY_RESPONSE_DATA));
+}
+
+static uint8_t _APP_UDP_METROLOGY_PutVarint(uint8_t *pBuffer, int32_t delta)
+{
+    uint32_t value;
+    uint8_t length = 0;
+
+    /* Zigzag encoding: small deltas of any sign get small values */
+    value = (uint32_t)delta << 1;
+    if (delta < 0)
+    {
+        value = ~value;
+    }
+
+    /* Varint encoding: 7 bits per byte, MSB set if more bytes follow */
+    while (value >= 0x80)
+    {
+        pBuffer[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    pBuffer[length++] = (uint8_t)value;
+
+    return length;
+}
+
+static void _APP_UDP_METROLOGY_PutCompactData(UDP_SOCKET hUDP, uint32_t quantitiesMask)
+{
+    DRV_METROLOGY_SNAPSHOT snapshot;
+    uint8_t buffer[APP_UDP_METROLOGY_COMPACT_MAX_SIZE];
+    uint16_t length;
+    uint8_t idx;
+
+    if (APP_METROLOGY_GetSnapshot(&snapshot) == false)
+    {
+        /* No data available: sequence 0 and no quantities */
+        snapshot.sequence = 0;
+        quantitiesMask = 0;
+    }
+
+    buffer[0] = APP_UDP_METROLOGY_MSG_COMPACT_DATA_RESPONSE;
+    memcpy(&buffer[1], &snapshot.sequence, sizeof(snapshot.sequence));
+    memcpy(&buffer[5], &quantitiesMask, sizeof(quantitiesMask));
+
+    length = 9;
+    for (idx = 0; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        if (quantitiesMask & (1UL << idx))
+        {
+            length += _APP_UDP_METROLOGY_PutVarint(&buffer[length], snapshot.RMS[idx]);
+        }
+    }
+
+    TCPIP_UDP_ArrayPut(hUDP, buffer, length);
+}
+
+static bool _APP_UDP_METROLOGY_GetSubscription(UDP_SOCKET hUDP, uint16_t dataLen,
+        APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST *pRequest)
+{
+    UDP_SOCKET_INFO socketInfo;
+    uint32_t quantitiesMask;
+    uint16_t periodS;
+    uint8_t idx;
+
+    if (dataLen < (sizeof(quantitiesMask) + sizeof(periodS)))
+    {
+        return false;
+    }
+
+    TCPIP_UDP_ArrayGet(hUDP, (uint8_t *) &quantitiesMask, sizeof(quantitiesMask));
+    TCPIP_UDP_ArrayGet(hUDP, (uint8_t *) &periodS, sizeof(periodS));
+    dataLen -= sizeof(quantitiesMask) + sizeof(periodS);
+
+    if ((quantitiesMask == 0) || ((quantitiesMask & ~APP_UDP_METROLOGY_QUANTITIES_MASK) != 0) ||
+        (periodS < APP_UDP_METROLOGY_PERIOD_MIN_S) || (periodS > APP_UDP_METROLOGY_PERIOD_MAX_S))
+    {
+        return false;
+    }
+
+    /* Updates are sent to the sender of the request */
+    if (TCPIP_UDP_SocketInfoGet(hUDP, &socketInfo) == false)
+    {
+        return false;
+    }
+
+    pRequest->remoteAddress = socketInfo.remoteIPaddress.v6Add;
+    pRequest->remotePort = socketInfo.remotePort;
+    pRequest->quantitiesMask = quantitiesMask;
+    pRequest->periodMs = (uint32_t)periodS * 1000;
+    pRequest->subscribe = true;
+
+    /* Deadbands are optional, in the order of the mask bits */
+    for (idx = 0; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        pRequest->deadband[idx] = 0;
+        if ((quantitiesMask & (1UL << idx)) && (dataLen >= sizeof(uint32_t)))
+        {
+            TCPIP_UDP_ArrayGet(hUDP, (uint8_t *) &pRequest->deadband[idx], sizeof(uint32_t));
+            dataLen -= sizeof(uint32_t);
+        }
+    }
+
+    return true;
+}
+
+static bool _APP_UDP_METROLOGY_PostSubscription(const APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST *pRequest)
+{
+    if (OSAL_MUTEX_Lock(&app_udp_metrologyData.requestMutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_TRUE)
+    {
+        return false;
+    }
+
+    /* A newer request replaces a pending one */
+    app_udp_metrologyData.request = *pRequest;
+    app_udp_metrologyData.requestPending = true;
+
+    OSAL_MUTEX_Unlock(&app_udp_metrologyData.requestMutex);
+
+    return true;
+}
+
+static void _APP_UDP_METROLOGY_UpdateSubscription(void)
+{
+    APP_UDP_METROLOGY_SUBSCRIPTION *pSubscription = &app_udp_metrologyData.subscription;
+    APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST request;
+    bool requestPending;
+
+    if (OSAL_MUTEX_Lock(&app_udp_metrologyData.requestMutex, OSAL_WAIT_FOREVER) != OSAL_RESULT_TRUE)
+    {
+        return;
+    }
+
+    requestPending = app_udp_metrologyData.requestPending;
+    if (requestPending == true)
+    {
+        request = app_udp_metrologyData.request;
+        app_udp_metrologyData.requestPending = false;
+    }
+
+    OSAL_MUTEX_Unlock(&app_udp_metrologyData.requestMutex);
+
+    if (requestPending == false)
+    {
+        return;
+    }
+
+    /* Replace previous subscription, if any. The update socket is opened
+     * again for the new subscriber when the first update is sent */
+    pSubscription->active = false;
+    if (app_udp_metrologyData.updateSocket != INVALID_SOCKET)
+    {
+        TCPIP_UDP_Close(app_udp_metrologyData.updateSocket);
+        app_udp_metrologyData.updateSocket = INVALID_SOCKET;
+    }
+
+    if (request.subscribe == false)
+    {
+        return;
+    }
+
+    pSubscription->remoteAddress = request.remoteAddress;
+    pSubscription->remotePort = request.remotePort;
+    pSubscription->quantitiesMask = request.quantitiesMask;
+    pSubscription->periodMs = request.periodMs;
+    memcpy(pSubscription->deadband, request.deadband, sizeof(pSubscription->deadband));
+
+    /* First update is a full update and it is sent right away */
+    memset(pSubscription->lastValue, 0, sizeof(pSubscription->lastValue));
+    pSubscription->fullUpdateCounter = 0;
+    pSubscription->sequence = 0;
+    pSubscription->nextReportTime = SYS_TIME_Counter64Get();
+    pSubscription->active = true;
+}
+
+static bool _APP_UDP_METROLOGY_OpenUpdateSocket(void)
+{
+    APP_UDP_METROLOGY_SUBSCRIPTION *pSubscription = &app_udp_metrologyData.subscription;
+    IP_MULTI_ADDRESS remoteAddress;
+    UDP_SOCKET socket;
+
+    remoteAddress.v6Add = pSubscription->remoteAddress;
+    socket = TCPIP_UDP_ClientOpen(IP_ADDRESS_TYPE_IPV6, pSubscription->remotePort, &remoteAddress);
+    if (socket == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    /* Send from the update port. The socket is only used to send, drop
+     * anything received on it */
+    if (TCPIP_UDP_Bind(socket, IP_ADDRESS_TYPE_IPV6, APP_UDP_METROLOGY_UPDATE_PORT, NULL) == false)
+    {
+        TCPIP_UDP_Close(socket);
+        return false;
+    }
+
+    TCPIP_UDP_OptionsSet(socket, UDP_OPTION_RX_QUEUE_LIMIT, (void*)0);
+
+    app_udp_metrologyData.updateSocket = socket;
+
+    return true;
+}
+
+static void _APP_UDP_METROLOGY_SendDataUpdate(void)
+{
+    APP_UDP_METROLOGY_SUBSCRIPTION *pSubscription = &app_udp_metrologyData.subscription;
+    APP_UDP_METROLOGY_RESPONSE_DATA metData;
+    uint32_t values[APP_UDP_METROLOGY_QUANTITIES_NUM];
+    uint8_t buffer[APP_UDP_METROLOGY_UPDATE_MAX_SIZE];
+    uint32_t changedMask = 0;
+    uint32_t absDelta;
+    int32_t delta;
+    uint16_t length;
+    uint8_t idx;
+    bool fullUpdate;
+
+    /* Retried every period if there is no socket available */
+    if ((app_udp_metrologyData.updateSocket == INVALID_SOCKET) &&
+        (_APP_UDP_METROLOGY_OpenUpdateSocket() == false))
+    {
+        SYS_DEBUG_MESSAGE(SYS_ERROR_WARNING, "APP_UDP_METROLOGY: Update socket not available\r\n");
+        return;
+    }
+
+    /* Skip this period if the update may not fit in the socket */
+    if (TCPIP_UDP_PutIsReady(app_udp_metrologyData.updateSocket) < APP_UDP_METROLOGY_UPDATE_MAX_SIZE)
+    {
+        return;
+    }
+
+    /* All the quantities are 32-bit */
+    if (_APP_UDP_METROLOGY_GetMetrologyData(&metData) == false)
+    {
+        return;
+    }
+
+    memcpy(values, &metData, sizeof(values));
+
+    fullUpdate = (pSubscription->fullUpdateCounter == 0);
+
+    /* Header is filled at the end: message, sequence, flags, changed mask */
+    length = 7;
+    for (idx = 0; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        if ((pSubscription->quantitiesMask & (1UL << idx)) == 0)
+        {
+            continue;
+        }
+
+        if (fullUpdate)
+        {
+            delta = (int32_t)values[idx];
+        }
+        else
+        {
+            /* Deltas are computed modulo 2^32, valid for signed and unsigned quantities */
+            delta = (int32_t)(values[idx] - pSubscription->lastValue[idx]);
+            absDelta = (delta < 0) ? (0U - (uint32_t)delta) : (uint32_t)delta;
+            if (absDelta <= pSubscription->deadband[idx])
+            {
+                continue;
+            }
+        }
+
+        length += _APP_UDP_METROLOGY_PutVarint(&buffer[length], delta);
+        pSubscription->lastValue[idx] = values[idx];
+        changedMask |= (1UL << idx);
+    }
+
+    if (fullUpdate)
+    {
+        pSubscription->fullUpdateCounter = APP_UDP_METROLOGY_FULL_UPDATE_PERIODS;
+    }
+    pSubscription->fullUpdateCounter--;
+
+    if (changedMask == 0)
+    {
+        /* Nothing changed beyond the deadbands */
+        return;
+    }
+
+    buffer[0] = APP_UDP_METROLOGY_MSG_DATA_UPDATE;
+    buffer[1] = pSubscription->sequence++;
+    buffer[2] = fullUpdate ? APP_UDP_METROLOGY_UPDATE_FLAG_FULL : 0;
+    memcpy(&buffer[3], &changedMask, sizeof(changedMask));
+
+    TCPIP_UDP_ArrayPut(app_udp_metrologyData.updateSocket, buffer, length);
+    TCPIP_UDP_Flush(app_udp_metrologyData.updateSocket);
+}
+
+static void _APP_UDP_METROLOGY_Waveform(UDP_SOCKET hUDP, uint16_t rxSize)
+{
+    static uint8_t chunk[APP_METROLOGY_WAVEFORM_CHUNK_SIZE];
+    APP_METROLOGY_WAVEFORM_INFO info;
+    uint8_t buffer[APP_UDP_METROLOGY_WAVEFORM_HEADER_SIZE];
+    uint8_t args[3];
+    uint16_t chunkIndex = 0;
+    uint16_t chunkSize = 0;
+    uint8_t command;
+    bool result = false;
+
+    if (rxSize < 1)
+    {
+        return;
+    }
+
+    TCPIP_UDP_Get(hUDP, &command);
+    rxSize--;
+
+    switch (command)
+    {
+        case APP_UDP_METROLOGY_WAVEFORM_CMD_START:
+            if (rxSize >= sizeof(args))
+            {
+                TCPIP_UDP_ArrayGet(hUDP, args, sizeof(args));
+                result = APP_METROLOGY_StartWaveformCapture(args[0],
+                        (DRV_METROLOGY_CAPTURE_SOURCE)args[1], args[2] != 0);
+            }
+            break;
+
+        case APP_UDP_METROLOGY_WAVEFORM_CMD_STOP:
+            APP_METROLOGY_StopWaveformCapture();
+            result = true;
+            break;
+
+        case APP_UDP_METROLOGY_WAVEFORM_CMD_TRIGGER:
+            result = APP_METROLOGY_TriggerWaveformCapture();
+            break;
+
+        case APP_UDP_METROLOGY_WAVEFORM_CMD_GET_INFO:
+            result = true;
+            break;
+
+        case APP_UDP_METROLOGY_WAVEFORM_CMD_GET_CHUNK:
+            result = (rxSize >= sizeof(chunkIndex));
+            if (result)
+            {
+                TCPIP_UDP_ArrayGet(hUDP, (uint8_t *) &chunkIndex, sizeof(chunkIndex));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* Capture id is 0 if there is no compressed window available. Chunks
+     * are only read if they belong to the reported capture id */
+    APP_METROLOGY_GetWaveformInfo(&info);
+
+    if ((command == APP_UDP_METROLOGY_WAVEFORM_CMD_GET_CHUNK) && result)
+    {
+        /* Read the chunk only if the response fits in the socket */
+        if (TCPIP_UDP_PutIsReady(hUDP) >= (APP_UDP_METROLOGY_WAVEFORM_HEADER_SIZE + sizeof(chunkIndex) + APP_METROLOGY_WAVEFORM_CHUNK_SIZE))
+        {
+            chunkSize = APP_METROLOGY_GetWaveformChunk(info.captureId, chunkIndex,
+                    chunk, APP_METROLOGY_WAVEFORM_CHUNK_SIZE);
+        }
+
+        result = (chunkSize > 0);
+    }
+
+    buffer[0] = APP_UDP_METROLOGY_MSG_WAVEFORM_RESPONSE;
+    buffer[1] = command;
+    buffer[2] = result ? 0 : 1;
+    memcpy(&buffer[3], &info.captureId, sizeof(info.captureId));
+    buffer[7] = info.channels;
+    buffer[8] = info.source;
+    buffer[9] = APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES;
+    memcpy(&buffer[10], &info.numSamples, sizeof(info.numSamples));
+    memcpy(&buffer[12], &info.preSamples, sizeof(info.preSamples));
+    memcpy(&buffer[14], &info.numChunks, sizeof(info.numChunks));
+    memcpy(&buffer[16], &info.lostCount, sizeof(info.lostCount));
+
+    TCPIP_UDP_ArrayPut(hUDP, buffer, sizeof(buffer));
+
+    if (chunkSize > 0)
+    {
+        TCPIP_UDP_ArrayPut(hUDP, (const uint8_t *) &chunkIndex, sizeof(chunkIndex));
+        TCPIP_UDP_ArrayPut(hUDP, chunk, chunkSize);
+    }
+
+    /* Send the UDP reply */
+    TCPIP_UDP_Flush(hUDP);
+}
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Callback Functions
@@ -81,124 +509,90 @@ void _APP_UDP_METROLOGY_UdpRxCallback(UDP_SOCKET hUDP, TCPIP_NET_HANDLE hNet, TC
 
     switch (udpProtocol)
     {
-        case 1:
+        case APP_UDP_METROLOGY_MSG_DATA_REQUEST:
         {
             /* Metrology data request. The response is 0x02 with
              * metrology data (RMS instantaneous values) */
             APP_UDP_METROLOGY_RESPONSE_DATA metData;
-            DRV_METROLOGY_RMS_SIGN rmsSign;
 
             /* Put the first byte (0x02: Metrology data response) */
-            TCPIP_UDP_Put(hUDP, 2);
-
-            /* Get RMS voltage values (without sign) */
-            APP_METROLOGY_GetRMS(RMS_UA, &metData.rmsUA, NULL);
-            APP_METROLOGY_GetRMS(RMS_UB, &metData.rmsUB, NULL);
-            APP_METROLOGY_GetRMS(RMS_UC, &metData.rmsUC, NULL);
-
-            /* Get RMS current values (without sign) */
-            APP_METROLOGY_GetRMS(RMS_IA, &metData.rmsIA, NULL);
-            APP_METROLOGY_GetRMS(RMS_IB, &metData.rmsIB, NULL);
-            APP_METROLOGY_GetRMS(RMS_IC, &metData.rmsIC, NULL);
-            APP_METROLOGY_GetRMS(RMS_INI, &metData.rmsINI, NULL);
-            APP_METROLOGY_GetRMS(RMS_INM, &metData.rmsINM, NULL);
-            APP_METROLOGY_GetRMS(RMS_INMI, &metData.rmsINMI, NULL);
-
-            /* Get RMS active power values (with sign) */
-            APP_METROLOGY_GetRMS(RMS_PT, (uint32_t*) &metData.rmsPT, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsPT = -metData.rmsPT;
-            }
+            TCPIP_UDP_Put(hUDP, APP_UDP_METROLOGY_MSG_DATA_RESPONSE);
 
-            APP_METROLOGY_GetRMS(RMS_PA, (uint32_t*) &metData.rmsPA, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
+            if (_APP_UDP_METROLOGY_GetMetrologyData(&metData) == false)
             {
-                metData.rmsPA = -metData.rmsPA;
+                /* No snapshot available: read the current values */
+                _APP_UDP_METROLOGY_GetMetrologyValues(&metData);
             }
 
-            APP_METROLOGY_GetRMS(RMS_PB, (uint32_t*) &metData.rmsPB, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsPB = -metData.rmsPB;
-            }
+            /* Insert metrology data in UDP reply */
+            TCPIP_UDP_ArrayPut(hUDP, (const uint8_t *) &metData, sizeof(metData));
 
-            APP_METROLOGY_GetRMS(RMS_PC, (uint32_t*) &metData.rmsPC, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsPC = -metData.rmsPC;
-            }
+            /* Send the UDP reply */
+            TCPIP_UDP_Flush(hUDP);
+            break;
+        }
 
-            /* Get RMS reactive power values (with sign) */
-            APP_METROLOGY_GetRMS(RMS_QT, (uint32_t*) &metData.rmsQT, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsQT = -metData.rmsQT;
-            }
+        case APP_UDP_METROLOGY_MSG_COMPACT_DATA_REQUEST:
+        {
+            /* Compact metrology data request. The response is 0x08 with
+             * the requested quantities (all of them by default) */
+            uint32_t quantitiesMask = APP_UDP_METROLOGY_QUANTITIES_MASK;
 
-            APP_METROLOGY_GetRMS(RMS_QA, (uint32_t*) &metData.rmsQA, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
+            if (rxPayloadSize >= (1 + sizeof(quantitiesMask)))
             {
-                metData.rmsQA = -metData.rmsQA;
+                TCPIP_UDP_ArrayGet(hUDP, (uint8_t *) &quantitiesMask, sizeof(quantitiesMask));
+                quantitiesMask &= APP_UDP_METROLOGY_QUANTITIES_MASK;
             }
 
-            APP_METROLOGY_GetRMS(RMS_QB, (uint32_t*) &metData.rmsQB, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsQB = -metData.rmsQB;
-            }
+            _APP_UDP_METROLOGY_PutCompactData(hUDP, quantitiesMask);
 
-            APP_METROLOGY_GetRMS(RMS_QC, (uint32_t*) &metData.rmsQC, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.rmsQC = -metData.rmsQC;
-            }
+            /* Send the UDP reply */
+            TCPIP_UDP_Flush(hUDP);
+            break;
+        }
 
-            /* Get RMS aparent power values (without sign) */
-            APP_METROLOGY_GetRMS(RMS_ST, &metData.rmsST, NULL);
-            APP_METROLOGY_GetRMS(RMS_SA, &metData.rmsSA, NULL);
-            APP_METROLOGY_GetRMS(RMS_SB, &metData.rmsSB, NULL);
-            APP_METROLOGY_GetRMS(RMS_SC, &metData.rmsSC, NULL);
-
-            /* Get frequency of the line voltage fundamental harmonic
-             * component determined by the Metrology library using the
-             * dominant phase */
-            APP_METROLOGY_GetRMS(RMS_FREQ, &metData.freq, NULL);
-
-            /* Get angles between the voltage and current vectors
-             * (with sign) */
-            APP_METROLOGY_GetRMS(RMS_ANGLEA, (uint32_t*) &metData.angleA, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
-            {
-                metData.angleA = -metData.angleA;
-            }
+        case APP_UDP_METROLOGY_MSG_SUBSCRIBE_REQUEST:
+        case APP_UDP_METROLOGY_MSG_UNSUBSCRIBE_REQUEST:
+        {
+            /* Subscription to metrology data updates. The response is 0x04
+             * with the result. The subscription is updated by the task */
+            APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST request;
+            bool result;
 
-            APP_METROLOGY_GetRMS(RMS_ANGLEB, (uint32_t*) &metData.angleB, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
+            if (udpProtocol == APP_UDP_METROLOGY_MSG_SUBSCRIBE_REQUEST)
             {
-                metData.angleB = -metData.angleB;
+                result = _APP_UDP_METROLOGY_GetSubscription(hUDP, rxPayloadSize - 1, &request);
             }
-
-            APP_METROLOGY_GetRMS(RMS_ANGLEC, (uint32_t*) &metData.angleC, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
+            else
             {
-                metData.angleC = -metData.angleC;
+                request.subscribe = false;
+                result = true;
             }
 
-            APP_METROLOGY_GetRMS(RMS_ANGLEN, (uint32_t*) &metData.angleN, &rmsSign);
-            if (rmsSign == RMS_SIGN_NEGATIVE)
+            if (result == true)
             {
-                metData.angleN = -metData.angleN;
+                result = _APP_UDP_METROLOGY_PostSubscription(&request);
             }
 
-            /* Insert metrology data in UDP reply */
-            TCPIP_UDP_ArrayPut(hUDP, (const uint8_t *) &metData, sizeof(metData));
+            TCPIP_UDP_Put(hUDP, APP_UDP_METROLOGY_MSG_SUBSCRIBE_RESPONSE);
+            TCPIP_UDP_Put(hUDP, result ? 0 : 1);
+
+            /* Wakeup task to update the reporting period */
+            OSAL_SEM_Post(&app_udp_metrologyData.semaphoreID);
 
             /* Send the UDP reply */
             TCPIP_UDP_Flush(hUDP);
             break;
         }
 
+        case APP_UDP_METROLOGY_MSG_WAVEFORM_REQUEST:
+        {
+            /* Waveform capture control and compressed window read. The
+             * response is 0x0A with the capture status */
+            _APP_UDP_METROLOGY_Waveform(hUDP, rxPayloadSize - 1);
+            break;
+        }
+
         default:
         {
             SYS_DEBUG_MESSAGE(SYS_ERROR_INFO, "APP_UDP_METROLOGY: Drop UDP message\r\n");
@@ -228,6 +622,13 @@ void APP_UDP_METROLOGY_Initialize ( void )
 {
     /* Place the App state machine in its initial state. */
     app_udp_metrologyData.state = APP_UDP_METROLOGY_STATE_WAIT_TCPIP_READY;
+    app_udp_metrologyData.socket = INVALID_SOCKET;
+    app_udp_metrologyData.updateSocket = INVALID_SOCKET;
+    app_udp_metrologyData.subscription.active = false;
+    app_udp_metrologyData.requestPending = false;
+
+    /* Create mutex. It protects the requests received from the TCP/IP task */
+    OSAL_MUTEX_Create(&app_udp_metrologyData.requestMutex);
 
     /* Create semaphore. It is used to suspend task. */
     OSAL_SEM_Create(&app_udp_metrologyData.semaphoreID, OSAL_SEM_TYPE_BINARY, 0, 0);
@@ -280,6 +681,7 @@ void APP_UDP_METROLOGY_Tasks ( void )
                 TCPIP_UDP_SignalHandlerRegister(socket, TCPIP_UDP_SIGNAL_RX_DATA,
                         _APP_UDP_METROLOGY_UdpRxCallback, NULL);
 
+                app_udp_metrologyData.socket = socket;
                 app_udp_metrologyData.state = APP_UDP_METROLOGY_STATE_SERVING_CONNECTION;
             }
 
@@ -288,6 +690,54 @@ void APP_UDP_METROLOGY_Tasks ( void )
 
         /* Serving connection on UDP port */
         case APP_UDP_METROLOGY_STATE_SERVING_CONNECTION:
+        {
+            APP_UDP_METROLOGY_SUBSCRIPTION *pSubscription = &app_udp_metrologyData.subscription;
+            uint64_t currentTime = SYS_TIME_Counter64Get();
+            uint64_t periodCount;
+
+            /* Apply the last subscription request, if any */
+            _APP_UDP_METROLOGY_UpdateSubscription();
+
+            /* Requests are served from the UDP RX callback. Send data
+             * updates to the subscriber, if any */
+            if ((pSubscription->active == true) && (currentTime >= pSubscription->nextReportTime))
+            {
+                periodCount = (uint64_t)SYS_TIME_MSToCount(1) * pSubscription->periodMs;
+                pSubscription->nextReportTime += periodCount;
+                if (pSubscription->nextReportTime <= currentTime)
+                {
+                    /* Periods were missed, do not send them in a burst */
+                    pSubscription->nextReportTime = currentTime + periodCount;
+                }
+
+                _APP_UDP_METROLOGY_SendDataUpdate();
+            }
+
+            /* Suspend task until next report or until the subscription changes */
+            if (pSubscription->active == true)
+            {
+                uint32_t waitMs;
+
+                currentTime = SYS_TIME_Counter64Get();
+                if (pSubscription->nextReportTime > currentTime)
+                {
+                    waitMs = (uint32_t)((pSubscription->nextReportTime - currentTime) / SYS_TIME_MSToCount(1)) + 1;
+                    if (waitMs >= OSAL_WAIT_FOREVER)
+                    {
+                        waitMs = OSAL_WAIT_FOREVER - 1;
+                    }
+
+                    OSAL_SEM_Pend(&app_udp_metrologyData.semaphoreID, (uint16_t)waitMs);
+                }
+            }
+            else
+            {
+                OSAL_SEM_Pend(&app_udp_metrologyData.semaphoreID, OSAL_WAIT_FOREVER);
+            }
+
+            break;
+        }
+
         /* Error state */
         case APP_UDP_METROLOGY_STATE_ERROR:
         /* The default state should never be executed. */
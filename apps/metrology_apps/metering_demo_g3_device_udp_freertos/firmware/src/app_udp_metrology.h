@@ -32,6 +32,8 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include "configuration.h"
+#include "system/time/sys_time.h"
+#include "library/tcpip/tcpip.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -51,6 +53,65 @@ extern "C" {
  * (rfc4944, rfc6282) (0xF0B0 - 0xF0BF) */
 #define APP_UDP_METROLOGY_SOCKET_PORT 0xF0B0
 
+/* Local port of the data updates. Updates are sent from their own socket,
+ * bound to this port so that it can be compressed too */
+#define APP_UDP_METROLOGY_UPDATE_PORT 0xF0B1
+
+/* UDP metrology message identifiers (first byte of every message) */
+#define APP_UDP_METROLOGY_MSG_DATA_REQUEST          1
+#define APP_UDP_METROLOGY_MSG_DATA_RESPONSE         2
+#define APP_UDP_METROLOGY_MSG_SUBSCRIBE_REQUEST     3
+#define APP_UDP_METROLOGY_MSG_SUBSCRIBE_RESPONSE    4
+#define APP_UDP_METROLOGY_MSG_UNSUBSCRIBE_REQUEST   5
+#define APP_UDP_METROLOGY_MSG_DATA_UPDATE           6
+#define APP_UDP_METROLOGY_MSG_COMPACT_DATA_REQUEST  7
+#define APP_UDP_METROLOGY_MSG_COMPACT_DATA_RESPONSE 8
+#define APP_UDP_METROLOGY_MSG_WAVEFORM_REQUEST      9
+#define APP_UDP_METROLOGY_MSG_WAVEFORM_RESPONSE     10
+
+/* Number of quantities in APP_UDP_METROLOGY_RESPONSE_DATA (all of them 32-bit) */
+#define APP_UDP_METROLOGY_QUANTITIES_NUM            26
+#define APP_UDP_METROLOGY_QUANTITIES_MASK           ((1UL << APP_UDP_METROLOGY_QUANTITIES_NUM) - 1)
+
+/* Limits of the reporting period of a subscription, in seconds */
+#define APP_UDP_METROLOGY_PERIOD_MIN_S              1
+#define APP_UDP_METROLOGY_PERIOD_MAX_S              3600
+
+/* Number of reporting periods between full updates. Full updates resync the
+ * subscriber after a lost update and act as a heartbeat */
+#define APP_UDP_METROLOGY_FULL_UPDATE_PERIODS       60
+
+/* Data update flags */
+#define APP_UDP_METROLOGY_UPDATE_FLAG_FULL          0x01
+
+/* Max size of a data update: header and 5-byte varint per quantity */
+#define APP_UDP_METROLOGY_UPDATE_MAX_SIZE           (7 + (5 * APP_UDP_METROLOGY_QUANTITIES_NUM))
+
+/* Compact data response: all the quantities of the same integration period
+ * as zigzag varints, instead of 4 bytes per quantity:
+ *   Compact data request: 0x07 | mask (4, optional, all quantities if missing)
+ *   Compact data response: 0x08 | sequence (4) | mask (4) | varint per
+ *                          quantity set in mask
+ * Max size of a compact data response: header and 5-byte varint per quantity */
+#define APP_UDP_METROLOGY_COMPACT_MAX_SIZE          (9 + (5 * APP_UDP_METROLOGY_QUANTITIES_NUM))
+
+/* Waveform capture commands. Compressed windows are read chunk by chunk:
+ *   Waveform request: 0x09 | command (1) | arguments
+ *     Start: channels (1) | source (1) | trigger on sag/swell events (1)
+ *     Stop, Trigger, Get info: no arguments
+ *     Get chunk: chunk index (2)
+ *   Waveform response: 0x0A | command (1) | status (1) | capture id (4) |
+ *                      channels (1) | source (1) | block samples (1) |
+ *                      samples (2) | pre-trigger samples (2) | chunks (2) |
+ *                      lost windows (2) [| chunk index (2) | chunk data] */
+#define APP_UDP_METROLOGY_WAVEFORM_CMD_START        0
+#define APP_UDP_METROLOGY_WAVEFORM_CMD_STOP         1
+#define APP_UDP_METROLOGY_WAVEFORM_CMD_TRIGGER      2
+#define APP_UDP_METROLOGY_WAVEFORM_CMD_GET_INFO     3
+#define APP_UDP_METROLOGY_WAVEFORM_CMD_GET_CHUNK    4
+
+#define APP_UDP_METROLOGY_WAVEFORM_HEADER_SIZE      18
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Type Definitions
@@ -84,6 +145,106 @@ typedef enum
 
 } APP_UDP_METROLOGY_STATES;
 
+// *****************************************************************************
+/* Metrology Subscription
+
+  Summary:
+    Holds the subscription of a head-end to metrology data updates.
+
+  Description:
+    The subscriber registers a set of quantities, a reporting period and a
+    deadband per quantity. Every period, only the quantities whose value
+    changed more than its deadband since the last reported value are sent,
+    encoded as zigzag varint deltas:
+
+      Subscribe request: 0x03 | mask (4) | period in s (2) | deadband (4) per
+                         quantity set in mask (optional, 0 if missing)
+      Subscribe response: 0x04 | result (1): 0 success, 1 invalid request
+      Unsubscribe request: 0x05 (answered with a subscribe response)
+      Data update: 0x06 | sequence (1) | flags (1) | changed mask (4) |
+                   varint per quantity set in changed mask
+
+    Bit n of the masks refers to the n-th field of
+    APP_UDP_METROLOGY_RESPONSE_DATA. Multi-byte fields are little endian.
+    In full updates (APP_UDP_METROLOGY_UPDATE_FLAG_FULL) the varints are the
+    values of all the subscribed quantities instead of deltas.
+
+  Remarks:
+    Only one subscriber is supported. A new subscription replaces it.
+    Data updates are sent from APP_UDP_METROLOGY_UPDATE_PORT.
+ */
+
+typedef struct
+{
+    /* Address of the subscriber */
+    IPV6_ADDR remoteAddress;
+
+    /* Port of the subscriber */
+    UDP_PORT remotePort;
+
+    /* Subscribed quantities */
+    uint32_t quantitiesMask;
+
+    /* Reporting period in milliseconds */
+    uint32_t periodMs;
+
+    /* Deadband of every quantity, in the units of the quantity */
+    uint32_t deadband[APP_UDP_METROLOGY_QUANTITIES_NUM];
+
+    /* Last reported value of every quantity */
+    uint32_t lastValue[APP_UDP_METROLOGY_QUANTITIES_NUM];
+
+    /* Time of the next report (system time counter) */
+    uint64_t nextReportTime;
+
+    /* Number of reporting periods until the next full update */
+    uint16_t fullUpdateCounter;
+
+    /* Sequence number of the data updates */
+    uint8_t sequence;
+
+    /* Flag to indicate whether the subscription is active */
+    bool active;
+
+} APP_UDP_METROLOGY_SUBSCRIPTION;
+
+// *****************************************************************************
+/* Metrology Subscription Request
+
+  Summary:
+    Holds a subscribe or unsubscribe request of a head-end.
+
+  Description:
+    Requests are received in the UDP RX callback, which is called from the
+    TCP/IP stack task. They are handed to the application task, which is the
+    only one that accesses the subscription and the update socket.
+
+  Remarks:
+    Access is protected by the request mutex.
+ */
+
+typedef struct
+{
+    /* Address of the subscriber */
+    IPV6_ADDR remoteAddress;
+
+    /* Port of the subscriber */
+    UDP_PORT remotePort;
+
+    /* Subscribed quantities */
+    uint32_t quantitiesMask;
+
+    /* Reporting period in milliseconds */
+    uint32_t periodMs;
+
+    /* Deadband of every quantity, in the units of the quantity */
+    uint32_t deadband[APP_UDP_METROLOGY_QUANTITIES_NUM];
+
+    /* Flag to indicate subscribe (true) or unsubscribe (false) */
+    bool subscribe;
+
+} APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST;
+
 
 // *****************************************************************************
 /* Application Data
@@ -106,6 +267,24 @@ typedef struct
     /* The application's current state */
     APP_UDP_METROLOGY_STATES state;
 
+    /* UDP server socket */
+    UDP_SOCKET socket;
+
+    /* UDP socket to send data updates */
+    UDP_SOCKET updateSocket;
+
+    /* Subscription to metrology data updates */
+    APP_UDP_METROLOGY_SUBSCRIPTION subscription;
+
+    /* Mutex to protect the subscription request */
+    OSAL_MUTEX_DECLARE(requestMutex);
+
+    /* Last subscription request, pending to be applied */
+    APP_UDP_METROLOGY_SUBSCRIPTION_REQUEST request;
+
+    /* Flag to indicate that there is a request pending to be applied */
+    bool requestPending;
+
 } APP_UDP_METROLOGY_DATA;
 
 // *****************************************************************************
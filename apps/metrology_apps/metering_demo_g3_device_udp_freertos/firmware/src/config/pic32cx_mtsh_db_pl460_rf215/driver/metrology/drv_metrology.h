@@ -172,6 +172,25 @@ typedef void (* DRV_METROLOGY_CALIBRATION_CALLBACK) (bool result);
 */
 typedef void (* DRV_METROLOGY_HARMONICS_CALLBACK) (uint8_t harmonicNum);
 
+// *****************************************************************************
+/* Metrology Harmonics Batch Callback Function Pointer
+
+  Summary:
+    Defines the data type and function signature for the callback function of the
+    batch harmonics analysis.
+
+  Description:
+    The Metrology driver will call back the client's function with this signature
+    once all the harmonics requested in a batch analysis have been completed.
+
+  Parameters:
+    numHarmonics  - The number of harmonics stored in the batch table.
+
+  Remarks:
+    None.
+*/
+typedef void (* DRV_METROLOGY_HARMONICS_BATCH_CALLBACK) (uint8_t numHarmonics);
+
 // *****************************************************************************
 
 // *****************************************************************************
@@ -546,6 +565,45 @@ DRV_METROLOGY_RESULT DRV_METROLOGY_CalibrationCallbackRegister(DRV_METROLOGY_CAL
 */
 DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicAnalysisCallbackRegister(DRV_METROLOGY_HARMONICS_CALLBACK callback);
 
+// *****************************************************************************
+/* Function:
+    DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicBatchCallbackRegister (
+        DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback
+    );
+
+  Summary:
+    Registers a function with the metrology driver to be called back when a batch harmonic analysis has completed.
+
+  Description:
+    This function allows a client to register a handling function with the driver to call back when all the harmonics
+    requested through DRV_METROLOGY_StartHarmonicAnalysisBatch have been analyzed.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    callback - Pointer to the function to be called.
+
+  Returns:
+    If successful, returns DRV_METROLOGY_SUCCESS. Otherwise, it returns DRV_METROLOGY_ERROR.
+
+  Example:
+    <code>
+        static void lAPP_METROLOGY_HarmonicBatchCallback(uint8_t numHarmonics)
+        {
+            app_metrologyData.harmonicAnalysisPending = false;
+        }
+
+        (...)
+
+        DRV_METROLOGY_HarmonicBatchCallbackRegister(lAPP_METROLOGY_HarmonicBatchCallback);
+    </code>
+
+  Remarks:
+    None.
+*/
+DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicBatchCallbackRegister(DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback);
+
 // *****************************************************************************
 /* Function:
     DRV_METROLOGY_STATUS DRV_METROLOGY_GetStatus(void);
@@ -828,14 +886,12 @@ DRV_METROLOGY_REGS_STATUS * DRV_METROLOGY_GetStatusData(void);
 
   Example:
     <code>
-        app_metrologyData.pMetControl = DRV_METROLOGY_GetControlData();
-        app_metrologyData.pMetStatus = DRV_METROLOGY_GetStatusData();
-        app_metrologyData.pMetAccData = DRV_METROLOGY_GetAccData();
-        app_metrologyData.pMetHarData = DRV_METROLOGY_GetHarData();
+        DRV_METROLOGY_REGS_ACCUMULATORS * pAccData = DRV_METROLOGY_GetAccData();
     </code>
 
   Remarks:
-    None.
+    Data is double buffered: the returned buffer is kept stable until the next integration
+    period is processed, so the pointer must be requested every time data is read.
 */
 DRV_METROLOGY_REGS_ACCUMULATORS * DRV_METROLOGY_GetAccData(void);
 
@@ -865,14 +921,12 @@ DRV_METROLOGY_REGS_ACCUMULATORS * DRV_METROLOGY_GetAccData(void);
 
   Example:
     <code>
-        app_metrologyData.pMetControl = DRV_METROLOGY_GetControlData();
-        app_metrologyData.pMetStatus = DRV_METROLOGY_GetStatusData();
-        app_metrologyData.pMetAccData = DRV_METROLOGY_GetAccData();
-        app_metrologyData.pMetHarData = DRV_METROLOGY_GetHarData();
+        DRV_METROLOGY_REGS_HARMONICS * pHarData = DRV_METROLOGY_GetHarData();
     </code>
 
   Remarks:
-    None.
+    Data is double buffered: the returned buffer is kept stable until the next integration
+    period is processed, so the pointer must be requested every time data is read.
 */
 DRV_METROLOGY_REGS_HARMONICS * DRV_METROLOGY_GetHarData(void);
 
@@ -1111,6 +1165,248 @@ void DRV_METROLOGY_SetConfiguration(DRV_METROLOGY_CONFIGURATION * config);
 */
 void DRV_METROLOGY_GetEventsData(DRV_METROLOGY_AFE_EVENTS * events);
 
+// *****************************************************************************
+/* Function:
+    void DRV_METROLOGY_GetIntegrationStats(DRV_METROLOGY_INTEGRATION_STATS * stats);
+
+  Summary:
+    Gets the statistics of the integration periods handoff.
+
+  Description:
+    At the end of each integration period, the IPC interrupt only records the period.
+    The driver task copies accumulators and harmonics data from the shared memory into
+    the ping-pong buffer not exposed to the clients and publishes it if no other period
+    ended during the copy; otherwise it copies the new period. This routine reports
+    the integration periods processed, the ones missed because the driver task was late
+    and the next period overwrote them, and the copies restarted for that reason.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    stats - Pointer to store the integration statistics.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+        DRV_METROLOGY_INTEGRATION_STATS stats;
+
+        DRV_METROLOGY_GetIntegrationStats(&stats);
+    </code>
+
+  Remarks:
+    None.
+*/
+void DRV_METROLOGY_GetIntegrationStats(DRV_METROLOGY_INTEGRATION_STATS * stats);
+
+// *****************************************************************************
+/* Function:
+    bool DRV_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot);
+
+  Summary:
+    Gets all the quantities calculated in the last integration period.
+
+  Description:
+    The snapshot is updated by the driver task once per integration period, so
+    all the values returned belong to the same period. This routine copies the
+    whole snapshot at once, instead of reading and converting every value
+    through DRV_METROLOGY_GetRMSValue and DRV_METROLOGY_GetRMSSign. The driver
+    keeps the snapshots of the last two periods. While the driver task is
+    updating one of them, the other one is copied, so a caller that preempts
+    the driver task gets the snapshot of the previous period.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    snapshot - Pointer to store the snapshot.
+
+  Returns:
+    true if a consistent snapshot has been copied, false if there is no data
+    yet or the caller has been preempted for more than one integration period.
+
+  Example:
+    <code>
+        DRV_METROLOGY_SNAPSHOT snapshot;
+
+        if (DRV_METROLOGY_GetSnapshot(&snapshot) == true)
+        {
+            if (snapshot.sequence != lastSequence)
+            {
+                voltageA = snapshot.RMS[RMS_UA];
+            }
+        }
+    </code>
+
+  Remarks:
+    The sequence number allows to detect new or missed integration periods.
+*/
+bool DRV_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot);
+
+// *****************************************************************************
+/* Function:
+    void DRV_METROLOGY_StartCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source);
+
+  Summary:
+    Starts the continuous waveform capture.
+
+  Description:
+    The metrology library stores the samples of the selected channels in the
+    capture buffer in circular-buffer fashion, until the capture is stopped.
+    Samples are interleaved: one 32-bit word per selected channel every sample
+    time, in the order of the DRV_METROLOGY_CAPTURE_CH_xx bits.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    channels - Bitmap of DRV_METROLOGY_CAPTURE_CH_xx channels to capture.
+    source   - Data to capture.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+        DRV_METROLOGY_StartCapture(DRV_METROLOGY_CAPTURE_CH_IA | DRV_METROLOGY_CAPTURE_CH_VA,
+                CAPTURE_SOURCE_4KHZ_FBW);
+    </code>
+
+  Remarks:
+    The capture settings are overwritten by the CAPTURE_CTRL register of the
+    metrology configuration when the metrology library is reloaded.
+*/
+void DRV_METROLOGY_StartCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source);
+
+// *****************************************************************************
+/* Function:
+    void DRV_METROLOGY_StopCapture(void);
+
+  Summary:
+    Stops the waveform capture.
+
+  Description:
+    The data in the capture buffer is kept until the capture is started again.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+        DRV_METROLOGY_StopCapture();
+    </code>
+
+  Remarks:
+    None.
+*/
+void DRV_METROLOGY_StopCapture(void);
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_METROLOGY_GetCaptureOffset(bool * wrapped);
+
+  Summary:
+    Gets the position of the capture buffer where the next sample is written.
+
+  Description:
+    The offset is given in 32-bit words from the beginning of the capture buffer.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    wrapped - Pointer to store whether the capture buffer has been filled at
+              least once. It can be NULL.
+
+  Returns:
+    Offset of the next sample in the capture buffer.
+
+  Example:
+    <code>
+        bool wrapped;
+        uint32_t offset = DRV_METROLOGY_GetCaptureOffset(&wrapped);
+    </code>
+
+  Remarks:
+    None.
+*/
+uint32_t DRV_METROLOGY_GetCaptureOffset(bool * wrapped);
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_METROLOGY_GetCaptureBufferSize(void);
+
+  Summary:
+    Gets the size of the capture buffer in 32-bit words.
+
+  Description:
+    None.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    Size of the capture buffer in 32-bit words.
+
+  Example:
+    <code>
+        uint32_t size = DRV_METROLOGY_GetCaptureBufferSize();
+    </code>
+
+  Remarks:
+    None.
+*/
+uint32_t DRV_METROLOGY_GetCaptureBufferSize(void);
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_METROLOGY_GetCaptureData(uint32_t offset, uint32_t * pData, uint32_t numWords);
+
+  Summary:
+    Copies data from the capture buffer.
+
+  Description:
+    The capture buffer is read as a circular buffer: the copy continues from
+    the beginning of the buffer when the end is reached. The capture does not
+    need to be stopped, so the caller must read the data before the metrology
+    library overwrites it.
+
+  Precondition:
+    DRV_METROLOGY_Initialize routine must have been called before.
+
+  Parameters:
+    offset   - Offset in 32-bit words of the first word to copy.
+    pData    - Pointer to store the data.
+    numWords - Number of 32-bit words to copy.
+
+  Returns:
+    Number of 32-bit words copied.
+
+  Example:
+    <code>
+        uint32_t samples[64];
+        uint32_t offset = DRV_METROLOGY_GetCaptureOffset(NULL);
+
+        offset += DRV_METROLOGY_GetCaptureBufferSize() - 64;
+        DRV_METROLOGY_GetCaptureData(offset, samples, 64);
+    </code>
+
+  Remarks:
+    None.
+*/
+uint32_t DRV_METROLOGY_GetCaptureData(uint32_t offset, uint32_t * pData, uint32_t numWords);
+
 // *****************************************************************************
 /* Function:
     DRV_METROLOGY_CALIBRATION_REFS * DRV_METROLOGY_GetCalibrationReferences (void);
@@ -1237,6 +1533,54 @@ void DRV_METROLOGY_StartCalibration(void);
 */
 void DRV_METROLOGY_StartHarmonicAnalysis(uint8_t harmonicNum, DRV_METROLOGY_HARMONICS_RMS *pHarmonicResponse);
 
+// *****************************************************************************
+/* Function:
+    DRV_METROLOGY_RESULT DRV_METROLOGY_StartHarmonicAnalysisBatch(
+        uint64_t harmonicBitmap,
+        DRV_METROLOGY_HARMONICS_RMS *pHarmonicTable,
+        uint8_t tableSize,
+        DRV_METROLOGY_HARMONICS_THD *pThd
+    );
+
+  Summary:
+    Starts the harmonic analysis of a set of harmonic orders.
+
+  Description:
+    This routine requests the analysis of all the harmonic orders included in the
+    bitmap (bit m set means harmonic m is analyzed), one after the other, without
+    intervention of the client. Results are stored in the table in increasing
+    harmonic order. When all of them have been analyzed, the THD of every channel
+    is computed (only if the fundamental harmonic is included in the bitmap) and
+    the batch callback is called once.
+
+  Precondition:
+    None.
+
+  Parameters:
+    harmonicBitmap - Bitmap of harmonic orders, from 1 to DRV_METROLOGY_HARMONIC_ORDER_MAX.
+                     Use DRV_METROLOGY_HARMONICS_RANGE to build a range of orders.
+    pHarmonicTable - Pointer to the preallocated table to store the harmonic data results.
+    tableSize - Number of entries of the table. It must be equal or greater than the number of bits set in the bitmap.
+    pThd - Pointer to store the THD values. It can be NULL if THD is not needed.
+
+  Returns:
+    If the batch analysis is started, returns DRV_METROLOGY_SUCCESS. Otherwise, it returns DRV_METROLOGY_ERROR.
+
+  Example:
+    <code>
+        static DRV_METROLOGY_HARMONICS_RMS harmonicTable[31];
+        static DRV_METROLOGY_HARMONICS_THD harmonicThd;
+
+        DRV_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1, 31),
+                harmonicTable, 31, &harmonicThd);
+    </code>
+
+  Remarks:
+    Each harmonic order requires the same integration periods as a single harmonic analysis.
+*/
+DRV_METROLOGY_RESULT DRV_METROLOGY_StartHarmonicAnalysisBatch(uint64_t harmonicBitmap,
+        DRV_METROLOGY_HARMONICS_RMS *pHarmonicTable, uint8_t tableSize, DRV_METROLOGY_HARMONICS_THD *pThd);
+
 #ifdef __cplusplus
  }
 #endif
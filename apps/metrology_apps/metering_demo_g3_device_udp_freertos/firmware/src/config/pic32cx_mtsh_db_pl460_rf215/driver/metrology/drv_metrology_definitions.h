@@ -81,6 +81,9 @@ extern uint8_t met_bin_end;
 #define DRV_METROLOGY_IPC_INIT_IRQ_MSK            IPC_ISR_IRQ20_Msk
 #define DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK     IPC_ISR_IRQ0_Msk
 
+/* Copies of the shared memory tried before giving up an integration period */
+#define DRV_METROLOGY_COPY_ATTEMPTS               3U
+
 #define  FREQ_Q         12U
 #define  GAIN_P_K_T_Q   24U
 #define  GAIN_VI_Q      10U
@@ -95,6 +98,18 @@ extern uint8_t met_bin_end;
 #define  RMS_HARMONIC   0x80000000UL
 #define  CONST_Pi       3.1415926
 
+/* Fixed point computation engine (DRV_METROLOGY_FIXED_POINT_CALC = 1).
+   Maximum error against the double precision engine, in output LSBs:
+   - U/I RMS (0.0001 V/A):        +/-1
+   - P/Q/S RMS (0.1 W/VAr/VA):    +/-1
+   - Angle (0.00001 degrees):     +/-1
+   - Energy (0.0001 kWh/kVArh):   +/-1 per integration period
+   Intermediate values are kept in 64 bits: accumulators times K_I/K_V gains
+   must not exceed 2^84, which is far above the metrology library range. */
+#define  DRV_METROLOGY_FX_PQ_FRAC             8U
+#define  DRV_METROLOGY_FX_CORDIC_ITERATIONS   24U
+#define  DRV_METROLOGY_FX_ANGLE_180           4608000000LL  /* 180 degrees * 10^5 in Q8 */
+
 /* Metrology Driver Sensor Type
 
   Summary:
@@ -225,6 +240,34 @@ typedef struct {
     double Vrms_C_m;
 } DRV_METROLOGY_HARMONICS_RMS;
 
+/* Metrology Driver Total Harmonic Distortion
+
+  Summary:
+    Identifies the result of the THD computation of a batch harmonic analysis.
+
+  Description:
+    - Ithd_X. Total harmonic distortion (%) of the current regarding channel X.
+    - Ithd_N. Total harmonic distortion (%) of the current regarding neutral channel.
+    - Vthd_X. Total harmonic distortion (%) of the voltage regarding channel X.
+    THD is computed as sqrt(sum(RMS_m^2)) / RMS_1 * 100, for all the analyzed harmonics m > 1.
+*/
+typedef struct {
+    double Ithd_A;
+    double Ithd_B;
+    double Ithd_C;
+    double Ithd_N;
+    double Vthd_A;
+    double Vthd_B;
+    double Vthd_C;
+} DRV_METROLOGY_HARMONICS_THD;
+
+/* Maximum harmonic order that can be requested to the metrology library */
+#define DRV_METROLOGY_HARMONIC_ORDER_MAX          63U
+
+/* Build a harmonic bitmap including all orders from first to last (both included) */
+#define DRV_METROLOGY_HARMONICS_RANGE(first, last)  \
+    ((((uint64_t)2U << (last)) - 1U) & ~(((uint64_t)1U << (first)) - 1U))
+
 /* Metrology Harmonic Analysis Data
 
   Summary:
@@ -235,12 +278,26 @@ typedef struct {
     - harmonicNum: Store the harmonic number to be analyzed.
     - integrationPeriods: Indicate the number of integration periods that must be waited until get the response
     - running: Flag to indicate that harmonic analysis is in process.
+    - batchPending: Bitmap of harmonic orders pending to be analyzed in batch mode.
+    - pBatchTable: Pointer to the table to store the results of the batch analysis.
+    - batchCount: Number of harmonics already stored in the batch table.
+    - pBatchThd: Pointer to store the THD values computed at the end of the batch analysis.
+    - batchSquareSum: Sum of the square RMS values of harmonics m > 1, per channel.
+    - batchFundamental: Index of the fundamental harmonic in the batch table, if requested.
+    - batch: Flag to indicate that the current analysis belongs to a batch.
 */
 typedef struct {
     DRV_METROLOGY_HARMONICS_RMS * pHarmonicAnalysisResponse;
     uint8_t harmonicNum;
     uint8_t integrationPeriods;
     bool  running;
+    uint64_t batchPending;
+    DRV_METROLOGY_HARMONICS_RMS * pBatchTable;
+    uint8_t batchCount;
+    DRV_METROLOGY_HARMONICS_THD * pBatchThd;
+    DRV_METROLOGY_HARMONICS_RMS batchSquareSum;
+    int8_t batchFundamental;
+    bool  batch;
 } DRV_METROLOGY_HARMONIC_ANALYSIS;
 
 /* Metrology Driver AFE Events
@@ -318,6 +375,22 @@ typedef enum {
     RMS_TYPE_NUM
 } DRV_METROLOGY_RMS_TYPE;
 
+/* Metrology Driver Integration Statistics
+
+  Summary:
+    Identifies the statistics of the integration periods handoff between the IPC interrupt and the driver task.
+
+  Description:
+    - processedCount. Number of integration periods processed by the driver task.
+    - missedCount. Number of integration periods overwritten by the next one before being processed.
+    - tornCount. Number of copies of the shared memory restarted because the next integration period ended during the copy.
+*/
+typedef struct {
+    uint32_t processedCount;
+    uint32_t missedCount;
+    uint32_t tornCount;
+} DRV_METROLOGY_INTEGRATION_STATS;
+
 /* Metrology Driver AFE calculated data
 
   Summary:
@@ -334,6 +407,58 @@ typedef struct {
     uint32_t RMS[RMS_TYPE_NUM];
 } DRV_METROLOGY_AFE_DATA;
 
+/* Metrology Driver Snapshot
+
+  Summary:
+    Identifies all the quantities calculated in the same integration period.
+
+  Description:
+    - sequence. Sequence number of the integration period. It is incremented every time the snapshot is updated.
+    - energy. Active energy calculated in the integration period.
+    - afeEvents. AFE events data.
+    - RMS[RMS_TYPE_NUM]. RMS calculated values with sign applied. Angles are in the range -180 to 180 degrees.
+*/
+typedef struct {
+    uint32_t sequence;
+    uint32_t energy;
+    DRV_METROLOGY_AFE_EVENTS afeEvents;
+    int32_t RMS[RMS_TYPE_NUM];
+} DRV_METROLOGY_SNAPSHOT;
+
+/* Metrology Driver Waveform Capture Source
+
+  Summary:
+    Identifies the data stored in the waveform capture buffer.
+
+  Description:
+    - CAPTURE_SOURCE_16KHZ. 16 kHz data [sQ1.30] before DSP filtering.
+    - CAPTURE_SOURCE_4KHZ_FBW. 4 kHz full bandwidth data [sQ2.29] (fundamental + harmonics).
+    - CAPTURE_SOURCE_4KHZ_NBW. 4 kHz narrow bandwidth data [sQ2.29] (fundamental only).
+*/
+typedef enum {
+    CAPTURE_SOURCE_16KHZ = 0,
+    CAPTURE_SOURCE_4KHZ_FBW,
+    CAPTURE_SOURCE_4KHZ_NBW,
+    CAPTURE_SOURCE_NUM
+} DRV_METROLOGY_CAPTURE_SOURCE;
+
+/* Metrology Driver Waveform Capture Channels
+
+  Summary:
+    Bitmap of the channels stored in the waveform capture buffer.
+
+  Description:
+    Every sample time, one 32-bit word per selected channel is stored in the
+    buffer, in the order of the bits of this bitmap.
+*/
+#define DRV_METROLOGY_CAPTURE_CH_IA         0x01U
+#define DRV_METROLOGY_CAPTURE_CH_VA         0x02U
+#define DRV_METROLOGY_CAPTURE_CH_IB         0x04U
+#define DRV_METROLOGY_CAPTURE_CH_VB         0x08U
+#define DRV_METROLOGY_CAPTURE_CH_IC         0x10U
+#define DRV_METROLOGY_CAPTURE_CH_VC         0x20U
+#define DRV_METROLOGY_CAPTURE_CH_MASK       0x3FU
+
 /* Metrology Driver Configuration
 
   Summary:
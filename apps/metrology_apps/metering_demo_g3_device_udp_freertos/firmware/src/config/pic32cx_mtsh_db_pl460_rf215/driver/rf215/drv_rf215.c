@@ -183,14 +183,22 @@ static void lDRV_RF215_ReadPNVN(uintptr_t context, void* pData, uint64_t timeRea
     /* Disable clock output by default (not used) */
     RF215_HAL_SpiWrite(RF215_RF_CLKO, (void *) &rf215RegValues.RF_CLKO, 1);
 
+#if (DRV_RF215_NUM_TRX == 1U)
     /* RF24 TRX disabled: Switch it to sleep state to save power */
     RF215_HAL_SpiWrite(RF215_ADDR_RF24_CMD, (void *) &rf215RegValues.RFn_CMD.sleep, 1);
 
+#endif
     /* MISRA C-2012 deviation block end */
 
     /* RF09 TRX reset event */
     RF215_PHY_ExtIntEvent(RF215_TRX_RF09_IDX, RF215_RFn_IRQ_WAKEUP, 0);
 
+#if (DRV_RF215_NUM_TRX == 2U)
+    /* RF24 TRX reset event */
+    RF215_PHY_ExtIntEvent(RF215_TRX_RF24_IDX, RF215_RFn_IRQ_WAKEUP, 0);
+
+#endif
+
     /* RF215 Chip Reset handled correctly. The driver is ready */
     dObj->rfChipResetFlag = true;
 }
@@ -202,6 +210,11 @@ static void lDRV_RF215_ReadIRQS(uintptr_t context, void* pData, uint64_t timeRea
     uint8_t rf09IRQS = pFlags[0];
     uint8_t rf24IRQS = pFlags[1];
     uint8_t bbc0IRQS = pFlags[2];
+#if (DRV_RF215_NUM_TRX == 2U)
+    uint8_t bbc1IRQS = pFlags[3];
+#else
+    uint8_t bbc1IRQS = 0U;
+#endif
 
     /* Check if object is not initialized or in error state */
     if (dObj->sysStatus <= SYS_STATUS_UNINITIALIZED)
@@ -213,7 +226,7 @@ static void lDRV_RF215_ReadIRQS(uintptr_t context, void* pData, uint64_t timeRea
     {
         /* First interrupt after initialization: Chip Reset / Power-On-Reset
          * should be indicated */
-        if (((rf09IRQS & rf24IRQS) != RF215_RFn_IRQ_WAKEUP) || (bbc0IRQS != 0U))
+        if (((rf09IRQS & rf24IRQS) != RF215_RFn_IRQ_WAKEUP) || ((bbc0IRQS | bbc1IRQS) != 0U))
 
         {
             RF215_HAL_Deinitialize();
@@ -233,7 +246,7 @@ static void lDRV_RF215_ReadIRQS(uintptr_t context, void* pData, uint64_t timeRea
         (void) OSAL_SEM_PostISR(&dObj->semaphoreID);
         return;
     }
-    else if ((rf09IRQS | rf24IRQS | bbc0IRQS) == 0U)
+    else if ((rf09IRQS | rf24IRQS | bbc0IRQS | bbc1IRQS) == 0U)
     {
         /* Count consecutive times reading RF215 flags as empty */
         if (dObj->irqsEmptyCount == 3U)
@@ -263,6 +276,11 @@ static void lDRV_RF215_ReadIRQS(uintptr_t context, void* pData, uint64_t timeRea
 
     /* RF09 interrupts */
     RF215_PHY_ExtIntEvent(RF215_TRX_RF09_IDX, rf09IRQS, bbc0IRQS);
+
+#if (DRV_RF215_NUM_TRX == 2U)
+    /* RF24 interrupts */
+    RF215_PHY_ExtIntEvent(RF215_TRX_RF24_IDX, rf24IRQS, bbc1IRQS);
+#endif
 }
 
 // *****************************************************************************
@@ -282,8 +300,13 @@ void DRV_RF215_ExtIntHandler(void)
         return;
     }
 
+#if (DRV_RF215_NUM_TRX == 2U)
+    /* Read IRQ Status registers (RF09_IRQS, RF24_IRQS, BBC0_IRQS, BBC1_IRQS) */
+    RF215_HAL_SpiRead(RF215_RF09_IRQS, pFlags, 4, lDRV_RF215_ReadIRQS, context);
+#else
     /* Read IRQ Status registers (RF09_IRQS, RF24_IRQS, BBC0_IRQS) */
     RF215_HAL_SpiRead(RF215_RF09_IRQS, pFlags, 3, lDRV_RF215_ReadIRQS, context);
+#endif
 }
 
 void DRV_RF215_NotifyRxInd(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* ind)
@@ -399,6 +422,18 @@ SYS_MODULE_OBJ DRV_RF215_Initialize (
         return SYS_MODULE_OBJ_INVALID;
     }
 
+#if (DRV_RF215_NUM_TRX == 2U)
+    /* Initialize RF215 PHY (2.4GHz transceiver) */
+    bandOpMode = rfPhyInit->rf24PhyBandOpmIni;
+    channelNum = rfPhyInit->rf24PhyChnNumIni;
+    if (RF215_PHY_Initialize(RF215_TRX_RF24_IDX, bandOpMode, channelNum) == false)
+    {
+        /* Invalid PHY configuration (2.4GHz transceiver) */
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+#endif
+
     /* Initialize Hardware Abstraction Layer */
     RF215_HAL_Initialize(rfPhyInit);
 
@@ -558,6 +593,9 @@ void DRV_RF215_Tasks( SYS_MODULE_OBJ object )
 
             /* PHY tasks */
             RF215_PHY_Tasks(RF215_TRX_RF09_IDX);
+#if (DRV_RF215_NUM_TRX == 2U)
+            RF215_PHY_Tasks(RF215_TRX_RF24_IDX);
+#endif
             break;
         }
 
@@ -614,7 +652,15 @@ DRV_HANDLE DRV_RF215_Open (
     uint8_t trxIdx = RF215_TRX_RF09_IDX;
 
     /* Validate the transceiver identifier */
+#if (DRV_RF215_NUM_TRX == 2U)
+    if (trxID == RF215_TRX_ID_RF24)
+    {
+        trxIdx = RF215_TRX_RF24_IDX;
+    }
+    else if (trxID != RF215_TRX_ID_RF09)
+#else
     if (trxID != RF215_TRX_ID_RF09)
+#endif
     {
         /* Invalid transceiver */
         return DRV_HANDLE_INVALID;
@@ -845,6 +891,10 @@ uint8_t DRV_RF215_GetPibSize(DRV_RF215_PIB_ATTRIBUTE attr)
             len = (uint8_t) sizeof(DRV_RF215_PHY_BAND_OPM);
             break;
 
+        case RF215_PIB_PHY_CHANNEL_OCCUPANCY:
+            len = (uint8_t) sizeof(DRV_RF215_CHN_OCCUPANCY_OBJ);
+            break;
+
         default:
             len = 0U;
             break;
@@ -943,6 +993,7 @@ DRV_RF215_PIB_RESULT DRV_RF215_SetPib (
         case RF215_PIB_PHY_RX_OVERRIDE:
         case RF215_PIB_PHY_RX_IND_NOT_HANDLED:
         case RF215_PIB_MAC_UNIT_BACKOFF_PERIOD:
+        case RF215_PIB_PHY_CHANNEL_OCCUPANCY:
             result = RF215_PIB_RESULT_READ_ONLY;
             break;
 
@@ -964,3 +1015,20 @@ DRV_RF215_PIB_RESULT DRV_RF215_SetPib (
 
     return result;
 }
+
+DRV_RF215_PIB_RESULT DRV_RF215_PhyProfileLoad (
+    DRV_HANDLE drvHandle,
+    DRV_RF215_PHY_BAND_OPM bandOpMode,
+    uint16_t channelNum
+)
+{
+    DRV_RF215_CLIENT_OBJ* clientObj;
+
+    clientObj = lDRV_RF215_DrvHandleValidate(drvHandle);
+    if (clientObj == NULL)
+    {
+        return RF215_PIB_RESULT_INVALID_HANDLE;
+    }
+
+    return RF215_PHY_ProfileLoad(clientObj->trxIndex, bandOpMode, channelNum);
+}
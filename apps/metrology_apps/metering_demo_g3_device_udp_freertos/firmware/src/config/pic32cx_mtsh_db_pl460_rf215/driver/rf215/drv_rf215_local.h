@@ -96,6 +96,9 @@ typedef struct
     uint8_t                         RF09_IRQS;
     uint8_t                         RF24_IRQS;
     uint8_t                         BBC0_IRQS;
+#if (DRV_RF215_NUM_TRX == 2U)
+    uint8_t                         BBC1_IRQS;
+#endif
 
     /* RF215 Part and version number registers */
     uint8_t                         RF_PN;
@@ -298,6 +301,9 @@ void DRV_RF215_ResumeTask(void);
 */
 
 #define RF215_TRX_RF09_IDX                         0U
+#if (DRV_RF215_NUM_TRX == 2U)
+#define RF215_TRX_RF24_IDX                         1U
+#endif
 
 // *****************************************************************************
 /* RF215 Register Base Addresses
@@ -347,7 +353,11 @@ void DRV_RF215_ResumeTask(void);
 #define RF215_RF_VN                                0x000EU
 
 /* Sub-1GHz/2.4GHz radio registers (RFn_), depending on TRX index */
+#if (DRV_RF215_NUM_TRX == 2U)
+#define RF215_ADDR_RFn(offset, trxIdx)             (RF215_BASE_ADDR_RF09 + (offset) + ((uint16_t)(trxIdx) << 8))
+#else
 #define RF215_ADDR_RFn(offset, trxIdx)             (RF215_BASE_ADDR_RF09 + (offset))
+#endif
 #define RF215_RFn_IRQM(trxIdx)                     RF215_ADDR_RFn(0x00U, (trxIdx))
 #define RF215_RFn_AUXS(trxIdx)                     RF215_ADDR_RFn(0x01U, (trxIdx))
 #define RF215_RFn_STATE(trxIdx)                    RF215_ADDR_RFn(0x02U, (trxIdx))
@@ -380,7 +390,11 @@ void DRV_RF215_ResumeTask(void);
 #define RF215_RFn_TXDACQ(trxIdx)                   RF215_ADDR_RFn(0x28U, (trxIdx))
 
 /* Baseband processor Core0/Core1 registers (BBCn_), depending on TRX index */
+#if (DRV_RF215_NUM_TRX == 2U)
+#define RF215_ADDR_BBCn(offset, trxIdx)            (RF215_BASE_ADDR_BBC0 + (offset) + ((uint16_t)(trxIdx) << 8))
+#else
 #define RF215_ADDR_BBCn(offset, trxIdx)            (RF215_BASE_ADDR_BBC0 + (offset))
+#endif
 #define RF215_BBCn_IRQM(trxIdx)                    RF215_ADDR_BBCn(0x00U, (trxIdx))
 #define RF215_BBCn_PC(trxIdx)                      RF215_ADDR_BBCn(0x01U, (trxIdx))
 #define RF215_BBCn_PS(trxIdx)                      RF215_ADDR_BBCn(0x02U, (trxIdx))
@@ -469,7 +483,11 @@ void DRV_RF215_ResumeTask(void);
 #define RF215_BBCn_CNT3(trxIdx)                    RF215_ADDR_BBCn(0x94U, (trxIdx))
 
 /** Baseband Core0/Core1 frame buffer registers (BBCn_), depending on TRX index */
+#if (DRV_RF215_NUM_TRX == 2U)
+#define RF215_ADDR_FRAME_BUF_BBCn(offset, trxIdx)  (RF215_BASE_ADDR_FRAME_BUF_BBC0 + (offset) + ((uint16_t)(trxIdx) << 12))
+#else
 #define RF215_ADDR_FRAME_BUF_BBCn(offset, trxIdx)  (RF215_BASE_ADDR_FRAME_BUF_BBC0 + (offset))
+#endif
 #define RF215_BBCn_FBRXS(trxIdx)                   RF215_ADDR_FRAME_BUF_BBCn(0x000U, (trxIdx))
 #define RF215_BBCn_FBRXE(trxIdx)                   RF215_ADDR_FRAME_BUF_BBCn(0x7FEU, (trxIdx))
 #define RF215_BBCn_FBTXS(trxIdx)                   RF215_ADDR_FRAME_BUF_BBCn(0x800U, (trxIdx))
@@ -77,6 +77,13 @@ Microchip or any third party.
    cycles of 32MHz, which is the frequency of RF215 counter) */
 #define RF215_SPI_BYTE_DURATION_US_Q5 28U
 
+/* SPI transfer statistics: Number of accesses, coalesced SPI bursts and
+ * latency from enqueue to callback. Disabled by default because it reads the
+ * SYS_TIME counter for every queued access */
+#ifndef DRV_RF215_SPI_STATS_ENABLE
+#define DRV_RF215_SPI_STATS_ENABLE    0U
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
@@ -114,19 +121,69 @@ typedef enum
     Object used to keep any data required for a SPI transfer.
 */
 
-typedef struct RF215_SPI_TRANSFER_OBJ_tag
+typedef struct
 {
-    struct RF215_SPI_TRANSFER_OBJ_tag* next;
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    uint64_t                           timeQueued;
+#endif
     void*                              pData;
     RF215_SPI_TRANSFER_CALLBACK        callback;
     uintptr_t                          context;
     size_t                             size;
+    /* Only valid in first transfer of a burst: Number of data bytes and
+     * number of queued transfers coalesced in the same SPI transfer */
+    size_t                             burstSize;
+    uint8_t                            burstNum;
     RF215_SPI_TRANSFER_MODE            mode;
     uint16_t                           regAddr;
-    bool                               inUse;
     bool                               fromTasks;
 } RF215_SPI_TRANSFER_OBJ;
 
+// *****************************************************************************
+/* RF215 Driver HAL SPI Statistics
+
+  Summary:
+    SPI transfer statistics of the RF215 driver HAL.
+
+  Remarks:
+    Latencies are in SYS_TIME counts, from the moment the access is queued
+    until its callback is called.
+*/
+
+typedef struct
+{
+    /* Number of SPI accesses (register blocks) requested */
+    uint32_t                        accesses;
+
+    /* Number of SPI transfers launched */
+    uint32_t                        bursts;
+
+    /* Number of SPI accesses coalesced in a previously queued SPI transfer */
+    uint32_t                        coalesced;
+
+    /* Number of SPI accesses discarded because the queue was full */
+    uint32_t                        dropped;
+
+    /* Maximum latency */
+    uint32_t                        latencyMax;
+
+    /* Accumulated latency of all accesses */
+    uint64_t                        latencySum;
+
+    /* Number of SPI accesses inserted ahead of queued frame buffer writes of
+     * the other transceiver */
+    uint32_t                        bypassed;
+
+    /* Number of SPI accesses and maximum latency of each transceiver (common
+     * registers not included) */
+    uint32_t                        trxAccesses[DRV_RF215_NUM_TRX];
+    uint32_t                        trxLatencyMax[DRV_RF215_NUM_TRX];
+
+    /* Maximum number of SPI accesses in the queue */
+    uint8_t                         queueNumMax;
+
+} RF215_HAL_SPI_STATS;
+
 // *****************************************************************************
 /* RF215 Driver HAL Instance Object
 
@@ -140,11 +197,13 @@ typedef struct
     /* SYS_TIME counter captured when SPI transfer is launched */
     uint64_t                        sysTimeTransfer;
 
-    /* Pointer to first element of SPI transfer queue */
-    RF215_SPI_TRANSFER_OBJ*         spiQueueFirst;
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    /* SPI transfer statistics */
+    RF215_HAL_SPI_STATS             spiStats;
 
-    /* Pointer to last element of SPI transfer queue */
-    RF215_SPI_TRANSFER_OBJ*         spiQueueLast;
+#endif
+    /* Number of bytes (including commands) of SPI transfers in the queue */
+    size_t                          spiQueueBytes;
 
     /* Pointer to SPI PLIB is busy funcition */
     DRV_RF215_PLIB_SPI_IS_BUSY      spiPlibIsBusy;
@@ -176,6 +235,18 @@ typedef struct
     /* SPI transfer from tasks flag */
     bool                            spiTransferFromTasks;
 
+    /* Index of first element (transfer in progress) of SPI transfer queue */
+    uint8_t                         spiQueueHead;
+
+    /* Number of elements in SPI transfer queue */
+    uint8_t                         spiQueueNum;
+
+    /* Number of elements removed from SPI transfer queue pending callback */
+    uint8_t                         spiQueueRelease;
+
+    /* Index of first element of last SPI transfer (burst) in the queue */
+    uint8_t                         spiQueueLastBurst;
+
     /* External interrupt disable counter */
     uint8_t                         extIntDisableCount;
 
@@ -240,6 +311,11 @@ void RF215_HAL_SpiWriteUpdate (
 
 size_t RF215_HAL_GetSpiQueueSize(void);
 
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+void RF215_HAL_GetSpiStats(RF215_HAL_SPI_STATS* stats, bool reset);
+
+#endif
+
 void RF215_HAL_LedRx(bool on);
 
 void RF215_HAL_LedTx(bool on);
@@ -54,12 +54,33 @@ typedef struct
 {
     IPV6_ADDR SourceAddress;
     IPV6_ADDR DestAddress;
-    unsigned long PacketLength;
+    uint32_t PacketLength;
     unsigned short zero1;
     unsigned char zero2;
     unsigned char NextHeader;
 } IPV6_PSEUDO_HEADER;
 
+// Number of per interface TX header templates.
+// A template keeps, for a destination address and upper layer protocol,
+// the selected source address and the pseudo header checksum of the fixed fields.
+// A value of 0 disables the templates.
+#if !defined(TCPIP_IPV6_TX_TEMPLATE_ENTRIES)
+#define TCPIP_IPV6_TX_TEMPLATE_ENTRIES      0
+#endif
+
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+// TX header template
+typedef struct
+{
+    IPV6_ADDR       destAddress;        // key: destination address
+    IPV6_ADDR       sourceAddress;      // selected source address
+    uint16_t        pseudoSum;          // one's complement sum of the pseudo header, 0 length
+    uint8_t         nextHeader;         // key: upper layer protocol
+    uint8_t         addGen;             // unicast address list generation the template is valid for
+    uint8_t         inUse;              // valid template
+}IPV6_TX_TEMPLATE;
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+
 typedef struct
 {
     IPV6_HEAP_NDP_DR_ENTRY * currentDefaultRouter;
@@ -85,7 +106,11 @@ typedef struct
     uint32_t        rxfragmentBufSize;  // RX fragmented buffer size
     uint32_t        fragmentPktRxTimeout;  // fragmented packet timeout value
     uint16_t        g3PanId;                  // PAN_Id for a G3 network
-    uint16_t        pad16;
+    uint8_t         addGen;                   // incremented when the unicast address list changes
+    uint8_t         pad8;
+#if (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
+    IPV6_TX_TEMPLATE txTemplate[TCPIP_IPV6_TX_TEMPLATE_ENTRIES];  // TX header templates
+#endif  // (TCPIP_IPV6_TX_TEMPLATE_ENTRIES != 0)
 } IPV6_INTERFACE_CONFIG;
 
 // stack private API
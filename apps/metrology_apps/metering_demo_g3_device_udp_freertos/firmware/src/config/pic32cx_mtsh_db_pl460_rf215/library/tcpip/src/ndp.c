@@ -85,6 +85,16 @@ static bool     gSetInitialDelay = false;
 static const void*      ndpMemH = 0;        // memory handle
 static int              ndpInitCount = 0;
 static int              nStackIfs = 0;      // max number of interfaces
+
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+static NDP_CACHE_INDEX* gNdpCacheIndex = 0; // per interface NC/DC hash index
+
+static OA_HASH_DCPT*    _NDP_CacheHashCreate(size_t hEntries, uint8_t type);
+static OA_HASH_DCPT*    _NDP_CacheHashGet(TCPIP_NET_IF * pNetIf, uint8_t type, uint8_t** ppPartial);
+static void             _NDP_CacheIndexInsert(TCPIP_NET_IF * pNetIf, void * entry, uint8_t type);
+static void             _NDP_CacheIndexRemove(TCPIP_NET_IF * pNetIf, void * entry, uint8_t type, size_t nNodes);
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+
 enum
 {
     RS_STATE_INACTIVE = 0,
@@ -168,6 +178,18 @@ bool TCPIP_NDP_Initialize (const TCPIP_STACK_MODULE_CTRL* const stackCtrl,
             return false;
         }
 
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+        gNdpCacheIndex = (NDP_CACHE_INDEX*)TCPIP_HEAP_Calloc(ndpMemH, stackCtrl->nIfs, sizeof(*gNdpCacheIndex));
+        if(gNdpCacheIndex != 0)
+        {   // index is optional; on failure the lists are searched linearly
+            for (i = 0; i < nStackIfs; i++)
+            {
+                gNdpCacheIndex[i].ncHash = _NDP_CacheHashCreate(TCPIP_IPV6_NDP_NC_HASH_ENTRIES, IPV6_HEAP_NDP_NC_ID);
+                gNdpCacheIndex[i].dcHash = _NDP_CacheHashCreate(TCPIP_IPV6_NDP_DC_HASH_ENTRIES, IPV6_HEAP_NDP_DC_ID);
+            }
+        }
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+
         for (i = 0; i < DUPLICATE_ADDR_DISCOVERY_THREADS; i++)
         {
             gDuplicateAddrDetectState[i].state = DAD_STATE_INACTIVE;
@@ -224,6 +246,25 @@ void TCPIP_NDP_Deinitialize(const TCPIP_STACK_MODULE_CTRL* const stackCtrl)
                 _TCPIP_NDP_Cleanup();
                 TCPIP_HEAP_Free(ndpMemH, gRSState);
                 gRSState = 0;
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+                if(gNdpCacheIndex != 0)
+                {
+                    int ix;
+                    for (ix = 0; ix < nStackIfs; ix++)
+                    {
+                        if(gNdpCacheIndex[ix].ncHash != 0)
+                        {
+                            TCPIP_HEAP_Free(ndpMemH, gNdpCacheIndex[ix].ncHash);
+                        }
+                        if(gNdpCacheIndex[ix].dcHash != 0)
+                        {
+                            TCPIP_HEAP_Free(ndpMemH, gNdpCacheIndex[ix].dcHash);
+                        }
+                    }
+                    TCPIP_HEAP_Free(ndpMemH, gNdpCacheIndex);
+                    gNdpCacheIndex = 0;
+                }
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
                 ndpMemH = 0;
             }
         }
@@ -398,8 +439,15 @@ IPV6_HEAP_NDP_DR_ENTRY * TCPIP_NDP_DefaultRouterEntryCreate (TCPIP_NET_IF * pNet
 IPV6_HEAP_NDP_DC_ENTRY * TCPIP_NDP_DestCacheEntryCreate (TCPIP_NET_IF * pNetIf, const IPV6_ADDR * remoteIPAddress, uint32_t linkMTU, IPV6_HEAP_NDP_NC_ENTRY * neighbor)
 {
     IPV6_HEAP_NDP_DC_ENTRY * destinationPointer;
+    bool newEntry;
 
-    destinationPointer = (IPV6_HEAP_NDP_DC_ENTRY *)TCPIP_HEAP_Malloc(ndpMemH, sizeof(IPV6_HEAP_NDP_DC_ENTRY));
+    // an existing entry (with no valid next hop) is updated rather than duplicated
+    destinationPointer = (IPV6_HEAP_NDP_DC_ENTRY *)TCPIP_NDP_RemoteNodeFind (pNetIf, remoteIPAddress, IPV6_HEAP_NDP_DC_ID);
+    newEntry = destinationPointer == NULL;
+    if (newEntry)
+    {
+        destinationPointer = (IPV6_HEAP_NDP_DC_ENTRY *)TCPIP_HEAP_Malloc(ndpMemH, sizeof(IPV6_HEAP_NDP_DC_ENTRY));
+    }
 
     if (destinationPointer != NULL)
     {
@@ -410,7 +458,10 @@ IPV6_HEAP_NDP_DC_ENTRY * TCPIP_NDP_DestCacheEntryCreate (TCPIP_NET_IF * pNetIf,
             destinationPointer->pathMTUIncreaseTimer = SYS_TMR_TickCountGet() + (SYS_TMR_TickCounterFrequencyGet() * TCPIP_IPV6_MTU_INCREASE_TIMEOUT);
         else
             destinationPointer->pathMTUIncreaseTimer = 0;
-        TCPIP_NDP_LinkedListEntryInsert (pNetIf, destinationPointer, IPV6_HEAP_NDP_DC_ID);
+        if (newEntry)
+        {
+            TCPIP_NDP_LinkedListEntryInsert (pNetIf, destinationPointer, IPV6_HEAP_NDP_DC_ID);
+        }
     }
 
     return destinationPointer;
@@ -1292,6 +1343,27 @@ void * TCPIP_NDP_RemoteNodeFind (TCPIP_NET_IF * pNetIf, const IPV6_ADDR * source
     if (pNetIf == NULL)
         return NULL;
 
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+    if(type == IPV6_HEAP_NDP_NC_ID || type == IPV6_HEAP_NDP_DC_ID)
+    {
+        uint8_t* pPartial;
+        OA_HASH_DCPT* pOH = _NDP_CacheHashGet(pNetIf, type, &pPartial);
+        if(pOH != 0)
+        {
+            NDP_HASH_ENTRY* pHE = (NDP_HASH_ENTRY*)TCPIP_OAHASH_EntryLookup(pOH, source);
+            if(pHE != 0)
+            {
+                return pHE->pNode;
+            }
+            if(*pPartial == 0)
+            {   // all list nodes are indexed
+                return NULL;
+            }
+            // else some nodes did not fit in the index; search the list
+        }
+    }
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+
     pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(pNetIf);
 
     switch (type)
@@ -1487,21 +1559,28 @@ bool TCPIP_NDP_IsG3PLC_Neighbor(const TCPIP_NET_IF * pNetIf, const IPV6_ADDR * a
 
     pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(pNetIf);
 
-    if((pNetIf->startFlags & TCPIP_NETWORK_CONFIG_IPV6_G3_NET) != 0)
+    if((pNetIf->startFlags & TCPIP_NETWORK_CONFIG_IPV6_G3_NET) != 0 && pIpv6Config->g3PanIdSet != 0)
     {   // G3-PLC interface
-        uint8_t g3LLAddress[8] = {0xFE, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-        if(memcmp(address->v, g3LLAddress, sizeof(g3LLAddress)) == 0)
-        {   // LLA: potential G3-PLC neighbor address if PAN_Id matches
-            if(pIpv6Config->g3PanIdSet != 0)
-            {   // check that the address host part is 'PAN_id:00ff:fe00:xxxx'; the last 2 bytes are the 'G3 Short Address'
-                if(TCPIP_Helper_ntohs(address->w[4]) == pIpv6Config->g3PanId && TCPIP_Helper_ntohs(address->w[5]) == 0x00ff && TCPIP_Helper_ntohs(address->w[6]) == 0xfe00)
-                {   // proper G3-PLC neighbor address
-                    if(pMacAdd != NULL)
-                    {   // the MAC address is the last 6 bytes of the IPv6 address!
-                        memcpy(pMacAdd->v, address->v + (16 - 6), sizeof(TCPIP_MAC_ADDR));
-                    }
-                    return true;
+        // check that the address host part is 'PAN_id:00ff:fe00:xxxx'; the last 2 bytes are the 'G3 Short Address'
+        if(TCPIP_Helper_ntohs(address->w[4]) == pIpv6Config->g3PanId && TCPIP_Helper_ntohs(address->w[5]) == 0x00ff && TCPIP_Helper_ntohs(address->w[6]) == 0xfe00)
+        {   // G3-PLC short address derived interface ID
+            uint8_t g3LLAddress[8] = {0xFE, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+            bool isNeighbor = memcmp(address->v, g3LLAddress, sizeof(g3LLAddress)) == 0;
+#if (TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR != 0)
+            if(!isNeighbor)
+            {   // mesh-local address: a G3-PLC neighbor if the prefix is on-link
+                // the mesh routing is done by the adaptation layer
+                isNeighbor = TCPIP_NDP_PrefixOnLinkStatusGet ((TCPIP_NET_IF*)pNetIf, address) != 0;
+            }
+#endif  // (TCPIP_IPV6_G3_PLC_MESH_LOCAL_NEIGHBOR != 0)
+
+            if(isNeighbor)
+            {   // proper G3-PLC neighbor address
+                if(pMacAdd != NULL)
+                {   // the MAC address is the last 6 bytes of the IPv6 address!
+                    memcpy(pMacAdd->v, address->v + (16 - 6), sizeof(TCPIP_MAC_ADDR));
                 }
+                return true;
             }
         }
     }
@@ -1570,6 +1649,10 @@ void TCPIP_NDP_SAAPrefixInfoProcess (TCPIP_NET_IF * pNetIf, NDP_OPTION_PREFIX_IN
             else
             {
                 // Prefix is equal to the prefix of an address configured by Stateless Address Autoconfiguration
+                if ((localAddressPointer->preferredLifetime == 0) != (prefixInfo->dPreferredLifetime == 0))
+                {   // deprecated state changes the source address selection
+                    TCPIP_IPV6_InterfaceConfigGet(pNetIf)->addGen++;
+                }
                 localAddressPointer->preferredLifetime = prefixInfo->dPreferredLifetime;
                 if ((prefixInfo->dValidLifetime > TCPIP_IPV6_NDP_VALID_LIFETIME_TWO_HOURS) ||
                     (prefixInfo->dValidLifetime > localAddressPointer->validLifetime))
@@ -2315,10 +2398,16 @@ void * TCPIP_NDP_LinkedListEntryRemove (TCPIP_NET_IF * pNetIf, void * entry, uin
         case IPV6_HEAP_NDP_DC_ID:
             TCPIP_Helper_SingleListNodeRemove (&pIpv6Config->listDestinationCache, entry);
             nextNode = ((IPV6_HEAP_NDP_DC_ENTRY *)entry)->next;
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+            _NDP_CacheIndexRemove(pNetIf, entry, type, pIpv6Config->listDestinationCache.nNodes);
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
             break;
         case IPV6_HEAP_NDP_NC_ID:
             TCPIP_Helper_SingleListNodeRemove (&pIpv6Config->listNeighborCache, entry);
             nextNode = ((IPV6_HEAP_NDP_NC_ENTRY *)entry)->next;
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+            _NDP_CacheIndexRemove(pNetIf, entry, type, pIpv6Config->listNeighborCache.nNodes);
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
             break;
         case IPV6_HEAP_NDP_PL_ID:
             TCPIP_Helper_SingleListNodeRemove (&pIpv6Config->listPrefixList, entry);
@@ -2327,6 +2416,7 @@ void * TCPIP_NDP_LinkedListEntryRemove (TCPIP_NET_IF * pNetIf, void * entry, uin
         case IPV6_HEAP_ADDR_UNICAST_ID:
             TCPIP_Helper_DoubleListNodeRemove (&pIpv6Config->listIpv6UnicastAddresses, entry);
             nextNode = ((IPV6_ADDR_STRUCT *)entry)->next;
+            pIpv6Config->addGen++;
             break;
         case IPV6_HEAP_ADDR_MULTICAST_ID:
             TCPIP_Helper_DoubleListNodeRemove (&pIpv6Config->listIpv6MulticastAddresses, entry);
@@ -2394,15 +2484,22 @@ void TCPIP_NDP_LinkedListEntryInsert (TCPIP_NET_IF * pNetIf, void * entry, uint8
             break;
         case IPV6_HEAP_NDP_DC_ID:
             TCPIP_Helper_SingleListTailAdd (&pIpv6Config->listDestinationCache, entry);
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+            _NDP_CacheIndexInsert(pNetIf, entry, type);
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
             break;
         case IPV6_HEAP_NDP_NC_ID:
             TCPIP_Helper_SingleListTailAdd (&pIpv6Config->listNeighborCache, entry);
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+            _NDP_CacheIndexInsert(pNetIf, entry, type);
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
             break;
         case IPV6_HEAP_NDP_PL_ID:
             TCPIP_Helper_SingleListTailAdd (&pIpv6Config->listPrefixList, entry);
             break;
         case IPV6_HEAP_ADDR_UNICAST_ID:
             TCPIP_Helper_DoubleListTailAdd (&pIpv6Config->listIpv6UnicastAddresses, entry);
+            pIpv6Config->addGen++;
             break;
         case IPV6_HEAP_ADDR_MULTICAST_ID:
             TCPIP_Helper_DoubleListTailAdd (&pIpv6Config->listIpv6MulticastAddresses, entry);
@@ -2413,6 +2510,221 @@ void TCPIP_NDP_LinkedListEntryInsert (TCPIP_NET_IF * pNetIf, void * entry, uint8
     }
 }
 
+/*****************************************************************************
+  Function:
+    void TCPIP_NDP_CacheIndexClear (TCPIP_NET_IF * pNetIf)
+
+  Summary:
+    Clears the neighbor cache and destination cache index of an interface.
+
+  Description:
+    Removes all the entries of the NC/DC hash index of the specified interface.
+    Needs to be called before the NC/DC lists are freed directly,
+    without going through TCPIP_NDP_LinkedListEntryRemove.
+
+  Precondition:
+    None
+
+  Parameters:
+    pNetIf - The interface whose index is to be cleared.
+
+  Returns:
+    None
+
+  Remarks:
+    None
+  ***************************************************************************/
+void TCPIP_NDP_CacheIndexClear (TCPIP_NET_IF * pNetIf)
+{
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+    NDP_CACHE_INDEX* pIndex;
+
+    if(gNdpCacheIndex == 0 || pNetIf == NULL)
+    {
+        return;
+    }
+
+    pIndex = gNdpCacheIndex + TCPIP_STACK_NetIxGet(pNetIf);
+    if(pIndex->ncHash != 0)
+    {
+        TCPIP_OAHASH_EntriesRemoveAll(pIndex->ncHash);
+    }
+    if(pIndex->dcHash != 0)
+    {
+        TCPIP_OAHASH_EntriesRemoveAll(pIndex->dcHash);
+    }
+    pIndex->ncPartial = 0;
+    pIndex->dcPartial = 0;
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+}
+
+#if defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+// NC/DC hash index helpers
+// the key is the remote IPv6 address, read from the indexed node
+
+static size_t _NDP_CacheHashKeyHash(OA_HASH_DCPT* pOH, const void* key)
+{
+    return fnv_32a_hash(key, sizeof(IPV6_ADDR)) % (pOH->hEntries);
+}
+
+static int _NDP_CacheHashNcKeyCompare(OA_HASH_DCPT* pOH, OA_HASH_ENTRY* hEntry, const void* key)
+{
+    IPV6_HEAP_NDP_NC_ENTRY* pNode = (IPV6_HEAP_NDP_NC_ENTRY*)((NDP_HASH_ENTRY*)hEntry)->pNode;
+    return memcmp(&pNode->remoteIPAddress, key, sizeof(IPV6_ADDR));
+}
+
+static int _NDP_CacheHashDcKeyCompare(OA_HASH_DCPT* pOH, OA_HASH_ENTRY* hEntry, const void* key)
+{
+    IPV6_HEAP_NDP_DC_ENTRY* pNode = (IPV6_HEAP_NDP_DC_ENTRY*)((NDP_HASH_ENTRY*)hEntry)->pNode;
+    return memcmp(&pNode->remoteIPAddress, key, sizeof(IPV6_ADDR));
+}
+
+// a key is inserted only from the node being indexed: point the entry to it
+static void _NDP_CacheHashNcKeyCopy(OA_HASH_DCPT* pOH, OA_HASH_ENTRY* dstEntry, const void* key)
+{
+    ((NDP_HASH_ENTRY*)dstEntry)->pNode = (uint8_t*)key - offsetof(IPV6_HEAP_NDP_NC_ENTRY, remoteIPAddress);
+}
+
+static void _NDP_CacheHashDcKeyCopy(OA_HASH_DCPT* pOH, OA_HASH_ENTRY* dstEntry, const void* key)
+{
+    ((NDP_HASH_ENTRY*)dstEntry)->pNode = (uint8_t*)key - offsetof(IPV6_HEAP_NDP_DC_ENTRY, remoteIPAddress);
+}
+
+// creates a hash with hEntries slots, for the IPV6_HEAP_NDP_NC_ID/IPV6_HEAP_NDP_DC_ID list
+// returns 0 if hEntries == 0 or allocation failed
+static OA_HASH_DCPT* _NDP_CacheHashCreate(size_t hEntries, uint8_t type)
+{
+    OA_HASH_DCPT* pOH;
+
+    if(hEntries == 0)
+    {
+        return 0;
+    }
+
+    pOH = (OA_HASH_DCPT*)TCPIP_HEAP_Malloc(ndpMemH, sizeof(OA_HASH_DCPT) + hEntries * sizeof(NDP_HASH_ENTRY));
+    if(pOH != 0)
+    {
+        pOH->memBlk = pOH + 1;
+        pOH->hParam = 0;
+        pOH->hEntrySize = sizeof(NDP_HASH_ENTRY);
+        pOH->hEntries = hEntries;
+        pOH->probeStep = 1;
+        pOH->hashF = _NDP_CacheHashKeyHash;
+#if defined(OA_DOUBLE_HASH_PROBING)
+        pOH->probeHash = 0;
+#endif  // defined(OA_DOUBLE_HASH_PROBING)
+        pOH->delF = 0;
+        if(type == IPV6_HEAP_NDP_NC_ID)
+        {
+            pOH->cmpF = _NDP_CacheHashNcKeyCompare;
+            pOH->cpyF = _NDP_CacheHashNcKeyCopy;
+        }
+        else
+        {
+            pOH->cmpF = _NDP_CacheHashDcKeyCompare;
+            pOH->cpyF = _NDP_CacheHashDcKeyCopy;
+        }
+        TCPIP_OAHASH_Initialize(pOH);
+    }
+
+    return pOH;
+}
+
+static OA_HASH_DCPT* _NDP_CacheHashGet(TCPIP_NET_IF * pNetIf, uint8_t type, uint8_t** ppPartial)
+{
+    NDP_CACHE_INDEX* pIndex;
+
+    if(gNdpCacheIndex == 0)
+    {
+        return 0;
+    }
+
+    pIndex = gNdpCacheIndex + TCPIP_STACK_NetIxGet(pNetIf);
+    if(type == IPV6_HEAP_NDP_NC_ID)
+    {
+        *ppPartial = &pIndex->ncPartial;
+        return pIndex->ncHash;
+    }
+
+    *ppPartial = &pIndex->dcPartial;
+    return pIndex->dcHash;
+}
+
+static void _NDP_CacheIndexInsert(TCPIP_NET_IF * pNetIf, void * entry, uint8_t type)
+{
+    uint8_t* pPartial;
+    NDP_HASH_ENTRY* pHE;
+    const IPV6_ADDR* pKey;
+    OA_HASH_DCPT* pOH = _NDP_CacheHashGet(pNetIf, type, &pPartial);
+
+    if(pOH == 0)
+    {
+        return;
+    }
+
+    if(type == IPV6_HEAP_NDP_NC_ID)
+    {
+        pKey = &((IPV6_HEAP_NDP_NC_ENTRY*)entry)->remoteIPAddress;
+    }
+    else
+    {
+        pKey = &((IPV6_HEAP_NDP_DC_ENTRY*)entry)->remoteIPAddress;
+    }
+
+    // the insertion stops at the first free slot, so check for an already
+    // indexed key first: a key is never present twice in the index
+    pHE = (NDP_HASH_ENTRY*)TCPIP_OAHASH_EntryLookup(pOH, pKey);
+    if(pHE == 0)
+    {
+        pHE = (NDP_HASH_ENTRY*)TCPIP_OAHASH_EntryLookupOrInsert(pOH, pKey);
+        if(pHE != 0)
+        {
+            pHE->pNode = entry;
+            return;
+        }
+    }
+
+    // index full or an older node with the same address is indexed:
+    // this node can be found only by searching the list
+    *pPartial = 1;
+}
+
+static void _NDP_CacheIndexRemove(TCPIP_NET_IF * pNetIf, void * entry, uint8_t type, size_t nNodes)
+{
+    uint8_t* pPartial;
+    NDP_HASH_ENTRY* pHE;
+    const IPV6_ADDR* pKey;
+    OA_HASH_DCPT* pOH = _NDP_CacheHashGet(pNetIf, type, &pPartial);
+
+    if(pOH == 0)
+    {
+        return;
+    }
+
+    if(nNodes == 0)
+    {   // list is empty; start clean
+        TCPIP_OAHASH_EntriesRemoveAll(pOH);
+        *pPartial = 0;
+        return;
+    }
+
+    if(type == IPV6_HEAP_NDP_NC_ID)
+    {
+        pKey = &((IPV6_HEAP_NDP_NC_ENTRY*)entry)->remoteIPAddress;
+    }
+    else
+    {
+        pKey = &((IPV6_HEAP_NDP_DC_ENTRY*)entry)->remoteIPAddress;
+    }
+
+    pHE = (NDP_HASH_ENTRY*)TCPIP_OAHASH_EntryLookup(pOH, pKey);
+    if(pHE != 0 && pHE->pNode == entry)
+    {
+        TCPIP_OAHASH_EntryRemove(pOH, &pHE->hEntry);
+    }
+}
+#endif  // defined(_TCPIP_NDP_CACHE_HASH_ENABLE)
+
 /*****************************************************************************
   Function:
     IPV6_ADDR_STRUCT * TCPIP_NDP_UnicastAddressMove (TCPIP_NET_IF * pNetIf,
@@ -2520,6 +2832,7 @@ IPV6_ADDR_STRUCT * TCPIP_NDP_TentativeAddressPromote (TCPIP_NET_IF * pNetIf, IPV
 
     TCPIP_Helper_DoubleListNodeRemove (&pIpv6Config->listIpv6TentativeAddresses, (DBL_LIST_NODE *)entryLocation);
     TCPIP_Helper_DoubleListTailAdd (&pIpv6Config->listIpv6UnicastAddresses, (DBL_LIST_NODE *)entryLocation);
+    pIpv6Config->addGen++;
 
     TCPIP_IPV6_ClientsNotify(pNetIf, IPV6_EVENT_ADDRESS_ADDED, entryLocation);
 
@@ -66,6 +66,12 @@ static int          udpInitCount = 0;   // initialization counter
 
 static uint16_t     udpDefTxSize;               // default size of the TX buffer
 
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+static uint32_t*    udpPortMap = 0;             // local port index: for each bucket,
+                                                // the bitmap of the sockets with a local port in that bucket
+static int          udpPortMapWords = 0;        // number of 32 bit words in a bucket bitmap
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+
 #if (TCPIP_UDP_USE_POOL_BUFFERS != 0)
 static SINGLE_LIST  udpPacketPool = { 0 };  // private pool of UDP packets
 
@@ -497,6 +503,62 @@ static  bool _UDPSocketBind(UDP_SOCKET_DCPT* pSkt, TCPIP_NET_IF* pNet, IP_MULTI_
     pSkt->pPkt = pTxPkt;
 }
 
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+static __inline__ uint32_t* __attribute__((always_inline)) _UDPPortMapBucket(UDP_PORT port)
+{
+    return udpPortMap + ((port ^ (port >> 8)) % TCPIP_UDP_PORT_HASH_BUCKETS) * udpPortMapWords;
+}
+
+// sets the socket local port and updates the port index
+static void _UDPSocketPortSet(UDP_SOCKET_DCPT* pSkt, UDP_PORT port)
+{
+    uint32_t sktBit = 1UL << (pSkt->sktIx & 0x1f);
+    int wordIx = pSkt->sktIx >> 5;
+
+    // don't let the RX thread see a partial update
+    OSAL_CRITSECT_DATA_TYPE status = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if(pSkt->localPort != 0)
+    {
+        _UDPPortMapBucket(pSkt->localPort)[wordIx] &= ~sktBit;
+    }
+    pSkt->localPort = port;
+    if(port != 0)
+    {
+        _UDPPortMapBucket(port)[wordIx] |= sktBit;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, status);
+}
+
+static void _UDPPortMapIterInit(UDP_PORT_MAP_ITER* pIter, UDP_PORT port)
+{
+    pIter->pMap = _UDPPortMapBucket(port);
+    pIter->sktMask = 0;
+    pIter->wordIx = -1;
+}
+
+// returns the index of the next socket in the bucket, in ascending order
+// or -1 if no more sockets
+static int _UDPPortMapNext(UDP_PORT_MAP_ITER* pIter)
+{
+    int bitIx;
+
+    while(pIter->sktMask == 0)
+    {
+        if(++pIter->wordIx >= udpPortMapWords)
+        {
+            return -1;
+        }
+        pIter->sktMask = pIter->pMap[pIter->wordIx];
+    }
+
+    bitIx = __builtin_ctz(pIter->sktMask);
+    pIter->sktMask &= pIter->sktMask - 1;
+    return (pIter->wordIx << 5) + bitIx;
+}
+#else
+#define _UDPSocketPortSet(pSkt, port)   do { (pSkt)->localPort = (port); } while(0)
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+
 // returns the associated socket descriptor, if such a socket is valid
 /*static __inline__*/static  UDP_SOCKET_DCPT* /*__attribute__((always_inline))*/ _UDPSocketDcpt(UDP_SOCKET s)
 {
@@ -605,6 +667,20 @@ bool TCPIP_UDP_Initialize(const TCPIP_STACK_MODULE_CTRL* const stackCtrl, const
         _TCPIPStackSignalHandlerDeregister(signalHandle);
         return false;
     }
+
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+    int newPortMapWords = (pUdpInit->nSockets + 31) / 32;
+    uint32_t* newPortMap = (uint32_t*)TCPIP_HEAP_Calloc(stackCtrl->memH, TCPIP_UDP_PORT_HASH_BUCKETS * newPortMapWords, sizeof(uint32_t));
+    if(newPortMap == 0)
+    {
+        SYS_ERROR(SYS_ERROR_ERROR, "UDP Dynamic allocation failed");
+        TCPIP_HEAP_Free(stackCtrl->memH, newSktDcpt);
+        _UserGblLockDelete();
+        _TCPIPStackSignalHandlerDeregister(signalHandle);
+        return false;
+    }
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+
 #if (TCPIP_UDP_USE_POOL_BUFFERS != 0)
     TCPIP_Helper_SingleListInitialize (&udpPacketPool);
     udpPacketsInPool = pUdpInit->poolBuffers;
@@ -644,6 +720,10 @@ bool TCPIP_UDP_Initialize(const TCPIP_STACK_MODULE_CTRL* const stackCtrl, const
     nUdpSockets = pUdpInit->nSockets;
     udpDefTxSize = pUdpInit->sktTxBuffSize;
     UDPSocketDcpt = newSktDcpt;
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+    udpPortMap = newPortMap;
+    udpPortMapWords = newPortMapWords;
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
 #if (TCPIP_UDP_EXTERN_PACKET_PROCESS != 0)
     udpPktHandler = 0;
 #endif  // (TCPIP_UDP_EXTERN_PACKET_PROCESS != 0)
@@ -727,6 +807,12 @@ void TCPIP_UDP_Deinitialize(const TCPIP_STACK_MODULE_CTRL* const stackCtrl)
 
             UDPSocketDcpt = 0;
 
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+            TCPIP_HEAP_Free(udpMemH, udpPortMap);
+            udpPortMap = 0;
+            udpPortMapWords = 0;
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+
 #if (TCPIP_UDP_USE_POOL_BUFFERS != 0)
             // Note: no protection for this access
             TCPIP_MAC_PACKET*   pPkt;
@@ -1018,7 +1104,7 @@ static UDP_SOCKET _UDPOpen(IP_ADDRESS_TYPE addType, UDP_OPEN_TYPE opType, UDP_PO
 
     // fill in all the socket parameters
     // so that the RX thread can see all the right data
-    pSkt->localPort = localPort;    
+    _UDPSocketPortSet(pSkt, localPort);
     pSkt->remotePort = remotePort;
     pSkt->addType = addType;
     pSkt->txAllocLimit = TCPIP_UDP_SOCKET_DEFAULT_TX_QUEUE_LIMIT; 
@@ -2305,6 +2391,7 @@ static void _UDPClose(UDP_SOCKET_DCPT* pSkt)
     {   // acknowledge the old one
         _UDP_RxPktAcknowledge(pSkt->pCurrRxPkt, TCPIP_MAC_PKT_ACK_PROTO_DEST_CLOSE);
     }
+    _UDPSocketPortSet(pSkt, 0);
     UDPSocketDcpt[pSkt->sktIx] = 0;
     TCPIP_HEAP_Free(udpMemH, pSkt);
 }
@@ -2619,6 +2706,102 @@ uint16_t TCPIP_UDP_Flush(UDP_SOCKET s)
     return 0;
 }
 
+uint16_t TCPIP_UDP_BatchSend(UDP_SOCKET s, const TCPIP_UDP_BATCH_ITEM* pItems, uint16_t nItems)
+{
+    uint16_t nSent, txSpace, flushLen;
+    const TCPIP_UDP_BATCH_ITEM* pItem;
+    UDP_SOCKET_DCPT* pSkt = _UDPSocketDcpt(s);
+
+    if(pSkt == 0 || pItems == 0 || pSkt->flags.txSplitAlloc != 0)
+    {
+        return 0;
+    }
+
+    if(_UDPTxPktValid(pSkt) && pSkt->txWrite != pSkt->txStart)
+    {   // user data pending in the socket; don't mix it with the batch
+        return 0;
+    }
+
+    for(nSent = 0, pItem = pItems; nSent < nItems; nSent++, pItem++)
+    {
+        if(pItem->pData == 0 || pItem->dataLen == 0)
+        {
+            break;
+        }
+
+        // get a TX packet that's not queued and set the destination
+        txSpace = 0;
+        switch(pSkt->addType)
+        {
+#if defined(TCPIP_STACK_USE_IPV6)
+            case IP_ADDRESS_TYPE_IPV6:
+                txSpace = _UDPv6IsTxPutReady(pSkt, pSkt->txSize);
+                if(txSpace != 0)
+                {
+                    TCPIP_IPV6_DestAddressSet (pSkt->pV6Pkt, &pItem->destAddress.v6Add);
+                }
+                break;
+#endif  // defined(TCPIP_STACK_USE_IPV6)
+
+#if defined(TCPIP_STACK_USE_IPV4)
+            case IP_ADDRESS_TYPE_IPV4:
+                if(pSkt->flags.bcastForceType == UDP_BCAST_NONE)
+                {   // BCAST cannot be overridden
+                    txSpace = _UDPv4IsTxPutReady(pSkt);
+                    pSkt->destAddress.Val = pItem->destAddress.v4Add.Val;
+                    pSkt->flags.destSet = 1;
+                }
+                break;
+#endif  // defined (TCPIP_STACK_USE_IPV4)
+
+            default:
+                break;
+        }
+
+        if(txSpace < pItem->dataLen)
+        {   // no packet or the payload does not fit
+            break;
+        }
+
+        if(pItem->destPort != 0 && pItem->destPort != pSkt->remotePort)
+        {
+            _RxSktLock(pSkt);
+            pSkt->remotePort = pItem->destPort;
+            _RxSktUnlock(pSkt);
+        }
+
+        TCPIP_Helper_Memcpy(pSkt->txWrite, pItem->pData, pItem->dataLen);
+        pSkt->txWrite += pItem->dataLen;
+
+        switch(pSkt->addType)
+        {
+#if defined(TCPIP_STACK_USE_IPV6)
+            case IP_ADDRESS_TYPE_IPV6:
+                flushLen = _UDPv6Flush(pSkt);
+                break;
+#endif  // defined(TCPIP_STACK_USE_IPV6)
+
+#if defined(TCPIP_STACK_USE_IPV4)
+            case IP_ADDRESS_TYPE_IPV4:
+                flushLen = _UDPv4Flush(pSkt);
+                break;
+#endif  // defined (TCPIP_STACK_USE_IPV4)
+
+            default:
+                flushLen = 0;
+                break;
+        }
+
+        if(flushLen == 0)
+        {   // failed; drop the item data
+            pSkt->txWrite = pSkt->txStart;
+            break;
+        }
+    }
+
+    return nSent;
+}
+
 
 uint16_t TCPIP_UDP_TxCountGet(UDP_SOCKET s)
 {
@@ -2797,6 +2980,9 @@ static UDP_SOCKET_DCPT* _UDPFindMatchingSocket(TCPIP_MAC_PACKET* pRxPkt, UDP_HEA
 #endif // defined (TCPIP_STACK_USE_IPV4)
     TCPIP_UDP_SKT_FLAGS _flags; 
     _flags.Val = 0;
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+    UDP_PORT_MAP_ITER sktIter;
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
 
 
     // This packet is said to be matching with current socket:
@@ -2812,7 +2998,13 @@ static UDP_SOCKET_DCPT* _UDPFindMatchingSocket(TCPIP_MAC_PACKET* pRxPkt, UDP_HEA
     
 
     pPktIf = (TCPIP_NET_IF*)pRxPkt->pktIf;
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+    // only the sockets having a local port in the packet destination port bucket
+    _UDPPortMapIterInit(&sktIter, h->DestinationPort);
+    while((sktIx = _UDPPortMapNext(&sktIter)) >= 0)
+#else
     for(sktIx = 0; sktIx < nUdpSockets; sktIx++)
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
     {
         bool processSkt = false;
         critStatus = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
@@ -3144,7 +3336,7 @@ bool TCPIP_UDP_Bind(UDP_SOCKET s, IP_ADDRESS_TYPE addType, UDP_PORT localPort,
     }
     if(bindSuccess)
     {
-        pSkt->localPort = localPort;
+        _UDPSocketPortSet(pSkt, localPort);
     }
     else
     {   // restore old add type
@@ -3643,7 +3835,13 @@ static bool _UDPIsAvailablePort(UDP_PORT port)
     UDP_SOCKET_DCPT *pSkt;
 
     // Find an available socket that matches the specified socket type
+#if (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
+    UDP_PORT_MAP_ITER sktIter;
+    _UDPPortMapIterInit(&sktIter, port);
+    while((skt = _UDPPortMapNext(&sktIter)) >= 0)
+#else
     for(skt = 0; skt < nUdpSockets; skt++)
+#endif  // (TCPIP_UDP_PORT_HASH_BUCKETS != 0)
     {
         pSkt = UDPSocketDcpt[skt]; 
         if(pSkt && pSkt->localPort == port)
@@ -133,6 +133,7 @@ extern "C" {
 #define DRV_PLC_PHY_HOST_DESC                 "PIC32CX2051MTG128"
 #define DRV_PLC_PHY_HOST_MODEL                3U
 #define DRV_PLC_PHY_HOST_BAND                 DRV_PLC_PHY_PROFILE
+#define DRV_PLC_PHY_TX_QUEUE_SIZE             2U
 
 
 // *****************************************************************************
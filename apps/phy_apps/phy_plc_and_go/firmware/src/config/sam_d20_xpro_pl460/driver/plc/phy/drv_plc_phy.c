@@ -99,6 +99,12 @@ SYS_MODULE_OBJ DRV_PLC_PHY_Initialize(
     gDrvPlcPhyObj.secure                = plcPhyInit->secure;
     gDrvPlcPhyObj.sleep                 = false;
 
+    /* TX queue initialization */
+    gDrvPlcPhyObj.txQueueFirst          = 0;
+    gDrvPlcPhyObj.txQueueNum            = 0;
+    gDrvPlcPhyObj.txCfmIn               = 0;
+    gDrvPlcPhyObj.txCfmOut              = 0;
+
     /* Callbacks initialization */
     gDrvPlcPhyObj.txCfmCallback         = NULL;
     gDrvPlcPhyObj.dataIndCallback       = NULL;
@@ -570,7 +570,13 @@ void DRV_PLC_PHY_Close(const DRV_HANDLE handle);
     </code>
 
   Remarks:
-    None.
+    If DRV_PLC_PHY_TX_QUEUE_SIZE is greater than 0, up to that number of
+    requests received while a transmission is in progress are stored by the
+    driver (parameters and a copy of the data) and sent from the TX confirm
+    interrupt. In TX_MODE_RELATIVE mode, the time of a queued transmission
+    counts from the moment it is sent to the PLC device. A cancel request also
+    discards queued transmissions, which are confirmed with
+    DRV_PLC_PHY_TX_RESULT_NO_TX.
 */
 void DRV_PLC_PHY_TxRequest(const DRV_HANDLE handle, DRV_PLC_PHY_TRANSMISSION_OBJ *transmitObj);
 
@@ -199,6 +199,18 @@ typedef struct
     /* Event detection flag: reset waiting tx cfm */
     volatile bool                   evResetTxCfm;
 
+    /* Index of the oldest transmission waiting in the TX queue */
+    volatile uint8_t                txQueueFirst;
+
+    /* Number of transmissions waiting in the TX queue */
+    volatile uint8_t                txQueueNum;
+
+    /* Write index of the TX confirm queue */
+    volatile uint8_t                txCfmIn;
+
+    /* Read index of the TX confirm queue */
+    volatile uint8_t                txCfmOut;
+
 } DRV_PLC_PHY_OBJ;
 
 
@@ -109,6 +109,12 @@ extern "C" {
 #define DRV_RF215_MAX_TX_TIME_DELAY_ERROR_US  9000U
 #define DRV_RF215_TIME_SYNC_EXECUTION_CYCLES  180U
 #define DRV_RF215_TX_COMMAND_EXECUTION_CYCLES 1400U
+#define DRV_RF215_PHY_PROFILES_NUMBER         4U
+#define DRV_RF215_RX_STREAM_CHUNK_US          200U
+#define DRV_RF215_TX_SCHEDULE_ENABLE          1U
+#define DRV_RF215_ED_CACHE_CHANNELS           0U
+#define DRV_RF215_ED_CACHE_VALID_US           2000U
+#define DRV_RF215_ED_SCAN_PERIOD_US           0U
 
 
 /* USI Service Common Configuration Options */
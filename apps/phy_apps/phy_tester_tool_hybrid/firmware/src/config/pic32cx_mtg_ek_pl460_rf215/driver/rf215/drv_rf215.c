@@ -827,6 +827,10 @@ uint8_t DRV_RF215_GetPibSize(DRV_RF215_PIB_ATTRIBUTE attr)
             len = (uint8_t) sizeof(DRV_RF215_PHY_BAND_OPM);
             break;
 
+        case RF215_PIB_PHY_CHANNEL_OCCUPANCY:
+            len = (uint8_t) sizeof(DRV_RF215_CHN_OCCUPANCY_OBJ);
+            break;
+
         default:
             len = 0U;
             break;
@@ -925,6 +929,7 @@ DRV_RF215_PIB_RESULT DRV_RF215_SetPib (
         case RF215_PIB_PHY_RX_OVERRIDE:
         case RF215_PIB_PHY_RX_IND_NOT_HANDLED:
         case RF215_PIB_MAC_UNIT_BACKOFF_PERIOD:
+        case RF215_PIB_PHY_CHANNEL_OCCUPANCY:
             result = RF215_PIB_RESULT_READ_ONLY;
             break;
 
@@ -947,3 +952,20 @@ DRV_RF215_PIB_RESULT DRV_RF215_SetPib (
 
     return result;
 }
+
+DRV_RF215_PIB_RESULT DRV_RF215_PhyProfileLoad (
+    DRV_HANDLE drvHandle,
+    DRV_RF215_PHY_BAND_OPM bandOpMode,
+    uint16_t channelNum
+)
+{
+    DRV_RF215_CLIENT_OBJ* clientObj;
+
+    clientObj = lDRV_RF215_DrvHandleValidate(drvHandle);
+    if (clientObj == NULL)
+    {
+        return RF215_PIB_RESULT_INVALID_HANDLE;
+    }
+
+    return RF215_PHY_ProfileLoad(clientObj->trxIndex, bandOpMode, channelNum);
+}
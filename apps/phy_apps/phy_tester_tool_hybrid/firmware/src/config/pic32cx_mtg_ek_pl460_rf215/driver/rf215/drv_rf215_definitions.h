@@ -51,6 +51,7 @@ Microchip or any third party.
 #include <stdint.h>
 #include "system/int/sys_int.h"
 #include "peripheral/flexcom/spi/master/plib_flexcom_spi_master_common.h"
+#include "configuration.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -566,6 +567,10 @@ typedef enum
     /* Threshold in dB above sensitivity for CCA with Energy Detection. 8 bits */
     RF215_PIB_PHY_CCA_ED_THRESHOLD_SENSITIVITY = 0x0144,
 
+    /* Occupancy information of the channel in use (read-only)
+     * (see DRV_RF215_CHN_OCCUPANCY_OBJ) */
+    RF215_PIB_PHY_CHANNEL_OCCUPANCY            = 0x0145,
+
     /* Sensitivity in dBm (according to 802.15.4). 8 bits */
     RF215_PIB_PHY_SENSITIVITY = 0x0150,
 
@@ -958,6 +963,58 @@ typedef struct
 
 } DRV_RF215_FW_VERSION;
 
+// *****************************************************************************
+/* RF215 Driver Channel Occupancy Data
+
+  Summary:
+    Defines the occupancy information of one RF channel.
+
+  Description:
+    This data type defines the information kept in the channel occupancy cache
+    for one channel frequency (PIB RF215_PIB_PHY_CHANNEL_OCCUPANCY). Times are
+    referred to system 64-bit time counter.
+
+  Remarks:
+    Only available if DRV_RF215_ED_CACHE_CHANNELS is not 0.
+*/
+
+typedef struct
+{
+    /* Time of last Energy Detection measurement */
+    uint64_t                     edTime;
+
+    /* End time of last received frame */
+    uint64_t                     rxTime;
+
+    /* Channel center frequency in Hz (0: no information) */
+    uint32_t                     chnFreq;
+
+    /* Number of ED measurements (CCA and background scan) */
+    uint32_t                     edCount;
+
+    /* Number of ED measurements above CCA threshold */
+    uint32_t                     edBusyCount;
+
+    /* Number of frames received */
+    uint32_t                     rxCount;
+
+    /* Number of CCA with ED duration reduced by the cache */
+    uint32_t                     ccaShortened;
+
+    /* Number of transmissions not attempted because of cached busy ED */
+    uint32_t                     ccaSkipped;
+
+    /* Last ED value in dBm */
+    int8_t                       edDBm;
+
+    /* Busy (1) / idle (0) history of ED measurements, bit 0 the most recent */
+    uint8_t                      edHistory;
+
+    /* Number of valid bits in edHistory */
+    uint8_t                      edHistoryLen;
+
+} DRV_RF215_CHN_OCCUPANCY_OBJ;
+
 // *****************************************************************************
 /* RF215 Driver PLIB SPI Is Busy
 
@@ -395,6 +395,12 @@ static uint8_t rf215PhyRxPsdu[DRV_RF215_MAX_PSDU_LEN];
 /* RF_IQIFC1 register */
 static uint8_t rf215PhyRegRF_IQIFC1;
 
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+/* PHY configuration profiles and next profile to replace, per TRX */
+static RF215_PHY_PROFILE_OBJ rf215PhyProfiles[DRV_RF215_NUM_TRX][DRV_RF215_PHY_PROFILES_NUMBER];
+static uint8_t rf215PhyProfileNext[DRV_RF215_NUM_TRX];
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File Scope Function Declarations
@@ -973,14 +979,17 @@ static inline void lRF215_BBC_SetFBLI(uint8_t trxIdx, uint16_t fbli)
     /* MISRA C-2012 deviation block end */
 }
 
-static inline uint16_t lRF215_BBC_GetBestFBLI (
+static uint32_t lRF215_BBC_RxOctetParams (
     DRV_RF215_PHY_CFG_OBJ* phyCfg,
     DRV_RF215_PHY_MOD_SCHEME modScheme,
-    uint16_t psduLen
+    uint16_t psduLen,
+    uint16_t* pBitsBlock,
+    uint8_t* pFecDelayBits,
+    uint32_t* pPayloadUSq5
 )
 {
-    uint32_t bitsPayTotal, octetsPayTotal, payloadUSq5, octetUSq5;
-    uint16_t marginUSq5, bitsSymb;
+    uint32_t bitsPayTotal, octetsPayTotal, octetUSq5;
+    uint16_t bitsSymb;
     const RF215_OFDM_BW_OPT_CONST_OBJ* optConst;
     const RF215_OFDM_MCS_CONST_OBJ* mcsConst;
     uint8_t symbolsOctet;
@@ -988,7 +997,6 @@ static inline uint16_t lRF215_BBC_GetBestFBLI (
     uint32_t denAux = 1U;
     uint16_t bitsBlock = 8U;
     uint8_t fecK = 0U;
-    uint16_t fbli = 2047U;
     uint8_t fecFlushBits = 0U;
     uint8_t fecDelayBits = 0U;
     DRV_RF215_PHY_TYPE_CFG_OBJ* phyTypeCfg = &phyCfg->phyTypeCfg;
@@ -1064,15 +1072,34 @@ static inline uint16_t lRF215_BBC_GetBestFBLI (
     bitsPayTotal = DIV_CEIL(bitsPayTotal, bitsBlock) * bitsBlock;
     octetsPayTotal = DIV_CEIL(bitsPayTotal, 8U);
 
+    /* Payload duration: PsduLen * TimeRfOctect */
+    *pPayloadUSq5 = octetUSq5 * octetsPayTotal;
+    *pBitsBlock = bitsBlock;
+    *pFecDelayBits = fecDelayBits;
+
+    return octetUSq5;
+}
+
+static inline uint16_t lRF215_BBC_GetBestFBLI (
+    DRV_RF215_PHY_CFG_OBJ* phyCfg,
+    DRV_RF215_PHY_MOD_SCHEME modScheme,
+    uint16_t psduLen
+)
+{
+    uint32_t payloadUSq5, octetUSq5, numAux, denAux;
+    uint16_t marginUSq5, bitsBlock;
+    uint16_t fbli = 2047U;
+    uint8_t fecDelayBits;
+
+    octetUSq5 = lRF215_BBC_RxOctetParams(phyCfg, modScheme, psduLen,
+            &bitsBlock, &fecDelayBits, &payloadUSq5);
+
     /* 500 us of margin between FBLI and RXFE in case there is another
      * interrupt in between to avoid delaying RXFE interrupt.
      * Added time of SPI transactions before reading buffer in FBLI interrupt:
      * 12 bytes (6 IRQS, 4 FBL, 2 SPI header) */
     marginUSq5 = (500U << 5) + (RF215_SPI_BYTE_DURATION_US_Q5 * 12U);
 
-    /* Payload duration: PsduLen * TimeRfOctect */
-    payloadUSq5 = octetUSq5 * octetsPayTotal;
-
     if (payloadUSq5 > marginUSq5)
     {
         uint16_t fbliBits, fbliBytes;
@@ -1110,6 +1137,63 @@ static inline uint16_t lRF215_BBC_GetBestFBLI (
     return fbli;
 }
 
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+static inline void lRF215_BBC_GetStreamParams (
+    RF215_PHY_OBJ* pObj,
+    DRV_RF215_PHY_MOD_SCHEME modScheme,
+    uint16_t psduLen
+)
+{
+    uint32_t payloadUSq5, octetUSq5, marginUSq5, chunkBits;
+    uint16_t bitsBlock, chunk;
+    uint16_t limit = 0U;
+    uint8_t fecDelayBits;
+
+    octetUSq5 = lRF215_BBC_RxOctetParams(&pObj->phyConfig, modScheme, psduLen,
+            &bitsBlock, &fecDelayBits, &payloadUSq5);
+
+    /* Chunk size: Bytes received in DRV_RF215_RX_STREAM_CHUNK_US, at least
+     * RF215_RX_STREAM_CHUNK_MIN to limit the SPI overhead of every chunk
+     * (IRQS, FBL, FBLI and SPI headers). Multiple of block size (ceiling). */
+    chunkBits = ((uint32_t) DRV_RF215_RX_STREAM_CHUNK_US << 8) / octetUSq5;
+    if (chunkBits < (RF215_RX_STREAM_CHUNK_MIN << 3))
+    {
+        chunkBits = RF215_RX_STREAM_CHUNK_MIN << 3;
+    }
+
+    chunkBits = DIV_CEIL(chunkBits, bitsBlock) * bitsBlock;
+    chunk = (uint16_t) DIV_CEIL(chunkBits, 8U);
+
+    /* Streaming only helps if a chunk is shorter than the PSDU part read at
+     * RXFE without streaming (500 us margin of lRF215_BBC_GetBestFBLI) */
+    if (((uint32_t) chunk * octetUSq5) >= (500U << 5))
+    {
+        pObj->rxStreamChunk = chunk;
+        pObj->rxStreamLimit = 0U;
+        return;
+    }
+
+    /* Margin between the last FBLI and RXFE: Interrupt latency (100 us) and
+     * SPI transactions of one chunk: 16 bytes (6 IRQS, 4 FBL, 4 FBLI, 2 SPI
+     * header) and chunk size. The next FBLI is only programmed if it is
+     * reached before that margin. */
+    marginUSq5 = (100U << 5) + (RF215_SPI_BYTE_DURATION_US_Q5 * (16U + (uint32_t) chunk));
+    if (payloadUSq5 > marginUSq5)
+    {
+        uint32_t limitBits = ((payloadUSq5 - marginUSq5) << 3) / octetUSq5;
+
+        /* Remove FEC "delay" */
+        if (limitBits > fecDelayBits)
+        {
+            limit = (uint16_t) ((limitBits - fecDelayBits) >> 3);
+        }
+    }
+
+    pObj->rxStreamChunk = chunk;
+    pObj->rxStreamLimit = limit;
+}
+#endif
+
 static void lRF215_PLL_Params (
     const RF215_PLL_CONST_OBJ* pllConst,
     RF215_PLL_PARAMS_OBJ* pllParams,
@@ -1208,6 +1292,24 @@ static inline bool lRF215_PLL_CheckConfig (
     return true;
 }
 
+static inline void lRF215_PLL_UpdateCNM (
+    RF215_PHY_REGS_OBJ* regsOld,
+    RF215_PHY_REGS_OBJ* regsNew
+)
+{
+    if ((regsNew->RFn_CS != regsOld->RFn_CS) ||
+            (regsNew->RFn_CCF0L != regsOld->RFn_CCF0L) ||
+            (regsNew->RFn_CCF0H != regsOld->RFn_CCF0H) ||
+            (regsNew->RFn_CNL != regsOld->RFn_CNL))
+    {
+        if (regsNew->RFn_CNM == regsOld->RFn_CNM)
+        {
+            /* RFn_CNM must always be written */
+            regsOld->RFn_CNM = regsNew->RFn_CNM + 1U;
+        }
+    }
+}
+
 static void lRF215_PLL_Regs (
     RF215_PHY_OBJ* phyObj,
     const RF215_PLL_CONST_OBJ* pllConst,
@@ -1277,17 +1379,7 @@ static void lRF215_PLL_Regs (
         pllParams->chnFreq = f0;
     }
 
-    if ((regsNew->RFn_CS != regsOld->RFn_CS) ||
-            (regsNew->RFn_CCF0L != regsOld->RFn_CCF0L) ||
-            (regsNew->RFn_CCF0H != regsOld->RFn_CCF0H) ||
-            (regsNew->RFn_CNL != regsOld->RFn_CNL))
-    {
-        if (regsNew->RFn_CNM == regsOld->RFn_CNM)
-        {
-            /* RFn_CNM must always be written */
-            regsOld->RFn_CNM = regsNew->RFn_CNM + 1U;
-        }
-    }
+    lRF215_PLL_UpdateCNM(regsOld, regsNew);
 }
 
 static inline void lRF215_RXFE_SetEDD(uint8_t trxIdx, uint8_t edd)
@@ -1624,6 +1716,106 @@ static void lRF215_TXRXFE_Regs(RF215_PHY_OBJ* phyObj, RF215_PHY_REGS_OBJ* regsNe
     regsNew->RFn_TXDFE = txdfe;
 }
 
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+static RF215_PHY_PROFILE_OBJ* lRF215_PHY_ProfileFind (
+    uint8_t trxIdx,
+    DRV_RF215_PHY_CFG_OBJ* phyCfg,
+    uint16_t chnNum
+)
+{
+    for (uint8_t idx = 0U; idx < DRV_RF215_PHY_PROFILES_NUMBER; idx++)
+    {
+        RF215_PHY_PROFILE_OBJ* profile = &rf215PhyProfiles[trxIdx][idx];
+        DRV_RF215_PHY_CFG_OBJ* profileCfg = &profile->phyConfig;
+
+        /* Registers only depend on channel, PHY type and modulation */
+        if ((profile->inUse == false) || (profile->channelNum != chnNum) ||
+                (profileCfg->chnF0Hz != phyCfg->chnF0Hz) ||
+                (profileCfg->chnSpaHz != phyCfg->chnSpaHz) ||
+                (profileCfg->phyType != phyCfg->phyType))
+        {
+            continue;
+        }
+
+        if (phyCfg->phyType == PHY_TYPE_FSK)
+        {
+            if ((profileCfg->phyTypeCfg.fsk.symRate == phyCfg->phyTypeCfg.fsk.symRate) &&
+                (profileCfg->phyTypeCfg.fsk.modIdx == phyCfg->phyTypeCfg.fsk.modIdx) &&
+                (profileCfg->phyTypeCfg.fsk.modOrd == phyCfg->phyTypeCfg.fsk.modOrd))
+            {
+                return profile;
+            }
+        }
+        else /* PHY_TYPE_OFDM */
+        {
+            if ((profileCfg->phyTypeCfg.ofdm.opt == phyCfg->phyTypeCfg.ofdm.opt) &&
+                (profileCfg->phyTypeCfg.ofdm.itlv == phyCfg->phyTypeCfg.ofdm.itlv))
+            {
+                return profile;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void lRF215_PHY_ProfileStore(uint8_t trxIdx, RF215_PHY_OBJ* phyObj, RF215_PHY_REGS_OBJ* regsNew)
+{
+    /* Replace profiles in round-robin order */
+    uint8_t idx = rf215PhyProfileNext[trxIdx];
+    RF215_PHY_PROFILE_OBJ* profile = &rf215PhyProfiles[trxIdx][idx];
+
+    idx++;
+    if (idx >= DRV_RF215_PHY_PROFILES_NUMBER)
+    {
+        idx = 0U;
+    }
+
+    rf215PhyProfileNext[trxIdx] = idx;
+
+    profile->phyConfig = phyObj->phyConfig;
+    profile->regs = *regsNew;
+    profile->chnFreq = phyObj->pllParams.chnFreq;
+    profile->turnaroundTimeUS = phyObj->turnaroundTimeUS;
+    profile->channelNum = phyObj->channelNum;
+    profile->inUse = true;
+}
+
+static void lRF215_PHY_ProfileRegs (
+    RF215_PHY_OBJ* phyObj,
+    RF215_PHY_PROFILE_OBJ* profile,
+    RF215_PHY_REGS_OBJ* regsNew
+)
+{
+    RF215_PHY_REGS_OBJ* regsOld = &phyObj->phyRegs;
+
+    /* Same result as lRF215_PLL_Regs, lRF215_BBC_Regs and lRF215_TXRXFE_Regs.
+     * Only the values taken from the current registers are updated. */
+    *regsNew = profile->regs;
+    regsNew->RFn_RSSI = regsOld->RFn_RSSI;
+    regsNew->RFn_EDV = regsOld->RFn_EDV;
+    regsNew->RFn_RNDV = regsOld->RFn_RNDV;
+
+    if (phyObj->pllParams.chnMode != RF215_RFn_CNM_CM_IEEE)
+    {
+        /* RFn_CS not used in Fine Resolution Channel Scheme */
+        regsNew->RFn_CS = regsOld->RFn_CS;
+    }
+
+    if (phyObj->phyConfig.phyType == PHY_TYPE_OFDM)
+    {
+        /* Only OFDMPHRRX.SPC depends on PHY configuration */
+        regsNew->BBCn_OFDMPHRRX = (regsOld->BBCn_OFDMPHRRX & ((uint8_t) ~RF215_BBCn_OFDMPHRRX_SPC_EN)) |
+                (profile->regs.BBCn_OFDMPHRRX & RF215_BBCn_OFDMPHRRX_SPC_EN);
+    }
+
+    phyObj->pllParams.chnFreq = profile->chnFreq;
+    phyObj->turnaroundTimeUS = profile->turnaroundTimeUS;
+
+    lRF215_PLL_UpdateCNM(regsOld, regsNew);
+}
+#endif
+
 static void lRF215_PHY_SetFlag(uintptr_t context, void* pData, uint64_t timeRead)
 {
     bool* flag = (bool *) context;
@@ -2037,6 +2229,7 @@ static bool lRF215_PHY_BandOpModeToPhyCfg (
             *phyConfig = SUN_OFDM_BAND_920_923_OPT1;
             break;
 
+
         case SUN_OFDM_BAND_2450_OPT4:
             *phyConfig = SUN_OFDM_BAND_2400_2483_OPT4;
             break;
@@ -2053,6 +2246,7 @@ static bool lRF215_PHY_BandOpModeToPhyCfg (
             *phyConfig = SUN_OFDM_BAND_2400_2483_OPT1;
             break;
 
+
         default:
             result = false;
             break;
@@ -2088,6 +2282,201 @@ static inline int32_t lRF215_PHY_EventTrxCountDiff(void* pData)
     return (int32_t) trxCount - (int32_t) spiHeaderDuration;
 }
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+static DRV_RF215_CHN_OCCUPANCY_OBJ* lRF215_PHY_EdCacheEntry(uint8_t trxIdx, bool create)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* entry;
+    DRV_RF215_CHN_OCCUPANCY_OBJ* oldest;
+    uint64_t lastTime, oldestTime;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+    uint32_t chnFreq = pObj->pllParams.chnFreq;
+
+    oldest = &pObj->edCache[0];
+    oldestTime = UINT64_MAX;
+    for (uint8_t idx = 0U; idx < DRV_RF215_ED_CACHE_CHANNELS; idx++)
+    {
+        entry = &pObj->edCache[idx];
+        if (entry->chnFreq == chnFreq)
+        {
+            /* Channel found */
+            return entry;
+        }
+
+        /* Keep least recently updated entry (unused entries first) */
+        lastTime = 0U;
+        if (entry->chnFreq != 0U)
+        {
+            lastTime = entry->edTime;
+            if (entry->rxTime > lastTime)
+            {
+                lastTime = entry->rxTime;
+            }
+        }
+
+        if (lastTime < oldestTime)
+        {
+            oldestTime = lastTime;
+            oldest = entry;
+        }
+    }
+
+    if (create == false)
+    {
+        return NULL;
+    }
+
+    /* Replace least recently updated entry */
+    (void) memset(oldest, 0, sizeof(DRV_RF215_CHN_OCCUPANCY_OBJ));
+    oldest->chnFreq = chnFreq;
+    return oldest;
+}
+
+static void lRF215_PHY_EdCacheUpdate(uint8_t trxIdx, uint8_t edv, bool busy)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* entry;
+
+    if (edv == RF215_RFn_EDV_Rst)
+    {
+        /* No valid ED value */
+        return;
+    }
+
+    entry = lRF215_PHY_EdCacheEntry(trxIdx, true);
+    entry->edTime = SYS_TIME_Counter64Get();
+    entry->edDBm = (int8_t) edv;
+    entry->edCount++;
+    entry->edHistory = (uint8_t) (entry->edHistory << 1);
+    if (busy == true)
+    {
+        entry->edHistory |= 1U;
+        entry->edBusyCount++;
+    }
+
+    if (entry->edHistoryLen < 8U)
+    {
+        entry->edHistoryLen++;
+    }
+}
+
+static inline void lRF215_PHY_EdCacheRxFrame(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* rxInd)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* entry = lRF215_PHY_EdCacheEntry(trxIdx, true);
+
+    /* Channel occupied until the end of the received PPDU */
+    entry->rxTime = rxInd->timeIniCount + rxInd->ppduDurationCount;
+    entry->rxCount++;
+}
+
+static DRV_RF215_TX_RESULT lRF215_PHY_EdCacheCca(uint8_t trxIdx)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* entry;
+    uint64_t edAge;
+    uint16_t eddMinUS;
+    uint8_t srRxVal;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+    uint8_t idleMask = (uint8_t) ((1U << RF215_ED_CACHE_IDLE_HISTORY) - 1U);
+
+    entry = lRF215_PHY_EdCacheEntry(trxIdx, false);
+    if (entry == NULL)
+    {
+        /* No information of this channel: Full ED */
+        return RF215_TX_SUCCESS;
+    }
+
+    edAge = SYS_TIME_Counter64Get() - entry->edTime;
+    if ((entry->edHistoryLen == 0U) ||
+            (edAge >= (uint64_t) SYS_TIME_USToCount(DRV_RF215_ED_CACHE_VALID_US)))
+    {
+        /* Last ED too old: Full ED */
+        return RF215_TX_SUCCESS;
+    }
+
+    if ((entry->edHistory & 1U) != 0U)
+    {
+        /* Channel busy very recently: Report busy channel without CCA */
+        entry->ccaSkipped++;
+        return RF215_TX_BUSY_CHN;
+    }
+
+    if ((entry->edHistoryLen >= RF215_ED_CACHE_IDLE_HISTORY) &&
+            ((entry->edHistory & idleMask) == 0U) &&
+            (entry->rxTime <= entry->edTime) &&
+            (pObj->phyState != PHY_STATE_RX_HEADER))
+    {
+        /* Channel idle in the last measurements and no frame received since
+         * then. Reduce ED duration to AGC update time (2us resolution). */
+        srRxVal = (pObj->phyRegs.RFn_RXDFE & RF215_RFn_RXDFE_SR_Msk) >> RF215_RFn_RXDFE_SR_Pos;
+        eddMinUS = (((uint16_t) rf215AgcUpdTime0[srRxVal] + 1U) >> 1) << 1;
+        if (eddMinUS < pObj->txCcaEdDurationUS)
+        {
+            pObj->txCcaEdDurationUS = eddMinUS;
+            entry->ccaShortened++;
+        }
+    }
+
+    return RF215_TX_SUCCESS;
+}
+
+#if (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+static inline void lRF215_PHY_EdScanAbort(uint8_t trxIdx)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+
+    if (pObj->edScanInProgress == true)
+    {
+        /* ED aborted by leaving RX: Auto mode automatically restored */
+        pObj->phyRegs.RFn_EDC = RF215_RFn_EDC_EDM_AUTO;
+        pObj->edScanInProgress = false;
+    }
+}
+
+static void lRF215_PHY_EdScanReadEDV(uintptr_t context, void* pData, uint64_t timeRead)
+{
+    uint8_t trxIdx = (uint8_t) context;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+    int8_t edDBm = (int8_t) pObj->edCacheEDV;
+
+    /* Busy channel if ED value is above CCA threshold */
+    lRF215_PHY_EdCacheUpdate(trxIdx, pObj->edCacheEDV,
+            (edDBm >= pObj->phyConfig.ccaEdThresholdDBm));
+}
+
+static inline void lRF215_PHY_EdScanComplete(uint8_t trxIdx)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+
+    /* Read ED value and restore ED duration for automatic mode */
+    pObj->edScanInProgress = false;
+    RF215_HAL_SpiRead(RF215_RFn_EDV(trxIdx), &pObj->edCacheEDV, 1,
+            lRF215_PHY_EdScanReadEDV, (uintptr_t) trxIdx);
+    lRF215_RXFE_SetAutoEDD(trxIdx);
+}
+
+static void lRF215_PHY_EdScanTimeExpired(uintptr_t context)
+{
+    uint8_t trxIdx = (uint8_t) context;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+
+    /* Critical region to avoid conflicts with TX preparation */
+    RF215_HAL_EnterCritical();
+
+    /* Background ED only while listening, with baseband enabled */
+    if ((pObj->phyState == PHY_STATE_RX_LISTEN) &&
+            (pObj->trxState == RF215_RFn_STATE_RF_RX) &&
+            (pObj->txStarted == false) && (pObj->edScanInProgress == false))
+    {
+        pObj->edScanInProgress = true;
+        lRF215_RXFE_SetEnDetectDuration(trxIdx, pObj->phyConfig.ccaEdDurationUS);
+        pObj->phyRegs.RFn_EDC = RF215_RFn_EDC_EDM_SINGLE;
+        RF215_HAL_SpiWrite(RF215_RFn_EDC(trxIdx), &pObj->phyRegs.RFn_EDC, 1);
+    }
+
+    RF215_HAL_LeaveCritical();
+}
+
+#endif
+#endif
+
 static void lRF215_PHY_CheckAborts(uint8_t trxIdx, bool reset)
 {
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
@@ -2141,6 +2530,11 @@ static void lRF215_PHY_CheckAborts(uint8_t trxIdx, bool reset)
 
         /* MISRA C-2012 deviation block end */
     }
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    /* Background ED in progress aborted */
+    lRF215_PHY_EdScanAbort(trxIdx);
+#endif
 }
 
 static inline void lRF215_TRX_Command(uint8_t trxIdx, const uint8_t* pCommand)
@@ -2246,6 +2640,11 @@ static void lRF215_TRX_RxListen(uint8_t trxIdx)
     /* Update PHY state */
     pObj->phyState = PHY_STATE_RX_LISTEN;
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    /* Background ED in progress aborted by TXPREP command */
+    lRF215_PHY_EdScanAbort(trxIdx);
+#endif
+
     if (pObj->phyCfgPending == true)
     {
         /* Pending PHY configuration */
@@ -2708,8 +3107,18 @@ static inline void lRF215_TRX_ResetEvent(uint8_t trxIdx)
     if (pObj->txRequestPending == true)
     {
         /* Pending TX request because of TRX reset in progress */
-        (void) RF215_PHY_TxRequest(pObj->txBufObjPending);
+        DRV_RF215_TX_BUFFER_OBJ* txBufObj = pObj->txBufObjPending;
+        DRV_RF215_TX_RESULT txResult = RF215_PHY_TxRequest(txBufObj);
         pObj->txRequestPending = false;
+
+        if (txResult != RF215_TX_SUCCESS)
+        {
+            /* Set pending TX confirm with TX error (statistics already
+             * updated in TX request) */
+            txBufObj->cfmObj.ppduDurationCount = 0;
+            txBufObj->cfmObj.txResult = txResult;
+            txBufObj->cfmPending = true;
+        }
     }
 }
 
@@ -2730,6 +3139,9 @@ static DRV_RF215_PIB_RESULT lRF215_PHY_SetPhyConfig (
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
     DRV_RF215_PHY_CFG_OBJ* phyCfg = &pObj->phyConfig;
     const RF215_PLL_CONST_OBJ* pllConst = &rf215PllConst[trxIdx];
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+    RF215_PHY_PROFILE_OBJ* profile;
+#endif
 
     /* If channel 0, get first available channel */
     if (chnNumNew == 0U)
@@ -2833,10 +3245,25 @@ static DRV_RF215_PIB_RESULT lRF215_PHY_SetPhyConfig (
     pObj->pllParams = pllParamsNew;
     pObj->phyCfgPending = false;
 
-    /* Obtain new register values depending on PHY configuration */
-    lRF215_PLL_Regs(pObj, pllConst, &regsNew);
-    lRF215_BBC_Regs(pObj, &regsNew);
-    lRF215_TXRXFE_Regs(pObj, &regsNew);
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+    /* Get register values from the profile, if already resolved */
+    profile = lRF215_PHY_ProfileFind(trxIdx, phyCfgNew, chnNumNew);
+    if (profile != NULL)
+    {
+        lRF215_PHY_ProfileRegs(pObj, profile, &regsNew);
+    }
+    else
+#endif
+    {
+        /* Obtain new register values depending on PHY configuration */
+        lRF215_PLL_Regs(pObj, pllConst, &regsNew);
+        lRF215_BBC_Regs(pObj, &regsNew);
+        lRF215_TXRXFE_Regs(pObj, &regsNew);
+
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+        lRF215_PHY_ProfileStore(trxIdx, pObj, &regsNew);
+#endif
+    }
 
     /* MISRA C-2012 deviation block start */
     /* MISRA C-2012 Rule 18.1 deviated twice. Deviation record ID - H3_MISRAC_2012_R_18_1_DR_1 */
@@ -2866,7 +3293,8 @@ static DRV_RF215_PIB_RESULT lRF215_PHY_SetPhyConfig (
 
 /* MISRA C-2012 deviation block end */
 
-static uint32_t lRF215_TX_ContentionWindowUS (DRV_RF215_TX_BUFFER_OBJ* txBufObj)
+static uint32_t lRF215_TX_ContentionWindowUS (DRV_RF215_TX_BUFFER_OBJ* txBufObj,
+    uint16_t ccaEdDurationUS)
 {
     uint32_t contentionWindowUS;
     DRV_RF215_PHY_CCA_MODE ccaMode = txBufObj->reqObj.ccaMode;
@@ -2891,13 +3319,14 @@ static uint32_t lRF215_TX_ContentionWindowUS (DRV_RF215_TX_BUFFER_OBJ* txBufObj)
     if ((ccaMode == PHY_CCA_MODE_1) || (ccaMode == PHY_CCA_MODE_3))
     {
         /* CCA with energy detection: Add ED duration */
-        contentionWindowUS += ((uint32_t) pObj->phyConfig.ccaEdDurationUS * cw);
+        contentionWindowUS += ((uint32_t) ccaEdDurationUS * cw);
     }
 
     return contentionWindowUS;
 }
 
-static uint32_t lRF215_TX_CommandDelayUSq5(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
+static uint32_t lRF215_TX_CommandDelayUSq5(DRV_RF215_TX_BUFFER_OBJ* txBufObj,
+    uint16_t ccaEdDurationUS)
 {
     const RF215_FSK_SYM_RATE_CONST_OBJ* fskConst;
     DRV_RF215_OFDM_BW_OPT opt;
@@ -2915,7 +3344,7 @@ static uint32_t lRF215_TX_CommandDelayUSq5(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
         txCmdDelayUSq5 += RF215_RX_CCA_ED_TIME_US_Q5;
 
         /* Contention window length (incudes ED duration) */
-        txCmdDelayUSq5 += (lRF215_TX_ContentionWindowUS(txBufObj) << 5);
+        txCmdDelayUSq5 += (lRF215_TX_ContentionWindowUS(txBufObj, ccaEdDurationUS) << 5);
 
         if (txBufObj->reqObj.ccaContentionWindow <= 1U)
         {
@@ -3022,7 +3451,8 @@ static uint32_t lRF215_TX_TotalDelay(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
     DRV_RF215_PHY_CCA_MODE ccaMode = txBufObj->reqObj.ccaMode;
 
     /* Delay between next SPI command (TX/EDM_SINGLE) and TX start time */
-    txTotalDelayUSq5 = lRF215_TX_CommandDelayUSq5(txBufObj);
+    txTotalDelayUSq5 = lRF215_TX_CommandDelayUSq5(txBufObj,
+            rf215PhyObj[txBufObj->clientObj->trxIndex].phyConfig.ccaEdDurationUS);
 
     /* Add required time before next SPI command in the worst case:
      * TX parameters configuration (only before last command (TX/CCATX)).
@@ -3314,6 +3744,11 @@ static void lRF215_TX_ReadAMCS(uintptr_t context, void* pData, uint64_t timeRead
     *pAMCS &= (uint8_t) ~RF215_BBCn_AMCS_CCAED;
     pObj->txAutoInProgress = false;
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    /* Update channel occupancy cache with CCA result */
+    lRF215_PHY_EdCacheUpdate(trxIdx, pObj->edCacheEDV, ((amcs & RF215_BBCn_AMCS_CCAED) != 0U));
+#endif
+
     /* Energy Detection finished with CCATX enabled. Check CCAED status bit. */
     if ((amcs & RF215_BBCn_AMCS_CCAED) == 0U)
     {
@@ -3394,6 +3829,12 @@ static void lRF215_TX_ReadEDV(uintptr_t context, void* pData, uint64_t timeRead)
         return;
     }
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    /* Update channel occupancy cache */
+    lRF215_PHY_EdCacheUpdate(txBufObj->clientObj->trxIndex, (uint8_t) edv,
+            (edv > pObj->phyConfig.ccaEdThresholdDBm));
+
+#endif
     /* ED finished (without CCATX). Read RFn_EDV and compare with threshold. */
     if (edv > pObj->phyConfig.ccaEdThresholdDBm)
     {
@@ -3419,6 +3860,11 @@ static inline void lRF215_TX_EnDetectComplete(uint8_t trxIdx)
     {
         /* Energy Detection finished with CCATX enabled.
          * Read BBCn_AMCS to check busy/clear channel. */
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+        /* Read ED value for channel occupancy cache */
+        RF215_HAL_SpiRead(RF215_RFn_EDV(trxIdx), &pObj->edCacheEDV, 1, NULL, 0);
+
+#endif
         RF215_HAL_SpiRead(RF215_BBCn_AMCS(trxIdx), &phyRegs->BBCn_AMCS, 1,
             lRF215_TX_ReadAMCS, (uintptr_t) trxIdx);
     }
@@ -3516,7 +3962,7 @@ static void lRF215_TX_Prepare(uint8_t trxIdx)
          * Set ED Duration register.
          * Switch TRX to RX state for ED. */
         lRF215_BBC_BaseBandDisable(trxIdx);
-        lRF215_RXFE_SetEnDetectDuration(trxIdx, pObj->phyConfig.ccaEdDurationUS);
+        lRF215_RXFE_SetEnDetectDuration(trxIdx, pObj->txCcaEdDurationUS);
         lRF215_TRX_CommandRx(trxIdx);
         if (txBufObj->reqObj.ccaContentionWindow <= 1U)
         {
@@ -3633,10 +4079,24 @@ static DRV_RF215_TX_RESULT lRF215_TX_ParamCfg(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
         return result;
     }
 
+    /* ED duration for CCA */
+    pObj->txCcaEdDurationUS = pObj->phyConfig.ccaEdDurationUS;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    if ((ccaMode == PHY_CCA_MODE_1) || (ccaMode == PHY_CCA_MODE_3))
+    {
+        /* Recent channel occupancy can avoid or shorten ED */
+        result = lRF215_PHY_EdCacheCca(trxIdx);
+        if (result != RF215_TX_SUCCESS)
+        {
+            return result;
+        }
+    }
+#endif
+
     /* Everything OK. Set TX in progress */
     pObj->txStarted = true;
     pObj->txBufObj = txBufObj;
-    pObj->txCmdDelayUSq5 = lRF215_TX_CommandDelayUSq5(txBufObj);
+    pObj->txCmdDelayUSq5 = lRF215_TX_CommandDelayUSq5(txBufObj, pObj->txCcaEdDurationUS);
 
     if ((txBufObj->reqObj.ccaContentionWindow > 1U) &&
             ((ccaMode == PHY_CCA_MODE_1) || (ccaMode == PHY_CCA_MODE_3)))
@@ -3982,11 +4442,21 @@ static void lRF215_TX_PrepareTimeExpired(uintptr_t context)
     /* Critical region to avoid conflicts in PHY object data */
     RF215_HAL_EnterCritical();
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    if ((pObj->txSchedNum == 0U) || (pObj->txSchedQueue[0] != txBufObj))
+    {
+        /* Not the first TX in the queue (preempted by an earlier TX request
+         * while the timer was expiring): Timer will be started again */
+        RF215_HAL_LeaveCritical();
+        return;
+    }
+
+#endif
     if ((pObj->phyState == PHY_STATE_TX_CCA_ED) || (pObj->txPendingState == PHY_STATE_TX_CCA_ED))
     {
         /* CCA ED still in progress. New interrupt for later (ED duration) */
         txBufObj->timeHandle = SYS_TIME_CallbackRegisterUS(lRF215_TX_PrepareTimeExpired,
-                context, pObj->phyConfig.ccaEdDurationUS, SYS_TIME_SINGLE);
+                context, pObj->txCcaEdDurationUS, SYS_TIME_SINGLE);
 
         RF215_HAL_LeaveCritical();
         return;
@@ -4059,6 +4529,220 @@ static void lRF215_TX_PrepareTimeExpired(uintptr_t context)
     RF215_HAL_LeaveCritical();
 }
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+static bool lRF215_TX_SchedTimerStart(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
+{
+    uint64_t interruptTime;
+    SYS_TIME_HANDLE timeHandle;
+    bool intStatus;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[txBufObj->clientObj->trxIndex];
+
+    /* Time when we need the scheduled interrupt (worst case TX delay) */
+    interruptTime = txBufObj->reqObj.timeCount - lRF215_TX_TotalDelay(txBufObj);
+
+    /* Critical region to avoid delays in current time computations */
+    intStatus = SYS_INT_Disable();
+
+    if (interruptTime < SYS_TIME_Counter64Get())
+    {
+        /* Preparation time already passed (i.e. previous TX finished late) */
+        pObj->txSchedStats.txLateStart++;
+    }
+
+    /* Schedule timer for the specified time */
+    timeHandle = lRF215_TX_TimeSchedule(interruptTime, true,
+            lRF215_TX_PrepareTimeExpired, txBufObj->txHandle);
+    txBufObj->timeHandle = timeHandle;
+
+    /* Leave critical region */
+    SYS_INT_Restore(intStatus);
+
+    return (timeHandle != SYS_TIME_HANDLE_INVALID);
+}
+
+static DRV_RF215_TX_RESULT lRF215_TX_SchedInsert(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
+{
+    uint64_t txStart, txEnd;
+    uint16_t paySymbols;
+    uint8_t pos, idx;
+    bool intStatus;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[txBufObj->clientObj->trxIndex];
+    RF215_PHY_TX_SCHED_STATS* stats = &pObj->txSchedStats;
+    DRV_RF215_TX_RESULT result = RF215_TX_SUCCESS;
+
+    /* Channel is busy from TX time until end of PPDU plus turnaround time */
+    txStart = txBufObj->reqObj.timeCount;
+    txEnd = txStart + lRF215_PHY_PpduDuration(&pObj->phyConfig,
+            txBufObj->reqObj.modScheme, txBufObj->reqObj.psduLen, &paySymbols);
+    txEnd += SYS_TIME_USToCount(pObj->turnaroundTimeUS);
+    txBufObj->timeHandle = SYS_TIME_HANDLE_INVALID;
+
+    /* Critical region to avoid conflicts with TX confirms from interrupts */
+    intStatus = SYS_INT_Disable();
+
+    /* Look for position in the queue (ordered by TX time) */
+    pos = pObj->txSchedNum;
+    while ((pos > 0U) && (pObj->txSchedQueue[pos - 1U]->reqObj.timeCount > txStart))
+    {
+        pos--;
+    }
+
+    if (pObj->txSchedNum >= DRV_RF215_TX_BUFFERS_NUMBER)
+    {
+        result = RF215_TX_FULL_BUFFERS;
+    }
+    else if ((pos > 0U) && (pObj->txSchedEnd[pos - 1U] > txStart))
+    {
+        /* Overlap with previous TX */
+        result = RF215_TX_BUSY_TX;
+    }
+    else if ((pos < pObj->txSchedNum) && (txEnd > pObj->txSchedQueue[pos]->reqObj.timeCount))
+    {
+        /* Overlap with next TX */
+        result = RF215_TX_BUSY_TX;
+    }
+    else if ((pos == 0U) && (pObj->txSchedNum > 0U) &&
+            (pObj->txStarted == true) && (pObj->txBufObj == pObj->txSchedQueue[0]))
+    {
+        /* First TX in the queue is already in preparation: It can't be
+         * preempted by an earlier TX */
+        result = RF215_TX_BUSY_TX;
+    }
+    else if (pos == 0U)
+    {
+        /* New first TX in the queue: Start its timer */
+        if (lRF215_TX_SchedTimerStart(txBufObj) == false)
+        {
+            result = RF215_TX_TIMEOUT;
+        }
+        else if (pObj->txSchedNum > 0U)
+        {
+            /* Previous first TX waits in the queue without timer */
+            DRV_RF215_TX_BUFFER_OBJ* txBufObjNext = pObj->txSchedQueue[0];
+            (void) SYS_TIME_TimerDestroy(txBufObjNext->timeHandle);
+            txBufObjNext->timeHandle = SYS_TIME_HANDLE_INVALID;
+        }
+        else
+        {
+            /* Empty queue: Nothing else to do */
+        }
+    }
+    else
+    {
+        /* TX timer will be started when previous TX finishes */
+    }
+
+    if (result == RF215_TX_SUCCESS)
+    {
+        /* Insert TX in the queue */
+        for (idx = pObj->txSchedNum; idx > pos; idx--)
+        {
+            pObj->txSchedQueue[idx] = pObj->txSchedQueue[idx - 1U];
+            pObj->txSchedEnd[idx] = pObj->txSchedEnd[idx - 1U];
+        }
+
+        pObj->txSchedQueue[pos] = txBufObj;
+        pObj->txSchedEnd[pos] = txEnd;
+        pObj->txSchedNum++;
+
+        stats->txQueued++;
+        if (pObj->txSchedNum > stats->queueNumMax)
+        {
+            stats->queueNumMax = pObj->txSchedNum;
+        }
+    }
+    else if (result == RF215_TX_BUSY_TX)
+    {
+        stats->txConflict++;
+    }
+    else
+    {
+        /* Other errors only counted in PHY statistics */
+    }
+
+    /* Leave critical region */
+    SYS_INT_Restore(intStatus);
+
+    return result;
+}
+
+static void lRF215_TX_SchedRemove (
+    DRV_RF215_TX_BUFFER_OBJ* txBufObj,
+    DRV_RF215_TX_RESULT result
+)
+{
+    uint8_t pos, idx;
+    bool intStatus;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[txBufObj->clientObj->trxIndex];
+    RF215_PHY_TX_SCHED_STATS* stats = &pObj->txSchedStats;
+
+    /* Critical region to avoid conflicts with TX requests */
+    intStatus = SYS_INT_Disable();
+
+    for (pos = 0U; pos < pObj->txSchedNum; pos++)
+    {
+        if (pObj->txSchedQueue[pos] == txBufObj)
+        {
+            break;
+        }
+    }
+
+    if (pos == pObj->txSchedNum)
+    {
+        /* Not in the queue (confirm overwritten or already removed) */
+        SYS_INT_Restore(intStatus);
+        return;
+    }
+
+    switch (result)
+    {
+        case RF215_TX_BUSY_RX:
+        case RF215_TX_CANCEL_BY_RX:
+            stats->txAbortedByRx++;
+            break;
+
+        case RF215_TX_BUSY_CHN:
+            stats->txCcaBusy++;
+            break;
+
+        default:
+            break;
+    }
+
+    /* Remove TX from the queue */
+    pObj->txSchedNum--;
+    for (idx = pos; idx < pObj->txSchedNum; idx++)
+    {
+        pObj->txSchedQueue[idx] = pObj->txSchedQueue[idx + 1U];
+        pObj->txSchedEnd[idx] = pObj->txSchedEnd[idx + 1U];
+    }
+
+    /* If the first TX was removed, start timer of the next one. If it is too
+     * late for it, it is removed from the queue with timeout error. */
+    while ((pos == 0U) && (pObj->txSchedNum > 0U))
+    {
+        DRV_RF215_TX_BUFFER_OBJ* txBufObjNext = pObj->txSchedQueue[0];
+
+        if (lRF215_TX_SchedTimerStart(txBufObjNext) == true)
+        {
+            break;
+        }
+
+        pObj->txSchedNum--;
+        for (idx = 0U; idx < pObj->txSchedNum; idx++)
+        {
+            pObj->txSchedQueue[idx] = pObj->txSchedQueue[idx + 1U];
+            pObj->txSchedEnd[idx] = pObj->txSchedEnd[idx + 1U];
+        }
+
+        RF215_PHY_SetTxCfm(txBufObjNext, RF215_TX_TIMEOUT);
+    }
+
+    /* Leave critical region */
+    SYS_INT_Restore(intStatus);
+}
+
+#endif
 static void lRF215_RX_PsduEnd(uint8_t trxIdx, bool fcsOk)
 {
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
@@ -4188,6 +4872,7 @@ static void lRF215_RX_BuffLvlIntReadFBL(uintptr_t context, void* pData, uint64_t
     uint8_t trxIdx = (uint8_t) context;
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
     uint8_t* pFBL = (uint8_t *) pData;
+    uint16_t offset = pObj->rxBufferOffset;
 
     if (pObj->phyState != PHY_STATE_RX_PAYLOAD)
     {
@@ -4200,15 +4885,24 @@ static void lRF215_RX_BuffLvlIntReadFBL(uintptr_t context, void* pData, uint64_t
     bufLevel = pFBL[0];
     bufLevel += ((uint16_t) pFBL[1] << 8);
 
-    if ((bufLevel == 0U) || (bufLevel > pObj->rxInd.psduLen))
+    if ((bufLevel <= offset) || (bufLevel > pObj->rxInd.psduLen))
     {
         /* Invalid buffer level */
         return;
     }
 
-    /* Read PSDU bytes already stored in RX Frame Buffer */
-    RF215_HAL_SpiRead(RF215_BBCn_FBRXS(trxIdx), pObj->rxPsdu, bufLevel, NULL, 0U);
+    /* Read PSDU bytes stored in RX Frame Buffer and not read yet */
+    RF215_HAL_SpiRead(RF215_BBCn_FBRXS(trxIdx) + offset, &pObj->rxPsdu[offset],
+            bufLevel - offset, NULL, 0U);
     pObj->rxBufferOffset = bufLevel;
+
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+    /* Program FBLI interrupt for next chunk, if it comes before RXFE */
+    if (((uint32_t) bufLevel + pObj->rxStreamChunk) <= pObj->rxStreamLimit)
+    {
+        lRF215_BBC_SetFBLI(trxIdx, bufLevel + pObj->rxStreamChunk - 1U);
+    }
+#endif
 }
 
 static inline void lRF215_RX_BuffLvlInt(uint8_t trxIdx)
@@ -4319,6 +5013,15 @@ static void lRF215_RX_ReadPHR(uintptr_t context, void* pData, uint64_t timeRead)
              * read less bytes as possible in RXFE interrupt, depending on the
              * RF frame parameters and SPI interface */
             uint16_t fbli = lRF215_BBC_GetBestFBLI(phyCfg, modScheme, psduLen);
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+            /* RX streaming: First FBLI interrupt after the first chunk, if it
+             * comes earlier than the FBLI computed for one read */
+            lRF215_BBC_GetStreamParams(pObj, modScheme, psduLen);
+            if ((pObj->rxStreamChunk <= pObj->rxStreamLimit) && (pObj->rxStreamChunk <= fbli))
+            {
+                fbli = pObj->rxStreamChunk - 1U;
+            }
+#endif
             lRF215_BBC_SetFBLI(trxIdx, fbli);
         }
 
@@ -4450,6 +5153,10 @@ bool RF215_PHY_Initialize (
     pObj->rxPaySymbols = 0;
     pObj->txPaySymbols = 0;
     pObj->rxFlagsPending = 0;
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+    pObj->rxStreamChunk = 0;
+    pObj->rxStreamLimit = 0;
+#endif
     pObj->trxRdy = false;
     pObj->rxIndPending = false;
     pObj->txfePending = false;
@@ -4465,6 +5172,24 @@ bool RF215_PHY_Initialize (
     pObj->txCancelPending = false;
     pObj->txRequestPending = false;
     pObj->resetInProgress = false;
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    (void) memset(&pObj->txSchedStats, 0, sizeof(pObj->txSchedStats));
+    pObj->txSchedNum = 0U;
+#endif
+    pObj->txCcaEdDurationUS = phyConfig.ccaEdDurationUS;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    (void) memset(pObj->edCache, 0, sizeof(pObj->edCache));
+#if (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    pObj->edScanTimeHandle = SYS_TIME_HANDLE_INVALID;
+    pObj->edScanInProgress = false;
+#endif
+#endif
+
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+    /* No PHY configuration profiles resolved yet */
+    (void) memset(rf215PhyProfiles[trxIdx], 0, sizeof(rf215PhyProfiles[trxIdx]));
+    rf215PhyProfileNext[trxIdx] = 0U;
+#endif
 
     if (lRF215_PHY_CheckPhyCfg(&phyConfig) == false)
     {
@@ -4484,6 +5209,16 @@ void RF215_PHY_Tasks(uint8_t trxIdx)
     bool reportInd = false;
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    /* Start background channel scan once the TRX is ready */
+    if ((pObj->edScanTimeHandle == SYS_TIME_HANDLE_INVALID) &&
+            (pObj->phyState != PHY_STATE_RESET))
+    {
+        pObj->edScanTimeHandle = SYS_TIME_CallbackRegisterUS(lRF215_PHY_EdScanTimeExpired,
+                (uintptr_t) trxIdx, DRV_RF215_ED_SCAN_PERIOD_US, SYS_TIME_PERIODIC);
+    }
+
+#endif
     /* Check if there is receive indication pending */
     if (pObj->rxIndPending == true)
     {
@@ -4498,6 +5233,9 @@ void RF215_PHY_Tasks(uint8_t trxIdx)
             (void) memcpy(rf215PhyRxPsdu, pObj->rxPsdu, pObj->rxInd.psduLen);
             pObj->rxIndPending = false;
             reportInd = true;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+            lRF215_PHY_EdCacheRxFrame(trxIdx, &pObj->rxInd);
+#endif
         }
 
         /* Leave critical region. RX indication ready to be notified */
@@ -4552,6 +5290,17 @@ void RF215_PHY_ExtIntEvent(uint8_t trxIdx, uint8_t rfIRQS, uint8_t bbcIRQS)
                 pObj->txfePending = false;
             }
         }
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+        else if (pObj->edScanInProgress == true)
+        {
+            /* Background ED finished */
+            lRF215_PHY_EdScanComplete(trxIdx);
+        }
+        else
+        {
+            /* Nothing to do */
+        }
+#endif
     }
 
     /* Check Transmitter Frame End interrupt */
@@ -4788,13 +5537,23 @@ DRV_RF215_TX_RESULT RF215_PHY_TxRequest(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
         }
     }
 
+
+    if ((result == RF215_TX_SUCCESS) && (pObj->resetInProgress == true) &&
+            (pObj->txRequestPending == true))
+    {
+        /* Error: Another TX request is waiting for TRX reset to finish */
+        result = RF215_TX_BUSY_TX;
+    }
+
     if (result == RF215_TX_SUCCESS)
     {
-        uint64_t interruptTime;
         uint32_t txTotalDelay;
+        uint64_t txTime = txBufObj->reqObj.timeCount;
+#if (DRV_RF215_TX_SCHEDULE_ENABLE == 0U)
+        uint64_t interruptTime;
         SYS_TIME_HANDLE timeHandle;
         bool intStatus;
-        uint64_t txTime = txBufObj->reqObj.timeCount;
+#endif
 
         if (pObj->resetInProgress == true)
         {
@@ -4823,6 +5582,10 @@ DRV_RF215_TX_RESULT RF215_PHY_TxRequest(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
         /* Update TX initial time in confirm object */
         txBufObj->cfmObj.timeIniCount = txTime;
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+        /* Insert in TX scheduling queue (timer started if it is the first) */
+        result = lRF215_TX_SchedInsert(txBufObj);
+#else
         /* Time when we need the scheduled interrupt */
         interruptTime = txTime - txTotalDelay;
 
@@ -4846,6 +5609,7 @@ DRV_RF215_TX_RESULT RF215_PHY_TxRequest(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
 
         /* Leave critical region */
         SYS_INT_Restore(intStatus);
+#endif
     }
 
     if (result != RF215_TX_SUCCESS)
@@ -4920,6 +5684,11 @@ void RF215_PHY_SetTxCfm (
         pObj->txStarted = false;
         pObj->txPendingState = PHY_STATE_RESET;
     }
+
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    /* Remove from TX scheduling queue and start timer of next TX */
+    lRF215_TX_SchedRemove(txBufObj, result);
+#endif
 }
 
 bool RF215_PHY_CheckTxContentionWindow(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
@@ -4936,7 +5705,8 @@ bool RF215_PHY_CheckTxContentionWindow(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
     /* Compute contention window duration and convert to SYS_TIME count.
      * Convert RX PPDU duration to SYS_TIME count.
      * Compare end of received frame with start of contention window. */
-    cwDurationUS = lRF215_TX_ContentionWindowUS(txBufObj);
+    cwDurationUS = lRF215_TX_ContentionWindowUS(txBufObj,
+        pObj->phyConfig.ccaEdDurationUS);
     cwDuration = SYS_TIME_USToCount(cwDurationUS);
     if ((pObj->rxInd.timeIniCount + pObj->rxInd.ppduDurationCount) >= (txBufObj->reqObj.timeCount - cwDuration))
     {
@@ -4948,6 +5718,27 @@ bool RF215_PHY_CheckTxContentionWindow(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
     return false;
 }
 
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+void RF215_PHY_GetTxSchedStats (
+    uint8_t trxIndex,
+    RF215_PHY_TX_SCHED_STATS* stats,
+    bool reset
+)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIndex];
+    bool intStatus = SYS_INT_Disable();
+
+    *stats = pObj->txSchedStats;
+    if (reset == true)
+    {
+        (void) memset(&pObj->txSchedStats, 0, sizeof(pObj->txSchedStats));
+    }
+
+    SYS_INT_Restore(intStatus);
+}
+
+#endif
+
 DRV_RF215_PIB_RESULT RF215_PHY_GetPib (
     uint8_t trxIndex,
     DRV_RF215_PIB_ATTRIBUTE attr,
@@ -4956,6 +5747,10 @@ DRV_RF215_PIB_RESULT RF215_PHY_GetPib (
 {
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIndex];
     DRV_RF215_PIB_RESULT result = RF215_PIB_RESULT_SUCCESS;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    DRV_RF215_CHN_OCCUPANCY_OBJ* entry;
+    bool intStatus;
+#endif
 
     switch (attr)
     {
@@ -4979,6 +5774,25 @@ DRV_RF215_PIB_RESULT RF215_PHY_GetPib (
             *((uint32_t *) value) = pObj->pllParams.chnFreq;
             break;
 
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+        case RF215_PIB_PHY_CHANNEL_OCCUPANCY:
+            /* Occupancy of channel in use (zero if there is no information) */
+            intStatus = SYS_INT_Disable();
+            entry = lRF215_PHY_EdCacheEntry(trxIndex, false);
+            if (entry != NULL)
+            {
+                (void) memcpy(value, (void *) entry, sizeof(DRV_RF215_CHN_OCCUPANCY_OBJ));
+            }
+            else
+            {
+                (void) memset(value, 0, sizeof(DRV_RF215_CHN_OCCUPANCY_OBJ));
+            }
+
+            SYS_INT_Restore(intStatus);
+            break;
+
+#endif
+
         case RF215_PIB_PHY_CCA_ED_DURATION_US:
             *((uint16_t *) value) = pObj->phyConfig.ccaEdDurationUS;
             break;
@@ -5284,6 +6098,78 @@ DRV_RF215_PIB_RESULT RF215_PHY_SetPib (
     return result;
 }
 
+DRV_RF215_PIB_RESULT RF215_PHY_ProfileLoad (
+    uint8_t trxIndex,
+    DRV_RF215_PHY_BAND_OPM bandOpMode,
+    uint16_t channelNum
+)
+{
+    DRV_RF215_PHY_CFG_OBJ phyCfgNew;
+    RF215_PLL_PARAMS_OBJ pllParamsNew;
+    const RF215_PLL_CONST_OBJ* pllConst = &rf215PllConst[trxIndex];
+
+    /* Convert frequency band and operating mode to PHY configuration object */
+    if (lRF215_PHY_BandOpModeToPhyCfg(bandOpMode, &phyCfgNew) == false)
+    {
+        return RF215_PIB_RESULT_INVALID_PARAM;
+    }
+
+    /* If channel 0, get first available channel */
+    if (channelNum == 0U)
+    {
+        channelNum = phyCfgNew.chnNumMin;
+    }
+
+    /* Check correct PHY and channel configuration */
+    if (lRF215_PHY_CheckPhyCfg(&phyCfgNew) == false)
+    {
+        return RF215_PIB_RESULT_INVALID_PARAM;
+    }
+
+    lRF215_PLL_Params(pllConst, &pllParamsNew, &phyCfgNew, channelNum);
+    if (lRF215_PLL_CheckConfig(pllConst, &pllParamsNew, &phyCfgNew, channelNum) == false)
+    {
+        return RF215_PIB_RESULT_INVALID_PARAM;
+    }
+
+#if (DRV_RF215_PHY_PROFILES_NUMBER > 0U)
+    /* Critical region to avoid conflicts in PHY object data */
+    RF215_HAL_EnterCritical();
+
+    if (lRF215_PHY_ProfileFind(trxIndex, &phyCfgNew, channelNum) == NULL)
+    {
+        RF215_PHY_REGS_OBJ regsNew = {0};
+        RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIndex];
+        DRV_RF215_PHY_CFG_OBJ phyCfgOld = pObj->phyConfig;
+        RF215_PLL_PARAMS_OBJ pllParamsOld = pObj->pllParams;
+        RF215_PHY_REGS_OBJ phyRegsOld = pObj->phyRegs;
+        uint16_t chnNumOld = pObj->channelNum;
+        uint16_t turnaroundTimeOld = pObj->turnaroundTimeUS;
+
+        /* Resolve the registers with the new configuration in the PHY object.
+         * Nothing is written to the device. */
+        pObj->phyConfig = phyCfgNew;
+        pObj->pllParams = pllParamsNew;
+        pObj->channelNum = channelNum;
+        lRF215_PLL_Regs(pObj, pllConst, &regsNew);
+        lRF215_BBC_Regs(pObj, &regsNew);
+        lRF215_TXRXFE_Regs(pObj, &regsNew);
+        lRF215_PHY_ProfileStore(trxIndex, pObj, &regsNew);
+
+        /* Restore PHY object */
+        pObj->phyConfig = phyCfgOld;
+        pObj->pllParams = pllParamsOld;
+        pObj->phyRegs = phyRegsOld;
+        pObj->channelNum = chnNumOld;
+        pObj->turnaroundTimeUS = turnaroundTimeOld;
+    }
+
+    RF215_HAL_LeaveCritical();
+#endif
+
+    return RF215_PIB_RESULT_SUCCESS;
+}
+
 void RF215_PHY_Reset(uint8_t trxIndex)
 {
     RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIndex];
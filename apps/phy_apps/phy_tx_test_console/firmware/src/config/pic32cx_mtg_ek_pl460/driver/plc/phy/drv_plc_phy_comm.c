@@ -70,6 +70,14 @@ static CACHE_ALIGN uint8_t sDataRxDat[CACHE_ALIGNED_SIZE_GET(PLC_DATA_PKT_SIZE)]
 static CACHE_ALIGN uint8_t sDataTxCfm[CACHE_ALIGNED_SIZE_GET(PLC_CMF_PKT_SIZE)];
 static CACHE_ALIGN uint8_t sDataReg[CACHE_ALIGNED_SIZE_GET(PLC_REG_PKT_SIZE)];
 
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+/* Transmission requests waiting for the PLC transmitter to be free */
+static DRV_PLC_PHY_TX_QUEUE_OBJ sTxQueue[DRV_PLC_PHY_TX_QUEUE_SIZE];
+
+/* Transmission confirms pending to be reported to upper layer */
+static DRV_PLC_PHY_TRANSMISSION_CFM_OBJ sTxCfmQueue[DRV_PLC_PHY_TX_CFM_QUEUE_SIZE];
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File scope functions
@@ -256,6 +264,40 @@ static void lDRV_PLC_PHY_COMM_RxEvent(DRV_PLC_PHY_RECEPTION_OBJ *pRxObj)
     pRxObj->pReceivedData = sDataRxDat;
 }
 
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+static uint8_t lDRV_PLC_PHY_COMM_TxCfmCount(void)
+{
+    return (uint8_t)((gPlcPhyObj->txCfmIn + DRV_PLC_PHY_TX_CFM_QUEUE_SIZE - gPlcPhyObj->txCfmOut) %
+            DRV_PLC_PHY_TX_CFM_QUEUE_SIZE);
+}
+
+static void lDRV_PLC_PHY_COMM_TxCfmPush(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ *pCfmObj)
+{
+    if (lDRV_PLC_PHY_COMM_TxCfmCount() < (DRV_PLC_PHY_TX_CFM_QUEUE_SIZE - 1U))
+    {
+        sTxCfmQueue[gPlcPhyObj->txCfmIn] = *pCfmObj;
+        gPlcPhyObj->txCfmIn = (uint8_t)((gPlcPhyObj->txCfmIn + 1U) % DRV_PLC_PHY_TX_CFM_QUEUE_SIZE);
+    }
+}
+
+static void lDRV_PLC_PHY_COMM_TxQueueFlush(void)
+{
+    DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+
+    cfmObj.rmsCalc = 0;
+    cfmObj.timeEnd = 0;
+    cfmObj.result = DRV_PLC_PHY_TX_RESULT_NO_TX;
+
+    /* Queued transmissions are reported as not transmitted */
+    while (gPlcPhyObj->txQueueNum > 0U)
+    {
+        lDRV_PLC_PHY_COMM_TxCfmPush(&cfmObj);
+        gPlcPhyObj->txQueueFirst = (uint8_t)((gPlcPhyObj->txQueueFirst + 1U) % DRV_PLC_PHY_TX_QUEUE_SIZE);
+        gPlcPhyObj->txQueueNum--;
+    }
+}
+#endif
+
 static bool lDRV_PLC_PHY_COMM_CheckComm(DRV_PLC_HAL_INFO *info)
 {
     if (info->key == DRV_PLC_HAL_KEY_CORTEX)
@@ -289,10 +331,26 @@ static bool lDRV_PLC_PHY_COMM_CheckComm(DRV_PLC_HAL_INFO *info)
         }
 
         /* Check if there is any tx_cfm pending to be reported */
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+        if (gPlcPhyObj->state[0] != DRV_PLC_PHY_STATE_IDLE)
+        {
+            DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+
+            cfmObj.rmsCalc = 0;
+            cfmObj.timeEnd = 0;
+            cfmObj.result = DRV_PLC_PHY_TX_RESULT_NO_TX;
+            lDRV_PLC_PHY_COMM_TxCfmPush(&cfmObj);
+            gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_IDLE;
+        }
+
+        /* Queued transmissions are lost after PLC reset */
+        lDRV_PLC_PHY_COMM_TxQueueFlush();
+#else
         if (gPlcPhyObj->state[0] == DRV_PLC_PHY_STATE_WAITING_TX_CFM)
         {
             gPlcPhyObj->evResetTxCfm = true;
         }
+#endif
 
         return true;
     }
@@ -431,6 +489,182 @@ static void lDRV_PLC_PHY_COMM_GetEventsInfo(DRV_PLC_PHY_EVENTS_OBJ *eventsObj)
     eventsObj->regRspLength += ((uint16_t)*pData++) << 8;
 }
 
+static void lDRV_PLC_PHY_COMM_EventsHandler(void)
+{
+    DRV_PLC_PHY_EVENTS_OBJ evObj;
+
+    /* Get PLC events information */
+    lDRV_PLC_PHY_COMM_GetEventsInfo(&evObj);
+
+    /* Check confirmation of the transmission event */
+    if (evObj.evCfm)
+    {
+        lDRV_PLC_PHY_COMM_SpiReadCmd(TX_CFM_ID, sDataTxCfm, (uint16_t)PLC_CMF_PKT_SIZE);
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+        {
+            DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+
+            /* Store confirm: next queued transmission may complete before Task runs */
+            lDRV_PLC_PHY_COMM_TxCfmEvent(&cfmObj);
+            lDRV_PLC_PHY_COMM_TxCfmPush(&cfmObj);
+        }
+#else
+        /* update event flag */
+        gPlcPhyObj->evTxCfm[0] = true;
+#endif
+        /* Update PLC state: idle */
+        gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_IDLE;
+    }
+
+    /* Check received new data event (First event in RX) */
+    if (evObj.evRxDat)
+    {
+        lDRV_PLC_PHY_COMM_SpiReadCmd(RX_DAT_ID, sDataRxDat, evObj.rcvDataLength);
+        /* update event flag */
+        gPlcPhyObj->evRxDat = true;
+    }
+
+    /* Check received new parameters event (Second event in RX) */
+    if (evObj.evRxPar)
+    {
+        lDRV_PLC_PHY_COMM_SpiReadCmd(RX_PAR_ID, sDataRxPar, (uint16_t)PLC_RX_PAR_SIZE - 4U);
+        /* update event flag */
+        gPlcPhyObj->evRxPar = true;
+    }
+
+    /* Check register info event */
+    if (evObj.evReg)
+    {
+        lDRV_PLC_PHY_COMM_SpiReadCmd(REG_INFO_ID, sDataReg, evObj.regRspLength);
+        /* update event flag */
+        gPlcPhyObj->evRegRspLength = evObj.regRspLength;
+    }
+}
+
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+static bool lDRV_PLC_PHY_COMM_TxQueuePut(DRV_PLC_PHY_TRANSMISSION_OBJ *transmitObj)
+{
+    DRV_PLC_PHY_TX_QUEUE_OBJ *txQueueObj;
+    DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+    uint8_t pendingNum;
+    bool txBusy;
+    bool queued = false;
+    bool rejected = false;
+
+    /* Disable external interrupt from PLC */
+    gPlcPhyObj->plcHal->enableExtInt(false);
+
+    /* Queued transmissions go first, even if the PLC transmitter is free */
+    txBusy = (gPlcPhyObj->state[0] != DRV_PLC_PHY_STATE_IDLE) || (gPlcPhyObj->txQueueNum > 0U);
+
+    if ((transmitObj->mode & TX_MODE_CANCEL) != 0U)
+    {
+        /* Cancel also applies to queued transmissions */
+        lDRV_PLC_PHY_COMM_TxQueueFlush();
+    }
+    else
+    {
+        /* Every accepted transmission needs a free slot in the confirm queue */
+        pendingNum = gPlcPhyObj->txQueueNum + lDRV_PLC_PHY_COMM_TxCfmCount();
+        if (txBusy)
+        {
+            pendingNum++;
+        }
+
+        if (pendingNum > DRV_PLC_PHY_TX_QUEUE_SIZE)
+        {
+            cfmObj.result = DRV_PLC_PHY_TX_RESULT_NO_TX;
+            rejected = true;
+        }
+        else if (txBusy)
+        {
+            if (transmitObj->dataLength > PLC_DATA_PKT_SIZE)
+            {
+                cfmObj.result = DRV_PLC_PHY_TX_RESULT_INV_LENGTH;
+                rejected = true;
+            }
+            else
+            {
+                /* Store request. It is sent when the current transmission is confirmed */
+                txQueueObj = &sTxQueue[(gPlcPhyObj->txQueueFirst + gPlcPhyObj->txQueueNum) % DRV_PLC_PHY_TX_QUEUE_SIZE];
+                txQueueObj->txParLength = (uint16_t)lDRV_PLC_PHY_COMM_TxStringify(transmitObj);
+                (void) memcpy(txQueueObj->txPar, sDataTxPar, txQueueObj->txParLength);
+                (void) memcpy(txQueueObj->txData, transmitObj->pTransmitData, transmitObj->dataLength);
+                txQueueObj->dataLength = transmitObj->dataLength;
+                gPlcPhyObj->txQueueNum++;
+                queued = true;
+            }
+        }
+        else
+        {
+            /* PLC transmitter is free: send request right away */
+        }
+    }
+
+    /* Enable external interrupt from PLC */
+    gPlcPhyObj->plcHal->enableExtInt(true);
+
+    if (rejected && (gPlcPhyObj->txCfmCallback != NULL))
+    {
+        cfmObj.rmsCalc = 0;
+        cfmObj.timeEnd = 0;
+        /* Report to upper layer */
+        gPlcPhyObj->txCfmCallback(&cfmObj, gPlcPhyObj->contextCfm);
+    }
+
+    return (queued || rejected);
+}
+
+static void lDRV_PLC_PHY_COMM_TxQueueLaunch(void)
+{
+    DRV_PLC_PHY_TX_QUEUE_OBJ *txQueueObj = NULL;
+
+    /* Disable external interrupt from PLC */
+    gPlcPhyObj->plcHal->enableExtInt(false);
+
+    if ((gPlcPhyObj->state[0] == DRV_PLC_PHY_STATE_IDLE) && (gPlcPhyObj->txQueueNum > 0U))
+    {
+        /* Release queue slot. Its content is kept until next TX request */
+        txQueueObj = &sTxQueue[gPlcPhyObj->txQueueFirst];
+        gPlcPhyObj->txQueueFirst = (uint8_t)((gPlcPhyObj->txQueueFirst + 1U) % DRV_PLC_PHY_TX_QUEUE_SIZE);
+        gPlcPhyObj->txQueueNum--;
+
+        /* Update PLC state: transmitting */
+        gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_TX;
+    }
+
+    /* Enable external interrupt from PLC */
+    gPlcPhyObj->plcHal->enableExtInt(true);
+
+    if (txQueueObj == NULL)
+    {
+        return;
+    }
+
+    /* Send TX parameters */
+    lDRV_PLC_PHY_COMM_SpiWriteCmd(TX_PAR_ID, txQueueObj->txPar, txQueueObj->txParLength);
+
+    /* Waiting CFM to avoid soon error responses */
+    gPlcPhyObj->plcHal->delay(200);
+
+    /* Send TX data */
+    if (gPlcPhyObj->state[0] == DRV_PLC_PHY_STATE_TX)
+    {
+        /* Update PLC state: waiting confirmation. Updated before sending
+         * data so that a PLC reset detected while sending is reported */
+        gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_WAITING_TX_CFM;
+
+        /* Send TX data content */
+        lDRV_PLC_PHY_COMM_SpiWriteCmd(TX_DAT_ID, txQueueObj->txData, txQueueObj->dataLength);
+    }
+    else
+    {
+        /* Time guard */
+        gPlcPhyObj->plcHal->delay(20);
+    }
+}
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: DRV_PLC_PHY Common Interface Implementation
@@ -447,12 +681,37 @@ void DRV_PLC_PHY_Init(DRV_PLC_PHY_OBJ *plcPhyObj)
     gPlcPhyObj->evRegRspLength = 0;
     gPlcPhyObj->evResetTxCfm = false;
 
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+    /* Queued transmissions are lost after PLC boot */
+    lDRV_PLC_PHY_COMM_TxQueueFlush();
+#endif
+
     /* Enable external interrupt from PLC */
     gPlcPhyObj->plcHal->enableExtInt(true);
 }
 
 void DRV_PLC_PHY_Task(void)
 {
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+    /* Send next queued transmission once the previous one is confirmed.
+     * Sent from here and not from the interrupt, as the direct path. */
+    lDRV_PLC_PHY_COMM_TxQueueLaunch();
+
+    /* Report stored confirms */
+    while (gPlcPhyObj->txCfmOut != gPlcPhyObj->txCfmIn)
+    {
+        DRV_PLC_PHY_TRANSMISSION_CFM_OBJ cfmObj;
+
+        cfmObj = sTxCfmQueue[gPlcPhyObj->txCfmOut];
+        gPlcPhyObj->txCfmOut = (uint8_t)((gPlcPhyObj->txCfmOut + 1U) % DRV_PLC_PHY_TX_CFM_QUEUE_SIZE);
+
+        if (gPlcPhyObj->txCfmCallback != NULL)
+        {
+            /* Report to upper layer */
+            gPlcPhyObj->txCfmCallback(&cfmObj, gPlcPhyObj->contextCfm);
+        }
+    }
+#else
     /* Check event flags */
     if ((gPlcPhyObj->evTxCfm[0]) || (gPlcPhyObj->evResetTxCfm))
     {
@@ -479,6 +738,7 @@ void DRV_PLC_PHY_Task(void)
             gPlcPhyObj->txCfmCallback(&cfmObj, gPlcPhyObj->contextCfm);
         }
     }
+#endif
 
     if (gPlcPhyObj->evRxPar && gPlcPhyObj->evRxDat)
     {
@@ -516,6 +776,17 @@ void DRV_PLC_PHY_TxRequest(const DRV_HANDLE handle, DRV_PLC_PHY_TRANSMISSION_OBJ
         return;
     }
 
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+    if ((handle != DRV_HANDLE_INVALID) && (handle == 0U))
+    {
+        /* Queue request if PLC transmitter is busy */
+        if (lDRV_PLC_PHY_COMM_TxQueuePut(transmitObj))
+        {
+            return;
+        }
+    }
+
+#endif
     if((handle != DRV_HANDLE_INVALID) && (handle == 0U) &&
             ((gPlcPhyObj->state[0] == DRV_PLC_PHY_STATE_IDLE) || ((transmitObj->mode & TX_MODE_CANCEL) != 0U)))
     {
@@ -540,11 +811,12 @@ void DRV_PLC_PHY_TxRequest(const DRV_HANDLE handle, DRV_PLC_PHY_TRANSMISSION_OBJ
             /* Send TX data */
             if (gPlcPhyObj->state[0] == DRV_PLC_PHY_STATE_TX)
             {
+                /* Update PLC state: waiting confirmation. Updated before sending
+                 * data so that a PLC reset detected while sending is reported */
+                gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_WAITING_TX_CFM;
+
                 /* Send TX data content */
                 lDRV_PLC_PHY_COMM_SpiWriteCmd(TX_DAT_ID, transmitObj->pTransmitData, transmitObj->dataLength);
-
-                /* Update PLC state: waiting confirmation */
-                gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_WAITING_TX_CFM;
             }
             else
             {
@@ -778,47 +1050,11 @@ void DRV_PLC_PHY_ExternalInterruptHandler(PIO_PIN pin, uintptr_t context)
 
     if ((gPlcPhyObj != NULL) && (pin == (PIO_PIN)gPlcPhyObj->plcHal->plcPlib->extIntPin))
     {
-        DRV_PLC_PHY_EVENTS_OBJ evObj;
-
         /* Time guard */
         gPlcPhyObj->plcHal->delay(20);
 
-        /* Get PLC events information */
-        lDRV_PLC_PHY_COMM_GetEventsInfo(&evObj);
-
-        /* Check confirmation of the transmission event */
-        if (evObj.evCfm)
-        {
-            lDRV_PLC_PHY_COMM_SpiReadCmd(TX_CFM_ID, sDataTxCfm, (uint16_t)PLC_CMF_PKT_SIZE);
-            /* update event flag */
-            gPlcPhyObj->evTxCfm[0] = true;
-            /* Update PLC state: idle */
-            gPlcPhyObj->state[0] = DRV_PLC_PHY_STATE_IDLE;
-        }
-
-        /* Check received new data event (First event in RX) */
-        if (evObj.evRxDat)
-        {
-            lDRV_PLC_PHY_COMM_SpiReadCmd(RX_DAT_ID, sDataRxDat, evObj.rcvDataLength);
-            /* update event flag */
-            gPlcPhyObj->evRxDat = true;
-        }
-
-        /* Check received new parameters event (Second event in RX) */
-        if (evObj.evRxPar)
-        {
-            lDRV_PLC_PHY_COMM_SpiReadCmd(RX_PAR_ID, sDataRxPar, (uint16_t)PLC_RX_PAR_SIZE - 4U);
-            /* update event flag */
-            gPlcPhyObj->evRxPar = true;
-        }
-
-        /* Check register info event */
-        if (evObj.evReg)
-        {
-            lDRV_PLC_PHY_COMM_SpiReadCmd(REG_INFO_ID, sDataReg, evObj.regRspLength);
-            /* update event flag */
-            gPlcPhyObj->evRegRspLength = evObj.regRspLength;
-        }
+        /* Get and handle PLC events */
+        lDRV_PLC_PHY_COMM_EventsHandler();
 
         /* Time guard */
         gPlcPhyObj->plcHal->delay(20);
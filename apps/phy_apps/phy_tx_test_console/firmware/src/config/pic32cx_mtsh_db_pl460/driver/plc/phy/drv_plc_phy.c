@@ -98,6 +98,12 @@ SYS_MODULE_OBJ DRV_PLC_PHY_Initialize(
     gDrvPlcPhyObj.binStartAddress       = plcPhyInit->binStartAddress;
     gDrvPlcPhyObj.secure                = plcPhyInit->secure;
 
+    /* TX queue initialization */
+    gDrvPlcPhyObj.txQueueFirst          = 0;
+    gDrvPlcPhyObj.txQueueNum            = 0;
+    gDrvPlcPhyObj.txCfmIn               = 0;
+    gDrvPlcPhyObj.txCfmOut              = 0;
+
     /* Callbacks initialization */
     gDrvPlcPhyObj.txCfmCallback         = NULL;
     gDrvPlcPhyObj.dataIndCallback       = NULL;
@@ -65,6 +65,17 @@ Microchip or any third party.
 /* Number of transmission buffers */
 #define NUM_TX_BUFFERS                           1U
 
+/* Depth of the driver TX queue. Transmission requests received while the PLC
+   transmitter is busy are stored and sent from the TX confirm interrupt.
+   0: TX queue disabled (requests are only accepted when idle) */
+#ifndef DRV_PLC_PHY_TX_QUEUE_SIZE
+#define DRV_PLC_PHY_TX_QUEUE_SIZE                0U
+#endif
+
+/* Size of the TX confirm queue: one confirm per queued request, plus the one
+   in progress, plus one empty slot to tell full from empty */
+#define DRV_PLC_PHY_TX_CFM_QUEUE_SIZE            (DRV_PLC_PHY_TX_QUEUE_SIZE + 2U)
+
 /* FLAG MASKs for set events */
 #define DRV_PLC_PHY_EV_FLAG_TX_CFM_MASK            0x0001U
 #define DRV_PLC_PHY_EV_FLAG_RX_DAT_MASK            0x0002U
@@ -120,6 +131,31 @@ typedef struct {
     bool evReg;
 } DRV_PLC_PHY_EVENTS_OBJ;
 
+// *****************************************************************************
+/* PLC TX Queue Object
+
+  Summary:
+    Object used to store a transmission request in the driver TX queue.
+
+  Description:
+    This object keeps the serialized transmission parameters and a copy of the
+    data of a request waiting for the PLC transmitter to be free.
+
+  Remarks:
+    None.
+*/
+
+typedef struct {
+    /* Serialized transmission parameters */
+    uint8_t txPar[PLC_TX_PAR_SIZE];
+    /* Transmission data */
+    uint8_t txData[PLC_DATA_PKT_SIZE];
+    /* Length of serialized transmission parameters */
+    uint16_t txParLength;
+    /* Length of transmission data */
+    uint16_t dataLength;
+} DRV_PLC_PHY_TX_QUEUE_OBJ;
+
 /* PLC Internal Memory Map
 
   Summary:
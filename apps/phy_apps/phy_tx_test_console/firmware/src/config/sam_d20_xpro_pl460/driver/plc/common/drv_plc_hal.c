@@ -69,6 +69,10 @@ Microchip or any third party.
 static CACHE_ALIGN uint8_t sRxSpiData[CACHE_ALIGNED_SIZE_GET(HAL_SPI_BUFFER_SIZE)];
 /* PDC Transmission buffer */
 static CACHE_ALIGN uint8_t sTxSpiData[CACHE_ALIGNED_SIZE_GET(HAL_SPI_BUFFER_SIZE)];
+/* PDC Transmission buffer of boot commands, used alternately with sTxSpiData */
+static CACHE_ALIGN uint8_t sTxSpiBootData[CACHE_ALIGNED_SIZE_GET(HAL_SPI_BUFFER_SIZE)];
+/* PDC Transmission buffer of the last SPI transfer */
+static uint8_t *sTxSpiLastData = sTxSpiData;
 
 /* Static pointer to PLIB interface used to handle PLC */
 static DRV_PLC_PLIB_INTERFACE *sPlcPlib;
@@ -233,12 +237,21 @@ bool DRV_PLC_HAL_GetPinLevel(SYS_PORT_PIN pin)
 
 void DRV_PLC_HAL_SendBootCmd(uint16_t cmd, uint32_t addr, uint32_t dataLength, uint8_t *pDataWr, uint8_t *pDataRd)
 {
+    uint8_t *pTxBuffer;
     uint8_t *pTxData;
     size_t size;
 
-    while(sPlcPlib->spiIsBusy()){}
+    /* Build command in the buffer not used by the SPI transfer in progress */
+    if (sTxSpiLastData == sTxSpiData)
+    {
+        pTxBuffer = sTxSpiBootData;
+    }
+    else
+    {
+        pTxBuffer = sTxSpiData;
+    }
 
-    pTxData = sTxSpiData;
+    pTxData = pTxBuffer;
 
     /* Build command */
     (void) memcpy(pTxData, (uint8_t *)&addr, 4);
@@ -269,7 +282,10 @@ void DRV_PLC_HAL_SendBootCmd(uint16_t cmd, uint32_t addr, uint32_t dataLength, u
     /* Assert CS pin */
     SYS_PORT_PinClear(sPlcPlib->spiCSPin);
 
-    (void) sPlcPlib->spiWriteRead(sTxSpiData, size, sRxSpiData, size);
+    while(sPlcPlib->spiIsBusy()){}
+
+    (void) sPlcPlib->spiWriteRead(pTxBuffer, size, sRxSpiData, size);
+    sTxSpiLastData = pTxBuffer;
 
     while(sPlcPlib->spiIsBusy()){}
 
@@ -292,6 +308,7 @@ void DRV_PLC_HAL_SendWrRdCmd(DRV_PLC_HAL_CMD *pCmd, DRV_PLC_HAL_INFO *pInfo)
     while(sPlcPlib->spiIsBusy()){}
 
     pTxData = sTxSpiData;
+    sTxSpiLastData = sTxSpiData;
 
     dataLength = ((pCmd->length + 1U) >> 1) & 0x7FFFU;
 
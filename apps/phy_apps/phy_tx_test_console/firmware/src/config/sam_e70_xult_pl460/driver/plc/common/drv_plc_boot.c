@@ -46,6 +46,7 @@ Microchip or any third party.
 // *****************************************************************************
 // *****************************************************************************
 #include <string.h>
+#include "configuration.h"
 #include "driver/plc/common/drv_plc_hal.h"
 #include "driver/plc/common/drv_plc_boot.h"
 
@@ -62,12 +63,64 @@ static DRV_PLC_HAL_INTERFACE *sDrvPlcHalObj;
 static DRV_PLC_BOOT_INFO sDrvPlcBootInfo = {0};
 
 /* This is the maximum size of the fragments to handle the upload task of binary
- file to PLC transceiver */
-#define MAX_FRAG_SIZE      512U
+ file to PLC transceiver. It is limited by the SPI buffer of the PLC HAL
+ (634 bytes including the 6 bytes of the boot command header) and aligned to
+ the 16-byte AES block size used in secure mode */
+#define MAX_FRAG_SIZE      624U
+
+/* Number of fragments uploaded in each call to DRV_PLC_BOOT_Tasks. The HAL
+ builds each boot command in the SPI buffer not used by the transfer in
+ progress, so a fragment is copied from FLASH while the previous one is being
+ transferred. Each call waits for the transfer of all its fragments but the
+ last one */
+#ifndef DRV_PLC_BOOT_FRAGS_PER_TASK
+#define DRV_PLC_BOOT_FRAGS_PER_TASK        1U
+#endif
+
+/* Skip the upload of the binary file if it is still resident in the PLC
+ transceiver after a reset of the host (see lDRV_PLC_BOOT_CheckResident) */
+#ifndef DRV_PLC_BOOT_RESIDENT_CHECK
+#define DRV_PLC_BOOT_RESIDENT_CHECK        0U
+#endif
 
 static DRV_PLC_BOOT_DATA_CALLBACK sDrvPlcBootCb = NULL;
 static uintptr_t sDrvPlcBootContext;
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+#define DRV_PLC_BOOT_RESIDENT_KEY          0x504C4342UL
+
+/* Blocks of the program memory of PLC transceiver read back and compared with
+ the binary file before starting it from the resident one. The first and the
+ last blocks are always compared */
+#define DRV_PLC_BOOT_VERIFY_BLOCKS         16U
+#define DRV_PLC_BOOT_VERIFY_BLOCK_SIZE     128U
+
+/* Signature of the binary file uploaded to PLC transceiver */
+typedef struct
+{
+    uint32_t key;
+    uint32_t binSize;
+    uint32_t binCrc;
+    uint32_t check;
+} DRV_PLC_BOOT_RESIDENT_INFO;
+
+/* Kept in a RAM section not initialized at startup, so it survives a soft or
+ watchdog reset of the host. If it is cleared anyway, the key does not match
+ and the binary file is always uploaded */
+#if defined(__XC32)
+static DRV_PLC_BOOT_RESIDENT_INFO sDrvPlcBootResident __attribute__((persistent));
+#else
+static DRV_PLC_BOOT_RESIDENT_INFO sDrvPlcBootResident __attribute__((noinit));
+#endif
+
+/* CRC32 (without final XOR) of the binary file stored in internal FLASH
+ memory, updated as it is uploaded */
+static uint32_t sDrvPlcBootBinCrc;
+
+/* Start up from the resident binary file is in progress */
+static bool sDrvPlcBootFromResident = false;
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: File scope functions
@@ -166,6 +219,27 @@ static void lDRV_PLC_BOOT_SartDecryption(void)
 //    }
 }
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+static uint32_t lDRV_PLC_BOOT_UpdateCrc32(uint32_t crc, const uint8_t *pData, uint32_t length)
+{
+    static const uint32_t crcTable[16] = {
+        0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+        0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+        0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+        0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+    };
+
+    while (length-- > 0U)
+    {
+        crc ^= *pData++;
+        crc = (crc >> 4) ^ crcTable[crc & 0x0FU];
+        crc = (crc >> 4) ^ crcTable[crc & 0x0FU];
+    }
+
+    return crc;
+}
+#endif
+
 static void lDRV_PLC_BOOT_FirmwareUploadTask(void)
 {
     uint8_t *pData;
@@ -241,6 +315,12 @@ static void lDRV_PLC_BOOT_FirmwareUploadTask(void)
         /* Write fragment data */
         sDrvPlcHalObj->sendBootCmd(DRV_PLC_BOOT_CMD_WRITE_BUF, progAddr, fragSize, pData, NULL);
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+        /* Computed while the fragment is being transferred */
+        sDrvPlcBootBinCrc = lDRV_PLC_BOOT_UpdateCrc32(sDrvPlcBootBinCrc,
+                (const uint8_t *)sDrvPlcBootInfo.pSrc, fragSizeReal);
+#endif
+
         /* Update counters */
         sDrvPlcBootInfo.pendingLength -= fragSizeReal;
         pData += fragSize;
@@ -252,6 +332,84 @@ static void lDRV_PLC_BOOT_FirmwareUploadTask(void)
     sDrvPlcBootInfo.pDst = progAddr;
 }
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+static uint32_t lDRV_PLC_BOOT_GetResidentCheck(void)
+{
+    return ~(sDrvPlcBootResident.key ^ sDrvPlcBootResident.binSize ^
+            sDrvPlcBootResident.binCrc);
+}
+
+static void lDRV_PLC_BOOT_SetResident(bool valid)
+{
+    sDrvPlcBootResident.binSize = sDrvPlcBootInfo.binSize;
+    sDrvPlcBootResident.binCrc = sDrvPlcBootBinCrc;
+    sDrvPlcBootResident.key = valid ? DRV_PLC_BOOT_RESIDENT_KEY : 0U;
+    sDrvPlcBootResident.check = lDRV_PLC_BOOT_GetResidentCheck();
+}
+
+static bool lDRV_PLC_BOOT_CheckResident(void)
+{
+    /* The PLC transceiver keeps its program memory across the reset pulse of
+     the HAL, as done when leaving sleep mode. The binary file is not uploaded
+     again if the last one uploaded has the same size and CRC32 and the
+     program memory still holds it (see lDRV_PLC_BOOT_VerifyResident) */
+    if ((sDrvPlcBootResident.key != DRV_PLC_BOOT_RESIDENT_KEY) ||
+        (sDrvPlcBootResident.check != lDRV_PLC_BOOT_GetResidentCheck()))
+    {
+        return false;
+    }
+
+    return (sDrvPlcBootResident.binSize == sDrvPlcBootInfo.binSize);
+}
+
+static bool lDRV_PLC_BOOT_VerifyResident(void)
+{
+    uint8_t block[DRV_PLC_BOOT_VERIFY_BLOCK_SIZE];
+    const uint8_t *pBin = (const uint8_t *)sDrvPlcBootInfo.binStartAddress;
+    uint32_t binSize = sDrvPlcBootInfo.binSize;
+    uint32_t step, offset, length;
+
+    if (binSize < (2U * DRV_PLC_BOOT_VERIFY_BLOCK_SIZE))
+    {
+        return false;
+    }
+
+    /* Word aligned blocks spread over the binary file, the last one ending
+     with it */
+    step = ((binSize - DRV_PLC_BOOT_VERIFY_BLOCK_SIZE) / (DRV_PLC_BOOT_VERIFY_BLOCKS - 1U)) & ~3UL;
+
+    for (uint32_t idx = 0; idx < DRV_PLC_BOOT_VERIFY_BLOCKS; idx++)
+    {
+        if (idx < (DRV_PLC_BOOT_VERIFY_BLOCKS - 1U))
+        {
+            offset = idx * step;
+        }
+        else
+        {
+            offset = (binSize - DRV_PLC_BOOT_VERIFY_BLOCK_SIZE + 3U) & ~3UL;
+        }
+
+        length = binSize - offset;
+        if (length > DRV_PLC_BOOT_VERIFY_BLOCK_SIZE)
+        {
+            length = DRV_PLC_BOOT_VERIFY_BLOCK_SIZE;
+        }
+
+        /* Read program memory. If the PLC transceiver lost it or its fuses
+         disable the read of the RAM, it does not match */
+        sDrvPlcHalObj->sendBootCmd(DRV_PLC_BOOT_CMD_READ_BUF, DRV_PLC_BOOT_PROGRAM_ADDR + offset,
+                DRV_PLC_BOOT_VERIFY_BLOCK_SIZE, NULL, block);
+
+        if (memcmp(block, &pBin[offset], length) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
 static void lDRV_PLC_BOOT_EnableBootCmd(void)
 {
     uint32_t reg_value;
@@ -333,6 +491,13 @@ static void lDRV_PLC_BOOT_RestartProcess(void)
     sDrvPlcBootInfo.pDst = DRV_PLC_BOOT_PROGRAM_ADDR;
     sDrvPlcBootInfo.secNumPackets = 0;
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+    /* Program memory is going to be overwritten */
+    sDrvPlcBootFromResident = false;
+    sDrvPlcBootBinCrc = 0xFFFFFFFFUL;
+    lDRV_PLC_BOOT_SetResident(false);
+#endif
+
     lDRV_PLC_BOOT_EnableBootCmd();
 
     sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_PROCESING;
@@ -363,6 +528,46 @@ void DRV_PLC_BOOT_Start(DRV_PLC_BOOT_INFO *pBootInfo, DRV_PLC_HAL_INTERFACE *pHa
         sDrvPlcBootInfo.contextBoot = pBootInfo->contextBoot;
     }
 
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+    sDrvPlcBootFromResident = false;
+    sDrvPlcBootBinCrc = 0xFFFFFFFFUL;
+
+    if ((sDrvPlcBootCb == NULL) && (sDrvPlcBootInfo.secure == false) &&
+        lDRV_PLC_BOOT_CheckResident())
+    {
+        /* Hold PLC transceiver in boot mode to read its program memory */
+        lDRV_PLC_BOOT_EnableBootCmd();
+
+        if (lDRV_PLC_BOOT_VerifyResident())
+        {
+            sDrvPlcBootBinCrc = lDRV_PLC_BOOT_UpdateCrc32(0xFFFFFFFFUL,
+                    (const uint8_t *)sDrvPlcBootInfo.binStartAddress, sDrvPlcBootInfo.binSize);
+
+            if (sDrvPlcBootBinCrc == sDrvPlcBootResident.binCrc)
+            {
+                /* Restart PLC transceiver from the resident binary file */
+                sDrvPlcBootFromResident = true;
+                lDRV_PLC_BOOT_DisableBootCmd();
+                sDrvPlcBootInfo.validationCounter = 50;
+                sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_VALIDATING;
+                return;
+            }
+
+            /* Binary file changed: CRC32 computed again while uploading it */
+            sDrvPlcBootBinCrc = 0xFFFFFFFFUL;
+        }
+
+        /* Program memory lost or changed: upload the binary file, boot mode
+         is already enabled */
+        lDRV_PLC_BOOT_SetResident(false);
+        sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_PROCESING;
+        return;
+    }
+
+    /* Program memory is going to be overwritten */
+    lDRV_PLC_BOOT_SetResident(false);
+#endif
+
     lDRV_PLC_BOOT_EnableBootCmd();
 
     sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_PROCESING;
@@ -377,7 +582,15 @@ void DRV_PLC_BOOT_Tasks( void )
 {
     if (sDrvPlcBootInfo.status == DRV_PLC_BOOT_STATUS_PROCESING)
     {
-        lDRV_PLC_BOOT_FirmwareUploadTask();
+        uint8_t fragCount = 0;
+
+        do
+        {
+            lDRV_PLC_BOOT_FirmwareUploadTask();
+            fragCount++;
+        } while ((sDrvPlcBootInfo.pendingLength > 0U) &&
+                 (fragCount < DRV_PLC_BOOT_FRAGS_PER_TASK));
+
         if (sDrvPlcBootInfo.pendingLength == 0U)
         {
             /* Check Secure Mode */
@@ -424,6 +637,13 @@ void DRV_PLC_BOOT_Tasks( void )
             {
                 /* Update boot status */
                 sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_READY;
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+                sDrvPlcBootFromResident = false;
+                if (sDrvPlcBootCb == NULL)
+                {
+                    lDRV_PLC_BOOT_SetResident(true);
+                }
+#endif
             }
             else
             {
@@ -431,6 +651,13 @@ void DRV_PLC_BOOT_Tasks( void )
                 {
                     sDrvPlcHalObj->delay(200);
                 }
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+                else if (sDrvPlcBootFromResident)
+                {
+                    /* Resident binary file lost: upload it */
+                    lDRV_PLC_BOOT_RestartProcess();
+                }
+#endif
                 else
                 {
                     sDrvPlcBootInfo.status = DRV_PLC_BOOT_STATUS_ERROR;
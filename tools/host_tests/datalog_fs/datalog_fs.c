@@ -0,0 +1,1419 @@
+/*******************************************************************************
+  Datalog file system test
+
+  File Name:
+    datalog_fs.c
+
+  Summary:
+    Host test of the datalog open file table, write-back cache and record
+    format of app_datalog.c on a SYS_FS mock with power loss injection.
+
+  Description:
+    app_datalog.c of the G3 metering demo is built for the host against a RAM
+    model of SYS_FS. Every file has the content seen through the file system
+    and the content committed to the media: writes and truncations change the
+    first one, and SYS_FS_FileSync and SYS_FS_FileClose commit it. As in FAT,
+    a file that is open can not be opened again or removed.
+
+    A power loss is injected after a random number of file system calls that
+    change the media. If that call commits a file, only a random part of the
+    new bytes reaches the media, optionally followed by garbage, so the last
+    records are torn. All later calls fail until the simulated reboot, which
+    drops the RAM content and the handles and starts the datalog again.
+
+    Power loss runs: random appends of random lengths to five logs (more
+    than the open file table holds), bursts, flushes, flush intervals, reads
+    and writes. After the reboot, the first append of every log must remove
+    the torn tail: the file must then be made of whole valid records, the
+    appended ones in order up to some record, and must keep every record
+    committed before the power loss and every record appended before a
+    successful APP_DATALOG_FLUSH. Reads must return the cached records.
+
+    Other runs check the file system accesses of a month of 15-minute load
+    profile records and of a burst of appends against one open, close and
+    sync per request, a read whose cache flush fails, and the clear of a
+    user whose files are kept open.
+
+    Usage:
+      datalog_fs [power loss runs]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "app_datalog.h"
+
+/* APP_DATALOG_Initialize configures the MATRIX, keep it away from the host
+   address space */
+static matrix_registers_t testMatrix;
+#undef MATRIX1_REGS
+#define MATRIX1_REGS                        (&testMatrix)
+
+#include "app_datalog.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_FS_FILES_NUM               32U
+#define TEST_FS_HANDLES_NUM             8U
+#define TEST_FS_NAME_LEN                48U
+
+#define TEST_COUNTS_PER_MS              100000U
+#define TEST_TASKS_PER_REQUEST          16U
+#define TEST_RESULT_NONE                (-1)
+
+#define TEST_DEFAULT_RUNS               400U
+#define TEST_RUN_STEPS                  300U
+#define TEST_MAX_LOSS_CALLS             500U
+#define TEST_MAX_RECORD_LEN             80U
+#define TEST_LONG_RECORD_LEN            600U
+#define TEST_BURST_RECORDS              20U
+#define TEST_LOGS_NUM                   5U
+
+#define TEST_PROFILE_RECORD_LEN         40U
+#define TEST_PROFILE_PERIOD_S           900U
+#define TEST_PROFILE_DAYS               31U
+#define TEST_BENCH_BURST_RECORDS        1000U
+
+#define TEST_MAX_FAILS_SHOWN            20U
+
+/* File or directory of the mock file system */
+typedef struct
+{
+    char name[TEST_FS_NAME_LEN];
+    bool used;
+    bool isDir;
+    /* Content seen through the file system */
+    uint8_t *data;
+    uint32_t size;
+    /* Content committed to the media */
+    uint8_t *media;
+    uint32_t mediaSize;
+    /* Media size after the last commit that completed */
+    uint32_t syncedSize;
+    uint32_t capacity;
+} TEST_FS_FILE;
+
+typedef struct
+{
+    bool used;
+    bool isDir;
+    uint32_t file;
+    uint32_t pos;
+} TEST_FS_HANDLE_OBJ;
+
+typedef struct
+{
+    TEST_FS_FILE files[TEST_FS_FILES_NUM];
+    TEST_FS_HANDLE_OBJ handles[TEST_FS_HANDLES_NUM];
+    /* Calls changing the media left before the power loss, 0 if none */
+    uint32_t lossCountdown;
+    bool powerLost;
+    /* Next file writes to fail */
+    uint32_t failWrites;
+    uint32_t opens;
+    uint32_t closes;
+    uint32_t writes;
+    uint32_t syncs;
+    uint32_t removeDenied;
+} TEST_FS;
+
+/* Records appended to a log, as they must be found in its file */
+typedef struct
+{
+    APP_DATALOG_USER userId;
+    APP_DATALOG_DATE date;
+    char fileName[32];
+    uint8_t *stream;
+    uint32_t streamLen;
+    uint32_t capacity;
+    uint32_t *recordEnd;
+    uint32_t records;
+    uint32_t recordsCapacity;
+    /* Records appended before the last successful flush */
+    uint32_t flushedRecords;
+} TEST_LOG;
+
+typedef struct
+{
+    uint32_t runs;
+    uint32_t tornTails;
+    uint32_t lostCached;
+    uint32_t recovered;
+    uint32_t appended;
+} TEST_LOSS_STATS;
+
+static TEST_FS testFs;
+static TEST_LOG testLogs[TEST_LOGS_NUM];
+static uint64_t testTimeMs;
+static uint32_t testCallbacks;
+static APP_DATALOG_RESULT testLastResult;
+static uint32_t testRecordSeq;
+static uint32_t testFails;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+static const struct
+{
+    APP_DATALOG_USER userId;
+    uint8_t year;
+    uint8_t month;
+} testLogIds[TEST_LOGS_NUM] =
+{
+    {APP_DATALOG_USER_PROFILE, 24U, 3U},
+    {APP_DATALOG_USER_PROFILE, 24U, 4U},
+    {APP_DATALOG_USER_EVENTS, APP_DATALOG_INVALID_YEAR, APP_DATALOG_INVALID_MONTH},
+    {APP_DATALOG_USER_DEMAND, 24U, 4U},
+    {APP_DATALOG_USER_METROLOGY, APP_DATALOG_INVALID_YEAR, APP_DATALOG_INVALID_MONTH},
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t _randRange(uint32_t min, uint32_t max)
+{
+    return min + (uint32_t)(_rand64() % ((uint64_t)max - min + 1U));
+}
+
+static void _fail(const char *name, const char *msg, uint32_t value)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s: %s %u\n", name, msg, (unsigned)value);
+    }
+}
+
+static void *_grow(void *ptr, uint32_t *capacity, uint32_t needed, size_t itemSize)
+{
+    uint32_t newCapacity = (*capacity == 0U) ? 256U : *capacity;
+
+    if (needed <= *capacity)
+    {
+        return ptr;
+    }
+
+    while (newCapacity < needed)
+    {
+        newCapacity *= 2U;
+    }
+
+    ptr = realloc(ptr, newCapacity * itemSize);
+    if (ptr == NULL)
+    {
+        printf("FAIL: out of memory\n");
+        exit(1);
+    }
+
+    *capacity = newCapacity;
+    return ptr;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SYS_FS Mock
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t _fsFind(const char *name)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        if ((testFs.files[idx].used == true) && (strcmp(testFs.files[idx].name, name) == 0))
+        {
+            return idx;
+        }
+    }
+
+    return TEST_FS_FILES_NUM;
+}
+
+static bool _fsIsOpen(uint32_t file)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_HANDLES_NUM; idx++)
+    {
+        if ((testFs.handles[idx].used == true) && (testFs.handles[idx].isDir == false) &&
+            (testFs.handles[idx].file == file))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static TEST_FS_HANDLE_OBJ *_fsHandle(SYS_FS_HANDLE handle)
+{
+    if ((handle == 0U) || (handle > TEST_FS_HANDLES_NUM) || (testFs.handles[handle - 1U].used == false))
+    {
+        return NULL;
+    }
+
+    return &testFs.handles[handle - 1U];
+}
+
+static SYS_FS_HANDLE _fsNewHandle(uint32_t file, bool isDir)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_HANDLES_NUM; idx++)
+    {
+        if (testFs.handles[idx].used == false)
+        {
+            testFs.handles[idx].used = true;
+            testFs.handles[idx].isDir = isDir;
+            testFs.handles[idx].file = file;
+            testFs.handles[idx].pos = 0U;
+            return (SYS_FS_HANDLE)(idx + 1U);
+        }
+    }
+
+    return SYS_FS_HANDLE_INVALID;
+}
+
+static uint32_t _fsCreate(const char *name, bool isDir)
+{
+    const char *slash = strrchr(name, '/');
+    char dirName[TEST_FS_NAME_LEN];
+    uint32_t idx;
+
+    if ((strlen(name) >= TEST_FS_NAME_LEN) || (name[0] == '\0'))
+    {
+        return TEST_FS_FILES_NUM;
+    }
+
+    if (slash != NULL)
+    {
+        // Parent directory must exist
+        memcpy(dirName, name, (size_t)(slash - name));
+        dirName[slash - name] = '\0';
+        idx = _fsFind(dirName);
+        if ((idx == TEST_FS_FILES_NUM) || (testFs.files[idx].isDir == false))
+        {
+            return TEST_FS_FILES_NUM;
+        }
+    }
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        if (testFs.files[idx].used == false)
+        {
+            TEST_FS_FILE *pFile = &testFs.files[idx];
+
+            strcpy(pFile->name, name);
+            pFile->used = true;
+            pFile->isDir = isDir;
+            pFile->size = 0U;
+            pFile->mediaSize = 0U;
+            pFile->syncedSize = 0U;
+            return idx;
+        }
+    }
+
+    return TEST_FS_FILES_NUM;
+}
+
+/* Both contents of a file have the same capacity */
+static void _fsReserve(TEST_FS_FILE *pFile, uint32_t needed)
+{
+    uint32_t capacity = pFile->capacity;
+
+    pFile->data = _grow(pFile->data, &capacity, needed, 1U);
+    pFile->media = _grow(pFile->media, &pFile->capacity, needed, 1U);
+}
+
+/* Commits a file to the media. A torn commit writes a random part of the
+   new bytes, and sometimes garbage after them. */
+static void _fsCommit(uint32_t file, bool torn)
+{
+    TEST_FS_FILE *pFile = &testFs.files[file];
+    uint32_t keep;
+    uint32_t cut;
+    uint32_t valid;
+    uint32_t idx;
+
+    _fsReserve(pFile, pFile->size);
+
+    if (torn == false)
+    {
+        memcpy(pFile->media, pFile->data, pFile->size);
+        pFile->mediaSize = pFile->size;
+        pFile->syncedSize = pFile->size;
+        return;
+    }
+
+    keep = (pFile->mediaSize < pFile->size) ? pFile->mediaSize : pFile->size;
+    cut = _randRange(keep, pFile->size);
+    valid = ((_rand64() & 1U) == 0U) ? cut : _randRange(keep, cut);
+
+    memcpy(pFile->media, pFile->data, valid);
+    for (idx = valid; idx < cut; idx++)
+    {
+        pFile->media[idx] = (uint8_t)_rand64();
+    }
+    pFile->mediaSize = cut;
+}
+
+/* Counts down the calls changing the media. Returns true if the call must
+   fail because the power is lost. */
+static bool _fsPowerLoss(uint32_t commitFile)
+{
+    if (testFs.powerLost == true)
+    {
+        return true;
+    }
+
+    if ((testFs.lossCountdown == 0U) || (--testFs.lossCountdown != 0U))
+    {
+        return false;
+    }
+
+    testFs.powerLost = true;
+    if (commitFile != TEST_FS_FILES_NUM)
+    {
+        _fsCommit(commitFile, true);
+    }
+
+    return true;
+}
+
+static void _fsFormat(void)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        free(testFs.files[idx].data);
+        free(testFs.files[idx].media);
+    }
+
+    memset(&testFs, 0, sizeof(testFs));
+}
+
+/* Power on after a power loss: files get the content of the media */
+static void _fsPowerOn(void)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        TEST_FS_FILE *pFile = &testFs.files[idx];
+
+        if ((pFile->used == true) && (pFile->isDir == false))
+        {
+            _fsReserve(pFile, pFile->mediaSize);
+            memcpy(pFile->data, pFile->media, pFile->mediaSize);
+            pFile->size = pFile->mediaSize;
+            pFile->syncedSize = pFile->mediaSize;
+        }
+    }
+
+    memset(testFs.handles, 0, sizeof(testFs.handles));
+    testFs.lossCountdown = 0U;
+    testFs.powerLost = false;
+    testFs.failWrites = 0U;
+}
+
+SYS_FS_RESULT SYS_FS_Mount(const char *devName, const char *mountName, SYS_FS_FILE_SYSTEM_TYPE filesystemtype,
+        unsigned long mountflags, const void *data)
+{
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_ERROR SYS_FS_Error(void)
+{
+    return SYS_FS_ERROR_OK;
+}
+
+SYS_FS_RESULT SYS_FS_DriveFormat(const char* drive, const SYS_FS_FORMAT_PARAM* opt, void* work, uint32_t len)
+{
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_HANDLE SYS_FS_FileOpen(const char* fname, SYS_FS_FILE_OPEN_ATTRIBUTES attributes)
+{
+    SYS_FS_HANDLE handle;
+    uint32_t file;
+
+    if (testFs.powerLost == true)
+    {
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    file = _fsFind(fname);
+    if ((file != TEST_FS_FILES_NUM) && ((testFs.files[file].isDir == true) || (_fsIsOpen(file) == true)))
+    {
+        // Open files are locked
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    if ((attributes == SYS_FS_FILE_OPEN_READ) || (attributes == SYS_FS_FILE_OPEN_READ_PLUS))
+    {
+        if (file == TEST_FS_FILES_NUM)
+        {
+            return SYS_FS_HANDLE_INVALID;
+        }
+    }
+    else if (file == TEST_FS_FILES_NUM)
+    {
+        file = _fsCreate(fname, false);
+        if (file == TEST_FS_FILES_NUM)
+        {
+            return SYS_FS_HANDLE_INVALID;
+        }
+    }
+    else if ((attributes == SYS_FS_FILE_OPEN_WRITE) || (attributes == SYS_FS_FILE_OPEN_WRITE_PLUS))
+    {
+        testFs.files[file].size = 0U;
+    }
+
+    handle = _fsNewHandle(file, false);
+    if (handle != SYS_FS_HANDLE_INVALID)
+    {
+        testFs.opens++;
+        if ((attributes == SYS_FS_FILE_OPEN_APPEND) || (attributes == SYS_FS_FILE_OPEN_APPEND_PLUS))
+        {
+            testFs.handles[handle - 1U].pos = testFs.files[file].size;
+        }
+    }
+
+    return handle;
+}
+
+SYS_FS_RESULT SYS_FS_FileClose(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    bool lost;
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    lost = _fsPowerLoss(pHandle->file);
+    pHandle->used = false;
+    if (lost == true)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    _fsCommit(pHandle->file, false);
+    testFs.closes++;
+    return SYS_FS_RES_SUCCESS;
+}
+
+size_t SYS_FS_FileRead(SYS_FS_HANDLE handle, void *buffer, size_t nbyte)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    TEST_FS_FILE *pFile;
+    size_t count;
+
+    if ((testFs.powerLost == true) || (pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return (size_t)-1;
+    }
+
+    pFile = &testFs.files[pHandle->file];
+    count = (pHandle->pos < pFile->size) ? (pFile->size - pHandle->pos) : 0U;
+    if (count > nbyte)
+    {
+        count = nbyte;
+    }
+
+    memcpy(buffer, &pFile->data[pHandle->pos], count);
+    pHandle->pos += (uint32_t)count;
+    return count;
+}
+
+size_t SYS_FS_FileWrite(SYS_FS_HANDLE handle, const void *buffer, size_t nbyte)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    TEST_FS_FILE *pFile;
+    uint32_t end;
+
+    if ((pHandle == NULL) || (pHandle->isDir == true) || (_fsPowerLoss(TEST_FS_FILES_NUM) == true))
+    {
+        return (size_t)-1;
+    }
+
+    if (testFs.failWrites > 0U)
+    {
+        testFs.failWrites--;
+        return (size_t)-1;
+    }
+
+    pFile = &testFs.files[pHandle->file];
+    end = pHandle->pos + (uint32_t)nbyte;
+    _fsReserve(pFile, end);
+    memcpy(&pFile->data[pHandle->pos], buffer, nbyte);
+    pHandle->pos = end;
+    if (end > pFile->size)
+    {
+        pFile->size = end;
+    }
+
+    testFs.writes++;
+    return nbyte;
+}
+
+int32_t SYS_FS_FileSeek(SYS_FS_HANDLE handle, int32_t offset, SYS_FS_FILE_SEEK_CONTROL whence)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    int64_t pos;
+
+    if ((testFs.powerLost == true) || (pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return -1;
+    }
+
+    pos = offset;
+    if (whence == SYS_FS_SEEK_CUR)
+    {
+        pos += pHandle->pos;
+    }
+    else if (whence == SYS_FS_SEEK_END)
+    {
+        pos += testFs.files[pHandle->file].size;
+    }
+
+    if ((pos < 0) || (pos > testFs.files[pHandle->file].size))
+    {
+        return -1;
+    }
+
+    pHandle->pos = (uint32_t)pos;
+    return (int32_t)pos;
+}
+
+int32_t SYS_FS_FileSize(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((testFs.powerLost == true) || (pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return -1;
+    }
+
+    return (int32_t)testFs.files[pHandle->file].size;
+}
+
+SYS_FS_RESULT SYS_FS_FileSync(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == true) || (_fsPowerLoss(pHandle->file) == true))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    _fsCommit(pHandle->file, false);
+    testFs.syncs++;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileTruncate(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == true) || (_fsPowerLoss(TEST_FS_FILES_NUM) == true))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    testFs.files[pHandle->file].size = pHandle->pos;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileStat(const char *fname, SYS_FS_FSTAT *buf)
+{
+    uint32_t file;
+    const char *slash;
+
+    if (testFs.powerLost == true)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    file = _fsFind(fname);
+    if (file == TEST_FS_FILES_NUM)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    slash = strrchr(fname, '/');
+    strcpy(buf->fname, (slash != NULL) ? (slash + 1) : fname);
+    buf->fsize = testFs.files[file].size;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_HANDLE SYS_FS_DirOpen(const char* path)
+{
+    uint32_t file;
+
+    if (testFs.powerLost == true)
+    {
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    file = _fsFind(path);
+    if ((file == TEST_FS_FILES_NUM) || (testFs.files[file].isDir == false))
+    {
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    return _fsNewHandle(file, true);
+}
+
+SYS_FS_RESULT SYS_FS_DirClose(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == false))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    pHandle->used = false;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_DirRead(SYS_FS_HANDLE handle, SYS_FS_FSTAT *stat)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    const char *dirName;
+    size_t dirLen;
+
+    if ((testFs.powerLost == true) || (pHandle == NULL) || (pHandle->isDir == false))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    // Entries are listed in table order, so removing the last entry read
+    // does not skip any other one
+    dirName = testFs.files[pHandle->file].name;
+    dirLen = strlen(dirName);
+    for (; pHandle->pos < TEST_FS_FILES_NUM; pHandle->pos++)
+    {
+        TEST_FS_FILE *pFile = &testFs.files[pHandle->pos];
+
+        if ((pFile->used == true) && (strncmp(pFile->name, dirName, dirLen) == 0) && (pFile->name[dirLen] == '/'))
+        {
+            strcpy(stat->fname, &pFile->name[dirLen + 1U]);
+            stat->fsize = pFile->size;
+            pHandle->pos++;
+            return SYS_FS_RES_SUCCESS;
+        }
+    }
+
+    stat->fname[0] = '\0';
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_DirectoryMake(const char* path)
+{
+    if ((testFs.powerLost == true) || (_fsFind(path) != TEST_FS_FILES_NUM) ||
+        (_fsCreate(path, true) == TEST_FS_FILES_NUM))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileDirectoryRemove(const char* path)
+{
+    uint32_t file;
+
+    if (testFs.powerLost == true)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    file = _fsFind(path);
+    if (file == TEST_FS_FILES_NUM)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    if (_fsIsOpen(file) == true)
+    {
+        // Open files are locked
+        testFs.removeDenied++;
+        return SYS_FS_RES_FAILURE;
+    }
+
+    testFs.files[file].used = false;
+    return SYS_FS_RES_SUCCESS;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+uint64_t SYS_TIME_Counter64Get(void)
+{
+    return testTimeMs * TEST_COUNTS_PER_MS;
+}
+
+uint32_t SYS_TIME_MSToCount(uint32_t ms)
+{
+    return ms * TEST_COUNTS_PER_MS;
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Datalog Requests
+// *****************************************************************************
+// *****************************************************************************
+
+static void _testEndCallback(APP_DATALOG_RESULT result)
+{
+    testLastResult = result;
+    testCallbacks++;
+}
+
+static void _testTasks(uint32_t calls)
+{
+    while (calls-- > 0U)
+    {
+        APP_DATALOG_Tasks();
+        testTimeMs++;
+    }
+}
+
+/* Power on: RAM is cleared and the datalog is started again */
+static void _testBoot(void)
+{
+    memset(&app_datalogData, 0, sizeof(app_datalogData));
+    APP_DATALOG_Initialize();
+    _testTasks(TEST_TASKS_PER_REQUEST);
+}
+
+/* Queues a request and runs the datalog task until it ends. Returns the
+   result or TEST_RESULT_NONE. */
+static int _testRequest(APP_DATALOG_OPERATION operation, APP_DATALOG_USER userId, const APP_DATALOG_DATE *date,
+        uint8_t *pData, uint16_t dataLen)
+{
+    APP_DATALOG_QUEUE_DATA request;
+    uint32_t callbacks = testCallbacks;
+    uint32_t calls;
+
+    request.userId = userId;
+    request.operation = operation;
+    request.endCallback = _testEndCallback;
+    request.date.year = (date != NULL) ? date->year : APP_DATALOG_INVALID_YEAR;
+    request.date.month = (date != NULL) ? date->month : APP_DATALOG_INVALID_MONTH;
+    request.dataLen = dataLen;
+    request.pData = pData;
+
+    if (APP_DATALOG_SendDatalogData(&request) == false)
+    {
+        return TEST_RESULT_NONE;
+    }
+
+    for (calls = 0U; (calls < TEST_TASKS_PER_REQUEST) && (testCallbacks == callbacks); calls++)
+    {
+        _testTasks(1U);
+    }
+
+    return (testCallbacks == callbacks) ? TEST_RESULT_NONE : (int)testLastResult;
+}
+
+static void _testIdle(uint32_t seconds)
+{
+    while (seconds-- > 0U)
+    {
+        testTimeMs += 999U;
+        _testTasks(1U);
+    }
+}
+
+static void _testLogInit(TEST_LOG *pLog, APP_DATALOG_USER userId, uint8_t year, uint8_t month)
+{
+    pLog->userId = userId;
+    pLog->date.year = year;
+    pLog->date.month = month;
+    APP_DATALOG_GetFileNameByDate(userId, &pLog->date, pLog->fileName);
+    pLog->streamLen = 0U;
+    pLog->records = 0U;
+    pLog->flushedRecords = 0U;
+}
+
+/* Appends a record with a sequence number and random data */
+static int _testAppend(TEST_LOG *pLog, uint16_t dataLen)
+{
+    static uint8_t data[TEST_LONG_RECORD_LEN];
+    APP_DATALOG_RECORD_HEADER header;
+    uint16_t idx;
+
+    for (idx = 0U; idx < dataLen; idx++)
+    {
+        data[idx] = (uint8_t)_rand64();
+    }
+
+    testRecordSeq++;
+    memcpy(data, &testRecordSeq, (dataLen < sizeof(testRecordSeq)) ? dataLen : sizeof(testRecordSeq));
+
+    header.marker = APP_DATALOG_RECORD_MARKER;
+    header.length = dataLen;
+    header.crc = _APP_DATALOG_UpdateCrc16(0xFFFF, data, dataLen);
+
+    pLog->stream = _grow(pLog->stream, &pLog->capacity, pLog->streamLen + sizeof(header) + dataLen, 1U);
+    memcpy(&pLog->stream[pLog->streamLen], &header, sizeof(header));
+    memcpy(&pLog->stream[pLog->streamLen + sizeof(header)], data, dataLen);
+    pLog->streamLen += sizeof(header) + dataLen;
+
+    pLog->recordEnd = _grow(pLog->recordEnd, &pLog->recordsCapacity, pLog->records + 1U, sizeof(uint32_t));
+    pLog->recordEnd[pLog->records++] = pLog->streamLen;
+
+    return _testRequest(APP_DATALOG_APPEND, pLog->userId, &pLog->date, data, dataLen);
+}
+
+static int _testFlush(void)
+{
+    int result = _testRequest(APP_DATALOG_FLUSH, APP_DATALOG_USER_CONSOLE, NULL, NULL, 0U);
+    uint32_t idx;
+
+    if (result == (int)APP_DATALOG_RESULT_SUCCESS)
+    {
+        for (idx = 0U; idx < TEST_LOGS_NUM; idx++)
+        {
+            testLogs[idx].flushedRecords = testLogs[idx].records;
+        }
+    }
+
+    return result;
+}
+
+/* Reads the whole log through the datalog and checks it against the
+   records appended. Logs longer than a read request are checked in the
+   file system once the cache is empty. */
+static void _testReadLog(const char *name, TEST_LOG *pLog)
+{
+    static uint8_t buffer[UINT16_MAX];
+    uint32_t file;
+    int result;
+
+    if (pLog->streamLen > UINT16_MAX)
+    {
+        file = _fsFind(pLog->fileName);
+        if ((app_datalogData.cache.size != 0U) || (file == TEST_FS_FILES_NUM) ||
+            (testFs.files[file].size != pLog->streamLen) ||
+            (memcmp(testFs.files[file].data, pLog->stream, pLog->streamLen) != 0))
+        {
+            _fail(name, "file differs from the appended records, records", pLog->records);
+        }
+        return;
+    }
+
+    memset(buffer, 0, pLog->streamLen);
+    result = _testRequest(APP_DATALOG_READ, pLog->userId, &pLog->date, buffer, (uint16_t)pLog->streamLen);
+    if (testFs.powerLost == false)
+    {
+        if (result != (int)APP_DATALOG_RESULT_SUCCESS)
+        {
+            _fail(name, "read failed, records", pLog->records);
+        }
+        else if (memcmp(buffer, pLog->stream, pLog->streamLen) != 0)
+        {
+            _fail(name, "read data differs from the appended records, records", pLog->records);
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Power Loss Runs
+// *****************************************************************************
+// *****************************************************************************
+
+/* Random requests until the power is lost */
+static void _testWorkload(const char *name)
+{
+    static uint8_t rtcData[16];
+    uint32_t step;
+    uint32_t count;
+    uint32_t choice;
+    TEST_LOG *pLog;
+    int result;
+
+    for (step = 0U; (step < TEST_RUN_STEPS) && (testFs.powerLost == false); step++)
+    {
+        pLog = &testLogs[_randRange(0U, TEST_LOGS_NUM - 1U)];
+        choice = _randRange(0U, 99U);
+        result = (int)APP_DATALOG_RESULT_SUCCESS;
+
+        if (choice < 60U)
+        {
+            // Mostly short records, sometimes one longer than the cache
+            result = _testAppend(pLog, (_randRange(0U, 49U) == 0U) ? TEST_LONG_RECORD_LEN :
+                    (uint16_t)_randRange(1U, TEST_MAX_RECORD_LEN));
+        }
+        else if (choice < 70U)
+        {
+            for (count = 0U; (count < TEST_BURST_RECORDS) && (result == (int)APP_DATALOG_RESULT_SUCCESS); count++)
+            {
+                result = _testAppend(pLog, (uint16_t)_randRange(1U, TEST_MAX_RECORD_LEN));
+            }
+        }
+        else if (choice < 78U)
+        {
+            result = _testFlush();
+        }
+        else if (choice < 86U)
+        {
+            _testIdle((APP_DATALOG_CACHE_FLUSH_INTERVAL_MS / 1000U) + 1U);
+        }
+        else if (choice < 93U)
+        {
+            if (pLog->records > 0U)
+            {
+                _testReadLog(name, pLog);
+            }
+        }
+        else
+        {
+            result = _testRequest(APP_DATALOG_WRITE, APP_DATALOG_USER_RTC, NULL, rtcData, sizeof(rtcData));
+        }
+
+        if ((testFs.powerLost == false) && (result != (int)APP_DATALOG_RESULT_SUCCESS))
+        {
+            _fail(name, "request failed without power loss, step", step);
+        }
+    }
+
+    // Power lost while idle
+    testFs.powerLost = true;
+}
+
+/* Checks a log after the reboot and its first append */
+static void _testCheckLog(const char *name, TEST_LOG *pLog, uint32_t mediaSize, uint32_t syncedSize,
+        TEST_LOSS_STATS *stats)
+{
+    APP_DATALOG_RECORD_HEADER header;
+    TEST_FS_FILE *pFile;
+    uint32_t file;
+    uint32_t offset;
+    uint32_t prefix;
+    uint32_t markerLen;
+    uint32_t records;
+    uint32_t attempted;
+
+    // Record appended after the reboot is the last one of the reference
+    attempted = pLog->records - 1U;
+    markerLen = pLog->recordEnd[attempted] - ((attempted > 0U) ? pLog->recordEnd[attempted - 1U] : 0U);
+
+    file = _fsFind(pLog->fileName);
+    if (file == TEST_FS_FILES_NUM)
+    {
+        _fail(name, "log file missing, records", pLog->records);
+        return;
+    }
+
+    pFile = &testFs.files[file];
+
+    // Only whole valid records
+    offset = 0U;
+    while ((pFile->size - offset) >= sizeof(header))
+    {
+        memcpy(&header, &pFile->data[offset], sizeof(header));
+        if ((header.marker != APP_DATALOG_RECORD_MARKER) || ((pFile->size - offset - sizeof(header)) < header.length) ||
+            (_APP_DATALOG_UpdateCrc16(0xFFFF, &pFile->data[offset + sizeof(header)], header.length) != header.crc))
+        {
+            break;
+        }
+        offset += sizeof(header) + header.length;
+    }
+
+    if ((offset != pFile->size) || (pFile->size < markerLen))
+    {
+        _fail(name, "torn record left in the log at offset", offset);
+        return;
+    }
+
+    // Appended records in order up to some record, then the new one
+    prefix = pFile->size - markerLen;
+    for (records = 0U; (records < attempted) && (pLog->recordEnd[records] <= prefix); records++)
+    {
+    }
+
+    if ((((records == 0U) ? 0U : pLog->recordEnd[records - 1U]) != prefix) ||
+        (memcmp(pFile->data, pLog->stream, prefix) != 0) ||
+        (memcmp(&pFile->data[prefix], &pLog->stream[pLog->streamLen - markerLen], markerLen) != 0))
+    {
+        _fail(name, "log is not the appended records in order, size", pFile->size);
+        return;
+    }
+
+    if (prefix < syncedSize)
+    {
+        _fail(name, "records committed before the power loss lost, bytes", syncedSize - prefix);
+    }
+
+    if (records < pLog->flushedRecords)
+    {
+        _fail(name, "flushed records lost", pLog->flushedRecords - records);
+    }
+
+    if (mediaSize > prefix)
+    {
+        stats->tornTails++;
+    }
+
+    if (records < attempted)
+    {
+        stats->lostCached++;
+    }
+
+    stats->recovered += records;
+    stats->appended += attempted;
+
+    // Reference is now the content of the file
+    memmove(&pLog->stream[prefix], &pLog->stream[pLog->streamLen - markerLen], markerLen);
+    pLog->streamLen = prefix + markerLen;
+    pLog->recordEnd[records] = pLog->streamLen;
+    pLog->records = records + 1U;
+    pLog->flushedRecords = pLog->records;
+}
+
+static bool _testPowerLoss(uint32_t runs)
+{
+    const char *name = "power loss";
+    uint32_t mediaSize[TEST_LOGS_NUM];
+    uint32_t syncedSize[TEST_LOGS_NUM];
+    TEST_LOSS_STATS stats;
+    uint32_t fails = testFails;
+    uint32_t run;
+    uint32_t idx;
+    uint32_t file;
+
+    memset(&stats, 0, sizeof(stats));
+
+    for (run = 0U; run < runs; run++)
+    {
+        _fsFormat();
+        for (idx = 0U; idx < TEST_LOGS_NUM; idx++)
+        {
+            _testLogInit(&testLogs[idx], testLogIds[idx].userId, testLogIds[idx].year, testLogIds[idx].month);
+        }
+
+        _testBoot();
+        testFs.lossCountdown = _randRange(1U, TEST_MAX_LOSS_CALLS);
+        _testWorkload(name);
+
+        for (idx = 0U; idx < TEST_LOGS_NUM; idx++)
+        {
+            file = _fsFind(testLogs[idx].fileName);
+            mediaSize[idx] = (file == TEST_FS_FILES_NUM) ? 0U : testFs.files[file].mediaSize;
+            syncedSize[idx] = (file == TEST_FS_FILES_NUM) ? 0U : testFs.files[file].syncedSize;
+        }
+
+        _fsPowerOn();
+        _testBoot();
+
+        // First append of every log removes its torn tail
+        for (idx = 0U; idx < TEST_LOGS_NUM; idx++)
+        {
+            if ((testLogs[idx].records != 0U) && (_testAppend(&testLogs[idx], 12U) != (int)APP_DATALOG_RESULT_SUCCESS))
+            {
+                _fail(name, "append after the reboot failed, run", run);
+            }
+        }
+
+        // Flushed records of the logs are not known before the check
+        if (_testRequest(APP_DATALOG_FLUSH, APP_DATALOG_USER_CONSOLE, NULL, NULL, 0U) != (int)APP_DATALOG_RESULT_SUCCESS)
+        {
+            _fail(name, "flush after the reboot failed, run", run);
+        }
+
+        for (idx = 0U; idx < TEST_LOGS_NUM; idx++)
+        {
+            if (testLogs[idx].records != 0U)
+            {
+                _testCheckLog(name, &testLogs[idx], mediaSize[idx], syncedSize[idx], &stats);
+                _testReadLog(name, &testLogs[idx]);
+            }
+        }
+
+        stats.runs++;
+    }
+
+    if (stats.tornTails == 0U)
+    {
+        _fail(name, "no torn tail injected, runs", stats.runs);
+    }
+
+    printf("%-14s %5u runs, %u torn tails removed, %u logs lost cached records, %u of %u records recovered\n", name,
+            (unsigned)stats.runs, (unsigned)stats.tornTails, (unsigned)stats.lostCached, (unsigned)stats.recovered,
+            (unsigned)stats.appended);
+
+    return (testFails == fails);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Access Count Runs
+// *****************************************************************************
+// *****************************************************************************
+
+static void _testPrintAccesses(const char *name, uint32_t requests)
+{
+    printf("%-14s %5u requests: %u opens, %u closes, %u writes, %u syncs (per request open: %u, %u, %u, %u)\n", name,
+            (unsigned)requests, (unsigned)testFs.opens, (unsigned)testFs.closes, (unsigned)testFs.writes,
+            (unsigned)testFs.syncs, (unsigned)requests, (unsigned)requests, (unsigned)requests, (unsigned)requests);
+}
+
+/* A month of 15-minute load profile records, with hourly energy and daily
+   demand writes */
+static bool _testLoadProfile(void)
+{
+    const char *name = "load profile";
+    static uint8_t energyData[64];
+    static uint8_t demandData[32];
+    TEST_LOG *pLog = &testLogs[0];
+    uint32_t fails = testFails;
+    uint32_t requests = 0U;
+    uint32_t seconds;
+    int result;
+
+    _fsFormat();
+    _testLogInit(pLog, APP_DATALOG_USER_PROFILE, 24U, 3U);
+    _testBoot();
+
+    for (seconds = 0U; seconds < (TEST_PROFILE_DAYS * 86400U); seconds += TEST_PROFILE_PERIOD_S)
+    {
+        result = _testAppend(pLog, TEST_PROFILE_RECORD_LEN);
+        requests++;
+
+        if ((seconds % 3600U) == 0U)
+        {
+            if (_testRequest(APP_DATALOG_WRITE, APP_DATALOG_USER_ENERGY, NULL, energyData, sizeof(energyData)) !=
+                (int)APP_DATALOG_RESULT_SUCCESS)
+            {
+                result = (int)APP_DATALOG_RESULT_ERROR;
+            }
+            requests++;
+        }
+
+        if ((seconds % 86400U) == 0U)
+        {
+            if (_testRequest(APP_DATALOG_WRITE, APP_DATALOG_USER_DEMAND, NULL, demandData, sizeof(demandData)) !=
+                (int)APP_DATALOG_RESULT_SUCCESS)
+            {
+                result = (int)APP_DATALOG_RESULT_ERROR;
+            }
+            requests++;
+        }
+
+        if (result != (int)APP_DATALOG_RESULT_SUCCESS)
+        {
+            _fail(name, "request failed at second", seconds);
+            break;
+        }
+
+        _testIdle(TEST_PROFILE_PERIOD_S);
+    }
+
+    _testPrintAccesses(name, requests);
+
+    // Flush interval commits every record without a flush request
+    if (app_datalogData.cache.size != 0U)
+    {
+        _fail(name, "records still cached after the flush interval, bytes", app_datalogData.cache.size);
+    }
+
+    _testReadLog(name, pLog);
+
+    if ((testFs.opens * 10U) > requests)
+    {
+        _fail(name, "file opens", testFs.opens);
+    }
+
+    return (testFails == fails);
+}
+
+/* Back to back appends are written in batches */
+static bool _testBurst(void)
+{
+    const char *name = "burst";
+    TEST_LOG *pLog = &testLogs[0];
+    uint32_t fails = testFails;
+    uint32_t idx;
+
+    _fsFormat();
+    _testLogInit(pLog, APP_DATALOG_USER_EVENTS, APP_DATALOG_INVALID_YEAR, APP_DATALOG_INVALID_MONTH);
+    _testBoot();
+
+    for (idx = 0U; idx < TEST_BENCH_BURST_RECORDS; idx++)
+    {
+        if (_testAppend(pLog, TEST_PROFILE_RECORD_LEN) != (int)APP_DATALOG_RESULT_SUCCESS)
+        {
+            _fail(name, "append failed, record", idx);
+            break;
+        }
+    }
+
+    if (_testFlush() != (int)APP_DATALOG_RESULT_SUCCESS)
+    {
+        _fail(name, "flush failed, records", pLog->records);
+    }
+
+    _testPrintAccesses(name, TEST_BENCH_BURST_RECORDS + 1U);
+    _testReadLog(name, pLog);
+
+    // One write of the cache per flush threshold
+    if (testFs.syncs > ((TEST_BENCH_BURST_RECORDS * (sizeof(APP_DATALOG_RECORD_HEADER) + TEST_PROFILE_RECORD_LEN)) /
+            APP_DATALOG_CACHE_FLUSH_THRESHOLD) + 2U)
+    {
+        _fail(name, "syncs", testFs.syncs);
+    }
+
+    return (testFails == fails);
+}
+
+/* A read whose cache flush fails reports an error, and the records are
+   written by the next flush */
+static bool _testReadFlushError(void)
+{
+    const char *name = "read error";
+    TEST_LOG *pLog = &testLogs[0];
+    static uint8_t buffer[256];
+    uint32_t fails = testFails;
+    uint32_t idx;
+
+    _fsFormat();
+    _testLogInit(pLog, APP_DATALOG_USER_PROFILE, 24U, 4U);
+    _testBoot();
+
+    for (idx = 0U; idx < 3U; idx++)
+    {
+        (void) _testAppend(pLog, 20U);
+    }
+
+    testFs.failWrites = 1U;
+    if (_testRequest(APP_DATALOG_READ, pLog->userId, &pLog->date, buffer, (uint16_t)pLog->streamLen) !=
+        (int)APP_DATALOG_RESULT_ERROR)
+    {
+        _fail(name, "read with a failed flush did not report an error, records", pLog->records);
+    }
+
+    if (_testFlush() != (int)APP_DATALOG_RESULT_SUCCESS)
+    {
+        _fail(name, "flush after the write error failed, records", pLog->records);
+    }
+
+    _testReadLog(name, pLog);
+
+    printf("%-14s %5u records read after the failed flush\n", name, (unsigned)pLog->records);
+    return (testFails == fails);
+}
+
+/* Clearing a user closes its open files before removing them */
+static bool _testClear(void)
+{
+    const char *name = "clear";
+    TEST_LOG *pLog = &testLogs[0];
+    uint32_t fails = testFails;
+    uint32_t idx;
+    uint32_t removed = 0U;
+
+    _fsFormat();
+    _testLogInit(&testLogs[0], APP_DATALOG_USER_PROFILE, 24U, 3U);
+    _testLogInit(&testLogs[1], APP_DATALOG_USER_PROFILE, 24U, 4U);
+    _testBoot();
+
+    for (idx = 0U; idx < 10U; idx++)
+    {
+        (void) _testAppend(&testLogs[idx & 1U], 24U);
+    }
+
+    if (APP_DATALOG_FileExists(pLog->userId, &pLog->date) == false)
+    {
+        _fail(name, "file of the log not found, records", pLog->records);
+    }
+
+    if (_testRequest(APP_DATALOG_CLEAR, APP_DATALOG_USER_PROFILE, NULL, NULL, 0U) != (int)APP_DATALOG_RESULT_SUCCESS)
+    {
+        _fail(name, "clear failed, records", pLog->records);
+    }
+
+    for (idx = 0U; idx < 2U; idx++)
+    {
+        if (_fsFind(testLogs[idx].fileName) == TEST_FS_FILES_NUM)
+        {
+            removed++;
+        }
+    }
+
+    if ((removed != 2U) || (testFs.removeDenied != 0U))
+    {
+        _fail(name, "files not removed", 2U - removed);
+    }
+
+    if (APP_DATALOG_FileExists(pLog->userId, &pLog->date) == true)
+    {
+        _fail(name, "file of the log found after the clear, records", pLog->records);
+    }
+
+    // Cleared records are not written back
+    _testLogInit(pLog, APP_DATALOG_USER_PROFILE, 24U, 3U);
+    (void) _testAppend(pLog, 24U);
+    _testReadLog(name, pLog);
+
+    printf("%-14s %5u files removed\n", name, (unsigned)removed);
+    return (testFails == fails);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t runs = TEST_DEFAULT_RUNS;
+    bool pass = true;
+
+    if (argc > 1)
+    {
+        runs = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    printf("Cache %u bytes, flush threshold %u bytes, flush interval %u ms, %u open files\n",
+            APP_DATALOG_CACHE_SIZE, APP_DATALOG_CACHE_FLUSH_THRESHOLD, APP_DATALOG_CACHE_FLUSH_INTERVAL_MS,
+            APP_DATALOG_FILE_HANDLES_NUM);
+
+    pass &= _testPowerLoss(runs);
+    pass &= _testLoadProfile();
+    pass &= _testBurst();
+    pass &= _testReadFlushError();
+    pass &= _testClear();
+
+    printf("%s\n", (pass == true) ? "PASS" : "FAIL");
+    return (pass == true) ? 0 : 1;
+}
@@ -0,0 +1,798 @@
+/*******************************************************************************
+  Datalog range query benchmark
+
+  File Name:
+    datalog_range.c
+
+  Summary:
+    Host benchmark of the APP_DATALOG_READ_RANGE queries of app_datalog.c over
+    simulated months of load profile records.
+
+  Description:
+    app_datalog.c of the G3 metering demo is built for the host against a RAM
+    model of SYS_FS that counts the file reads and the bytes read. A month of
+    15-minute load profile records (APP_ENERGY_PROFILE_RECORD) is appended to
+    the March file and most of a month to the April file, as app_energy.c
+    does.
+
+    Range queries walk the monthly files covered by the range, as
+    APP_ENERGY_GetProfile does: the last day and the last hour, with the
+    index built by the query, kept in RAM, extended by later appends, loaded
+    from the stored index after a reset or after a query to another file,
+    and rebuilt when the stored index is corrupt. Every query must return
+    the records of the range in file order, up to the buffer size.
+
+    The bytes read by each query are printed next to the ones of a full scan,
+    which reads every byte of the files covered, as any time range query did
+    before the index. Queries served by an index in RAM or stored must read
+    less than TEST_MAX_SCAN_PERCENT of the full scan.
+
+    Usage:
+      datalog_range
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "app_datalog.h"
+
+/* APP_DATALOG_Initialize configures the MATRIX, keep it away from the host
+   address space */
+static matrix_registers_t testMatrix;
+#undef MATRIX1_REGS
+#define MATRIX1_REGS                        (&testMatrix)
+
+#include "app_datalog.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_FS_FILES_NUM               32U
+#define TEST_FS_HANDLES_NUM             8U
+#define TEST_FS_NAME_LEN                48U
+
+#define TEST_COUNTS_PER_MS              100000U
+#define TEST_TASKS_PER_REQUEST          16U
+#define TEST_RESULT_NONE                (-1)
+
+/* 2024-03-01 and 2024-04-01, in days since 2000-01-01 */
+#define TEST_MARCH_DAY                  8826U
+#define TEST_APRIL_DAY                  8857U
+#define TEST_APRIL_DAYS                 30U
+#define TEST_PERIOD_S                   (APP_ENERGY_PROFILE_PERIOD_MIN * 60U)
+#define TEST_DAY_S                      86400U
+
+/* Records of April left to append after the first queries */
+#define TEST_LATE_RECORDS               8U
+#define TEST_MAX_RECORDS                (2U * 31U * (TEST_DAY_S / TEST_PERIOD_S))
+#define TEST_MAX_SCAN_PERCENT           10U
+#define TEST_MONTHS_NUM                 2U
+
+#define TEST_MAX_FAILS_SHOWN            20U
+
+typedef struct
+{
+    char name[TEST_FS_NAME_LEN];
+    bool used;
+    bool isDir;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+} TEST_FS_FILE;
+
+typedef struct
+{
+    bool used;
+    bool isDir;
+    uint32_t file;
+    uint32_t pos;
+} TEST_FS_HANDLE_OBJ;
+
+typedef struct
+{
+    TEST_FS_FILE files[TEST_FS_FILES_NUM];
+    TEST_FS_HANDLE_OBJ handles[TEST_FS_HANDLES_NUM];
+    uint32_t reads;
+    uint32_t readBytes;
+} TEST_FS;
+
+/* Monthly profile file */
+typedef struct
+{
+    APP_DATALOG_DATE date;
+    uint32_t timeStart;
+    uint32_t timeEnd;
+    APP_ENERGY_PROFILE_RECORD *records;
+    uint32_t numRecords;
+} TEST_MONTH;
+
+typedef struct
+{
+    const char *name;
+    uint32_t timeStart;
+    uint32_t timeEnd;
+    uint16_t maxRecords;
+    /* Query served by an index in RAM or stored */
+    bool indexed;
+} TEST_QUERY;
+
+static TEST_FS testFs;
+static TEST_MONTH testMonths[TEST_MONTHS_NUM];
+static APP_ENERGY_PROFILE_RECORD testResponse[TEST_MAX_RECORDS];
+static uint64_t testTimeMs;
+static uint32_t testCallbacks;
+static APP_DATALOG_RESULT testLastResult;
+static uint32_t testFails;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static void _fail(const char *name, const char *msg, uint32_t value)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s: %s %u\n", name, msg, (unsigned)value);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SYS_FS Mock
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t _fsFind(const char *name)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        if ((testFs.files[idx].used == true) && (strcmp(testFs.files[idx].name, name) == 0))
+        {
+            return idx;
+        }
+    }
+
+    return TEST_FS_FILES_NUM;
+}
+
+static TEST_FS_HANDLE_OBJ *_fsHandle(SYS_FS_HANDLE handle)
+{
+    if ((handle == 0U) || (handle > TEST_FS_HANDLES_NUM) || (testFs.handles[handle - 1U].used == false))
+    {
+        return NULL;
+    }
+
+    return &testFs.handles[handle - 1U];
+}
+
+static SYS_FS_HANDLE _fsNewHandle(uint32_t file, bool isDir)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_HANDLES_NUM; idx++)
+    {
+        if (testFs.handles[idx].used == false)
+        {
+            testFs.handles[idx].used = true;
+            testFs.handles[idx].isDir = isDir;
+            testFs.handles[idx].file = file;
+            testFs.handles[idx].pos = 0U;
+            return (SYS_FS_HANDLE)(idx + 1U);
+        }
+    }
+
+    return SYS_FS_HANDLE_INVALID;
+}
+
+static uint32_t _fsCreate(const char *name, bool isDir)
+{
+    uint32_t idx;
+
+    if (strlen(name) >= TEST_FS_NAME_LEN)
+    {
+        return TEST_FS_FILES_NUM;
+    }
+
+    for (idx = 0U; idx < TEST_FS_FILES_NUM; idx++)
+    {
+        if (testFs.files[idx].used == false)
+        {
+            strcpy(testFs.files[idx].name, name);
+            testFs.files[idx].used = true;
+            testFs.files[idx].isDir = isDir;
+            testFs.files[idx].size = 0U;
+            return idx;
+        }
+    }
+
+    return TEST_FS_FILES_NUM;
+}
+
+SYS_FS_RESULT SYS_FS_Mount(const char *devName, const char *mountName, SYS_FS_FILE_SYSTEM_TYPE filesystemtype,
+        unsigned long mountflags, const void *data)
+{
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_ERROR SYS_FS_Error(void)
+{
+    return SYS_FS_ERROR_OK;
+}
+
+SYS_FS_RESULT SYS_FS_DriveFormat(const char* drive, const SYS_FS_FORMAT_PARAM* opt, void* work, uint32_t len)
+{
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_HANDLE SYS_FS_FileOpen(const char* fname, SYS_FS_FILE_OPEN_ATTRIBUTES attributes)
+{
+    uint32_t file = _fsFind(fname);
+
+    if ((file != TEST_FS_FILES_NUM) && (testFs.files[file].isDir == true))
+    {
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    if ((attributes == SYS_FS_FILE_OPEN_READ) || (attributes == SYS_FS_FILE_OPEN_READ_PLUS))
+    {
+        if (file == TEST_FS_FILES_NUM)
+        {
+            return SYS_FS_HANDLE_INVALID;
+        }
+    }
+    else if (file == TEST_FS_FILES_NUM)
+    {
+        file = _fsCreate(fname, false);
+        if (file == TEST_FS_FILES_NUM)
+        {
+            return SYS_FS_HANDLE_INVALID;
+        }
+    }
+    else if ((attributes == SYS_FS_FILE_OPEN_WRITE) || (attributes == SYS_FS_FILE_OPEN_WRITE_PLUS))
+    {
+        testFs.files[file].size = 0U;
+    }
+
+    return _fsNewHandle(file, false);
+}
+
+SYS_FS_RESULT SYS_FS_FileClose(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    pHandle->used = false;
+    return SYS_FS_RES_SUCCESS;
+}
+
+size_t SYS_FS_FileRead(SYS_FS_HANDLE handle, void *buffer, size_t nbyte)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    TEST_FS_FILE *pFile;
+    size_t count;
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return (size_t)-1;
+    }
+
+    pFile = &testFs.files[pHandle->file];
+    count = (pHandle->pos < pFile->size) ? (pFile->size - pHandle->pos) : 0U;
+    if (count > nbyte)
+    {
+        count = nbyte;
+    }
+
+    memcpy(buffer, &pFile->data[pHandle->pos], count);
+    pHandle->pos += (uint32_t)count;
+    testFs.reads++;
+    testFs.readBytes += (uint32_t)count;
+    return count;
+}
+
+size_t SYS_FS_FileWrite(SYS_FS_HANDLE handle, const void *buffer, size_t nbyte)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    TEST_FS_FILE *pFile;
+    uint32_t end;
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return (size_t)-1;
+    }
+
+    pFile = &testFs.files[pHandle->file];
+    end = pHandle->pos + (uint32_t)nbyte;
+    if (end > pFile->capacity)
+    {
+        pFile->capacity = (end + 0xFFFFU) & ~0xFFFFU;
+        pFile->data = realloc(pFile->data, pFile->capacity);
+        if (pFile->data == NULL)
+        {
+            printf("FAIL: out of memory\n");
+            exit(1);
+        }
+    }
+
+    memcpy(&pFile->data[pHandle->pos], buffer, nbyte);
+    pHandle->pos = end;
+    if (end > pFile->size)
+    {
+        pFile->size = end;
+    }
+
+    return nbyte;
+}
+
+int32_t SYS_FS_FileSeek(SYS_FS_HANDLE handle, int32_t offset, SYS_FS_FILE_SEEK_CONTROL whence)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+    int64_t pos;
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return -1;
+    }
+
+    pos = offset;
+    if (whence == SYS_FS_SEEK_CUR)
+    {
+        pos += pHandle->pos;
+    }
+    else if (whence == SYS_FS_SEEK_END)
+    {
+        pos += testFs.files[pHandle->file].size;
+    }
+
+    if ((pos < 0) || (pos > testFs.files[pHandle->file].size))
+    {
+        return -1;
+    }
+
+    pHandle->pos = (uint32_t)pos;
+    return (int32_t)pos;
+}
+
+int32_t SYS_FS_FileSize(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return -1;
+    }
+
+    return (int32_t)testFs.files[pHandle->file].size;
+}
+
+SYS_FS_RESULT SYS_FS_FileSync(SYS_FS_HANDLE handle)
+{
+    return (_fsHandle(handle) == NULL) ? SYS_FS_RES_FAILURE : SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileTruncate(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == true))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    testFs.files[pHandle->file].size = pHandle->pos;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileStat(const char *fname, SYS_FS_FSTAT *buf)
+{
+    uint32_t file = _fsFind(fname);
+
+    if (file == TEST_FS_FILES_NUM)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    buf->fsize = testFs.files[file].size;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_HANDLE SYS_FS_DirOpen(const char* path)
+{
+    uint32_t file = _fsFind(path);
+
+    if ((file == TEST_FS_FILES_NUM) || (testFs.files[file].isDir == false))
+    {
+        return SYS_FS_HANDLE_INVALID;
+    }
+
+    return _fsNewHandle(file, true);
+}
+
+SYS_FS_RESULT SYS_FS_DirClose(SYS_FS_HANDLE handle)
+{
+    TEST_FS_HANDLE_OBJ *pHandle = _fsHandle(handle);
+
+    if ((pHandle == NULL) || (pHandle->isDir == false))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    pHandle->used = false;
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_DirRead(SYS_FS_HANDLE handle, SYS_FS_FSTAT *stat)
+{
+    // Directories are not cleared by the benchmark
+    stat->fname[0] = '\0';
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_DirectoryMake(const char* path)
+{
+    if ((_fsFind(path) != TEST_FS_FILES_NUM) || (_fsCreate(path, true) == TEST_FS_FILES_NUM))
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    return SYS_FS_RES_SUCCESS;
+}
+
+SYS_FS_RESULT SYS_FS_FileDirectoryRemove(const char* path)
+{
+    uint32_t file = _fsFind(path);
+
+    if (file == TEST_FS_FILES_NUM)
+    {
+        return SYS_FS_RES_FAILURE;
+    }
+
+    testFs.files[file].used = false;
+    return SYS_FS_RES_SUCCESS;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+uint64_t SYS_TIME_Counter64Get(void)
+{
+    return testTimeMs * TEST_COUNTS_PER_MS;
+}
+
+uint32_t SYS_TIME_MSToCount(uint32_t ms)
+{
+    return ms * TEST_COUNTS_PER_MS;
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Datalog Requests
+// *****************************************************************************
+// *****************************************************************************
+
+static void _testEndCallback(APP_DATALOG_RESULT result)
+{
+    testLastResult = result;
+    testCallbacks++;
+}
+
+static void _testTasks(uint32_t calls)
+{
+    while (calls-- > 0U)
+    {
+        APP_DATALOG_Tasks();
+        testTimeMs++;
+    }
+}
+
+/* Reset: RAM is cleared and the datalog is started again */
+static void _testBoot(void)
+{
+    uint32_t idx;
+
+    for (idx = 0U; idx < TEST_FS_HANDLES_NUM; idx++)
+    {
+        testFs.handles[idx].used = false;
+    }
+
+    memset(&app_datalogData, 0, sizeof(app_datalogData));
+    APP_DATALOG_Initialize();
+    _testTasks(TEST_TASKS_PER_REQUEST);
+}
+
+static int _testRequest(APP_DATALOG_OPERATION operation, const APP_DATALOG_DATE *date, uint8_t *pData,
+        uint16_t dataLen)
+{
+    APP_DATALOG_QUEUE_DATA request;
+    uint32_t callbacks = testCallbacks;
+    uint32_t calls;
+
+    request.userId = APP_DATALOG_USER_PROFILE;
+    request.operation = operation;
+    request.endCallback = _testEndCallback;
+    request.date = *date;
+    request.dataLen = dataLen;
+    request.pData = pData;
+
+    if (APP_DATALOG_SendDatalogData(&request) == false)
+    {
+        return TEST_RESULT_NONE;
+    }
+
+    for (calls = 0U; (calls < TEST_TASKS_PER_REQUEST) && (testCallbacks == callbacks); calls++)
+    {
+        _testTasks(1U);
+    }
+
+    return (testCallbacks == callbacks) ? TEST_RESULT_NONE : (int)testLastResult;
+}
+
+/* Appends the next 15-minute record of a month */
+static bool _testAppend(TEST_MONTH *pMonth)
+{
+    APP_ENERGY_PROFILE_RECORD *pRecord = &pMonth->records[pMonth->numRecords];
+    uint32_t tariff;
+
+    pRecord->timeStamp = pMonth->timeStart + ((pMonth->numRecords + 1U) * TEST_PERIOD_S);
+    pRecord->demand = 200U + (uint32_t)(_rand64() % 5000U);
+    for (tariff = 0U; tariff < TARIFF_NUM_TYPE; tariff++)
+    {
+        pRecord->energy.tariff[tariff] = ((pMonth->numRecords == 0U) ? 0U : pRecord[-1].energy.tariff[tariff]) +
+                ((((pRecord->timeStamp / 3600U) % TARIFF_NUM_TYPE) == tariff) ? pRecord->demand : 0U);
+    }
+
+    pMonth->numRecords++;
+    return (_testRequest(APP_DATALOG_APPEND, &pMonth->date, (uint8_t *)pRecord, sizeof(*pRecord)) ==
+            (int)APP_DATALOG_RESULT_SUCCESS);
+}
+
+static void _testMonthInit(TEST_MONTH *pMonth, uint8_t month, uint32_t day, uint32_t days)
+{
+    pMonth->date.year = 24U;
+    pMonth->date.month = month;
+    pMonth->timeStart = day * TEST_DAY_S;
+    pMonth->timeEnd = (day + days) * TEST_DAY_S;
+    pMonth->records = calloc(days * (TEST_DAY_S / TEST_PERIOD_S), sizeof(APP_ENERGY_PROFILE_RECORD));
+    pMonth->numRecords = 0U;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Queries
+// *****************************************************************************
+// *****************************************************************************
+
+/* Walks the monthly files covered by the range, as APP_ENERGY_GetProfile
+   does, and checks the records against the appended ones */
+static void _testQuery(const TEST_QUERY *query)
+{
+    APP_DATALOG_RANGE_QUERY rangeQuery;
+    char fileName[32];
+    uint32_t expected = 0U;
+    uint32_t numRecords = 0U;
+    uint32_t scanBytes = 0U;
+    uint32_t reads = testFs.reads;
+    uint32_t readBytes = testFs.readBytes;
+    uint32_t month;
+    uint32_t idx;
+    uint32_t file;
+
+    for (month = 0U; month < TEST_MONTHS_NUM; month++)
+    {
+        TEST_MONTH *pMonth = &testMonths[month];
+
+        // Records of a month end at the first second of the next one
+        if ((query->timeEnd <= pMonth->timeStart) || (query->timeStart > pMonth->timeEnd) ||
+            (numRecords == query->maxRecords))
+        {
+            continue;
+        }
+
+        APP_DATALOG_GetFileNameByDate(APP_DATALOG_USER_PROFILE, &pMonth->date, fileName);
+        file = _fsFind(fileName);
+        scanBytes += (file == TEST_FS_FILES_NUM) ? 0U : testFs.files[file].size;
+
+        rangeQuery.timeStart = query->timeStart;
+        rangeQuery.timeEnd = query->timeEnd;
+        rangeQuery.pRecords = (uint8_t *)&testResponse[numRecords];
+        rangeQuery.recordLen = sizeof(APP_ENERGY_PROFILE_RECORD);
+        rangeQuery.maxRecords = query->maxRecords - numRecords;
+        rangeQuery.numRecords = 0U;
+
+        if (_testRequest(APP_DATALOG_READ_RANGE, &pMonth->date, (uint8_t *)&rangeQuery, sizeof(rangeQuery)) !=
+            (int)APP_DATALOG_RESULT_SUCCESS)
+        {
+            _fail(query->name, "range query failed, month", pMonth->date.month);
+            return;
+        }
+
+        // Records of the range in file order
+        for (idx = 0U; (idx < pMonth->numRecords) && (expected < query->maxRecords); idx++)
+        {
+            if ((pMonth->records[idx].timeStamp >= query->timeStart) && (pMonth->records[idx].timeStamp <= query->timeEnd))
+            {
+                if ((expected >= (numRecords + rangeQuery.numRecords)) ||
+                    (memcmp(&testResponse[expected], &pMonth->records[idx], sizeof(APP_ENERGY_PROFILE_RECORD)) != 0))
+                {
+                    _fail(query->name, "record missing or different, record", expected);
+                    return;
+                }
+                expected++;
+            }
+        }
+
+        numRecords += rangeQuery.numRecords;
+        if (numRecords != expected)
+        {
+            _fail(query->name, "records out of the range returned", numRecords - expected);
+            return;
+        }
+    }
+
+    reads = testFs.reads - reads;
+    readBytes = testFs.readBytes - readBytes;
+
+    printf("%-22s %7u %7u %9u %9u %5.1f%%\n", query->name, (unsigned)numRecords, (unsigned)reads, (unsigned)readBytes,
+            (unsigned)scanBytes, (scanBytes == 0U) ? 0.0 : (100.0 * readBytes) / scanBytes);
+
+    if ((query->indexed == true) && ((readBytes * 100U) > (scanBytes * TEST_MAX_SCAN_PERCENT)))
+    {
+        _fail(query->name, "bytes read by an indexed query", readBytes);
+    }
+}
+
+/* Clears the time range of the last block in the stored index of a month,
+   so that an index used without its CRC check skips the last records */
+static bool _testCorruptIndex(TEST_MONTH *pMonth)
+{
+    char fileName[32];
+    char indexName[32];
+    uint32_t file;
+
+    APP_DATALOG_GetFileNameByDate(APP_DATALOG_USER_PROFILE, &pMonth->date, fileName);
+    _APP_DATALOG_GetIndexFileName(fileName, indexName);
+    file = _fsFind(indexName);
+    if ((file == TEST_FS_FILES_NUM) ||
+        (testFs.files[file].size < (sizeof(APP_DATALOG_TS_INDEX_HEADER) + sizeof(APP_DATALOG_TS_BLOCK))))
+    {
+        return false;
+    }
+
+    memset(&testFs.files[file].data[testFs.files[file].size - sizeof(APP_DATALOG_TS_BLOCK)], 0,
+            sizeof(APP_DATALOG_TS_BLOCK));
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    TEST_MONTH *pMarch = &testMonths[0];
+    TEST_MONTH *pApril = &testMonths[1];
+    uint32_t now;
+    uint32_t idx;
+    uint32_t aprilRecords;
+    bool pass = true;
+
+    _testBoot();
+
+    // A month of records in March, April up to TEST_LATE_RECORDS periods
+    // before its end
+    _testMonthInit(pMarch, 3U, TEST_MARCH_DAY, TEST_APRIL_DAY - TEST_MARCH_DAY);
+    _testMonthInit(pApril, 4U, TEST_APRIL_DAY, TEST_APRIL_DAYS);
+    aprilRecords = (TEST_APRIL_DAYS * (TEST_DAY_S / TEST_PERIOD_S)) - TEST_LATE_RECORDS;
+
+    for (idx = 0U; idx < ((TEST_APRIL_DAY - TEST_MARCH_DAY) * (TEST_DAY_S / TEST_PERIOD_S)); idx++)
+    {
+        pass &= _testAppend(pMarch);
+    }
+
+    for (idx = 0U; idx < aprilRecords; idx++)
+    {
+        pass &= _testAppend(pApril);
+    }
+
+    if (pass == false)
+    {
+        _fail("append", "records appended, failed", 0U);
+    }
+
+    now = pApril->records[pApril->numRecords - 1U].timeStamp;
+
+    printf("%u + %u records of %u bytes, index blocks of %u records\n", (unsigned)pMarch->numRecords,
+            (unsigned)pApril->numRecords, (unsigned)sizeof(APP_ENERGY_PROFILE_RECORD), APP_DATALOG_TS_BLOCK_RECORDS);
+    printf("%-22s %7s %7s %9s %9s %6s\n", "", "records", "reads", "bytes", "scan", "");
+
+    {
+        const TEST_QUERY dayFirst = {"last day, first query", now - TEST_DAY_S, now, TEST_MAX_RECORDS, false};
+        const TEST_QUERY day = {"last day", now - TEST_DAY_S, now, TEST_MAX_RECORDS, true};
+        const TEST_QUERY hour = {"last hour", now - 3600U, now, TEST_MAX_RECORDS, true};
+        const TEST_QUERY truncated = {"last day, 10 records", now - TEST_DAY_S, now, 10U, true};
+        const TEST_QUERY crossFirst = {"month change, first", pApril->timeStart - (TEST_DAY_S / 2U),
+                pApril->timeStart + (TEST_DAY_S / 2U), TEST_MAX_RECORDS, false};
+        const TEST_QUERY cross = {"month change", pApril->timeStart - (TEST_DAY_S / 2U),
+                pApril->timeStart + (TEST_DAY_S / 2U), TEST_MAX_RECORDS, true};
+        const TEST_QUERY week = {"last week", now - (7U * TEST_DAY_S), now, TEST_MAX_RECORDS, false};
+        const TEST_QUERY all = {"both months", pMarch->timeStart, now + TEST_DAY_S, TEST_MAX_RECORDS, false};
+        TEST_QUERY late = {"appended records", 0U, 0U, TEST_MAX_RECORDS, true};
+        TEST_QUERY rebuilt = {"corrupt stored index", now - TEST_DAY_S, now, TEST_MAX_RECORDS, false};
+        TEST_QUERY reset = {"last day, after reset", now - TEST_DAY_S, now, TEST_MAX_RECORDS, true};
+
+        _testQuery(&dayFirst);
+        _testQuery(&day);
+        _testQuery(&hour);
+        _testQuery(&truncated);
+
+        // Index is extended by the appends
+        for (idx = 0U; idx < TEST_LATE_RECORDS; idx++)
+        {
+            if (_testAppend(pApril) == false)
+            {
+                _fail("append", "late record failed, record", idx);
+            }
+        }
+        late.timeStart = now + 1U;
+        now = pApril->records[pApril->numRecords - 1U].timeStamp;
+        late.timeEnd = now;
+        _testQuery(&late);
+
+        // Queries alternating between files load the stored indexes
+        _testQuery(&crossFirst);
+        _testQuery(&cross);
+        _testQuery(&hour);
+
+        _testBoot();
+        reset.timeStart = now - TEST_DAY_S;
+        reset.timeEnd = now;
+        _testQuery(&reset);
+        _testQuery(&week);
+        _testQuery(&all);
+
+        if (_testCorruptIndex(pApril) == false)
+        {
+            _fail("corrupt stored index", "no stored index, records", pApril->numRecords);
+        }
+        _testBoot();
+        rebuilt.timeStart = now - TEST_DAY_S;
+        rebuilt.timeEnd = now;
+        _testQuery(&rebuilt);
+        _testQuery(&reset);
+    }
+
+    pass = (testFails == 0U);
+    printf("%s\n", (pass == true) ? "PASS" : "FAIL");
+    return (pass == true) ? 0 : 1;
+}
@@ -0,0 +1,1001 @@
+/*******************************************************************************
+  Event stream test
+
+  File Name:
+    event_stream.c
+
+  Summary:
+    Host test of the event detection and the batched event storage of
+    app_events.c with event streams derived from synthetic waveforms.
+
+  Description:
+    app_events.c of the G3 metering demo is built for the host with a stub of
+    the datalog that keeps the last events record written. The test generates
+    the three phase voltages sample by sample, 20 samples per 50 Hz cycle with
+    a 5th harmonic and noise, and changes their level cycle by cycle:
+    normal levels, sags and swells from 1 cycle to 30 s, levels wandering
+    around the thresholds and chatter between two levels every 1 to 3
+    integration periods. For every integration period of 1 s the RMS
+    voltages and the AFE sag and swell flags, raised by the half cycles out of
+    +-10%, are queued to the events task as the metrology task does. The
+    events task sometimes runs late and finds up to 5 periods in the queue.
+
+    Each event has its own settings: events following the AFE flags, sags and
+    swells with hysteresis, a swell without hysteresis, and minimum periods
+    from 1 to 10. Thresholds are changed during the run, the events are
+    cleared once, and the meter is reset twice: once with the events record
+    restored, and once with a record written before the settings existed.
+
+    A reference model follows the condition of each event with a run length
+    counter, keeps the completed events and counts the ones overwritten in
+    the ring before being stored. After every period the event counters,
+    the ring, the drop counters and the last flags of app_events.c must be
+    equal to the model. Datalog writes must happen exactly when the model
+    expects them: right away for the first event after a quiet period, then
+    at most once every APP_EVENTS_STORE_PERIODS, and in the next period after
+    a settings change or a clear. Every record written must be equal to the
+    events in RAM.
+
+    Usage:
+      event_stream
+*******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "definitions.h"
+#include "app_events.h"
+
+#include "app_events.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_PERIODS                60000U
+#define TEST_CYCLES_PER_PERIOD      50U
+#define TEST_SAMPLES_PER_HALF       10U
+#define TEST_SAMPLES_PER_CYCLE      (2U * TEST_SAMPLES_PER_HALF)
+#define TEST_UN                     230.0
+#define TEST_NOISE                  0.003
+#define TEST_AFE_SAG                0.90
+#define TEST_AFE_SWELL              1.10
+#define TEST_NUM_PHASES             3U
+#define TEST_LOG_EVENTS             (EVENT_LOG_MAX_NUMBER - 1U)
+#define TEST_HISTORY                16U
+#define TEST_MAX_TASKS              16U
+#define TEST_MAX_FAILS_SHOWN        20U
+
+/* RMS voltage in the units of the thresholds, 0.0001 V */
+#define TEST_RMS(level)             ((uint32_t)((level) * TEST_UN * 10000.0))
+
+typedef enum
+{
+    TEST_SEG_NORMAL = 0,
+    TEST_SEG_SAG,
+    TEST_SEG_NEAR_SAG,
+    TEST_SEG_SWELL,
+    TEST_SEG_NEAR_SWELL,
+    TEST_SEG_CHATTER,
+} TEST_SEGMENT_TYPE;
+
+/* Level of a phase voltage, as a fraction of the nominal voltage */
+typedef struct
+{
+    TEST_SEGMENT_TYPE type;
+    double base;
+    double level;
+    double altLevel;
+    uint32_t cycles;
+    uint32_t toggleCycles;
+    uint32_t toggleLeft;
+} TEST_PHASE;
+
+typedef struct
+{
+    bool active;
+    /* Consecutive periods with the condition against the state */
+    uint32_t run;
+    struct tm startTime;
+    /* Completed events, event n at n % TEST_HISTORY */
+    APP_EVENTS_EVENT_INFO history[TEST_HISTORY];
+    uint32_t completedPeriod[TEST_HISTORY];
+    uint32_t count;
+    uint32_t storedCount;
+    uint32_t dropped;
+    uint32_t total;
+    uint32_t totalDropped;
+} TEST_MODEL_EVENT;
+
+/* Events data queued and not processed yet */
+typedef struct
+{
+    APP_EVENTS_QUEUE_DATA data[APP_EVENTS_QUEUE_DATA_SIZE];
+    uint32_t period[APP_EVENTS_QUEUE_DATA_SIZE];
+    uint8_t first;
+    uint8_t size;
+} TEST_FIFO;
+
+/* Settings change, clear or reset before a period */
+typedef struct
+{
+    uint32_t period;
+    uint8_t eventId;
+    APP_EVENTS_EVENT_CONFIG config;
+} TEST_CHANGE;
+
+#define TEST_CHANGE_CLEAR           0xF0U
+#define TEST_CHANGE_RESET           0xF1U
+#define TEST_CHANGE_RESET_OLD       0xF2U
+
+static const APP_EVENTS_EVENT_CONFIG testEventConfig[EVENTS_NUM_ID] =
+{
+    /* SAG_UA: AFE flag */
+    {0, 0, 2, 3},
+    /* SAG_UB: 90% / 92% */
+    {TEST_RMS(0.90), TEST_RMS(0.92), 1, 1},
+    /* SAG_UC: 85% / 87%, long filters */
+    {TEST_RMS(0.85), TEST_RMS(0.87), 5, 10},
+    /* POW_UA: AFE flag */
+    {0, 0, 1, 2},
+    /* POW_UB: 110% / 108% */
+    {TEST_RMS(1.10), TEST_RMS(1.08), 3, 3},
+    /* POW_UC: 110%, no hysteresis */
+    {TEST_RMS(1.10), TEST_RMS(1.10), 1, 1},
+};
+
+static const TEST_CHANGE testChanges[] =
+{
+    {15000U, SAG_UB_EVENT_ID, {TEST_RMS(0.88), TEST_RMS(0.95), 1, 1}},
+    {22000U, TEST_CHANGE_CLEAR, {0, 0, 0, 0}},
+    {30000U, POW_UA_EVENT_ID, {TEST_RMS(1.12), TEST_RMS(1.09), 1, 2}},
+    {36000U, TEST_CHANGE_RESET, {0, 0, 0, 0}},
+    {51000U, TEST_CHANGE_RESET_OLD, {0, 0, 0, 0}},
+};
+
+static const struct tm testNoTime;
+static double testWave[TEST_SAMPLES_PER_CYCLE];
+static TEST_PHASE testPhases[TEST_NUM_PHASES];
+static TEST_MODEL_EVENT testModel[EVENTS_NUM_ID];
+static APP_EVENTS_EVENT_CONFIG testConfig[EVENTS_NUM_ID];
+static TEST_FIFO testFifo;
+static APP_EVENTS_EVENTS testStored;
+static bool testFileExists;
+static uint32_t testWrites;
+static uint32_t testReads;
+static uint32_t testClears;
+static bool testStorePending;
+static bool testStoreForced;
+static bool testLastStoreValid;
+static uint32_t testLastStore;
+static uint32_t testMaxLatency;
+static uint32_t testImmediateStores;
+static uint32_t testLateRuns;
+static time_t testStart;
+static uint32_t testFails;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+APP_DATALOG_STATES APP_DATALOG_GetStatus(void)
+{
+    return APP_DATALOG_STATE_READY;
+}
+
+bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date)
+{
+    (void) date;
+    return (userId == APP_DATALOG_USER_EVENTS) && testFileExists;
+}
+
+void APP_DATALOG_ClearData(APP_DATALOG_USER userId)
+{
+    if (userId == APP_DATALOG_USER_EVENTS)
+    {
+        testClears++;
+    }
+}
+
+bool APP_DATALOG_SendDatalogData(APP_DATALOG_QUEUE_DATA *datalogData)
+{
+    if ((datalogData->userId != APP_DATALOG_USER_EVENTS) || (datalogData->dataLen != sizeof(testStored)))
+    {
+        testFails++;
+        printf("FAIL: datalog: user %u, length %u\n", (unsigned)datalogData->userId,
+                (unsigned)datalogData->dataLen);
+        return false;
+    }
+
+    if (datalogData->operation == APP_DATALOG_WRITE)
+    {
+        /* The record is copied when written, the datalog task may run later */
+        memcpy(&testStored, datalogData->pData, sizeof(testStored));
+        testFileExists = true;
+        testWrites++;
+    }
+    else
+    {
+        memcpy(datalogData->pData, &testStored, sizeof(testStored));
+        testReads++;
+        if (datalogData->endCallback != NULL)
+        {
+            datalogData->endCallback(APP_DATALOG_RESULT_SUCCESS);
+        }
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+/* Uniform in [0, 1) */
+static double _randUnit(void)
+{
+    return (double)(_rand64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint32_t _randRange(uint32_t min, uint32_t max)
+{
+    return min + (uint32_t)(_rand64() % (uint64_t)(max - min + 1U));
+}
+
+static void _fail(uint32_t period, const char *name, const char *msg, uint32_t value)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: period %u: %s: %s %u\n", (unsigned)period, name, msg, (unsigned)value);
+    }
+}
+
+static const char *_eventName(uint8_t eventId)
+{
+    static const char *names[EVENTS_NUM_ID] = {"SAG_UA", "SAG_UB", "SAG_UC", "POW_UA", "POW_UB", "POW_UC"};
+
+    return names[eventId];
+}
+
+static bool _infoIsClear(const APP_EVENTS_EVENT_INFO *info)
+{
+    return (memcmp(&info->startTime, &testNoTime, sizeof(struct tm)) == 0) &&
+            (memcmp(&info->endTime, &testNoTime, sizeof(struct tm)) == 0);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Waveforms
+// *****************************************************************************
+// *****************************************************************************
+
+static void _waveInit(void)
+{
+    double angle;
+    uint32_t idx;
+
+    /* Fundamental and 4% of 5th harmonic, scaled to an RMS value of 1 */
+    for (idx = 0U; idx < TEST_SAMPLES_PER_CYCLE; idx++)
+    {
+        angle = (2.0 * M_PI * idx) / TEST_SAMPLES_PER_CYCLE;
+        testWave[idx] = M_SQRT2 * (sin(angle) + (0.04 * sin(5.0 * angle))) / sqrt(1.0016);
+    }
+}
+
+static void _phaseNextSegment(TEST_PHASE *phase)
+{
+    uint32_t select = _randRange(0U, 99U);
+
+    phase->toggleCycles = 0U;
+    if (select < 50U)
+    {
+        phase->type = TEST_SEG_NORMAL;
+        phase->base = 0.97 + (0.06 * _randUnit());
+        phase->cycles = _randRange(50U, 3000U);
+    }
+    else if (select < 62U)
+    {
+        phase->type = TEST_SEG_SAG;
+        phase->base = 0.50 + (0.39 * _randUnit());
+        phase->cycles = _randRange(1U, 1500U);
+    }
+    else if (select < 72U)
+    {
+        phase->type = TEST_SEG_NEAR_SAG;
+        phase->base = 0.83 + (0.12 * _randUnit());
+        phase->cycles = _randRange(100U, 1500U);
+    }
+    else if (select < 82U)
+    {
+        phase->type = TEST_SEG_SWELL;
+        phase->base = 1.11 + (0.14 * _randUnit());
+        phase->cycles = _randRange(1U, 1500U);
+    }
+    else if (select < 90U)
+    {
+        phase->type = TEST_SEG_NEAR_SWELL;
+        phase->base = 1.06 + (0.08 * _randUnit());
+        phase->cycles = _randRange(100U, 1500U);
+    }
+    else
+    {
+        /* Between the normal level and a sag or a swell every 1 to 3 periods */
+        phase->type = TEST_SEG_CHATTER;
+        phase->base = 1.0;
+        phase->altLevel = (_randUnit() < 0.5) ? 0.80 : 1.20;
+        phase->cycles = _randRange(500U, 5000U);
+        phase->toggleCycles = _randRange(TEST_CYCLES_PER_PERIOD, 3U * TEST_CYCLES_PER_PERIOD);
+        phase->toggleLeft = phase->toggleCycles;
+    }
+
+    phase->level = phase->base;
+}
+
+/* Level of the next cycle */
+static double _phaseCycle(TEST_PHASE *phase)
+{
+    double level;
+
+    if (phase->cycles == 0U)
+    {
+        _phaseNextSegment(phase);
+    }
+    phase->cycles--;
+
+    if ((phase->type == TEST_SEG_NEAR_SAG) || (phase->type == TEST_SEG_NEAR_SWELL))
+    {
+        /* Random walk around the thresholds */
+        phase->level += (_randUnit() - 0.5) * 0.003;
+        if (phase->level < (phase->base - 0.04))
+        {
+            phase->level = phase->base - 0.04;
+        }
+        else if (phase->level > (phase->base + 0.04))
+        {
+            phase->level = phase->base + 0.04;
+        }
+    }
+
+    if (phase->type == TEST_SEG_CHATTER)
+    {
+        if (--phase->toggleLeft == 0U)
+        {
+            level = phase->level;
+            phase->level = phase->altLevel;
+            phase->altLevel = level;
+            phase->toggleLeft = phase->toggleCycles;
+        }
+    }
+
+    return phase->level * (1.0 + ((_randUnit() - 0.5) * 0.004));
+}
+
+/* RMS voltage and AFE flags of a phase over an integration period */
+static uint32_t _phasePeriod(TEST_PHASE *phase, bool *sag, bool *swell)
+{
+    double amplitude, sample, halfSum, sum = 0.0, halfRms;
+    uint32_t cycle, half, idx;
+
+    *sag = false;
+    *swell = false;
+    for (cycle = 0U; cycle < TEST_CYCLES_PER_PERIOD; cycle++)
+    {
+        amplitude = _phaseCycle(phase) * TEST_UN;
+        for (half = 0U; half < 2U; half++)
+        {
+            halfSum = 0.0;
+            for (idx = half * TEST_SAMPLES_PER_HALF; idx < ((half + 1U) * TEST_SAMPLES_PER_HALF); idx++)
+            {
+                sample = (amplitude * testWave[idx]) + ((_randUnit() - 0.5) * 2.0 * TEST_NOISE * TEST_UN);
+                halfSum += sample * sample;
+            }
+
+            halfRms = sqrt(halfSum / TEST_SAMPLES_PER_HALF);
+            *sag = *sag || (halfRms < (TEST_AFE_SAG * TEST_UN));
+            *swell = *swell || (halfRms > (TEST_AFE_SWELL * TEST_UN));
+            sum += halfSum;
+        }
+    }
+
+    return (uint32_t)((sqrt(sum / (TEST_CYCLES_PER_PERIOD * TEST_SAMPLES_PER_CYCLE)) * 10000.0) + 0.5);
+}
+
+static void _generatePeriod(uint32_t period, APP_EVENTS_QUEUE_DATA *data)
+{
+    time_t time = testStart + (time_t)period;
+    bool sag[TEST_NUM_PHASES], swell[TEST_NUM_PHASES];
+
+    memset(data, 0, sizeof(*data));
+    data->rmsUA = _phasePeriod(&testPhases[0], &sag[0], &swell[0]);
+    data->rmsUB = _phasePeriod(&testPhases[1], &sag[1], &swell[1]);
+    data->rmsUC = _phasePeriod(&testPhases[2], &sag[2], &swell[2]);
+    data->eventFlags.sagA = sag[0];
+    data->eventFlags.sagB = sag[1];
+    data->eventFlags.sagC = sag[2];
+    data->eventFlags.swellA = swell[0];
+    data->eventFlags.swellB = swell[1];
+    data->eventFlags.swellC = swell[2];
+    data->eventFlags.paDir = (period >> 3) & 1U;
+    data->eventFlags.qcDir = (period >> 5) & 1U;
+    (void) gmtime_r(&time, &data->eventTime);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Model
+// *****************************************************************************
+// *****************************************************************************
+
+static bool _modelCondition(uint8_t eventId, const APP_EVENTS_QUEUE_DATA *data)
+{
+    const APP_EVENTS_EVENT_CONFIG *config = &testConfig[eventId];
+    uint32_t rms, threshold;
+    bool flag;
+
+    switch (eventId)
+    {
+        case SAG_UA_EVENT_ID: flag = data->eventFlags.sagA; rms = data->rmsUA; break;
+        case SAG_UB_EVENT_ID: flag = data->eventFlags.sagB; rms = data->rmsUB; break;
+        case SAG_UC_EVENT_ID: flag = data->eventFlags.sagC; rms = data->rmsUC; break;
+        case POW_UA_EVENT_ID: flag = data->eventFlags.swellA; rms = data->rmsUA; break;
+        case POW_UB_EVENT_ID: flag = data->eventFlags.swellB; rms = data->rmsUB; break;
+        default: flag = data->eventFlags.swellC; rms = data->rmsUC; break;
+    }
+
+    if (config->startThreshold == 0U)
+    {
+        return flag;
+    }
+
+    threshold = testModel[eventId].active ? config->endThreshold : config->startThreshold;
+    return (eventId <= SAG_UC_EVENT_ID) ? (rms < threshold) : (rms > threshold);
+}
+
+/* Returns true when an event is completed */
+static bool _modelStep(uint8_t eventId, const APP_EVENTS_QUEUE_DATA *data, uint32_t period)
+{
+    TEST_MODEL_EVENT *event = &testModel[eventId];
+    APP_EVENTS_EVENT_INFO *info;
+
+    if (_modelCondition(eventId, data) != event->active)
+    {
+        event->run++;
+    }
+    else
+    {
+        event->run = 0U;
+    }
+
+    if ((event->active == false) && (event->run > testConfig[eventId].minStartPeriods))
+    {
+        event->active = true;
+        event->run = 0U;
+        event->startTime = data->eventTime;
+    }
+    else if ((event->active == true) && (event->run > testConfig[eventId].minEndPeriods))
+    {
+        event->active = false;
+        event->run = 0U;
+        event->count++;
+        event->total++;
+        info = &event->history[event->count % TEST_HISTORY];
+        info->startTime = event->startTime;
+        info->endTime = data->eventTime;
+        event->completedPeriod[event->count % TEST_HISTORY] = period;
+
+        /* The ring keeps the last TEST_LOG_EVENTS completed events: the one
+           completed TEST_LOG_EVENTS before is overwritten now */
+        if (event->count > (event->storedCount + TEST_LOG_EVENTS))
+        {
+            event->dropped++;
+            event->totalDropped++;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+static void _modelStored(uint32_t period)
+{
+    TEST_MODEL_EVENT *event;
+    uint32_t eventId, number, first, latency;
+
+    for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+    {
+        event = &testModel[eventId];
+        first = event->storedCount + 1U;
+        if ((event->count >= TEST_LOG_EVENTS) && (first < (event->count - TEST_LOG_EVENTS + 1U)))
+        {
+            first = event->count - TEST_LOG_EVENTS + 1U;
+        }
+
+        for (number = first; number <= event->count; number++)
+        {
+            latency = period - event->completedPeriod[number % TEST_HISTORY];
+            if (latency > testMaxLatency)
+            {
+                testMaxLatency = latency;
+            }
+            if ((latency == 0U) && (testStoreForced == false))
+            {
+                testImmediateStores++;
+            }
+        }
+
+        event->storedCount = event->count;
+    }
+
+    testStorePending = false;
+    testStoreForced = false;
+    testLastStoreValid = true;
+    testLastStore = period;
+}
+
+/* State of the events in progress after a reset, from the restored record */
+static void _modelResync(void)
+{
+    APP_EVENTS_EVENT_DATA *data;
+    TEST_MODEL_EVENT *event;
+    uint8_t eventId;
+
+    for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+    {
+        data = &app_eventsData.events.event[eventId];
+        event = &testModel[eventId];
+        event->active = (data->status == EVENT_START) || (data->status == EVENT_HOLDING_END);
+        event->run = 0U;
+        if (data->status == EVENT_HOLDING_START)
+        {
+            event->run = testConfig[eventId].minStartPeriods + 1U - data->holdingCounter;
+        }
+        else if (data->status == EVENT_HOLDING_END)
+        {
+            event->run = testConfig[eventId].minEndPeriods + 1U - data->holdingCounter;
+        }
+        event->startTime = data->data[data->dataIndex].startTime;
+    }
+
+    testStorePending = false;
+    testStoreForced = false;
+    testLastStoreValid = false;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+// *****************************************************************************
+// *****************************************************************************
+
+static void _checkEvents(uint32_t period, const APP_EVENTS_QUEUE_DATA *data)
+{
+    TEST_MODEL_EVENT *event;
+    APP_EVENTS_EVENT_INFO info;
+    APP_EVENTS_EVENT_CONFIG config;
+    APP_EVENTS_FLAGS flags;
+    uint16_t dropped;
+    uint8_t eventId, offset, counter;
+
+    for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+    {
+        event = &testModel[eventId];
+
+        (void) APP_EVENTS_GetNumEvents((APP_EVENTS_EVENT_ID)eventId, &counter);
+        if ((counter != (uint8_t)event->count) ||
+                (app_eventsData.events.event[eventId].counter != (uint16_t)event->count))
+        {
+            _fail(period, _eventName(eventId), "event counter, expected", event->count);
+            return;
+        }
+
+        (void) APP_EVENTS_GetDroppedEvents((APP_EVENTS_EVENT_ID)eventId, &dropped);
+        if (dropped != event->dropped)
+        {
+            _fail(period, _eventName(eventId), "dropped events, expected", event->dropped);
+            return;
+        }
+
+        (void) APP_EVENTS_GetEventConfig((APP_EVENTS_EVENT_ID)eventId, &config);
+        if (memcmp(&config, &testConfig[eventId], sizeof(config)) != 0)
+        {
+            _fail(period, _eventName(eventId), "settings differ, start threshold", config.startThreshold);
+            return;
+        }
+
+        /* Offset 0 is the event in progress */
+        (void) APP_EVENTS_GetEventInfo((APP_EVENTS_EVENT_ID)eventId, 0U, &info);
+        if (event->active)
+        {
+            if ((memcmp(&info.startTime, &event->startTime, sizeof(struct tm)) != 0) ||
+                    (memcmp(&info.endTime, &testNoTime, sizeof(struct tm)) != 0))
+            {
+                _fail(period, _eventName(eventId), "event in progress, start minute", event->startTime.tm_min);
+                return;
+            }
+        }
+        else if (_infoIsClear(&info) == false)
+        {
+            _fail(period, _eventName(eventId), "no event in progress, start minute", info.startTime.tm_min);
+            return;
+        }
+
+        for (offset = 1U; (offset <= TEST_LOG_EVENTS) && (offset <= event->count); offset++)
+        {
+            (void) APP_EVENTS_GetEventInfo((APP_EVENTS_EVENT_ID)eventId, offset, &info);
+            if (memcmp(&info, &event->history[(event->count + 1U - offset) % TEST_HISTORY], sizeof(info)) != 0)
+            {
+                _fail(period, _eventName(eventId), "completed event differs, offset", offset);
+                return;
+            }
+        }
+    }
+
+    APP_EVENTS_GetLastEventFlags(&flags);
+    if ((flags.sagA != data->eventFlags.sagA) || (flags.sagB != data->eventFlags.sagB) ||
+            (flags.sagC != data->eventFlags.sagC) || (flags.swellA != data->eventFlags.swellA) ||
+            (flags.swellB != data->eventFlags.swellB) || (flags.swellC != data->eventFlags.swellC) ||
+            (flags.paDir != data->eventFlags.paDir) || (flags.qcDir != data->eventFlags.qcDir))
+    {
+        _fail(period, "flags", "last flags differ, sagA", flags.sagA);
+    }
+}
+
+static void _checkStore(uint32_t period, uint32_t writes, bool expected)
+{
+    if (writes != (expected ? 1U : 0U))
+    {
+        _fail(period, "store", expected ? "events not stored, writes" : "events stored too early, writes", writes);
+    }
+
+    if (writes > 0U)
+    {
+        if (memcmp(&testStored, &app_eventsData.events, sizeof(testStored)) != 0)
+        {
+            _fail(period, "store", "record differs from the events in RAM, writes", writes);
+        }
+        _modelStored(period);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Test Run
+// *****************************************************************************
+// *****************************************************************************
+
+static bool _runUntilRunning(void)
+{
+    uint32_t tasks;
+
+    for (tasks = 0U; tasks < TEST_MAX_TASKS; tasks++)
+    {
+        APP_EVENTS_Tasks();
+        if (app_eventsData.state == APP_EVENTS_STATE_RUNNING)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Events task run for every period in the queue */
+static void _drain(void)
+{
+    APP_EVENTS_QUEUE_DATA *data;
+    uint32_t period, writes, eventId;
+    bool update = false;
+    bool expected;
+
+    while (testFifo.size > 0U)
+    {
+        data = &testFifo.data[testFifo.first];
+        period = testFifo.period[testFifo.first];
+
+        writes = testWrites;
+        APP_EVENTS_Tasks();
+        writes = testWrites - writes;
+
+        update = false;
+        for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+        {
+            update = _modelStep((uint8_t)eventId, data, period) || update;
+        }
+
+        testStorePending = testStorePending || update;
+        expected = testStorePending && (testStoreForced || (testLastStoreValid == false) ||
+                ((period - testLastStore) >= APP_EVENTS_STORE_PERIODS));
+
+        _checkEvents(period, data);
+        _checkStore(period, writes, expected);
+
+        testFifo.first = (testFifo.first + 1U) % APP_EVENTS_QUEUE_DATA_SIZE;
+        testFifo.size--;
+    }
+}
+
+static void _reset(uint32_t period, bool oldRecord)
+{
+    uint32_t writes, reads, eventId;
+
+    /* Events still pending are stored before the reset */
+    writes = testWrites;
+    APP_EVENTS_StoreEvents();
+    _checkStore(period, testWrites - writes, testStorePending);
+
+    if (oldRecord)
+    {
+        /* Record written before the settings were stored with the events */
+        testStored.marker = 0U;
+    }
+
+    writes = testWrites;
+    reads = testReads;
+    APP_EVENTS_Initialize();
+    if (_runUntilRunning() == false)
+    {
+        _fail(period, "reset", "events task not running, state", app_eventsData.state);
+        return;
+    }
+
+    if (testReads != (reads + 1U))
+    {
+        _fail(period, "reset", "events record not read, reads", testReads - reads);
+    }
+
+    if (oldRecord)
+    {
+        /* Default settings, drop counters cleared and stored at once */
+        for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+        {
+            testConfig[eventId].startThreshold = 0U;
+            testConfig[eventId].endThreshold = 0U;
+            testConfig[eventId].minStartPeriods = EVENT_HOLDING_START_COUNTER;
+            testConfig[eventId].minEndPeriods = EVENT_HOLDING_END_COUNTER;
+            testModel[eventId].dropped = 0U;
+        }
+
+        if (testWrites != (writes + 1U))
+        {
+            _fail(period, "reset", "default settings not stored, writes", testWrites - writes);
+        }
+    }
+    else if (testWrites != writes)
+    {
+        _fail(period, "reset", "events record written at start up, writes", testWrites - writes);
+    }
+
+    if ((oldRecord == false) && (memcmp(&app_eventsData.events, &testStored, sizeof(testStored)) != 0))
+    {
+        _fail(period, "reset", "events differ from the record read", 0U);
+    }
+
+    _modelResync();
+}
+
+static void _applyChanges(uint32_t period)
+{
+    APP_EVENTS_EVENT_CONFIG config;
+    uint32_t eventId;
+    size_t idx;
+
+    for (idx = 0U; idx < (sizeof(testChanges) / sizeof(testChanges[0])); idx++)
+    {
+        if (testChanges[idx].period != period)
+        {
+            continue;
+        }
+
+        _drain();
+        if (testChanges[idx].eventId == TEST_CHANGE_CLEAR)
+        {
+            APP_EVENTS_ClearEvents();
+            for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+            {
+                memset(&testModel[eventId].startTime, 0, sizeof(struct tm));
+                testModel[eventId].active = false;
+                testModel[eventId].run = 0U;
+                testModel[eventId].count = 0U;
+                testModel[eventId].storedCount = 0U;
+                testModel[eventId].dropped = 0U;
+            }
+            testStorePending = true;
+            testStoreForced = true;
+        }
+        else if (testChanges[idx].eventId == TEST_CHANGE_RESET)
+        {
+            _reset(period, false);
+        }
+        else if (testChanges[idx].eventId == TEST_CHANGE_RESET_OLD)
+        {
+            _reset(period, true);
+        }
+        else
+        {
+            config = testChanges[idx].config;
+            if (APP_EVENTS_SetEventConfig((APP_EVENTS_EVENT_ID)testChanges[idx].eventId, &config) == false)
+            {
+                _fail(period, _eventName(testChanges[idx].eventId), "settings rejected", 0U);
+                continue;
+            }
+            testConfig[testChanges[idx].eventId] = config;
+            testStorePending = true;
+            testStoreForced = true;
+        }
+    }
+}
+
+static void _setConfig(void)
+{
+    APP_EVENTS_EVENT_CONFIG config;
+    uint32_t eventId;
+
+    /* Invalid settings: no filter, sag or swell without hysteresis, event */
+    config = testEventConfig[SAG_UA_EVENT_ID];
+    config.minStartPeriods = 0U;
+    if (APP_EVENTS_SetEventConfig(SAG_UA_EVENT_ID, &config) == true)
+    {
+        _fail(0U, "settings", "no start filter accepted", 0U);
+    }
+
+    config = testEventConfig[SAG_UB_EVENT_ID];
+    config.endThreshold = config.startThreshold - 1U;
+    if (APP_EVENTS_SetEventConfig(SAG_UB_EVENT_ID, &config) == true)
+    {
+        _fail(0U, "settings", "sag end threshold below the start one accepted", config.endThreshold);
+    }
+
+    config = testEventConfig[POW_UB_EVENT_ID];
+    config.endThreshold = config.startThreshold + 1U;
+    if (APP_EVENTS_SetEventConfig(POW_UB_EVENT_ID, &config) == true)
+    {
+        _fail(0U, "settings", "swell end threshold above the start one accepted", config.endThreshold);
+    }
+
+    if (APP_EVENTS_SetEventConfig(EVENTS_NUM_ID, &config) == true)
+    {
+        _fail(0U, "settings", "invalid event accepted", EVENTS_NUM_ID);
+    }
+
+    if (app_eventsData.storePending == true)
+    {
+        _fail(0U, "settings", "store requested by invalid settings", 0U);
+    }
+
+    for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+    {
+        config = testEventConfig[eventId];
+        if (APP_EVENTS_SetEventConfig((APP_EVENTS_EVENT_ID)eventId, &config) == false)
+        {
+            _fail(0U, _eventName(eventId), "settings rejected", 0U);
+        }
+        testConfig[eventId] = testEventConfig[eventId];
+    }
+
+    testStorePending = true;
+    testStoreForced = true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    APP_EVENTS_QUEUE_DATA data;
+    uint32_t period, late = 0U, idx, eventId, writes;
+    uint32_t completed = 0U, dropped = 0U;
+    bool pass;
+
+    _waveInit();
+    testStart = 1861920000;
+
+    APP_EVENTS_Initialize();
+    if ((_runUntilRunning() == false) || (testWrites != 1U))
+    {
+        printf("FAIL: initialization: state %u, writes %u\n", (unsigned)app_eventsData.state,
+                (unsigned)testWrites);
+        return 1;
+    }
+    _setConfig();
+
+    for (period = 0U; period < TEST_PERIODS; period++)
+    {
+        _applyChanges(period);
+
+        _generatePeriod(period, &data);
+        if (APP_EVENTS_SendEventsData(&data) == false)
+        {
+            _fail(period, "queue", "period not queued, queued", testFifo.size);
+            continue;
+        }
+        idx = (testFifo.first + testFifo.size) % APP_EVENTS_QUEUE_DATA_SIZE;
+        testFifo.data[idx] = data;
+        testFifo.period[idx] = period;
+        testFifo.size++;
+
+        /* The events task is late now and then and finds several periods */
+        if (late > 0U)
+        {
+            late--;
+        }
+        else if (_randRange(0U, 99U) < 5U)
+        {
+            late = _randRange(1U, APP_EVENTS_QUEUE_DATA_SIZE - 1U);
+            testLateRuns++;
+        }
+
+        if (late == 0U)
+        {
+            _drain();
+        }
+    }
+
+    _drain();
+    writes = testWrites;
+    APP_EVENTS_StoreEvents();
+    _checkStore(period, testWrites - writes, testStorePending);
+
+    /* The queue holds APP_EVENTS_QUEUE_DATA_SIZE periods */
+    for (idx = 0U; idx <= APP_EVENTS_QUEUE_DATA_SIZE; idx++)
+    {
+        if (APP_EVENTS_SendEventsData(&data) != (idx < APP_EVENTS_QUEUE_DATA_SIZE))
+        {
+            _fail(period, "queue", "queue size, period", idx);
+        }
+    }
+
+    for (eventId = 0U; eventId < EVENTS_NUM_ID; eventId++)
+    {
+        printf("%s: events %u, dropped %u\n", _eventName(eventId), (unsigned)testModel[eventId].total,
+                (unsigned)testModel[eventId].totalDropped);
+        completed += testModel[eventId].total;
+        dropped += testModel[eventId].totalDropped;
+        if (testModel[eventId].total == 0U)
+        {
+            _fail(period, _eventName(eventId), "no events completed", 0U);
+        }
+    }
+
+    if ((dropped == 0U) || (testImmediateStores == 0U) || (testClears != 1U))
+    {
+        _fail(period, "run", "dropped events, immediate stores or clears missing, clears", testClears);
+    }
+
+    if (testMaxLatency >= APP_EVENTS_STORE_PERIODS)
+    {
+        _fail(period, "run", "store latency, periods", testMaxLatency);
+    }
+
+    printf("periods %u (late task %u times), events %u, dropped %u, datalog writes %u, "
+            "stored right away %u, max store latency %u periods\n", (unsigned)TEST_PERIODS,
+            (unsigned)testLateRuns, (unsigned)completed, (unsigned)dropped, (unsigned)testWrites,
+            (unsigned)testImmediateStores, (unsigned)testMaxLatency);
+
+    pass = (testFails == 0U);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+/*******************************************************************************
+  Host stub of the XC32 sys/attribs.h for the event stream test
+
+  Summary:
+    Function placement attributes, empty on the host.
+*******************************************************************************/
+
+#ifndef _SYS_ATTRIBS_H
+#define _SYS_ATTRIBS_H
+
+#define __longramfunc__
+#define __ramfunc__
+
+#endif  // _SYS_ATTRIBS_H
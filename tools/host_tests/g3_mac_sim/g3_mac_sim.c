@@ -0,0 +1,906 @@
+/*******************************************************************************
+  G3 MAC wrapper network simulation test
+
+  File Name:
+    g3_mac_sim.c
+
+  Summary:
+    Host test of mac_wrapper.c over simulated PLC and RF MAC layers.
+
+  Description:
+    mac_wrapper.c and mac_common.c of the G3 coordinator configuration run
+    on every node of a simulated network (see mac_sim.c), with a packet
+    error rate and an LQI per link and medium and a simulated time. The
+    test acts as the upper layer of every node, through MAC_WRP_* calls and
+    the MAC wrapper callbacks.
+
+    The functional part uses four nodes with fixed links: network start,
+    scan with beacons from both media, PLC_BACKUP_RF with and without an RF
+    POS entry for the destination, RF_BACKUP_PLC, BOTH with the duplicate
+    dropped by the wrapper, the QUEUE_FULL confirm of a third request and
+    the millisecond and second counters of every node. Confirm statuses,
+    media types and times are checked against the timing of the simulation.
+
+    The network part places the nodes on a grid, with PLC and RF links
+    whose PER and LQI degrade with the distance and some links missing on
+    one of the media. Every node sends a broadcast on both media and then
+    unicast frames to random neighbours with random media types. Every
+    request must be confirmed once, every indication must carry the sent
+    MSDU, addresses and link LQI, a medium must not indicate a frame twice,
+    and a SUCCESS confirm needs an indication at the destination. The
+    success ratio of PLC_NO_BACKUP and RF_NO_BACKUP frames and the
+    reception ratio of broadcast frames must agree with the link PER. The
+    frames indicated on both media after a backup or BOTH request, which
+    the duplicate table of the wrapper missed, are counted.
+
+    The adaptation layer, LOADng and LBP are prebuilt libraries of the
+    stack, so routing and bootstrap are not part of this test.
+
+    Usage:
+      g3_mac_sim [nodes] [seconds] [seed]    500 nodes, 120 s, seed 1 by
+                                             default
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "configuration.h"
+#include "stack/g3/mac/mac_wrapper/mac_wrapper.h"
+#include "mac_sim.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_PAN_ID                 0x781DU
+#define TEST_NODE_BROADCAST         0xFFFFU
+#define TEST_FRAME_NONE             0xFFFFFFFFU
+#define TEST_BEACONS_MAX            16U
+#define TEST_MAX_FAILS_SHOWN        10
+
+/* Network run */
+#define TEST_DEFAULT_NODES          500U
+#define TEST_DEFAULT_SECONDS        120U
+#define TEST_STEP_US                10000U
+#define TEST_HELLO_US               2000000U
+#define TEST_SEND_MEAN_US           4000000.0
+#define TEST_STOP_BEFORE_END_US     10000000U
+#define TEST_LEN_MIN                20U
+#define TEST_LEN_MAX                200U
+
+/* Allowed deviation of the PER checks, in standard deviations */
+#define TEST_SIGMAS                 4.0
+
+typedef struct
+{
+    uint16_t        src;
+    uint16_t        dst;
+    uint16_t        len;
+    uint8_t         mediaType;
+    uint8_t         status;
+    uint8_t         confMediaType;
+    uint8_t         confirms;
+    uint16_t        ind[MAC_SIM_MEDIA];
+    uint64_t        requestUS;
+    uint64_t        confirmUS;
+} TEST_FRAME;
+
+typedef struct
+{
+    MAC_WRP_HANDLE  handle;
+    uint8_t         nextHandle;
+    uint8_t         pending;
+    uint32_t        handleFrame[256];
+    uint64_t        nextSendUS;
+    uint32_t        indications;
+    uint32_t        lastFrame;
+    uint8_t         lastMedia;
+    uint8_t         startConfirms;
+    uint8_t         startStatus;
+    uint8_t         scanConfirms;
+    uint8_t         scanStatus;
+    uint64_t        scanConfirmUS;
+    uint8_t         beaconsNum;
+    MAC_WRP_PAN_DESCRIPTOR beacons[TEST_BEACONS_MAX];
+} TEST_NODE;
+
+typedef struct
+{
+    uint32_t        badConfirms;
+    uint32_t        badData;
+    uint32_t        badAddress;
+    uint32_t        badLqi;
+} TEST_ERRORS;
+
+static TEST_NODE* testNodes;
+static uint16_t testNodesNum;
+static TEST_FRAME* testFrames;
+static uint32_t testFramesNum;
+static uint32_t testFramesSize;
+static TEST_ERRORS testErrors;
+static uint64_t testRandom;
+static int testFails;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char* msg)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s\n", msg);
+    }
+}
+
+static void _check(bool condition, const char* msg)
+{
+    if (!condition)
+    {
+        _fail(msg);
+    }
+}
+
+static double _random(void)
+{
+    testRandom ^= testRandom >> 12;
+    testRandom ^= testRandom << 25;
+    testRandom ^= testRandom >> 27;
+    return (double)((testRandom * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+
+static MAC_SIM_MEDIUM _indMedium(MAC_WRP_MEDIA_TYPE_INDICATION mediaType)
+{
+    return (mediaType == MAC_WRP_MEDIA_TYPE_IND_PLC) ? MAC_SIM_PLC : MAC_SIM_RF;
+}
+
+static uint8_t _payloadByte(uint32_t frame, uint16_t idx)
+{
+    return (uint8_t)((frame * 31U) + idx);
+}
+
+static void _dataConfirm(MAC_WRP_DATA_CONFIRM_PARAMS *dcParams)
+{
+    TEST_NODE* pNode = &testNodes[MAC_SIM_Current()];
+    uint32_t frame = pNode->handleFrame[dcParams->msduHandle];
+    TEST_FRAME* pFrame;
+
+    if (frame == TEST_FRAME_NONE)
+    {
+        testErrors.badConfirms++;
+        return;
+    }
+
+    pFrame = &testFrames[frame];
+    pFrame->confirms++;
+    pFrame->status = (uint8_t) dcParams->status;
+    pFrame->confMediaType = (uint8_t) dcParams->mediaType;
+    pFrame->confirmUS = MAC_SIM_TimeUS();
+    pNode->handleFrame[dcParams->msduHandle] = TEST_FRAME_NONE;
+    pNode->pending--;
+}
+
+static void _dataIndication(MAC_WRP_DATA_INDICATION_PARAMS *diParams)
+{
+    uint16_t node = MAC_SIM_Current();
+    TEST_NODE* pNode = &testNodes[node];
+    MAC_SIM_MEDIUM medium = _indMedium(diParams->mediaType);
+    TEST_FRAME* pFrame;
+    uint32_t frame;
+    double per;
+    uint8_t lqi;
+
+    if (diParams->msduLength < 4U)
+    {
+        testErrors.badData++;
+        return;
+    }
+
+    frame = (uint32_t) diParams->msdu[0] | ((uint32_t) diParams->msdu[1] << 8) |
+        ((uint32_t) diParams->msdu[2] << 16) | ((uint32_t) diParams->msdu[3] << 24);
+    if (frame >= testFramesNum)
+    {
+        testErrors.badData++;
+        return;
+    }
+
+    pFrame = &testFrames[frame];
+    if (diParams->msduLength != pFrame->len)
+    {
+        testErrors.badData++;
+        return;
+    }
+
+    for (uint16_t i = 4U; i < pFrame->len; i++)
+    {
+        if (diParams->msdu[i] != _payloadByte(frame, i))
+        {
+            testErrors.badData++;
+            return;
+        }
+    }
+
+    if ((diParams->srcAddress.addressMode != MAC_WRP_ADDRESS_MODE_SHORT) ||
+        (diParams->srcAddress.shortAddress != pFrame->src) || (diParams->srcPanId != TEST_PAN_ID) ||
+        ((pFrame->dst != TEST_NODE_BROADCAST) && (pFrame->dst != node)))
+    {
+        testErrors.badAddress++;
+    }
+
+    if (!MAC_SIM_GetLink(pFrame->src, node, medium, &per, &lqi) || (diParams->linkQuality != lqi))
+    {
+        testErrors.badLqi++;
+    }
+
+    pFrame->ind[medium]++;
+    pNode->indications++;
+    pNode->lastFrame = frame;
+    pNode->lastMedia = (uint8_t) diParams->mediaType;
+}
+
+static void _beaconNotify(MAC_WRP_BEACON_NOTIFY_INDICATION_PARAMS *bnParams)
+{
+    TEST_NODE* pNode = &testNodes[MAC_SIM_Current()];
+
+    if (pNode->beaconsNum < TEST_BEACONS_MAX)
+    {
+        pNode->beacons[pNode->beaconsNum++] = bnParams->panDescriptor;
+    }
+}
+
+static void _scanConfirm(MAC_WRP_SCAN_CONFIRM_PARAMS *scParams)
+{
+    TEST_NODE* pNode = &testNodes[MAC_SIM_Current()];
+
+    pNode->scanConfirms++;
+    pNode->scanStatus = (uint8_t) scParams->status;
+    pNode->scanConfirmUS = MAC_SIM_TimeUS();
+}
+
+static void _startConfirm(MAC_WRP_START_CONFIRM_PARAMS *scParams)
+{
+    TEST_NODE* pNode = &testNodes[MAC_SIM_Current()];
+
+    pNode->startConfirms++;
+    pNode->startStatus = (uint8_t) scParams->status;
+}
+
+static bool _setPib(MAC_WRP_PIB_ATTRIBUTE attribute, const void* pValue, uint8_t length)
+{
+    MAC_WRP_PIB_VALUE value;
+
+    value.length = length;
+    (void) memcpy(value.value, pValue, length);
+    return MAC_WRP_SetRequestSync(testNodes[MAC_SIM_Current()].handle, attribute, 0U, &value) ==
+        MAC_WRP_STATUS_SUCCESS;
+}
+
+static bool _networkInit(uint16_t nodes, uint32_t seed)
+{
+    MAC_WRP_HANDLERS handlers;
+
+    free(testNodes);
+    free(testFrames);
+    testFrames = NULL;
+    testFramesNum = 0U;
+    testFramesSize = 0U;
+    (void) memset(&testErrors, 0, sizeof(testErrors));
+    testNodesNum = nodes;
+    testNodes = calloc(nodes, sizeof(TEST_NODE));
+    if ((testNodes == NULL) || !MAC_SIM_Init(nodes, seed))
+    {
+        return false;
+    }
+
+    (void) memset(&handlers, 0, sizeof(handlers));
+    handlers.dataConfirmCallback = _dataConfirm;
+    handlers.dataIndicationCallback = _dataIndication;
+    handlers.beaconNotifyIndicationCallback = _beaconNotify;
+    handlers.scanConfirmCallback = _scanConfirm;
+    handlers.startConfirmCallback = _startConfirm;
+
+    for (uint16_t i = 0U; i < nodes; i++)
+    {
+        TEST_NODE* pNode = &testNodes[i];
+        uint8_t extAddress[8] = {0x00, 0x04, 0x25, 0xFF, 0xFE, 0x00, (uint8_t)(i >> 8), (uint8_t) i};
+
+        for (uint16_t h = 0U; h < 256U; h++)
+        {
+            pNode->handleFrame[h] = TEST_FRAME_NONE;
+        }
+
+        pNode->lastFrame = TEST_FRAME_NONE;
+        MAC_SIM_Select(i);
+        (void) MAC_WRP_Initialize(G3_MAC_WRP_INDEX_0);
+        pNode->handle = MAC_WRP_Open(G3_MAC_WRP_INDEX_0, MAC_WRP_BAND_CENELEC_A);
+        MAC_WRP_SetCallbacks(pNode->handle, &handlers);
+        if (!_setPib(MAC_WRP_PIB_MANUF_EXTENDED_ADDRESS, extAddress, 8U))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* PAN ID and short address of a node that joined the network */
+static bool _nodeJoin(uint16_t node)
+{
+    uint16_t panId = TEST_PAN_ID;
+
+    MAC_SIM_Select(node);
+    return _setPib(MAC_WRP_PIB_PAN_ID, &panId, 2U) && _setPib(MAC_WRP_PIB_SHORT_ADDRESS, &node, 2U);
+}
+
+static uint32_t _send(uint16_t src, uint16_t dst, MAC_WRP_MEDIA_TYPE_REQUEST mediaType, uint16_t len)
+{
+    TEST_NODE* pNode = &testNodes[src];
+    MAC_WRP_DATA_REQUEST_PARAMS params;
+    uint8_t msdu[TEST_LEN_MAX];
+    TEST_FRAME* pFrame;
+    uint32_t frame;
+
+    if (testFramesNum == testFramesSize)
+    {
+        testFramesSize = (testFramesSize == 0U) ? 1024U : (testFramesSize * 2U);
+        testFrames = realloc(testFrames, testFramesSize * sizeof(TEST_FRAME));
+        if (testFrames == NULL)
+        {
+            fprintf(stderr, "g3_mac_sim: out of memory\n");
+            exit(2);
+        }
+    }
+
+    frame = testFramesNum++;
+    pFrame = &testFrames[frame];
+    (void) memset(pFrame, 0, sizeof(TEST_FRAME));
+    pFrame->src = src;
+    pFrame->dst = dst;
+    pFrame->len = len;
+    pFrame->mediaType = (uint8_t) mediaType;
+    pFrame->requestUS = MAC_SIM_TimeUS();
+
+    msdu[0] = (uint8_t) frame;
+    msdu[1] = (uint8_t)(frame >> 8);
+    msdu[2] = (uint8_t)(frame >> 16);
+    msdu[3] = (uint8_t)(frame >> 24);
+    for (uint16_t i = 4U; i < len; i++)
+    {
+        msdu[i] = _payloadByte(frame, i);
+    }
+
+    (void) memset(&params, 0, sizeof(params));
+    params.msdu = msdu;
+    params.msduLength = len;
+    params.destPanId = TEST_PAN_ID;
+    params.srcAddressMode = MAC_WRP_ADDRESS_MODE_SHORT;
+    params.destAddress.addressMode = MAC_WRP_ADDRESS_MODE_SHORT;
+    params.destAddress.shortAddress = dst;
+    params.txOptions = (dst == TEST_NODE_BROADCAST) ? MAC_WRP_TX_OPTION_NO_ACK : MAC_WRP_TX_OPTION_ACK;
+    params.qualityOfService = MAC_WRP_QUALITY_OF_SERVICE_NORMAL_PRIORITY;
+    params.securityLevel = MAC_WRP_SECURITY_LEVEL_NONE;
+    params.mediaType = mediaType;
+    params.msduHandle = pNode->nextHandle++;
+
+    pNode->handleFrame[params.msduHandle] = frame;
+    pNode->pending++;
+    MAC_SIM_Select(src);
+    MAC_WRP_DataRequest(pNode->handle, &params);
+
+    /* msdu goes out of scope: the MAC layers must have copied it */
+    (void) memset(msdu, 0xA5, sizeof(msdu));
+    return frame;
+}
+
+static void _runFor(uint64_t us)
+{
+    MAC_SIM_Run(MAC_SIM_TimeUS() + us);
+}
+
+static void _checkErrors(const char* name)
+{
+    char msg[128];
+
+    if ((testErrors.badConfirms | testErrors.badData | testErrors.badAddress | testErrors.badLqi) != 0U)
+    {
+        (void) snprintf(msg, sizeof(msg), "%s: %u unexpected confirms, %u bad MSDUs, %u bad addresses, %u bad LQIs",
+            name, testErrors.badConfirms, testErrors.badData, testErrors.badAddress, testErrors.badLqi);
+        _fail(msg);
+    }
+}
+
+static void _checkClocks(const char* name)
+{
+    char msg[128];
+    uint32_t nowMs = (uint32_t)(MAC_SIM_TimeUS() / 1000U);
+
+    for (uint16_t i = 0U; i < testNodesNum; i++)
+    {
+        MAC_SIM_Select(i);
+        uint32_t ms = MAC_WRP_GetMsCounter();
+        uint32_t seconds = MAC_WRP_GetSecondsCounter();
+        if ((ms != nowMs) || (seconds != (nowMs / 1000U)))
+        {
+            (void) snprintf(msg, sizeof(msg), "%s: node %u counters %u ms %u s at %u ms", name, i, ms, seconds, nowMs);
+            _fail(msg);
+            return;
+        }
+    }
+}
+
+static bool _hasBeacon(const TEST_NODE* pNode, uint16_t lba, MAC_WRP_MEDIA_TYPE_INDICATION mediaType, uint8_t lqi)
+{
+    for (uint8_t i = 0U; i < pNode->beaconsNum; i++)
+    {
+        const MAC_WRP_PAN_DESCRIPTOR* pDesc = &pNode->beacons[i];
+        if ((pDesc->lbaAddress == lba) && (pDesc->mediaType == mediaType) && (pDesc->linkQuality == lqi) &&
+            (pDesc->panId == TEST_PAN_ID))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Test Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Coordinator 0, joined nodes A (1) and B (2), node C (3) not joined */
+static void _testFunctional(void)
+{
+    const uint16_t len = 60U;
+    uint32_t plcAttemptUS = MAC_SIM_AttemptUS(MAC_SIM_PLC, len, true);
+    uint32_t rfAttemptUS = MAC_SIM_AttemptUS(MAC_SIM_RF, len, true);
+    MAC_WRP_SCAN_REQUEST_PARAMS scanParams;
+    MAC_WRP_START_REQUEST_PARAMS startParams;
+    uint64_t startUS;
+    uint32_t frame, frame2, frame3;
+    uint16_t coordShort = 0U;
+
+    if (!_networkInit(4U, 1U) || !_nodeJoin(1U) || !_nodeJoin(2U))
+    {
+        _fail("functional: network init");
+        return;
+    }
+
+    MAC_SIM_SetLink(0U, 1U, MAC_SIM_PLC, 0.0, 80U);
+    MAC_SIM_SetLink(0U, 1U, MAC_SIM_RF, 0.0, 120U);
+    MAC_SIM_SetLink(0U, 2U, MAC_SIM_PLC, 0.0, 60U);
+    MAC_SIM_SetLink(1U, 2U, MAC_SIM_PLC, 0.0, 30U);
+    MAC_SIM_SetLink(1U, 2U, MAC_SIM_RF, 0.0, 100U);
+    MAC_SIM_SetLink(0U, 3U, MAC_SIM_PLC, 0.0, 50U);
+    MAC_SIM_SetLink(0U, 3U, MAC_SIM_RF, 0.0, 90U);
+    MAC_SIM_SetLink(1U, 3U, MAC_SIM_PLC, 0.0, 40U);
+
+    /* Network start, one confirm for both media */
+    MAC_SIM_Select(0U);
+    _check(_setPib(MAC_WRP_PIB_SHORT_ADDRESS, &coordShort, 2U), "functional: coordinator short address");
+    startParams.panId = TEST_PAN_ID;
+    MAC_WRP_StartRequest(testNodes[0].handle, &startParams);
+    _runFor(1000U);
+    _check((testNodes[0].startConfirms == 1U) && (testNodes[0].startStatus == MAC_WRP_STATUS_SUCCESS),
+        "functional: start confirm");
+
+    /* PLC broadcast from the coordinator, not for the node out of the PAN */
+    frame = _send(0U, TEST_NODE_BROADCAST, MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP, len);
+    _runFor(1000000U);
+    _check((testFrames[frame].confirms == 1U) && (testFrames[frame].status == MAC_WRP_STATUS_SUCCESS),
+        "functional: broadcast confirm");
+    _check((testFrames[frame].ind[MAC_SIM_PLC] == 2U) && (testFrames[frame].ind[MAC_SIM_RF] == 0U) &&
+        (testNodes[3].indications == 0U), "functional: broadcast indications");
+
+    /* Scan from C: beacons of the coordinator on both media and of A on PLC */
+    MAC_SIM_Select(3U);
+    scanParams.scanDuration = 2U;
+    startUS = MAC_SIM_TimeUS();
+    MAC_WRP_ScanRequest(testNodes[3].handle, &scanParams);
+    _runFor(3000000U);
+    _check((testNodes[3].scanConfirms == 1U) && (testNodes[3].scanStatus == MAC_WRP_STATUS_SUCCESS) &&
+        (testNodes[3].scanConfirmUS == (startUS + 2000000U)), "functional: scan confirm");
+    _check((testNodes[3].beaconsNum == 3U) && _hasBeacon(&testNodes[3], 0U, MAC_WRP_MEDIA_TYPE_IND_PLC, 50U) &&
+        _hasBeacon(&testNodes[3], 0U, MAC_WRP_MEDIA_TYPE_IND_RF, 90U) &&
+        _hasBeacon(&testNodes[3], 1U, MAC_WRP_MEDIA_TYPE_IND_PLC, 40U), "functional: scan beacons");
+
+    /* A to B over a dead PLC link: no RF POS entry for B, no backup */
+    MAC_SIM_SetLink(1U, 2U, MAC_SIM_PLC, 1.0, 0U);
+    frame = _send(1U, 2U, MAC_WRP_MEDIA_TYPE_REQ_PLC_BACKUP_RF, len);
+    _runFor(2000000U);
+    _check((testFrames[frame].confirms == 1U) && (testFrames[frame].status == MAC_WRP_STATUS_NO_ACK) &&
+        (testFrames[frame].confMediaType == MAC_WRP_MEDIA_TYPE_CONF_PLC) &&
+        (testFrames[frame].ind[MAC_SIM_PLC] == 0U) && (testFrames[frame].ind[MAC_SIM_RF] == 0U),
+        "functional: PLC_BACKUP_RF without RF POS entry");
+    _check((testFrames[frame].confirmUS - testFrames[frame].requestUS) ==
+        ((MAC_SIM_PLC_RETRIES + 1U) * plcAttemptUS), "functional: PLC retries duration");
+
+    /* B broadcasts on RF, A learns B in its RF POS table */
+    frame = _send(2U, TEST_NODE_BROADCAST, MAC_WRP_MEDIA_TYPE_REQ_RF_NO_BACKUP, len);
+    _runFor(1000000U);
+    _check((testFrames[frame].ind[MAC_SIM_RF] == 1U) && (testNodes[1].lastFrame == frame) &&
+        (testNodes[1].lastMedia == MAC_WRP_MEDIA_TYPE_IND_RF), "functional: RF broadcast");
+
+    /* Same request, now backed up on RF */
+    frame = _send(1U, 2U, MAC_WRP_MEDIA_TYPE_REQ_PLC_BACKUP_RF, len);
+    _runFor(2000000U);
+    _check((testFrames[frame].confirms == 1U) && (testFrames[frame].status == MAC_WRP_STATUS_SUCCESS) &&
+        (testFrames[frame].confMediaType == MAC_WRP_MEDIA_TYPE_CONF_RF_AS_BACKUP) &&
+        (testFrames[frame].ind[MAC_SIM_PLC] == 0U) && (testFrames[frame].ind[MAC_SIM_RF] == 1U),
+        "functional: PLC_BACKUP_RF with RF POS entry");
+    _check((testFrames[frame].confirmUS - testFrames[frame].requestUS) ==
+        (((MAC_SIM_PLC_RETRIES + 1U) * plcAttemptUS) + rfAttemptUS), "functional: RF backup duration");
+
+    /* BOTH: received on both media, indicated once */
+    frame = _send(1U, 0U, MAC_WRP_MEDIA_TYPE_REQ_BOTH, len);
+    _runFor(1000000U);
+    _check((testFrames[frame].confirms == 1U) && (testFrames[frame].status == MAC_WRP_STATUS_SUCCESS) &&
+        (testFrames[frame].confMediaType == MAC_WRP_MEDIA_TYPE_CONF_BOTH) &&
+        (testFrames[frame].ind[MAC_SIM_RF] == 1U) && (testFrames[frame].ind[MAC_SIM_PLC] == 0U),
+        "functional: BOTH with duplicate dropped");
+
+    /* B to the coordinator: no RF link, PLC POS entry from the broadcast */
+    frame = _send(2U, 0U, MAC_WRP_MEDIA_TYPE_REQ_RF_BACKUP_PLC, len);
+    _runFor(2000000U);
+    _check((testFrames[frame].confirms == 1U) && (testFrames[frame].status == MAC_WRP_STATUS_SUCCESS) &&
+        (testFrames[frame].confMediaType == MAC_WRP_MEDIA_TYPE_CONF_PLC_AS_BACKUP) &&
+        (testFrames[frame].ind[MAC_SIM_PLC] == 1U) && (testNodes[0].lastFrame == frame),
+        "functional: RF_BACKUP_PLC");
+
+    /* Two requests in the wrapper queue, the third one is rejected */
+    startUS = MAC_SIM_TimeUS();
+    frame = _send(1U, 0U, MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP, len);
+    frame2 = _send(1U, 0U, MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP, len);
+    frame3 = _send(1U, 0U, MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP, len);
+    _check((testFrames[frame3].confirms == 1U) && (testFrames[frame3].status == MAC_WRP_STATUS_QUEUE_FULL) &&
+        (testFrames[frame3].confirmUS == startUS), "functional: QUEUE_FULL");
+    _runFor(1000000U);
+    _check((testFrames[frame].status == MAC_WRP_STATUS_SUCCESS) && (testFrames[frame2].status == MAC_WRP_STATUS_SUCCESS) &&
+        (testFrames[frame].confirmUS == (startUS + plcAttemptUS)) &&
+        (testFrames[frame2].confirmUS == (startUS + (2U * plcAttemptUS))) &&
+        (testFrames[frame].ind[MAC_SIM_PLC] == 1U) && (testFrames[frame2].ind[MAC_SIM_PLC] == 1U) &&
+        (testFrames[frame3].ind[MAC_SIM_PLC] == 0U), "functional: queued requests");
+
+    /* Counters of every node follow the simulated time */
+    _runFor(3600000000ULL);
+    _checkClocks("functional");
+    _checkErrors("functional");
+
+    printf("functional: %u frames, %.1f s simulated\n", testFramesNum, (double) MAC_SIM_TimeUS() / 1e6);
+}
+
+static void _testNetwork(uint16_t nodes, uint32_t seconds, uint32_t seed)
+{
+    uint16_t side = (uint16_t) ceil(sqrt((double) nodes));
+    uint64_t endUS = (uint64_t) seconds * 1000000ULL;
+    uint64_t stopUS = (endUS > TEST_STOP_BEFORE_END_US) ? (endUS - TEST_STOP_BEFORE_END_US) : 0U;
+    uint16_t** neighbours;
+    uint16_t* neighboursNum;
+    uint32_t links[MAC_SIM_MEDIA] = {0U, 0U};
+    double expBcast[MAC_SIM_MEDIA] = {0.0, 0.0};
+    double varBcast[MAC_SIM_MEDIA] = {0.0, 0.0};
+    double expUcast[MAC_SIM_MEDIA] = {0.0, 0.0};
+    double varUcast[MAC_SIM_MEDIA] = {0.0, 0.0};
+    uint32_t obsBcast[MAC_SIM_MEDIA] = {0U, 0U};
+    uint32_t obsUcast[MAC_SIM_MEDIA] = {0U, 0U};
+    uint32_t numUcast[MAC_SIM_MEDIA] = {0U, 0U};
+    uint32_t confByMedia[5] = {0U, 0U, 0U, 0U, 0U};
+    uint32_t successByType[5] = {0U, 0U, 0U, 0U, 0U};
+    uint32_t sentByType[5] = {0U, 0U, 0U, 0U, 0U};
+    uint32_t unconfirmed = 0U, twice = 0U, badMedia = 0U, notDelivered = 0U, dupMiss = 0U, slow = 0U;
+    MAC_SIM_STATS stats;
+    clock_t wallStart = clock();
+    double wallSeconds;
+    char msg[160];
+
+    testRandom = ((uint64_t) seed * 0x9E3779B97F4A7C15ULL) ^ 0x2545F4914F6CDD1DULL;
+    if (!_networkInit(nodes, seed))
+    {
+        _fail("network: init");
+        return;
+    }
+
+    neighbours = calloc(nodes, sizeof(uint16_t*));
+    neighboursNum = calloc(nodes, sizeof(uint16_t));
+    if ((neighbours == NULL) || (neighboursNum == NULL))
+    {
+        _fail("network: out of memory");
+        return;
+    }
+
+    /* At most 12 nodes within 2 grid steps */
+    for (uint16_t a = 0U; a < nodes; a++)
+    {
+        neighbours[a] = malloc(12U * sizeof(uint16_t));
+    }
+
+    /* Links up to 2 grid steps on PLC and 1.5 on RF, some missing */
+    for (uint16_t a = 0U; a < nodes; a++)
+    {
+        int ax = a % side, ay = a / side;
+        if (!_nodeJoin(a))
+        {
+            _fail("network: join");
+            return;
+        }
+
+        for (uint16_t b = a + 1U; b < nodes; b++)
+        {
+            int dx = (b % side) - ax, dy = (b / side) - ay;
+            double d = sqrt((double)((dx * dx) + (dy * dy)));
+            bool linked = false;
+            if (dy > 2)
+            {
+                break;
+            }
+
+            if ((d <= 2.0) && (_random() >= 0.1))
+            {
+                MAC_SIM_SetLink(a, b, MAC_SIM_PLC, 0.1 + (0.3 * (d - 1.0)) + (0.1 * _random()),
+                    (uint8_t)(110.0 - (30.0 * (d - 1.0)) - (10.0 * _random())));
+                links[MAC_SIM_PLC]++;
+                linked = true;
+            }
+
+            if ((d <= 1.5) && (_random() >= 0.15))
+            {
+                MAC_SIM_SetLink(a, b, MAC_SIM_RF, 0.1 + (0.5 * (d - 1.0)) + (0.1 * _random()),
+                    (uint8_t)(150.0 - (40.0 * (d - 1.0)) - (10.0 * _random())));
+                links[MAC_SIM_RF]++;
+                linked = true;
+            }
+
+            if (linked)
+            {
+                neighbours[a][neighboursNum[a]++] = b;
+                neighbours[b][neighboursNum[b]++] = a;
+            }
+        }
+
+        testNodes[a].nextSendUS = TEST_HELLO_US + (uint64_t)(_random() * TEST_SEND_MEAN_US);
+    }
+
+    /* Broadcast on both media from every node */
+    for (uint16_t a = 0U; a < nodes; a++)
+    {
+        MAC_SIM_Run(((uint64_t) a * TEST_HELLO_US) / nodes);
+        (void) _send(a, TEST_NODE_BROADCAST, MAC_WRP_MEDIA_TYPE_REQ_BOTH, TEST_LEN_MIN);
+    }
+
+    /* Unicast traffic to random neighbours */
+    while (MAC_SIM_TimeUS() < endUS)
+    {
+        uint64_t nowUS = MAC_SIM_TimeUS();
+        for (uint16_t a = 0U; (a < nodes) && (nowUS < stopUS); a++)
+        {
+            TEST_NODE* pNode = &testNodes[a];
+            MAC_WRP_MEDIA_TYPE_REQUEST mediaType;
+            uint16_t dst;
+            double per;
+            uint8_t lqi;
+
+            if ((nowUS < pNode->nextSendUS) || (neighboursNum[a] == 0U))
+            {
+                continue;
+            }
+
+            pNode->nextSendUS = nowUS + (uint64_t)(-log(1.0 - _random()) * TEST_SEND_MEAN_US);
+            if (pNode->pending >= 2U)
+            {
+                continue;
+            }
+
+            mediaType = (MAC_WRP_MEDIA_TYPE_REQUEST)(uint8_t)(_random() * 5.0);
+            dst = neighbours[a][(uint16_t)(_random() * neighboursNum[a])];
+            if (((mediaType == MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP) && !MAC_SIM_GetLink(a, dst, MAC_SIM_PLC, &per, &lqi)) ||
+                ((mediaType == MAC_WRP_MEDIA_TYPE_REQ_RF_NO_BACKUP) && !MAC_SIM_GetLink(a, dst, MAC_SIM_RF, &per, &lqi)))
+            {
+                continue;
+            }
+
+            (void) _send(a, dst, mediaType,
+                (uint16_t)(TEST_LEN_MIN + (uint16_t)(_random() * (double)(TEST_LEN_MAX - TEST_LEN_MIN + 1U))));
+        }
+
+        MAC_SIM_Run(nowUS + TEST_STEP_US);
+    }
+
+    /* Let the requests in progress finish */
+    while ((MAC_SIM_PendingEvents() > 0U) && (MAC_SIM_TimeUS() < (endUS + 60000000ULL)))
+    {
+        _runFor(1000000U);
+    }
+
+    wallSeconds = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+
+    for (uint32_t f = 0U; f < testFramesNum; f++)
+    {
+        TEST_FRAME* pFrame = &testFrames[f];
+        uint8_t type = pFrame->mediaType;
+        uint16_t indAll = pFrame->ind[MAC_SIM_PLC] + pFrame->ind[MAC_SIM_RF];
+        bool success = (pFrame->status == MAC_WRP_STATUS_SUCCESS);
+        double per;
+        uint8_t lqi;
+
+        if (pFrame->confirms == 0U)
+        {
+            unconfirmed++;
+            continue;
+        }
+
+        if (pFrame->confirms > 1U)
+        {
+            twice++;
+        }
+
+        if (pFrame->dst == TEST_NODE_BROADCAST)
+        {
+            for (uint8_t m = 0U; m < MAC_SIM_MEDIA; m++)
+            {
+                obsBcast[m] += pFrame->ind[m];
+                for (uint16_t i = 0U; i < neighboursNum[pFrame->src]; i++)
+                {
+                    if (MAC_SIM_GetLink(pFrame->src, neighbours[pFrame->src][i], (MAC_SIM_MEDIUM) m, &per, &lqi))
+                    {
+                        expBcast[m] += 1.0 - per;
+                        varBcast[m] += per * (1.0 - per);
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        sentByType[type]++;
+        successByType[type] += success ? 1U : 0U;
+        if (pFrame->confMediaType < 5U)
+        {
+            confByMedia[pFrame->confMediaType]++;
+        }
+
+        /* A medium indicates a frame once, the wrapper may miss the copy of the other one */
+        if ((pFrame->ind[MAC_SIM_PLC] > 1U) || (pFrame->ind[MAC_SIM_RF] > 1U))
+        {
+            twice++;
+        }
+
+        if (indAll > 1U)
+        {
+            dupMiss++;
+        }
+
+        if (success && (indAll == 0U))
+        {
+            notDelivered++;
+        }
+
+        switch (type)
+        {
+            case MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP:
+            case MAC_WRP_MEDIA_TYPE_REQ_RF_NO_BACKUP:
+            {
+                MAC_SIM_MEDIUM m = (type == MAC_WRP_MEDIA_TYPE_REQ_PLC_NO_BACKUP) ? MAC_SIM_PLC : MAC_SIM_RF;
+                uint8_t retries = (m == MAC_SIM_PLC) ? MAC_SIM_PLC_RETRIES : MAC_SIM_RF_RETRIES;
+                uint64_t maxUS = 2ULL * (retries + 1U) * MAC_SIM_AttemptUS(m, TEST_LEN_MAX, true);
+                double pAttempt, p;
+
+                badMedia += (pFrame->confMediaType != ((m == MAC_SIM_PLC) ? MAC_WRP_MEDIA_TYPE_CONF_PLC :
+                    MAC_WRP_MEDIA_TYPE_CONF_RF)) ? 1U : 0U;
+                badMedia += (pFrame->ind[(m == MAC_SIM_PLC) ? MAC_SIM_RF : MAC_SIM_PLC] != 0U) ? 1U : 0U;
+                if (((pFrame->confirmUS - pFrame->requestUS) > maxUS) ||
+                    (success && ((pFrame->confirmUS - pFrame->requestUS) < MAC_SIM_AttemptUS(m, pFrame->len, true))))
+                {
+                    slow++;
+                }
+
+                /* Frame and ACK received in one of the attempts */
+                (void) MAC_SIM_GetLink(pFrame->src, pFrame->dst, m, &per, &lqi);
+                pAttempt = (1.0 - per) * (1.0 - per);
+                p = 1.0 - pow(1.0 - pAttempt, (double) retries + 1.0);
+                expUcast[m] += p;
+                varUcast[m] += p * (1.0 - p);
+                obsUcast[m] += success ? 1U : 0U;
+                numUcast[m]++;
+                break;
+            }
+
+            case MAC_WRP_MEDIA_TYPE_REQ_PLC_BACKUP_RF:
+                badMedia += ((pFrame->confMediaType != MAC_WRP_MEDIA_TYPE_CONF_PLC) &&
+                    (pFrame->confMediaType != MAC_WRP_MEDIA_TYPE_CONF_RF_AS_BACKUP)) ? 1U : 0U;
+                break;
+
+            case MAC_WRP_MEDIA_TYPE_REQ_RF_BACKUP_PLC:
+                badMedia += ((pFrame->confMediaType != MAC_WRP_MEDIA_TYPE_CONF_RF) &&
+                    (pFrame->confMediaType != MAC_WRP_MEDIA_TYPE_CONF_PLC_AS_BACKUP)) ? 1U : 0U;
+                break;
+
+            default:
+                badMedia += (pFrame->confMediaType != MAC_WRP_MEDIA_TYPE_CONF_BOTH) ? 1U : 0U;
+                break;
+        }
+    }
+
+    MAC_SIM_GetStats(&stats);
+    printf("network: %u nodes, %u PLC and %u RF links, %.0f s simulated in %.2f s, %llu events (%.0f/s)\n",
+        nodes, links[MAC_SIM_PLC], links[MAC_SIM_RF], (double) MAC_SIM_TimeUS() / 1e6, wallSeconds,
+        (unsigned long long) stats.events, (wallSeconds > 0.0) ? ((double) stats.events / wallSeconds) : 0.0);
+    printf("network: %u frames, PLC %u attempts %u lost %u retries dropped, RF %u attempts %u lost %u retries dropped\n",
+        testFramesNum, stats.txAttempts[MAC_SIM_PLC], stats.rxLost[MAC_SIM_PLC], stats.rxRetries[MAC_SIM_PLC],
+        stats.txAttempts[MAC_SIM_RF], stats.rxLost[MAC_SIM_RF], stats.rxRetries[MAC_SIM_RF]);
+    printf("network: unicast SUCCESS PLC_BACKUP_RF %u/%u RF_BACKUP_PLC %u/%u BOTH %u/%u PLC %u/%u RF %u/%u\n",
+        successByType[0], sentByType[0], successByType[1], sentByType[1], successByType[2], sentByType[2],
+        successByType[3], sentByType[3], successByType[4], sentByType[4]);
+    printf("network: confirmed on PLC %u RF %u BOTH %u PLC_AS_BACKUP %u RF_AS_BACKUP %u, indicated twice %u\n",
+        confByMedia[0], confByMedia[1], confByMedia[2], confByMedia[3], confByMedia[4], dupMiss);
+
+    _check(testFramesNum > (uint32_t) nodes, "network: traffic generated");
+    (void) snprintf(msg, sizeof(msg), "network: %u unconfirmed, %u confirmed or indicated twice on a medium",
+        unconfirmed, twice);
+    _check((unconfirmed == 0U) && (twice == 0U), msg);
+    (void) snprintf(msg, sizeof(msg), "network: %u media mismatches, %u SUCCESS not delivered, %u out of time",
+        badMedia, notDelivered, slow);
+    _check((badMedia == 0U) && (notDelivered == 0U) && (slow == 0U), msg);
+    _checkErrors("network");
+
+    for (uint8_t m = 0U; m < MAC_SIM_MEDIA; m++)
+    {
+        const char* name = (m == MAC_SIM_PLC) ? "PLC" : "RF";
+        printf("network: %s broadcast received %u expected %.0f, unicast SUCCESS %u/%u expected %.0f\n",
+            name, obsBcast[m], expBcast[m], obsUcast[m], numUcast[m], expUcast[m]);
+        (void) snprintf(msg, sizeof(msg), "network: %s broadcast receptions %u, expected %.1f", name, obsBcast[m], expBcast[m]);
+        _check(fabs((double) obsBcast[m] - expBcast[m]) <= ((TEST_SIGMAS * sqrt(varBcast[m])) + 1.0), msg);
+        (void) snprintf(msg, sizeof(msg), "network: %s unicast SUCCESS %u, expected %.1f", name, obsUcast[m], expUcast[m]);
+        _check(fabs((double) obsUcast[m] - expUcast[m]) <= ((TEST_SIGMAS * sqrt(varUcast[m])) + 1.0), msg);
+    }
+
+    _checkClocks("network");
+
+    for (uint16_t a = 0U; a < nodes; a++)
+    {
+        free(neighbours[a]);
+    }
+
+    free(neighbours);
+    free(neighboursNum);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    uint16_t nodes = (argc > 1) ? (uint16_t) strtoul(argv[1], NULL, 0) : TEST_DEFAULT_NODES;
+    uint32_t seconds = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 0) : TEST_DEFAULT_SECONDS;
+    uint32_t seed = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 0) : 1U;
+
+    _testFunctional();
+    if (nodes > 1U)
+    {
+        _testNetwork(nodes, seconds, seed);
+    }
+
+    if (testFails > TEST_MAX_FAILS_SHOWN)
+    {
+        printf("... %d failures\n", testFails);
+    }
+
+    MAC_SIM_Free();
+    free(testNodes);
+    free(testFrames);
+
+    printf("%s\n", (testFails == 0) ? "PASS" : "FAIL");
+    return (testFails == 0) ? 0 : 1;
+}
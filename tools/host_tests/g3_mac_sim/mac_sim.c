@@ -0,0 +1,1278 @@
+/*******************************************************************************
+  Simulated G3 PLC and RF MAC layers for the G3 MAC simulation
+
+  File Name:
+    mac_sim.c
+
+  Summary:
+    mac_wrapper.c and mac_common.c of the configuration over an event driven
+    simulation of the MAC PLC and MAC RF libraries.
+
+  Description:
+    Time is kept in microseconds and SYS_TIME counts one tick per
+    microsecond, so MAC_COMMON_GetMsCounter follows the simulated time. The
+    simulation only advances in MAC_SIM_Run, running the events in time
+    order; requests made from callbacks are handled at the time of the event.
+
+    Each MAC layer sends its data requests one at a time. A frame with ACK
+    request is sent up to 1 + retries times: every attempt is received with
+    the link PER and, if received, its ACK is received with the link PER
+    too. The frame is indicated on the first attempt received; later
+    attempts are dropped by the DSN at the receiver. The confirm comes at
+    the end of the last attempt. Broadcast frames and frames without ACK
+    are sent once and received by each neighbour with its link PER. There
+    is no CSMA, no collision and no tone map: the media of the nodes are
+    independent.
+
+    Received frames with short source address refresh the POS table of the
+    receiver, with the TTL of MAC_COMMON. MAC_WRP_POS_ENTRY and
+    MAC_RF_POS_TABLE_ENTRY read from the MAC layers report the remaining
+    valid time in seconds.
+
+    A scan sends a beacon request on each medium; every neighbour with PAN
+    ID and short address answers at a random time within the scan duration,
+    as in the G3 beacon randomization, with both frames subject to the link
+    PER. The scan confirm comes at the end of the duration.
+
+    The PLC and RF device, POS and DSN tables allocated by mac_wrapper.c are
+    not used. MAC_PLC_MIB_SetAttributeSync only returns success, as the
+    shared attributes are read from MAC_COMMON.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mac_sim.h"
+#include "configuration.h"
+
+#include "stack/g3/mac/mac_wrapper/mac_wrapper.c"
+#include "stack/g3/mac/mac_common/mac_common.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Frame duration: preamble and headers plus a time per MSDU byte */
+#define SIM_PLC_FRAME_US(len)       (14000U + (400U * (uint32_t)(len)))
+#define SIM_RF_FRAME_US(len)        (2000U + (160U * (uint32_t)(len)))
+
+/* Turnaround and ACK frame */
+#define SIM_PLC_ACK_US              14000U
+#define SIM_RF_ACK_US               3000U
+
+/* Inter frame space after each attempt */
+#define SIM_PLC_IFS_US              5000U
+#define SIM_RF_IFS_US               1000U
+
+/* Beacon request and beacon, MSDU bytes */
+#define SIM_BEACON_LEN              8U
+
+#define SIM_TX_QUEUE_SIZE           4U
+#define SIM_POS_ENTRIES             64U
+#define SIM_MSDU_MAX                HYAL_BACKUP_BUF_SIZE
+#define SIM_NODE_NONE               0xFFFFU
+
+/* Default macTMRTTL, minutes */
+#define SIM_TMR_TTL_DEFAULT         10U
+
+/* Every node is selected at least this often, so its seconds counter and
+   the 32-bit tick difference of MAC_COMMON_GetMsCounter stay in range */
+#define SIM_REFRESH_US              60000000ULL
+
+typedef enum
+{
+    SIM_EV_RX,
+    SIM_EV_TX_END,
+    SIM_EV_TX_ERROR,
+    SIM_EV_BEACON,
+    SIM_EV_SCAN_END,
+    SIM_EV_START_CFM,
+    SIM_EV_RESET_CFM,
+} SIM_EVENT_TYPE;
+
+typedef struct
+{
+    uint64_t            timeUS;
+    uint32_t            seq;
+    uint16_t            node;
+    uint16_t            peer;
+    uint8_t             type;
+    uint8_t             medium;
+    uint8_t             handle;
+    uint8_t             status;
+} SIM_EVENT;
+
+typedef struct
+{
+    float               per;
+    uint8_t             lqi;
+} SIM_LINK;
+
+typedef struct
+{
+    uint16_t*           nodes;
+    uint16_t            num;
+    uint16_t            size;
+} SIM_NEIGHBOURS;
+
+/* Data request copied at request time */
+typedef struct
+{
+    MAC_DATA_REQUEST_PARAMS params;
+    MAC_ADDRESS         srcAddress;
+    MAC_PAN_ID          srcPanId;
+    uint16_t            destNode;
+    uint8_t             dsn;
+    uint8_t             data[SIM_MSDU_MAX];
+} SIM_TX;
+
+typedef struct
+{
+    MAC_SHORT_ADDRESS   shortAddress;
+    uint8_t             lqi;
+    uint64_t            expireUS;
+} SIM_POS;
+
+/* Handlers of MAC_PLC_HANDLERS or MAC_RF_HANDLERS */
+typedef struct
+{
+    MAC_DataConfirm             dataConfirm;
+    MAC_DataIndication          dataIndication;
+    MAC_ResetConfirm            resetConfirm;
+    MAC_BeaconNotifyIndication  beaconNotify;
+    MAC_ScanConfirm             scanConfirm;
+    MAC_StartConfirm            startConfirm;
+    MAC_CommStatusIndication    commStatus;
+    MAC_SnifferIndication       sniffer;
+} SIM_HANDLERS;
+
+typedef struct
+{
+    SIM_HANDLERS        handlers;
+    bool                initialized;
+    bool                scanning;
+    bool                txBusy;
+    uint8_t             txNum;
+    uint8_t             dsn;
+    uint8_t             tmrTtl;
+    SIM_TX              tx[SIM_TX_QUEUE_SIZE];
+    SIM_POS             pos[SIM_POS_ENTRIES];
+    uint8_t             posNum;
+} SIM_MAC;
+
+/* File scope data of mac_wrapper.c and mac_common.c of a node */
+typedef struct
+{
+    MAC_WRP_DATA            macWrpData;
+    MAC_WRP_DATA_REQ_ENTRY  dataReqQueue[MAC_WRP_DATA_REQ_QUEUE_SIZE];
+    HYAL_DUPLICATES_ENTRY   hyALDuplicatesTable[HYAL_DUPLICATES_TABLE_SIZE];
+    HYAL_DATA               hyalData;
+    MAC_COMMON_MIB          macMibCommon;
+    uint64_t                previousCounter64;
+    uint32_t                auxMsCounter;
+    uint32_t                currentMsCounter;
+    uint32_t                currentSecondCounter;
+} SIM_CONTEXT;
+
+typedef struct
+{
+    SIM_CONTEXT         ctx;
+    SIM_MAC             mac[MAC_SIM_MEDIA];
+    SIM_NEIGHBOURS      neighbours[MAC_SIM_MEDIA];
+} SIM_NODE;
+
+typedef struct
+{
+    uint64_t            timeUS;
+    uint64_t            refreshUS;
+    uint64_t            random;
+    uint32_t            seq;
+    uint16_t            nodesNum;
+    uint16_t            current;
+    SIM_NODE*           nodes;
+    SIM_LINK*           links;
+    SIM_EVENT*          events;
+    uint32_t            eventsNum;
+    uint32_t            eventsSize;
+    MAC_SIM_STATS       stats;
+} SIM_OBJ;
+
+static SIM_OBJ sim;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static double _simRandom(void)
+{
+    /* xorshift64* */
+    sim.random ^= sim.random >> 12;
+    sim.random ^= sim.random << 25;
+    sim.random ^= sim.random >> 27;
+    return (double)((sim.random * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+
+static SIM_LINK* _simLink(uint16_t nodeA, uint16_t nodeB, MAC_SIM_MEDIUM medium)
+{
+    return &sim.links[((((size_t) nodeA * sim.nodesNum) + nodeB) * MAC_SIM_MEDIA) + medium];
+}
+
+static void _simContextSave(SIM_CONTEXT* pCtx)
+{
+    pCtx->macWrpData = macWrpData;
+    (void) memcpy(pCtx->dataReqQueue, dataReqQueue, sizeof(dataReqQueue));
+    (void) memcpy(pCtx->hyALDuplicatesTable, hyALDuplicatesTable, sizeof(hyALDuplicatesTable));
+    pCtx->hyalData = hyalData;
+    pCtx->macMibCommon = macMibCommon;
+    pCtx->previousCounter64 = previousCounter64;
+    pCtx->auxMsCounter = auxMsCounter;
+    pCtx->currentMsCounter = currentMsCounter;
+    pCtx->currentSecondCounter = currentSecondCounter;
+}
+
+static void _simContextRestore(const SIM_CONTEXT* pCtx)
+{
+    macWrpData = pCtx->macWrpData;
+    (void) memcpy(dataReqQueue, pCtx->dataReqQueue, sizeof(dataReqQueue));
+    (void) memcpy(hyALDuplicatesTable, pCtx->hyALDuplicatesTable, sizeof(hyALDuplicatesTable));
+    hyalData = pCtx->hyalData;
+    macMibCommon = pCtx->macMibCommon;
+    previousCounter64 = pCtx->previousCounter64;
+    auxMsCounter = pCtx->auxMsCounter;
+    currentMsCounter = pCtx->currentMsCounter;
+    currentSecondCounter = pCtx->currentSecondCounter;
+}
+
+/* MAC_COMMON MIB of any node, the live one for the current node */
+static const MAC_COMMON_MIB* _simMib(uint16_t node)
+{
+    if (node == sim.current)
+    {
+        return &macMibCommon;
+    }
+
+    return &sim.nodes[node].ctx.macMibCommon;
+}
+
+static SIM_MAC* _simMac(MAC_SIM_MEDIUM medium)
+{
+    return &sim.nodes[sim.current].mac[medium];
+}
+
+static void _simEventPush(uint64_t timeUS, SIM_EVENT_TYPE type, uint16_t node, uint16_t peer,
+    MAC_SIM_MEDIUM medium, uint8_t handle, uint8_t status)
+{
+    SIM_EVENT ev;
+    uint32_t idx;
+
+    if (sim.eventsNum == sim.eventsSize)
+    {
+        sim.eventsSize = (sim.eventsSize == 0U) ? 1024U : (sim.eventsSize * 2U);
+        sim.events = realloc(sim.events, sim.eventsSize * sizeof(SIM_EVENT));
+        if (sim.events == NULL)
+        {
+            fprintf(stderr, "mac_sim: out of memory\n");
+            exit(2);
+        }
+    }
+
+    ev.timeUS = timeUS;
+    ev.seq = sim.seq++;
+    ev.node = node;
+    ev.peer = peer;
+    ev.type = (uint8_t) type;
+    ev.medium = (uint8_t) medium;
+    ev.handle = handle;
+    ev.status = status;
+
+    /* Sift up, events at the same time keep their order */
+    idx = sim.eventsNum++;
+    while (idx > 0U)
+    {
+        uint32_t parent = (idx - 1U) / 2U;
+        SIM_EVENT* pParent = &sim.events[parent];
+        if ((pParent->timeUS < ev.timeUS) || ((pParent->timeUS == ev.timeUS) && (pParent->seq < ev.seq)))
+        {
+            break;
+        }
+
+        sim.events[idx] = *pParent;
+        idx = parent;
+    }
+
+    sim.events[idx] = ev;
+}
+
+static bool _simEventBefore(const SIM_EVENT* pA, const SIM_EVENT* pB)
+{
+    return (pA->timeUS < pB->timeUS) || ((pA->timeUS == pB->timeUS) && (pA->seq < pB->seq));
+}
+
+static SIM_EVENT _simEventPop(void)
+{
+    SIM_EVENT first = sim.events[0];
+    SIM_EVENT last = sim.events[--sim.eventsNum];
+    uint32_t idx = 0U;
+
+    /* Sift down */
+    while (true)
+    {
+        uint32_t child = (2U * idx) + 1U;
+        if (child >= sim.eventsNum)
+        {
+            break;
+        }
+
+        if (((child + 1U) < sim.eventsNum) && _simEventBefore(&sim.events[child + 1U], &sim.events[child]))
+        {
+            child++;
+        }
+
+        if (!_simEventBefore(&sim.events[child], &last))
+        {
+            break;
+        }
+
+        sim.events[idx] = sim.events[child];
+        idx = child;
+    }
+
+    if (sim.eventsNum > 0U)
+    {
+        sim.events[idx] = last;
+    }
+
+    return first;
+}
+
+static void _simNeighbourAdd(SIM_NEIGHBOURS* pNb, uint16_t node)
+{
+    for (uint16_t i = 0U; i < pNb->num; i++)
+    {
+        if (pNb->nodes[i] == node)
+        {
+            return;
+        }
+    }
+
+    if (pNb->num == pNb->size)
+    {
+        pNb->size = (pNb->size == 0U) ? 8U : (uint16_t)(pNb->size * 2U);
+        pNb->nodes = realloc(pNb->nodes, pNb->size * sizeof(uint16_t));
+        if (pNb->nodes == NULL)
+        {
+            fprintf(stderr, "mac_sim: out of memory\n");
+            exit(2);
+        }
+    }
+
+    pNb->nodes[pNb->num++] = node;
+}
+
+static void _simNeighbourRemove(SIM_NEIGHBOURS* pNb, uint16_t node)
+{
+    for (uint16_t i = 0U; i < pNb->num; i++)
+    {
+        if (pNb->nodes[i] == node)
+        {
+            pNb->nodes[i] = pNb->nodes[--pNb->num];
+            return;
+        }
+    }
+}
+
+static uint32_t _simFrameUS(MAC_SIM_MEDIUM medium, uint16_t msduLength)
+{
+    return (medium == MAC_SIM_PLC) ? SIM_PLC_FRAME_US(msduLength) : SIM_RF_FRAME_US(msduLength);
+}
+
+static uint8_t _simRetries(MAC_SIM_MEDIUM medium)
+{
+    return (medium == MAC_SIM_PLC) ? MAC_SIM_PLC_RETRIES : MAC_SIM_RF_RETRIES;
+}
+
+/* Frame addressed to the node, with the filters of the MAC layers */
+static bool _simAccepts(uint16_t node, const MAC_DATA_REQUEST_PARAMS* pParams)
+{
+    const MAC_COMMON_MIB* pMib = _simMib(node);
+
+    if ((pParams->destPanId != MAC_PAN_ID_BROADCAST) && (pParams->destPanId != pMib->panId))
+    {
+        return false;
+    }
+
+    if (pParams->destAddress.addressMode == MAC_ADDRESS_MODE_SHORT)
+    {
+        return (pParams->destAddress.shortAddress == MAC_SHORT_ADDRESS_BROADCAST) ||
+            (pParams->destAddress.shortAddress == pMib->shortAddress);
+    }
+
+    return memcmp(pParams->destAddress.extendedAddress.address, pMib->extendedAddress.address,
+        sizeof(MAC_EXTENDED_ADDRESS)) == 0;
+}
+
+static bool _simIsBroadcast(const MAC_DATA_REQUEST_PARAMS* pParams)
+{
+    return (pParams->destAddress.addressMode == MAC_ADDRESS_MODE_SHORT) &&
+        (pParams->destAddress.shortAddress == MAC_SHORT_ADDRESS_BROADCAST);
+}
+
+static SIM_POS* _simPosFind(SIM_MAC* pMac, MAC_SHORT_ADDRESS shortAddress)
+{
+    for (uint8_t i = 0U; i < pMac->posNum; i++)
+    {
+        SIM_POS* pPos = &pMac->pos[i];
+        if (pPos->shortAddress == shortAddress)
+        {
+            if (pPos->expireUS <= sim.timeUS)
+            {
+                *pPos = pMac->pos[--pMac->posNum];
+                return NULL;
+            }
+
+            return pPos;
+        }
+    }
+
+    return NULL;
+}
+
+static void _simPosUpdate(SIM_MAC* pMac, MAC_SHORT_ADDRESS shortAddress, uint8_t lqi)
+{
+    SIM_POS* pPos = _simPosFind(pMac, shortAddress);
+
+    if (pPos == NULL)
+    {
+        if (pMac->posNum < SIM_POS_ENTRIES)
+        {
+            pPos = &pMac->pos[pMac->posNum++];
+        }
+        else
+        {
+            /* Table full: replace the entry closest to expire */
+            pPos = &pMac->pos[0];
+            for (uint8_t i = 1U; i < SIM_POS_ENTRIES; i++)
+            {
+                if (pMac->pos[i].expireUS < pPos->expireUS)
+                {
+                    pPos = &pMac->pos[i];
+                }
+            }
+        }
+    }
+
+    pPos->shortAddress = shortAddress;
+    pPos->lqi = lqi;
+    pPos->expireUS = sim.timeUS + ((uint64_t) macMibCommon.posTableEntryTtl * 60000000ULL);
+}
+
+static uint16_t _simPosValidTime(const SIM_POS* pPos)
+{
+    uint64_t seconds = (pPos->expireUS - sim.timeUS) / 1000000ULL;
+    return (seconds > 0xFFFFU) ? 0xFFFFU : (uint16_t) seconds;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulated Transmission and Reception
+// *****************************************************************************
+// *****************************************************************************
+
+/* Start the first frame of the queue of the current node */
+static void _simTxStart(MAC_SIM_MEDIUM medium)
+{
+    SIM_MAC* pMac = _simMac(medium);
+    SIM_TX* pTx = &pMac->tx[0];
+    uint16_t node = sim.current;
+    SIM_NEIGHBOURS* pNb = &sim.nodes[node].neighbours[medium];
+    uint64_t endUS = sim.timeUS;
+    uint32_t attemptUS;
+    MAC_STATUS status;
+
+    pMac->txBusy = true;
+    pTx->dsn = pMac->dsn++;
+    pTx->srcPanId = macMibCommon.panId;
+    pTx->srcAddress.addressMode = pTx->params.srcAddressMode;
+    if (pTx->params.srcAddressMode == MAC_ADDRESS_MODE_SHORT)
+    {
+        pTx->srcAddress.shortAddress = macMibCommon.shortAddress;
+    }
+    else
+    {
+        pTx->srcAddress.extendedAddress = macMibCommon.extendedAddress;
+    }
+
+    attemptUS = MAC_SIM_AttemptUS(medium, pTx->params.msduLength,
+        (pTx->params.txOptions & (uint8_t) MAC_TX_OPTION_ACK) != 0U);
+
+    if (_simIsBroadcast(&pTx->params))
+    {
+        /* Each neighbour draws its reception at the end of the frame */
+        endUS += _simFrameUS(medium, pTx->params.msduLength);
+        _simEventPush(endUS, SIM_EV_RX, node, SIM_NODE_NONE, medium, 0U, 0U);
+        sim.stats.txAttempts[medium]++;
+        _simEventPush(sim.timeUS + attemptUS, SIM_EV_TX_END, node, 0U, medium,
+            pTx->params.msduHandle, (uint8_t) MAC_STATUS_SUCCESS);
+        return;
+    }
+
+    pTx->destNode = SIM_NODE_NONE;
+    for (uint16_t i = 0U; i < pNb->num; i++)
+    {
+        if (_simAccepts(pNb->nodes[i], &pTx->params))
+        {
+            pTx->destNode = pNb->nodes[i];
+            break;
+        }
+    }
+
+    if ((pTx->params.txOptions & (uint8_t) MAC_TX_OPTION_ACK) == 0U)
+    {
+        endUS += _simFrameUS(medium, pTx->params.msduLength);
+        sim.stats.txAttempts[medium]++;
+        if (pTx->destNode != SIM_NODE_NONE)
+        {
+            if (_simRandom() >= _simLink(node, pTx->destNode, medium)->per)
+            {
+                _simEventPush(endUS, SIM_EV_RX, node, pTx->destNode, medium, 0U, 0U);
+            }
+            else
+            {
+                sim.stats.rxLost[medium]++;
+            }
+        }
+
+        _simEventPush(sim.timeUS + attemptUS, SIM_EV_TX_END, node, 0U, medium,
+            pTx->params.msduHandle, (uint8_t) MAC_STATUS_SUCCESS);
+        return;
+    }
+
+    /* Attempts with ACK request, drawn at once */
+    status = MAC_STATUS_NO_ACK;
+    bool received = false;
+    for (uint8_t attempt = 0U; attempt <= _simRetries(medium); attempt++)
+    {
+        uint64_t startUS = endUS;
+        endUS += attemptUS;
+        sim.stats.txAttempts[medium]++;
+        if (pTx->destNode == SIM_NODE_NONE)
+        {
+            continue;
+        }
+
+        double per = _simLink(node, pTx->destNode, medium)->per;
+        if (_simRandom() < per)
+        {
+            sim.stats.rxLost[medium]++;
+            continue;
+        }
+
+        if (received)
+        {
+            sim.stats.rxRetries[medium]++;
+        }
+        else
+        {
+            received = true;
+            _simEventPush(startUS + _simFrameUS(medium, pTx->params.msduLength), SIM_EV_RX,
+                node, pTx->destNode, medium, 0U, 0U);
+        }
+
+        if (_simRandom() >= per)
+        {
+            status = MAC_STATUS_SUCCESS;
+            break;
+        }
+    }
+
+    _simEventPush(endUS, SIM_EV_TX_END, node, 0U, medium, pTx->params.msduHandle, (uint8_t) status);
+}
+
+/* Indicate the first frame of the queue of the sender to the current node */
+static void _simRxIndicate(uint16_t sender, MAC_SIM_MEDIUM medium)
+{
+    SIM_TX* pTx = &sim.nodes[sender].mac[medium].tx[0];
+    SIM_MAC* pMac = _simMac(medium);
+    SIM_LINK* pLink = _simLink(sender, sim.current, medium);
+    MAC_DATA_INDICATION_PARAMS di;
+
+    if (pTx->srcAddress.addressMode == MAC_ADDRESS_MODE_SHORT)
+    {
+        _simPosUpdate(pMac, pTx->srcAddress.shortAddress, pLink->lqi);
+    }
+
+    sim.stats.rxFrames[medium]++;
+    if (pMac->handlers.dataIndication == NULL)
+    {
+        return;
+    }
+
+    (void) memset(&di, 0, sizeof(di));
+    di.msdu = pTx->data;
+    di.msduLength = pTx->params.msduLength;
+    di.timestamp = (MAC_TIMESTAMP)(sim.timeUS / 1000U);
+    di.srcPanId = pTx->srcPanId;
+    di.destPanId = pTx->params.destPanId;
+    di.srcAddress = pTx->srcAddress;
+    di.destAddress = pTx->params.destAddress;
+    di.linkQuality = pLink->lqi;
+    di.dsn = pTx->dsn;
+    di.keyIndex = pTx->params.keyIndex;
+    di.securityLevel = pTx->params.securityLevel;
+    di.qualityOfService = pTx->params.qualityOfService;
+    pMac->handlers.dataIndication(&di);
+}
+
+static void _simEventRun(const SIM_EVENT* pEv)
+{
+    MAC_SIM_MEDIUM medium = (MAC_SIM_MEDIUM) pEv->medium;
+    SIM_MAC* pMac;
+
+    if (pEv->type == (uint8_t) SIM_EV_RX)
+    {
+        if (pEv->peer != SIM_NODE_NONE)
+        {
+            MAC_SIM_Select(pEv->peer);
+            _simRxIndicate(pEv->node, medium);
+            return;
+        }
+
+        /* Broadcast: the neighbour list may grow from callbacks, use a copy */
+        SIM_NEIGHBOURS* pNb = &sim.nodes[pEv->node].neighbours[medium];
+        uint16_t num = pNb->num;
+        uint16_t* pList = malloc(((size_t) num + 1U) * sizeof(uint16_t));
+        if (pList == NULL)
+        {
+            fprintf(stderr, "mac_sim: out of memory\n");
+            exit(2);
+        }
+
+        (void) memcpy(pList, pNb->nodes, (size_t) num * sizeof(uint16_t));
+        for (uint16_t i = 0U; i < num; i++)
+        {
+            uint16_t peer = pList[i];
+            if (!_simAccepts(peer, &sim.nodes[pEv->node].mac[medium].tx[0].params))
+            {
+                continue;
+            }
+
+            if (_simRandom() < _simLink(pEv->node, peer, medium)->per)
+            {
+                sim.stats.rxLost[medium]++;
+                continue;
+            }
+
+            MAC_SIM_Select(peer);
+            _simRxIndicate(pEv->node, medium);
+        }
+
+        free(pList);
+        return;
+    }
+
+    MAC_SIM_Select(pEv->node);
+    pMac = _simMac(medium);
+
+    switch (pEv->type)
+    {
+        case SIM_EV_TX_END:
+        case SIM_EV_TX_ERROR:
+        {
+            MAC_DATA_CONFIRM_PARAMS dc;
+            dc.msduHandle = pEv->handle;
+            dc.status = (MAC_STATUS) pEv->status;
+            dc.timestamp = (MAC_TIMESTAMP)(sim.timeUS / 1000U);
+
+            if (pEv->type == (uint8_t) SIM_EV_TX_END)
+            {
+                /* Release the frame and start the next one before the
+                   confirm, so requests from the callback are queued */
+                pMac->txNum--;
+                (void) memmove(&pMac->tx[0], &pMac->tx[1], pMac->txNum * sizeof(SIM_TX));
+                pMac->txBusy = false;
+                sim.stats.txFrames[medium]++;
+                if (pMac->txNum > 0U)
+                {
+                    _simTxStart(medium);
+                }
+            }
+
+            if (pMac->handlers.dataConfirm != NULL)
+            {
+                pMac->handlers.dataConfirm(&dc);
+            }
+
+            break;
+        }
+
+        case SIM_EV_BEACON:
+            if (pMac->scanning && (pMac->handlers.beaconNotify != NULL))
+            {
+                const MAC_COMMON_MIB* pMib = _simMib(pEv->peer);
+                MAC_BEACON_NOTIFY_INDICATION_PARAMS bn;
+                bn.panDescriptor.panId = pMib->panId;
+                bn.panDescriptor.lbaAddress = pMib->shortAddress;
+                bn.panDescriptor.rcCoord = pMib->rcCoord;
+                bn.panDescriptor.linkQuality = _simLink(pEv->peer, pEv->node, medium)->lqi;
+                sim.stats.beacons[medium]++;
+                pMac->handlers.beaconNotify(&bn);
+            }
+
+            break;
+
+        case SIM_EV_SCAN_END:
+            pMac->scanning = false;
+            if (pMac->handlers.scanConfirm != NULL)
+            {
+                MAC_SCAN_CONFIRM_PARAMS sc;
+                sc.status = MAC_STATUS_SUCCESS;
+                pMac->handlers.scanConfirm(&sc);
+            }
+
+            break;
+
+        case SIM_EV_START_CFM:
+            if (pMac->handlers.startConfirm != NULL)
+            {
+                MAC_START_CONFIRM_PARAMS sc;
+                sc.status = MAC_STATUS_SUCCESS;
+                pMac->handlers.startConfirm(&sc);
+            }
+
+            break;
+
+        case SIM_EV_RESET_CFM:
+            if (pMac->handlers.resetConfirm != NULL)
+            {
+                MAC_RESET_CONFIRM_PARAMS rc;
+                rc.status = MAC_STATUS_SUCCESS;
+                pMac->handlers.resetConfirm(&rc);
+            }
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulated MAC Layers
+// *****************************************************************************
+// *****************************************************************************
+
+static void _simMacInit(MAC_SIM_MEDIUM medium, const SIM_HANDLERS* pHandlers)
+{
+    SIM_MAC* pMac = _simMac(medium);
+
+    pMac->handlers = *pHandlers;
+    pMac->initialized = true;
+    pMac->scanning = false;
+    pMac->tmrTtl = SIM_TMR_TTL_DEFAULT;
+    pMac->posNum = 0U;
+}
+
+static void _simMacDataRequest(MAC_SIM_MEDIUM medium, MAC_DATA_REQUEST_PARAMS *drParams)
+{
+    SIM_MAC* pMac = _simMac(medium);
+    SIM_TX* pTx;
+    MAC_STATUS status = MAC_STATUS_SUCCESS;
+
+    if (drParams->msduLength > SIM_MSDU_MAX)
+    {
+        status = MAC_STATUS_FRAME_TOO_LONG;
+    }
+    else if (pMac->txNum == SIM_TX_QUEUE_SIZE)
+    {
+        status = MAC_STATUS_TRANSACTION_OVERFLOW;
+    }
+
+    if (status != MAC_STATUS_SUCCESS)
+    {
+        _simEventPush(sim.timeUS, SIM_EV_TX_ERROR, sim.current, 0U, medium, drParams->msduHandle, (uint8_t) status);
+        return;
+    }
+
+    /* The MSDU buffer of the caller is only valid during the request */
+    pTx = &pMac->tx[pMac->txNum++];
+    pTx->params = *drParams;
+    (void) memcpy(pTx->data, drParams->msdu, drParams->msduLength);
+    pTx->params.msdu = pTx->data;
+
+    if (!pMac->txBusy)
+    {
+        _simTxStart(medium);
+    }
+}
+
+static void _simMacScanRequest(MAC_SIM_MEDIUM medium, MAC_SCAN_REQUEST_PARAMS *scanParams)
+{
+    SIM_MAC* pMac = _simMac(medium);
+    SIM_NEIGHBOURS* pNb = &sim.nodes[sim.current].neighbours[medium];
+    uint64_t durationUS = (uint64_t) scanParams->scanDuration * 1000000ULL;
+    uint64_t requestUS = _simFrameUS(medium, SIM_BEACON_LEN);
+    uint64_t beaconUS = _simFrameUS(medium, SIM_BEACON_LEN);
+
+    pMac->scanning = true;
+    for (uint16_t i = 0U; i < pNb->num; i++)
+    {
+        uint16_t peer = pNb->nodes[i];
+        const MAC_COMMON_MIB* pMib = _simMib(peer);
+        double per = _simLink(sim.current, peer, medium)->per;
+
+        if ((pMib->panId == MAC_PAN_ID_BROADCAST) || (pMib->shortAddress == MAC_SHORT_ADDRESS_BROADCAST))
+        {
+            continue;
+        }
+
+        if ((_simRandom() < per) || (_simRandom() < per) || (durationUS <= (requestUS + beaconUS)))
+        {
+            sim.stats.rxLost[medium]++;
+            continue;
+        }
+
+        _simEventPush(sim.timeUS + requestUS + beaconUS +
+            (uint64_t)(_simRandom() * (double)(durationUS - requestUS - beaconUS)),
+            SIM_EV_BEACON, sim.current, peer, medium, 0U, 0U);
+    }
+
+    _simEventPush(sim.timeUS + durationUS, SIM_EV_SCAN_END, sim.current, 0U, medium, 0U, 0U);
+}
+
+static void _simMacStartRequest(MAC_SIM_MEDIUM medium, MAC_START_REQUEST_PARAMS *startParams)
+{
+    macMibCommon.panId = startParams->panId;
+    macMibCommon.coordinator = true;
+    _simEventPush(sim.timeUS, SIM_EV_START_CFM, sim.current, 0U, medium, 0U, 0U);
+}
+
+static void _simMacResetRequest(MAC_SIM_MEDIUM medium, MAC_RESET_REQUEST_PARAMS *rstParams)
+{
+    SIM_MAC* pMac = _simMac(medium);
+
+    if (rstParams->setDefaultPib)
+    {
+        pMac->posNum = 0U;
+        pMac->tmrTtl = SIM_TMR_TTL_DEFAULT;
+    }
+
+    _simEventPush(sim.timeUS, SIM_EV_RESET_CFM, sim.current, 0U, medium, 0U, 0U);
+}
+
+void MAC_PLC_Init(MAC_PLC_INIT *init)
+{
+    const MAC_PLC_HANDLERS* pPlc = &init->macPlcHandlers;
+    SIM_HANDLERS handlers = {
+        pPlc->macPlcDataConfirm, pPlc->macPlcDataIndication, pPlc->macPlcResetConfirm,
+        pPlc->macPlcBeaconNotifyIndication, pPlc->macPlcScanConfirm, pPlc->macPlcStartConfirm,
+        pPlc->macPlcCommStatusIndication, pPlc->macPlcMacSnifferIndication
+    };
+
+    _simMacInit(MAC_SIM_PLC, &handlers);
+}
+
+void MAC_PLC_Tasks(void)
+{
+}
+
+SYS_STATUS MAC_PLC_Status(void)
+{
+    return _simMac(MAC_SIM_PLC)->initialized ? SYS_STATUS_READY : SYS_STATUS_UNINITIALIZED;
+}
+
+void MAC_PLC_DataRequest(MAC_DATA_REQUEST_PARAMS *drParams)
+{
+    _simMacDataRequest(MAC_SIM_PLC, drParams);
+}
+
+MAC_STATUS MAC_PLC_GetRequestSync(MAC_PLC_PIB_ATTRIBUTE attribute, uint16_t index, MAC_PIB_VALUE *pibValue)
+{
+    SIM_MAC* pMac = _simMac(MAC_SIM_PLC);
+
+    pibValue->length = 0U;
+    switch (attribute)
+    {
+        case MAC_PIB_MANUF_POS_TABLE_ELEMENT:
+        {
+            SIM_POS* pPos = _simPosFind(pMac, index);
+            MAC_WRP_POS_ENTRY entry;
+            if (pPos == NULL)
+            {
+                return MAC_STATUS_INVALID_INDEX;
+            }
+
+            entry.shortAddress = pPos->shortAddress;
+            entry.lqi = pPos->lqi;
+            entry.posValidTime = _simPosValidTime(pPos);
+            pibValue->length = (uint8_t) sizeof(entry);
+            (void) memcpy(pibValue->value, &entry, sizeof(entry));
+            return MAC_STATUS_SUCCESS;
+        }
+
+        case MAC_PIB_TMR_TTL:
+            pibValue->length = 1U;
+            pibValue->value[0] = pMac->tmrTtl;
+            return MAC_STATUS_SUCCESS;
+
+        case MAC_PIB_DSN:
+            pibValue->length = 1U;
+            pibValue->value[0] = pMac->dsn;
+            return MAC_STATUS_SUCCESS;
+
+        case MAC_PIB_MANUF_NEIGHBOUR_TABLE_ELEMENT:
+            /* No tone map exchange, so no neighbour table */
+            return MAC_STATUS_INVALID_INDEX;
+
+        default:
+            return MAC_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+}
+
+MAC_STATUS MAC_PLC_SetRequestSync(MAC_PLC_PIB_ATTRIBUTE attribute, uint16_t index, const MAC_PIB_VALUE *pibValue)
+{
+    SIM_MAC* pMac = _simMac(MAC_SIM_PLC);
+
+    switch (attribute)
+    {
+        case MAC_PIB_TMR_TTL:
+            pMac->tmrTtl = pibValue->value[0];
+            return MAC_STATUS_SUCCESS;
+
+        case MAC_PIB_DSN:
+            pMac->dsn = pibValue->value[0];
+            return MAC_STATUS_SUCCESS;
+
+        case MAC_PIB_MANUF_RESET_TMR_TTL:
+            return MAC_STATUS_SUCCESS;
+
+        default:
+            return MAC_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+}
+
+MAC_STATUS MAC_PLC_MIB_SetAttributeSync(MAC_COMMON_PIB_ATTRIBUTE attribute, uint16_t index,
+    const MAC_PIB_VALUE *pibValue)
+{
+    return MAC_STATUS_SUCCESS;
+}
+
+void MAC_PLC_ResetRequest(MAC_RESET_REQUEST_PARAMS *rstParams)
+{
+    _simMacResetRequest(MAC_SIM_PLC, rstParams);
+}
+
+void MAC_PLC_ScanRequest(MAC_SCAN_REQUEST_PARAMS *scanParams)
+{
+    _simMacScanRequest(MAC_SIM_PLC, scanParams);
+}
+
+void MAC_PLC_StartRequest(MAC_START_REQUEST_PARAMS *startParams)
+{
+    _simMacStartRequest(MAC_SIM_PLC, startParams);
+}
+
+void MAC_RF_Init(MAC_RF_INIT *init)
+{
+    const MAC_RF_HANDLERS* pRf = &init->macRfHandlers;
+    SIM_HANDLERS handlers = {
+        pRf->macRfDataConfirm, pRf->macRfDataIndication, pRf->macRfResetConfirm,
+        pRf->macRfBeaconNotifyIndication, pRf->macRfScanConfirm, pRf->macRfStartConfirm,
+        pRf->macRfCommStatusIndication, pRf->macRfMacSnifferIndication
+    };
+
+    _simMacInit(MAC_SIM_RF, &handlers);
+}
+
+void MAC_RF_Tasks(void)
+{
+}
+
+SYS_STATUS MAC_RF_Status(void)
+{
+    return _simMac(MAC_SIM_RF)->initialized ? SYS_STATUS_READY : SYS_STATUS_UNINITIALIZED;
+}
+
+void MAC_RF_DataRequest(MAC_DATA_REQUEST_PARAMS *drParams)
+{
+    _simMacDataRequest(MAC_SIM_RF, drParams);
+}
+
+MAC_STATUS MAC_RF_GetRequestSync(MAC_RF_PIB_ATTRIBUTE attribute, uint16_t index, MAC_PIB_VALUE *pibValue)
+{
+    SIM_MAC* pMac = _simMac(MAC_SIM_RF);
+
+    pibValue->length = 0U;
+    switch (attribute)
+    {
+        case MAC_PIB_MANUF_POS_TABLE_ELEMENT_RF:
+        {
+            SIM_POS* pPos = _simPosFind(pMac, index);
+            MAC_RF_POS_TABLE_ENTRY entry;
+            if (pPos == NULL)
+            {
+                return MAC_STATUS_INVALID_INDEX;
+            }
+
+            /* Links are symmetric, the reverse LQI is the forward one */
+            (void) memset(&entry, 0, sizeof(entry));
+            entry.shortAddress = pPos->shortAddress;
+            entry.forwardLqi = pPos->lqi;
+            entry.reverseLqi = pPos->lqi;
+            entry.posValidTime = _simPosValidTime(pPos);
+            entry.reverseLqiValidTime = entry.posValidTime;
+            pibValue->length = (uint8_t) sizeof(entry);
+            (void) memcpy(pibValue->value, &entry, sizeof(entry));
+            return MAC_STATUS_SUCCESS;
+        }
+
+        case MAC_PIB_DSN_RF:
+            pibValue->length = 1U;
+            pibValue->value[0] = pMac->dsn;
+            return MAC_STATUS_SUCCESS;
+
+        default:
+            return MAC_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+}
+
+MAC_STATUS MAC_RF_SetRequestSync(MAC_RF_PIB_ATTRIBUTE attribute, uint16_t index, const MAC_PIB_VALUE *pibValue)
+{
+    if (attribute == MAC_PIB_DSN_RF)
+    {
+        _simMac(MAC_SIM_RF)->dsn = pibValue->value[0];
+        return MAC_STATUS_SUCCESS;
+    }
+
+    return MAC_STATUS_UNSUPPORTED_ATTRIBUTE;
+}
+
+void MAC_RF_ResetRequest(MAC_RESET_REQUEST_PARAMS *rstParams)
+{
+    _simMacResetRequest(MAC_SIM_RF, rstParams);
+}
+
+void MAC_RF_ScanRequest(MAC_SCAN_REQUEST_PARAMS *scanParams)
+{
+    _simMacScanRequest(MAC_SIM_RF, scanParams);
+}
+
+void MAC_RF_StartRequest(MAC_START_REQUEST_PARAMS *srParams)
+{
+    _simMacStartRequest(MAC_SIM_RF, srParams);
+}
+
+uint64_t SYS_TIME_Counter64Get(void)
+{
+    return sim.timeUS;
+}
+
+uint32_t SYS_TIME_CountToMS(uint32_t count)
+{
+    return count / 1000U;
+}
+
+uint32_t SYS_TIME_MSToCount(uint32_t ms)
+{
+    return ms * 1000U;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Interface
+// *****************************************************************************
+// *****************************************************************************
+
+bool MAC_SIM_Init(uint16_t nodes, uint32_t seed)
+{
+    SIM_CONTEXT initCtx;
+
+    MAC_SIM_Free();
+    if ((nodes == 0U) || (nodes == SIM_NODE_NONE))
+    {
+        return false;
+    }
+
+    sim.nodesNum = nodes;
+    sim.random = ((uint64_t) seed * 0x9E3779B97F4A7C15ULL) ^ 0xD1B54A32D192ED03ULL;
+    sim.nodes = calloc(nodes, sizeof(SIM_NODE));
+    sim.links = malloc((size_t) nodes * nodes * MAC_SIM_MEDIA * sizeof(SIM_LINK));
+    if ((sim.nodes == NULL) || (sim.links == NULL))
+    {
+        MAC_SIM_Free();
+        return false;
+    }
+
+    for (size_t i = 0U; i < ((size_t) nodes * nodes * MAC_SIM_MEDIA); i++)
+    {
+        sim.links[i].per = 1.0f;
+        sim.links[i].lqi = 0U;
+    }
+
+    /* File scope data as after the start up of the firmware */
+    (void) memset(&macWrpData, 0, sizeof(macWrpData));
+    (void) memset(dataReqQueue, 0, sizeof(dataReqQueue));
+    (void) memset(hyALDuplicatesTable, 0, sizeof(hyALDuplicatesTable));
+    (void) memset(&hyalData, 0, sizeof(hyalData));
+    macMibCommon = macMibCommonDefaults;
+    previousCounter64 = 0U;
+    auxMsCounter = 0U;
+    currentMsCounter = 0U;
+    currentSecondCounter = 0U;
+    _simContextSave(&initCtx);
+    for (uint16_t i = 0U; i < nodes; i++)
+    {
+        sim.nodes[i].ctx = initCtx;
+    }
+
+    sim.current = 0U;
+    return true;
+}
+
+void MAC_SIM_Free(void)
+{
+    if (sim.nodes != NULL)
+    {
+        for (uint16_t i = 0U; i < sim.nodesNum; i++)
+        {
+            free(sim.nodes[i].neighbours[MAC_SIM_PLC].nodes);
+            free(sim.nodes[i].neighbours[MAC_SIM_RF].nodes);
+        }
+    }
+
+    free(sim.nodes);
+    free(sim.links);
+    free(sim.events);
+    (void) memset(&sim, 0, sizeof(sim));
+}
+
+void MAC_SIM_SetLink(uint16_t nodeA, uint16_t nodeB, MAC_SIM_MEDIUM medium, double per, uint8_t lqi)
+{
+    if ((nodeA >= sim.nodesNum) || (nodeB >= sim.nodesNum) || (nodeA == nodeB) || (medium >= MAC_SIM_MEDIA))
+    {
+        return;
+    }
+
+    if (per >= 1.0)
+    {
+        per = 1.0;
+        _simNeighbourRemove(&sim.nodes[nodeA].neighbours[medium], nodeB);
+        _simNeighbourRemove(&sim.nodes[nodeB].neighbours[medium], nodeA);
+    }
+    else
+    {
+        _simNeighbourAdd(&sim.nodes[nodeA].neighbours[medium], nodeB);
+        _simNeighbourAdd(&sim.nodes[nodeB].neighbours[medium], nodeA);
+    }
+
+    _simLink(nodeA, nodeB, medium)->per = (float) per;
+    _simLink(nodeA, nodeB, medium)->lqi = lqi;
+    _simLink(nodeB, nodeA, medium)->per = (float) per;
+    _simLink(nodeB, nodeA, medium)->lqi = lqi;
+}
+
+bool MAC_SIM_GetLink(uint16_t nodeA, uint16_t nodeB, MAC_SIM_MEDIUM medium, double* pPer, uint8_t* pLqi)
+{
+    SIM_LINK* pLink;
+
+    if ((nodeA >= sim.nodesNum) || (nodeB >= sim.nodesNum) || (nodeA == nodeB) || (medium >= MAC_SIM_MEDIA))
+    {
+        return false;
+    }
+
+    pLink = _simLink(nodeA, nodeB, medium);
+    *pPer = pLink->per;
+    *pLqi = pLink->lqi;
+    return pLink->per < 1.0f;
+}
+
+void MAC_SIM_Select(uint16_t node)
+{
+    if (node >= sim.nodesNum)
+    {
+        return;
+    }
+
+    if (node != sim.current)
+    {
+        _simContextSave(&sim.nodes[sim.current].ctx);
+        _simContextRestore(&sim.nodes[node].ctx);
+        sim.current = node;
+    }
+
+    /* Catch up with the time elapsed since the node was last current: the
+       seconds counter only moves one second per call */
+    (void) MAC_COMMON_GetMsCounter();
+    while ((currentMsCounter - auxMsCounter) >= 1000U)
+    {
+        (void) MAC_COMMON_GetMsCounter();
+    }
+}
+
+uint16_t MAC_SIM_Current(void)
+{
+    return sim.current;
+}
+
+void MAC_SIM_Run(uint64_t timeUS)
+{
+    while ((sim.eventsNum > 0U) && (sim.events[0].timeUS <= timeUS))
+    {
+        SIM_EVENT ev = _simEventPop();
+        sim.timeUS = ev.timeUS;
+        sim.stats.events++;
+        _simEventRun(&ev);
+    }
+
+    if (timeUS > sim.timeUS)
+    {
+        sim.timeUS = timeUS;
+    }
+
+    if ((sim.timeUS - sim.refreshUS) >= SIM_REFRESH_US)
+    {
+        uint16_t current = sim.current;
+        sim.refreshUS = sim.timeUS;
+        for (uint16_t i = 0U; i < sim.nodesNum; i++)
+        {
+            MAC_SIM_Select(i);
+        }
+
+        MAC_SIM_Select(current);
+    }
+}
+
+uint64_t MAC_SIM_TimeUS(void)
+{
+    return sim.timeUS;
+}
+
+uint32_t MAC_SIM_PendingEvents(void)
+{
+    return sim.eventsNum;
+}
+
+uint32_t MAC_SIM_AttemptUS(MAC_SIM_MEDIUM medium, uint16_t msduLength, bool ackRequest)
+{
+    uint32_t attemptUS = _simFrameUS(medium, msduLength);
+
+    if (medium == MAC_SIM_PLC)
+    {
+        attemptUS += SIM_PLC_IFS_US + (ackRequest ? SIM_PLC_ACK_US : 0U);
+    }
+    else
+    {
+        attemptUS += SIM_RF_IFS_US + (ackRequest ? SIM_RF_ACK_US : 0U);
+    }
+
+    return attemptUS;
+}
+
+void MAC_SIM_GetStats(MAC_SIM_STATS* pStats)
+{
+    *pStats = sim.stats;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+  Simulated G3 PLC and RF MAC layers for the G3 MAC simulation
+
+  File Name:
+    mac_sim.h
+
+  Summary:
+    Network of nodes running mac_wrapper.c over simulated MAC layers.
+
+  Description:
+    mac_sim.c builds mac_wrapper.c and mac_common.c of the configuration and
+    replaces the MAC PLC and MAC RF libraries and SYS_TIME by a simulation
+    of a network of nodes sharing a simulated time. Every pair of nodes has
+    a link per medium, with a packet error rate and the LQI reported by the
+    receiver.
+
+    The file scope data of mac_wrapper.c and mac_common.c is kept per node.
+    MAC_SIM_Select makes a node the current one: MAC_WRP_* calls made by the
+    test and callbacks from the wrapper run on the current node. Callbacks
+    from MAC_SIM_Run select the node they are delivered to.
+*******************************************************************************/
+
+#ifndef MAC_SIM_H
+#define MAC_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Frame retries of the simulated MAC layers (macMaxFrameRetries) */
+#define MAC_SIM_PLC_RETRIES         5U
+#define MAC_SIM_RF_RETRIES          3U
+
+typedef enum
+{
+    MAC_SIM_PLC = 0,
+    MAC_SIM_RF,
+    MAC_SIM_MEDIA
+} MAC_SIM_MEDIUM;
+
+typedef struct
+{
+    uint64_t    events;                     /* Events processed */
+    uint32_t    txFrames[MAC_SIM_MEDIA];    /* Data confirms */
+    uint32_t    txAttempts[MAC_SIM_MEDIA];  /* Frames sent, retries included */
+    uint32_t    rxFrames[MAC_SIM_MEDIA];    /* Data indications */
+    uint32_t    rxLost[MAC_SIM_MEDIA];      /* Frames lost by the link PER */
+    uint32_t    rxRetries[MAC_SIM_MEDIA];   /* Retries dropped by the DSN */
+    uint32_t    beacons[MAC_SIM_MEDIA];     /* Beacon notifications */
+} MAC_SIM_STATS;
+
+/* Create a network of unconnected nodes at time 0 */
+bool MAC_SIM_Init(uint16_t nodes, uint32_t seed);
+void MAC_SIM_Free(void);
+
+/* Link in both directions, PER 1.0 or above removes it */
+void MAC_SIM_SetLink(uint16_t nodeA, uint16_t nodeB, MAC_SIM_MEDIUM medium, double per, uint8_t lqi);
+bool MAC_SIM_GetLink(uint16_t nodeA, uint16_t nodeB, MAC_SIM_MEDIUM medium, double* pPer, uint8_t* pLqi);
+
+void MAC_SIM_Select(uint16_t node);
+uint16_t MAC_SIM_Current(void);
+
+/* Run the events up to timeUS and advance the time to it */
+void MAC_SIM_Run(uint64_t timeUS);
+uint64_t MAC_SIM_TimeUS(void);
+uint32_t MAC_SIM_PendingEvents(void);
+
+/* Air time of one attempt, from the frame start to the end of the ACK wait */
+uint32_t MAC_SIM_AttemptUS(MAC_SIM_MEDIUM medium, uint16_t msduLength, bool ackRequest);
+
+void MAC_SIM_GetStats(MAC_SIM_STATS* pStats);
+
+#endif // MAC_SIM_H
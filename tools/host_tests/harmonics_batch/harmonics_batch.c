@@ -0,0 +1,634 @@
+/*******************************************************************************
+  Batch harmonic analysis test
+
+  File Name:
+    harmonics_batch.c
+
+  Summary:
+    Host test of DRV_METROLOGY_StartHarmonicAnalysisBatch against synthetic
+    waveforms.
+
+  Description:
+    drv_metrology.c of the G3 metering demo is built for the host with its
+    own configuration. A model of the metrology library samples synthetic
+    voltage and current waveforms of known harmonic content at TEST_FS_HZ,
+    TEST_N samples per integration period, with ADC noise. At the end of
+    every period it raises the IPC interrupt and, when a harmonic order has
+    been requested in FEATURE_CTRL1 for 1 to TEST_MAX_CONF_DELAY periods
+    (random), writes the DFT of every channel at that order to the harmonic
+    registers (sQ25.6) and confirms the order in STATE_FLAG. The main loop
+    calls DRV_METROLOGY_Tasks once per period.
+
+    For each batch, the batch callback must be called once with the number
+    of orders of the bitmap; the table must hold the RMS of every order, in
+    ascending order, within TEST_RMS_TOLERANCE_xxx of the synthetic waveforms,
+    and the THD of every channel must be the one of the RMS values of the
+    table, and within TEST_THD_TOLERANCE_xxx of the one of the waveforms for
+    the analyzed orders (0 if the fundamental is not analyzed). The
+    integration callback must keep being called every period while the batch
+    runs. Invalid requests must be rejected, and a single order analysis must
+    still work after a batch.
+
+    Usage:
+      harmonics_batch
+*******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "device.h"
+
+/* The Cortex-M barrier is an instruction the host assembler does not know */
+#define __DMB()                             __sync_synchronize()
+
+static ipc_registers_t testIpc;
+#undef IPC1_REGS
+#define IPC1_REGS                           (&testIpc)
+
+#include "drv_metrology_host.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_FS_HZ              4000U
+#define TEST_F0_HZ              50U
+#define TEST_SAMPLES_PER_CYCLE  (TEST_FS_HZ / TEST_F0_HZ)
+#define TEST_N                  4000U
+
+/* Highest order of the waveforms, below the Nyquist frequency */
+#define TEST_MAX_ORDER          39U
+#define TEST_CHANNELS           7U
+
+/* ADC noise, peak, in waveform units */
+#define TEST_NOISE              0.5
+
+/* Periods from a harmonic request to its result, at most */
+#define TEST_MAX_CONF_DELAY     3U
+
+/* RMS: absolute plus relative. THD: percentage points plus relative, from
+   the RMS errors of the fundamental and the harmonics */
+#define TEST_RMS_TOLERANCE_ABS  0.02
+#define TEST_RMS_TOLERANCE_REL  0.001
+#define TEST_THD_TOLERANCE_ABS  0.02
+#define TEST_THD_TOLERANCE_REL  0.005
+
+#define TEST_TABLE_SIZE         64U
+
+/* Channels in the order of the harmonic registers */
+enum
+{
+    TEST_CH_IA = 0,
+    TEST_CH_VA,
+    TEST_CH_IB,
+    TEST_CH_VB,
+    TEST_CH_IC,
+    TEST_CH_VC,
+    TEST_CH_IN,
+};
+
+static const char *testChannelNames[TEST_CHANNELS] = {"IA", "VA", "IB", "VB", "IC", "VC", "IN"};
+
+typedef struct
+{
+    const char *name;
+    uint64_t bitmap;
+    uint8_t tableSize;
+    bool thd;
+} TEST_BATCH;
+
+static const TEST_BATCH testBatches[] =
+{
+    {"orders 1-31",             DRV_METROLOGY_HARMONICS_RANGE(1U, 31U),  TEST_TABLE_SIZE, true},
+    {"odd orders 1-13",         0x2AAAULL,                              7U,              true},
+    {"orders 2-39, no fund.",   DRV_METROLOGY_HARMONICS_RANGE(2U, 39U),  TEST_TABLE_SIZE, true},
+    {"orders 1-39, no THD",     DRV_METROLOGY_HARMONICS_RANGE(1U, 39U),  TEST_TABLE_SIZE, false},
+};
+
+typedef struct
+{
+    /* RMS and phase of every order of every channel */
+    double rms[TEST_CHANNELS][TEST_MAX_ORDER + 1U];
+    double phase[TEST_CHANNELS][TEST_MAX_ORDER + 1U];
+    /* One integration period of samples, without noise */
+    double samples[TEST_CHANNELS][TEST_N];
+} TEST_WAVEFORMS;
+
+typedef struct
+{
+    uint32_t period;
+    uint32_t integrations;
+    uint32_t batchCalls;
+    uint8_t batchCount;
+    uint32_t singleCalls;
+    uint8_t singleOrder;
+    uint32_t reqOrder;
+    uint32_t reqAge;
+    uint32_t confDelay;
+    uint32_t fails;
+} TEST_STATE;
+
+static MET_REGISTERS testShared;
+static TEST_WAVEFORMS testWaves;
+static TEST_STATE testState;
+static DRV_METROLOGY_HARMONICS_RMS testTable[TEST_TABLE_SIZE];
+static uint64_t testRandState = 0x2545F4914F6CDD1DULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Metrology Library Model
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static double _uniform(double max)
+{
+    return max * ((double)(_rand64() >> 11) / 9007199254740992.0);
+}
+
+/* Mains voltages with some low order distortion, rectifier load currents
+   with odd harmonics decreasing as 1/m, and a neutral current made of the
+   triplen harmonics of the phases */
+static void _buildWaveforms(void)
+{
+    static const double vHarmonics[TEST_MAX_ORDER + 1U] =
+    {
+        [3] = 0.020, [5] = 0.030, [7] = 0.015, [9] = 0.005, [11] = 0.010, [13] = 0.007,
+        [17] = 0.004, [19] = 0.003, [23] = 0.002, [25] = 0.002, [37] = 0.001,
+    };
+    static const double iFundamental[3] = {10.0, 8.0, 12.0};
+    uint32_t ch, m, n, phaseIdx;
+    double angle;
+
+    (void) memset(&testWaves, 0, sizeof(testWaves));
+
+    for (phaseIdx = 0U; phaseIdx < 3U; phaseIdx++)
+    {
+        uint32_t vCh = TEST_CH_VA + (2U * phaseIdx);
+        uint32_t iCh = TEST_CH_IA + (2U * phaseIdx);
+
+        testWaves.rms[vCh][1] = 230.0;
+        for (m = 2U; m <= TEST_MAX_ORDER; m++)
+        {
+            testWaves.rms[vCh][m] = 230.0 * vHarmonics[m];
+        }
+
+        testWaves.rms[iCh][1] = iFundamental[phaseIdx];
+        for (m = 3U; m <= TEST_MAX_ORDER; m += 2U)
+        {
+            testWaves.rms[iCh][m] = iFundamental[phaseIdx] / (double)m;
+        }
+    }
+
+    testWaves.rms[TEST_CH_IN][1] = 2.0;
+    for (m = 3U; m <= TEST_MAX_ORDER; m += 6U)
+    {
+        testWaves.rms[TEST_CH_IN][m] = 30.0 / (double)m;
+    }
+
+    for (ch = 0U; ch < TEST_CHANNELS; ch++)
+    {
+        for (m = 1U; m <= TEST_MAX_ORDER; m++)
+        {
+            testWaves.phase[ch][m] = _uniform(2.0 * M_PI);
+        }
+
+        for (n = 0U; n < TEST_N; n++)
+        {
+            for (m = 1U; m <= TEST_MAX_ORDER; m++)
+            {
+                if (testWaves.rms[ch][m] != 0.0)
+                {
+                    angle = (2.0 * M_PI * (double)((m * n) % TEST_SAMPLES_PER_CYCLE)) / (double)TEST_SAMPLES_PER_CYCLE;
+                    testWaves.samples[ch][n] += sqrt(2.0) * testWaves.rms[ch][m] * cos(angle + testWaves.phase[ch][m]);
+                }
+            }
+        }
+    }
+}
+
+/* DFT of one period of samples with noise, in sQ25.6 */
+static void _writeHarmonic(uint32_t order)
+{
+    uint32_t *pHar = (uint32_t *)&testShared.MET_HARMONICS;
+    uint32_t ch, n;
+    double re, im, x, angle;
+
+    for (ch = 0U; ch < TEST_CHANNELS; ch++)
+    {
+        re = 0.0;
+        im = 0.0;
+        for (n = 0U; n < TEST_N; n++)
+        {
+            x = testWaves.samples[ch][n] + _uniform(2.0 * TEST_NOISE) - TEST_NOISE;
+            angle = (2.0 * M_PI * (double)((order * n) % TEST_SAMPLES_PER_CYCLE)) / (double)TEST_SAMPLES_PER_CYCLE;
+            re += x * cos(angle);
+            im -= x * sin(angle);
+        }
+
+        pHar[ch] = (uint32_t)(int32_t)lround(re * 64.0);
+        pHar[ch + TEST_CHANNELS] = (uint32_t)(int32_t)lround(im * 64.0);
+    }
+
+    *(uint32_t *)&testShared.MET_STATUS.STATE_FLAG = STATUS_STATE_FLAG_HARMONIC_m_CONF(order);
+}
+
+/* End of an integration period: harmonic result when ready, interrupt */
+static void _endPeriod(void)
+{
+    uint32_t ctrl1 = testShared.MET_CONTROL.FEATURE_CTRL1;
+    uint32_t order = (ctrl1 & FEATURE_CTRL1_HARMONIC_m_REQ_Msk) >> FEATURE_CTRL1_HARMONIC_m_REQ_Pos;
+
+    if ((ctrl1 & FEATURE_CTRL1_HARMONIC_EN_Msk) != 0U)
+    {
+        if (order != testState.reqOrder)
+        {
+            testState.reqOrder = order;
+            testState.reqAge = 0U;
+            testState.confDelay = 1U + (uint32_t)(_rand64() % TEST_MAX_CONF_DELAY);
+        }
+
+        testState.reqAge++;
+        if (testState.reqAge == testState.confDelay)
+        {
+            _writeHarmonic(order);
+        }
+    }
+    else
+    {
+        testState.reqOrder = 0U;
+    }
+
+    testState.period++;
+    *(uint32_t *)&testShared.MET_STATUS.INTERVAL_NUM = testState.period;
+
+    *(uint32_t *)&testIpc.IPC_ISR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK;
+    *(uint32_t *)&testIpc.IPC_IMR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK | DRV_METROLOGY_IPC_INIT_IRQ_MSK;
+    IPC1_InterruptHandler();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver Callbacks
+// *****************************************************************************
+// *****************************************************************************
+
+static void _integrationCallback(void)
+{
+    testState.integrations++;
+}
+
+static void _batchCallback(uint8_t numHarmonics)
+{
+    testState.batchCalls++;
+    testState.batchCount = numHarmonics;
+}
+
+static void _singleCallback(uint8_t harmonicNum)
+{
+    testState.singleCalls++;
+    testState.singleOrder = harmonicNum;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char *name, const char *msg, double value)
+{
+    testState.fails++;
+    if (testState.fails <= 20U)
+    {
+        printf("FAIL: %s: %s %g\n", name, msg, value);
+    }
+}
+
+static void _reset(void)
+{
+    (void) memset(&testState, 0, sizeof(testState));
+    (void) memset(&testShared, 0, sizeof(testShared));
+    *(uint32_t *)&testShared.MET_STATUS.STATUS = STATUS_STATUS_DSP_RUNNING;
+    *(uint32_t *)&testShared.MET_STATUS.N = TEST_N;
+
+    gDrvMetObj.metRegisters = &testShared;
+    gDrvMetObj.ipcInterruptFlag = false;
+    gDrvMetObj.integrationFlag = false;
+    gDrvMetObj.calibrationData.running = false;
+    gDrvMetObj.harmonicAnalysisData.running = false;
+    gDrvMetObj.harmonicAnalysisData.batch = false;
+    lDRV_METROLOGY_ResetIntegrationData();
+}
+
+/* Runs integration periods until the callback counter changes or maxPeriods */
+static uint32_t _runUntil(const uint32_t *pCalls, uint32_t maxPeriods)
+{
+    uint32_t calls = *pCalls;
+    uint32_t periods = 0U;
+
+    while ((*pCalls == calls) && (periods < maxPeriods))
+    {
+        _endPeriod();
+        DRV_METROLOGY_Tasks((SYS_MODULE_OBJ)1);
+        periods++;
+    }
+
+    return periods;
+}
+
+static double _channelRms(const DRV_METROLOGY_HARMONICS_RMS *pRms, uint32_t ch)
+{
+    switch (ch)
+    {
+        case TEST_CH_IA: return pRms->Irms_A_m;
+        case TEST_CH_VA: return pRms->Vrms_A_m;
+        case TEST_CH_IB: return pRms->Irms_B_m;
+        case TEST_CH_VB: return pRms->Vrms_B_m;
+        case TEST_CH_IC: return pRms->Irms_C_m;
+        case TEST_CH_VC: return pRms->Vrms_C_m;
+        default: return pRms->Irms_N_m;
+    }
+}
+
+static double _channelThd(const DRV_METROLOGY_HARMONICS_THD *pThd, uint32_t ch)
+{
+    switch (ch)
+    {
+        case TEST_CH_IA: return pThd->Ithd_A;
+        case TEST_CH_VA: return pThd->Vthd_A;
+        case TEST_CH_IB: return pThd->Ithd_B;
+        case TEST_CH_VB: return pThd->Vthd_B;
+        case TEST_CH_IC: return pThd->Ithd_C;
+        case TEST_CH_VC: return pThd->Vthd_C;
+        default: return pThd->Ithd_N;
+    }
+}
+
+static void _checkRms(const char *name, const DRV_METROLOGY_HARMONICS_RMS *pRms, uint32_t order, double *pMaxErr)
+{
+    uint32_t ch;
+    double expected, err;
+
+    for (ch = 0U; ch < TEST_CHANNELS; ch++)
+    {
+        expected = (order <= TEST_MAX_ORDER) ? testWaves.rms[ch][order] : 0.0;
+        err = fabs(_channelRms(pRms, ch) - expected);
+        if (err > *pMaxErr)
+        {
+            *pMaxErr = err;
+        }
+
+        if (err > (TEST_RMS_TOLERANCE_ABS + (TEST_RMS_TOLERANCE_REL * expected)))
+        {
+            printf("  %s order %u: %.4f, expected %.4f\n", testChannelNames[ch], (unsigned)order,
+                    _channelRms(pRms, ch), expected);
+            _fail(name, "RMS out of tolerance, order", (double)order);
+        }
+    }
+}
+
+static bool _testBatch(const TEST_BATCH *batch)
+{
+    DRV_METROLOGY_HARMONICS_THD thd;
+    double squareSum[TEST_CHANNELS], tableSum[TEST_CHANNELS], tableFund[TEST_CHANNELS];
+    double expected, tableThd, maxRmsErr = 0.0, maxThdErr = 0.0;
+    uint32_t nOrders = 0U, periods, order, ch, idx;
+    uint32_t fails = testState.fails;
+
+    _reset();
+    testState.fails = fails;
+
+    for (order = 1U; order <= DRV_METROLOGY_HARMONIC_ORDER_MAX; order++)
+    {
+        if ((batch->bitmap & (1ULL << order)) != 0U)
+        {
+            nOrders++;
+        }
+    }
+
+    (void) memset(testTable, 0xFF, sizeof(testTable));
+    (void) memset(&thd, 0xFF, sizeof(thd));
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(batch->bitmap, testTable, batch->tableSize,
+            (batch->thd == true) ? &thd : NULL) != DRV_METROLOGY_SUCCESS)
+    {
+        _fail(batch->name, "batch not started, orders", (double)nOrders);
+        return false;
+    }
+
+    /* A single order request is ignored while the batch runs */
+    DRV_METROLOGY_StartHarmonicAnalysis(2U, &testTable[TEST_TABLE_SIZE - 1U]);
+
+    periods = _runUntil(&testState.batchCalls, nOrders * (2U + TEST_MAX_CONF_DELAY) + 2U);
+
+    /* One more period: the callback must not be called again */
+    _endPeriod();
+    DRV_METROLOGY_Tasks((SYS_MODULE_OBJ)1);
+
+    if ((testState.batchCalls != 1U) || (testState.batchCount != nOrders))
+    {
+        _fail(batch->name, "batch callbacks", (double)testState.batchCalls);
+        _fail(batch->name, "harmonics reported", (double)testState.batchCount);
+    }
+
+    if (testState.integrations != (periods + 1U))
+    {
+        _fail(batch->name, "integration callbacks missed", (double)(periods + 1U - testState.integrations));
+    }
+
+    if (testState.singleCalls != 0U)
+    {
+        _fail(batch->name, "single order callback during the batch", (double)testState.singleCalls);
+    }
+
+    /* Table in ascending order */
+    (void) memset(squareSum, 0, sizeof(squareSum));
+    (void) memset(tableSum, 0, sizeof(tableSum));
+    (void) memset(tableFund, 0, sizeof(tableFund));
+    for (order = 1U, idx = 0U; order <= DRV_METROLOGY_HARMONIC_ORDER_MAX; order++)
+    {
+        if ((batch->bitmap & (1ULL << order)) != 0U)
+        {
+            _checkRms(batch->name, &testTable[idx], order, &maxRmsErr);
+            for (ch = 0U; ch < TEST_CHANNELS; ch++)
+            {
+                if (order == 1U)
+                {
+                    tableFund[ch] = _channelRms(&testTable[idx], ch);
+                }
+                else
+                {
+                    tableSum[ch] += _channelRms(&testTable[idx], ch) * _channelRms(&testTable[idx], ch);
+                    if (order <= TEST_MAX_ORDER)
+                    {
+                        squareSum[ch] += testWaves.rms[ch][order] * testWaves.rms[ch][order];
+                    }
+                }
+            }
+            idx++;
+        }
+    }
+
+    for (ch = 0U; (ch < TEST_CHANNELS) && (batch->thd == true); ch++)
+    {
+        expected = 0.0;
+        tableThd = 0.0;
+        if ((batch->bitmap & 2U) != 0U)
+        {
+            expected = (sqrt(squareSum[ch]) * 100.0) / testWaves.rms[ch][1];
+            tableThd = (sqrt(tableSum[ch]) * 100.0) / tableFund[ch];
+        }
+
+        if (fabs(_channelThd(&thd, ch) - tableThd) > (1e-9 * tableThd))
+        {
+            printf("  %s THD %.6f %%, table %.6f %%\n", testChannelNames[ch], _channelThd(&thd, ch), tableThd);
+            _fail(batch->name, "THD not the one of the table, channel", (double)ch);
+        }
+
+        if ((fabs(_channelThd(&thd, ch) - expected) / (TEST_THD_TOLERANCE_ABS + (TEST_THD_TOLERANCE_REL * expected))) >
+                maxThdErr)
+        {
+            maxThdErr = fabs(_channelThd(&thd, ch) - expected) / (TEST_THD_TOLERANCE_ABS + (TEST_THD_TOLERANCE_REL * expected));
+        }
+
+        if (fabs(_channelThd(&thd, ch) - expected) > (TEST_THD_TOLERANCE_ABS + (TEST_THD_TOLERANCE_REL * expected)))
+        {
+            printf("  %s THD %.3f %%, expected %.3f %%\n", testChannelNames[ch], _channelThd(&thd, ch), expected);
+            _fail(batch->name, "THD out of tolerance, channel", (double)ch);
+        }
+    }
+
+    printf("%-22s %6u %7u %9.1f %11.4f %11.4f\n", batch->name, (unsigned)nOrders, (unsigned)periods,
+            (double)periods / (double)nOrders, maxRmsErr, maxThdErr);
+
+    if (batch->thd == true)
+    {
+        printf("  THD %%: IA %.2f IB %.2f IC %.2f IN %.2f VA %.2f VB %.2f VC %.2f\n", thd.Ithd_A, thd.Ithd_B,
+                thd.Ithd_C, thd.Ithd_N, thd.Vthd_A, thd.Vthd_B, thd.Vthd_C);
+    }
+
+    return (testState.fails == fails);
+}
+
+static bool _testErrors(void)
+{
+    uint32_t fails;
+
+    _reset();
+
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(0U, testTable, TEST_TABLE_SIZE, NULL) != DRV_METROLOGY_ERROR)
+    {
+        _fail("errors", "empty bitmap accepted", 0.0);
+    }
+
+    /* Order 0 is not a harmonic */
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(1U, testTable, TEST_TABLE_SIZE, NULL) != DRV_METROLOGY_ERROR)
+    {
+        _fail("errors", "order 0 accepted", 0.0);
+    }
+
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1U, 7U), testTable, 6U, NULL) !=
+            DRV_METROLOGY_ERROR)
+    {
+        _fail("errors", "table too small accepted", 6.0);
+    }
+
+    if (DRV_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1U, 7U), NULL, TEST_TABLE_SIZE, NULL) !=
+            DRV_METROLOGY_ERROR)
+    {
+        _fail("errors", "no table accepted", 0.0);
+    }
+
+    if (gDrvMetObj.harmonicAnalysisData.running == true)
+    {
+        _fail("errors", "analysis started by a rejected request", 0.0);
+    }
+
+    if ((DRV_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1U, 3U), testTable, 3U, NULL) !=
+            DRV_METROLOGY_SUCCESS) ||
+            (DRV_METROLOGY_StartHarmonicAnalysisBatch(DRV_METROLOGY_HARMONICS_RANGE(1U, 3U), testTable, 3U, NULL) !=
+            DRV_METROLOGY_ERROR))
+    {
+        _fail("errors", "second batch accepted while running", 0.0);
+    }
+
+    (void) _runUntil(&testState.batchCalls, 3U * (2U + TEST_MAX_CONF_DELAY) + 2U);
+
+    /* Single order analysis after a batch */
+    fails = testState.fails;
+    DRV_METROLOGY_StartHarmonicAnalysis(5U, &testTable[0]);
+    (void) _runUntil(&testState.singleCalls, 2U + TEST_MAX_CONF_DELAY + 2U);
+    if ((testState.singleCalls != 1U) || (testState.singleOrder != 5U) || (testState.batchCalls != 1U))
+    {
+        _fail("single order", "callbacks", (double)testState.singleCalls);
+    }
+    else
+    {
+        double maxErr = 0.0;
+        _checkRms("single order", &testTable[0], 5U, &maxErr);
+    }
+
+    printf("Invalid requests rejected, single order analysis after a batch: %s\n",
+            (testState.fails == 0U) ? "ok" : "failed");
+
+    return (testState.fails == 0U);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    bool pass = true;
+    size_t idx;
+
+    (void) argc;
+    (void) argv;
+
+    _buildWaveforms();
+    DRV_METROLOGY_IntegrationCallbackRegister(_integrationCallback);
+    DRV_METROLOGY_HarmonicBatchCallbackRegister(_batchCallback);
+    DRV_METROLOGY_HarmonicAnalysisCallbackRegister(_singleCallback);
+
+    printf("fs %u Hz, f0 %u Hz, %u samples per period, noise %.1f, result 1 to %u periods after the request\n",
+            TEST_FS_HZ, TEST_F0_HZ, TEST_N, TEST_NOISE, TEST_MAX_CONF_DELAY);
+    printf("%-22s %6s %7s %9s %11s %11s\n", "", "orders", "periods", "per order", "max RMS err", "THD err/tol");
+
+    for (idx = 0U; idx < (sizeof(testBatches) / sizeof(testBatches[0])); idx++)
+    {
+        if (_testBatch(&testBatches[idx]) == false)
+        {
+            pass = false;
+        }
+    }
+
+    if (_testErrors() == false)
+    {
+        pass = false;
+    }
+
+    printf("%s\n", (pass == true) ? "PASS" : "FAIL");
+    return (pass == true) ? 0 : 1;
+}
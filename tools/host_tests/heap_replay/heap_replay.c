@@ -0,0 +1,742 @@
+/*******************************************************************************
+  TCP/IP heap trace log replay
+
+  File Name:
+    heap_replay.c
+
+  Summary:
+    Replays a TCP/IP heap trace log on a host.
+
+  Description:
+    The log is the output of the HPL console command: lines of hexadecimal
+    TCPIP_HEAP_TRACE_RECORD records, as stored in the target memory.
+    Records are replayed in order against the first fit heap of the stack
+    (tcpip_heap_internal.c, built for the host) with the requested size, so
+    a heap size can be checked before changing TCPIP_STACK_DRAM_SIZE.
+
+    The first fit heap works in units of its block header: 8 bytes on the
+    target, 16 bytes on a 64 bit host. Record sizes are converted to the same
+    number of units on the host, so the replay takes the same allocation
+    decisions as the target. Sizes are printed in target bytes.
+
+    Only logs recorded with the first fit heap are replayed exactly: with
+    the slab heap the size of a class block is logged instead.
+
+    With -s the log is replayed into a slab heap with the given classes
+    instead, to size TCPIP_STACK_HEAP_SLAB_xxx_SIZE/BLOCKS from a trace.
+    Class block sizes are scaled to the host units as the first fit area
+    is. For each class the blocks used at most and the exhausted
+    allocations of the replay are printed, with the peak number of blocks
+    of the class simultaneously allocated on the target: the blocks the
+    class needs for that traffic.
+
+    The self test also checks that the slab heap rejects the release of
+    pointers that are not allocated blocks of the heap.
+
+    Usage:
+      heap_replay [-s size:blocks[,size:blocks...]] <heap size> [log file]
+                                              replay a log (stdin by default)
+      heap_replay -t                          self test
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "tcpip/src/tcpip_private.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Heap unit of the target: size of the first fit block header */
+#define TARGET_HEAP_UNIT        8U
+
+#define MAX_RECORDS             65536U
+#define MAX_LINE_LENGTH         512U
+#define MAX_SLAB_ENTRIES        8U
+
+typedef struct
+{
+    unsigned int nAllocs;
+    unsigned int nFrees;
+    unsigned int nFailed;
+    unsigned int nRecovered;
+    unsigned int nUnmatched;
+    size_t watermark;
+    /* Blocks of each slab class allocated on the target: current and peak */
+    unsigned int classBlocks[MAX_SLAB_ENTRIES];
+    unsigned int classPeak[MAX_SLAB_ENTRIES];
+} REPLAY_RESULT;
+
+unsigned int heapAssertCount;
+
+static TCPIP_HEAP_TRACE_RECORD logRecords[MAX_RECORDS];
+static unsigned int nLogRecords;
+
+/* Replay heap blocks, indexed by the block offset in the recorded heap */
+static void* replayBlocks[0x10000];
+
+/* Slab class + 1 of the recorded blocks, 0 for the first fit ones */
+static uint8_t replayClasses[0x10000];
+
+/* Slab classes in host units; no classes: first fit heap */
+static TCPIP_STACK_HEAP_SLAB_ENTRY slabEntries[MAX_SLAB_ENTRIES];
+static unsigned int nSlabEntries;
+
+static size_t hostUnit;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static TCPIP_STACK_HEAP_HANDLE _createHeap(size_t heapSize)
+{
+    TCPIP_STACK_HEAP_INTERNAL_CONFIG heapConfig;
+
+    memset(&heapConfig, 0, sizeof(heapConfig));
+    heapConfig.heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP;
+    heapConfig.heapFlags = TCPIP_STACK_HEAP_FLAG_NO_WARN_MESSAGE;
+    heapConfig.malloc_fnc = malloc;
+    heapConfig.free_fnc = free;
+    heapConfig.heapSize = heapSize;
+
+    return TCPIP_HEAP_Create((const TCPIP_STACK_HEAP_CONFIG*)&heapConfig, NULL);
+}
+
+static TCPIP_STACK_HEAP_HANDLE _createSlabHeap(size_t heapSize)
+{
+    TCPIP_STACK_HEAP_SLAB_CONFIG heapConfig;
+
+    memset(&heapConfig, 0, sizeof(heapConfig));
+    heapConfig.heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_SLAB;
+    heapConfig.heapFlags = TCPIP_STACK_HEAP_FLAG_NO_WARN_MESSAGE;
+    heapConfig.malloc_fnc = malloc;
+    heapConfig.free_fnc = free;
+    heapConfig.heapSize = heapSize;
+    heapConfig.nSlabEntries = (uint16_t)nSlabEntries;
+    heapConfig.pSlabEntries = slabEntries;
+
+    return TCPIP_HEAP_Create((const TCPIP_STACK_HEAP_CONFIG*)&heapConfig, NULL);
+}
+
+/* Parses the -s classes, given in target bytes */
+static bool _parseSlabEntries(const char* arg)
+{
+    unsigned long blockSize, nBlocks;
+    char* end;
+
+    nSlabEntries = 0;
+    while (*arg != 0)
+    {
+        blockSize = strtoul(arg, &end, 10);
+        if ((*end != ':') || (nSlabEntries == MAX_SLAB_ENTRIES))
+        {
+            return false;
+        }
+
+        nBlocks = strtoul(end + 1, &end, 10);
+        if ((blockSize == 0) || (nBlocks == 0) || ((*end != ',') && (*end != 0)) ||
+                (blockSize * hostUnit / TARGET_HEAP_UNIT > 0xFFFFU) || (nBlocks > 0xFFFFU))
+        {
+            return false;
+        }
+
+        slabEntries[nSlabEntries].blockSize = (uint16_t)(blockSize * hostUnit / TARGET_HEAP_UNIT);
+        slabEntries[nSlabEntries].nBlocks = (uint16_t)nBlocks;
+        nSlabEntries++;
+        arg = (*end == ',') ? end + 1 : end;
+    }
+
+    return nSlabEntries != 0;
+}
+
+/* Slab class of a host request, nSlabEntries if none fits */
+static unsigned int _slabClass(size_t nBytes)
+{
+    unsigned int idx;
+
+    for (idx = 0; idx < nSlabEntries; idx++)
+    {
+        if (nBytes <= slabEntries[idx].blockSize)
+        {
+            break;
+        }
+    }
+
+    return idx;
+}
+
+static size_t _getHostUnit(void)
+{
+    TCPIP_STACK_HEAP_HANDLE heapH;
+    void* ptr;
+    size_t unit;
+
+    /* A 1 byte block takes the header and one unit */
+    heapH = _createHeap(4096);
+    ptr = TCPIP_HEAP_MallocDebug(heapH, 1, 0, 0);
+    unit = (*((TCPIP_HEAP_OBJECT*)heapH)->TCPIP_HEAP_AllocSize)(heapH, ptr) / 2;
+    TCPIP_HEAP_FreeDebug(heapH, ptr, 0);
+    TCPIP_HEAP_Delete(heapH);
+
+    return unit;
+}
+
+static int _hexValue(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+
+    c = (char)toupper((unsigned char)c);
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/* Reads the HPL output. Lines that are not records are skipped */
+static unsigned int _readLog(FILE* file, TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int maxRecords)
+{
+    char line[MAX_LINE_LENGTH];
+    uint8_t data[MAX_LINE_LENGTH / 2];
+    unsigned int nRecords = 0;
+    size_t len, idx;
+    int hi, lo;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        len = strcspn(line, "\r\n");
+        if ((len == 0) || ((len % (2 * sizeof(TCPIP_HEAP_TRACE_RECORD))) != 0))
+        {
+            continue;
+        }
+
+        for (idx = 0; idx < len; idx += 2)
+        {
+            hi = _hexValue(line[idx]);
+            lo = _hexValue(line[idx + 1]);
+            if ((hi < 0) || (lo < 0))
+            {
+                break;
+            }
+
+            data[idx / 2] = (uint8_t)((hi << 4) | lo);
+        }
+
+        if (idx < len)
+        {
+            continue;
+        }
+
+        /* Records are little endian, as in the target memory */
+        for (idx = 0; (idx < len / 2) && (nRecords < maxRecords); idx += sizeof(TCPIP_HEAP_TRACE_RECORD))
+        {
+            pRecords[nRecords].op = data[idx];
+            pRecords[nRecords].moduleId = data[idx + 1];
+            pRecords[nRecords].lineNo = (uint16_t)(data[idx + 2] | (data[idx + 3] << 8));
+            pRecords[nRecords].nBytes = (uint16_t)(data[idx + 4] | (data[idx + 5] << 8));
+            pRecords[nRecords].blockOffset = (uint16_t)(data[idx + 6] | (data[idx + 7] << 8));
+            nRecords++;
+        }
+    }
+
+    return nRecords;
+}
+
+/* Host request taking the same number of units as the recorded one */
+static size_t _hostRequest(const TCPIP_HEAP_TRACE_RECORD* pRecord, size_t recordUnit)
+{
+    size_t units;
+
+    if (pRecord->op == TCPIP_HEAP_TRACE_OP_ALLOC)
+    {
+        /* Block size: header and data units */
+        units = pRecord->nBytes / recordUnit;
+        return units > 1 ? (units - 1) * hostUnit : 1;
+    }
+
+    /* Failed allocation: requested size */
+    units = (pRecord->nBytes + recordUnit - 1) / recordUnit;
+    return units > 0 ? units * hostUnit : 1;
+}
+
+static void _replay(const TCPIP_HEAP_TRACE_RECORD* pRecords, unsigned int nRecords, size_t recordUnit,
+        TCPIP_STACK_HEAP_HANDLE heapH, REPLAY_RESULT* pResult)
+{
+    const TCPIP_HEAP_TRACE_RECORD* pRec;
+    void* ptr;
+    unsigned int idx, slabClass;
+    size_t nBytes;
+
+    memset(pResult, 0, sizeof(*pResult));
+    memset(replayBlocks, 0, sizeof(replayBlocks));
+    memset(replayClasses, 0, sizeof(replayClasses));
+
+    for (idx = 0, pRec = pRecords; idx < nRecords; idx++, pRec++)
+    {
+        switch (pRec->op)
+        {
+            case TCPIP_HEAP_TRACE_OP_ALLOC:
+                nBytes = _hostRequest(pRec, recordUnit);
+                ptr = TCPIP_HEAP_MallocDebug(heapH, nBytes, pRec->moduleId, pRec->lineNo);
+                pResult->nAllocs++;
+                if (ptr == NULL)
+                {
+                    pResult->nFailed++;
+                }
+
+                replayBlocks[pRec->blockOffset] = ptr;
+
+                slabClass = _slabClass(nBytes);
+                if (slabClass < nSlabEntries)
+                {
+                    replayClasses[pRec->blockOffset] = (uint8_t)(slabClass + 1U);
+                    if (++pResult->classBlocks[slabClass] > pResult->classPeak[slabClass])
+                    {
+                        pResult->classPeak[slabClass] = pResult->classBlocks[slabClass];
+                    }
+                }
+                break;
+
+            case TCPIP_HEAP_TRACE_OP_FAIL:
+                /* Failed on the target: check whether it fits now */
+                nBytes = _hostRequest(pRec, recordUnit);
+                ptr = TCPIP_HEAP_MallocDebug(heapH, nBytes, pRec->moduleId, pRec->lineNo);
+                pResult->nAllocs++;
+                if (ptr == NULL)
+                {
+                    pResult->nFailed++;
+                }
+                else
+                {
+                    pResult->nRecovered++;
+                    TCPIP_HEAP_FreeDebug(heapH, ptr, pRec->moduleId);
+                }
+
+                /* The class needed one more block for a moment */
+                slabClass = _slabClass(nBytes);
+                if ((slabClass < nSlabEntries) && (pResult->classBlocks[slabClass] + 1U > pResult->classPeak[slabClass]))
+                {
+                    pResult->classPeak[slabClass] = pResult->classBlocks[slabClass] + 1U;
+                }
+                break;
+
+            case TCPIP_HEAP_TRACE_OP_FREE:
+                ptr = replayBlocks[pRec->blockOffset];
+                pResult->nFrees++;
+                if (replayClasses[pRec->blockOffset] != 0)
+                {
+                    pResult->classBlocks[replayClasses[pRec->blockOffset] - 1U]--;
+                    replayClasses[pRec->blockOffset] = 0;
+                }
+
+                if (ptr != NULL)
+                {
+                    TCPIP_HEAP_FreeDebug(heapH, ptr, pRec->moduleId);
+                    replayBlocks[pRec->blockOffset] = NULL;
+                }
+                else
+                {
+                    /* Allocated before the log started or failed in the replay */
+                    pResult->nUnmatched++;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    pResult->watermark = TCPIP_HEAP_HighWatermark(heapH);
+}
+
+/* As TCPIP_STACK_HEAP_FragmentationIndex */
+static unsigned int _fragmentationIndex(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    size_t freeSize, maxSize;
+
+    freeSize = TCPIP_HEAP_FreeSize(heapH);
+    maxSize = TCPIP_HEAP_MaxSize(heapH);
+    if ((freeSize == 0) || (maxSize >= freeSize))
+    {
+        return 0;
+    }
+
+    return 100 - (unsigned int)((maxSize * 100) / freeSize);
+}
+
+static void _printResult(TCPIP_STACK_HEAP_HANDLE heapH, size_t heapSize, const REPLAY_RESULT* pResult)
+{
+    TCPIP_HEAP_TRACE_ENTRY entry;
+    TCPIP_HEAP_SLAB_ENTRY_LIST slabList;
+    unsigned int idx;
+
+    printf("Heap %zu bytes: %u allocs (%u failed, %u failed on target now fit), %u frees (%u unmatched)\n",
+            heapSize, pResult->nAllocs, pResult->nFailed, pResult->nRecovered, pResult->nFrees, pResult->nUnmatched);
+    printf("Watermark %zu bytes, fragmentation %u %%\n",
+            pResult->watermark * TARGET_HEAP_UNIT / hostUnit, _fragmentationIndex(heapH));
+
+    for (idx = 0; idx < nSlabEntries; idx++)
+    {
+        if (TCPIP_HEAP_SLAB_EntryList(heapH, (int)idx, &slabList))
+        {
+            printf("Slab %4d bytes: %3d blocks, %3d used at most, %4d exhausted, %3u needed by the trace\n",
+                    (int)(slabList.blockSize * TARGET_HEAP_UNIT / hostUnit), slabList.nBlocks, slabList.highWatermark,
+                    slabList.failCount, pResult->classPeak[idx]);
+        }
+    }
+
+    printf("Module  Allocs  Frees  Current   Peak  Failed (bytes, rounded to heap units)\n");
+
+    for (idx = 0; idx < TCPIP_STACK_DRAM_TRACE_SLOTS; idx++)
+    {
+        if (TCPIP_HEAP_TraceGetEntry(heapH, idx, &entry) && (entry.nAllocs != 0))
+        {
+            printf("%6d  %6d  %5d  %7d  %5d  %6d\n", entry.moduleId, entry.nAllocs, entry.nFrees,
+                    (int)(entry.currAllocated * TARGET_HEAP_UNIT / hostUnit),
+                    (int)(entry.peakAllocated * TARGET_HEAP_UNIT / hostUnit),
+                    (int)(entry.totFailed * TARGET_HEAP_UNIT / hostUnit));
+        }
+    }
+}
+
+/* Records a random heap activity, dumps it as the HPL command does and
+   replays it into a heap of the same size: the replay must match */
+static int _selfTest(void)
+{
+    TCPIP_STACK_HEAP_HANDLE heapH, replayH;
+    TCPIP_HEAP_TRACE_ENTRY entry, replayEntry;
+    TCPIP_HEAP_TRACE_RECORD records[4];
+    REPLAY_RESULT result;
+    void* blocks[64];
+    int modules[64];
+    unsigned int nRecords, nRead, idx, nFailed, slot;
+    uint32_t lost;
+    FILE* file;
+    uint8_t* pData;
+    size_t heapSize = 14336;
+    int errors = 0;
+
+    memset(blocks, 0, sizeof(blocks));
+    srand(1);
+    heapH = _createHeap(heapSize);
+
+    nFailed = 0;
+    for (idx = 0; idx < 2000; idx++)
+    {
+        slot = (unsigned int)rand() % 64;
+        if (blocks[slot] != NULL)
+        {
+            TCPIP_HEAP_FreeDebug(heapH, blocks[slot], modules[slot]);
+            blocks[slot] = NULL;
+        }
+        else
+        {
+            modules[slot] = 1 + rand() % 6;
+            blocks[slot] = TCPIP_HEAP_MallocDebug(heapH, 20 + (size_t)(rand() % 1400), modules[slot], 100 + (int)slot);
+            if (blocks[slot] == NULL)
+            {
+                nFailed++;
+            }
+        }
+    }
+
+    file = tmpfile();
+    nRecords = 0;
+    while ((nRead = TCPIP_HEAP_TraceLogRead(heapH, records, 4, &lost)) != 0)
+    {
+        pData = (uint8_t*)records;
+        for (idx = 0; idx < nRead * sizeof(*records); idx++)
+        {
+            fprintf(file, "%02X", pData[idx]);
+        }
+        fprintf(file, "\r\n");
+        nRecords += nRead;
+    }
+    fprintf(file, "Heap trace log: %u records, %lu lost\r\n", nRecords, (unsigned long)lost);
+    rewind(file);
+
+    nRead = _readLog(file, logRecords, MAX_RECORDS);
+    nLogRecords = nRead;
+    fclose(file);
+    if ((nRead != nRecords) || (lost != 0))
+    {
+        printf("FAIL: %u records read, %u written, %lu lost\n", nRead, nRecords, (unsigned long)lost);
+        return 1;
+    }
+
+    /* Recorded on the host: same unit size */
+    replayH = _createHeap(heapSize);
+    _replay(logRecords, nRead, hostUnit, replayH, &result);
+
+    if ((result.nFailed != nFailed) || (result.nRecovered != 0) || (result.nUnmatched != 0))
+    {
+        printf("FAIL: %u failed in the replay, %u recorded\n", result.nFailed, nFailed);
+        errors++;
+    }
+
+    if (result.watermark != TCPIP_HEAP_HighWatermark(heapH))
+    {
+        printf("FAIL: watermark %zu, recorded %zu\n", result.watermark, TCPIP_HEAP_HighWatermark(heapH));
+        errors++;
+    }
+
+    for (idx = 0; idx < TCPIP_STACK_DRAM_TRACE_SLOTS; idx++)
+    {
+        if (TCPIP_HEAP_TraceGetEntry(heapH, idx, &entry) && (entry.nAllocs != 0))
+        {
+            /* Failed sizes are rounded to heap units in the replay */
+            if (!TCPIP_HEAP_TraceGetEntry(replayH, idx, &replayEntry) ||
+                    (replayEntry.moduleId != entry.moduleId) ||
+                    (replayEntry.nAllocs != entry.nAllocs) ||
+                    (replayEntry.nFrees != entry.nFrees) ||
+                    (replayEntry.peakAllocated != entry.peakAllocated) ||
+                    (replayEntry.currAllocated != entry.currAllocated))
+            {
+                printf("FAIL: module %d does not match: peak %d/%d, current %d/%d\n", entry.moduleId,
+                        replayEntry.peakAllocated, entry.peakAllocated, replayEntry.currAllocated, entry.currAllocated);
+                errors++;
+            }
+        }
+    }
+
+    printf("Self test: %u records, %u failed allocations: %s\n", nRecords, nFailed, errors ? "FAIL" : "PASS");
+
+    TCPIP_HEAP_Delete(replayH);
+    for (idx = 0; idx < 64; idx++)
+    {
+        if (blocks[idx] != NULL)
+        {
+            TCPIP_HEAP_FreeDebug(heapH, blocks[idx], modules[idx]);
+        }
+    }
+    TCPIP_HEAP_Delete(heapH);
+
+    return errors ? 1 : 0;
+}
+
+/* Releases pointers that are not allocated blocks of a slab heap: each one
+   must fail and assert, and leave the heap as it was. The log of the first
+   fit self test is then replayed into a slab heap large enough for all the
+   blocks: the blocks used by each class must be the ones counted in the
+   trace, with no failed release */
+static int _slabSelfTest(void)
+{
+    static const TCPIP_STACK_HEAP_SLAB_ENTRY targetEntries[] = { { 64, 16 }, { 256, 8 }, { 1408, 4 } };
+    TCPIP_STACK_HEAP_HANDLE heapH;
+    TCPIP_HEAP_SLAB_ENTRY_LIST slabList;
+    REPLAY_RESULT result;
+    uint8_t *pSmall, *pLarge, *pNext, *pOther;
+    size_t heapSize, freeSize;
+    unsigned int idx, nBadFrees;
+    int local = 0;
+    int errors = 0;
+
+    nSlabEntries = sizeof(targetEntries) / sizeof(*targetEntries);
+    for (idx = 0; idx < nSlabEntries; idx++)
+    {
+        slabEntries[idx].blockSize = (uint16_t)(targetEntries[idx].blockSize * hostUnit / TARGET_HEAP_UNIT);
+        slabEntries[idx].nBlocks = targetEntries[idx].nBlocks;
+    }
+
+    heapSize = 14336U / TARGET_HEAP_UNIT * hostUnit;
+    heapH = _createSlabHeap(heapSize);
+    if (heapH == NULL)
+    {
+        printf("FAIL: slab heap creation\n");
+        return 1;
+    }
+
+    freeSize = TCPIP_HEAP_FreeSize(heapH);
+    heapAssertCount = 0;
+    nBadFrees = 0;
+
+    pSmall = TCPIP_HEAP_MallocDebug(heapH, 20, 1, 1);
+    pLarge = TCPIP_HEAP_MallocDebug(heapH, 2 * slabEntries[2].blockSize, 1, 2);
+    if ((pSmall == NULL) || (pLarge == NULL))
+    {
+        printf("FAIL: slab heap allocation\n");
+        return 1;
+    }
+
+    /* Inside a block, outside the heap, released twice */
+    if (TCPIP_HEAP_FreeDebug(heapH, pSmall + TARGET_HEAP_UNIT, 1) != 0)
+    {
+        printf("FAIL: slab heap released a pointer inside a block\n");
+        errors++;
+    }
+    nBadFrees++;
+
+    if (TCPIP_HEAP_LastError(heapH) != TCPIP_STACK_HEAP_RES_PTR_ERR)
+    {
+        printf("FAIL: slab heap bad release not reported\n");
+        errors++;
+    }
+
+    if (TCPIP_HEAP_FreeDebug(heapH, &local, 1) != 0)
+    {
+        printf("FAIL: slab heap released a pointer outside the heap\n");
+        errors++;
+    }
+    nBadFrees++;
+
+    if (TCPIP_HEAP_FreeDebug(heapH, pSmall, 1) != slabEntries[0].blockSize)
+    {
+        printf("FAIL: slab heap block not released\n");
+        errors++;
+    }
+
+    if (TCPIP_HEAP_FreeDebug(heapH, pSmall, 1) != 0)
+    {
+        printf("FAIL: slab heap released a block twice\n");
+        errors++;
+    }
+    nBadFrees++;
+
+    /* The block must be in the free list once only */
+    pNext = TCPIP_HEAP_MallocDebug(heapH, 20, 1, 3);
+    pOther = TCPIP_HEAP_MallocDebug(heapH, 20, 1, 4);
+    if ((pNext == NULL) || (pNext == pOther))
+    {
+        printf("FAIL: slab heap block allocated twice\n");
+        errors++;
+    }
+
+    TCPIP_HEAP_FreeDebug(heapH, pNext, 1);
+    TCPIP_HEAP_FreeDebug(heapH, pOther, 1);
+    TCPIP_HEAP_FreeDebug(heapH, pLarge, 1);
+
+    if ((TCPIP_HEAP_FreeSize(heapH) != freeSize) || (heapAssertCount != nBadFrees))
+    {
+        printf("FAIL: slab heap free size %zu, created %zu, %u asserts for %u bad releases\n",
+                TCPIP_HEAP_FreeSize(heapH), freeSize, heapAssertCount, nBadFrees);
+        errors++;
+    }
+
+    TCPIP_HEAP_Delete(heapH);
+
+    /* Replay of the first fit log, classes never exhausted */
+    for (idx = 0; idx < nSlabEntries; idx++)
+    {
+        slabEntries[idx].nBlocks = 64;
+    }
+
+    heapH = _createSlabHeap(1024U * 1024U);
+    heapAssertCount = 0;
+    _replay(logRecords, nLogRecords, hostUnit, heapH, &result);
+
+    for (idx = 0; idx < nSlabEntries; idx++)
+    {
+        if (!TCPIP_HEAP_SLAB_EntryList(heapH, (int)idx, &slabList) ||
+                ((unsigned int)slabList.highWatermark != result.classPeak[idx]) || (slabList.failCount != 0))
+        {
+            printf("FAIL: slab class %u: %d blocks used, %u in the trace\n", idx, slabList.highWatermark,
+                    result.classPeak[idx]);
+            errors++;
+        }
+    }
+
+    if ((result.nFailed != 0) || (result.nUnmatched != 0) || (heapAssertCount != 0))
+    {
+        printf("FAIL: slab replay: %u failed, %u unmatched, %u asserts\n", result.nFailed, result.nUnmatched,
+                heapAssertCount);
+        errors++;
+    }
+
+    printf("Slab self test: %u bad releases rejected, classes %u/%u/%u blocks in the trace: %s\n", nBadFrees,
+            result.classPeak[0], result.classPeak[1], result.classPeak[2], errors ? "FAIL" : "PASS");
+
+    nSlabEntries = 0;
+    return errors ? 1 : 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    TCPIP_STACK_HEAP_HANDLE heapH;
+    REPLAY_RESULT result;
+    FILE* file = stdin;
+    unsigned int nRecords;
+    size_t heapSize;
+    int errors;
+
+    hostUnit = _getHostUnit();
+
+    if ((argc == 2) && (strcmp(argv[1], "-t") == 0))
+    {
+        errors = _selfTest();
+        errors += _slabSelfTest();
+        return errors ? 1 : 0;
+    }
+
+    if ((argc >= 3) && (strcmp(argv[1], "-s") == 0))
+    {
+        if (!_parseSlabEntries(argv[2]))
+        {
+            fprintf(stderr, "invalid slab classes: %s\n", argv[2]);
+            return 2;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: %s [-s size:blocks[,size:blocks...]] <heap size> [log file]\n       %s -t\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+
+    heapSize = (size_t)strtoul(argv[1], NULL, 10);
+    if (argc == 3)
+    {
+        file = fopen(argv[2], "r");
+        if (file == NULL)
+        {
+            perror(argv[2]);
+            return 2;
+        }
+    }
+
+    nRecords = _readLog(file, logRecords, MAX_RECORDS);
+    if (file != stdin)
+    {
+        fclose(file);
+    }
+
+    /* Same number of units as the target heap */
+    if (nSlabEntries != 0)
+    {
+        heapH = _createSlabHeap(heapSize / TARGET_HEAP_UNIT * hostUnit);
+    }
+    else
+    {
+        heapH = _createHeap(heapSize / TARGET_HEAP_UNIT * hostUnit);
+    }
+
+    if (heapH == NULL)
+    {
+        fprintf(stderr, "heap creation failed\n");
+        return 2;
+    }
+
+    printf("%u records\n", nRecords);
+    _replay(logRecords, nRecords, TARGET_HEAP_UNIT, heapH, &result);
+    _printResult(heapH, heapSize, &result);
+
+    return result.nFailed != 0 ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************
+  Host stub of tcpip_private.h for the heap replay tool
+
+  Summary:
+    Minimal definitions needed to build tcpip_heap_alloc.c and
+    tcpip_heap_internal.c on a host, with the heap debug trace enabled.
+*******************************************************************************/
+
+#ifndef _TCPIP_PRIVATE_H_
+#define _TCPIP_PRIVATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define CACHE_LINE_SIZE                     4u
+
+/* OSAL: single threaded host */
+typedef int OSAL_SEM_HANDLE_TYPE;
+typedef int OSAL_CRITSECT_DATA_TYPE;
+#define OSAL_SEM_TYPE_BINARY                0
+#define OSAL_RESULT_TRUE                    1
+#define OSAL_WAIT_FOREVER                   0
+#define OSAL_CRIT_TYPE_LOW                  0
+#define OSAL_SEM_Create(a, b, c, d)         OSAL_RESULT_TRUE
+#define OSAL_SEM_Delete(a)
+#define OSAL_SEM_Pend(a, b)                 0
+#define OSAL_SEM_Post(a)                    0
+#define OSAL_CRIT_Enter(t)                  0
+#define OSAL_CRIT_Leave(t, s)               ((void)(s))
+
+/* Heap configuration: first fit and slab heaps with the debug trace and log */
+#define TCPIP_STACK_USE_INTERNAL_HEAP
+#define TCPIP_STACK_USE_INTERNAL_HEAP_SLAB
+#define TCPIP_STACK_DRAM_DEBUG_ENABLE
+#define TCPIP_STACK_DRAM_TRACE_ENABLE
+#define TCPIP_STACK_DRAM_TRACE_SLOTS        32
+#define TCPIP_STACK_DRAM_TRACE_LOG_SIZE     4096
+#define TCPIP_STACK_SUPPORTED_HEAPS         2
+
+#define TCPIP_THIS_MODULE_ID                0
+
+/* Module ids used by the heap trace; values do not matter on the host */
+#define TCPIP_MODULE_IPV6                   5
+#define TCPIP_MODULE_NDP                    11
+
+#define SYS_ERROR_PRINT(level, fmt, ...)
+/* Failed asserts are counted by the replay tool */
+extern unsigned int heapAssertCount;
+#define _TCPIPStack_Assert(cond, file, func, line)  do { if(!(cond)) { heapAssertCount++; } } while(0)
+
+#include "tcpip/tcpip_heap.h"
+#include "tcpip/src/tcpip_heap_alloc.h"
+
+#endif  // _TCPIP_PRIVATE_H_
@@ -0,0 +1,988 @@
+/*******************************************************************************
+  IPv6 TX template test
+
+  File Name:
+    ipv6_template.c
+
+  Summary:
+    Host test of the IPv6 TX header templates of TCPIP_IPV6_Flush.
+
+  Description:
+    ipv6.c of the G3 coordinator UDP application is built for the host with
+    its own configuration, together with the stack helpers. NDP, ICMPv6, the
+    stack manager and the MAC are replaced by stubs: every destination is a
+    G3-PLC neighbor and every MAC packet handed to the stack is captured as
+    an IPv6 frame. The TCP/IP heap is replaced by the host heap, with a count
+    of the blocks in use to detect leaks.
+
+    The interface gets the link-local and the unique local addresses of the
+    coordinator. Datagrams of random protocol, length and contents are
+    flushed to random link-local and unique local destinations, more than
+    there are template slots, and the upper layer checksum of each captured
+    frame is verified against a pseudo header sum computed here, for the
+    frames that ran the source address selection and for the ones that took
+    the template. The test also checks that an immediate repeat always takes
+    the template, that the selected source matches the destination scope and
+    that a change of the unicast address list invalidates the templates.
+    The template pseudo header sum, completed with the length as
+    TCPIP_IPV6_Flush does, is compared with TCPIP_IPV6_PseudoHeaderChecksumGet
+    for random address, protocol and length tuples, and the cost of both per
+    packet is measured. It then measures the flushes per second with and
+    without the templates.
+
+    Usage:
+      ipv6_template [packets]       test and benchmark (100000 packets by default)
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tcpip/src/tcpip_private.h"
+#include "tcpip/src/ipv6_private.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define LOOP_MAX_FRAME          1400U
+#define LOOP_MAX_PAYLOAD        600U
+
+#define TEST_PAN_ID             0x781DU
+#define TEST_DESTINATIONS       64U
+#define TEST_PACKETS            4000U
+#define TEST_BENCH_DESTINATIONS 4U
+#define TEST_SUM_TUPLES         5000000UL
+#define TEST_SUM_SET            1024U
+
+/* Upper layer protocol of a test datagram */
+typedef struct
+{
+    uint8_t     type;
+    uint8_t     headerLen;
+    uint8_t     checksumOffset;
+} TEST_PROTOCOL;
+
+typedef struct
+{
+    TCPIP_MAC_PACKET        macPkt;
+    TCPIP_MAC_DATA_SEGMENT  macSeg;
+    uint8_t                 macBuffer[LOOP_MAX_FRAME];
+    uint8_t                 frame[LOOP_MAX_FRAME];
+    unsigned int            frameLen;
+    unsigned long           nFrames;
+    unsigned long           nSelections;
+    unsigned int            nMacPackets;
+    unsigned int            nHeapBlocks;
+    bool                    capture;
+} LOOP_DATA;
+
+static LOOP_DATA loopData;
+
+static TCPIP_NET_IF loopNet;
+
+static const TEST_PROTOCOL testProtocols[] =
+{
+    {IP_PROT_UDP, 8, 6},
+    {IP_PROT_TCP, 20, 16},
+    {IPV6_PROT_ICMPV6, 8, 2},
+};
+
+static IPV6_ADDR testLinkLocal;
+static IPV6_ADDR testUniqueLocal;
+
+static uint32_t testRandom = 0x2545F491UL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Host Heap
+// *****************************************************************************
+// *****************************************************************************
+
+static void* _loopMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    void* ptr = malloc(nBytes);
+
+    if (ptr != NULL)
+    {
+        loopData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static void* _loopCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* ptr = calloc(nElems, elemSize);
+
+    if (ptr != NULL)
+    {
+        loopData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static size_t _loopFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{
+    if (pBuff != NULL)
+    {
+        loopData.nHeapBlocks--;
+        free((void*)pBuff);
+    }
+
+    return 0;
+}
+
+static const TCPIP_HEAP_OBJECT loopHeap =
+{
+    .TCPIP_HEAP_Malloc = _loopMalloc,
+    .TCPIP_HEAP_Calloc = _loopCalloc,
+    .TCPIP_HEAP_Free = _loopFree,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: MAC Packet Capture
+// *****************************************************************************
+// *****************************************************************************
+
+TCPIP_MAC_PACKET* _TCPIP_PKT_PacketAlloc(uint16_t pktLen, uint16_t segLoadLen, TCPIP_MAC_PACKET_FLAGS flags)
+{
+    TCPIP_MAC_PACKET* pMacPkt = &loopData.macPkt;
+
+    if ((loopData.nMacPackets != 0U) ||
+            ((sizeof(TCPIP_MAC_ETHERNET_HEADER) + segLoadLen) > sizeof(loopData.macBuffer)))
+    {
+        return NULL;
+    }
+
+    memset(pMacPkt, 0, sizeof(*pMacPkt));
+    memset(&loopData.macSeg, 0, sizeof(loopData.macSeg));
+    loopData.macSeg.segLoad = loopData.macBuffer;
+    loopData.macSeg.segSize = sizeof(loopData.macBuffer);
+    pMacPkt->pDSeg = &loopData.macSeg;
+    pMacPkt->pMacLayer = loopData.macBuffer;
+    pMacPkt->pNetLayer = loopData.macBuffer + sizeof(TCPIP_MAC_ETHERNET_HEADER);
+    pMacPkt->pktFlags = flags;
+    loopData.nMacPackets++;
+    return pMacPkt;
+}
+
+void _TCPIP_PKT_PacketFree(TCPIP_MAC_PACKET* pPkt)
+{
+    loopData.nMacPackets--;
+}
+
+void _TCPIP_PKT_PacketAcknowledge(TCPIP_MAC_PACKET* pPkt, TCPIP_MAC_PKT_ACK_RES ackRes, TCPIP_STACK_MODULE moduleId)
+{
+}
+
+TCPIP_MAC_RES _TCPIPStackPacketTx(TCPIP_NET_IF* pNetIf, TCPIP_MAC_PACKET* ptrPacket)
+{
+    unsigned int frameLen = ptrPacket->pDSeg->segLen;
+
+    loopData.nFrames++;
+    if (loopData.capture)
+    {
+        memcpy(loopData.frame, ptrPacket->pMacLayer, frameLen);
+        loopData.frameLen = frameLen;
+    }
+
+    /* Sent: the MAC acknowledges the packet */
+    (*ptrPacket->ackFunc)(ptrPacket, ptrPacket->ackParam);
+    return TCPIP_MAC_RES_OK;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: NDP Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void TCPIP_NDP_LinkedListEntryInsert(TCPIP_NET_IF* pNetIf, void* entry, uint8_t type)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(pNetIf);
+
+    if (type == IPV6_HEAP_ADDR_UNICAST_ID)
+    {
+        TCPIP_Helper_DoubleListTailAdd(&pIpv6Config->listIpv6UnicastAddresses, entry);
+        pIpv6Config->addGen++;
+    }
+    else if (type == IPV6_HEAP_ADDR_MULTICAST_ID)
+    {
+        TCPIP_Helper_DoubleListTailAdd(&pIpv6Config->listIpv6MulticastAddresses, entry);
+    }
+}
+
+void* TCPIP_NDP_LinkedListEntryRemove(TCPIP_NET_IF* pNetIf, void* entry, uint8_t type)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(pNetIf);
+
+    if (type == IPV6_HEAP_ADDR_UNICAST_ID)
+    {
+        TCPIP_Helper_DoubleListNodeRemove(&pIpv6Config->listIpv6UnicastAddresses, entry);
+        pIpv6Config->addGen++;
+    }
+    else if (type == IPV6_HEAP_ADDR_MULTICAST_ID)
+    {
+        TCPIP_Helper_DoubleListNodeRemove(&pIpv6Config->listIpv6MulticastAddresses, entry);
+    }
+
+    _loopFree(0, entry);
+    return NULL;
+}
+
+IPV6_ADDR_STRUCT* TCPIP_NDP_UnicastAddressMove(TCPIP_NET_IF* pNetIf, IPV6_ADDR_STRUCT* entryLocation, IPV6_ADDR_STRUCT* previousEntryLocation)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(pNetIf);
+    IPV6_ADDR_STRUCT* returnVal = entryLocation->next;
+
+    /* Called only while the source address selection sorts the list */
+    loopData.nSelections++;
+
+    if (previousEntryLocation != entryLocation->prev)
+    {
+        TCPIP_Helper_DoubleListNodeRemove(&pIpv6Config->listIpv6UnicastAddresses, (DBL_LIST_NODE*)entryLocation);
+        if (previousEntryLocation == NULL)
+        {
+            TCPIP_Helper_DoubleListHeadAdd(&pIpv6Config->listIpv6UnicastAddresses, (DBL_LIST_NODE*)entryLocation);
+        }
+        else if (pIpv6Config->listIpv6UnicastAddresses.tail == (void*)previousEntryLocation)
+        {
+            TCPIP_Helper_DoubleListTailAdd(&pIpv6Config->listIpv6UnicastAddresses, (DBL_LIST_NODE*)entryLocation);
+        }
+        else
+        {
+            TCPIP_Helper_DoubleListMidAdd(&pIpv6Config->listIpv6UnicastAddresses, (DBL_LIST_NODE*)entryLocation, (DBL_LIST_NODE*)previousEntryLocation);
+        }
+    }
+
+    return returnVal;
+}
+
+bool TCPIP_NDP_IsG3PLC_Neighbor(const TCPIP_NET_IF* pNetIf, const IPV6_ADDR* address, TCPIP_MAC_ADDR* pMacAdd)
+{
+    /* PAN ID and short address, as for a G3-PLC link-local address */
+    memset(pMacAdd, 0, sizeof(*pMacAdd));
+    pMacAdd->v[2] = address->v[8];
+    pMacAdd->v[3] = address->v[9];
+    pMacAdd->v[4] = address->v[14];
+    pMacAdd->v[5] = address->v[15];
+    return true;
+}
+
+void* TCPIP_NDP_RemoteNodeFind(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* source, uint8_t type)
+{
+    return NULL;
+}
+
+char TCPIP_NDP_DupAddrDiscoveryDetect(TCPIP_NET_IF* pNetIf, IPV6_ADDR_STRUCT* localAddressPointer)
+{
+    return 0;
+}
+
+/* Not used on the TX path of a G3-PLC neighbor */
+IPV6_HEAP_NDP_NC_ENTRY* TCPIP_NDP_NborEntryCreate(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* remoteIPAddr, const TCPIP_MAC_ADDR* remoteMACAddr, uint8_t initialState, uint8_t routerFlag, IPV6_ADDR_STRUCT* preferredSource)
+{
+    return NULL;
+}
+
+IPV6_HEAP_NDP_NC_ENTRY* TCPIP_NDP_NborEntryDelete(TCPIP_NET_IF* pNetIf, IPV6_HEAP_NDP_NC_ENTRY* entry)
+{
+    return NULL;
+}
+
+IPV6_HEAP_NDP_DR_ENTRY* TCPIP_NDP_DefaultRouterEntryCreate(TCPIP_NET_IF* pNetIf, IPV6_HEAP_NDP_NC_ENTRY* neighbor, uint32_t invalidationTime)
+{
+    return NULL;
+}
+
+IPV6_HEAP_NDP_DR_ENTRY* TCPIP_NDP_DefaultRouterGet(TCPIP_NET_IF* pNetIf)
+{
+    return NULL;
+}
+
+IPV6_HEAP_NDP_DC_ENTRY* TCPIP_NDP_DestCacheEntryCreate(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* remoteIPAddress, uint32_t linkMTU, IPV6_HEAP_NDP_NC_ENTRY* neighbor)
+{
+    return NULL;
+}
+
+IPV6_HEAP_NDP_NC_ENTRY* TCPIP_NDP_NextHopGet(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* address)
+{
+    return NULL;
+}
+
+void TCPIP_NDP_AddressResolve(IPV6_HEAP_NDP_NC_ENTRY* entry)
+{
+}
+
+void TCPIP_NDP_ReachabilitySet(TCPIP_NET_IF* pNetIf, IPV6_HEAP_NDP_NC_ENTRY* neighborPointer, NEIGHBOR_UNREACHABILITY_DETECT_STATE newState)
+{
+}
+
+void TCPIP_NDP_RouterSolicitStart(TCPIP_NET_IF* pNetIf)
+{
+}
+
+void TCPIP_NDP_CacheIndexClear(TCPIP_NET_IF* pNetIf)
+{
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: ICMPv6, Stack Manager and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void TCPIP_ICMPV6_Process(TCPIP_NET_IF* pNetIf, TCPIP_MAC_PACKET* pRxPkt, IPV6_ADDR_STRUCT* localIPStruct, const IPV6_ADDR* localIP, const IPV6_ADDR* remoteIP, uint16_t dataLen, uint16_t headerLen, uint8_t hopLimit, uint8_t addrType)
+{
+}
+
+IPV6_PACKET* TCPIP_ICMPV6_HeaderErrorPut(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* localIP, const IPV6_ADDR* remoteIP, uint8_t code, uint8_t type, uint32_t additionalData)
+{
+    return NULL;
+}
+
+bool TCPIP_ICMPV6_Flush(IPV6_PACKET* pkt)
+{
+    return false;
+}
+
+int TCPIP_STACK_NetIxGet(const TCPIP_NET_IF* pNetIf)
+{
+    return 0;
+}
+
+TCPIP_NET_HANDLE TCPIP_STACK_IndexToNet(int netIx)
+{
+    return (netIx == 0) ? &loopNet : NULL;
+}
+
+int TCPIP_STACK_NumberOfNetworksGet(void)
+{
+    return 1;
+}
+
+bool TCPIP_STACK_NetworkIsLinked(TCPIP_NET_IF* pNetIf)
+{
+    return true;
+}
+
+const IPV6_ADDR* TCPIP_STACK_NetStaticIPv6AddressGet(TCPIP_NET_IF* pNetIf, int* pPrefixLen)
+{
+    return NULL;
+}
+
+const IPV6_ADDR* TCPIP_STACK_NetDefaultIPv6GatewayGet(TCPIP_NET_IF* pNetIf)
+{
+    return NULL;
+}
+
+tcpipSignalHandle _TCPIPStackSignalHandlerRegister(TCPIP_STACK_MODULE modId, tcpipModuleSignalHandler signalHandler, int16_t asyncTmoMs)
+{
+    return (tcpipSignalHandle)&loopNet;
+}
+
+void _TCPIPStackSignalHandlerDeregister(tcpipSignalHandle handle)
+{
+}
+
+bool _TCPIPStackSignalHandlerSetParams(TCPIP_STACK_MODULE modId, tcpipSignalHandle handle, int16_t asyncTmoMs)
+{
+    return true;
+}
+
+TCPIP_MODULE_SIGNAL _TCPIPStackModuleSignalGet(TCPIP_STACK_MODULE modId, TCPIP_MODULE_SIGNAL clrMask)
+{
+    return TCPIP_MODULE_SIGNAL_NONE;
+}
+
+TCPIP_MAC_PACKET* _TCPIPStackModuleRxExtract(TCPIP_STACK_MODULE modId)
+{
+    return NULL;
+}
+
+bool _TCPIPStackModuleRxInsert(TCPIP_STACK_MODULE modId, TCPIP_MAC_PACKET* pRxPkt, bool signal)
+{
+    return false;
+}
+
+void _TCPIPStack_Assert(bool cond, const char* fileName, const char* funcName, int lineNo)
+{
+    if (!cond)
+    {
+        printf("FAIL: assert in %s, line %d\n", funcName, lineNo);
+        exit(1);
+    }
+}
+
+uint16_t TCPIP_PKT_PayloadLen(TCPIP_MAC_PACKET* pPkt)
+{
+    return 0;
+}
+
+TCPIP_MAC_DATA_SEGMENT* TCPIP_PKT_DataSegmentGet(TCPIP_MAC_PACKET* pPkt, const uint8_t* dataAddress, bool srchTransport)
+{
+    return NULL;
+}
+
+uint32_t SYS_TMR_TickCountGet(void)
+{
+    return 0;
+}
+
+uint32_t SYS_TMR_TickCounterFrequencyGet(void)
+{
+    return 1000;
+}
+
+bool SYS_INT_Disable(void)
+{
+    return true;
+}
+
+void SYS_INT_Restore(bool state)
+{
+}
+
+SYS_ERROR_LEVEL SYS_DEBUG_ErrorLevelGet(void)
+{
+    return SYS_ERROR_ERROR;
+}
+
+SYS_MODULE_INDEX SYS_DEBUG_ConsoleInstanceGet(void)
+{
+    return 0;
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t _random(void)
+{
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static void _setDestination(IPV6_ADDR* pAddress, unsigned int ix)
+{
+    /* Even destinations are link-local, odd ones unique local, as seen by
+     * the coordinator: PAN ID and short address of a G3 device */
+    memset(pAddress, 0, sizeof(*pAddress));
+    if ((ix & 1U) == 0U)
+    {
+        pAddress->v[0] = 0xFE;
+        pAddress->v[1] = 0x80;
+    }
+    else
+    {
+        pAddress->v[0] = 0xFD;
+        pAddress->v[5] = 0x02;
+        pAddress->v[6] = (uint8_t)(TEST_PAN_ID >> 8);
+        pAddress->v[7] = (uint8_t)TEST_PAN_ID;
+    }
+    pAddress->v[8] = (uint8_t)(TEST_PAN_ID >> 8);
+    pAddress->v[9] = (uint8_t)TEST_PAN_ID;
+    pAddress->v[11] = 0xFF;
+    pAddress->v[12] = 0xFE;
+    pAddress->v[14] = (uint8_t)((ix + 1U) >> 8);
+    pAddress->v[15] = (uint8_t)(ix + 1U);
+}
+
+/* One's complement sum of a buffer, in network order, as an independent
+ * reference for the checksum written by the stack */
+static uint32_t _refSum(uint32_t sum, const uint8_t* pData, unsigned int len)
+{
+    unsigned int ix;
+
+    for (ix = 0; (ix + 1U) < len; ix += 2U)
+    {
+        sum += ((uint32_t)pData[ix] << 8) | pData[ix + 1U];
+    }
+
+    if ((len & 1U) != 0U)
+    {
+        sum += (uint32_t)pData[len - 1U] << 8;
+    }
+
+    return sum;
+}
+
+static uint16_t _refFold(uint32_t sum)
+{
+    while ((sum >> 16) != 0U)
+    {
+        sum = (sum & 0xFFFFU) + (sum >> 16);
+    }
+
+    return (uint16_t)sum;
+}
+
+static int _flush(const IPV6_ADDR* pDest, const TEST_PROTOCOL* pProt, uint8_t* pPayload, uint16_t payloadLen)
+{
+    uint8_t header[20];
+    IPV6_PACKET* pkt;
+    int res;
+
+    pkt = TCPIP_IPV6_TxPacketAllocate(&loopNet, NULL, NULL);
+    if (pkt == NULL)
+    {
+        return -1;
+    }
+
+    memset(header, 0, sizeof(header));
+    header[0] = 0xF0;
+    header[1] = pProt->type;
+    header[2] = (uint8_t)payloadLen;
+    if ((TCPIP_IPV6_UpperLayerHeaderPut(pkt, header, pProt->headerLen, pProt->type, pProt->checksumOffset) == NULL) ||
+            ((payloadLen != 0U) && (TCPIP_IPV6_PayloadSet(pkt, pPayload, payloadLen) == 0U)))
+    {
+        TCPIP_IPV6_PacketFree(pkt);
+        return -1;
+    }
+
+    TCPIP_IPV6_HeaderPut(pkt, pProt->type);
+    TCPIP_IPV6_DestAddressSet(pkt, pDest);
+    res = TCPIP_IPV6_Flush(pkt);
+    TCPIP_IPV6_PacketFree(pkt);
+    return res;
+}
+
+/* Checks the captured frame of a flushed datagram; the IPv6 header is the
+ * IPV6_HEADER of the host build, with a wider V_T_F */
+static int _checkFrame(const IPV6_ADDR* pDest, const IPV6_ADDR* pSource, const TEST_PROTOCOL* pProt, uint16_t payloadLen)
+{
+    const uint8_t* pUpper = loopData.frame + sizeof(TCPIP_MAC_ETHERNET_HEADER) + sizeof(IPV6_HEADER);
+    uint16_t upperLen = (uint16_t)(pProt->headerLen + payloadLen);
+    IPV6_HEADER ipv6Header;
+    uint32_t sum;
+
+    memcpy(&ipv6Header, loopData.frame + sizeof(TCPIP_MAC_ETHERNET_HEADER), sizeof(ipv6Header));
+    if ((loopData.frameLen != (sizeof(TCPIP_MAC_ETHERNET_HEADER) + sizeof(IPV6_HEADER) + upperLen)) ||
+            ((ipv6Header.V_T_F & 0xF0U) != 0x60U) || (TCPIP_Helper_ntohs(ipv6Header.PayloadLength) != upperLen) ||
+            (ipv6Header.NextHeader != pProt->type))
+    {
+        printf("FAIL: frame header: length %u, protocol %u\n", loopData.frameLen, pProt->type);
+        return 1;
+    }
+
+    if ((memcmp(&ipv6Header.SourceAddress, pSource, sizeof(IPV6_ADDR)) != 0) ||
+            (memcmp(&ipv6Header.DestAddress, pDest, sizeof(IPV6_ADDR)) != 0))
+    {
+        printf("FAIL: frame addresses: destination %02X..%02X, source %02X..%02X\n",
+                pDest->v[0], pDest->v[15], ipv6Header.SourceAddress.v[0], ipv6Header.SourceAddress.v[15]);
+        return 1;
+    }
+
+    /* Pseudo header: source, destination, upper layer length and protocol */
+    sum = _refSum(0, ipv6Header.SourceAddress.v, sizeof(IPV6_ADDR));
+    sum = _refSum(sum, ipv6Header.DestAddress.v, sizeof(IPV6_ADDR));
+    sum += upperLen;
+    sum += pProt->type;
+    sum = _refSum(sum, pUpper, upperLen);
+    if (_refFold(sum) != 0xFFFFU)
+    {
+        printf("FAIL: checksum: protocol %u, length %u, sum %04X\n", pProt->type, upperLen, _refFold(sum));
+        return 1;
+    }
+
+    return 0;
+}
+
+static int _testChecksum(void)
+{
+    static uint8_t payload[LOOP_MAX_PAYLOAD];
+    IPV6_ADDR dests[TEST_DESTINATIONS];
+    unsigned long nMiss = 0, nHit = 0;
+    unsigned int ix, jx, pass;
+
+    for (ix = 0; ix < TEST_DESTINATIONS; ix++)
+    {
+        _setDestination(&dests[ix], ix);
+    }
+
+    for (ix = 0; ix < TEST_PACKETS; ix++)
+    {
+        unsigned int destIx = _random() % TEST_DESTINATIONS;
+        const TEST_PROTOCOL* pProt = &testProtocols[_random() % (sizeof(testProtocols) / sizeof(testProtocols[0]))];
+        uint16_t payloadLen = (uint16_t)(_random() % LOOP_MAX_PAYLOAD);
+        const IPV6_ADDR* pSource = ((destIx & 1U) == 0U) ? &testLinkLocal : &testUniqueLocal;
+
+        for (jx = 0; jx < payloadLen; jx++)
+        {
+            payload[jx] = (uint8_t)_random();
+        }
+
+        /* The same datagram twice: the second flush always takes the
+         * template stored by the first one, if it did not take one */
+        for (pass = 0; pass < 2U; pass++)
+        {
+            unsigned long nSelections = loopData.nSelections;
+
+            loopData.frameLen = 0;
+            if (_flush(&dests[destIx], pProt, payload, payloadLen) != 1)
+            {
+                printf("FAIL: flush %u\n", ix);
+                return 1;
+            }
+
+            if (_checkFrame(&dests[destIx], pSource, pProt, payloadLen) != 0)
+            {
+                printf("  packet %u, %s\n", ix, (nSelections != loopData.nSelections) ? "source selected" : "template");
+                return 1;
+            }
+
+            if (nSelections != loopData.nSelections)
+            {
+                nMiss++;
+                if (pass != 0U)
+                {
+                    printf("FAIL: packet %u repeated without the template\n", ix);
+                    return 1;
+                }
+            }
+            else
+            {
+                nHit++;
+            }
+        }
+    }
+
+    printf("checksum: %u datagrams to %u destinations, %lu source selections, %lu templates, %u slots\n",
+            2U * TEST_PACKETS, TEST_DESTINATIONS, nMiss, nHit, (unsigned int)TCPIP_IPV6_TX_TEMPLATE_ENTRIES);
+    return 0;
+}
+
+static int _testInvalidate(void)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(&loopNet);
+    IPV6_ADDR_STRUCT* pAddr;
+    IPV6_PACKET* pkt;
+    IPV6_ADDR dest, linkLocal2;
+    unsigned long nSelections;
+    uint8_t header[8] = {0};
+    uint8_t payload[8] = {0};
+
+    _setDestination(&dest, 0);
+    _flush(&dest, &testProtocols[0], payload, sizeof(payload));
+
+    /* Changed behind the address list: the template keeps the old source */
+    pAddr = TCPIP_IPV6_AddressFind(&loopNet, &testLinkLocal, IPV6_ADDR_TYPE_UNICAST);
+    linkLocal2 = testLinkLocal;
+    linkLocal2.v[15] ^= 0x01U;
+    memcpy(&pAddr->address, &linkLocal2, sizeof(IPV6_ADDR));
+    _flush(&dest, &testProtocols[0], payload, sizeof(payload));
+    memcpy(&pAddr->address, &testLinkLocal, sizeof(IPV6_ADDR));
+    if (_checkFrame(&dest, &testLinkLocal, &testProtocols[0], sizeof(payload)) != 0)
+    {
+        printf("FAIL: invalidate: template not used\n");
+        return 1;
+    }
+
+    /* Removing the selected source runs the selection again */
+    nSelections = loopData.nSelections;
+    TCPIP_IPV6_AddressUnicastRemove(&loopNet, &testLinkLocal);
+    TCPIP_IPV6_UnicastAddressAdd(&loopNet, &linkLocal2, 0, false);
+    _flush(&dest, &testProtocols[0], payload, sizeof(payload));
+    if ((_checkFrame(&dest, &linkLocal2, &testProtocols[0], sizeof(payload)) != 0) || (nSelections == loopData.nSelections))
+    {
+        printf("FAIL: invalidate: address list change\n");
+        return 1;
+    }
+
+    /* A source set by the caller is kept and has its own checksum */
+    pkt = TCPIP_IPV6_TxPacketAllocate(&loopNet, NULL, NULL);
+    TCPIP_IPV6_UpperLayerHeaderPut(pkt, header, sizeof(header), IP_PROT_UDP, 6);
+    TCPIP_IPV6_HeaderPut(pkt, IP_PROT_UDP);
+    TCPIP_IPV6_PayloadSet(pkt, payload, sizeof(payload));
+    TCPIP_IPV6_DestAddressSet(pkt, &dest);
+    TCPIP_IPV6_SourceAddressSet(pkt, &testUniqueLocal);
+    TCPIP_IPV6_Flush(pkt);
+    TCPIP_IPV6_PacketFree(pkt);
+    if (_checkFrame(&dest, &testUniqueLocal, &testProtocols[0], sizeof(payload)) != 0)
+    {
+        printf("FAIL: invalidate: specified source\n");
+        return 1;
+    }
+
+    /* and does not replace the template of the default selection */
+    nSelections = loopData.nSelections;
+    _flush(&dest, &testProtocols[0], payload, sizeof(payload));
+    if ((_checkFrame(&dest, &linkLocal2, &testProtocols[0], sizeof(payload)) != 0) ||
+            (nSelections != loopData.nSelections))
+    {
+        printf("FAIL: invalidate: template replaced by a specified source\n");
+        return 1;
+    }
+
+    /* A new address on the list also does */
+    nSelections = loopData.nSelections;
+    TCPIP_IPV6_UnicastAddressAdd(&loopNet, &testLinkLocal, 0, false);
+    _flush(&dest, &testProtocols[0], payload, sizeof(payload));
+    if (nSelections == loopData.nSelections)
+    {
+        printf("FAIL: invalidate: address added\n");
+        return 1;
+    }
+
+    TCPIP_IPV6_AddressUnicastRemove(&loopNet, &linkLocal2);
+    printf("invalidate: address list changes drop the templates, specified source kept (generation %u)\n",
+            pIpv6Config->addGen);
+    return 0;
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+/* Pseudo header sum of the fixed fields, as TCPIP_IPV6_TxTemplateStore
+ * computes it */
+static uint16_t _templateSum(const IPV6_ADDR* pSource, const IPV6_ADDR* pDest, uint8_t type)
+{
+    IPV6_PSEUDO_HEADER pseudoHeader;
+
+    pseudoHeader.zero1 = 0;
+    pseudoHeader.zero2 = 0;
+    pseudoHeader.PacketLength = 0;
+    pseudoHeader.NextHeader = type;
+    memcpy(&pseudoHeader.SourceAddress, pSource, sizeof(IPV6_ADDR));
+    memcpy(&pseudoHeader.DestAddress, pDest, sizeof(IPV6_ADDR));
+    return ~TCPIP_Helper_CalcIPChecksum((uint8_t*)&pseudoHeader, sizeof(pseudoHeader), 0);
+}
+
+static int _testPseudoSum(unsigned long nTuples)
+{
+    static IPV6_ADDR sources[TEST_SUM_SET], dests[TEST_SUM_SET];
+    static uint16_t tmplSums[TEST_SUM_SET], lengths[TEST_SUM_SET];
+    static uint8_t types[TEST_SUM_SET];
+    volatile uint16_t sink = 0;
+    IPV6_PACKET* pkt;
+    unsigned long ix, nMismatch = 0;
+    unsigned int jx, kx;
+    double start, tFull, tTmpl;
+
+    pkt = TCPIP_IPV6_TxPacketAllocate(&loopNet, NULL, NULL);
+    if (pkt == NULL)
+    {
+        printf("FAIL: pseudo header: packet allocation\n");
+        return 1;
+    }
+
+    /* Full pseudo header against template sum plus length */
+    for (ix = 0; ix < nTuples; ix++)
+    {
+        IPV6_ADDR source, dest;
+        uint16_t pktLen;
+
+        for (kx = 0; kx < sizeof(IPV6_ADDR); kx++)
+        {
+            source.v[kx] = (uint8_t)_random();
+            dest.v[kx] = (uint8_t)_random();
+        }
+
+        TCPIP_IPV6_SourceAddressSet(pkt, &source);
+        TCPIP_IPV6_DestAddressSet(pkt, &dest);
+        pkt->upperLayerHeaderType = testProtocols[_random() % (sizeof(testProtocols) / sizeof(testProtocols[0]))].type;
+        pkt->upperLayerHeaderLen = (uint16_t)(_random() % 64U);
+        pkt->payloadLen = (uint16_t)(_random() % 1280U);
+
+        pktLen = TCPIP_Helper_htons(pkt->upperLayerHeaderLen + pkt->payloadLen);
+        if (TCPIP_Helper_CalcIPChecksum((uint8_t*)&pktLen, sizeof(pktLen), _templateSum(&source, &dest, pkt->upperLayerHeaderType)) !=
+                TCPIP_IPV6_PseudoHeaderChecksumGet(pkt))
+        {
+            nMismatch++;
+        }
+
+        if (ix < TEST_SUM_SET)
+        {
+            sources[ix] = source;
+            dests[ix] = dest;
+            types[ix] = pkt->upperLayerHeaderType;
+            lengths[ix] = pkt->upperLayerHeaderLen + pkt->payloadLen;
+            tmplSums[ix] = _templateSum(&source, &dest, types[ix]);
+        }
+    }
+
+    /* Cost per packet of both, over a set of tuples */
+    start = _seconds();
+    for (ix = 0; ix < nTuples; ix++)
+    {
+        jx = (unsigned int)(ix % TEST_SUM_SET);
+        TCPIP_IPV6_SourceAddressSet(pkt, &sources[jx]);
+        TCPIP_IPV6_DestAddressSet(pkt, &dests[jx]);
+        pkt->upperLayerHeaderType = types[jx];
+        pkt->upperLayerHeaderLen = 0;
+        pkt->payloadLen = lengths[jx];
+        sink += TCPIP_IPV6_PseudoHeaderChecksumGet(pkt);
+    }
+    tFull = _seconds() - start;
+
+    start = _seconds();
+    for (ix = 0; ix < nTuples; ix++)
+    {
+        uint16_t pktLen;
+
+        jx = (unsigned int)(ix % TEST_SUM_SET);
+        TCPIP_IPV6_SourceAddressSet(pkt, &sources[jx]);
+        TCPIP_IPV6_DestAddressSet(pkt, &dests[jx]);
+        pktLen = TCPIP_Helper_htons(lengths[jx]);
+        sink += TCPIP_Helper_CalcIPChecksum((uint8_t*)&pktLen, sizeof(pktLen), tmplSums[jx]);
+    }
+    tTmpl = _seconds() - start;
+
+    TCPIP_IPV6_PacketFree(pkt);
+
+    if (nMismatch != 0U)
+    {
+        printf("FAIL: pseudo header: %lu of %lu template sums differ\n", nMismatch, nTuples);
+        return 1;
+    }
+
+    printf("pseudo header: %lu random tuples, template sum matches the full sum\n", nTuples);
+    printf("  full pseudo header: %6.1f ns/packet\n", (tFull * 1e9) / (double)nTuples);
+    printf("  template sum:       %6.1f ns/packet\n", (tTmpl * 1e9) / (double)nTuples);
+    return 0;
+}
+
+static int _benchmark(unsigned long nPackets)
+{
+    IPV6_INTERFACE_CONFIG* pIpv6Config = TCPIP_IPV6_InterfaceConfigGet(&loopNet);
+    uint8_t payload[32];
+    IPV6_ADDR dests[TEST_BENCH_DESTINATIONS];
+    unsigned long ix, nFrames, nSelect, nTmpl;
+    double start, tSelect, tTmpl;
+
+    memset(payload, 0x5A, sizeof(payload));
+    for (ix = 0; ix < TEST_BENCH_DESTINATIONS; ix++)
+    {
+        _setDestination(&dests[ix], (unsigned int)ix);
+    }
+    loopData.capture = false;
+
+    /* Every flush runs the source address selection */
+    nFrames = loopData.nFrames;
+    start = _seconds();
+    for (ix = 0; ix < nPackets; ix++)
+    {
+        pIpv6Config->addGen++;
+        _flush(&dests[ix % TEST_BENCH_DESTINATIONS], &testProtocols[0], payload, sizeof(payload));
+    }
+    tSelect = _seconds() - start;
+    nSelect = loopData.nFrames - nFrames;
+
+    nFrames = loopData.nFrames;
+    start = _seconds();
+    for (ix = 0; ix < nPackets; ix++)
+    {
+        _flush(&dests[ix % TEST_BENCH_DESTINATIONS], &testProtocols[0], payload, sizeof(payload));
+    }
+    tTmpl = _seconds() - start;
+    nTmpl = loopData.nFrames - nFrames;
+
+    loopData.capture = true;
+
+    if ((nSelect != nPackets) || (nTmpl != nPackets))
+    {
+        printf("FAIL: benchmark: %lu and %lu of %lu packets sent\n", nSelect, nTmpl, nPackets);
+        return 1;
+    }
+
+    printf("benchmark: %lu UDP datagrams of %u bytes to %u destinations, 2 local addresses\n",
+            nPackets, (unsigned int)sizeof(payload), TEST_BENCH_DESTINATIONS);
+    printf("  source selection, full pseudo header: %10.0f packets/s\n", (double)nPackets / tSelect);
+    printf("  TX template:                          %10.0f packets/s\n", (double)nPackets / tTmpl);
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    TCPIP_STACK_MODULE_CTRL stackCtrl;
+    TCPIP_IPV6_MODULE_CONFIG ipv6Config;
+    unsigned long nPackets = 100000UL;
+    unsigned int nInitBlocks;
+    int nErrors = 0;
+
+    if (argc > 1)
+    {
+        nPackets = strtoul(argv[1], NULL, 0);
+    }
+
+    memset(&loopNet, 0, sizeof(loopNet));
+    loopNet.Flags.bInterfaceEnabled = true;
+    loopNet.startFlags = TCPIP_NETWORK_CONFIG_IPV6_NO_DAD;
+    loopNet.netMACAddr.v[2] = (uint8_t)(TEST_PAN_ID >> 8);
+    loopNet.netMACAddr.v[3] = (uint8_t)TEST_PAN_ID;
+
+    memset(&stackCtrl, 0, sizeof(stackCtrl));
+    stackCtrl.memH = &loopHeap;
+    stackCtrl.nIfs = 1;
+    stackCtrl.pNetIf = &loopNet;
+    stackCtrl.stackAction = TCPIP_STACK_ACTION_INIT;
+
+    memset(&ipv6Config, 0, sizeof(ipv6Config));
+    ipv6Config.rxfragmentBufSize = TCPIP_IPV6_RX_FRAGMENTED_BUFFER_SIZE;
+    ipv6Config.fragmentPktRxTimeout = TCPIP_IPV6_FRAGMENT_PKT_TIMEOUT;
+
+    loopData.capture = true;
+    if (TCPIP_IPV6_Initialize(&stackCtrl, &ipv6Config) == false)
+    {
+        printf("FAIL: IPv6 initialization\n");
+        return 1;
+    }
+
+    /* Coordinator addresses, as set by the application */
+    _setDestination(&testLinkLocal, 0xFFFEU);
+    _setDestination(&testUniqueLocal, 0xFFFFU);
+    testLinkLocal.v[14] = testLinkLocal.v[15] = 0;
+    testUniqueLocal.v[14] = testUniqueLocal.v[15] = 0;
+    if ((TCPIP_IPV6_UnicastAddressAdd(&loopNet, &testLinkLocal, 0, false) == NULL) ||
+            (TCPIP_IPV6_UnicastAddressAdd(&loopNet, &testUniqueLocal, 64, false) == NULL))
+    {
+        printf("FAIL: address add\n");
+        return 1;
+    }
+    nInitBlocks = loopData.nHeapBlocks;
+
+    nErrors += _testChecksum();
+    nErrors += _testInvalidate();
+    nErrors += _testPseudoSum(TEST_SUM_TUPLES);
+    nErrors += _benchmark(nPackets);
+
+    if ((loopData.nHeapBlocks != nInitBlocks) || (loopData.nMacPackets != 0U))
+    {
+        printf("FAIL: %d heap blocks and %u MAC packets not released\n",
+                (int)(loopData.nHeapBlocks - nInitBlocks), loopData.nMacPackets);
+        nErrors++;
+    }
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
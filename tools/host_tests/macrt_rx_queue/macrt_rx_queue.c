@@ -0,0 +1,393 @@
+/*******************************************************************************
+  G3 MAC RT RX queue test
+
+  File Name:
+    macrt_rx_queue.c
+
+  Summary:
+    Host test of the G3 MAC RT driver RX queue against a mock of the PL460.
+
+  Description:
+    drv_g3_macrt_local_comm.c of the G3 coordinator (PIC32CX MTG, PL460 and
+    RF215) is built for the host with its own configuration. The PLC HAL is
+    replaced by a mock of the PL460 G3 MAC RT command interface: the status
+    reports the RX parameters and data indication events of one frame and its
+    length, and each frame carries its sequence number in the link quality of
+    its RX parameters and in a payload pattern of a length that depends on it.
+
+    Bursts of frames are injected through the external interrupt handler
+    while DRV_G3_MACRT_Task is not called, then the task is called once and
+    TEST_FRAMES_AFTER more frames are received with the task called after
+    each one. A reference model of the queue gives the frames that must be
+    reported and the counters: no frame may be lost while the burst fits in
+    the queue, and every frame beyond it must be counted as an overflow. The
+    frames must be reported in order, with their payload and length intact
+    and with their own RX parameters, or none if the PL460 did not send them.
+    An overflow must already be counted when the discarded frame is read out
+    of the PL460. Bursts are sent with the RX parameters and the data of each
+    frame in the same interrupt, in two interrupts and without parameters for
+    odd frames.
+
+    Built with TEST_RX_QUEUE_SIZE, the same runs are made with that queue
+    size.
+
+    Usage:
+      macrt_rx_queue
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "configuration.h"
+
+#ifdef TEST_RX_QUEUE_SIZE
+#undef DRV_G3_MACRT_RX_QUEUE_SIZE
+#define DRV_G3_MACRT_RX_QUEUE_SIZE          TEST_RX_QUEUE_SIZE
+#endif
+
+/* The interrupt handler clears the PIO status: use a host copy of the PIO */
+static pio_registers_t testPio;
+#undef PIO0_REGS
+#define PIO0_REGS                           (&testPio)
+
+/* TX requests wait for the PL460 with WFE: no such instruction on the host */
+#undef __WFE
+#define __WFE()                             do {} while (false)
+
+#include "driver/plc/g3MacRt/drv_g3_macrt_local_comm.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_FRAMES_AFTER           3U
+#define TEST_BURST_MAX              (DRV_G3_MACRT_RX_QUEUE_SIZE + 4U)
+#define TEST_FRAMES_MAX             (TEST_BURST_MAX * 2U + TEST_FRAMES_AFTER)
+
+typedef enum
+{
+    /* RX parameters and data of each frame in the same interrupt */
+    TEST_MODE_TOGETHER,
+    /* RX parameters in an interrupt and data in the next one */
+    TEST_MODE_SPLIT,
+    /* Odd frames without RX parameters */
+    TEST_MODE_NO_PARAMS_ODD,
+} TEST_MODE;
+
+typedef struct
+{
+    uint32_t received;
+    uint32_t badData;
+    uint32_t badParams;
+    uint32_t outOfOrder;
+    uint32_t expected;
+    uint32_t overflows;
+    uint32_t lateOverflows;
+    uint8_t maxLevel;
+} TEST_RESULT;
+
+static const char* const testModeNames[] =
+{
+    "together", "split", "no params"
+};
+
+static DRV_PLC_HAL_INTERFACE testHal;
+static DRV_G3_MACRT_OBJ testObj;
+
+/* PL460 mock: events of the frame being received */
+static bool testPendParams, testPendData;
+static uint8_t testSeq;
+
+/* Reference model of the queue */
+static uint8_t testExpected[TEST_FRAMES_MAX];
+static bool testExpectedParams[TEST_FRAMES_MAX];
+static uint32_t testExpectedNum, testModelLevel;
+
+static TEST_RESULT testResult;
+static int testParamsSeq;
+static uint32_t testRestarts;
+static int testFails;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: PLC HAL and Boot Mock
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t _frameLength(uint8_t seq)
+{
+    return (uint16_t) (20U + (((uint32_t) seq * 37U) % 200U));
+}
+
+void DRV_PLC_BOOT_Restart(DRV_PLC_BOOT_RESTART_MODE mode)
+{
+    (void) mode;
+    testRestarts++;
+}
+
+static void _halEnableExtInt(bool enable)
+{
+    (void) enable;
+}
+
+static void _halDelay(uint32_t us)
+{
+    (void) us;
+}
+
+static void _halSendWrRdCmd(void* pCmd, void* pInfo)
+{
+    DRV_PLC_HAL_CMD* halCmd = (DRV_PLC_HAL_CMD*) pCmd;
+    DRV_PLC_HAL_INFO* halInfo = (DRV_PLC_HAL_INFO*) pInfo;
+    uint16_t length = _frameLength(testSeq);
+    uint16_t idx;
+
+    halInfo->key = DRV_PLC_HAL_KEY_CORTEX;
+    halInfo->flags = 0U;
+    if (testPendParams == true)
+    {
+        halInfo->flags |= DRV_G3_MACRT_EV_RX_PAR_IND_FLAG_MASK;
+    }
+
+    if (testPendData == true)
+    {
+        halInfo->flags |= DRV_G3_MACRT_EV_DATA_IND_FLAG_MASK;
+    }
+
+    if (halCmd->memId == (uint16_t) STATUS_INFO_ID)
+    {
+        (void) memset(halCmd->pData, 0, halCmd->length);
+        halCmd->pData[4] = (uint8_t) length;
+        halCmd->pData[5] = (uint8_t) (length >> 8);
+    }
+    else if (halCmd->memId == (uint16_t) RX_PAR_IND_ID)
+    {
+        if (halCmd->length > 1U)
+        {
+            (void) memset(halCmd->pData, 0, halCmd->length);
+            ((MAC_RT_RX_PARAMETERS_OBJ*) halCmd->pData)->pduLinkQuality = testSeq;
+        }
+
+        testPendParams = false;
+    }
+    else if (halCmd->memId == (uint16_t) DATA_IND_ID)
+    {
+        if (halCmd->length > 1U)
+        {
+            for (idx = 0U; idx < halCmd->length; idx++)
+            {
+                halCmd->pData[idx] = (uint8_t) (testSeq + idx);
+            }
+        }
+        else if (testObj.rxStats.rxQueueOverflows != testResult.overflows)
+        {
+            /* Frame discarded before its overflow is counted */
+            testResult.lateOverflows++;
+        }
+        else
+        {
+            /* Overflow already counted */
+        }
+
+        testPendData = false;
+    }
+    else
+    {
+        /* No other events */
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application
+// *****************************************************************************
+// *****************************************************************************
+
+static void _rxParamsInd(MAC_RT_RX_PARAMETERS_OBJ* pParameters)
+{
+    testParamsSeq = pParameters->pduLinkQuality;
+}
+
+static void _dataInd(uint8_t* pData, uint16_t length)
+{
+    uint32_t pos = testResult.received;
+    uint8_t seq = pData[0];
+    uint16_t idx;
+
+    if ((pos >= testExpectedNum) || (seq != testExpected[pos]))
+    {
+        testResult.outOfOrder++;
+    }
+    else if (testParamsSeq != (testExpectedParams[pos] ? (int) seq : -1))
+    {
+        testResult.badParams++;
+    }
+    else
+    {
+        /* Order and parameters correct */
+    }
+
+    if (length != _frameLength(seq))
+    {
+        testResult.badData++;
+    }
+    else
+    {
+        for (idx = 0U; idx < length; idx++)
+        {
+            if (pData[idx] != (uint8_t) (seq + idx))
+            {
+                testResult.badData++;
+                break;
+            }
+        }
+    }
+
+    testParamsSeq = -1;
+    testResult.received++;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Test Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _interrupt(void)
+{
+    DRV_G3_MACRT_ExternalInterruptHandler((PIO_PIN) DRV_PLC_EXT_INT_PIN, 0U);
+}
+
+static void _frame(TEST_MODE mode)
+{
+    bool params = ((mode != TEST_MODE_NO_PARAMS_ODD) || ((testSeq & 1U) == 0U));
+
+    /* Reference model */
+    if (testModelLevel >= DRV_G3_MACRT_RX_QUEUE_SIZE)
+    {
+        testResult.overflows++;
+    }
+    else
+    {
+        testExpected[testExpectedNum] = testSeq;
+        testExpectedParams[testExpectedNum] = params;
+        testExpectedNum++;
+        testModelLevel++;
+        if (testModelLevel > testResult.maxLevel)
+        {
+            testResult.maxLevel = (uint8_t) testModelLevel;
+        }
+    }
+
+    if (mode == TEST_MODE_SPLIT)
+    {
+        testPendParams = true;
+        _interrupt();
+        testPendData = true;
+        _interrupt();
+    }
+    else
+    {
+        testPendParams = params;
+        testPendData = true;
+        _interrupt();
+    }
+
+    testSeq++;
+}
+
+static void _task(void)
+{
+    DRV_G3_MACRT_Task();
+    testModelLevel = 0U;
+}
+
+static void _runBurst(TEST_MODE mode, uint32_t burst)
+{
+    DRV_G3_MACRT_RX_STATS stats;
+    uint32_t idx;
+    bool ok;
+
+    (void) memset(&testResult, 0, sizeof(testResult));
+    testExpectedNum = 0U;
+    testModelLevel = 0U;
+    testSeq = 0U;
+    testParamsSeq = -1;
+    testRestarts = 0U;
+    DRV_G3_MACRT_Init(&testObj);
+
+    /* Task late for the whole burst */
+    for (idx = 0U; idx < burst; idx++)
+    {
+        _frame(mode);
+    }
+
+    _task();
+
+    /* Queue usable again */
+    for (idx = 0U; idx < TEST_FRAMES_AFTER; idx++)
+    {
+        _frame(mode);
+        _task();
+    }
+
+    DRV_G3_MACRT_GetRxStats(0U, &stats);
+    testResult.expected = testExpectedNum;
+
+    ok = ((testResult.received == testExpectedNum) && (testResult.badData == 0U) &&
+          (testResult.badParams == 0U) && (testResult.outOfOrder == 0U) && (testRestarts == 0U) &&
+          (stats.rxQueueOverflows == testResult.overflows) && (testResult.lateOverflows == 0U) &&
+          (stats.rxQueueMaxLevel == testResult.maxLevel));
+
+    printf("%-9s burst %2u: received %2u/%2u, overflows %2u, late %2u, max level %u, "
+           "bad data %u, bad params %u, out of order %u %s\n", testModeNames[mode], (unsigned) burst,
+           (unsigned) testResult.received, (unsigned) testResult.expected,
+           (unsigned) stats.rxQueueOverflows, (unsigned) testResult.lateOverflows, (unsigned) stats.rxQueueMaxLevel,
+           (unsigned) testResult.badData, (unsigned) testResult.badParams, (unsigned) testResult.outOfOrder,
+           (ok == true) ? "OK" : "FAIL");
+
+    if (ok == false)
+    {
+        testFails++;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    static DRV_PLC_PLIB_INTERFACE plcPlib;
+    uint32_t burst;
+
+    plcPlib.extIntPin = DRV_PLC_EXT_INT_PIN;
+    testHal.plcPlib = &plcPlib;
+    testHal.enableExtInt = _halEnableExtInt;
+    testHal.delay = _halDelay;
+    testHal.sendWrRdCmd = _halSendWrRdCmd;
+
+    testObj.plcHal = &testHal;
+    testObj.dataIndCallback = _dataInd;
+    testObj.rxParamsIndCallback = _rxParamsInd;
+
+    printf("RX queue of %u frames\n", (unsigned) DRV_G3_MACRT_RX_QUEUE_SIZE);
+
+    for (burst = 1U; burst <= TEST_BURST_MAX; burst++)
+    {
+        _runBurst(TEST_MODE_TOGETHER, burst);
+    }
+
+    for (burst = DRV_G3_MACRT_RX_QUEUE_SIZE - 1U; burst <= (DRV_G3_MACRT_RX_QUEUE_SIZE + 1U); burst++)
+    {
+        _runBurst(TEST_MODE_SPLIT, burst);
+        _runBurst(TEST_MODE_NO_PARAMS_ODD, burst);
+    }
+
+    printf("%s\n", (testFails == 0) ? "PASS" : "FAIL");
+    return (testFails == 0) ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+/*******************************************************************************
+  Host stub of the PORTS System Service for the MAC RT RX queue test
+
+  Summary:
+    Pins used by the PLC driver configuration.
+
+  Description:
+    The generated sys_ports.h defines the ports from the PIO register
+    addresses, which are not integer constants on the host. Only the pin
+    numbers of the configuration are needed to build the G3 MAC RT driver.
+*******************************************************************************/
+
+#ifndef SYS_PORTS_H
+#define SYS_PORTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "peripheral/pio/plib_pio.h"
+
+typedef enum
+{
+    SYS_PORT_PIN_PA1 = 1,
+    SYS_PORT_PIN_PA2 = 2,
+    SYS_PORT_PIN_PB15 = 47,
+    SYS_PORT_PIN_PD15 = 111,
+    SYS_PORT_PIN_PD19 = 115,
+    SYS_PORT_PIN_NONE = -1
+} SYS_PORT_PIN;
+
+#endif // SYS_PORTS_H
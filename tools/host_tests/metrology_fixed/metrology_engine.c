@@ -0,0 +1,47 @@
+/*******************************************************************************
+  Metrology computation engine for the fixed point test
+
+  File Name:
+    metrology_engine.c
+
+  Summary:
+    One build of drv_metrology.c with the engine selected by the Makefile.
+
+  Description:
+    METROLOGY_FIXED_POINT_CALC replaces DRV_METROLOGY_FIXED_POINT_CALC of the
+    configuration and METROLOGY_ENGINE_NAME names the exported engine object.
+    drv_metrology_host.c is the copy of drv_metrology.c made by the Makefile.
+*******************************************************************************/
+
+#include "metrology_engine.h"
+#include "device.h"
+
+#undef DRV_METROLOGY_FIXED_POINT_CALC
+#define DRV_METROLOGY_FIXED_POINT_CALC      METROLOGY_FIXED_POINT_CALC
+
+/* The Cortex-M barrier is an instruction the host assembler does not know */
+#define __DMB()                             __sync_synchronize()
+
+#include "drv_metrology_host.c"
+
+static void _setRegisters(MET_REGISTERS *metRegisters, DRV_METROLOGY_REGS_ACCUMULATORS *accData)
+{
+    gDrvMetObj.metRegisters = metRegisters;
+    gDrvMetObj.pMetAccData = accData;
+}
+
+static uint32_t _getPQEnergy(bool reactive)
+{
+    return lDRV_Metrology_GetPQEnergy((reactive == true) ? QENERGY : PENERGY);
+}
+
+const METROLOGY_ENGINE METROLOGY_ENGINE_NAME =
+{
+    _setRegisters,
+    lDRV_Metrology_GetVIRMS,
+    lDRV_Metrology_GetInxRMS,
+    lDRV_Metrology_GetPQRMS,
+    lDRV_Metrology_GetSRMS,
+    lDRV_Metrology_GetAngleRMS,
+    _getPQEnergy
+};
@@ -0,0 +1,39 @@
+/*******************************************************************************
+  Metrology computation engine interface for the fixed point test
+
+  File Name:
+    metrology_engine.h
+
+  Summary:
+    Computation functions of one build of drv_metrology.c.
+
+  Description:
+    metrology_engine.c is built twice, once with the double precision engine
+    and once with the fixed point one. Each build exports only its engine
+    object, so both copies of the driver can be linked in the same test.
+*******************************************************************************/
+
+#ifndef METROLOGY_ENGINE_H
+#define METROLOGY_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "driver/metrology/drv_metrology.h"
+
+typedef struct
+{
+    /* Set the registers read by the engine: N, K_x gains and accumulators */
+    void (*setRegisters)(MET_REGISTERS *metRegisters, DRV_METROLOGY_REGS_ACCUMULATORS *accData);
+    uint32_t (*getVIRMS)(uint64_t val, uint32_t k_x);
+    uint32_t (*getInxRMS)(uint64_t val);
+    uint32_t (*getPQRMS)(int64_t val, uint32_t k_ix, uint32_t k_vx);
+    uint32_t (*getSRMS)(int64_t pv, int64_t qv, uint32_t k_ix, uint32_t k_vx);
+    uint32_t (*getAngleRMS)(int64_t p, int64_t q);
+    uint32_t (*getPQEnergy)(bool reactive);
+} METROLOGY_ENGINE;
+
+extern const METROLOGY_ENGINE metEngineDouble;
+extern const METROLOGY_ENGINE metEngineFixed;
+
+#endif // METROLOGY_ENGINE_H
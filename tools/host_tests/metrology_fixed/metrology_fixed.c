@@ -0,0 +1,632 @@
+/*******************************************************************************
+  Metrology fixed point engine test
+
+  File Name:
+    metrology_fixed.c
+
+  Summary:
+    Compares the fixed point and the double precision metrology engines.
+
+  Description:
+    drv_metrology.c of the G3 metering demo is linked twice, once with each
+    engine (see metrology_engine.c). Both engines compute the RMS voltages and
+    currents, the active, reactive and apparent powers, the angles and the
+    energy of every accumulator snapshot of a corpus, and the results must not
+    differ by more than the bounds documented in drv_metrology_definitions.h
+    (1 LSB). The test reports the maximum error of each quantity and the time
+    each engine takes per integration period.
+
+    The corpus is either generated, from random voltages, currents and angles
+    over the metrology range and a set of corner cases, or read from console
+    captures of the metering demo: the DAR command output gives the
+    accumulators of a snapshot, and the last DSR and DCR outputs before it
+    give N and the K_x gains.
+
+    Usage:
+      metrology_fixed [-n snapshots] [-r rounds] [capture file ...]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include "metrology_engine.h"
+#include "system/int/sys_int.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_SNAPSHOTS  20000U
+#define TEST_DEFAULT_ROUNDS     20U
+#define TEST_MAX_ERROR_LSB      1
+#define TEST_MAX_FAILS_SHOWN    10U
+#define TEST_ANGLE_360          36000000L
+
+typedef enum
+{
+    VAL_UA = 0, VAL_UB, VAL_UC, VAL_IA, VAL_IB, VAL_IC, VAL_INM, VAL_INI, VAL_INMI,
+    VAL_PA, VAL_PB, VAL_PC, VAL_QA, VAL_QB, VAL_QC, VAL_SA, VAL_SB, VAL_SC,
+    VAL_ANGLEA, VAL_ANGLEB, VAL_ANGLEC, VAL_ANGLEN, VAL_PENERGY, VAL_QENERGY,
+    VAL_NUM
+} TEST_VALUE_ID;
+
+typedef enum
+{
+    CAT_VI_RMS = 0, CAT_PQS_RMS, CAT_ANGLE, CAT_ENERGY, CAT_NUM
+} TEST_CATEGORY;
+
+/* Accumulators of one integration period and the registers they are scaled with */
+typedef struct
+{
+    uint32_t n;
+    uint32_t kI[3];
+    uint32_t kV[3];
+    uint32_t kIN;
+    DRV_METROLOGY_REGS_ACCUMULATORS acc;
+} TEST_SNAPSHOT;
+
+typedef struct
+{
+    TEST_SNAPSHOT *snapshots;
+    size_t num;
+    size_t size;
+} TEST_CORPUS;
+
+static const char *valueNames[VAL_NUM] =
+{
+    "UA", "UB", "UC", "IA", "IB", "IC", "INM", "INI", "INMI",
+    "PA", "PB", "PC", "QA", "QB", "QC", "SA", "SB", "SC",
+    "ANGLEA", "ANGLEB", "ANGLEC", "ANGLEN", "PENERGY", "QENERGY"
+};
+
+static const char *categoryNames[CAT_NUM] =
+{
+    "U/I RMS (0.0001 V/A)", "P/Q/S RMS (0.1 W/VAr/VA)", "Angle (0.00001 deg)", "Energy (0.0001 kWh/kVArh)"
+};
+
+static MET_REGISTERS testRegs;
+static uint64_t testRandState = 0x2545F4914F6CDD1DULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static double _uniform(double min, double max)
+{
+    return min + ((max - min) * ((double)(_rand64() >> 11) / 9007199254740992.0));
+}
+
+/* Magnitude spread over decades, so small loads are as frequent as large ones */
+static double _logUniform(double min, double max)
+{
+    return pow(10.0, _uniform(log10(min), log10(max)));
+}
+
+static TEST_SNAPSHOT *_corpusAdd(TEST_CORPUS *corpus)
+{
+    TEST_SNAPSHOT *snap;
+
+    if (corpus->num == corpus->size)
+    {
+        corpus->size = (corpus->size == 0U) ? 1024U : (corpus->size * 2U);
+        corpus->snapshots = realloc(corpus->snapshots, corpus->size * sizeof(TEST_SNAPSHOT));
+        if (corpus->snapshots == NULL)
+        {
+            printf("FAIL: out of memory\n");
+            exit(1);
+        }
+    }
+
+    snap = &corpus->snapshots[corpus->num++];
+    (void) memset(snap, 0, sizeof(*snap));
+    return snap;
+}
+
+static void _snapshotDefaults(TEST_SNAPSHOT *snap)
+{
+    uint8_t ph;
+
+    snap->n = 4000U;
+    for (ph = 0U; ph < 3U; ph++)
+    {
+        snap->kI[ph] = DRV_METROLOGY_CONF_KI;
+        snap->kV[ph] = DRV_METROLOGY_CONF_KV;
+    }
+    snap->kIN = DRV_METROLOGY_CONF_KI;
+}
+
+/* Accumulator of v^2 over N samples, uQ24.40, for an RMS value v and gain k */
+static uint64_t _accVI(double rms, uint32_t k, uint32_t n)
+{
+    double m = (rms * (double)RMS_DIV_G) / (double)k;
+
+    return (uint64_t)(m * m * (double)n * (double)RMS_DIV_Q);
+}
+
+/* Accumulator of v*i over N samples, sQ23.40, for a power p and gains ki, kv */
+static int64_t _accPQ(double power, uint32_t ki, uint32_t kv, uint32_t n)
+{
+    double m = (power * (double)RMS_DIV_G * (double)RMS_DIV_G) / ((double)ki * (double)kv);
+
+    return (int64_t)(m * (double)n * (double)RMS_DIV_Q);
+}
+
+static void _snapshotPhase(TEST_SNAPSHOT *snap, uint8_t ph, double u, double i, double angleDeg)
+{
+    double s = u * i;
+    double phi = (angleDeg * M_PI) / 180.0;
+    uint64_t *pU = (ph == 0U) ? (uint64_t *)&snap->acc.V_A : ((ph == 1U) ? (uint64_t *)&snap->acc.V_B : (uint64_t *)&snap->acc.V_C);
+    uint64_t *pI = (ph == 0U) ? (uint64_t *)&snap->acc.I_A : ((ph == 1U) ? (uint64_t *)&snap->acc.I_B : (uint64_t *)&snap->acc.I_C);
+    int64_t *pP = (ph == 0U) ? (int64_t *)&snap->acc.P_A : ((ph == 1U) ? (int64_t *)&snap->acc.P_B : (int64_t *)&snap->acc.P_C);
+    int64_t *pQ = (ph == 0U) ? (int64_t *)&snap->acc.Q_A : ((ph == 1U) ? (int64_t *)&snap->acc.Q_B : (int64_t *)&snap->acc.Q_C);
+
+    *pU = _accVI(u, snap->kV[ph], snap->n);
+    *pI = _accVI(i, snap->kI[ph], snap->n);
+    *pP = _accPQ(s * cos(phi), snap->kI[ph], snap->kV[ph], snap->n);
+    *pQ = _accPQ(s * sin(phi), snap->kI[ph], snap->kV[ph], snap->n);
+}
+
+static void _corpusCorners(TEST_CORPUS *corpus)
+{
+    static const double angles[] = {0.0, 90.0, -90.0, 180.0, -180.0, 45.0, -135.0, 0.001, -0.001, 179.999};
+    static const int64_t pq[][2] =
+    {
+        {0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1},
+        {INT64_MAX, 0}, {0, INT64_MAX}, {-INT64_MAX, 1}, {-INT64_MAX, -1}, {INT64_MAX, INT64_MAX},
+        {(int64_t)1 << 40, -((int64_t)1 << 40)}, {-((int64_t)1 << 50), (int64_t)1 << 20}
+    };
+    TEST_SNAPSHOT *snap;
+    size_t idx;
+    uint8_t ph;
+
+    /* No load and no voltage */
+    snap = _corpusAdd(corpus);
+    _snapshotDefaults(snap);
+
+    /* Unity load at the quadrant boundaries */
+    for (idx = 0U; idx < (sizeof(angles) / sizeof(angles[0])); idx++)
+    {
+        snap = _corpusAdd(corpus);
+        _snapshotDefaults(snap);
+        for (ph = 0U; ph < 3U; ph++)
+        {
+            _snapshotPhase(snap, ph, 230.0, 10.0, angles[idx]);
+        }
+    }
+
+    /* Angle of extreme and tiny power accumulators */
+    for (idx = 0U; idx < (sizeof(pq) / sizeof(pq[0])); idx++)
+    {
+        snap = _corpusAdd(corpus);
+        _snapshotDefaults(snap);
+        snap->acc.P_N = pq[idx][0];
+        snap->acc.Q_N = pq[idx][1];
+    }
+}
+
+static void _corpusGenerate(TEST_CORPUS *corpus, size_t num)
+{
+    TEST_SNAPSHOT *snap;
+    double u, i, in;
+    size_t idx;
+    uint8_t ph;
+
+    for (idx = 0U; idx < num; idx++)
+    {
+        snap = _corpusAdd(corpus);
+
+        /* Integration period of 50 or 60 Hz cycles at 4 kHz, calibrated gains */
+        snap->n = 3200U + (uint32_t)(_rand64() % 1601U);
+        for (ph = 0U; ph < 3U; ph++)
+        {
+            snap->kI[ph] = (uint32_t)(DRV_METROLOGY_CONF_KI * _uniform(0.8, 1.2));
+            snap->kV[ph] = (uint32_t)(DRV_METROLOGY_CONF_KV * _uniform(0.8, 1.2));
+        }
+        snap->kIN = (uint32_t)(DRV_METROLOGY_CONF_KI * _uniform(0.8, 1.2));
+
+        for (ph = 0U; ph < 3U; ph++)
+        {
+            u = ((_rand64() % 20U) == 0U) ? 0.0 : _logUniform(0.001, 1000.0);
+            i = ((_rand64() % 10U) == 0U) ? 0.0 : _logUniform(0.0001, 1000.0);
+            _snapshotPhase(snap, ph, u, i, _uniform(-180.0, 180.0));
+        }
+
+        in = _logUniform(0.0001, 1000.0);
+        snap->acc.I_Nm = _accVI(in, snap->kIN, snap->n);
+        snap->acc.I_Ni = (uint64_t)(in * in * (double)snap->n * (double)RMS_DIV_Inx_Q);
+        snap->acc.I_Nmi = (uint64_t)(in * in * _uniform(0.9, 1.1) * (double)snap->n * (double)RMS_DIV_Inx_Q);
+        snap->acc.P_N = snap->acc.P_A - (snap->acc.P_B / 2) - (snap->acc.P_C / 2);
+        snap->acc.Q_N = snap->acc.Q_A - (snap->acc.Q_B / 2) - (snap->acc.Q_C / 2);
+    }
+}
+
+/* Register of a capture line "NN NAME": its place in the snapshot */
+static bool _captureSet(TEST_SNAPSHOT *snap, bool *pAccDone, const char *name, uint64_t value)
+{
+    static const struct
+    {
+        const char *name;
+        size_t offset;
+    } accRegs[] =
+    {
+        {"I_A", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_A)},
+        {"I_B", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_B)},
+        {"I_C", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_C)},
+        {"I_Ni", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_Ni)},
+        {"I_Nm", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_Nm)},
+        {"I_Nmi", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, I_Nmi)},
+        {"P_A", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, P_A)},
+        {"P_B", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, P_B)},
+        {"P_C", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, P_C)},
+        {"P_N", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, P_N)},
+        {"Q_A", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, Q_A)},
+        {"Q_B", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, Q_B)},
+        {"Q_C", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, Q_C)},
+        {"Q_N", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, Q_N)},
+        {"V_A", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, V_A)},
+        {"V_B", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, V_B)},
+        {"V_C", offsetof(DRV_METROLOGY_REGS_ACCUMULATORS, V_C)},
+    };
+    size_t idx;
+
+    for (idx = 0U; idx < (sizeof(accRegs) / sizeof(accRegs[0])); idx++)
+    {
+        if (strcmp(name, accRegs[idx].name) == 0)
+        {
+            (void) memcpy((uint8_t *)&snap->acc + accRegs[idx].offset, &value, sizeof(value));
+            *pAccDone = true;
+            return true;
+        }
+    }
+
+    if (strcmp(name, "N") == 0)
+    {
+        snap->n = (uint32_t)value;
+    }
+    else if ((strncmp(name, "K_I", 3U) == 0) && (name[3] >= 'A') && (name[3] <= 'C') && (name[4] == 0))
+    {
+        snap->kI[name[3] - 'A'] = (uint32_t)value;
+    }
+    else if ((strncmp(name, "K_V", 3U) == 0) && (name[3] >= 'A') && (name[3] <= 'C') && (name[4] == 0))
+    {
+        snap->kV[name[3] - 'A'] = (uint32_t)value;
+    }
+    else if (strcmp(name, "K_IN") == 0)
+    {
+        snap->kIN = (uint32_t)value;
+    }
+
+    return false;
+}
+
+/* Read the DAR, DSR and DCR outputs of a console capture: a line of register
+ * names ("00 I_A      01 I_B ...") followed by a line of hex values */
+static int _corpusRead(TEST_CORPUS *corpus, const char *fileName)
+{
+    FILE *file;
+    char line[512], names[8][32];
+    char *tok;
+    TEST_SNAPSHOT current;
+    size_t numNames = 0U, idx, start = corpus->num;
+    bool accDone = false;
+
+    file = fopen(fileName, "r");
+    if (file == NULL)
+    {
+        printf("FAIL: can not open %s\n", fileName);
+        return 1;
+    }
+
+    (void) memset(&current, 0, sizeof(current));
+    _snapshotDefaults(&current);
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char *save = NULL;
+        char *toks[16];
+        size_t numToks = 0U;
+        bool isNames = true;
+
+        for (tok = strtok_r(line, " \t\r\n>", &save); (tok != NULL) && (numToks < 16U); tok = strtok_r(NULL, " \t\r\n>", &save))
+        {
+            toks[numToks++] = tok;
+        }
+
+        if (numToks == 0U)
+        {
+            continue;
+        }
+
+        /* Names line: pairs of a 2 digit index and a name */
+        for (idx = 0U; idx < numToks; idx += 2U)
+        {
+            if (((idx + 1U) >= numToks) || (strlen(toks[idx]) != 2U) ||
+                    (isdigit((unsigned char)toks[idx][0]) == 0) || (isdigit((unsigned char)toks[idx][1]) == 0) ||
+                    (isalpha((unsigned char)toks[idx + 1U][0]) == 0))
+            {
+                isNames = false;
+                break;
+            }
+        }
+
+        if (isNames == true)
+        {
+            /* A new DAR output closes the previous snapshot */
+            if ((strcmp(toks[1], "I_A") == 0) && (accDone == true))
+            {
+                *_corpusAdd(corpus) = current;
+                accDone = false;
+            }
+
+            numNames = numToks / 2U;
+            for (idx = 0U; idx < numNames; idx++)
+            {
+                (void) snprintf(names[idx], sizeof(names[idx]), "%s", toks[(2U * idx) + 1U]);
+            }
+            continue;
+        }
+
+        /* Values line of the previous names line */
+        if ((numNames > 0U) && (numToks == numNames))
+        {
+            for (idx = 0U; idx < numNames; idx++)
+            {
+                (void) _captureSet(&current, &accDone, names[idx], strtoull(toks[idx], NULL, 16));
+            }
+        }
+
+        numNames = 0U;
+    }
+
+    if (accDone == true)
+    {
+        *_corpusAdd(corpus) = current;
+    }
+
+    (void) fclose(file);
+    printf("%s: %zu snapshots\n", fileName, corpus->num - start);
+    return 0;
+}
+
+static void _compute(const METROLOGY_ENGINE *engine, TEST_SNAPSHOT *snap, uint32_t *values)
+{
+    DRV_METROLOGY_REGS_ACCUMULATORS *acc = &snap->acc;
+
+    testRegs.MET_STATUS.N = snap->n;
+    testRegs.MET_CONTROL.K_IA = snap->kI[0];
+    testRegs.MET_CONTROL.K_IB = snap->kI[1];
+    testRegs.MET_CONTROL.K_IC = snap->kI[2];
+    testRegs.MET_CONTROL.K_VA = snap->kV[0];
+    testRegs.MET_CONTROL.K_VB = snap->kV[1];
+    testRegs.MET_CONTROL.K_VC = snap->kV[2];
+    testRegs.MET_CONTROL.K_IN = snap->kIN;
+    engine->setRegisters(&testRegs, acc);
+
+    values[VAL_UA] = engine->getVIRMS(acc->V_A, snap->kV[0]);
+    values[VAL_UB] = engine->getVIRMS(acc->V_B, snap->kV[1]);
+    values[VAL_UC] = engine->getVIRMS(acc->V_C, snap->kV[2]);
+    values[VAL_IA] = engine->getVIRMS(acc->I_A, snap->kI[0]);
+    values[VAL_IB] = engine->getVIRMS(acc->I_B, snap->kI[1]);
+    values[VAL_IC] = engine->getVIRMS(acc->I_C, snap->kI[2]);
+    values[VAL_INM] = engine->getVIRMS(acc->I_Nm, snap->kIN);
+    values[VAL_INI] = engine->getInxRMS(acc->I_Ni);
+    values[VAL_INMI] = engine->getInxRMS(acc->I_Nmi);
+
+    values[VAL_PA] = engine->getPQRMS(acc->P_A, snap->kI[0], snap->kV[0]);
+    values[VAL_PB] = engine->getPQRMS(acc->P_B, snap->kI[1], snap->kV[1]);
+    values[VAL_PC] = engine->getPQRMS(acc->P_C, snap->kI[2], snap->kV[2]);
+    values[VAL_QA] = engine->getPQRMS(acc->Q_A, snap->kI[0], snap->kV[0]);
+    values[VAL_QB] = engine->getPQRMS(acc->Q_B, snap->kI[1], snap->kV[1]);
+    values[VAL_QC] = engine->getPQRMS(acc->Q_C, snap->kI[2], snap->kV[2]);
+    values[VAL_SA] = engine->getSRMS(acc->P_A, acc->Q_A, snap->kI[0], snap->kV[0]);
+    values[VAL_SB] = engine->getSRMS(acc->P_B, acc->Q_B, snap->kI[1], snap->kV[1]);
+    values[VAL_SC] = engine->getSRMS(acc->P_C, acc->Q_C, snap->kI[2], snap->kV[2]);
+
+    values[VAL_ANGLEA] = engine->getAngleRMS(acc->P_A, acc->Q_A);
+    values[VAL_ANGLEB] = engine->getAngleRMS(acc->P_B, acc->Q_B);
+    values[VAL_ANGLEC] = engine->getAngleRMS(acc->P_C, acc->Q_C);
+    values[VAL_ANGLEN] = engine->getAngleRMS(acc->P_N, acc->Q_N);
+
+    values[VAL_PENERGY] = engine->getPQEnergy(false);
+    values[VAL_QENERGY] = engine->getPQEnergy(true);
+}
+
+static TEST_CATEGORY _category(TEST_VALUE_ID id)
+{
+    if (id <= VAL_INMI)
+    {
+        return CAT_VI_RMS;
+    }
+    else if (id <= VAL_SC)
+    {
+        return CAT_PQS_RMS;
+    }
+    else if (id <= VAL_ANGLEN)
+    {
+        return CAT_ANGLE;
+    }
+
+    return CAT_ENERGY;
+}
+
+/* Difference in LSBs; angles are sign and magnitude and wrap at 360 degrees */
+static int64_t _error(TEST_VALUE_ID id, uint32_t valDouble, uint32_t valFixed)
+{
+    int64_t a, b, err;
+
+    if (_category(id) == CAT_ANGLE)
+    {
+        a = ((valDouble & 0x80000000UL) != 0UL) ? -(int64_t)(valDouble & 0x7FFFFFFFUL) : (int64_t)valDouble;
+        b = ((valFixed & 0x80000000UL) != 0UL) ? -(int64_t)(valFixed & 0x7FFFFFFFUL) : (int64_t)valFixed;
+        err = llabs(a - b);
+        if (err > (TEST_ANGLE_360 / 2))
+        {
+            err = TEST_ANGLE_360 - err;
+        }
+        return err;
+    }
+
+    return llabs((int64_t)valDouble - (int64_t)valFixed);
+}
+
+static int _compare(TEST_CORPUS *corpus)
+{
+    uint32_t valDouble[VAL_NUM], valFixed[VAL_NUM];
+    int64_t maxError[CAT_NUM] = {0}, err;
+    unsigned long nValues[CAT_NUM] = {0}, nExact[CAT_NUM] = {0};
+    unsigned long nFails = 0U;
+    size_t idx;
+    int id, cat;
+
+    for (idx = 0U; idx < corpus->num; idx++)
+    {
+        _compute(&metEngineDouble, &corpus->snapshots[idx], valDouble);
+        _compute(&metEngineFixed, &corpus->snapshots[idx], valFixed);
+
+        for (id = 0; id < VAL_NUM; id++)
+        {
+            cat = _category((TEST_VALUE_ID)id);
+            err = _error((TEST_VALUE_ID)id, valDouble[id], valFixed[id]);
+            nValues[cat]++;
+            if (err == 0)
+            {
+                nExact[cat]++;
+            }
+            if (err > maxError[cat])
+            {
+                maxError[cat] = err;
+            }
+            if (err > TEST_MAX_ERROR_LSB)
+            {
+                if (nFails < TEST_MAX_FAILS_SHOWN)
+                {
+                    printf("FAIL: snapshot %zu %s: double %lu fixed %lu\n", idx, valueNames[id],
+                            (unsigned long)valDouble[id], (unsigned long)valFixed[id]);
+                }
+                nFails++;
+            }
+        }
+    }
+
+    printf("compare: %zu snapshots\n", corpus->num);
+    for (cat = 0; cat < CAT_NUM; cat++)
+    {
+        printf("  %-26s max error %lld LSB, %.2f%% exact\n", categoryNames[cat], (long long)maxError[cat],
+                (nValues[cat] == 0U) ? 0.0 : ((100.0 * (double)nExact[cat]) / (double)nValues[cat]));
+    }
+
+    if (nFails > 0U)
+    {
+        printf("FAIL: %lu values differ by more than %d LSB\n", nFails, TEST_MAX_ERROR_LSB);
+        return 1;
+    }
+
+    return 0;
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static double _benchmark(const METROLOGY_ENGINE *engine, TEST_CORPUS *corpus, unsigned long rounds)
+{
+    uint32_t values[VAL_NUM];
+    volatile uint32_t sink = 0U;
+    unsigned long round;
+    size_t idx;
+    double start;
+
+    start = _seconds();
+    for (round = 0U; round < rounds; round++)
+    {
+        for (idx = 0U; idx < corpus->num; idx++)
+        {
+            _compute(engine, &corpus->snapshots[idx], values);
+            sink += values[VAL_SA];
+        }
+    }
+
+    (void) sink;
+    return ((_seconds() - start) * 1e9) / ((double)rounds * (double)corpus->num);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    TEST_CORPUS corpus = {NULL, 0U, 0U};
+    unsigned long numSnapshots = TEST_DEFAULT_SNAPSHOTS;
+    unsigned long rounds = TEST_DEFAULT_ROUNDS;
+    double tDouble, tFixed;
+    int nErrors = 0;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((strcmp(argv[arg], "-n") == 0) && ((arg + 1) < argc))
+        {
+            numSnapshots = strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((strcmp(argv[arg], "-r") == 0) && ((arg + 1) < argc))
+        {
+            rounds = strtoul(argv[++arg], NULL, 0);
+        }
+        else
+        {
+            nErrors += _corpusRead(&corpus, argv[arg]);
+        }
+    }
+
+    if (corpus.num == 0U)
+    {
+        _corpusCorners(&corpus);
+        _corpusGenerate(&corpus, numSnapshots);
+    }
+
+    if ((nErrors == 0) && (corpus.num > 0U))
+    {
+        nErrors += _compare(&corpus);
+
+        tDouble = _benchmark(&metEngineDouble, &corpus, rounds);
+        tFixed = _benchmark(&metEngineFixed, &corpus, rounds);
+        printf("benchmark: %lu rounds, %u values per integration period\n", rounds, (unsigned) VAL_NUM);
+        printf("  double:      %8.1f ns per integration period\n", tDouble);
+        printf("  fixed point: %8.1f ns per integration period\n", tFixed);
+    }
+
+    free(corpus.snapshots);
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
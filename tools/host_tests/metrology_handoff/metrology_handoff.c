@@ -0,0 +1,411 @@
+/*******************************************************************************
+  Metrology integration handoff test
+
+  File Name:
+    metrology_handoff.c
+
+  Summary:
+    Host test of the handoff of the integration periods between the IPC
+    interrupt and the metrology driver task.
+
+  Description:
+    drv_metrology.c of the G3 metering demo is built for the host with its
+    own configuration. A model of the metrology library ends an integration
+    period every TEST_PERIOD_US: it writes accumulators and harmonics of the
+    period into the shared memory, with a pattern of the period number in
+    every word, and raises the IPC interrupt, at once or TEST_IRQ_DELAY_US
+    later. The main loop calls DRV_METROLOGY_Tasks after random delays and
+    the copies of the shared memory made by the driver advance the simulated
+    time by TEST_COPY_US_PER_BYTE, so periods also end, and the interrupt
+    runs, in the middle of a copy.
+
+    After every task call the data published by the driver must belong to a
+    single period, never older than the one published before. At the end,
+    every period signaled by the interrupt must have been either processed or
+    counted as missed, and the interrupt must not have copied any byte of the
+    shared memory. The statistics are printed for every main loop profile.
+
+    Usage:
+      metrology_handoff [periods per profile]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "device.h"
+
+/* The driver copies the shared memory through the test, which advances the
+ * simulated time during the copy */
+static void *_copy(void *dst, const void *src, size_t size);
+#define memcpy                              _copy
+
+/* The Cortex-M barrier is an instruction the host assembler does not know */
+#define __DMB()                             __sync_synchronize()
+
+static ipc_registers_t testIpc;
+#undef IPC1_REGS
+#define IPC1_REGS                           (&testIpc)
+
+#include "drv_metrology_host.c"
+
+#undef memcpy
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_PERIODS    20000U
+#define TEST_PERIOD_US          1000U
+
+/* About 500 bytes are copied per period: about a third of the period, so
+ * that periods often end during a copy */
+#define TEST_COPY_US_PER_BYTE   0.6
+#define TEST_COPY_STEP          8U
+
+/* Interrupt raised this long after the shared memory is written */
+#define TEST_IRQ_DELAY_US       40.0
+
+typedef struct
+{
+    const char *name;
+    /* Main loop delay between task calls: uniform up to maxLoopUS, and up to
+     * lateLoopUS one call in lateEvery */
+    double maxLoopUS;
+    double lateLoopUS;
+    uint32_t lateEvery;
+    /* Interrupt after the write of the shared memory */
+    bool irqDelayed;
+    /* Checks of the profile */
+    bool expectMissed;
+    bool expectTorn;
+} TEST_PROFILE;
+
+static const TEST_PROFILE testProfiles[] =
+{
+    {"on time",           200.0,    0.0,  0U, false, false, false},
+    {"late",              200.0, 3500.0,  5U, false, true,  true},
+    {"always late",      2500.0,    0.0,  0U, false, true,  true},
+    {"delayed interrupt", 200.0, 2500.0, 10U, true,  true,  true},
+};
+
+typedef struct
+{
+    double now;
+    double nextPeriod;
+    double irqAt;
+    bool irqPending;
+    uint32_t period;
+    uint32_t signaled;
+    bool inIsr;
+    uint32_t isrCopyBytes;
+    uint32_t lastPublished;
+    uint32_t fails;
+} TEST_STATE;
+
+static MET_REGISTERS testShared;
+static TEST_STATE testState;
+static const TEST_PROFILE *testProfile;
+static uint64_t testRandState = 0x2545F4914F6CDD1DULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Metrology Library Model
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static double _uniform(double max)
+{
+    return max * ((double)(_rand64() >> 11) / 9007199254740992.0);
+}
+
+static uint32_t _word(uint32_t period, uint32_t idx)
+{
+    return (period << 10) ^ idx;
+}
+
+static void _writeShared(uint32_t period)
+{
+    uint32_t *pAcc = (uint32_t *)&testShared.MET_ACCUMULATORS;
+    uint32_t *pHar = (uint32_t *)&testShared.MET_HARMONICS;
+    uint32_t idx;
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_ACCUMULATORS) / 4U); idx++)
+    {
+        pAcc[idx] = _word(period, idx);
+    }
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_HARMONICS) / 4U); idx++)
+    {
+        pHar[idx] = _word(period, idx + 0x200U);
+    }
+
+    *(uint32_t *)&testShared.MET_STATUS.INTERVAL_NUM = period;
+}
+
+static void _raiseIrq(void)
+{
+    *(uint32_t *)&testIpc.IPC_ISR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK;
+    *(uint32_t *)&testIpc.IPC_IMR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK | DRV_METROLOGY_IPC_INIT_IRQ_MSK;
+
+    testState.inIsr = true;
+    IPC1_InterruptHandler();
+    testState.inIsr = false;
+    testState.signaled++;
+}
+
+/* Run the metrology library until the simulated time */
+static void _advance(double until, const TEST_PROFILE *profile)
+{
+    while (true)
+    {
+        double next = testState.nextPeriod;
+
+        if ((testState.irqPending == true) && (testState.irqAt <= next))
+        {
+            next = testState.irqAt;
+        }
+
+        if (next > until)
+        {
+            break;
+        }
+
+        if ((testState.irqPending == true) && (next == testState.irqAt))
+        {
+            testState.irqPending = false;
+            _raiseIrq();
+            continue;
+        }
+
+        if (testState.irqPending == true)
+        {
+            /* The previous interrupt is raised before the next write */
+            testState.irqPending = false;
+            _raiseIrq();
+        }
+
+        testState.period++;
+        _writeShared(testState.period);
+        testState.nextPeriod += TEST_PERIOD_US;
+
+        if (profile->irqDelayed == true)
+        {
+            testState.irqPending = true;
+            testState.irqAt = next + TEST_IRQ_DELAY_US;
+        }
+        else
+        {
+            _raiseIrq();
+        }
+    }
+
+    testState.now = until;
+}
+
+static void *_copy(void *dst, const void *src, size_t size)
+{
+    const uint8_t *pSrc = (const uint8_t *)src;
+    uint8_t *pDst = (uint8_t *)dst;
+    const uint8_t *pSharedStart = (const uint8_t *)&testShared.MET_ACCUMULATORS;
+    const uint8_t *pSharedEnd = (const uint8_t *)&testShared.MET_HARMONICS + sizeof(DRV_METROLOGY_REGS_HARMONICS);
+    size_t done, step;
+
+    if ((pSrc < pSharedStart) || (pSrc >= pSharedEnd))
+    {
+        return memmove(dst, src, size);
+    }
+
+    if (testState.inIsr == true)
+    {
+        testState.isrCopyBytes += (uint32_t)size;
+    }
+
+    /* The metrology library may end a period between two steps of the copy */
+    for (done = 0U; done < size; done += step)
+    {
+        step = ((size - done) < TEST_COPY_STEP) ? (size - done) : TEST_COPY_STEP;
+        memmove(&pDst[done], &pSrc[done], step);
+        _advance(testState.now + ((double)step * TEST_COPY_US_PER_BYTE), testProfile);
+    }
+
+    return dst;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Period of the published data, or 0 if the words are not of a single one */
+static uint32_t _publishedPeriod(void)
+{
+    const uint32_t *pAcc = (const uint32_t *)DRV_METROLOGY_GetAccData();
+    const uint32_t *pHar = (const uint32_t *)DRV_METROLOGY_GetHarData();
+    uint32_t period = pAcc[0] >> 10;
+    uint32_t idx;
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_ACCUMULATORS) / 4U); idx++)
+    {
+        if (pAcc[idx] != _word(period, idx))
+        {
+            return 0U;
+        }
+    }
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_HARMONICS) / 4U); idx++)
+    {
+        if (pHar[idx] != _word(period, idx + 0x200U))
+        {
+            return 0U;
+        }
+    }
+
+    return period;
+}
+
+static void _fail(const char *msg, uint32_t value)
+{
+    testState.fails++;
+    if (testState.fails <= 10U)
+    {
+        printf("FAIL: %s: %s %u\n", testProfile->name, msg, (unsigned)value);
+    }
+}
+
+static bool _testProfile(const TEST_PROFILE *profile, uint32_t periods)
+{
+    DRV_METROLOGY_INTEGRATION_STATS stats;
+    uint32_t calls = 0U;
+    uint32_t pending;
+
+    testProfile = profile;
+    (void) memset(&testState, 0, sizeof(testState));
+    (void) memset(&testShared, 0, sizeof(testShared));
+    *(uint32_t *)&testShared.MET_STATUS.STATUS = STATUS_STATUS_DSP_RUNNING;
+    testState.nextPeriod = TEST_PERIOD_US;
+
+    gDrvMetObj.metRegisters = &testShared;
+    gDrvMetObj.ipcInterruptFlag = false;
+    gDrvMetObj.integrationFlag = false;
+    gDrvMetObj.calibrationData.running = false;
+    gDrvMetObj.harmonicAnalysisData.running = false;
+    lDRV_METROLOGY_ResetIntegrationData();
+
+    while (testState.period < periods)
+    {
+        double loopUS = _uniform(profile->maxLoopUS);
+        uint32_t period;
+
+        if ((profile->lateEvery != 0U) && ((_rand64() % profile->lateEvery) == 0U))
+        {
+            loopUS = _uniform(profile->lateLoopUS);
+        }
+
+        _advance(testState.now + loopUS, profile);
+        DRV_METROLOGY_Tasks((SYS_MODULE_OBJ)1);
+        calls++;
+
+        period = _publishedPeriod();
+        if ((period == 0U) && (testState.signaled != 0U) && (gDrvMetObj.integrationStats.processedCount != 0U))
+        {
+            _fail("published data of several periods, call", calls);
+        }
+        else if (period < testState.lastPublished)
+        {
+            _fail("published period older than the previous one, period", period);
+        }
+        else
+        {
+            testState.lastPublished = period;
+        }
+    }
+
+    DRV_METROLOGY_GetIntegrationStats(&stats);
+
+    /* The last period may still wait for the task */
+    pending = (gDrvMetObj.integrationCount != gDrvMetObj.processedCount) ? 1U : 0U;
+    if ((stats.processedCount + stats.missedCount + pending) != testState.signaled)
+    {
+        _fail("periods not processed nor counted as missed", testState.signaled - stats.processedCount -
+                stats.missedCount - pending);
+    }
+
+    if (testState.isrCopyBytes != 0U)
+    {
+        _fail("bytes of the shared memory copied by the interrupt", testState.isrCopyBytes);
+    }
+
+    if ((profile->expectMissed == true) && (stats.missedCount == 0U))
+    {
+        _fail("no missed period reported, processed", stats.processedCount);
+    }
+
+    if ((profile->expectMissed == false) && (stats.missedCount > stats.tornCount))
+    {
+        _fail("periods missed with the task on time", stats.missedCount);
+    }
+
+    if ((profile->expectTorn == true) && (stats.tornCount == 0U))
+    {
+        _fail("no torn copy detected, processed", stats.processedCount);
+    }
+
+    printf("%-18s %8u %9u %7u %6u %6u\n", profile->name, (unsigned)testState.signaled, (unsigned)stats.processedCount,
+            (unsigned)stats.missedCount, (unsigned)stats.tornCount, (unsigned)calls);
+
+    return (testState.fails == 0U);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t periods = TEST_DEFAULT_PERIODS;
+    bool pass = true;
+    size_t idx;
+
+    if (argc > 1)
+    {
+        periods = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    printf("Period %u us, copy %.1f us per byte (%u bytes), interrupt delay %.0f us\n", TEST_PERIOD_US,
+            TEST_COPY_US_PER_BYTE, (unsigned)(sizeof(DRV_METROLOGY_REGS_ACCUMULATORS) + sizeof(DRV_METROLOGY_REGS_HARMONICS)),
+            TEST_IRQ_DELAY_US);
+    printf("%-18s %8s %9s %7s %6s %6s\n", "", "signaled", "processed", "missed", "torn", "tasks");
+
+    for (idx = 0U; idx < (sizeof(testProfiles) / sizeof(testProfiles[0])); idx++)
+    {
+        if (_testProfile(&testProfiles[idx], periods) == false)
+        {
+            pass = false;
+        }
+    }
+
+    printf("%s\n", (pass == true) ? "PASS" : "FAIL");
+    return (pass == true) ? 0 : 1;
+}
@@ -0,0 +1,649 @@
+/*******************************************************************************
+  Metrology snapshot test
+
+  File Name:
+    metrology_snapshot.c
+
+  Summary:
+    Host test of the consistency of DRV_METROLOGY_GetSnapshot when a reader
+    and the driver task preempt each other, and benchmark of its latency.
+
+  Description:
+    drv_metrology.c of the G3 metering demo is built for the host with its
+    own configuration. The writer runs in its own context: a model of the
+    metrology library writes the shared memory of an integration period
+    from a pattern of the period and raises the IPC interrupt, then the
+    driver task processes the period and updates the snapshot. The writer
+    stops at both barriers of the snapshot update and at the end of every
+    period, so a writer step is one of:
+    - from the end of a period to the first barrier: the count gets odd,
+    - from the first to the second barrier: the new snapshot is filled,
+    - from the second barrier to the end of the period: the count gets even.
+
+    Reads run in the main context. A read starts with the writer stopped at
+    any of the three points, and the copy of the snapshot of every attempt
+    is split after any word, where the writer runs a number of steps. All the
+    splits of the first attempt are run, with every number of steps up to
+    TEST_MAX_STEPS in the first two attempts, followed by random schedules.
+
+    Every accepted snapshot must be equal to the snapshot of its sequence
+    calculated without preemption, and not older than the last snapshot
+    completed when the read started. An attempt may only be rejected if the
+    writer has started filling the copied snapshot during the attempt, and
+    the read must stop at the first attempt in which it has not.
+
+    The number of reads of the RMS values through DRV_METROLOGY_GetRMSValue
+    and DRV_METROLOGY_GetRMSSign that mix two periods when the driver task
+    runs between two of them is printed, and the time of a snapshot read is
+    compared with the time of those 26 pairs of calls.
+
+    Usage:
+      metrology_snapshot [random reads]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "device.h"
+
+/* The copy of the snapshot and the barriers of the driver are the
+ * preemption points of the test */
+static void *_copy(void *dst, const void *src, size_t size);
+static void _barrier(void);
+#define memcpy                              _copy
+#define __DMB()                             _barrier()
+
+static ipc_registers_t testIpc;
+#undef IPC1_REGS
+#define IPC1_REGS                           (&testIpc)
+
+#include "drv_metrology_host.c"
+
+#undef memcpy
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_READS      200000U
+#define TEST_BENCH_READS        1000000U
+
+/* The shared memory pattern repeats every TEST_TABLE_SIZE periods */
+#define TEST_TABLE_SIZE         256U
+
+#define TEST_ATTEMPTS           3U
+#define TEST_MAX_STEPS          7U
+#define TEST_SNAPSHOT_WORDS     (sizeof(DRV_METROLOGY_SNAPSHOT) / 4U)
+#define TEST_WRITER_STACK       (256U * 1024U)
+
+/* Points where the writer stops */
+#define TEST_PHASE_END          0U
+#define TEST_PHASE_BARRIER1     1U
+#define TEST_PHASE_BARRIER2     2U
+#define TEST_PHASES             3U
+
+typedef struct
+{
+    /* Writer point when the read starts */
+    uint8_t startPhase;
+    /* Writer steps in the middle of the copy of every attempt, after
+     * copyWord words of the snapshot */
+    uint8_t steps[TEST_ATTEMPTS];
+    uint8_t copyWord[TEST_ATTEMPTS];
+} TEST_SCHEDULE;
+
+typedef struct
+{
+    const TEST_SCHEDULE *schedule;
+    bool inWriter;
+    bool inReader;
+    uint8_t phase;
+    uint8_t writerBarriers;
+    uint8_t attempts;
+    uint32_t period;
+    uint32_t completed;
+    uint32_t reads;
+    uint32_t accepted;
+    uint32_t previous;
+    uint32_t rejected;
+    uint32_t fails;
+} TEST_STATE;
+
+static MET_REGISTERS testShared;
+static TEST_STATE testState;
+static DRV_METROLOGY_SNAPSHOT testTable[TEST_TABLE_SIZE];
+static ucontext_t testMainCtx;
+static ucontext_t testWriterCtx;
+static uint8_t testWriterStack[TEST_WRITER_STACK];
+static uint64_t testRandState = 0x2545F4914F6CDD1DULL;
+static volatile int32_t testSink;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Writer Model
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t _hash(uint32_t a, uint32_t b)
+{
+    uint64_t x = ((uint64_t)a << 32) | b;
+
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
+/* Shared memory of a period. The 64 bit accumulators get values of both
+ * signs, so that the directions of the powers change between periods */
+static void _writeShared(uint32_t period)
+{
+    uint32_t *pAcc = (uint32_t *)&testShared.MET_ACCUMULATORS;
+    uint32_t *pHar = (uint32_t *)&testShared.MET_HARMONICS;
+    uint32_t data = (period - 1U) % TEST_TABLE_SIZE;
+    uint32_t idx, value;
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_ACCUMULATORS) / 4U); idx += 2U)
+    {
+        value = _hash(data, idx);
+        pAcc[idx] = _hash(data, idx + 0x100U);
+        pAcc[idx + 1U] = ((value & 0x80000000U) != 0U) ? ~(value & 0xFFFU) : (value & 0xFFFU);
+    }
+
+    for (idx = 0U; idx < (sizeof(DRV_METROLOGY_REGS_HARMONICS) / 4U); idx++)
+    {
+        pHar[idx] = _hash(data, idx + 0x200U);
+    }
+
+    *(uint32_t *)&testShared.MET_STATUS.STATE_FLAG = _hash(data, 0x400U) & 0x00007777U;
+    *(uint32_t *)&testShared.MET_STATUS.FREQ = 0xC800U + (_hash(data, 0x401U) & 0xFFU);
+    *(uint32_t *)&testShared.MET_STATUS.INTERVAL_NUM = period;
+}
+
+static void _raiseIrq(void)
+{
+    *(uint32_t *)&testIpc.IPC_ISR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK;
+    *(uint32_t *)&testIpc.IPC_IMR = DRV_METROLOGY_IPC_INTEGRATION_IRQ_MSK | DRV_METROLOGY_IPC_INIT_IRQ_MSK;
+    IPC1_InterruptHandler();
+}
+
+static void _yield(uint8_t phase)
+{
+    testState.phase = phase;
+    testState.inWriter = false;
+    (void) swapcontext(&testWriterCtx, &testMainCtx);
+}
+
+/* Periods processed at once by the driver task */
+static void _writerMain(void)
+{
+    while (true)
+    {
+        testState.period++;
+        _writeShared(testState.period);
+        _raiseIrq();
+
+        testState.writerBarriers = 0U;
+        DRV_METROLOGY_Tasks((SYS_MODULE_OBJ)1);
+
+        testState.completed = testState.period;
+        _yield(TEST_PHASE_END);
+    }
+}
+
+static void _writerStep(void)
+{
+    testState.inWriter = true;
+    (void) swapcontext(&testMainCtx, &testWriterCtx);
+}
+
+static void _writerRunTo(uint8_t phase)
+{
+    do
+    {
+        _writerStep();
+    } while (testState.phase != phase);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Preemption Points
+// *****************************************************************************
+// *****************************************************************************
+
+static void _barrier(void)
+{
+    __sync_synchronize();
+
+    if (testState.inWriter == true)
+    {
+        testState.writerBarriers++;
+        _yield(testState.writerBarriers);
+    }
+}
+
+static void *_copy(void *dst, const void *src, size_t size)
+{
+    const uint8_t *pSrc = (const uint8_t *)src;
+    const uint8_t *pSnapStart = (const uint8_t *)&gDrvMetObj.metSnapshot[0];
+    const uint8_t *pSnapEnd = (const uint8_t *)&gDrvMetObj.metSnapshot[2];
+    size_t split;
+    uint8_t attempt, step;
+
+    if ((pSrc < pSnapStart) || (pSrc >= pSnapEnd) || (testState.inReader == false) || (testState.schedule == NULL))
+    {
+        return memmove(dst, src, size);
+    }
+
+    attempt = testState.attempts++;
+    if (attempt >= TEST_ATTEMPTS)
+    {
+        return memmove(dst, src, size);
+    }
+
+    split = (size_t)testState.schedule->copyWord[attempt] * 4U;
+    if (split > size)
+    {
+        split = size;
+    }
+
+    (void) memmove(dst, src, split);
+    for (step = 0U; step < testState.schedule->steps[attempt]; step++)
+    {
+        _writerStep();
+    }
+    (void) memmove((uint8_t *)dst + split, pSrc + split, size - split);
+
+    return dst;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char *msg, uint32_t value)
+{
+    testState.fails++;
+    if (testState.fails <= 20U)
+    {
+        printf("FAIL: %s %u\n", msg, (unsigned)value);
+    }
+}
+
+static void _reset(void)
+{
+    (void) memset(&testState, 0, sizeof(testState));
+    (void) memset(&testShared, 0, sizeof(testShared));
+    (void) memmove(&testShared.MET_CONTROL, &gDrvMetControlDefault, sizeof(DRV_METROLOGY_REGS_CONTROL));
+    *(uint32_t *)&testShared.MET_STATUS.STATUS = STATUS_STATUS_DSP_RUNNING;
+    /* Samples of an integration period */
+    *(uint32_t *)&testShared.MET_STATUS.N = 4000U;
+
+    gDrvMetObj.metRegisters = &testShared;
+    gDrvMetObj.ipcInterruptFlag = false;
+    gDrvMetObj.integrationFlag = false;
+    gDrvMetObj.calibrationData.running = false;
+    gDrvMetObj.harmonicAnalysisData.running = false;
+    (void) memset(&gDrvMetObj.metAFEData, 0, sizeof(DRV_METROLOGY_AFE_DATA));
+    lDRV_METROLOGY_ResetIntegrationData();
+
+    (void) getcontext(&testWriterCtx);
+    testWriterCtx.uc_stack.ss_sp = testWriterStack;
+    testWriterCtx.uc_stack.ss_size = sizeof(testWriterStack);
+    testWriterCtx.uc_link = &testMainCtx;
+    makecontext(&testWriterCtx, _writerMain, 0);
+}
+
+static const DRV_METROLOGY_SNAPSHOT *_lastSnapshot(void)
+{
+    return &gDrvMetObj.metSnapshot[(gDrvMetObj.snapshotCount >> 1) & 1U];
+}
+
+static bool _matches(const DRV_METROLOGY_SNAPSHOT *snapshot)
+{
+    DRV_METROLOGY_SNAPSHOT expected;
+
+    if (snapshot->sequence == 0U)
+    {
+        return false;
+    }
+
+    expected = testTable[(snapshot->sequence - 1U) % TEST_TABLE_SIZE];
+    expected.sequence = snapshot->sequence;
+    return (memcmp(&expected, snapshot, sizeof(DRV_METROLOGY_SNAPSHOT)) == 0);
+}
+
+/* Snapshots of the periods of the pattern, updated without preemption */
+static bool _buildTable(void)
+{
+    uint32_t idx;
+
+    _reset();
+
+    for (idx = 0U; idx < TEST_TABLE_SIZE; idx++)
+    {
+        _writerRunTo(TEST_PHASE_END);
+        testTable[idx] = *_lastSnapshot();
+        if (testTable[idx].sequence != testState.period)
+        {
+            _fail("snapshot sequence is not the period, period", testState.period);
+        }
+    }
+
+    if (memcmp(&testTable[0].RMS, &testTable[1].RMS, sizeof(testTable[0].RMS)) == 0)
+    {
+        _fail("RMS values of different periods are equal, period", 2U);
+    }
+
+    /* The snapshot depends only on the shared memory of the period */
+    for (idx = 0U; idx < TEST_TABLE_SIZE; idx++)
+    {
+        _writerRunTo(TEST_PHASE_END);
+        if (_matches(_lastSnapshot()) == false)
+        {
+            _fail("snapshot differs from the one of the same pattern, period", testState.period);
+        }
+    }
+
+    return (testState.fails == 0U);
+}
+
+/* An attempt copies the last complete snapshot. It is overwritten once the
+ * writer starts filling snapshots twice, or once if it was filling the
+ * other one when the attempt started */
+static bool _expectedRead(const TEST_SCHEDULE *schedule, uint8_t *attempts)
+{
+    uint8_t phase = testState.phase;
+    uint8_t attempt, step, starts;
+    bool filling;
+
+    for (attempt = 0U; attempt < TEST_ATTEMPTS; attempt++)
+    {
+        filling = (phase != TEST_PHASE_END);
+        starts = 0U;
+        for (step = 0U; step < schedule->steps[attempt]; step++)
+        {
+            if (phase == TEST_PHASE_END)
+            {
+                starts++;
+            }
+            phase = (phase + 1U) % TEST_PHASES;
+        }
+
+        if (starts <= ((filling == true) ? 0U : 1U))
+        {
+            *attempts = attempt + 1U;
+            return true;
+        }
+    }
+
+    *attempts = TEST_ATTEMPTS;
+    return false;
+}
+
+static void _testRead(const TEST_SCHEDULE *schedule)
+{
+    DRV_METROLOGY_SNAPSHOT snapshot;
+    uint32_t completedAtStart;
+    uint8_t expectedAttempts;
+    bool expected;
+    bool result;
+
+    _writerRunTo(schedule->startPhase);
+    completedAtStart = testState.completed;
+    expected = _expectedRead(schedule, &expectedAttempts);
+
+    testState.schedule = schedule;
+    testState.inReader = true;
+    testState.attempts = 0U;
+    result = DRV_METROLOGY_GetSnapshot(&snapshot);
+    testState.inReader = false;
+    testState.schedule = NULL;
+    testState.reads++;
+
+    if (result != expected)
+    {
+        _fail((result == true) ? "snapshot accepted after being overwritten in every attempt, read" :
+                "snapshot rejected with an attempt not overwritten, read", testState.reads);
+        return;
+    }
+
+    if (testState.attempts != expectedAttempts)
+    {
+        _fail("snapshot copies of the read, expected", expectedAttempts);
+    }
+
+    if (result == false)
+    {
+        testState.rejected++;
+        return;
+    }
+
+    testState.accepted++;
+    if (_matches(&snapshot) == false)
+    {
+        _fail("accepted snapshot mixes periods, sequence", snapshot.sequence);
+    }
+    else if (snapshot.sequence < completedAtStart)
+    {
+        _fail("accepted snapshot older than the one completed before the read, sequence", snapshot.sequence);
+    }
+    else if (snapshot.sequence > testState.completed)
+    {
+        _fail("accepted snapshot of a period not completed, sequence", snapshot.sequence);
+    }
+    else if (snapshot.sequence < testState.completed)
+    {
+        testState.previous++;
+    }
+    else
+    {
+        /* Snapshot of the last complete period */
+    }
+}
+
+static uint8_t _randomSteps(void)
+{
+    uint32_t r = (uint32_t)(_rand64() % 10U);
+
+    if (r < 4U)
+    {
+        return 0U;
+    }
+
+    if (r < 8U)
+    {
+        return (uint8_t)(1U + (_rand64() % 3U));
+    }
+
+    return (uint8_t)(4U + (_rand64() % 5U));
+}
+
+static bool _testInterleavings(uint32_t randomReads)
+{
+    TEST_SCHEDULE schedule;
+    uint32_t phase, s0, s1, word, idx;
+
+    for (phase = 0U; phase < TEST_PHASES; phase++)
+    {
+        for (s0 = 0U; s0 <= TEST_MAX_STEPS; s0++)
+        {
+            for (s1 = 0U; s1 <= TEST_MAX_STEPS; s1++)
+            {
+                for (word = 0U; word <= TEST_SNAPSHOT_WORDS; word++)
+                {
+                    schedule.startPhase = (uint8_t)phase;
+                    schedule.steps[0] = (uint8_t)s0;
+                    schedule.steps[1] = (uint8_t)s1;
+                    schedule.steps[2] = _randomSteps();
+                    schedule.copyWord[0] = (uint8_t)word;
+                    schedule.copyWord[1] = (uint8_t)(_rand64() % (TEST_SNAPSHOT_WORDS + 1U));
+                    schedule.copyWord[2] = (uint8_t)(_rand64() % (TEST_SNAPSHOT_WORDS + 1U));
+                    _testRead(&schedule);
+                }
+            }
+        }
+    }
+
+    for (idx = 0U; idx < randomReads; idx++)
+    {
+        schedule.startPhase = (uint8_t)(_rand64() % TEST_PHASES);
+        for (word = 0U; word < TEST_ATTEMPTS; word++)
+        {
+            schedule.steps[word] = _randomSteps();
+            schedule.copyWord[word] = (uint8_t)(_rand64() % (TEST_SNAPSHOT_WORDS + 1U));
+        }
+        _testRead(&schedule);
+    }
+
+    printf("reads %u: accepted %u (%u of the previous period), rejected %u, periods %u\n",
+            (unsigned)testState.reads, (unsigned)testState.accepted, (unsigned)testState.previous,
+            (unsigned)testState.rejected, (unsigned)testState.period);
+
+    return (testState.fails == 0U);
+}
+
+static void _getRMS(int32_t *rms, uint8_t first, uint8_t last)
+{
+    uint8_t type;
+    uint32_t value;
+
+    for (type = first; type < last; type++)
+    {
+        value = DRV_METROLOGY_GetRMSValue((DRV_METROLOGY_RMS_TYPE)type);
+        if (DRV_METROLOGY_GetRMSSign((DRV_METROLOGY_RMS_TYPE)type) == RMS_SIGN_NEGATIVE)
+        {
+            rms[type] = -(int32_t)value;
+        }
+        else
+        {
+            rms[type] = (int32_t)value;
+        }
+    }
+}
+
+/* The values read one by one belong to two periods if the driver task runs
+ * between two of the calls */
+static void _testGetters(uint32_t reads)
+{
+    int32_t rms[RMS_TYPE_NUM];
+    const DRV_METROLOGY_SNAPSHOT *before, *after;
+    uint32_t idx, mixed = 0U;
+    uint8_t split;
+
+    _writerRunTo(TEST_PHASE_END);
+
+    for (idx = 0U; idx < reads; idx++)
+    {
+        split = (uint8_t)(1U + (_rand64() % ((uint32_t)RMS_TYPE_NUM - 1U)));
+        before = &testTable[(testState.completed - 1U) % TEST_TABLE_SIZE];
+        after = &testTable[testState.completed % TEST_TABLE_SIZE];
+
+        _getRMS(rms, 0U, split);
+        _writerRunTo(TEST_PHASE_END);
+        _getRMS(rms, split, (uint8_t)RMS_TYPE_NUM);
+
+        if ((memcmp(rms, before->RMS, sizeof(rms)) != 0) && (memcmp(rms, after->RMS, sizeof(rms)) != 0))
+        {
+            mixed++;
+        }
+    }
+
+    printf("reads of the RMS values one by one preempted by the task: %u of %u mix two periods\n",
+            (unsigned)mixed, (unsigned)reads);
+}
+
+static double _elapsedNs(const struct timespec *start)
+{
+    struct timespec end;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &end);
+    return ((double)(end.tv_sec - start->tv_sec) * 1e9) + (double)(end.tv_nsec - start->tv_nsec);
+}
+
+static void _benchmark(uint32_t reads)
+{
+    DRV_METROLOGY_SNAPSHOT snapshot;
+    int32_t rms[RMS_TYPE_NUM];
+    struct timespec start;
+    double snapshotNs, gettersNs;
+    uint32_t idx;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    for (idx = 0U; idx < reads; idx++)
+    {
+        (void) DRV_METROLOGY_GetSnapshot(&snapshot);
+        testSink = snapshot.RMS[idx % (uint32_t)RMS_TYPE_NUM];
+    }
+    snapshotNs = _elapsedNs(&start) / (double)reads;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    for (idx = 0U; idx < reads; idx++)
+    {
+        _getRMS(rms, 0U, (uint8_t)RMS_TYPE_NUM);
+        testSink = rms[idx % (uint32_t)RMS_TYPE_NUM];
+    }
+    gettersNs = _elapsedNs(&start) / (double)reads;
+
+    printf("read of all the values: snapshot %.1f ns, %u value and sign calls %.1f ns (x%.1f)\n", snapshotNs,
+            (unsigned)RMS_TYPE_NUM, gettersNs, gettersNs / snapshotNs);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t reads = TEST_DEFAULT_READS;
+    bool pass;
+
+    if (argc > 1)
+    {
+        reads = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    printf("Snapshot %u words, pattern of %u periods\n", (unsigned)TEST_SNAPSHOT_WORDS, TEST_TABLE_SIZE);
+
+    pass = _buildTable();
+    if (pass == true)
+    {
+        pass = _testInterleavings(reads);
+    }
+
+    if (pass == true)
+    {
+        _testGetters(10000U);
+        _benchmark(TEST_BENCH_READS);
+    }
+
+    printf("%s\n", (pass == true) ? "PASS" : "FAIL");
+    return (pass == true) ? 0 : 1;
+}
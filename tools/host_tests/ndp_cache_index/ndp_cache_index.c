@@ -0,0 +1,641 @@
+/*******************************************************************************
+  NDP cache index test
+
+  File Name:
+    ndp_cache_index.c
+
+  Summary:
+    Host test of the NDP neighbor and destination cache hash index.
+
+  Description:
+    ndp.c of the G3 coordinator UDP application is built for the host with
+    its own configuration, together with the open addressing hash and the
+    stack helpers. IPv6, ICMPv6 and the stack manager are replaced by stubs;
+    the interface has a single IPv6 configuration whose neighbor and
+    destination cache lists are managed by NDP. The TCP/IP heap is replaced
+    by the host heap, with a count of the blocks in use to detect leaks.
+
+    Random neighbor and destination cache creations and deletions over a pool
+    of more G3-PLC link-local addresses than there are index slots, with some
+    duplicate neighbors, are checked after every step:
+    TCPIP_NDP_RemoteNodeFind must return a node of the list with the address
+    for every address of the pool, and NULL only if the list has none.
+
+    The benchmark then fills the neighbor cache with 25%, 50%, 75% and 100%
+    of the index slots in devices and measures the lookups per second of
+    TCPIP_NDP_RemoteNodeFind for present and absent addresses, against a
+    search of the list as NDP does without the index, and the longest probe
+    sequence of the index. From TEST_BENCH_MIN_DEVICES neighbors, below which
+    the list search is as fast, up to the TEST_BENCH_MAX_LOAD sizing rule of
+    the configuration the index must be faster than the list. Built with
+    TEST_HASH_ENTRIES, the index has that number of slots instead of the
+    ones of the configuration.
+
+    Usage:
+      ndp_cache_index [lookups]     test and benchmark (2000000 lookups by default)
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "configuration.h"
+
+#ifdef TEST_HASH_ENTRIES
+#undef TCPIP_IPV6_NDP_NC_HASH_ENTRIES
+#define TCPIP_IPV6_NDP_NC_HASH_ENTRIES      TEST_HASH_ENTRIES
+#undef TCPIP_IPV6_NDP_DC_HASH_ENTRIES
+#define TCPIP_IPV6_NDP_DC_HASH_ENTRIES      TEST_HASH_ENTRIES
+#endif
+
+#include "tcpip/src/ndp.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_PAN_ID             0x781DU
+#define TEST_POOL               64U
+#define TEST_STEPS              20000U
+#define TEST_BENCH_DESTINATIONS 1024U
+
+/* Load factor (percent) the configurations are sized for */
+#define TEST_BENCH_MAX_LOAD     75U
+/* Neighbors from which the index must beat the list search */
+#define TEST_BENCH_MIN_DEVICES  48U
+#define TEST_BENCH_LOOKUPS      2000000UL
+
+typedef struct
+{
+    TCPIP_NET_IF            net;
+    IPV6_INTERFACE_CONFIG   ipv6Config;
+    unsigned int            nHeapBlocks;
+} TEST_DATA;
+
+static TEST_DATA testData;
+
+static uint32_t testRandom = 0x2545F491UL;
+
+const IPV6_ADDR IPV6_FIXED_ADDR_UNSPECIFIED = {{0}};
+const IPV6_ADDR IPV6_FIXED_ADDR_ALL_NODES_MULTICAST = {{0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01}};
+const IPV6_ADDR IPV6_FIXED_ADDR_ALL_ROUTER_MULTICAST = {{0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02}};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Host Heap
+// *****************************************************************************
+// *****************************************************************************
+
+static void* _testMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    void* ptr = malloc(nBytes);
+
+    if (ptr != NULL)
+    {
+        testData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static void* _testCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* ptr = calloc(nElems, elemSize);
+
+    if (ptr != NULL)
+    {
+        testData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static size_t _testFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{
+    if (pBuff != NULL)
+    {
+        testData.nHeapBlocks--;
+        free((void*)pBuff);
+    }
+
+    return 0;
+}
+
+static const TCPIP_HEAP_OBJECT testHeap =
+{
+    .TCPIP_HEAP_Malloc = _testMalloc,
+    .TCPIP_HEAP_Calloc = _testCalloc,
+    .TCPIP_HEAP_Free = _testFree,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Stack Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+IPV6_INTERFACE_CONFIG* TCPIP_IPV6_InterfaceConfigGet(const TCPIP_NET_IF* pNetIf)
+{
+    return &testData.ipv6Config;
+}
+
+int TCPIP_STACK_NetIxGet(const TCPIP_NET_IF* pNetIf)
+{
+    return 0;
+}
+
+TCPIP_NET_HANDLE TCPIP_STACK_IndexToNet(int netIx)
+{
+    return &testData.net;
+}
+
+bool TCPIP_IPV6_InterfaceIsReady(TCPIP_NET_HANDLE netH)
+{
+    return false;
+}
+
+const IPV6_ADDR* TCPIP_IPV6_DefaultRouterGet(TCPIP_NET_HANDLE netH)
+{
+    return NULL;
+}
+
+IPV6_ADDR_STRUCT* TCPIP_IPV6_DASSourceAddressSelect(TCPIP_NET_HANDLE hNetIf, const IPV6_ADDR* dest,
+        const IPV6_ADDR* requestedSource)
+{
+    return NULL;
+}
+
+IPV6_ADDR_STRUCT* TCPIP_IPV6_UnicastAddressAdd(TCPIP_NET_HANDLE netH, const IPV6_ADDR* address, int prefixLen,
+        uint8_t skipProcessing)
+{
+    return NULL;
+}
+
+void TCPIP_IPV6_ClientsNotify(TCPIP_NET_IF* pNetIf, IPV6_EVENT_TYPE evType, const void* evParam)
+{
+}
+
+unsigned short TCPIP_IPV6_ArrayPutHelper(IPV6_PACKET* pkt, const void* dataSource, uint8_t dataType,
+        unsigned short len)
+{
+    return 0;
+}
+
+unsigned short TCPIP_IPV6_TxIsPutReady(IPV6_PACKET* pkt, unsigned short count)
+{
+    return 0;
+}
+
+bool TCPIP_IPV6_PacketTransmit(IPV6_PACKET* pkt)
+{
+    return false;
+}
+
+void TCPIP_IPV6_PacketFree(IPV6_PACKET* pkt)
+{
+}
+
+bool TCPIP_ICMPV6_Flush(IPV6_PACKET* pkt)
+{
+    return false;
+}
+
+void TCPIP_ICMPV6_G3AdvertisementSelect(TCPIP_NET_IF* pNetIf, const IPV6_ADDR_STRUCT** pLclStruct,
+        const IPV6_ADDR_STRUCT** pAdvStruct)
+{
+    *pLclStruct = NULL;
+    *pAdvStruct = NULL;
+}
+
+bool TCPIP_ICMPV6_G3RouterAdvertisementPut(const TCPIP_NET_IF* pNetIf, const IPV6_ADDR* localIP,
+        const IPV6_ADDR* remoteIP, const IPV6_ADDR_STRUCT* advIP)
+{
+    return false;
+}
+
+IPV6_PACKET* TCPIP_ICMPV6_HeaderNeighborSolicitationPut(TCPIP_NET_IF* pNetIf, IPV6_ADDR* localIP, IPV6_ADDR* remoteIP,
+        IPV6_ADDR* targetAddr)
+{
+    return NULL;
+}
+
+IPV6_PACKET* TCPIP_ICMPV6_HeaderRouterSolicitationPut(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* localIP,
+        const IPV6_ADDR* remoteIP)
+{
+    return NULL;
+}
+
+TCPIP_MAC_DATA_SEGMENT* TCPIP_PKT_DataSegmentGet(TCPIP_MAC_PACKET* pPkt, const uint8_t* dataAddress, bool srchTransport)
+{
+    return NULL;
+}
+
+tcpipSignalHandle _TCPIPStackSignalHandlerRegister(TCPIP_STACK_MODULE modId, tcpipModuleSignalHandler signalHandler,
+        int16_t asyncTmoMs)
+{
+    return (tcpipSignalHandle)&testData;
+}
+
+void _TCPIPStackSignalHandlerDeregister(tcpipSignalHandle handle)
+{
+}
+
+void _TCPIPStack_Assert(bool cond, const char* fileName, const char* funcName, int lineNo)
+{
+    if (!cond)
+    {
+        printf("FAIL: assert in %s, line %d\n", funcName, lineNo);
+        exit(1);
+    }
+}
+
+uint32_t _TCPIP_SecCountGet(void)
+{
+    return 0;
+}
+
+uint32_t SYS_TMR_TickCountGet(void)
+{
+    return 0;
+}
+
+uint32_t SYS_TMR_TickCounterFrequencyGet(void)
+{
+    return 1000;
+}
+
+bool SYS_INT_Disable(void)
+{
+    return true;
+}
+
+void SYS_INT_Restore(bool state)
+{
+}
+
+SYS_ERROR_LEVEL SYS_DEBUG_ErrorLevelGet(void)
+{
+    return SYS_ERROR_ERROR;
+}
+
+SYS_MODULE_INDEX SYS_DEBUG_ConsoleInstanceGet(void)
+{
+    return 0;
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t _random(void)
+{
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+/* G3-PLC link-local address: fe80::PAN_id:00ff:fe00:short_address */
+static void _setAddress(IPV6_ADDR* pAddress, unsigned int shortAddress)
+{
+    memset(pAddress, 0, sizeof(*pAddress));
+    pAddress->v[0] = 0xFE;
+    pAddress->v[1] = 0x80;
+    pAddress->v[8] = (uint8_t)(TEST_PAN_ID >> 8);
+    pAddress->v[9] = (uint8_t)TEST_PAN_ID;
+    pAddress->v[11] = 0xFF;
+    pAddress->v[12] = 0xFE;
+    pAddress->v[14] = (uint8_t)(shortAddress >> 8);
+    pAddress->v[15] = (uint8_t)shortAddress;
+}
+
+/* NC and DC entries both start with the next pointer */
+static const IPV6_ADDR* _nodeAddress(const void* pNode, uint8_t type)
+{
+    return (type == IPV6_HEAP_NDP_NC_ID) ?
+            &((const IPV6_HEAP_NDP_NC_ENTRY*)pNode)->remoteIPAddress : &((const IPV6_HEAP_NDP_DC_ENTRY*)pNode)->remoteIPAddress;
+}
+
+/* Search of the list, as TCPIP_NDP_RemoteNodeFind does without the index */
+static void* _listFind(const SINGLE_LIST* pList, const IPV6_ADDR* pAddress, uint8_t type)
+{
+    void* node;
+
+    for (node = pList->head; node != NULL; node = ((SGL_LIST_NODE*)node)->next)
+    {
+        if (memcmp(_nodeAddress(node, type), pAddress, sizeof(IPV6_ADDR)) == 0)
+        {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+static bool _listContains(const SINGLE_LIST* pList, const void* pNode)
+{
+    void* node;
+
+    for (node = pList->head; node != NULL; node = ((SGL_LIST_NODE*)node)->next)
+    {
+        if (node == pNode)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void* _listNode(const SINGLE_LIST* pList, unsigned int ix)
+{
+    void* node = pList->head;
+
+    while ((node != NULL) && (ix-- != 0U))
+    {
+        node = ((SGL_LIST_NODE*)node)->next;
+    }
+
+    return node;
+}
+
+/* Every address of the pool is found by the index as in the list */
+static int _checkPool(const IPV6_ADDR* pool, unsigned int step)
+{
+    static const uint8_t types[] = {IPV6_HEAP_NDP_NC_ID, IPV6_HEAP_NDP_DC_ID};
+    unsigned int ix, tx;
+
+    for (tx = 0; tx < sizeof(types); tx++)
+    {
+        const SINGLE_LIST* pList = (types[tx] == IPV6_HEAP_NDP_NC_ID) ?
+                &testData.ipv6Config.listNeighborCache : &testData.ipv6Config.listDestinationCache;
+
+        for (ix = 0; ix < TEST_POOL; ix++)
+        {
+            void* pFound = TCPIP_NDP_RemoteNodeFind(&testData.net, &pool[ix], types[tx]);
+            void* pRef = _listFind(pList, &pool[ix], types[tx]);
+
+            /* With duplicate neighbors, any node of the list with the address */
+            if ((pRef == NULL) ? (pFound != NULL) :
+                    ((pFound == NULL) || (_listContains(pList, pFound) == false) ||
+                     (memcmp(_nodeAddress(pFound, types[tx]), &pool[ix], sizeof(IPV6_ADDR)) != 0)))
+            {
+                printf("FAIL: step %u, %s address %u: found %p, list %p\n", step,
+                        (types[tx] == IPV6_HEAP_NDP_NC_ID) ? "NC" : "DC", ix, pFound, pRef);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int _testIndex(void)
+{
+    IPV6_ADDR pool[TEST_POOL];
+    SINGLE_LIST* pNcList = &testData.ipv6Config.listNeighborCache;
+    SINGLE_LIST* pDcList = &testData.ipv6Config.listDestinationCache;
+    unsigned long nOps[5] = {0};
+    unsigned int step, ix, maxNc = 0, maxDc = 0;
+
+    for (ix = 0; ix < TEST_POOL; ix++)
+    {
+        _setAddress(&pool[ix], ix + 1U);
+    }
+
+    for (step = 0; step < TEST_STEPS; step++)
+    {
+        unsigned int op = _random() % 100U;
+        const IPV6_ADDR* pAddress = &pool[_random() % TEST_POOL];
+
+        if (op < 35U)
+        {   /* new neighbor, mostly for an address not in the cache */
+            if ((_listFind(pNcList, pAddress, IPV6_HEAP_NDP_NC_ID) == NULL) || ((_random() % 8U) == 0U))
+            {
+                TCPIP_NDP_NborEntryCreate(&testData.net, pAddress, NULL, NDP_STATE_REACHABLE, 0, NULL);
+                nOps[0]++;
+            }
+        }
+        else if (op < 55U)
+        {   /* neighbor deleted, with the destinations through it */
+            if (pNcList->nNodes != 0)
+            {
+                TCPIP_NDP_NborEntryDelete(&testData.net, _listNode(pNcList, _random() % pNcList->nNodes));
+                nOps[1]++;
+            }
+        }
+        else if (op < 85U)
+        {   /* destination through a neighbor, created or updated */
+            if (pNcList->nNodes != 0)
+            {
+                TCPIP_NDP_DestCacheEntryCreate(&testData.net, pAddress, TCPIP_IPV6_DEFAULT_LINK_MTU,
+                        _listNode(pNcList, _random() % pNcList->nNodes));
+                nOps[2]++;
+            }
+        }
+        else if (op < 99U)
+        {   /* destination deleted */
+            if (pDcList->nNodes != 0)
+            {
+                TCPIP_NDP_LinkedListEntryRemove(&testData.net, _listNode(pDcList, _random() % pDcList->nNodes),
+                        IPV6_HEAP_NDP_DC_ID);
+                nOps[3]++;
+            }
+        }
+        else
+        {   /* all the destinations deleted */
+            while (pDcList->nNodes != 0)
+            {
+                TCPIP_NDP_LinkedListEntryRemove(&testData.net, pDcList->head, IPV6_HEAP_NDP_DC_ID);
+            }
+            nOps[4]++;
+        }
+
+        if (pNcList->nNodes > maxNc)
+        {
+            maxNc = pNcList->nNodes;
+        }
+
+        if (pDcList->nNodes > maxDc)
+        {
+            maxDc = pDcList->nNodes;
+        }
+
+        if (_checkPool(pool, step) != 0)
+        {
+            return 1;
+        }
+    }
+
+    while (pNcList->nNodes != 0)
+    {
+        TCPIP_NDP_NborEntryDelete(&testData.net, (IPV6_HEAP_NDP_NC_ENTRY*)pNcList->head);
+    }
+
+    printf("index: %u steps over %u addresses, %u slots: %lu NC and %lu DC creations, %lu and %lu deletions, "
+            "%lu DC flushes, up to %u NC and %u DC entries\n", TEST_STEPS, TEST_POOL,
+            (unsigned int)TCPIP_IPV6_NDP_NC_HASH_ENTRIES, nOps[0], nOps[2], nOps[1], nOps[3], nOps[4], maxNc, maxDc);
+    return 0;
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static int _benchmark(unsigned long nLookups, unsigned int nDevices)
+{
+    static IPV6_ADDR present[TEST_BENCH_DESTINATIONS], absent[TEST_BENCH_DESTINATIONS];
+    static uint16_t order[TEST_BENCH_DESTINATIONS * 4U];
+    SINGLE_LIST* pNcList = &testData.ipv6Config.listNeighborCache;
+    unsigned long ix, nFound[4] = {0};
+    unsigned int jx;
+    double start, tIndex[2], tList[2];
+    size_t maxProbes;
+    int res = 0;
+
+    for (jx = 0; jx < nDevices; jx++)
+    {
+        _setAddress(&present[jx], jx + 1U);
+        _setAddress(&absent[jx], jx + 1U + TEST_BENCH_DESTINATIONS);
+        if (TCPIP_NDP_NborEntryCreate(&testData.net, &present[jx], NULL, NDP_STATE_REACHABLE, 0, NULL) == NULL)
+        {
+            printf("FAIL: benchmark: neighbor %u not created\n", jx);
+            return 1;
+        }
+    }
+
+    for (jx = 0; jx < (sizeof(order) / sizeof(order[0])); jx++)
+    {
+        order[jx] = (uint16_t)(_random() % nDevices);
+    }
+
+    /* Present addresses, then absent ones: index, then list */
+    for (jx = 0; jx < 2U; jx++)
+    {
+        const IPV6_ADDR* pAddresses = (jx == 0U) ? present : absent;
+
+        start = _seconds();
+        for (ix = 0; ix < nLookups; ix++)
+        {
+            if (TCPIP_NDP_RemoteNodeFind(&testData.net, &pAddresses[order[ix % (sizeof(order) / sizeof(order[0]))]],
+                    IPV6_HEAP_NDP_NC_ID) != NULL)
+            {
+                nFound[jx]++;
+            }
+        }
+        tIndex[jx] = _seconds() - start;
+
+        start = _seconds();
+        for (ix = 0; ix < nLookups; ix++)
+        {
+            if (_listFind(pNcList, &pAddresses[order[ix % (sizeof(order) / sizeof(order[0]))]],
+                    IPV6_HEAP_NDP_NC_ID) != NULL)
+            {
+                nFound[2U + jx]++;
+            }
+        }
+        tList[jx] = _seconds() - start;
+    }
+
+    maxProbes = gNdpCacheIndex[0].ncHash->maxProbes;
+
+    while (pNcList->nNodes != 0)
+    {
+        TCPIP_NDP_NborEntryDelete(&testData.net, (IPV6_HEAP_NDP_NC_ENTRY*)pNcList->head);
+    }
+
+    if ((nFound[0] != nLookups) || (nFound[1] != 0U) || (nFound[2] != nLookups) || (nFound[3] != 0U))
+    {
+        printf("FAIL: benchmark: index found %lu present and %lu absent, list %lu and %lu\n", nFound[0], nFound[1], nFound[2], nFound[3]);
+        return 1;
+    }
+
+    printf("benchmark: %lu lookups, %u neighbors, %u slots (load %u%%), max probes %u\n", nLookups, nDevices,
+            (unsigned int)TCPIP_IPV6_NDP_NC_HASH_ENTRIES, (nDevices * 100U) / TCPIP_IPV6_NDP_NC_HASH_ENTRIES,
+            (unsigned int)maxProbes);
+    printf("  present: list %6.2f M/s, index %6.2f M/s\n", (double)nLookups / tList[0] / 1e6,
+            (double)nLookups / tIndex[0] / 1e6);
+    printf("  absent:  list %6.2f M/s, index %6.2f M/s\n", (double)nLookups / tList[1] / 1e6,
+            (double)nLookups / tIndex[1] / 1e6);
+
+    if ((nDevices >= TEST_BENCH_MIN_DEVICES) &&
+            ((nDevices * 100U) <= (TCPIP_IPV6_NDP_NC_HASH_ENTRIES * TEST_BENCH_MAX_LOAD)) &&
+            ((tIndex[0] >= tList[0]) || (tIndex[1] >= tList[1])))
+    {
+        printf("FAIL: benchmark: index not faster than the list\n");
+        res = 1;
+    }
+
+    return res;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    TCPIP_STACK_MODULE_CTRL stackCtrl;
+    unsigned long nLookups = TEST_BENCH_LOOKUPS;
+    unsigned int nInitBlocks, load;
+    int nErrors = 0;
+
+    if (argc > 1)
+    {
+        nLookups = strtoul(argv[1], NULL, 0);
+    }
+
+    memset(&testData, 0, sizeof(testData));
+    testData.net.Flags.bInterfaceEnabled = true;
+    testData.net.startFlags = TCPIP_NETWORK_CONFIG_IPV6_G3_NET;
+    testData.ipv6Config.g3PanId = TEST_PAN_ID;
+    testData.ipv6Config.g3PanIdSet = 1;
+
+    memset(&stackCtrl, 0, sizeof(stackCtrl));
+    stackCtrl.memH = &testHeap;
+    stackCtrl.nIfs = 1;
+    stackCtrl.pNetIf = &testData.net;
+    stackCtrl.stackAction = TCPIP_STACK_ACTION_INIT;
+
+    if (TCPIP_NDP_Initialize(&stackCtrl, NULL) == false)
+    {
+        printf("FAIL: NDP initialization\n");
+        return 1;
+    }
+    nInitBlocks = testData.nHeapBlocks;
+
+    nErrors += _testIndex();
+    for (load = 25U; load <= 100U; load += 25U)
+    {
+        nErrors += _benchmark(nLookups, (TCPIP_IPV6_NDP_NC_HASH_ENTRIES * load) / 100U);
+    }
+
+    if (testData.nHeapBlocks != nInitBlocks)
+    {
+        printf("FAIL: %d heap blocks not released\n", (int)(testData.nHeapBlocks - nInitBlocks));
+        nErrors++;
+    }
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
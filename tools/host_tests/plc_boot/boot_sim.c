@@ -0,0 +1,318 @@
+/*******************************************************************************
+  PL460 boot simulation for the PLC boot test
+
+  File Name:
+    boot_sim.c
+
+  Summary:
+    One build of drv_plc_boot.c booting a timed model of the PL460.
+
+  Description:
+    BOOT_SIM_FRAGS_PER_TASK and BOOT_SIM_RESIDENT_CHECK, if defined, replace
+    DRV_PLC_BOOT_FRAGS_PER_TASK and DRV_PLC_BOOT_RESIDENT_CHECK of the
+    configuration and BOOT_SIM_NAME names the exported simulation object.
+
+    The PLC HAL is replaced by a model of drv_plc_hal.c: a boot command
+    copies its data from flash to the SPI buffer, waits for the previous SPI
+    transfer and starts the DMA transfer, and only waits for it to end when
+    it reads data back. With the double buffered HAL the copy overlaps the
+    previous transfer; with a single buffer it waits for it first, as
+    drv_plc_hal.c did before. READ_BUF returns the program memory of the
+    PL460. The reset pulse takes the 1050 us of the HAL and keeps the program
+    memory. When the bootloader is left with the CPU not held, the PL460 runs
+    its program memory: 1.5 ms later the external interrupt pin goes low
+    and, if the program memory holds the image, the firmware answers with
+    the Cortex key. Otherwise it never answers.
+
+    Time only advances in the HAL, in the CRC32 of the driver, charged at a
+    fixed rate per byte wherever the driver computes it, and between main
+    loop calls to DRV_PLC_BOOT_Tasks. The Makefile renames the CRC32
+    function of the driver (drv_plc_boot_host.c) so that it is called
+    through the timed one below.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "boot_sim.h"
+#include "configuration.h"
+
+#ifdef BOOT_SIM_FRAGS_PER_TASK
+#undef DRV_PLC_BOOT_FRAGS_PER_TASK
+#define DRV_PLC_BOOT_FRAGS_PER_TASK         BOOT_SIM_FRAGS_PER_TASK
+#endif
+
+#ifdef BOOT_SIM_RESIDENT_CHECK
+#undef DRV_PLC_BOOT_RESIDENT_CHECK
+#define DRV_PLC_BOOT_RESIDENT_CHECK         BOOT_SIM_RESIDENT_CHECK
+#endif
+
+#if defined(DRV_PLC_BOOT_RESIDENT_CHECK) && (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+static void _crcTime(uint32_t bytes);
+static uint32_t lDRV_PLC_BOOT_UpdateCrc32Driver(uint32_t crc, const uint8_t *pData, uint32_t length);
+
+static uint32_t lDRV_PLC_BOOT_UpdateCrc32(uint32_t crc, const uint8_t *pData, uint32_t length)
+{
+    _crcTime(length);
+    return lDRV_PLC_BOOT_UpdateCrc32Driver(crc, pData, length);
+}
+#endif
+
+#include "drv_plc_boot_host.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* HAL_SPI_BUFFER_SIZE of drv_plc_hal.c minus the boot command header */
+#define SIM_BOOT_DATA_MAX       628U
+#define SIM_BOOT_HEADER_SIZE    6U
+#define SIM_WRRD_HEADER_SIZE    4U
+
+/* Reset pulse of DRV_PLC_HAL_Reset */
+#define SIM_RESET_US            1050.0
+
+/* PL460 firmware start up, from the end of the bootloader to the Cortex key */
+#define SIM_STARTUP_US          1500.0
+
+/* PL460 program memory */
+#define SIM_PROGRAM_SIZE        (192U * 1024U)
+
+/* Boot not finished after this long is a failure */
+#define SIM_TIMEOUT_US          5000000.0
+
+typedef struct
+{
+    const BOOT_SIM_MODEL* model;
+    const uint8_t* image;
+    uint32_t imageSize;
+    double now;
+    double spiBusyUntil;
+    double firmwareReadyAt;
+    bool cpuWait;
+    bool firmwareRunning;
+    uint32_t bytesUploaded;
+    uint8_t program[SIM_PROGRAM_SIZE];
+} SIM_PL460;
+
+static SIM_PL460 simPl460;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: PLC HAL Model
+// *****************************************************************************
+// *****************************************************************************
+
+static void _spiWait(void)
+{
+    if (simPl460.now < simPl460.spiBusyUntil)
+    {
+        simPl460.now = simPl460.spiBusyUntil;
+    }
+}
+
+static double _spiUS(uint32_t bytes)
+{
+    return ((double) bytes * 8.0 * 1e6) / simPl460.model->spiHz;
+}
+
+static void _crcTime(uint32_t bytes)
+{
+    simPl460.now += ((double) bytes * simPl460.model->crcNsPerByte) / 1000.0;
+}
+
+static void _halReset(void)
+{
+    _spiWait();
+    simPl460.cpuWait = false;
+    simPl460.firmwareRunning = false;
+    simPl460.now += SIM_RESET_US;
+}
+
+static void _halSetup(bool set16Bits)
+{
+    (void) set16Bits;
+    _spiWait();
+}
+
+static void _halDelay(uint32_t us)
+{
+    simPl460.now += (double) us;
+}
+
+static void _halSendBootCmd(uint16_t cmd, uint32_t addr, uint32_t dataLength, void* pDataWr, void* pDataRd)
+{
+    if (simPl460.model->halDoubleBuffer == false)
+    {
+        _spiWait();
+    }
+
+    if (dataLength > SIM_BOOT_DATA_MAX)
+    {
+        dataLength = SIM_BOOT_DATA_MAX;
+    }
+
+    /* Command header and copy of the data to the SPI buffer, then DMA */
+    simPl460.now += simPl460.model->cmdUS + (((double) dataLength * 1e6) / simPl460.model->flashBps);
+    _spiWait();
+    simPl460.spiBusyUntil = simPl460.now + _spiUS(dataLength + SIM_BOOT_HEADER_SIZE);
+
+    if ((cmd == (uint16_t) DRV_PLC_BOOT_CMD_WRITE_BUF) && (pDataWr != NULL) &&
+            ((addr + dataLength) <= SIM_PROGRAM_SIZE))
+    {
+        (void) memcpy(&simPl460.program[addr], pDataWr, dataLength);
+        simPl460.bytesUploaded += dataLength;
+    }
+    else if ((cmd == (uint16_t) DRV_PLC_BOOT_CMD_WRITE_WORD) && (addr == PLC_MISCR) && (pDataWr != NULL))
+    {
+        uint32_t value;
+
+        (void) memcpy(&value, pDataWr, sizeof(value));
+        simPl460.cpuWait = ((value & PLC_MISCR_CPUWAIT) != 0U);
+    }
+    else if ((cmd == (uint16_t) DRV_PLC_BOOT_CMD_DIS_SPI_CLK_CTRL) && (simPl460.cpuWait == false))
+    {
+        /* Bootloader left: the CPU runs the program memory */
+        simPl460.firmwareRunning = (memcmp(simPl460.program, simPl460.image, simPl460.imageSize) == 0);
+        simPl460.firmwareReadyAt = simPl460.spiBusyUntil + SIM_STARTUP_US;
+    }
+    else
+    {
+        /* No effect on the model */
+    }
+
+    if ((pDataRd != NULL) && (dataLength > 0U))
+    {
+        simPl460.now = simPl460.spiBusyUntil;
+        if ((cmd == (uint16_t) DRV_PLC_BOOT_CMD_READ_BUF) && ((addr + dataLength) <= SIM_PROGRAM_SIZE))
+        {
+            (void) memcpy(pDataRd, &simPl460.program[addr], dataLength);
+        }
+        else
+        {
+            (void) memset(pDataRd, 0, dataLength);
+        }
+    }
+}
+
+static void _halSendWrRdCmd(void* pCmd, void* pInfo)
+{
+    DRV_PLC_HAL_CMD* halCmd = (DRV_PLC_HAL_CMD*) pCmd;
+    DRV_PLC_HAL_INFO* halInfo = (DRV_PLC_HAL_INFO*) pInfo;
+
+    _spiWait();
+    simPl460.now += simPl460.model->cmdUS + _spiUS((uint32_t) halCmd->length + SIM_WRRD_HEADER_SIZE);
+
+    halInfo->flags = 0U;
+    if ((simPl460.firmwareRunning == true) && (simPl460.now >= simPl460.firmwareReadyAt))
+    {
+        halInfo->key = DRV_PLC_HAL_KEY_CORTEX;
+    }
+    else
+    {
+        halInfo->key = 0U;
+    }
+}
+
+static bool _halGetPinLevel(SYS_PORT_PIN pin)
+{
+    (void) pin;
+
+    /* External interrupt pin is high from the end of the bootloader until the
+     start up is over, whether the firmware runs or not */
+    return (simPl460.now < simPl460.firmwareReadyAt);
+}
+
+static DRV_PLC_PLIB_INTERFACE simPlib = {
+    .extIntPio = DRV_PLC_EXT_INT_PIO,
+};
+
+static DRV_PLC_HAL_INTERFACE simHal = {
+    .plcPlib = &simPlib,
+    .reset = _halReset,
+    .setup = _halSetup,
+    .delay = _halDelay,
+    .getPinLevel = _halGetPinLevel,
+    .sendBootCmd = _halSendBootCmd,
+    .sendWrRdCmd = _halSendWrRdCmd,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _boot(const uint8_t* image, uint32_t size, BOOT_SIM_START start, const BOOT_SIM_MODEL* model,
+    BOOT_SIM_RESULT* pResult)
+{
+    DRV_PLC_BOOT_INFO bootInfo;
+    double taskStart;
+
+    (void) memset(pResult, 0, sizeof(*pResult));
+    pResult->fragsPerTask = DRV_PLC_BOOT_FRAGS_PER_TASK;
+    pResult->residentCheck = (DRV_PLC_BOOT_RESIDENT_CHECK > 0U);
+
+    if (start == BOOT_SIM_POWER_ON)
+    {
+#if (DRV_PLC_BOOT_RESIDENT_CHECK > 0U)
+        /* Content of the RAM not initialized at power on */
+        (void) memset(&sDrvPlcBootResident, 0xA5, sizeof(sDrvPlcBootResident));
+#endif
+        (void) memset(simPl460.program, 0, sizeof(simPl460.program));
+    }
+    else if (start == BOOT_SIM_PL460_LOST)
+    {
+        (void) memset(simPl460.program, 0, sizeof(simPl460.program));
+    }
+    else if (start == BOOT_SIM_PL460_CORRUPTED)
+    {
+        /* Last byte of the image, always read back by the resident check */
+        simPl460.program[size - 1U] ^= 0x01U;
+    }
+    else
+    {
+        /* Host reset: PL460 keeps running from its program memory */
+    }
+
+    simPl460.model = model;
+    simPl460.image = image;
+    simPl460.imageSize = size;
+    simPl460.now = 0.0;
+    simPl460.spiBusyUntil = 0.0;
+    simPl460.firmwareReadyAt = 0.0;
+    simPl460.cpuWait = false;
+    simPl460.firmwareRunning = false;
+    simPl460.bytesUploaded = 0U;
+
+    (void) memset(&bootInfo, 0, sizeof(bootInfo));
+    bootInfo.binSize = size;
+    bootInfo.binStartAddress = (uint32_t) (uintptr_t) image;
+    bootInfo.secure = false;
+
+    DRV_PLC_BOOT_Start(&bootInfo, &simHal);
+
+    while ((DRV_PLC_BOOT_Status() < DRV_PLC_BOOT_STATUS_READY) && (simPl460.now < SIM_TIMEOUT_US))
+    {
+        taskStart = simPl460.now;
+        DRV_PLC_BOOT_Tasks();
+        pResult->tasks++;
+        if ((simPl460.now - taskStart) > pResult->maxTaskUS)
+        {
+            pResult->maxTaskUS = simPl460.now - taskStart;
+        }
+
+        simPl460.now += model->loopUS;
+    }
+
+    pResult->ready = (DRV_PLC_BOOT_Status() == DRV_PLC_BOOT_STATUS_READY);
+    pResult->imageOk = (memcmp(simPl460.program, image, size) == 0);
+    pResult->bootMS = simPl460.now / 1000.0;
+    pResult->bytesUploaded = simPl460.bytesUploaded;
+}
+
+const BOOT_SIM BOOT_SIM_NAME =
+{
+    _boot
+};
@@ -0,0 +1,67 @@
+/*******************************************************************************
+  PL460 boot simulation interface for the PLC boot test
+
+  File Name:
+    boot_sim.h
+
+  Summary:
+    Boot of the PL460 by one build of drv_plc_boot.c.
+
+  Description:
+    boot_sim.c is built twice, once with one fragment per task and without
+    the resident image check, and once with the options of the
+    configuration. Each build exports only its simulation object, so both
+    copies of the boot driver can be linked in the same test.
+*******************************************************************************/
+
+#ifndef BOOT_SIM_H
+#define BOOT_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    /* Host and PL460 powered up: PL460 memory and resident record lost */
+    BOOT_SIM_POWER_ON,
+    /* Host reset: PL460 memory and resident record kept */
+    BOOT_SIM_HOST_RESET,
+    /* Host reset while the PL460 lost its memory: resident record kept */
+    BOOT_SIM_PL460_LOST,
+    /* Host reset while one byte of the PL460 memory changed */
+    BOOT_SIM_PL460_CORRUPTED
+} BOOT_SIM_START;
+
+typedef struct
+{
+    double      spiHz;              /* SPI clock */
+    double      flashBps;           /* Flash read speed, bytes per second */
+    double      loopUS;             /* Rest of the main loop after each task */
+    double      cmdUS;              /* Software time of each SPI command */
+    double      crcNsPerByte;       /* CRC32 of the binary file */
+    bool        halDoubleBuffer;    /* Boot command built during the previous transfer */
+} BOOT_SIM_MODEL;
+
+typedef struct
+{
+    uint32_t    fragsPerTask;       /* DRV_PLC_BOOT_FRAGS_PER_TASK */
+    bool        residentCheck;      /* DRV_PLC_BOOT_RESIDENT_CHECK */
+    bool        ready;              /* Boot status READY */
+    bool        imageOk;            /* PL460 program memory holds the image */
+    double      bootMS;             /* Start to READY */
+    double      maxTaskUS;          /* Longest DRV_PLC_BOOT_Tasks call */
+    uint32_t    tasks;              /* DRV_PLC_BOOT_Tasks calls */
+    uint32_t    bytesUploaded;      /* Bytes written to program memory */
+} BOOT_SIM_RESULT;
+
+typedef struct
+{
+    /* Boot the image, which must be at a 32-bit address */
+    void (*boot)(const uint8_t* image, uint32_t size, BOOT_SIM_START start, const BOOT_SIM_MODEL* model,
+        BOOT_SIM_RESULT* pResult);
+} BOOT_SIM;
+
+extern const BOOT_SIM bootSimBase;
+extern const BOOT_SIM bootSimFast;
+
+#endif // BOOT_SIM_H
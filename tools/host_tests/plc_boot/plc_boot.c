@@ -0,0 +1,253 @@
+/*******************************************************************************
+  PL460 boot time test
+
+  File Name:
+    plc_boot.c
+
+  Summary:
+    Host test of the PL460 firmware upload and of the resident image check.
+
+  Description:
+    drv_plc_boot.c of the G3 coordinator (PIC32CX MTG, PL460 and RF215) is
+    built twice with its own configuration: once with one fragment per
+    task and without the resident image check, as the other configurations,
+    and once with DRV_PLC_BOOT_FRAGS_PER_TASK and DRV_PLC_BOOT_RESIDENT_CHECK
+    of the configuration. Both boot a timed model of the PL460 and its SPI
+    (see boot_sim.c) with the given binary file, for several main loop
+    periods: the base build with the single buffered HAL, the fast build
+    with the double buffered one.
+
+    Every boot must end READY with the image in the program memory of the
+    PL460. From power on, both builds must upload the whole image and the
+    fast build must not be slower. After a reset of the host, the base build
+    uploads it again and the fast build must not upload anything and must be
+    faster. The fast build must upload the whole image if the PL460 lost it
+    or one byte of it changed, or if the binary file changed, and start the
+    upload once the program memory is read back (and the CRC32 computed for
+    a new binary file), not after the start up timeout of the firmware. The
+    boot time, bytes uploaded, task calls and longest task call are printed
+    for every case.
+
+    Usage:
+      plc_boot <binary file> [main loop periods in us]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "boot_sim.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_IMAGE_SIZE_MAX     (160U * 1024U)
+#define TEST_LOOPS_MAX          8U
+
+/* Read back of the program memory by the resident check, 16 blocks of 128
+ * bytes at 8 MHz and margin */
+#define TEST_READ_BACK_MS       3.0
+
+/* The boot driver takes the image address as 32 bits: keep it in .bss and
+ * build without PIE */
+static uint8_t testImage[TEST_IMAGE_SIZE_MAX];
+static uint8_t testImageChanged[TEST_IMAGE_SIZE_MAX];
+static uint32_t testImageSize;
+
+static double testLoops[TEST_LOOPS_MAX] = {50.0, 1000.0, 5000.0};
+static unsigned int testNumLoops = 3U;
+
+static int testFails;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char* build, const char* title, double loopUS, const char* msg)
+{
+    testFails++;
+    printf("FAIL: %s %s, loop %.0f us: %s\n", build, title, loopUS, msg);
+}
+
+static void _checkBoot(const char* build, const char* title, double loopUS, const BOOT_SIM_RESULT* pResult,
+    bool upload)
+{
+    if ((pResult->ready == false) || (pResult->imageOk == false))
+    {
+        _fail(build, title, loopUS, (pResult->ready == false) ? "not ready" : "image not in program memory");
+    }
+
+    if ((upload == true) && (pResult->bytesUploaded < testImageSize))
+    {
+        _fail(build, title, loopUS, "image not uploaded");
+    }
+
+    if ((upload == false) && (pResult->bytesUploaded != 0U))
+    {
+        _fail(build, title, loopUS, "image uploaded again");
+    }
+}
+
+static void _print(const char* build, const char* title, const BOOT_SIM_RESULT* pResult)
+{
+    printf("%-5s %-13s %9.1f %7u %6u %8.0f\n", build, title, pResult->bootMS, (unsigned) pResult->bytesUploaded,
+            (unsigned) pResult->tasks, pResult->maxTaskUS);
+}
+
+static void _checkUploadDelay(const char* title, double loopUS, const BOOT_SIM_RESULT* pResult,
+    const BOOT_SIM_RESULT* pCold, double checkMS)
+{
+    if (pResult->bootMS > (pCold->bootMS + checkMS))
+    {
+        _fail("fast", title, loopUS, "upload delayed by the resident image start up");
+    }
+}
+
+static void _testLoop(const BOOT_SIM_MODEL* model)
+{
+    BOOT_SIM_RESULT baseCold, baseReset, fastCold, fastReset, fastLost, fastCorrupted, fastChanged;
+    BOOT_SIM_MODEL baseModel = *model;
+    double crcMS = ((double) testImageSize * model->crcNsPerByte) / 1e6;
+
+    printf("Main loop %.0f us\n", model->loopUS);
+
+    /* Boot driver and HAL as in the other configurations */
+    baseModel.halDoubleBuffer = false;
+
+    bootSimBase.boot(testImage, testImageSize, BOOT_SIM_POWER_ON, &baseModel, &baseCold);
+    _print("base", "power on", &baseCold);
+    _checkBoot("base", "power on", model->loopUS, &baseCold, true);
+
+    bootSimBase.boot(testImage, testImageSize, BOOT_SIM_HOST_RESET, &baseModel, &baseReset);
+    _print("base", "host reset", &baseReset);
+    _checkBoot("base", "host reset", model->loopUS, &baseReset, true);
+
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_POWER_ON, model, &fastCold);
+    _print("fast", "power on", &fastCold);
+    _checkBoot("fast", "power on", model->loopUS, &fastCold, true);
+    if (fastCold.bootMS > baseCold.bootMS)
+    {
+        _fail("fast", "power on", model->loopUS, "slower than the base build");
+    }
+
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_HOST_RESET, model, &fastReset);
+    _print("fast", "host reset", &fastReset);
+    _checkBoot("fast", "host reset", model->loopUS, &fastReset, (fastReset.residentCheck == false));
+    if ((fastReset.residentCheck == true) && (fastReset.bootMS >= baseReset.bootMS))
+    {
+        _fail("fast", "host reset", model->loopUS, "not faster than the base build");
+    }
+
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_PL460_LOST, model, &fastLost);
+    _print("fast", "PL460 lost", &fastLost);
+    _checkBoot("fast", "PL460 lost", model->loopUS, &fastLost, true);
+    _checkUploadDelay("PL460 lost", model->loopUS, &fastLost, &fastCold, TEST_READ_BACK_MS);
+
+    /* PL460 holds the image and the record is valid: one byte changed */
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_HOST_RESET, model, &fastReset);
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_PL460_CORRUPTED, model, &fastCorrupted);
+    _print("fast", "PL460 changed", &fastCorrupted);
+    _checkBoot("fast", "PL460 changed", model->loopUS, &fastCorrupted, true);
+    _checkUploadDelay("PL460 changed", model->loopUS, &fastCorrupted, &fastCold, TEST_READ_BACK_MS);
+
+    /* PL460 holds the image and the record is valid: new binary file */
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_HOST_RESET, model, &fastReset);
+    bootSimFast.boot(testImageChanged, testImageSize, BOOT_SIM_HOST_RESET, model, &fastChanged);
+    _print("fast", "new binary", &fastChanged);
+    _checkBoot("fast", "new binary", model->loopUS, &fastChanged, true);
+    _checkUploadDelay("new binary", model->loopUS, &fastChanged, &fastCold, TEST_READ_BACK_MS + crcMS);
+}
+
+static bool _loadImage(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        printf("FAIL: cannot open %s\n", path);
+        return false;
+    }
+
+    testImageSize = (uint32_t) fread(testImage, 1U, sizeof(testImage), file);
+    (void) fclose(file);
+
+    if ((testImageSize == 0U) || (testImageSize == sizeof(testImage)))
+    {
+        printf("FAIL: %s is empty or larger than %u bytes\n", path, TEST_IMAGE_SIZE_MAX);
+        return false;
+    }
+
+    if ((uintptr_t) testImage > UINT32_MAX)
+    {
+        printf("FAIL: image above 4 GB, build without PIE\n");
+        return false;
+    }
+
+    /* Same size, one byte changed */
+    (void) memcpy(testImageChanged, testImage, testImageSize);
+    testImageChanged[testImageSize / 2U] ^= 0x01U;
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    BOOT_SIM_MODEL model = {8e6, 100e6, 0.0, 2.0, 60.0, true};
+    BOOT_SIM_RESULT info;
+    unsigned int idx;
+    int arg;
+
+    if (argc < 2)
+    {
+        printf("Usage: %s <binary file> [main loop periods in us]\n", argv[0]);
+        return 1;
+    }
+
+    if (_loadImage(argv[1]) == false)
+    {
+        return 1;
+    }
+
+    if (argc > 2)
+    {
+        testNumLoops = 0U;
+        for (arg = 2; (arg < argc) && (testNumLoops < TEST_LOOPS_MAX); arg++)
+        {
+            testLoops[testNumLoops] = atof(argv[arg]);
+
+            /* Time only advances in the main loop while the PL460 starts up */
+            if (testLoops[testNumLoops] < 1.0)
+            {
+                testLoops[testNumLoops] = 1.0;
+            }
+
+            testNumLoops++;
+        }
+    }
+
+    model.loopUS = testLoops[0];
+    bootSimFast.boot(testImage, testImageSize, BOOT_SIM_POWER_ON, &model, &info);
+    printf("%u byte image, SPI %.1f MHz, flash %.0f MB/s, base 1 fragment per task, fast %u fragments per task, double buffered HAL%s\n",
+            (unsigned) testImageSize, model.spiHz / 1e6, model.flashBps / 1e6, (unsigned) info.fragsPerTask,
+            (info.residentCheck == true) ? " and resident check" : "");
+    printf("%-5s %-13s %9s %7s %6s %8s\n", "", "", "boot ms", "bytes", "tasks", "task us");
+
+    for (idx = 0U; idx < testNumLoops; idx++)
+    {
+        model.loopUS = testLoops[idx];
+        _testLoop(&model);
+    }
+
+    printf("%s\n", (testFails == 0) ? "PASS" : "FAIL");
+    return (testFails == 0) ? 0 : 1;
+}
@@ -0,0 +1,715 @@
+/*******************************************************************************
+  PLC PHY TX queue test
+
+  File Name:
+    plc_tx_queue.c
+
+  Summary:
+    Host test of the PLC PHY driver TX queue against a mock of the PL460.
+
+  Description:
+    drv_plc_phy_comm.c of the phy_tx_test_console application is built for the
+    host with its own configuration. The PLC HAL is replaced by a mock of the
+    PL460 G3 PHY command interface: SPI commands by memory ID, the status
+    and TX confirm events with the external interrupt, a single TX buffer
+    that answers BUSY_TX to parameters written while a frame is on the line
+    or waiting for its data, invalid length errors, relative and absolute
+    start times and an optional PLC reset reported on a given SPI transfer.
+    Time is simulated in microseconds; every SPI transfer takes 10 us plus
+    1 us per byte and a frame stays on the line 2 ms plus 40 us per byte.
+
+    The application calls DRV_PLC_PHY_Task once per main loop period and
+    keeps a number of requests outstanding, as phy_tx_test_console and
+    phy_plc_and_go do for bulk transfers. Every payload carries its sequence
+    number, so that a payload modified after the request, or a frame sent
+    before an earlier request, is detected when the frame goes on the line.
+
+    Throughput runs send 133 byte frames for 2 s with a 1 ms and a 10 ms main
+    loop, with one request outstanding and with the queue full. Every
+    request must get one successful confirm, the PL460 must never answer
+    BUSY_TX and no payload may be corrupted or reordered; with the queue,
+    the line must not be idle between frames for longer than the main loop
+    period plus TEST_LAUNCH_MAX_US on average. Stress runs mix invalid lengths, absolute
+    start times, cancels and PLC resets over several seeds: every request
+    must still get exactly one confirm.
+
+    In every run, no TX parameters or data may be written from the external
+    interrupt, and no TX data may be written after the PL460 rejected its
+    parameters (the driver waits for the error confirm before the data, in
+    the direct and in the queued path).
+
+    Built with TEST_TX_QUEUE_SIZE 0, the same runs are made without the queue
+    for comparison; only the throughput runs are checked.
+
+    Usage:
+      plc_tx_queue
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "configuration.h"
+
+#ifdef TEST_TX_QUEUE_SIZE
+#undef DRV_PLC_PHY_TX_QUEUE_SIZE
+#define DRV_PLC_PHY_TX_QUEUE_SIZE           TEST_TX_QUEUE_SIZE
+#endif
+
+/* The interrupt handler clears the PIO status: use a host copy of the PIO */
+static pio_registers_t testPio;
+#undef PIO0_REGS
+#define PIO0_REGS                           (&testPio)
+
+#include "driver/plc/phy/drv_plc_phy_comm.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Offset of the TX mode in the serialized TX parameters */
+#define TEST_PAR_MODE_OFFSET        (6U + NUM_SUBBANDS_MAX + TONE_MAP_SIZE_MAX)
+
+#define TEST_SPI_OVERHEAD_US        10U
+#define TEST_FRAME_OVERHEAD_US      2000U
+#define TEST_FRAME_US_PER_BYTE      40U
+#define TEST_ERROR_CFM_US           50U
+#define TEST_PL460_LEN_MAX          400U
+
+#define TEST_FRAME_LEN              133U
+#define TEST_RUN_US                 2000000U
+#define TEST_ABSOLUTE_DELAY_US      3000U
+#define TEST_STRESS_SEEDS           9U
+
+/* Mean idle time between queued frames on top of the main loop period:
+ * error confirm guard, TX parameters and data */
+#define TEST_LAUNCH_MAX_US          600.0
+
+/* Requests outstanding with the queue full: one on the line plus the queue */
+#define TEST_DEPTH_MAX              (DRV_PLC_PHY_TX_QUEUE_SIZE + 1U)
+
+typedef struct
+{
+    uint32_t loopUS;
+    uint32_t depth;
+    unsigned int seed;
+    bool stress;
+} TEST_RUN;
+
+typedef struct
+{
+    uint32_t requests;
+    uint32_t confirms;
+    uint32_t cfmSuccess;
+    uint32_t cfmNoTx;
+    uint32_t cfmInvLength;
+    uint32_t cfmOther;
+    uint32_t frames;
+    uint32_t busyTx;
+    uint32_t badData;
+    uint32_t cfmOverwritten;
+    uint32_t pendingMismatch;
+    uint32_t isrTxWrites;
+    uint32_t dataDiscarded;
+    uint32_t outOfOrder;
+    double busyPercent;
+    double meanGapUS;
+} TEST_RESULT;
+
+/* PL460 model */
+typedef struct
+{
+    bool parPending;
+    bool txOn;
+    uint8_t par[PLC_TX_PAR_SIZE];
+    uint64_t txStart;
+    uint64_t txEnd;
+    uint64_t lastEnd;
+    uint8_t txData[PLC_DATA_PKT_SIZE];
+    uint16_t txLen;
+    uint8_t lastSeq;
+    bool cfmReady;
+    uint8_t cfm[PLC_CMF_PKT_SIZE];
+    uint32_t evFlags;
+    bool errPending;
+    uint64_t errTime;
+    uint8_t errResult;
+    uint64_t idleUS;
+    uint64_t busyUS;
+} TEST_PL460;
+
+static uint64_t testNow;
+static bool testInIsr, testIntEnabled, testIntPending;
+static uint32_t testSpiCount, testResetSpi;
+static TEST_PL460 testPl460;
+static TEST_RESULT* testResult;
+static DRV_PLC_PHY_OBJ testPlcPhyObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: PL460 and PLC HAL Mock
+// *****************************************************************************
+// *****************************************************************************
+
+static void _isr(void);
+
+static void _pl460Confirm(uint8_t result, uint32_t timeEnd)
+{
+    if (testPl460.cfmReady == true)
+    {
+        testResult->cfmOverwritten++;
+    }
+
+    (void) memset(testPl460.cfm, 0, sizeof(testPl460.cfm));
+    testPl460.cfm[4] = (uint8_t) timeEnd;
+    testPl460.cfm[5] = (uint8_t) (timeEnd >> 8);
+    testPl460.cfm[6] = (uint8_t) (timeEnd >> 16);
+    testPl460.cfm[7] = (uint8_t) (timeEnd >> 24);
+    testPl460.cfm[8] = result;
+    testPl460.cfmReady = true;
+    testPl460.evFlags |= DRV_PLC_PHY_EV_FLAG_TX_CFM_MASK;
+    testIntPending = true;
+}
+
+static void _pl460Events(void)
+{
+    if ((testPl460.errPending == true) && (testNow >= testPl460.errTime))
+    {
+        testPl460.errPending = false;
+        _pl460Confirm(testPl460.errResult, (uint32_t) testNow);
+    }
+
+    if ((testPl460.txOn == true) && (testNow >= testPl460.txEnd))
+    {
+        uint16_t idx;
+        uint8_t seq = testPl460.txData[0];
+
+        testPl460.txOn = false;
+        testPl460.lastEnd = testPl460.txEnd;
+        testPl460.busyUS += testPl460.txEnd - testPl460.txStart;
+
+        /* Payload: sequence number, byte index, sequence number check */
+        for (idx = 1U; idx < (testPl460.txLen - 1U); idx++)
+        {
+            if (testPl460.txData[idx] != (uint8_t) idx)
+            {
+                break;
+            }
+        }
+
+        if ((testPl460.txLen < 2U) || (idx != (testPl460.txLen - 1U)) ||
+                (testPl460.txData[testPl460.txLen - 1U] != (uint8_t) (seq ^ 0x5AU)))
+        {
+            testResult->badData++;
+        }
+        else if ((testResult->frames > 1U) && ((int8_t) (seq - testPl460.lastSeq) <= 0))
+        {
+            /* Frames go on the line in request order */
+            testResult->outOfOrder++;
+        }
+        else
+        {
+            testPl460.lastSeq = seq;
+        }
+
+        _pl460Confirm(DRV_PLC_PHY_TX_RESULT_SUCCESS, (uint32_t) testPl460.txEnd);
+    }
+}
+
+static void _advance(uint32_t us)
+{
+    uint64_t end = testNow + us;
+
+    while (testNow < end)
+    {
+        testNow++;
+        _pl460Events();
+        if ((testIntPending == true) && (testIntEnabled == true) && (testInIsr == false))
+        {
+            _isr();
+        }
+    }
+}
+
+static void _isr(void)
+{
+    testInIsr = true;
+    testIntPending = false;
+    DRV_PLC_PHY_ExternalInterruptHandler((PIO_PIN) DRV_PLC_EXT_INT_PIN, 0U);
+    testInIsr = false;
+}
+
+static void _pl460Reset(void)
+{
+    testPl460.txOn = false;
+    testPl460.parPending = false;
+    testPl460.errPending = false;
+    testPl460.cfmReady = false;
+    testPl460.evFlags = 0U;
+}
+
+static void _pl460WriteTxPar(uint8_t* pData, uint16_t length)
+{
+    uint8_t mode = pData[TEST_PAR_MODE_OFFSET];
+    uint16_t dataLen = (uint16_t) pData[4] | ((uint16_t) pData[5] << 8);
+
+    if ((mode & TX_MODE_CANCEL) != 0U)
+    {
+        if (testPl460.txOn == true)
+        {
+            testPl460.txOn = false;
+            testPl460.lastEnd = testNow;
+            testPl460.busyUS += testNow - testPl460.txStart;
+            _pl460Confirm(DRV_PLC_PHY_TX_RESULT_NO_TX, (uint32_t) testNow);
+        }
+
+        testPl460.parPending = false;
+    }
+    else if ((testPl460.txOn == true) || (testPl460.parPending == true))
+    {
+        /* Single TX buffer */
+        testResult->busyTx++;
+        testPl460.errPending = true;
+        testPl460.errTime = testNow + TEST_ERROR_CFM_US;
+        testPl460.errResult = DRV_PLC_PHY_TX_RESULT_BUSY_TX;
+    }
+    else if ((dataLen == 0U) || (dataLen > TEST_PL460_LEN_MAX))
+    {
+        testPl460.errPending = true;
+        testPl460.errTime = testNow + TEST_ERROR_CFM_US;
+        testPl460.errResult = DRV_PLC_PHY_TX_RESULT_INV_LENGTH;
+    }
+    else
+    {
+        (void) memcpy(testPl460.par, pData, length);
+        testPl460.parPending = true;
+    }
+}
+
+static void _pl460WriteTxData(uint8_t* pData)
+{
+    uint32_t timeIni;
+    uint16_t dataLen;
+
+    if (testPl460.parPending == false)
+    {
+        /* Parameters rejected: data discarded */
+        testResult->dataDiscarded++;
+        return;
+    }
+
+    timeIni = (uint32_t) testPl460.par[0] | ((uint32_t) testPl460.par[1] << 8) |
+            ((uint32_t) testPl460.par[2] << 16) | ((uint32_t) testPl460.par[3] << 24);
+    dataLen = (uint16_t) testPl460.par[4] | ((uint16_t) testPl460.par[5] << 8);
+    testPl460.parPending = false;
+
+    if ((testPl460.par[TEST_PAR_MODE_OFFSET] & TX_MODE_RELATIVE) != 0U)
+    {
+        testPl460.txStart = testNow + timeIni;
+    }
+    else
+    {
+        testPl460.txStart = (timeIni > testNow) ? timeIni : testNow;
+    }
+
+    if (testPl460.txStart > testPl460.lastEnd)
+    {
+        testPl460.idleUS += testPl460.txStart - testPl460.lastEnd;
+    }
+
+    testPl460.txEnd = testPl460.txStart + TEST_FRAME_OVERHEAD_US + (TEST_FRAME_US_PER_BYTE * dataLen);
+    testPl460.txOn = true;
+    testPl460.txLen = dataLen;
+    (void) memcpy(testPl460.txData, pData, dataLen);
+    testResult->frames++;
+}
+
+static void _halSendWrRdCmd(void* pCmd, void* pInfo)
+{
+    DRV_PLC_HAL_CMD* halCmd = (DRV_PLC_HAL_CMD*) pCmd;
+    DRV_PLC_HAL_INFO* halInfo = (DRV_PLC_HAL_INFO*) pInfo;
+
+    _advance(TEST_SPI_OVERHEAD_US + halCmd->length);
+
+    halInfo->key = DRV_PLC_HAL_KEY_CORTEX;
+    halInfo->flags = testPl460.evFlags;
+
+    testSpiCount++;
+    if (testSpiCount == testResetSpi)
+    {
+        /* PLC reset seen in this transfer: command not executed */
+        halInfo->key = DRV_PLC_HAL_KEY_BOOT;
+        halInfo->flags = DRV_PLC_HAL_FLAG_RST_WDOG;
+        _pl460Reset();
+        return;
+    }
+
+    if (halCmd->cmd == DRV_PLC_HAL_CMD_WR)
+    {
+        if ((testInIsr == true) &&
+                ((halCmd->memId == (uint16_t) TX_PAR_ID) || (halCmd->memId == (uint16_t) TX_DAT_ID)))
+        {
+            testResult->isrTxWrites++;
+        }
+
+        if (halCmd->memId == (uint16_t) TX_PAR_ID)
+        {
+            _pl460WriteTxPar(halCmd->pData, halCmd->length);
+        }
+        else if (halCmd->memId == (uint16_t) TX_DAT_ID)
+        {
+            _pl460WriteTxData(halCmd->pData);
+        }
+        else
+        {
+            /* Not used by the test */
+        }
+    }
+    else if (halCmd->memId == (uint16_t) STATUS_ID)
+    {
+        uint32_t timer = (uint32_t) testNow;
+
+        (void) memset(halCmd->pData, 0, halCmd->length);
+        (void) memcpy(halCmd->pData, &timer, sizeof(timer));
+    }
+    else if (halCmd->memId == (uint16_t) TX_CFM_ID)
+    {
+        (void) memcpy(halCmd->pData, testPl460.cfm,
+                (halCmd->length < sizeof(testPl460.cfm)) ? halCmd->length : sizeof(testPl460.cfm));
+        testPl460.cfmReady = false;
+        testPl460.evFlags &= ~DRV_PLC_PHY_EV_FLAG_TX_CFM_MASK;
+    }
+    else
+    {
+        /* Not used by the test */
+    }
+}
+
+static void _halDelay(uint32_t us)
+{
+    _advance(us);
+}
+
+static void _halEnableExtInt(bool enable)
+{
+    testIntEnabled = enable;
+    if ((enable == true) && (testIntPending == true) && (testInIsr == false))
+    {
+        _isr();
+    }
+}
+
+static bool _halGetThermalMonitor(void)
+{
+    return false;
+}
+
+static void _halReset(void)
+{
+}
+
+void DRV_PLC_BOOT_Restart(DRV_PLC_BOOT_RESTART_MODE mode)
+{
+    (void) mode;
+}
+
+static DRV_PLC_PLIB_INTERFACE testPlib = {
+    .extIntPin = DRV_PLC_EXT_INT_PIN,
+};
+
+static DRV_PLC_HAL_INTERFACE testHal = {
+    .plcPlib = &testPlib,
+    .reset = _halReset,
+    .getThermalMonitor = _halGetThermalMonitor,
+    .enableExtInt = _halEnableExtInt,
+    .delay = _halDelay,
+    .sendWrRdCmd = _halSendWrRdCmd,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _txCfm(DRV_PLC_PHY_TRANSMISSION_CFM_OBJ* cfmObj, uintptr_t context)
+{
+    (void) context;
+
+    testResult->confirms++;
+    if (cfmObj->result == DRV_PLC_PHY_TX_RESULT_SUCCESS)
+    {
+        testResult->cfmSuccess++;
+    }
+    else if (cfmObj->result == DRV_PLC_PHY_TX_RESULT_NO_TX)
+    {
+        testResult->cfmNoTx++;
+    }
+    else if (cfmObj->result == DRV_PLC_PHY_TX_RESULT_INV_LENGTH)
+    {
+        testResult->cfmInvLength++;
+    }
+    else
+    {
+        testResult->cfmOther++;
+    }
+}
+
+static uint32_t _driverPending(void)
+{
+    uint32_t pending = (testPlcPhyObj.state[0] != DRV_PLC_PHY_STATE_IDLE) ? 1U : 0U;
+
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+    pending += testPlcPhyObj.txQueueNum + lDRV_PLC_PHY_COMM_TxCfmCount();
+#else
+    pending += ((testPlcPhyObj.evTxCfm[0] == true) || (testPlcPhyObj.evResetTxCfm == true)) ? 1U : 0U;
+#endif
+    return pending;
+}
+
+static void _run(const TEST_RUN* run, TEST_RESULT* result)
+{
+    DRV_PLC_PHY_TRANSMISSION_OBJ txObj;
+    uint8_t data[TEST_PL460_LEN_MAX];
+    uint32_t sent;
+    uint16_t idx;
+    int drain;
+
+    (void) memset(result, 0, sizeof(*result));
+    (void) memset(&testPl460, 0, sizeof(testPl460));
+    (void) memset(&testPlcPhyObj, 0, sizeof(testPlcPhyObj));
+    (void) memset(&txObj, 0, sizeof(txObj));
+    testResult = result;
+    testNow = 0U;
+    testInIsr = false;
+    testIntEnabled = false;
+    testIntPending = false;
+    testSpiCount = 0U;
+    testResetSpi = 0U;
+    srand(run->seed);
+
+    testPlcPhyObj.plcHal = &testHal;
+    testPlcPhyObj.txCfmCallback = _txCfm;
+    testPlcPhyObj.state[0] = DRV_PLC_PHY_STATE_IDLE;
+    DRV_PLC_PHY_Init(&testPlcPhyObj);
+
+    while (testNow < TEST_RUN_US)
+    {
+        DRV_PLC_PHY_Task();
+
+        /* At most one request per outstanding slot and main loop: a request
+         * rejected right away is retried in the next loop */
+        for (sent = 0U; (sent < run->depth) && ((result->requests - result->confirms) < run->depth); sent++)
+        {
+            uint16_t len = TEST_FRAME_LEN;
+            uint8_t seq = (uint8_t) result->requests;
+
+            if ((run->stress == true) && ((rand() % 20) == 0))
+            {
+                len = 0U;
+            }
+
+            for (idx = 0U; idx < len; idx++)
+            {
+                data[idx] = (uint8_t) idx;
+            }
+
+            if (len > 0U)
+            {
+                data[0] = seq;
+                data[len - 1U] = (uint8_t) (seq ^ 0x5AU);
+            }
+
+            txObj.pTransmitData = data;
+            txObj.dataLength = len;
+            txObj.timeIni = 0U;
+            txObj.mode = TX_MODE_RELATIVE;
+            if ((run->stress == true) && ((rand() % 10) == 0))
+            {
+                txObj.timeIni = (uint32_t) testNow + TEST_ABSOLUTE_DELAY_US;
+                txObj.mode = TX_MODE_ABSOLUTE;
+            }
+
+            result->requests++;
+            DRV_PLC_PHY_TxRequest(0U, &txObj);
+
+            /* The application reuses its buffer right away */
+            (void) memset(data, 0xEE, sizeof(data));
+
+            if ((run->stress == true) && ((rand() % 30) == 0))
+            {
+                txObj.dataLength = TEST_FRAME_LEN;
+                txObj.mode = TX_MODE_CANCEL | TX_MODE_RELATIVE;
+                DRV_PLC_PHY_TxRequest(0U, &txObj);
+            }
+
+            if ((run->stress == true) && ((rand() % 40) == 0))
+            {
+                testResetSpi = testSpiCount + 1U + ((uint32_t) rand() % 6U);
+            }
+
+            if (_driverPending() != (result->requests - result->confirms))
+            {
+                result->pendingMismatch++;
+            }
+        }
+
+        _advance(run->loopUS);
+    }
+
+    /* Wait for the outstanding confirms */
+    for (drain = 0; (drain < 200) && (result->requests != result->confirms); drain++)
+    {
+        DRV_PLC_PHY_Task();
+        _advance(run->loopUS * 10U);
+    }
+
+    result->busyPercent = (100.0 * (double) testPl460.busyUS) / (double) testNow;
+    result->meanGapUS = (result->frames > 0U) ? ((double) testPl460.idleUS / (double) result->frames) : 0.0;
+}
+
+static void _print(const char* title, const TEST_RUN* run, const TEST_RESULT* result)
+{
+    printf("%-10s %6u %5u %6u %6u %6.1f %7.0f %6u %6u %4u %4u %4u %4u %4u\n", title,
+            (unsigned) run->loopUS, (unsigned) run->depth, (unsigned) result->frames,
+            (unsigned) result->requests, result->busyPercent, result->meanGapUS,
+            (unsigned) result->confirms, (unsigned) result->cfmSuccess, (unsigned) result->cfmNoTx,
+            (unsigned) result->cfmInvLength, (unsigned) result->cfmOther, (unsigned) result->busyTx,
+            (unsigned) result->badData);
+}
+
+static int _check(const char* title, const TEST_RUN* run, const TEST_RESULT* result)
+{
+    int nErrors = 0;
+
+    if (result->confirms != result->requests)
+    {
+        printf("FAIL: %s: %u requests, %u confirms\n", title, (unsigned) result->requests,
+                (unsigned) result->confirms);
+        nErrors++;
+    }
+
+    if ((run->stress == false) && (result->cfmSuccess != result->requests))
+    {
+        printf("FAIL: %s: %u requests not transmitted\n", title,
+                (unsigned) (result->requests - result->cfmSuccess));
+        nErrors++;
+    }
+
+    if ((result->busyTx != 0U) || (result->cfmOverwritten != 0U))
+    {
+        printf("FAIL: %s: PL460 busy %u times, %u confirms overwritten\n", title,
+                (unsigned) result->busyTx, (unsigned) result->cfmOverwritten);
+        nErrors++;
+    }
+
+    if ((result->badData != 0U) || (result->outOfOrder != 0U))
+    {
+        printf("FAIL: %s: %u frames with a modified payload, %u out of order\n", title,
+                (unsigned) result->badData, (unsigned) result->outOfOrder);
+        nErrors++;
+    }
+
+    if ((result->isrTxWrites != 0U) || (result->dataDiscarded != 0U))
+    {
+        printf("FAIL: %s: %u TX writes from the interrupt, %u TX data after rejected parameters\n", title,
+                (unsigned) result->isrTxWrites, (unsigned) result->dataDiscarded);
+        nErrors++;
+    }
+
+    if (result->pendingMismatch != 0U)
+    {
+        printf("FAIL: %s: %u times the driver had another number of requests pending\n", title,
+                (unsigned) result->pendingMismatch);
+        nErrors++;
+    }
+
+    return nErrors;
+}
+
+static int _testThroughput(void)
+{
+    static const uint32_t loops[] = {1000U, 10000U};
+    TEST_RUN run = {0U, 1U, 1U, false};
+    TEST_RESULT single, queued;
+    unsigned int idx;
+    int nErrors = 0;
+
+    for (idx = 0U; idx < (sizeof(loops) / sizeof(loops[0])); idx++)
+    {
+        run.loopUS = loops[idx];
+        run.depth = 1U;
+        _run(&run, &single);
+        _print("single", &run, &single);
+        nErrors += _check("single", &run, &single);
+
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+        run.depth = TEST_DEPTH_MAX;
+        _run(&run, &queued);
+        _print("queued", &run, &queued);
+        nErrors += _check("queued", &run, &queued);
+
+        if (queued.frames < single.frames)
+        {
+            printf("FAIL: loop %u us: %u frames queued, %u frames one by one\n", (unsigned) run.loopUS,
+                    (unsigned) queued.frames, (unsigned) single.frames);
+            nErrors++;
+        }
+
+        if (queued.meanGapUS > ((double) run.loopUS + TEST_LAUNCH_MAX_US))
+        {
+            printf("FAIL: loop %u us: mean gap %.0f us queued\n", (unsigned) run.loopUS, queued.meanGapUS);
+            nErrors++;
+        }
+#else
+        (void) queued;
+#endif
+    }
+
+    return nErrors;
+}
+
+static int _testStress(void)
+{
+    TEST_RUN run = {1000U, TEST_DEPTH_MAX, 0U, true};
+    TEST_RESULT result;
+    char title[16];
+    int nErrors = 0;
+
+    for (run.seed = 1U; run.seed <= TEST_STRESS_SEEDS; run.seed++)
+    {
+        (void) snprintf(title, sizeof(title), "stress %u", run.seed);
+        _run(&run, &result);
+        _print(title, &run, &result);
+#if (DRV_PLC_PHY_TX_QUEUE_SIZE > 0U)
+        nErrors += _check(title, &run, &result);
+#endif
+    }
+
+    return nErrors;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    int nErrors = 0;
+
+    printf("PLC PHY TX queue size %u, %u byte frames of %u us\n", (unsigned) DRV_PLC_PHY_TX_QUEUE_SIZE,
+            TEST_FRAME_LEN, TEST_FRAME_OVERHEAD_US + (TEST_FRAME_US_PER_BYTE * TEST_FRAME_LEN));
+    printf("%-10s %6s %5s %6s %6s %6s %7s %6s %6s %4s %4s %4s %4s %4s\n", "", "loop", "depth",
+            "frames", "reqs", "busy", "gap", "cfms", "ok", "noTx", "len", "oth", "bsy", "bad");
+    printf("%-10s %6s %5s %6s %6s %6s %7s %6s %6s %4s %4s %4s %4s %4s\n", "", "us", "", "", "", "%",
+            "us", "", "", "", "", "", "", "");
+
+    nErrors += _testThroughput();
+    nErrors += _testStress();
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+/*******************************************************************************
+  Host stub of the PORTS System Service for the PLC TX queue test
+
+  Summary:
+    Pins used by the PLC driver configuration.
+
+  Description:
+    The generated sys_ports.h defines the ports from the PIO register
+    addresses, which are not integer constants on the host. Only the pin
+    numbers of the configuration are needed to build the PLC PHY driver.
+*******************************************************************************/
+
+#ifndef SYS_PORTS_H
+#define SYS_PORTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "peripheral/pio/plib_pio.h"
+
+typedef enum
+{
+    SYS_PORT_PIN_PA2 = 2,
+    SYS_PORT_PIN_PA3 = 3,
+    SYS_PORT_PIN_PA17 = 17,
+    SYS_PORT_PIN_PD3 = 99,
+    SYS_PORT_PIN_PD16 = 112,
+    SYS_PORT_PIN_NONE = -1
+} SYS_PORT_PIN;
+
+#endif // SYS_PORTS_H
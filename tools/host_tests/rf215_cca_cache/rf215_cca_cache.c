@@ -0,0 +1,1127 @@
+/*******************************************************************************
+  RF215 CCA occupancy cache test
+
+  File Name:
+    rf215_cca_cache.c
+
+  Summary:
+    Host simulation of the RF215 PHY channel occupancy cache with synthetic
+    channel occupancy traces.
+
+  Description:
+    rf215_phy.c of the G3 metering demo is built for the host with
+    DRV_RF215_ED_CACHE_CHANNELS, DRV_RF215_ED_SCAN_PERIOD_US and
+    DRV_RF215_ED_CACHE_VALID_US taken from the test build (SYS_TIME at 1 count
+    per microsecond). With the 2 ms validity of the demos, measurements always
+    expire during a received frame; the build with 20 ms validity also covers
+    a CCA right after a received frame. A CSMA-CA stand-in
+    of the MAC (unslotted, BE 3 to 5, up to 4 backoffs, 400 us unit) sends
+    frames of 40 bytes with CCA mode 3 on FSK 863 MHz operating mode 1, and
+    every CCA goes through the PHY as the driver does it:
+    lRF215_TX_ParamCfg (the cache decision), lRF215_TX_Prepare (ED duration
+    programmed in RFn_EDD) and, once the ED ends, lRF215_TX_EnDetectComplete
+    and the AMCS read callback. Every millisecond lRF215_PHY_EdScanTimeExpired
+    runs as the periodic timer of the PHY would, and the ED it starts ends in
+    lRF215_PHY_EdScanComplete.
+
+    The air is a synthetic occupancy trace per channel: frames of 20 to 255
+    bytes from other nodes at -98 to -60 dBm with exponential gaps, over a
+    -105 dBm noise floor. An ED measures the mean power of its window, from
+    the duration programmed in RFn_EDD. Frames starting while the transceiver
+    listens are received (RX header state until their end, then the RX
+    indication fills the cache).
+
+    Each scenario (a quiet channel, a busy channel, and 6 channels with a
+    channel change every 50 ms) runs twice on the same trace: with the cache,
+    and with the cache cleared before every CCA (always a full ED). Every
+    decision of the cache (busy reported without CCA, ED shortened, full ED)
+    must match a reference model of the channel history, and the occupancy of
+    every channel read with RF215_PIB_PHY_CHANNEL_OCCUPANCY must match it at
+    the end. With the cache, the mean ED time per CCA must drop on the quiet
+    channel, the number of CCA ED measurements must drop on the busy one, the
+    busy reports without CCA must be wrong (a full ED would have been idle)
+    in less than 10% of the cases, and missed detections (a full ED before
+    the TX would have been busy) and collisions may not grow beyond the
+    noise of the simulation.
+
+    Built with TEST_ED_CACHE_CHANNELS 0, the scenarios only run with full ED,
+    every CCA must use the configured ED duration, and the results are
+    printed for comparison.
+
+    Usage:
+      rf215_cca_cache [seconds]       simulated time per scenario (60 s)
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "configuration.h"
+
+#undef DRV_RF215_ED_CACHE_CHANNELS
+#define DRV_RF215_ED_CACHE_CHANNELS         TEST_ED_CACHE_CHANNELS
+#undef DRV_RF215_ED_SCAN_PERIOD_US
+#define DRV_RF215_ED_SCAN_PERIOD_US         TEST_ED_SCAN_PERIOD_US
+#undef DRV_RF215_ED_CACHE_VALID_US
+#define DRV_RF215_ED_CACHE_VALID_US         TEST_ED_CACHE_VALID_US
+
+#include "driver/rf215/phy/rf215_phy.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_SECONDS    60U
+#define TEST_TRX                RF215_TRX_RF09_IDX
+#define TEST_DEV_REGS_SIZE      0x4000U
+#define TEST_MAX_FAILS_SHOWN    10U
+
+/* Air: noise floor, sensitivity and levels of the frames of other nodes */
+#define TEST_NOISE_DBM          (-105.0)
+#define TEST_SENSITIVITY_DBM    (-100)
+#define TEST_LEVEL_MIN_DBM      (-98)
+#define TEST_LEVEL_MAX_DBM      (-60)
+#define TEST_FRAME_LEN_MIN      20U
+#define TEST_FRAME_LEN_MAX      255U
+#define TEST_GAP_MIN_US         200U
+
+/* Channels: 200 kHz spacing from 863.1 MHz */
+#define TEST_CHANNELS_MAX       6U
+#define TEST_CHN_FREQ_BASE      863100000U
+#define TEST_CHN_SPACING        200000U
+
+/* Trace of each channel kept from 100 ms before to 100 ms after now */
+#define TEST_TRACE_FRAMES       128U
+#define TEST_TRACE_WINDOW_US    100000U
+
+/* MAC: unslotted CSMA-CA */
+#define TEST_PSDU_LEN           40U
+#define TEST_REQUEST_MEAN_US    20000.0
+#define TEST_UNIT_BACKOFF_US    400U
+#define TEST_MIN_BE             3U
+#define TEST_MAX_BE             5U
+#define TEST_MAX_BACKOFFS       4U
+
+/* Background scan period of the PHY timer */
+#define TEST_SCAN_PERIOD_US     1000U
+
+/* Tolerances against the run with full ED */
+#define TEST_FALSE_SKIPS_PCT    10U
+#define TEST_COLLISIONS_PCT     10U
+
+typedef enum
+{
+    TEST_DECISION_FULL = 0,
+    TEST_DECISION_SHORT,
+    TEST_DECISION_SKIP,
+} TEST_DECISION;
+
+typedef enum
+{
+    TEST_MAC_WAIT = 0,
+    TEST_MAC_BACKOFF,
+    TEST_MAC_CCA_ED,
+    TEST_MAC_TX,
+} TEST_MAC_STATE;
+
+typedef struct
+{
+    uint64_t start;
+    uint64_t end;
+    int8_t dBm;
+} TEST_FRAME;
+
+/* Occupancy trace of one channel (ring of frames in time order) */
+typedef struct
+{
+    TEST_FRAME frames[TEST_TRACE_FRAMES];
+    uint64_t randState;
+    uint64_t lastStart;
+    uint64_t lastEnd;
+    uint32_t first;
+    uint32_t num;
+} TEST_TRACE;
+
+typedef struct
+{
+    const char* name;
+    uint8_t channels;
+    uint32_t gapMeanUS;
+    uint32_t hopPeriodUS;
+} TEST_SCENARIO;
+
+typedef struct
+{
+    uint32_t requests;
+    uint32_t sent;
+    uint32_t failures;
+    uint32_t ccaEd;
+    uint32_t ccaShortened;
+    uint32_t ccaSkipped;
+    uint32_t busyRx;
+    uint32_t scans;
+    uint32_t falseSkips;
+    uint32_t missed;
+    uint32_t collisions;
+    uint32_t rxFrames;
+    uint64_t latencySum;
+    uint64_t edTimeSum;
+} TEST_RESULT;
+
+static const TEST_SCENARIO testScenarios[] =
+{
+    {"quiet", 1U, 500000U, 0U},
+    {"busy", 1U, 15000U, 0U},
+    {"hopping", TEST_CHANNELS_MAX, 60000U, 50000U},
+};
+
+const RF215_REG_VALUES_OBJ rf215RegValues = {0};
+
+static uint64_t testNow;
+static uint8_t testDevRegs[TEST_DEV_REGS_SIZE];
+static DRV_RF215_CLIENT_OBJ testClient;
+static DRV_RF215_TX_BUFFER_OBJ testTxBuffer;
+static TEST_TRACE testTraces[TEST_CHANNELS_MAX];
+static const TEST_SCENARIO* testScenario;
+static TEST_RESULT testResult;
+static bool testBypass;
+static unsigned long testErrors;
+static uint64_t testRandState;
+
+/* Transceiver and air */
+static uint8_t testChannel;
+static bool testRxOn;
+static TEST_FRAME testRxFrame;
+static uint64_t testRxNext;
+static uint64_t testScanEnd;
+static uint64_t testEdStart;
+
+/* MAC */
+static TEST_MAC_STATE testMacState;
+static uint64_t testMacTime;
+static uint64_t testMacRequest;
+static uint8_t testMacNB;
+static uint8_t testMacBE;
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+/* Reference model of the channel occupancy cache */
+static DRV_RF215_CHN_OCCUPANCY_OBJ testRef[TEST_CHANNELS_MAX];
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RF215 HAL, Driver and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void RF215_HAL_EnterCritical(void) {}
+void RF215_HAL_LeaveCritical(void) {}
+bool RF215_HAL_SpiLock(void) { return true; }
+void RF215_HAL_SpiUnlock(void) {}
+size_t RF215_HAL_GetSpiQueueSize(void) { return 0U; }
+void RF215_HAL_LedTx(bool on) { (void) on; }
+void RF215_HAL_LedRx(bool on) { (void) on; }
+
+static uint32_t _edDuration(void);
+
+static void _devWrite(uint16_t addr, const uint8_t* pData, size_t size)
+{
+    size_t idx;
+
+    for (idx = 0U; idx < size; idx++)
+    {
+        testDevRegs[addr + idx] = pData[idx];
+    }
+
+    if ((addr <= RF215_RFn_EDC(TEST_TRX)) && ((addr + size) > RF215_RFn_EDC(TEST_TRX)))
+    {
+        /* Single ED started (background ED while listening, or CCA) */
+        testScanEnd = UINT64_MAX;
+        if (testDevRegs[RF215_RFn_EDC(TEST_TRX)] == RF215_RFn_EDC_EDM_SINGLE)
+        {
+            testEdStart = testNow;
+            if (rf215PhyObj[TEST_TRX].phyState == PHY_STATE_RX_LISTEN)
+            {
+                testScanEnd = testNow + _edDuration();
+            }
+        }
+    }
+}
+
+void RF215_HAL_SpiRead(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    (void) memcpy(pData, &testDevRegs[addr], size);
+    if (callback != NULL)
+    {
+        callback(context, pData, testNow);
+    }
+}
+
+void RF215_HAL_SpiReadFromTasks(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    RF215_HAL_SpiRead(addr, pData, size, callback, context);
+}
+
+void RF215_HAL_SpiWrite(uint16_t addr, void* pData, size_t size)
+{
+    _devWrite(addr, pData, size);
+}
+
+void RF215_HAL_SpiWriteUpdate(uint16_t addr, uint8_t* pDataNew, uint8_t* pDataOld, size_t size)
+{
+    size_t idx;
+
+    for (idx = 0U; idx < size; idx++)
+    {
+        if (pDataNew[idx] != pDataOld[idx])
+        {
+            pDataOld[idx] = pDataNew[idx];
+            _devWrite(addr + (uint16_t) idx, &pDataNew[idx], 1U);
+        }
+    }
+}
+
+DRV_RF215_TX_BUFFER_OBJ* DRV_RF215_TxHandleValidate(DRV_RF215_TX_HANDLE txHandle)
+{
+    return ((txHandle == 0U) && (testTxBuffer.inUse == true)) ? &testTxBuffer : NULL;
+}
+
+void DRV_RF215_AbortTxByRx(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_AbortTxByPhyConfig(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_NotifyRxInd(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* ind) { (void) trxIdx; (void) ind; }
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+uint64_t SYS_TIME_Counter64Get(void) { return testNow; }
+uint32_t SYS_TIME_FrequencyGet(void) { return 1000000U; }
+uint32_t SYS_TIME_USToCount(uint32_t us) { return us; }
+
+SYS_TIME_HANDLE SYS_TIME_TimerCreate(uint32_t count, uint32_t period, SYS_TIME_CALLBACK callBack,
+    uintptr_t context, SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) count; (void) period; (void) callBack; (void) context; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+SYS_TIME_RESULT SYS_TIME_TimerStart(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+SYS_TIME_RESULT SYS_TIME_TimerDestroy(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterUS(SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t us,
+    SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) callback; (void) context; (void) us; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Channel Occupancy Trace
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _xorshift(uint64_t* state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t _rand64(void)
+{
+    return _xorshift(&testRandState);
+}
+
+static double _randExp(uint64_t* state, double mean)
+{
+    return -mean * log(((double) (_xorshift(state) >> 11) + 1.0) / 9007199254740993.0);
+}
+
+static void _fail(const char* message, unsigned long value)
+{
+    if (testErrors < TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s %s: %.3f ms: %s (%lu)\n", testScenario->name, testBypass ? "full ED" : "cache",
+                (double) testNow / 1000.0, message, value);
+    }
+    testErrors++;
+}
+
+static TEST_FRAME* _traceFrame(TEST_TRACE* trace, uint32_t pos)
+{
+    return &trace->frames[(trace->first + pos) % TEST_TRACE_FRAMES];
+}
+
+/* Frames of the channel generated up to TEST_TRACE_WINDOW_US after now, and
+ * dropped TEST_TRACE_WINDOW_US after their end */
+static TEST_TRACE* _trace(uint8_t channel)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    TEST_TRACE* trace = &testTraces[channel];
+    TEST_FRAME* frame;
+    uint16_t len, symbols;
+
+    while (true)
+    {
+        while ((trace->num > 0U) && ((trace->frames[trace->first].end + TEST_TRACE_WINDOW_US) < testNow))
+        {
+            trace->first = (trace->first + 1U) % TEST_TRACE_FRAMES;
+            trace->num--;
+        }
+
+        if ((trace->lastEnd != 0U) && (trace->lastStart > (testNow + TEST_TRACE_WINDOW_US)))
+        {
+            break;
+        }
+
+        if (trace->num == TEST_TRACE_FRAMES)
+        {
+            _fail("occupancy trace full", channel);
+            break;
+        }
+
+        frame = _traceFrame(trace, trace->num);
+        len = (uint16_t) (TEST_FRAME_LEN_MIN + (_xorshift(&trace->randState) %
+                (TEST_FRAME_LEN_MAX - TEST_FRAME_LEN_MIN + 1U)));
+        frame->start = trace->lastEnd + TEST_GAP_MIN_US + (uint64_t) _randExp(&trace->randState, testScenario->gapMeanUS);
+        frame->end = frame->start + lRF215_PHY_PpduDuration(&pObj->phyConfig, FSK_FEC_OFF, len, &symbols);
+        frame->dBm = (int8_t) (TEST_LEVEL_MIN_DBM + (int) (_xorshift(&trace->randState) %
+                (uint64_t) (TEST_LEVEL_MAX_DBM - TEST_LEVEL_MIN_DBM + 1)));
+        trace->lastStart = frame->start;
+        trace->lastEnd = frame->end;
+        trace->num++;
+    }
+
+    return trace;
+}
+
+/* Mean power in [start, end) as the RF215 ED value */
+static int8_t _traceEnergy(uint8_t channel, uint64_t start, uint64_t end)
+{
+    TEST_TRACE* trace = _trace(channel);
+    TEST_FRAME* frame;
+    double energy = pow(10.0, TEST_NOISE_DBM / 10.0) * (double) (end - start);
+    uint64_t from, to;
+    uint32_t pos;
+    double dBm;
+
+    for (pos = 0U; pos < trace->num; pos++)
+    {
+        frame = _traceFrame(trace, pos);
+        from = (frame->start > start) ? frame->start : start;
+        to = (frame->end < end) ? frame->end : end;
+        if (to > from)
+        {
+            energy += pow(10.0, frame->dBm / 10.0) * (double) (to - from);
+        }
+    }
+
+    dBm = floor(10.0 * log10(energy / (double) (end - start)));
+    return (int8_t) ((dBm < -127.0) ? -127.0 : dBm);
+}
+
+static bool _traceOverlap(uint8_t channel, uint64_t start, uint64_t end)
+{
+    TEST_TRACE* trace = _trace(channel);
+    TEST_FRAME* frame;
+    uint32_t pos;
+
+    for (pos = 0U; pos < trace->num; pos++)
+    {
+        frame = _traceFrame(trace, pos);
+        if ((frame->start < end) && (frame->end > start))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* First frame of the channel starting after now */
+static TEST_FRAME* _traceNext(uint8_t channel)
+{
+    TEST_TRACE* trace = _trace(channel);
+    TEST_FRAME* frame;
+    uint32_t pos;
+
+    for (pos = 0U; pos < trace->num; pos++)
+    {
+        frame = _traceFrame(trace, pos);
+        if (frame->start > testNow)
+        {
+            return frame;
+        }
+    }
+
+    return NULL;
+}
+
+/* ED duration programmed in RFn_EDD */
+static uint32_t _edDuration(void)
+{
+    static const uint8_t dtbUS[4] = {2U, 8U, 32U, 128U};
+    uint8_t edd = testDevRegs[RF215_RFn_EDD(TEST_TRX)];
+
+    return (uint32_t) dtbUS[(edd & RF215_RFn_EDD_DTB_Msk) >> RF215_RFn_EDD_DTB_Pos] *
+            ((edd & RF215_RFn_EDD_DF_Msk) >> RF215_RFn_EDD_DF_Pos);
+}
+
+static bool _edBusy(int8_t edv)
+{
+    return (edv >= rf215PhyObj[TEST_TRX].phyConfig.ccaEdThresholdDBm);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Model of the Occupancy Cache
+// *****************************************************************************
+// *****************************************************************************
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+static uint64_t _refLastTime(DRV_RF215_CHN_OCCUPANCY_OBJ* ref)
+{
+    return (ref->rxTime > ref->edTime) ? ref->rxTime : ref->edTime;
+}
+
+/* Channel history, lost when DRV_RF215_ED_CACHE_CHANNELS other channels have
+ * been updated after it */
+static DRV_RF215_CHN_OCCUPANCY_OBJ* _refEntry(uint8_t channel)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* ref = &testRef[channel];
+    DRV_RF215_CHN_OCCUPANCY_OBJ* oldest = NULL;
+    uint8_t idx, present = 0U;
+
+    if (ref->chnFreq != 0U)
+    {
+        return ref;
+    }
+
+    for (idx = 0U; idx < TEST_CHANNELS_MAX; idx++)
+    {
+        if (testRef[idx].chnFreq != 0U)
+        {
+            present++;
+            if ((oldest == NULL) || (_refLastTime(&testRef[idx]) < _refLastTime(oldest)))
+            {
+                oldest = &testRef[idx];
+            }
+        }
+    }
+
+    if (present == DRV_RF215_ED_CACHE_CHANNELS)
+    {
+        (void) memset(oldest, 0, sizeof(*oldest));
+    }
+
+    ref->chnFreq = TEST_CHN_FREQ_BASE + (channel * TEST_CHN_SPACING);
+    return ref;
+}
+
+static void _refEd(int8_t edv, bool busy)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* ref = _refEntry(testChannel);
+
+    ref->edTime = testNow;
+    ref->edDBm = edv;
+    ref->edCount++;
+    ref->edHistory = (uint8_t) ((ref->edHistory << 1) | (busy ? 1U : 0U));
+    ref->edBusyCount += busy ? 1U : 0U;
+    ref->edHistoryLen += (ref->edHistoryLen < 8U) ? 1U : 0U;
+}
+
+static void _refRx(const TEST_FRAME* frame)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* ref = _refEntry(testChannel);
+
+    ref->rxTime = frame->end;
+    ref->rxCount++;
+}
+
+static TEST_DECISION _refDecision(void)
+{
+    DRV_RF215_CHN_OCCUPANCY_OBJ* ref = &testRef[testChannel];
+    uint8_t idleMask = (uint8_t) ((1U << RF215_ED_CACHE_IDLE_HISTORY) - 1U);
+
+    if ((ref->chnFreq == 0U) || (ref->edHistoryLen == 0U) ||
+            ((testNow - ref->edTime) >= DRV_RF215_ED_CACHE_VALID_US))
+    {
+        return TEST_DECISION_FULL;
+    }
+
+    if ((ref->edHistory & 1U) != 0U)
+    {
+        ref->ccaSkipped++;
+        return TEST_DECISION_SKIP;
+    }
+
+    if ((ref->edHistoryLen >= RF215_ED_CACHE_IDLE_HISTORY) && ((ref->edHistory & idleMask) == 0U) &&
+            (ref->rxTime <= ref->edTime))
+    {
+        ref->ccaShortened++;
+        return TEST_DECISION_SHORT;
+    }
+
+    return TEST_DECISION_FULL;
+}
+
+static void _refCheck(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    DRV_RF215_CHN_OCCUPANCY_OBJ occupancy;
+    DRV_RF215_CHN_OCCUPANCY_OBJ* ref;
+    uint8_t channel;
+
+    for (channel = 0U; channel < testScenario->channels; channel++)
+    {
+        ref = &testRef[channel];
+        pObj->pllParams.chnFreq = TEST_CHN_FREQ_BASE + (channel * TEST_CHN_SPACING);
+        if ((RF215_PHY_GetPib(TEST_TRX, RF215_PIB_PHY_CHANNEL_OCCUPANCY, &occupancy) != RF215_PIB_RESULT_SUCCESS) ||
+                (occupancy.chnFreq != ref->chnFreq) || (occupancy.edTime != ref->edTime) ||
+                (occupancy.rxTime != ref->rxTime) || (occupancy.edCount != ref->edCount) ||
+                (occupancy.edBusyCount != ref->edBusyCount) || (occupancy.rxCount != ref->rxCount) ||
+                (occupancy.ccaShortened != ref->ccaShortened) || (occupancy.ccaSkipped != ref->ccaSkipped) ||
+                ((ref->edCount != 0U) && (occupancy.edDBm != ref->edDBm)) ||
+                (occupancy.edHistory != ref->edHistory) || (occupancy.edHistoryLen != ref->edHistoryLen))
+        {
+            _fail("channel occupancy differs from the reference", channel);
+        }
+    }
+
+    pObj->pllParams.chnFreq = TEST_CHN_FREQ_BASE + (testChannel * TEST_CHN_SPACING);
+}
+
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transceiver and MAC Stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+/* TRXRDY of the RX command sent by the PHY */
+static void _trxListening(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+
+    pObj->trxState = RF215_RFn_STATE_RF_RX;
+    pObj->trxRdy = true;
+}
+
+static void _rxEnd(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+
+    testRxOn = false;
+    if (pObj->phyState != PHY_STATE_RX_HEADER)
+    {
+        return;
+    }
+
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    testResult.rxFrames++;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    /* RX indication from the PHY tasks */
+    pObj->rxInd.timeIniCount = testRxFrame.start;
+    pObj->rxInd.ppduDurationCount = (uint32_t) (testRxFrame.end - testRxFrame.start);
+    lRF215_PHY_EdCacheRxFrame(TEST_TRX, &pObj->rxInd);
+    if (testBypass == false)
+    {
+        _refRx(&testRxFrame);
+    }
+#endif
+}
+
+static void _rxStart(TEST_FRAME* frame)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+
+    if ((pObj->phyState == PHY_STATE_RX_LISTEN) && (frame->dBm >= TEST_SENSITIVITY_DBM))
+    {
+        pObj->phyState = PHY_STATE_RX_HEADER;
+        testRxOn = true;
+        testRxFrame = *frame;
+    }
+}
+
+static void _rxSchedule(void)
+{
+    TEST_FRAME* frame = _traceNext(testChannel);
+
+    testRxNext = (frame != NULL) ? frame->start : UINT64_MAX;
+}
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+static void _scanEnd(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    int8_t edv;
+
+    testScanEnd = UINT64_MAX;
+    if (pObj->edScanInProgress == false)
+    {
+        return;
+    }
+
+    /* EDC interrupt of the background ED */
+    edv = _traceEnergy(testChannel, testEdStart, testNow);
+    testDevRegs[RF215_RFn_EDV(TEST_TRX)] = (uint8_t) edv;
+    lRF215_PHY_EdScanComplete(TEST_TRX);
+    testResult.scans++;
+    if (testBypass == false)
+    {
+        _refEd(edv, _edBusy(edv));
+    }
+}
+
+#endif
+
+static void _macBackoff(void)
+{
+    testMacNB++;
+    testMacBE = (testMacBE < TEST_MAX_BE) ? (testMacBE + 1U) : TEST_MAX_BE;
+    if (testMacNB > TEST_MAX_BACKOFFS)
+    {
+        /* Channel access failure */
+        testResult.failures++;
+        testMacState = TEST_MAC_WAIT;
+        testMacTime = testNow + (uint64_t) _randExp(&testRandState, TEST_REQUEST_MEAN_US);
+        return;
+    }
+
+    testMacState = TEST_MAC_BACKOFF;
+    testMacTime = testNow + ((_rand64() % (1U << testMacBE)) * TEST_UNIT_BACKOFF_US);
+}
+
+static void _macConfirm(void)
+{
+    testTxBuffer.inUse = false;
+    testTxBuffer.cfmPending = false;
+}
+
+static void _macCca(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    DRV_RF215_TX_RESULT result;
+    TEST_DECISION decision = TEST_DECISION_FULL;
+    uint32_t fullUS = pObj->phyConfig.ccaEdDurationUS;
+    uint32_t edUS;
+
+    (void) memset(&testTxBuffer, 0, sizeof(testTxBuffer));
+    testTxBuffer.clientObj = &testClient;
+    testTxBuffer.inUse = true;
+    testTxBuffer.reqObj.psduLen = TEST_PSDU_LEN;
+    testTxBuffer.reqObj.ccaMode = PHY_CCA_MODE_3;
+    testTxBuffer.reqObj.modScheme = FSK_FEC_OFF;
+    testTxBuffer.reqObj.timeMode = TX_TIME_RELATIVE;
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    if (testBypass == true)
+    {
+        (void) memset(pObj->edCache, 0, sizeof(pObj->edCache));
+    }
+    else if (pObj->phyState != PHY_STATE_RX_HEADER)
+    {
+        decision = _refDecision();
+    }
+    else
+    {
+        /* Busy RX before the cache is looked up */
+    }
+#endif
+
+    /* TX parameters configuration and carrier sense */
+    result = lRF215_TX_ParamCfg(&testTxBuffer);
+    if (result == RF215_TX_BUSY_RX)
+    {
+        testResult.busyRx++;
+        _macConfirm();
+        _macBackoff();
+        return;
+    }
+
+    if (result == RF215_TX_BUSY_CHN)
+    {
+        testResult.ccaSkipped++;
+        if (decision != TEST_DECISION_SKIP)
+        {
+            _fail("busy channel reported without CCA", decision);
+        }
+
+        if (_edBusy(_traceEnergy(testChannel, testNow, testNow + fullUS)) == false)
+        {
+            testResult.falseSkips++;
+        }
+
+        _macConfirm();
+        _macBackoff();
+        return;
+    }
+
+    if (result != RF215_TX_SUCCESS)
+    {
+        _fail("TX parameters rejected", result);
+        _macConfirm();
+        _macBackoff();
+        return;
+    }
+
+    /* TX preparation: TRXRDY of the TXPREP command if it was sent from TRXOFF */
+    lRF215_TX_Prepare(TEST_TRX);
+    if (pObj->txPendingState == PHY_STATE_TX_TXPREP)
+    {
+        pObj->txPendingState = PHY_STATE_RESET;
+        pObj->trxRdy = true;
+        lRF215_TX_Prepare(TEST_TRX);
+    }
+
+    edUS = _edDuration();
+    if ((pObj->phyState != PHY_STATE_TX_TXPREP) || (edUS != pObj->txCcaEdDurationUS))
+    {
+        _fail("ED of the CCA not prepared as configured", edUS);
+    }
+
+    if ((decision == TEST_DECISION_SKIP) || ((decision == TEST_DECISION_SHORT) != (edUS < fullUS)) ||
+            ((decision == TEST_DECISION_FULL) && (edUS != fullUS)) || (edUS == 0U))
+    {
+        _fail("ED duration of the CCA differs from the reference", edUS);
+    }
+
+    testResult.ccaEd++;
+    testResult.ccaShortened += (edUS < fullUS) ? 1U : 0U;
+    testResult.edTimeSum += edUS;
+
+    /* ED with CCATX: TX if the channel is idle at the end */
+    lRF215_TX_Start(TEST_TRX);
+    testMacState = TEST_MAC_CCA_ED;
+    testMacTime = testNow + edUS;
+}
+
+static void _macEdEnd(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    uint32_t fullUS = pObj->phyConfig.ccaEdDurationUS;
+    int8_t edv = _traceEnergy(testChannel, testEdStart, testNow);
+    uint64_t txEnd;
+    uint16_t symbols;
+    bool busy = _edBusy(edv);
+
+    /* EDC interrupt: EDV and AMCS.CCAED read by the PHY */
+    testDevRegs[RF215_RFn_EDV(TEST_TRX)] = (uint8_t) edv;
+    testDevRegs[RF215_BBCn_AMCS(TEST_TRX)] |= RF215_BBCn_AMCS_CCAED;
+    if (busy == false)
+    {
+        testDevRegs[RF215_BBCn_AMCS(TEST_TRX)] &= (uint8_t) ~RF215_BBCn_AMCS_CCAED;
+    }
+
+    lRF215_TX_EnDetectComplete(TEST_TRX);
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    if (testBypass == false)
+    {
+        _refEd(edv, busy);
+    }
+#endif
+
+    if (busy == true)
+    {
+        if ((testTxBuffer.cfmPending == false) || (testTxBuffer.cfmObj.txResult != RF215_TX_BUSY_CHN))
+        {
+            _fail("busy CCA not confirmed", testTxBuffer.cfmObj.txResult);
+        }
+
+        _trxListening();
+        _macConfirm();
+        _macBackoff();
+        return;
+    }
+
+    if (pObj->phyState != PHY_STATE_TX)
+    {
+        _fail("TX not started after an idle CCA", pObj->phyState);
+    }
+
+    /* Full ED before the TX start would have seen the channel busy */
+    if (_edBusy(_traceEnergy(testChannel, testNow - fullUS, testNow)) == true)
+    {
+        testResult.missed++;
+    }
+
+    txEnd = testNow + lRF215_PHY_PpduDuration(&pObj->phyConfig, FSK_FEC_OFF, TEST_PSDU_LEN, &symbols);
+    if (_traceOverlap(testChannel, testNow, txEnd) == true)
+    {
+        testResult.collisions++;
+    }
+
+    testResult.sent++;
+    testResult.latencySum += testNow - testMacRequest;
+    testMacState = TEST_MAC_TX;
+    testMacTime = txEnd;
+}
+
+static void _macTxEnd(void)
+{
+    /* TXFE: back to RX and TX confirm */
+    lRF215_TX_FrameEnd(TEST_TRX);
+    _trxListening();
+    if ((testTxBuffer.cfmPending == false) || (testTxBuffer.cfmObj.txResult != RF215_TX_SUCCESS))
+    {
+        _fail("TX not confirmed", testTxBuffer.cfmObj.txResult);
+    }
+
+    _macConfirm();
+    testMacState = TEST_MAC_WAIT;
+    testMacTime = testNow + (uint64_t) _randExp(&testRandState, TEST_REQUEST_MEAN_US);
+}
+
+static void _macEvent(void)
+{
+    switch (testMacState)
+    {
+        case TEST_MAC_WAIT:
+            /* New frame: first backoff */
+            testResult.requests++;
+            testMacRequest = testNow;
+            testMacNB = 0U;
+            testMacBE = TEST_MIN_BE;
+            testMacState = TEST_MAC_BACKOFF;
+            testMacTime = testNow + ((_rand64() % (1U << testMacBE)) * TEST_UNIT_BACKOFF_US);
+            break;
+
+        case TEST_MAC_BACKOFF:
+            _macCca();
+            break;
+
+        case TEST_MAC_CCA_ED:
+            _macEdEnd();
+            break;
+
+        default:
+            _macTxEnd();
+            break;
+    }
+}
+
+static void _hop(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+
+    /* New channel: RX restarted, reception in progress lost */
+    testChannel = (uint8_t) (_rand64() % testScenario->channels);
+    pObj->pllParams.chnFreq = TEST_CHN_FREQ_BASE + (testChannel * TEST_CHN_SPACING);
+    testRxOn = false;
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    lRF215_TRX_RxListen(TEST_TRX);
+    _trxListening();
+    _rxSchedule();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation
+// *****************************************************************************
+// *****************************************************************************
+
+static void _run(const TEST_SCENARIO* scenario, bool bypass, uint64_t duration)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    uint64_t next, nextScan, nextHop;
+    uint8_t channel;
+
+    testScenario = scenario;
+    testBypass = bypass;
+    (void) memset(&testResult, 0, sizeof(testResult));
+    (void) memset(testTraces, 0, sizeof(testTraces));
+    for (channel = 0U; channel < TEST_CHANNELS_MAX; channel++)
+    {
+        testTraces[channel].randState = 0x9E3779B97F4A7C15ULL * (channel + 1U);
+    }
+    testRandState = 0xD1B54A32D192ED03ULL;
+    testNow = 0U;
+    testChannel = 0U;
+    testRxOn = false;
+    testScanEnd = UINT64_MAX;
+
+    pObj->pllParams.chnFreq = TEST_CHN_FREQ_BASE;
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    pObj->txStarted = false;
+    pObj->txPendingState = PHY_STATE_RESET;
+    _trxListening();
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    (void) memset(pObj->edCache, 0, sizeof(pObj->edCache));
+    (void) memset(testRef, 0, sizeof(testRef));
+#if (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+    pObj->edScanInProgress = false;
+#endif
+#endif
+
+    testMacState = TEST_MAC_WAIT;
+    testMacTime = (uint64_t) _randExp(&testRandState, TEST_REQUEST_MEAN_US);
+    nextScan = TEST_SCAN_PERIOD_US;
+    nextHop = (scenario->hopPeriodUS != 0U) ? scenario->hopPeriodUS : UINT64_MAX;
+    _rxSchedule();
+
+    while ((testNow < duration) || (testMacState != TEST_MAC_WAIT))
+    {
+        next = testMacTime;
+        next = (testRxOn && (testRxFrame.end < next)) ? testRxFrame.end : next;
+        next = (testRxNext < next) ? testRxNext : next;
+        next = (testScanEnd < next) ? testScanEnd : next;
+        next = (DRV_RF215_ED_SCAN_PERIOD_US != 0U) && (nextScan < next) ? nextScan : next;
+        next = ((testMacState == TEST_MAC_WAIT) && (nextHop < next)) ? nextHop : next;
+        testNow = next;
+
+        if (testRxOn && (testRxFrame.end == testNow))
+        {
+            _rxEnd();
+        }
+        else if (testRxNext == testNow)
+        {
+            TEST_FRAME* frame;
+
+            /* _traceNext returns the frame after now: look it up at its start */
+            testNow--;
+            frame = _traceNext(testChannel);
+            testNow++;
+            _rxStart(frame);
+            _rxSchedule();
+        }
+        else if (testScanEnd == testNow)
+        {
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+            _scanEnd();
+#else
+            testScanEnd = UINT64_MAX;
+#endif
+        }
+        else if (nextScan == testNow)
+        {
+            nextScan += TEST_SCAN_PERIOD_US;
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U) && (DRV_RF215_ED_SCAN_PERIOD_US != 0U)
+            if (testBypass == false)
+            {
+                lRF215_PHY_EdScanTimeExpired(TEST_TRX);
+            }
+#endif
+        }
+        else if (testMacTime == testNow)
+        {
+            _macEvent();
+        }
+        else
+        {
+            nextHop += scenario->hopPeriodUS;
+            _hop();
+        }
+    }
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+    if (testBypass == false)
+    {
+        _refCheck();
+    }
+#endif
+}
+
+static void _print(const char* name, const TEST_RESULT* result)
+{
+    printf("  %-8s %6u %6u %5u %8.0f %7.1f %7u %7u %9u %7u %6u %6u %6u\n", name, (unsigned) result->requests,
+            (unsigned) result->sent, (unsigned) result->failures,
+            (result->sent != 0U) ? ((double) result->latencySum / result->sent) : 0.0,
+            (result->ccaEd + result->ccaSkipped != 0U) ?
+            ((double) result->edTimeSum / (result->ccaEd + result->ccaSkipped)) : 0.0,
+            (unsigned) result->ccaEd, (unsigned) result->ccaSkipped, (unsigned) result->ccaShortened,
+            (unsigned) result->falseSkips, (unsigned) result->missed, (unsigned) result->collisions,
+            (unsigned) result->scans);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[TEST_TRX];
+    const TEST_SCENARIO* scenario;
+    TEST_RESULT full;
+    uint64_t duration = (uint64_t) TEST_DEFAULT_SECONDS * 1000000U;
+    size_t idx;
+
+    if (argc > 1)
+    {
+        duration = (uint64_t) strtoul(argv[1], NULL, 0) * 1000000U;
+    }
+
+    testScenario = &testScenarios[0];
+    if (lRF215_PHY_BandOpModeToPhyCfg(SUN_FSK_BAND_863_OPM1, &pObj->phyConfig) == false)
+    {
+        _fail("no FSK 863 MHz operating mode 1", 0U);
+        printf("FAIL\n");
+        return 1;
+    }
+
+    /* Front-end registers of the configuration (AGC update time) */
+    lRF215_TXRXFE_Regs(pObj, &pObj->phyRegs);
+    lRF215_RXFE_AdjustEDD(TEST_TRX);
+    testDevRegs[RF215_RFn_EDD(TEST_TRX)] = pObj->phyRegs.RFn_EDD;
+    testClient.trxIndex = TEST_TRX;
+
+    printf("FSK 863 MHz OPM1: ED %u us, threshold %d dBm, PSDU %u bytes, cache %u channels (valid %u us), "
+            "scan %u us\n", (unsigned) pObj->phyConfig.ccaEdDurationUS, (int) pObj->phyConfig.ccaEdThresholdDBm,
+            TEST_PSDU_LEN, (unsigned) DRV_RF215_ED_CACHE_CHANNELS, (unsigned) DRV_RF215_ED_CACHE_VALID_US,
+            (unsigned) DRV_RF215_ED_SCAN_PERIOD_US);
+    printf("  %-8s %6s %6s %5s %8s %7s %7s %7s %9s %7s %6s %6s %6s\n", "", "frames", "sent", "fail",
+            "latency", "ED us", "CCA ED", "skipped", "shortened", "false", "missed", "coll.", "scans");
+
+    for (idx = 0U; idx < (sizeof(testScenarios) / sizeof(testScenarios[0])); idx++)
+    {
+        scenario = &testScenarios[idx];
+        printf("%s (%u channel%s, mean gap %u ms):\n", scenario->name, (unsigned) scenario->channels,
+                (scenario->channels > 1U) ? "s" : "", (unsigned) (scenario->gapMeanUS / 1000U));
+
+        _run(scenario, true, duration);
+        full = testResult;
+        _print("full ED", &full);
+        if ((full.ccaShortened != 0U) || (full.ccaSkipped != 0U))
+        {
+            _fail("CCA without full ED", full.ccaShortened + full.ccaSkipped);
+        }
+
+#if (DRV_RF215_ED_CACHE_CHANNELS != 0U)
+        _run(scenario, false, duration);
+        _print("cache", &testResult);
+
+        if ((idx == 0U) && ((testResult.edTimeSum * full.ccaEd) >= (full.edTimeSum * testResult.ccaEd)))
+        {
+            _fail("mean ED time not reduced on a quiet channel", (unsigned long) testResult.edTimeSum);
+        }
+
+        if ((idx == 1U) && (testResult.ccaEd >= full.ccaEd))
+        {
+            _fail("CCA ED measurements not reduced on a busy channel", testResult.ccaEd);
+        }
+
+        if ((testResult.falseSkips * 100U) > (testResult.ccaSkipped * TEST_FALSE_SKIPS_PCT))
+        {
+            _fail("too many busy channels reported without CCA on an idle channel", testResult.falseSkips);
+        }
+
+        if ((testResult.missed * 1000U) > ((full.missed * 1000U) + testResult.sent))
+        {
+            _fail("missed detections", testResult.missed);
+        }
+
+        if ((testResult.collisions * 100U) > ((full.collisions * (100U + TEST_COLLISIONS_PCT)) + 500U))
+        {
+            _fail("collisions", testResult.collisions);
+        }
+#endif
+    }
+
+    printf("%s\n", (testErrors == 0U) ? "PASS" : "FAIL");
+    return (testErrors == 0U) ? 0 : 1;
+}
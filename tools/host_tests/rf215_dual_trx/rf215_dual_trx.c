@@ -0,0 +1,849 @@
+/*******************************************************************************
+  RF215 dual transceiver test
+
+  File Name:
+    rf215_dual_trx.c
+
+  Summary:
+    Host simulation of interleaved interrupts and SPI accesses of both RF215
+    transceivers through the RF215 driver HAL.
+
+  Description:
+    rf215_hal.c of a configuration with both transceivers is built for the
+    host with the SPI PLIB, the external interrupt pin and the RF215 replaced
+    by a timed model: SPI transfers take RF215_SPI_BYTE_DURATION_US_Q5 per
+    byte plus the DMA restart, the IRQS registers are cleared on read and the
+    IRQ line raises the pin interrupt, which is kept pending while the HAL
+    has it disabled. A stand-in of the driver reads the IRQS registers from
+    the pin interrupt and drives both transceivers from the flags:
+
+    - RF09 transmits a frame of 64 to 576 bytes 2 to 5 ms after the previous
+      one ends: AMCS, TXFLL and TX command writes, then the frame buffer.
+      The RF215 sends the payload at 2.4 Mb/s from 160 us after the TX
+      command, so every frame buffer byte must be written before it is sent.
+    - RF24 receives frames of 10 to 127 bytes at 250 kb/s, some back to back
+      (192 us of preamble and header from one frame end to the next payload)
+      and some after an idle time. On RXFS the length (RXFLL) and the EDV
+      (from tasks) are read; on RXFE the payload is read from the frame
+      buffer and the RX command written. The frame buffer must be read before
+      the next frame overwrites it.
+
+    Every transmitted frame must be in the RF09 frame buffer when it ends,
+    every received frame must be read intact, every IRQ flag must be read
+    once, the RF24 read callbacks must come in the order they were queued and
+    the external interrupt must be enabled at the end. The SPI statistics must
+    agree with the model. The test prints the IRQ latencies (flag raised to
+    IRQS read) of each transceiver, the RF24 register read and payload
+    latencies, the lost RF24 frames and the smallest margin of the RF09 frame
+    buffer writes.
+
+    rf215_dual_trx_fifo is built with the HAL queue of a single transceiver
+    (no accesses inserted ahead of the other transceiver, no split frame
+    buffer writes) as the baseline, and does not fail on lost frames.
+
+    Usage:
+      rf215_dual_trx [seconds]        simulated time (60 s by default)
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "configuration.h"
+#include "system/ports/sys_ports.h"
+
+#ifdef TEST_FIFO_QUEUE
+/* Baseline: SPI queue of the HAL with a single transceiver */
+#undef DRV_RF215_NUM_TRX
+#define DRV_RF215_NUM_TRX               1U
+#endif
+
+/* The PIO PLIB inlines the pin interrupt control and the pin read, which
+ * access the PIO registers: they go to the pin model here */
+static void _pinIntEnable(bool enable);
+static bool _pinRead(void);
+#define PIO_PinInterruptEnable(pin)     _pinIntEnable(true)
+#define PIO_PinInterruptDisable(pin)    _pinIntEnable(false)
+#define SYS_PORT_PinRead(pin)           _pinRead()
+
+#include "driver/rf215/hal/rf215_hal.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_SECONDS    60U
+#define TEST_DEV_REGS_SIZE      0x4000U
+#define TEST_MAX_FAILS_SHOWN    10U
+
+/* SYS_TIME at 32 MHz: one count is 1/32 us, so a SPI byte takes
+ * RF215_SPI_BYTE_DURATION_US_Q5 counts. DMA interrupt and restart take as
+ * long as 2 bytes */
+#define TEST_SYS_TIME_FREQ      32000000U
+#define TEST_US(us)             ((uint64_t)(us) * 32U)
+#define TEST_SPI_OVERHEAD       (2U * RF215_SPI_BYTE_DURATION_US_Q5)
+
+/* Main loop period: RF215_HAL_Tasks and the RF09 TX requests */
+#define TEST_LOOP               TEST_US(50U)
+
+/* Time given at the end to finish the SPI transfers and read the IRQs */
+#define TEST_DRAIN              TEST_US(100000U)
+
+/* RF09: 2.4 Mb/s, payload sent 160 us after the TX command */
+#define TEST_RF09_BYTE          107U
+#define TEST_RF09_SHR           TEST_US(160U)
+#define TEST_RF09_LEN_MIN       64U
+#define TEST_RF09_PERIOD_MIN    2000U
+#define TEST_RF09_PERIOD_MAX    5000U
+
+/* RF24: 250 kb/s, 192 us of preamble and header before the payload */
+#define TEST_RF24_BYTE          TEST_US(32U)
+#define TEST_RF24_SHR           TEST_US(192U)
+#define TEST_RF24_LEN_MIN       10U
+#define TEST_RF24_LEN_MAX       127U
+#define TEST_RF24_IDLE_MEAN     2000.0
+#define TEST_RF24_FRAMES        64U
+
+/* RF24 reads in flight */
+#define TEST_READS              16U
+
+/* Registers of the model */
+#define TEST_RF09_CMD           (RF215_BASE_ADDR_RF09 + 0x03U)
+#define TEST_RF24_CMD           (RF215_BASE_ADDR_RF24 + 0x03U)
+#define TEST_RF24_EDV           (RF215_BASE_ADDR_RF24 + 0x10U)
+#define TEST_BBC0_TXFLL         (RF215_BASE_ADDR_BBC0 + 0x06U)
+#define TEST_BBC0_AMCS          (RF215_BASE_ADDR_BBC0 + 0x40U)
+#define TEST_BBC1_RXFLL         (RF215_BASE_ADDR_BBC1 + 0x04U)
+#define TEST_BBC0_FBTXS         (RF215_BASE_ADDR_FRAME_BUF_BBC0 + 0x800U)
+#define TEST_BBC1_FBRXS         RF215_BASE_ADDR_FRAME_BUF_BBC1
+#define TEST_IRQS_RF09          0U
+#define TEST_IRQS_RF24          1U
+#define TEST_IRQS_BBC0          2U
+#define TEST_IRQS_BBC1          3U
+#define TEST_IRQS_NUM           4U
+
+typedef enum
+{
+    TEST_READ_RXFL = 0,
+    TEST_READ_EDV,
+    TEST_READ_PAYLOAD,
+} TEST_READ_KIND;
+
+typedef struct
+{
+    uint64_t max;
+    uint64_t sum;
+    uint32_t num;
+} TEST_LATENCY;
+
+/* Model of the RF215 SPI: transfer in progress */
+typedef struct
+{
+    FLEXCOM_SPI_CALLBACK callback;
+    uintptr_t context;
+    bool busy;
+    uint16_t addr;
+    size_t size;
+    uint64_t timeStart;
+    uint64_t timeEnd;
+    /* Transfer that finished last, whose callbacks are running */
+    uint16_t doneAddr;
+    uint64_t doneTimeStart;
+} TEST_SPI;
+
+/* RF09 transmitter: PHY stand-in and RF215 model */
+typedef struct
+{
+    uint8_t psdu[DRV_RF215_MAX_PSDU_LEN];
+    uint8_t amcs[2];
+    uint8_t txfl[2];
+    uint8_t cmd;
+    uint16_t len;
+    uint64_t timeRequest;
+    uint64_t timeStart;
+    uint64_t timeEnd;
+    int64_t marginMin;
+    uint32_t frames;
+    uint32_t underruns;
+    bool queued;
+    bool started;
+} TEST_RF09;
+
+/* RF24 read in flight */
+typedef struct
+{
+    uint8_t data[TEST_RF24_LEN_MAX];
+    uint64_t timeQueued;
+    uint32_t seq;
+    uint32_t frame;
+    size_t size;
+    TEST_READ_KIND kind;
+} TEST_READ;
+
+/* RF24 receiver: RF215 model and PHY stand-in */
+typedef struct
+{
+    TEST_READ reads[TEST_READS];
+    uint64_t rxfeTime[TEST_RF24_FRAMES];
+    uint8_t len[TEST_RF24_FRAMES];
+    uint64_t timeRxfs;
+    uint64_t timeRxfe;
+    uint32_t frame;
+    uint32_t rxfeFrame;
+    uint32_t framesEnded;
+    uint32_t indicated;
+    uint32_t readSeq;
+    uint32_t readSeqDone;
+    uint32_t accesses;
+    uint32_t cmdWrites;
+    uint32_t cmdWritesDev;
+    uint16_t phyLen;
+    uint8_t cmd;
+    uint8_t readNext;
+    bool receiving;
+} TEST_RF24;
+
+static uint8_t testDevRegs[TEST_DEV_REGS_SIZE];
+static uint8_t testIrqs[TEST_IRQS_NUM];
+static uint64_t testIrqTime[TEST_IRQS_NUM][8];
+static unsigned long testIrqRaised, testIrqRead, testIrqDispatched;
+static TEST_LATENCY testIrqLatency[2];
+static TEST_LATENCY testRxflLatency;
+static TEST_LATENCY testPayloadLatency;
+static TEST_SPI testSpi;
+static TEST_RF09 testRf09;
+static TEST_RF24 testRf24;
+static PIO_PIN_CALLBACK testPinCallback;
+static uintptr_t testPinContext;
+static bool testPinIntEnabled;
+static bool testPinEdge;
+static bool testStopping;
+static uint64_t testTime;
+static uint64_t testNextLoop;
+static unsigned long testErrors;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SPI PLIB, Port and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char *message, unsigned long value)
+{
+    if (testErrors < TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %.3f ms: %s (%lu)\n", (double)testTime / (TEST_SYS_TIME_FREQ / 1000.0), message, value);
+    }
+    testErrors++;
+}
+
+static void _latencyAdd(TEST_LATENCY *latency, uint64_t value)
+{
+    latency->sum += value;
+    latency->num++;
+    if (value > latency->max)
+    {
+        latency->max = value;
+    }
+}
+
+static bool _irqLine(void)
+{
+    return ((testDevRegs[0] | testDevRegs[1] | testDevRegs[2] | testDevRegs[3]) != 0U);
+}
+
+static void _pinIntEnable(bool enable)
+{
+    testPinIntEnabled = enable;
+}
+
+static bool _pinRead(void)
+{
+    return _irqLine();
+}
+
+static void _rf09Write(uint16_t addr, const uint8_t *pData, size_t size, uint64_t timeFirst);
+
+static bool _spiIsBusy(void)
+{
+    return testSpi.busy;
+}
+
+static bool _spiWriteRead(void* pTransmitData, size_t txSize, void* pReceiveData, size_t rxSize)
+{
+    uint8_t* pTx = pTransmitData;
+    uint8_t* pRx = pReceiveData;
+    uint16_t cmd = ((uint16_t)pTx[0] << 8) | pTx[1];
+    uint16_t addr = cmd & 0x3FFFU;
+    size_t size = txSize - RF215_SPI_CMD_SIZE;
+    uint64_t timeFirst = testTime + (RF215_SPI_CMD_SIZE * RF215_SPI_BYTE_DURATION_US_Q5);
+    uint8_t bit;
+    size_t idx;
+
+    if (testSpi.busy == true)
+    {
+        _fail("SPI transfer launched while another one is in progress", addr);
+        return false;
+    }
+
+    /* The RF215 executes the transfer as the bytes go through */
+    if ((cmd & RF215_SPI_CMD_MODE_WRITE) != 0U)
+    {
+        (void) memcpy(&testDevRegs[addr], &pTx[RF215_SPI_CMD_SIZE], size);
+        _rf09Write(addr, &pTx[RF215_SPI_CMD_SIZE], size, timeFirst);
+        if ((addr <= TEST_RF24_CMD) && ((addr + size) > TEST_RF24_CMD))
+        {
+            testRf24.cmdWritesDev++;
+        }
+    }
+    else
+    {
+        (void) memcpy(&pRx[RF215_SPI_CMD_SIZE], &testDevRegs[addr], size);
+        for (idx = addr; (idx < TEST_IRQS_NUM) && (idx < (addr + size)); idx++)
+        {
+            /* IRQS registers are cleared on read */
+            for (bit = 0U; bit < 8U; bit++)
+            {
+                if ((testDevRegs[idx] & (1U << bit)) != 0U)
+                {
+                    _latencyAdd(&testIrqLatency[idx & 1U], testTime - testIrqTime[idx][bit]);
+                    testIrqRead++;
+                }
+            }
+            testDevRegs[idx] = 0U;
+        }
+    }
+
+    testSpi.busy = true;
+    testSpi.addr = addr;
+    testSpi.size = txSize;
+    testSpi.timeStart = testTime;
+    testSpi.timeEnd = testTime + (txSize * RF215_SPI_BYTE_DURATION_US_Q5) + TEST_SPI_OVERHEAD;
+    (void) rxSize;
+    return true;
+}
+
+static void _spiSetCallback(FLEXCOM_SPI_CALLBACK callback, uintptr_t context)
+{
+    testSpi.callback = callback;
+    testSpi.context = context;
+}
+
+void PIO_PortSet(PIO_PORT port, uint32_t mask) { (void) port; (void) mask; }
+void PIO_PortClear(PIO_PORT port, uint32_t mask) { (void) port; (void) mask; }
+
+bool PIO_PinInterruptCallbackRegister(PIO_PIN pin, const PIO_PIN_CALLBACK callback, uintptr_t context)
+{
+    (void) pin;
+    testPinCallback = callback;
+    testPinContext = context;
+    return true;
+}
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+uint64_t SYS_TIME_Counter64Get(void) { return testTime; }
+uint32_t SYS_TIME_FrequencyGet(void) { return TEST_SYS_TIME_FREQ; }
+
+SYS_TIME_RESULT SYS_TIME_DelayUS(uint32_t us, SYS_TIME_HANDLE* handle)
+{
+    (void) us; (void) handle;
+    return SYS_TIME_ERROR;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RF215 Model
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t _randRange(uint32_t min, uint32_t max)
+{
+    return min + (uint32_t)(_rand64() % (uint64_t)(max - min + 1U));
+}
+
+static uint8_t _rf24Byte(uint32_t frame, size_t idx)
+{
+    return (uint8_t)((frame * 151U) + (idx * 29U) + (idx >> 3));
+}
+
+static void _raiseIrq(uint8_t reg, uint8_t mask)
+{
+    uint8_t bit;
+
+    if (_irqLine() == false)
+    {
+        /* Rising edge of the IRQ line: pin interrupt pending */
+        testPinEdge = true;
+    }
+
+    for (bit = 0U; bit < 8U; bit++)
+    {
+        if (((mask & (1U << bit)) != 0U) && ((testDevRegs[reg] & (1U << bit)) == 0U))
+        {
+            testIrqTime[reg][bit] = testTime;
+            testIrqRaised++;
+        }
+    }
+
+    testDevRegs[reg] |= mask;
+}
+
+/* Writes to the RF09 registers and frame buffer */
+static void _rf09Write(uint16_t addr, const uint8_t *pData, size_t size, uint64_t timeFirst)
+{
+    uint16_t offset;
+    int64_t margin;
+
+    if ((addr <= TEST_RF09_CMD) && ((addr + size) > TEST_RF09_CMD) &&
+            (pData[TEST_RF09_CMD - addr] == RF215_RFn_CMD_RF_TX))
+    {
+        testRf09.started = true;
+        testRf09.timeStart = timeFirst + ((TEST_RF09_CMD - addr) * RF215_SPI_BYTE_DURATION_US_Q5);
+        testRf09.timeEnd = testRf09.timeStart + TEST_RF09_SHR +
+                ((uint64_t)(testDevRegs[TEST_BBC0_TXFLL] | ((testDevRegs[TEST_BBC0_TXFLL + 1U] & 0x7U) << 8)) *
+                TEST_RF09_BYTE);
+    }
+
+    if ((addr >= TEST_BBC0_FBTXS) && (addr < RF215_BASE_ADDR_FRAME_BUF_BBC1))
+    {
+        if (testRf09.started == false)
+        {
+            _fail("RF09 frame buffer written before the TX command", addr);
+            return;
+        }
+
+        /* The first byte of the chunk is the closest to be sent */
+        offset = addr - TEST_BBC0_FBTXS;
+        margin = (int64_t)(testRf09.timeStart + TEST_RF09_SHR + ((uint64_t)offset * TEST_RF09_BYTE)) -
+                (int64_t)timeFirst;
+        if (margin < testRf09.marginMin)
+        {
+            testRf09.marginMin = margin;
+        }
+
+        if (margin < 0)
+        {
+            testRf09.underruns++;
+        }
+    }
+}
+
+/* RF09 frame sent */
+static void _rf09TxEnd(void)
+{
+    if (memcmp(&testDevRegs[TEST_BBC0_FBTXS], testRf09.psdu, testRf09.len) != 0)
+    {
+        _fail("RF09 frame buffer differs from the frame at the end of TX", testRf09.frames);
+    }
+
+    testRf09.started = false;
+    _raiseIrq(TEST_IRQS_BBC0, RF215_BBCn_IRQ_TXFE);
+}
+
+/* RF24 frame: payload starts (RXFS) and ends (RXFE) */
+static void _rf24RxStart(void)
+{
+    uint32_t frame = ++testRf24.frame;
+    uint8_t len = (uint8_t)_randRange(TEST_RF24_LEN_MIN, TEST_RF24_LEN_MAX);
+    size_t idx;
+
+    /* The frame buffer is written as the frame is received: a read launched
+     * after the next RXFS gets data of the next frame */
+    testRf24.len[frame % TEST_RF24_FRAMES] = len;
+    testDevRegs[TEST_BBC1_RXFLL] = len;
+    testDevRegs[TEST_BBC1_RXFLL + 1U] = 0U;
+    for (idx = 0; idx < len; idx++)
+    {
+        testDevRegs[TEST_BBC1_FBRXS + idx] = _rf24Byte(frame, idx);
+    }
+
+    testRf24.receiving = true;
+    testRf24.timeRxfe = testTime + ((uint64_t)len * TEST_RF24_BYTE);
+    _raiseIrq(TEST_IRQS_BBC1, RF215_BBCn_IRQ_RXFS);
+}
+
+static void _rf24RxEnd(void)
+{
+    double idle = 0.0;
+
+    testRf24.receiving = false;
+    testRf24.rxfeFrame = testRf24.frame;
+    testRf24.rxfeTime[testRf24.frame % TEST_RF24_FRAMES] = testTime;
+    testRf24.framesEnded++;
+    _raiseIrq(TEST_IRQS_BBC1, RF215_BBCn_IRQ_RXFE);
+
+    /* Next frame: back to back or after an idle time */
+    if (_randRange(0U, 4U) != 0U)
+    {
+        idle = -TEST_RF24_IDLE_MEAN * log(((double)(_rand64() >> 11) + 1.0) / 9007199254740993.0);
+    }
+    testRf24.timeRxfs = testTime + TEST_RF24_SHR + TEST_US((uint64_t)idle);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Driver and PHY Stand-ins
+// *****************************************************************************
+// *****************************************************************************
+
+static void _rf24ReadCallback(uintptr_t context, void* pData, uint64_t time);
+
+static void _rf24Read(uint16_t addr, size_t size, TEST_READ_KIND kind, uint32_t frame, bool fromTasks)
+{
+    TEST_READ *read = &testRf24.reads[testRf24.readNext];
+
+    if ((testRf24.readSeq - testRf24.readSeqDone) >= TEST_READS)
+    {
+        _fail("too many RF24 reads in flight", testRf24.readSeq - testRf24.readSeqDone);
+        return;
+    }
+
+    read->seq = ++testRf24.readSeq;
+    read->kind = kind;
+    read->frame = frame;
+    read->size = size;
+    read->timeQueued = testTime;
+    testRf24.accesses++;
+    if (fromTasks == true)
+    {
+        RF215_HAL_SpiReadFromTasks(addr, read->data, size, _rf24ReadCallback, testRf24.readNext);
+    }
+    else
+    {
+        RF215_HAL_SpiRead(addr, read->data, size, _rf24ReadCallback, testRf24.readNext);
+    }
+    testRf24.readNext = (testRf24.readNext + 1U) % TEST_READS;
+}
+
+static void _rf24ReadCallback(uintptr_t context, void* pData, uint64_t time)
+{
+    TEST_READ *read = &testRf24.reads[context];
+    uint32_t frame = read->frame;
+    uint8_t len = testRf24.len[frame % TEST_RF24_FRAMES];
+    size_t idx;
+    bool intact;
+
+    if (read->seq != (testRf24.readSeqDone + 1U))
+    {
+        _fail("RF24 read callback out of order", read->seq);
+    }
+    testRf24.readSeqDone = read->seq;
+
+    if (read->kind == TEST_READ_RXFL)
+    {
+        testRf24.phyLen = read->data[0] | ((uint16_t)read->data[1] << 8);
+        _latencyAdd(&testRxflLatency, time - read->timeQueued);
+    }
+    else if (read->kind == TEST_READ_PAYLOAD)
+    {
+        intact = (read->size == len);
+        for (idx = 0; intact && (idx < len); idx++)
+        {
+            intact = (read->data[idx] == _rf24Byte(frame, idx));
+        }
+
+        if (intact)
+        {
+            testRf24.indicated++;
+            _latencyAdd(&testPayloadLatency, time - testRf24.rxfeTime[frame % TEST_RF24_FRAMES]);
+        }
+    }
+    else
+    {
+        /* EDV read from tasks */
+    }
+}
+
+static void _irqsCallback(uintptr_t context, void* pData, uint64_t time)
+{
+    uint8_t* flags = pData;
+    uint8_t idx, bit;
+
+    for (idx = 0U; idx < TEST_IRQS_NUM; idx++)
+    {
+        for (bit = 0U; bit < 8U; bit++)
+        {
+            testIrqDispatched += ((flags[idx] >> bit) & 1U);
+        }
+    }
+
+    if ((flags[TEST_IRQS_BBC0] & RF215_BBCn_IRQ_TXFE) != 0U)
+    {
+        /* RF09 TX confirm: next frame */
+        testRf09.queued = false;
+        testRf09.frames++;
+        testRf09.timeRequest = time + TEST_US(_randRange(TEST_RF09_PERIOD_MIN, TEST_RF09_PERIOD_MAX));
+    }
+
+    if ((flags[TEST_IRQS_BBC1] & RF215_BBCn_IRQ_RXFE) != 0U)
+    {
+        /* RF24 RX end: read the payload and receive again */
+        if ((testRf24.phyLen >= TEST_RF24_LEN_MIN) && (testRf24.phyLen <= TEST_RF24_LEN_MAX))
+        {
+            _rf24Read(TEST_BBC1_FBRXS, testRf24.phyLen, TEST_READ_PAYLOAD, testRf24.rxfeFrame, false);
+        }
+
+        testRf24.cmd = RF215_RFn_CMD_RF_RX;
+        testRf24.accesses++;
+        testRf24.cmdWrites++;
+        RF215_HAL_SpiWrite(TEST_RF24_CMD, &testRf24.cmd, 1U);
+    }
+
+    if ((flags[TEST_IRQS_BBC1] & RF215_BBCn_IRQ_RXFS) != 0U)
+    {
+        /* RF24 RX start: frame length and energy */
+        _rf24Read(TEST_BBC1_RXFLL, 2U, TEST_READ_RXFL, testRf24.frame, false);
+        _rf24Read(TEST_RF24_EDV, 1U, TEST_READ_EDV, testRf24.frame, true);
+    }
+}
+
+void DRV_RF215_ExtIntHandler(void)
+{
+    /* Read IRQ Status registers (RF09_IRQS, RF24_IRQS, BBC0_IRQS, BBC1_IRQS) */
+    RF215_HAL_SpiRead(RF215_RF09_IRQS, testIrqs, TEST_IRQS_NUM, _irqsCallback, 0);
+}
+
+/* RF09 PHY: TX request from tasks */
+static void _rf09TxRequest(void)
+{
+    size_t idx;
+
+    testRf09.len = (uint16_t)_randRange(TEST_RF09_LEN_MIN, DRV_RF215_MAX_PSDU_LEN);
+    for (idx = 0; idx < testRf09.len; idx++)
+    {
+        testRf09.psdu[idx] = (uint8_t)_rand64();
+    }
+
+    testRf09.amcs[0] = RF215_BBCn_AMCS_TX2RX;
+    testRf09.amcs[1] = 0x80U;
+    testRf09.txfl[0] = (uint8_t)testRf09.len;
+    testRf09.txfl[1] = (uint8_t)(testRf09.len >> 8);
+    testRf09.cmd = RF215_RFn_CMD_RF_TX;
+    testRf09.queued = true;
+
+    RF215_HAL_SpiWrite(TEST_BBC0_AMCS, testRf09.amcs, 2U);
+    RF215_HAL_SpiWrite(TEST_BBC0_TXFLL, testRf09.txfl, 2U);
+    RF215_HAL_SpiWrite(TEST_RF09_CMD, &testRf09.cmd, 1U);
+    RF215_HAL_SpiWrite(TEST_BBC0_FBTXS, testRf09.psdu, testRf09.len);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation
+// *****************************************************************************
+// *****************************************************************************
+
+/* SPI transfer in progress finishes: DMA interrupt */
+static void _spiComplete(void)
+{
+    testSpi.busy = false;
+    testSpi.doneAddr = testSpi.addr;
+    testSpi.doneTimeStart = testSpi.timeStart;
+    testSpi.callback(testSpi.context);
+}
+
+/* Pin interrupt: pending edge served when the HAL enables it */
+static void _pinInterrupt(void)
+{
+    while ((testPinIntEnabled == true) && (testPinEdge == true))
+    {
+        testPinEdge = false;
+        testPinCallback((PIO_PIN) DRV_RF215_EXT_INT_PIN, testPinContext);
+    }
+}
+
+static bool _quiet(void)
+{
+    return (testSpi.busy == false) && (rf215HalObj.spiQueueNum == 0U) && (_irqLine() == false) &&
+            (testRf09.queued == false) && (testRf24.receiving == false);
+}
+
+static void _run(uint64_t duration)
+{
+    uint64_t next;
+    uint64_t timeRf24;
+
+    testNextLoop = 0U;
+    testRf09.timeRequest = TEST_US(1000U);
+    testRf09.marginMin = INT64_MAX;
+    testRf24.timeRxfs = TEST_US(1500U);
+
+    while ((testStopping == false) || (_quiet() == false))
+    {
+        testStopping = (testTime >= duration);
+        if (testTime >= (duration + TEST_DRAIN))
+        {
+            _fail("SPI transfers or IRQs pending at the end", rf215HalObj.spiQueueNum);
+            break;
+        }
+
+        timeRf24 = testRf24.receiving ? testRf24.timeRxfe : testRf24.timeRxfs;
+        if ((testStopping == true) && (testRf24.receiving == false))
+        {
+            timeRf24 = UINT64_MAX;
+        }
+
+        next = testNextLoop;
+        if ((testSpi.busy == true) && (testSpi.timeEnd <= next))
+        {
+            next = testSpi.timeEnd;
+        }
+        if ((testRf09.started == true) && (testRf09.timeEnd < next))
+        {
+            next = testRf09.timeEnd;
+        }
+        if (timeRf24 < next)
+        {
+            next = timeRf24;
+        }
+
+        testTime = next;
+        if ((testSpi.busy == true) && (testSpi.timeEnd == testTime))
+        {
+            _spiComplete();
+        }
+        else if ((testRf09.started == true) && (testRf09.timeEnd == testTime))
+        {
+            _rf09TxEnd();
+        }
+        else if (timeRf24 == testTime)
+        {
+            if (testRf24.receiving == true)
+            {
+                _rf24RxEnd();
+            }
+            else
+            {
+                _rf24RxStart();
+            }
+        }
+        else
+        {
+            /* Main loop */
+            RF215_HAL_Tasks();
+            if ((testStopping == false) && (testRf09.queued == false) && (testTime >= testRf09.timeRequest))
+            {
+                _rf09TxRequest();
+            }
+            testNextLoop = testTime + TEST_LOOP;
+        }
+
+        _pinInterrupt();
+    }
+}
+
+static void _printLatency(const char *name, const TEST_LATENCY *latency)
+{
+    printf("  %-28s max %7.1f us, mean %6.1f us (%lu)\n", name,
+            (double)latency->max / (TEST_SYS_TIME_FREQ / 1000000.0),
+            (latency->num != 0U) ? ((double)latency->sum / ((double)latency->num * (TEST_SYS_TIME_FREQ / 1000000.0))) : 0.0,
+            (unsigned long)latency->num);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    RF215_HAL_SPI_STATS stats;
+    DRV_RF215_INIT init = {0};
+    uint32_t seconds = TEST_DEFAULT_SECONDS;
+    uint32_t lost;
+
+    if (argc > 1)
+    {
+        seconds = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    init.spiPlibIsBusy = _spiIsBusy;
+    init.spiPlibWriteRead = _spiWriteRead;
+    init.spiPlibSetCallback = _spiSetCallback;
+    RF215_HAL_Initialize(&init);
+
+    /* The external interrupt is enabled by the first reset */
+    rf215HalObj.extIntDisableCount = 0U;
+    testPinIntEnabled = true;
+
+    _run(TEST_US((uint64_t)seconds * 1000000U));
+
+    lost = testRf24.framesEnded - testRf24.indicated;
+#ifndef TEST_FIFO_QUEUE
+    if (lost != 0U)
+    {
+        _fail("RF24 frames lost", lost);
+    }
+#endif
+
+    if (testRf09.underruns != 0U)
+    {
+        _fail("RF09 frame buffer written after the bytes were sent", testRf09.underruns);
+    }
+
+    if ((testIrqRead != testIrqRaised) || (testIrqDispatched != testIrqRaised))
+    {
+        _fail("IRQ flags raised and read or dispatched differ", testIrqRaised);
+    }
+
+    if (testRf24.readSeqDone != testRf24.readSeq)
+    {
+        _fail("RF24 reads without callback", testRf24.readSeq - testRf24.readSeqDone);
+    }
+
+    if (testRf24.cmdWritesDev != testRf24.cmdWrites)
+    {
+        _fail("RF24 RX commands written", testRf24.cmdWritesDev);
+    }
+
+    if ((rf215HalObj.extIntDisableCount != 0U) || (testPinIntEnabled == false))
+    {
+        _fail("external interrupt left disabled", rf215HalObj.extIntDisableCount);
+    }
+
+    RF215_HAL_GetSpiStats(&stats, false);
+    if ((stats.dropped != 0U) || ((stats.accesses - stats.coalesced) != stats.bursts))
+    {
+        _fail("statistics differ from the SPI model", stats.accesses);
+    }
+
+#if (DRV_RF215_NUM_TRX == 2U)
+    if ((stats.trxAccesses[1] != testRf24.accesses) || (stats.trxLatencyMax[1] < testRxflLatency.max) ||
+            (stats.bypassed == 0U))
+    {
+        _fail("RF24 statistics differ from the model", stats.trxAccesses[1]);
+    }
+#endif
+
+#ifdef TEST_FIFO_QUEUE
+    printf("single transceiver queue (baseline), %u s:\n", (unsigned)seconds);
+#else
+    printf("dual transceiver queue, %u s:\n", (unsigned)seconds);
+#endif
+    printf("  RF09: %u frames, frame buffer margin min %.1f us\n", (unsigned)testRf09.frames,
+            (double)testRf09.marginMin / (TEST_SYS_TIME_FREQ / 1000000.0));
+    printf("  RF24: %u frames, %u lost\n", (unsigned)testRf24.framesEnded, (unsigned)lost);
+    _printLatency("RF09 IRQ", &testIrqLatency[0]);
+    _printLatency("RF24 IRQ", &testIrqLatency[1]);
+    _printLatency("RF24 RXFLL read", &testRxflLatency);
+    _printLatency("RF24 RXFE to payload read", &testPayloadLatency);
+    printf("  SPI: %u accesses, %u transfers, %u inserted ahead, queue max %u\n", (unsigned)stats.accesses,
+            (unsigned)stats.bursts, (unsigned)stats.bypassed, (unsigned)stats.queueNumMax);
+
+    printf("%s\n", (testErrors == 0U) ? "PASS" : "FAIL");
+    return (testErrors == 0U) ? 0 : 1;
+}
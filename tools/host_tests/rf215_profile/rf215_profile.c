@@ -0,0 +1,449 @@
+/*******************************************************************************
+  RF215 PHY configuration profile test
+
+  File Name:
+    rf215_profile.c
+
+  Summary:
+    Host test of the RF215 PHY configuration profiles.
+
+  Description:
+    rf215_phy.c of the G3 metering demo is built for the host with its own
+    configuration. The SPI of the RF215 HAL is replaced by a register file of
+    the transceiver, written by RF215_HAL_SpiWrite and
+    RF215_HAL_SpiWriteUpdate, so the test sees what a PHY configuration
+    change leaves in the device.
+
+    For every transceiver of the configuration, every frequency band and
+    operating mode accepted by it and every channel of the band, the PHY configuration is applied twice from the same
+    starting state: once with no profiles, so the registers are resolved, and
+    once after RF215_PHY_ProfileLoad, so they are taken from the profile. The
+    device registers, the register copy of the PHY object, the channel
+    frequency and the turnaround time must be the same. RF215_PHY_ProfileLoad
+    must not change the PHY object or write to the device. The test then
+    compares the time to resolve the registers with the time to take them
+    from a profile.
+
+    Usage:
+      rf215_profile [changes]       test and benchmark (1000000 changes by default)
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "driver/rf215/phy/rf215_phy.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEV_REGS_SIZE      0x4000U
+
+/* PHY object and device registers before a PHY configuration change */
+typedef struct
+{
+    RF215_PHY_OBJ   phyObj;
+    uint8_t         devRegs[TEST_DEV_REGS_SIZE];
+} TEST_STATE;
+
+/* Result of a PHY configuration change */
+typedef struct
+{
+    RF215_PHY_REGS_OBJ      phyRegs;
+    RF215_PLL_PARAMS_OBJ    pllParams;
+    uint16_t                turnaroundTimeUS;
+    uint16_t                channelNum;
+    uint8_t                 devRegs[TEST_DEV_REGS_SIZE];
+} TEST_RESULT;
+
+const RF215_REG_VALUES_OBJ rf215RegValues = {0};
+
+static uint8_t testDevRegs[TEST_DEV_REGS_SIZE];
+static unsigned long testSpiWrites;
+static uint8_t testTrxIdx;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RF215 HAL, Driver and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void RF215_HAL_EnterCritical(void) {}
+void RF215_HAL_LeaveCritical(void) {}
+bool RF215_HAL_SpiLock(void) { return true; }
+void RF215_HAL_SpiUnlock(void) {}
+size_t RF215_HAL_GetSpiQueueSize(void) { return 0U; }
+void RF215_HAL_LedTx(bool on) { (void) on; }
+void RF215_HAL_LedRx(bool on) { (void) on; }
+
+void RF215_HAL_SpiRead(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    (void) memcpy(pData, &testDevRegs[addr], size);
+    (void) callback;
+    (void) context;
+}
+
+void RF215_HAL_SpiReadFromTasks(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    RF215_HAL_SpiRead(addr, pData, size, callback, context);
+}
+
+void RF215_HAL_SpiWrite(uint16_t addr, void* pData, size_t size)
+{
+    (void) memcpy(&testDevRegs[addr], pData, size);
+    testSpiWrites++;
+}
+
+void RF215_HAL_SpiWriteUpdate(uint16_t addr, uint8_t* pDataNew, uint8_t* pDataOld, size_t size)
+{
+    size_t idx;
+
+    for (idx = 0U; idx < size; idx++)
+    {
+        if (pDataNew[idx] != pDataOld[idx])
+        {
+            pDataOld[idx] = pDataNew[idx];
+            RF215_HAL_SpiWrite((uint16_t) (addr + idx), &pDataOld[idx], 1U);
+        }
+    }
+}
+
+DRV_RF215_TX_BUFFER_OBJ* DRV_RF215_TxHandleValidate(DRV_RF215_TX_HANDLE txHandle) { (void) txHandle; return NULL; }
+void DRV_RF215_AbortTxByRx(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_AbortTxByPhyConfig(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_NotifyRxInd(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* ind) { (void) trxIdx; (void) ind; }
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+uint64_t SYS_TIME_Counter64Get(void) { return 0U; }
+uint32_t SYS_TIME_FrequencyGet(void) { return 1000000U; }
+uint32_t SYS_TIME_USToCount(uint32_t us) { return us; }
+
+SYS_TIME_HANDLE SYS_TIME_TimerCreate(uint32_t count, uint32_t period, SYS_TIME_CALLBACK callBack,
+    uintptr_t context, SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) count; (void) period; (void) callBack; (void) context; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+SYS_TIME_RESULT SYS_TIME_TimerStart(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+SYS_TIME_RESULT SYS_TIME_TimerDestroy(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterUS(SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t us,
+    SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) callback; (void) context; (void) us; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _profilesClear(void)
+{
+    (void) memset(rf215PhyProfiles, 0, sizeof(rf215PhyProfiles));
+    (void) memset(rf215PhyProfileNext, 0, sizeof(rf215PhyProfileNext));
+}
+
+/* Starting state: another PHY configuration, random registers in the device
+ * and the same values in the register copy of the PHY object */
+static void _stateInit(TEST_STATE* pState, DRV_RF215_PHY_CFG_OBJ* pPrevCfg)
+{
+    RF215_PHY_OBJ* pObj = &pState->phyObj;
+    uint8_t* pRegs;
+    size_t idx;
+
+    (void) memset(pObj, 0, sizeof(*pObj));
+    pObj->phyConfig = *pPrevCfg;
+    pObj->channelNum = pPrevCfg->chnNumMin;
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    pObj->trxState = RF215_RFn_STATE_RF_TRXOFF;
+    pObj->trxRdy = true;
+
+    pRegs = (uint8_t *) &pObj->phyRegs;
+    for (idx = 0U; idx < sizeof(pObj->phyRegs); idx++)
+    {
+        pRegs[idx] = (uint8_t) rand();
+    }
+
+    for (idx = 0U; idx < TEST_DEV_REGS_SIZE; idx++)
+    {
+        pState->devRegs[idx] = (uint8_t) rand();
+    }
+
+    (void) memcpy(&pState->devRegs[RF215_RFn_CS(testTrxIdx)], &pObj->phyRegs.RFn_CS, 16U);
+}
+
+static void _stateRestore(const TEST_STATE* pState)
+{
+    rf215PhyObj[testTrxIdx] = pState->phyObj;
+    (void) memcpy(testDevRegs, pState->devRegs, TEST_DEV_REGS_SIZE);
+}
+
+static void _resultGet(TEST_RESULT* pResult)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[testTrxIdx];
+
+    pResult->phyRegs = pObj->phyRegs;
+    pResult->pllParams = pObj->pllParams;
+    pResult->turnaroundTimeUS = pObj->turnaroundTimeUS;
+    pResult->channelNum = pObj->channelNum;
+    (void) memcpy(pResult->devRegs, testDevRegs, TEST_DEV_REGS_SIZE);
+}
+
+static int _resultCompare(const TEST_RESULT* pFresh, const TEST_RESULT* pCached)
+{
+    if (memcmp(pFresh->devRegs, pCached->devRegs, TEST_DEV_REGS_SIZE) != 0)
+    {
+        return 1;
+    }
+
+    if ((memcmp(&pFresh->phyRegs, &pCached->phyRegs, sizeof(pFresh->phyRegs)) != 0) ||
+            (pFresh->pllParams.chnFreq != pCached->pllParams.chnFreq) ||
+            (pFresh->turnaroundTimeUS != pCached->turnaroundTimeUS) ||
+            (pFresh->channelNum != pCached->channelNum))
+    {
+        return 2;
+    }
+
+    return 0;
+}
+
+static int _testChannel(DRV_RF215_PHY_BAND_OPM bandOpMode, DRV_RF215_PHY_CFG_OBJ* pCfg, uint16_t chnNum,
+    const TEST_STATE* pState)
+{
+    static TEST_RESULT fresh, cached;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[testTrxIdx];
+    unsigned long spiWrites;
+    int diff;
+
+    /* Registers resolved */
+    _profilesClear();
+    _stateRestore(pState);
+    if (lRF215_PHY_SetPhyConfig(testTrxIdx, pCfg, chnNum, false) != RF215_PIB_RESULT_SUCCESS)
+    {
+        printf("FAIL: band 0x%04x channel %u: configuration rejected\n", (unsigned) bandOpMode, chnNum);
+        return 1;
+    }
+    _resultGet(&fresh);
+
+    /* Registers taken from the profile */
+    _profilesClear();
+    _stateRestore(pState);
+    spiWrites = testSpiWrites;
+    if (RF215_PHY_ProfileLoad(testTrxIdx, bandOpMode, chnNum) != RF215_PIB_RESULT_SUCCESS)
+    {
+        printf("FAIL: band 0x%04x channel %u: profile load rejected\n", (unsigned) bandOpMode, chnNum);
+        return 1;
+    }
+
+    if ((memcmp(pObj, &pState->phyObj, sizeof(*pObj)) != 0) || (testSpiWrites != spiWrites))
+    {
+        printf("FAIL: band 0x%04x channel %u: profile load changed the PHY\n", (unsigned) bandOpMode, chnNum);
+        return 1;
+    }
+
+    if (lRF215_PHY_ProfileFind(testTrxIdx, pCfg, chnNum) == NULL)
+    {
+        printf("FAIL: band 0x%04x channel %u: profile not found\n", (unsigned) bandOpMode, chnNum);
+        return 1;
+    }
+
+    (void) lRF215_PHY_SetPhyConfig(testTrxIdx, pCfg, chnNum, false);
+    _resultGet(&cached);
+
+    diff = _resultCompare(&fresh, &cached);
+    if (diff != 0)
+    {
+        printf("FAIL: band 0x%04x channel %u: %s differ\n", (unsigned) bandOpMode, chnNum,
+                (diff == 1) ? "device registers" : "PHY object registers");
+        return 1;
+    }
+
+    return 0;
+}
+
+static int _testTrx(void)
+{
+    static TEST_STATE state;
+    DRV_RF215_PHY_CFG_OBJ cfg, prevCfg;
+    const RF215_PLL_CONST_OBJ* pllConst = &rf215PllConst[testTrxIdx];
+    RF215_PLL_PARAMS_OBJ pllParams;
+    const char* trxName = (testTrxIdx == RF215_TRX_RF09_IDX) ? "RF09" : "RF24";
+    unsigned long nChannels = 0U;
+    unsigned int nBands = 0U;
+    uint32_t bandOpMode;
+    uint32_t chnNum, chnMin, chnMax;
+    bool bandTested;
+    int range, nErrors = 0;
+
+    /* Starting configuration: the default one of the transceiver */
+    (void) lRF215_PHY_BandOpModeToPhyCfg((testTrxIdx == RF215_TRX_RF09_IDX) ?
+            SUN_FSK_BAND_863_OPM1 : SUN_FSK_BAND_2450_OPM1, &prevCfg);
+
+    for (bandOpMode = 0U; bandOpMode <= 0xFFFFU; bandOpMode++)
+    {
+        if (lRF215_PHY_BandOpModeToPhyCfg((DRV_RF215_PHY_BAND_OPM) bandOpMode, &cfg) == false)
+        {
+            continue;
+        }
+
+        bandTested = false;
+        for (range = 0; range < 2; range++)
+        {
+            chnMin = (range == 0) ? cfg.chnNumMin : cfg.chnNumMin2;
+            chnMax = (range == 0) ? cfg.chnNumMax : cfg.chnNumMax2;
+            if ((range == 1) && (chnMin == 0U) && (chnMax == 0U))
+            {
+                continue;
+            }
+
+            for (chnNum = chnMin; chnNum <= chnMax; chnNum++)
+            {
+                /* Skip the bands of the other transceiver */
+                lRF215_PLL_Params(pllConst, &pllParams, &cfg, (uint16_t) chnNum);
+                if (lRF215_PLL_CheckConfig(pllConst, &pllParams, &cfg, (uint16_t) chnNum) == false)
+                {
+                    continue;
+                }
+
+                bandTested = true;
+                _stateInit(&state, &prevCfg);
+                nErrors += _testChannel((DRV_RF215_PHY_BAND_OPM) bandOpMode, &cfg, (uint16_t) chnNum, &state);
+                nChannels++;
+                if (nErrors > 10)
+                {
+                    return nErrors;
+                }
+            }
+        }
+
+        if (bandTested == true)
+        {
+            nBands++;
+        }
+    }
+
+    printf("%s: %u bands and operating modes, %lu channels, cached and resolved registers compared\n",
+            trxName, nBands, nChannels);
+    if (nBands == 0U)
+    {
+        printf("FAIL: %s: no band tested\n", trxName);
+        nErrors++;
+    }
+
+    return nErrors;
+}
+
+static int _testBands(void)
+{
+    int nErrors = 0;
+
+    for (testTrxIdx = 0U; testTrxIdx < DRV_RF215_NUM_TRX; testTrxIdx++)
+    {
+        nErrors += _testTrx();
+    }
+
+    return nErrors;
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static int _benchmark(unsigned long nChanges)
+{
+    DRV_RF215_PHY_CFG_OBJ cfg;
+    const RF215_PLL_CONST_OBJ* pllConst = &rf215PllConst[RF215_TRX_RF09_IDX];
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    RF215_PHY_PROFILE_OBJ* profile;
+    volatile uint8_t sink = 0U;
+    unsigned long ix;
+    uint16_t chnNum;
+    double start, tResolve, tProfile;
+
+    /* Four channels of the OFDM option 4 band, all of them in the profiles */
+    testTrxIdx = RF215_TRX_RF09_IDX;
+    (void) lRF215_PHY_BandOpModeToPhyCfg(SUN_OFDM_BAND_863_OPT4, &cfg);
+    _profilesClear();
+    for (chnNum = cfg.chnNumMin; chnNum < (cfg.chnNumMin + 4U); chnNum++)
+    {
+        (void) RF215_PHY_ProfileLoad(testTrxIdx, SUN_OFDM_BAND_863_OPT4, chnNum);
+    }
+
+    pObj->phyConfig = cfg;
+    start = _seconds();
+    for (ix = 0U; ix < nChanges; ix++)
+    {
+        RF215_PHY_REGS_OBJ regsNew = {0};
+
+        chnNum = cfg.chnNumMin + (uint16_t) (ix & 3U);
+        pObj->channelNum = chnNum;
+        lRF215_PLL_Params(pllConst, &pObj->pllParams, &cfg, chnNum);
+        lRF215_PLL_Regs(pObj, pllConst, &regsNew);
+        lRF215_BBC_Regs(pObj, &regsNew);
+        lRF215_TXRXFE_Regs(pObj, &regsNew);
+        sink += regsNew.RFn_TXDFE;
+    }
+    tResolve = _seconds() - start;
+
+    start = _seconds();
+    for (ix = 0U; ix < nChanges; ix++)
+    {
+        RF215_PHY_REGS_OBJ regsNew = {0};
+
+        chnNum = cfg.chnNumMin + (uint16_t) (ix & 3U);
+        pObj->channelNum = chnNum;
+        lRF215_PLL_Params(pllConst, &pObj->pllParams, &cfg, chnNum);
+        profile = lRF215_PHY_ProfileFind(testTrxIdx, &cfg, chnNum);
+        if (profile == NULL)
+        {
+            printf("FAIL: benchmark: channel %u not in the profiles\n", chnNum);
+            return 1;
+        }
+        lRF215_PHY_ProfileRegs(pObj, profile, &regsNew);
+        sink += regsNew.RFn_TXDFE;
+    }
+    tProfile = _seconds() - start;
+
+    (void) sink;
+    printf("benchmark: %lu register sets, %u profiles\n", nChanges, (unsigned) DRV_RF215_PHY_PROFILES_NUMBER);
+    printf("  resolved:     %8.1f ns per change\n", (tResolve * 1e9) / (double) nChanges);
+    printf("  from profile: %8.1f ns per change\n", (tProfile * 1e9) / (double) nChanges);
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    unsigned long nChanges = 1000000UL;
+    int nErrors = 0;
+
+    if (argc > 1)
+    {
+        nChanges = strtoul(argv[1], NULL, 0);
+    }
+
+    srand(1);
+    nErrors += _testBands();
+    nErrors += _benchmark(nChanges);
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
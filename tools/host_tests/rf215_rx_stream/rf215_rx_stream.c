@@ -0,0 +1,246 @@
+/*******************************************************************************
+  RF215 RX streaming timing test
+
+  File Name:
+    rf215_rx_stream.c
+
+  Summary:
+    Host test of the RF215 RX frame buffer streaming.
+
+  Description:
+    rf215_phy.c of the G3 metering demo is built twice with its own
+    configuration: once with DRV_RF215_RX_STREAM_CHUNK_US 0, where one FBLI
+    interrupt reads most of the PSDU and the rest is read after RXFE, and
+    once with the configured chunk duration, where the FBLI interrupt is
+    programmed again after every chunk. Both receive the same frames from a
+    timed model of the RF215 and its SPI (see rx_stream_sim.c), through the
+    real RX interrupt handlers of the PHY.
+
+    For every PHY mode of the bands accepted by the configuration, every
+    modulation scheme and a set of PSDU lengths, both builds must deliver the
+    RX indication with the sent PSDU, must not read a PSDU byte before it is
+    in the frame buffer and must not write an FBLI value the frame buffer
+    level is already above. The streaming build must not take longer from
+    RXFE to the RX indication, and for the modes where it does not stream it
+    must behave as the other build. The latency of both builds is printed
+    for every case.
+
+    Usage:
+      rf215_rx_stream [PSDU lengths]     127, 512, 1024, 2047 and the maximum
+                                         by default
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "rx_stream_sim.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_LENGTHS_MAX            16U
+#define TEST_PHY_MODES_MAX          64U
+#define TEST_MOD_SCHEMES            7U
+#define TEST_MAX_FAILS_SHOWN        10
+
+/* Streaming may add this much to the latency of a case */
+#define TEST_LATENCY_TOLERANCE_US   1.0
+
+static uint16_t testLengths[TEST_LENGTHS_MAX];
+static unsigned int testNumLengths;
+static int testFails;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const RX_SIM_RESULT* pResult, uint16_t psduLen, const char* msg)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s %s %u bytes: %s\n", pResult->phyName, pResult->modName, psduLen, msg);
+    }
+}
+
+static void _lengthsDefault(uint16_t psduLenMax)
+{
+    static const uint16_t lengths[] = {127U, 512U, 1024U, 2047U};
+    unsigned int idx;
+
+    testNumLengths = 0U;
+    for (idx = 0U; idx < (sizeof(lengths) / sizeof(lengths[0])); idx++)
+    {
+        if (lengths[idx] <= psduLenMax)
+        {
+            testLengths[testNumLengths++] = lengths[idx];
+        }
+    }
+
+    if (testLengths[testNumLengths - 1U] != psduLenMax)
+    {
+        testLengths[testNumLengths++] = psduLenMax;
+    }
+}
+
+static void _checkBuild(const RX_SIM_RESULT* pResult, uint16_t psduLen, const char* build)
+{
+    char msg[64];
+
+    if ((isinf(pResult->latencyUS)) || (pResult->indOk == false))
+    {
+        (void) snprintf(msg, sizeof(msg), "%s: no RX indication with the sent PSDU", build);
+        _fail(pResult, psduLen, msg);
+    }
+
+    if (pResult->earlyReads != 0U)
+    {
+        (void) snprintf(msg, sizeof(msg), "%s: %u bytes read before received", build, pResult->earlyReads);
+        _fail(pResult, psduLen, msg);
+    }
+
+    if (pResult->lateFbli != 0U)
+    {
+        (void) snprintf(msg, sizeof(msg), "%s: %u FBLI written below the level", build, pResult->lateFbli);
+        _fail(pResult, psduLen, msg);
+    }
+}
+
+static void _checkCase(const RX_SIM_RESULT* pBase, const RX_SIM_RESULT* pStream, uint16_t psduLen)
+{
+    _checkBuild(pBase, psduLen, "base");
+    _checkBuild(pStream, psduLen, "stream");
+
+    if (pStream->latencyUS > (pBase->latencyUS + TEST_LATENCY_TOLERANCE_US))
+    {
+        _fail(pStream, psduLen, "streaming is slower");
+    }
+
+    if ((pStream->streamChunk == 0U) && ((pStream->latencyUS != pBase->latencyUS) ||
+            (pStream->spiBytes != pBase->spiBytes) || (pStream->fbliInts != pBase->fbliInts)))
+    {
+        _fail(pStream, psduLen, "no streaming, but not the same reception");
+    }
+}
+
+static int _testModes(void)
+{
+    static uint32_t phyKeys[TEST_PHY_MODES_MAX];
+    RX_SIM_RESULT base, stream;
+    unsigned int numKeys = 0U;
+    unsigned int numCases = 0U, numStreamed = 0U;
+    double sumBase = 0.0, sumStream = 0.0, maxBase = 0.0, maxStream = 0.0;
+    uint32_t bandOpMode, seed = 1U;
+    unsigned int idx;
+    uint8_t mod;
+
+    printf("%-22s %-7s %5s %8s %9s %9s %5s %9s %11s\n", "PHY mode", "", "PSDU", "payload", "base",
+            "stream", "chunk", "FBLI", "after RXFE");
+    printf("%-22s %-7s %5s %8s %9s %9s %5s %9s %11s\n", "", "", "bytes", "us", "us", "us", "bytes",
+            "ints", "bytes");
+
+    for (bandOpMode = 0U; bandOpMode <= 0xFFFFU; bandOpMode++)
+    {
+        /* One band of each PHY mode */
+        if (rxSimBase.rxFrame((uint16_t) bandOpMode, 0U, 127U, seed, &base) == RX_SIM_INVALID_BAND)
+        {
+            continue;
+        }
+
+        for (idx = 0U; (idx < numKeys) && (phyKeys[idx] != base.phyKey); idx++)
+        {
+        }
+
+        if ((idx < numKeys) || (numKeys == TEST_PHY_MODES_MAX))
+        {
+            continue;
+        }
+
+        phyKeys[numKeys++] = base.phyKey;
+        if (testNumLengths == 0U)
+        {
+            _lengthsDefault(base.psduLenMax);
+        }
+
+        for (mod = 0U; mod < TEST_MOD_SCHEMES; mod++)
+        {
+            for (idx = 0U; idx < testNumLengths; idx++)
+            {
+                uint16_t psduLen = testLengths[idx];
+                RX_SIM_STATUS statusBase, statusStream;
+
+                seed++;
+                statusBase = rxSimBase.rxFrame((uint16_t) bandOpMode, mod, psduLen, seed, &base);
+                statusStream = rxSimStream.rxFrame((uint16_t) bandOpMode, mod, psduLen, seed, &stream);
+                if (statusBase != statusStream)
+                {
+                    _fail(&base, psduLen, "builds disagree on the case");
+                    continue;
+                }
+
+                if (statusBase != RX_SIM_OK)
+                {
+                    continue;
+                }
+
+                _checkCase(&base, &stream, psduLen);
+                printf("%-22s %-7s %5u %8.0f %9.1f %9.1f %5u %4u %4u %5u %5u\n", base.phyName, base.modName,
+                        psduLen, base.payloadUS, base.latencyUS, stream.latencyUS, stream.streamChunk,
+                        base.fbliInts, stream.fbliInts, base.bytesAfterRxfe, stream.bytesAfterRxfe);
+
+                numCases++;
+                numStreamed += (stream.streamChunk != 0U) ? 1U : 0U;
+                sumBase += base.latencyUS;
+                sumStream += stream.latencyUS;
+                maxBase = (base.latencyUS > maxBase) ? base.latencyUS : maxBase;
+                maxStream = (stream.latencyUS > maxStream) ? stream.latencyUS : maxStream;
+            }
+        }
+    }
+
+    if (numCases == 0U)
+    {
+        printf("FAIL: no PHY mode tested\n");
+        return 1;
+    }
+
+    printf("%u PHY modes, %u cases, %u streamed\n", numKeys, numCases, numStreamed);
+    printf("RXFE to RX indication: mean %.1f us, max %.1f us without streaming\n",
+            sumBase / (double) numCases, maxBase);
+    printf("                       mean %.1f us, max %.1f us with streaming\n",
+            sumStream / (double) numCases, maxStream);
+    if (testFails > TEST_MAX_FAILS_SHOWN)
+    {
+        printf("... %d failures\n", testFails);
+    }
+
+    return testFails;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    int nErrors;
+    int idx;
+
+    for (idx = 1; (idx < argc) && (testNumLengths < TEST_LENGTHS_MAX); idx++)
+    {
+        testLengths[testNumLengths++] = (uint16_t) strtoul(argv[idx], NULL, 0);
+    }
+
+    nErrors = _testModes();
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,686 @@
+/*******************************************************************************
+  RF215 RX simulation for the RX streaming test
+
+  File Name:
+    rx_stream_sim.c
+
+  Summary:
+    One build of rf215_phy.c receiving frames from a timed model of the
+    RF215 and its SPI.
+
+  Description:
+    RX_STREAM_CHUNK_US, if defined, replaces DRV_RF215_RX_STREAM_CHUNK_US of
+    the configuration and RX_STREAM_SIM_NAME names the exported simulation
+    object.
+
+    The RF215 HAL is replaced by a queue of SPI transfers that run one after
+    the other, each one taking RF215_SPI_BYTE_DURATION_US_Q5 per byte plus the
+    command bytes and a fixed overhead for the DMA interrupt and the start of
+    the next transfer. Registers are sampled when their byte is clocked, and
+    callbacks run when the transfer finishes, after the next one is started,
+    as in rf215_hal.c. The external interrupt is only handled when the SPI
+    queue is empty, as the HAL keeps it disabled while accesses are queued;
+    it reads the four IRQS registers and calls RF215_PHY_ExtIntEvent.
+
+    The frame starts at the RXFS interrupt. The frame buffer level grows one
+    interleaver block at a time, delayed by the FEC decoder, as computed by
+    lRF215_BBC_RxOctetParams, and the RXFE interrupt comes at the end of the
+    payload. The FBLI interrupt is raised when the level goes above the
+    value of BBCn_FBLIL/H, so a value written below the current level is
+    lost.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "rx_stream_sim.h"
+#include "configuration.h"
+
+#ifdef RX_STREAM_CHUNK_US
+#undef DRV_RF215_RX_STREAM_CHUNK_US
+#define DRV_RF215_RX_STREAM_CHUNK_US        RX_STREAM_CHUNK_US
+#endif
+
+#include "driver/rf215/phy/rf215_phy.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* SPI byte duration, from the HAL */
+#define SIM_SPI_BYTE_US         ((double) RF215_SPI_BYTE_DURATION_US_Q5 / 32.0)
+
+/* DMA interrupt, callbacks and start of the next transfer */
+#define SIM_SPI_OVERHEAD_US     4.0
+
+/* External interrupt to IRQS read queued */
+#define SIM_IRQ_LATENCY_US      5.0
+
+/* No RX indication this long after RXFE is a failure */
+#define SIM_TIMEOUT_US          100000.0
+
+#define SIM_QUEUE_SIZE          32U
+#define SIM_WRITE_SIZE_MAX      64U
+#define SIM_DEV_REGS_SIZE       0x4000U
+#define SIM_FBLI_RESET          0x7FFU
+
+/* BBC0_IRQS after RF09_IRQS and RF24_IRQS */
+#define SIM_BBC_IRQS_OFFSET     2U
+
+/* One SPI access, with the data it read or writes */
+typedef struct
+{
+    RF215_SPI_TRANSFER_CALLBACK     callback;
+    uintptr_t                       context;
+    uint8_t*                        pData;
+    uint16_t                        addr;
+    uint16_t                        size;
+    bool                            write;
+    bool                            irqs;
+    uint8_t                         data[DRV_RF215_MAX_PSDU_LEN];
+} SIM_TRANSFER;
+
+typedef struct
+{
+    double          now;
+
+    /* SPI queue */
+    SIM_TRANSFER    queue[SIM_QUEUE_SIZE];
+    uint8_t         head;
+    uint8_t         num;
+    bool            spiBusy;
+    double          spiStart;
+    double          spiEnd;
+
+    /* Frame being received */
+    uint8_t         trxIdx;
+    uint8_t         psdu[DRV_RF215_MAX_PSDU_LEN];
+    uint16_t        psduLen;
+    double          octetUS;
+    double          payloadUS;
+    uint16_t        bitsBlock;
+    uint8_t         fecDelayBits;
+    bool            rxfeRaised;
+
+    /* Device interrupts */
+    uint16_t        fbli;
+    bool            fbliArmed;
+    uint8_t         irqs;
+    double          irqTime;
+    bool            irqsQueued;
+
+    /* RX indication */
+    double          indTime;
+    DRV_RF215_RX_INDICATION_OBJ* pInd;
+
+    RX_SIM_RESULT*  pResult;
+} SIM_OBJ;
+
+const RF215_REG_VALUES_OBJ rf215RegValues = {0};
+
+static SIM_OBJ sim;
+static uint8_t simDevRegs[SIM_DEV_REGS_SIZE];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Frame buffer level at time t after RXFS: complete interleaver blocks,
+ * less the bits still in the FEC decoder */
+static uint16_t _bufLevel(double t)
+{
+    double bits;
+    long blockBits, level;
+
+    if ((sim.rxfeRaised == true) || (t >= sim.payloadUS))
+    {
+        return sim.psduLen;
+    }
+
+    if (t <= 0.0)
+    {
+        return 0U;
+    }
+
+    bits = ((t * 8.0) / sim.octetUS) + 1e-6;
+    blockBits = ((long) (bits / sim.bitsBlock) * sim.bitsBlock) - sim.fecDelayBits;
+    level = (blockBits < 0) ? 0 : (blockBits >> 3);
+    return (level > sim.psduLen) ? sim.psduLen : (uint16_t) level;
+}
+
+/* Time the frame buffer level goes above the FBLI value, before RXFE */
+static double _fbliTime(void)
+{
+    double blocks, t;
+
+    blocks = ceil((double) (((uint32_t) sim.fbli + 1U) * 8U + sim.fecDelayBits) / (double) sim.bitsBlock);
+    t = (blocks * sim.bitsBlock * sim.octetUS) / 8.0;
+    if (t >= sim.payloadUS)
+    {
+        return HUGE_VAL;
+    }
+
+    return (t < sim.now) ? sim.now : t;
+}
+
+static void _irqRaise(uint8_t flag)
+{
+    if (sim.irqs == 0U)
+    {
+        sim.irqTime = sim.now;
+    }
+
+    sim.irqs |= flag;
+}
+
+static uint8_t _devRead(uint16_t addr, double t)
+{
+    uint16_t addrFBRX = RF215_BBCn_FBRXS(sim.trxIdx);
+    uint16_t level = _bufLevel(t);
+
+    if (addr == RF215_BBCn_FBLL(sim.trxIdx))
+    {
+        return (uint8_t) level;
+    }
+
+    if (addr == (RF215_BBCn_FBLL(sim.trxIdx) + 1U))
+    {
+        return (uint8_t) (level >> 8);
+    }
+
+    if ((addr >= addrFBRX) && (addr < (addrFBRX + sim.psduLen)))
+    {
+        uint16_t idx = addr - addrFBRX;
+
+        if (idx >= level)
+        {
+            sim.pResult->earlyReads++;
+        }
+
+        if (t >= sim.payloadUS)
+        {
+            sim.pResult->bytesAfterRxfe++;
+        }
+
+        return sim.psdu[idx];
+    }
+
+    return simDevRegs[addr];
+}
+
+/* Read or write the registers of a transfer as its bytes are clocked */
+static void _spiSample(SIM_TRANSFER* transfer)
+{
+    uint16_t addrFBLI = RF215_BBCn_FBLIL(sim.trxIdx);
+    double tByte = sim.now + (RF215_SPI_CMD_SIZE * SIM_SPI_BYTE_US);
+    uint16_t idx;
+
+    if (transfer->irqs == true)
+    {
+        /* IRQS registers are cleared on read */
+        (void) memset(transfer->data, 0, transfer->size);
+        transfer->data[SIM_BBC_IRQS_OFFSET + sim.trxIdx] = sim.irqs;
+        sim.irqs = 0U;
+        return;
+    }
+
+    for (idx = 0U; idx < transfer->size; idx++)
+    {
+        uint16_t addr = transfer->addr + idx;
+
+        if (transfer->write == true)
+        {
+            simDevRegs[addr] = transfer->data[idx];
+        }
+        else
+        {
+            transfer->data[idx] = _devRead(addr, tByte);
+        }
+
+        tByte += SIM_SPI_BYTE_US;
+    }
+
+    if ((transfer->write == true) && (transfer->addr <= (addrFBLI + 1U)) &&
+            ((transfer->addr + transfer->size) > addrFBLI))
+    {
+        /* FBLI written: the interrupt comes if the level is not above it yet */
+        sim.fbli = simDevRegs[addrFBLI] + ((uint16_t) (simDevRegs[addrFBLI + 1U] & RF215_BBCn_FBLIH_FBLIH_Msk) << 8);
+        sim.fbliArmed = (_bufLevel(tByte) <= sim.fbli);
+        if ((sim.fbliArmed == false) && (sim.fbli < sim.psduLen))
+        {
+            sim.pResult->lateFbli++;
+        }
+    }
+}
+
+static void _spiStartNext(void)
+{
+    SIM_TRANSFER* transfer;
+
+    if ((sim.spiBusy == true) || (sim.num == 0U))
+    {
+        return;
+    }
+
+    transfer = &sim.queue[sim.head];
+    sim.spiBusy = true;
+    sim.spiStart = sim.now;
+    sim.spiEnd = sim.now + ((double) (transfer->size + RF215_SPI_CMD_SIZE) * SIM_SPI_BYTE_US) +
+            SIM_SPI_OVERHEAD_US;
+    sim.pResult->spiBytes += transfer->size + RF215_SPI_CMD_SIZE;
+    _spiSample(transfer);
+}
+
+static void _spiQueue(uint16_t addr, void* pData, size_t size, bool write, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    SIM_TRANSFER* transfer;
+
+    if ((sim.num == SIM_QUEUE_SIZE) || (size > DRV_RF215_MAX_PSDU_LEN) ||
+            ((write == true) && (size > SIM_WRITE_SIZE_MAX)))
+    {
+        printf("FAIL: SPI access 0x%04x of %u bytes does not fit the queue\n", addr, (unsigned) size);
+        exit(1);
+    }
+
+    transfer = &sim.queue[(sim.head + sim.num) % SIM_QUEUE_SIZE];
+    transfer->addr = addr;
+    transfer->pData = (uint8_t *) pData;
+    transfer->size = (uint16_t) size;
+    transfer->write = write;
+    transfer->irqs = false;
+    transfer->callback = callback;
+    transfer->context = context;
+    if (write == true)
+    {
+        (void) memcpy(transfer->data, pData, size);
+    }
+
+    sim.num++;
+    _spiStartNext();
+}
+
+static uint64_t _sysTimeCount(double us)
+{
+    return (uint64_t) (us * 32.0);
+}
+
+/* SPI transfer finished: start the next one, then notify */
+static void _spiFinished(void)
+{
+    SIM_TRANSFER transfer = sim.queue[sim.head];
+    double timeStart = sim.spiStart;
+
+    sim.head = (sim.head + 1U) % SIM_QUEUE_SIZE;
+    sim.num--;
+    sim.spiBusy = false;
+    _spiStartNext();
+
+    if (transfer.irqs == true)
+    {
+        uint8_t bbcIRQS = transfer.data[SIM_BBC_IRQS_OFFSET + sim.trxIdx];
+
+        sim.irqsQueued = false;
+        if ((bbcIRQS & RF215_BBCn_IRQ_FBLI) != 0U)
+        {
+            sim.pResult->fbliInts++;
+        }
+
+        RF215_PHY_ExtIntEvent(sim.trxIdx, 0U, bbcIRQS);
+        return;
+    }
+
+    if (transfer.write == false)
+    {
+        (void) memcpy(transfer.pData, transfer.data, transfer.size);
+    }
+
+    if (transfer.callback != NULL)
+    {
+        transfer.callback(transfer.context, transfer.pData, _sysTimeCount(timeStart));
+    }
+}
+
+static void _irqsRead(void)
+{
+    SIM_TRANSFER* transfer = &sim.queue[(sim.head + sim.num) % SIM_QUEUE_SIZE];
+
+    transfer->addr = RF215_RF09_IRQS;
+    transfer->size = 4U;
+    transfer->write = false;
+    transfer->irqs = true;
+    transfer->callback = NULL;
+    sim.irqsQueued = true;
+    sim.num++;
+    _spiStartNext();
+}
+
+/* Any PHR value the PHY decodes as the modulation scheme */
+static bool _phrFind(const DRV_RF215_PHY_CFG_OBJ* pCfg, DRV_RF215_PHY_MOD_SCHEME modScheme, uint8_t* pPhr)
+{
+    uint16_t phr;
+
+    for (phr = 0U; phr <= 0xFFU; phr++)
+    {
+        DRV_RF215_PHY_MOD_SCHEME mod;
+
+        if (pCfg->phyType == PHY_TYPE_FSK)
+        {
+            mod = lRF215_FSK_ReadPHR((uint8_t) phr);
+        }
+        else
+        {
+            mod = lRF215_OFDM_ReadPHR((uint8_t) phr, pCfg->phyTypeCfg.ofdm.opt);
+        }
+
+        if (mod == modScheme)
+        {
+            *pPhr = (uint8_t) phr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void _names(const DRV_RF215_PHY_CFG_OBJ* pCfg, DRV_RF215_PHY_MOD_SCHEME modScheme, RX_SIM_RESULT* pResult)
+{
+    if (pCfg->phyType == PHY_TYPE_FSK)
+    {
+        const DRV_RF215_FSK_CFG_OBJ* fsk = &pCfg->phyTypeCfg.fsk;
+
+        /* The modulation index does not change the timing */
+        pResult->phyKey = 0x10000UL | ((uint32_t) fsk->symRate << 4) | (uint32_t) fsk->modOrd;
+        (void) snprintf(pResult->phyName, sizeof(pResult->phyName), "FSK %u kHz %u-FSK",
+                (unsigned) fskSymRateConst[fsk->symRate].kHz, (fsk->modOrd == FSK_MOD_ORD_4FSK) ? 4U : 2U);
+        (void) snprintf(pResult->modName, sizeof(pResult->modName), "FEC %s",
+                (modScheme == FSK_FEC_ON) ? "on" : "off");
+    }
+    else
+    {
+        pResult->phyKey = 0x20000UL | (uint32_t) pCfg->phyTypeCfg.ofdm.opt;
+        (void) snprintf(pResult->phyName, sizeof(pResult->phyName), "OFDM option %u",
+                (unsigned) pCfg->phyTypeCfg.ofdm.opt + 1U);
+        (void) snprintf(pResult->modName, sizeof(pResult->modName), "MCS%u", (unsigned) modScheme);
+    }
+}
+
+/* Receive one frame, from RXFS to the RX indication */
+static void _simFrame(uint8_t trxIdx, DRV_RF215_PHY_MOD_SCHEME mod, uint8_t phr, uint16_t psduLen, uint32_t seed,
+    RX_SIM_RESULT* pResult)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[trxIdx];
+    uint32_t octetUSq5, payloadUSq5;
+    uint16_t idx;
+
+    (void) memset(&sim, 0, sizeof(sim));
+    sim.pResult = pResult;
+    sim.trxIdx = trxIdx;
+    sim.psduLen = psduLen;
+    sim.indTime = -1.0;
+    srand(seed);
+    for (idx = 0U; idx < psduLen; idx++)
+    {
+        sim.psdu[idx] = (uint8_t) rand();
+    }
+
+    octetUSq5 = lRF215_BBC_RxOctetParams(&pObj->phyConfig, mod, psduLen, &sim.bitsBlock,
+            &sim.fecDelayBits, &payloadUSq5);
+    sim.octetUS = (double) octetUSq5 / 32.0;
+    sim.payloadUS = (double) payloadUSq5 / 32.0;
+    pResult->payloadUS = sim.payloadUS;
+
+    simDevRegs[RF215_BBCn_RXFLL(trxIdx)] = (uint8_t) psduLen;
+    simDevRegs[RF215_BBCn_RXFLL(trxIdx) + 1U] = (uint8_t) (psduLen >> 8);
+    simDevRegs[RF215_BBCn_FSKPHRRX(trxIdx)] = phr;
+    simDevRegs[RF215_BBCn_OFDMPHRRX(trxIdx)] = phr;
+    sim.fbli = simDevRegs[RF215_BBCn_FBLIL(trxIdx)] +
+            ((uint16_t) (simDevRegs[RF215_BBCn_FBLIL(trxIdx) + 1U] & RF215_BBCn_FBLIH_FBLIH_Msk) << 8);
+    sim.fbliArmed = true;
+
+    /* PHY receiving the header when RXFS comes. FBLI is the value left by
+     * the previous frame. */
+    pObj->trxState = RF215_RFn_STATE_RF_RX;
+    pObj->trxRdy = true;
+    pObj->phyState = PHY_STATE_RX_HEADER;
+    _irqRaise(RF215_BBCn_IRQ_RXFS);
+
+    while (sim.indTime < 0.0)
+    {
+        enum { EV_NONE, EV_SPI, EV_RXFE, EV_FBLI, EV_IRQ } ev = EV_NONE;
+        double tNext = HUGE_VAL;
+        double t;
+
+        if (sim.spiBusy == true)
+        {
+            tNext = sim.spiEnd;
+            ev = EV_SPI;
+        }
+
+        if ((sim.rxfeRaised == false) && (sim.payloadUS < tNext))
+        {
+            tNext = sim.payloadUS;
+            ev = EV_RXFE;
+        }
+
+        if (sim.fbliArmed == true)
+        {
+            t = _fbliTime();
+            if (t < tNext)
+            {
+                tNext = t;
+                ev = EV_FBLI;
+            }
+        }
+
+        if ((sim.irqs != 0U) && (sim.irqsQueued == false) && (sim.num == 0U))
+        {
+            t = sim.irqTime + SIM_IRQ_LATENCY_US;
+            t = (t < sim.now) ? sim.now : t;
+            if (t < tNext)
+            {
+                tNext = t;
+                ev = EV_IRQ;
+            }
+        }
+
+        if ((ev == EV_NONE) || (tNext > (sim.payloadUS + SIM_TIMEOUT_US)))
+        {
+            break;
+        }
+
+        sim.now = tNext;
+        switch (ev)
+        {
+            case EV_SPI:
+                _spiFinished();
+                if (pObj->rxIndPending == true)
+                {
+                    sim.indTime = sim.now;
+                }
+                break;
+
+            case EV_RXFE:
+                sim.rxfeRaised = true;
+                _irqRaise(RF215_BBCn_IRQ_RXFE);
+                break;
+
+            case EV_FBLI:
+                sim.fbliArmed = false;
+                _irqRaise(RF215_BBCn_IRQ_FBLI);
+                break;
+
+            default:
+                _irqsRead();
+                break;
+        }
+    }
+
+#if (DRV_RF215_RX_STREAM_CHUNK_US != 0U)
+    if (pObj->rxStreamChunk <= pObj->rxStreamLimit)
+    {
+        pResult->streamChunk = pObj->rxStreamChunk;
+    }
+#endif
+
+    if (sim.indTime < 0.0)
+    {
+        pResult->latencyUS = HUGE_VAL;
+        return;
+    }
+
+    pResult->latencyUS = sim.indTime - sim.payloadUS;
+
+    /* RX indication from the PHY tasks */
+    RF215_PHY_Tasks(trxIdx);
+    pResult->indOk = (sim.pInd != NULL) && (sim.pInd->psduLen == psduLen) &&
+            (sim.pInd->modScheme == mod) && (memcmp(sim.pInd->psdu, sim.psdu, psduLen) == 0);
+}
+
+static RX_SIM_STATUS _rxFrame(uint16_t bandOpMode, uint8_t modScheme, uint16_t psduLen, uint32_t seed,
+    RX_SIM_RESULT* pResult)
+{
+    DRV_RF215_PHY_CFG_OBJ cfg;
+    DRV_RF215_PHY_MOD_SCHEME mod = (DRV_RF215_PHY_MOD_SCHEME) modScheme;
+    uint8_t trxIdx, phr;
+
+    (void) memset(pResult, 0, sizeof(*pResult));
+    pResult->psduLenMax = DRV_RF215_MAX_PSDU_LEN;
+    if (lRF215_PHY_BandOpModeToPhyCfg((DRV_RF215_PHY_BAND_OPM) bandOpMode, &cfg) == false)
+    {
+        return RX_SIM_INVALID_BAND;
+    }
+
+    /* First transceiver that can tune the band, from a cleared PHY object so
+     * that no state is left from the previous case */
+    for (trxIdx = 0U; trxIdx < DRV_RF215_NUM_TRX; trxIdx++)
+    {
+        (void) memset(&rf215PhyObj[trxIdx], 0, sizeof(rf215PhyObj[trxIdx]));
+        if (RF215_PHY_Initialize(trxIdx, (DRV_RF215_PHY_BAND_OPM) bandOpMode, cfg.chnNumMin) == true)
+        {
+            break;
+        }
+    }
+
+    if (trxIdx == DRV_RF215_NUM_TRX)
+    {
+        return RX_SIM_INVALID_BAND;
+    }
+
+    _names(&cfg, mod, pResult);
+    if (_phrFind(&cfg, mod, &phr) == false)
+    {
+        return RX_SIM_INVALID_MOD;
+    }
+
+    if ((psduLen <= DRV_RF215_FCS_LEN) || (psduLen > DRV_RF215_MAX_PSDU_LEN))
+    {
+        return RX_SIM_INVALID_LEN;
+    }
+
+    /* A first frame brings the registers of the device and their copy in
+     * the PHY object to the state of a transceiver that has been receiving;
+     * the second one is measured */
+    (void) memset(simDevRegs, 0, sizeof(simDevRegs));
+    _simFrame(trxIdx, mod, phr, psduLen, seed, pResult);
+    (void) memset(pResult, 0, sizeof(*pResult));
+    pResult->psduLenMax = DRV_RF215_MAX_PSDU_LEN;
+    _names(&cfg, mod, pResult);
+    _simFrame(trxIdx, mod, phr, psduLen, seed, pResult);
+    return RX_SIM_OK;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RF215 HAL, Driver and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void RF215_HAL_EnterCritical(void) {}
+void RF215_HAL_LeaveCritical(void) {}
+bool RF215_HAL_SpiLock(void) { return true; }
+void RF215_HAL_SpiUnlock(void) {}
+size_t RF215_HAL_GetSpiQueueSize(void) { return sim.num; }
+void RF215_HAL_LedTx(bool on) { (void) on; }
+void RF215_HAL_LedRx(bool on) { (void) on; }
+
+void RF215_HAL_SpiRead(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    _spiQueue(addr, pData, size, false, callback, context);
+}
+
+void RF215_HAL_SpiReadFromTasks(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    _spiQueue(addr, pData, size, false, callback, context);
+}
+
+void RF215_HAL_SpiWrite(uint16_t addr, void* pData, size_t size)
+{
+    _spiQueue(addr, pData, size, true, NULL, 0U);
+}
+
+void RF215_HAL_SpiWriteUpdate(uint16_t addr, uint8_t* pDataNew, uint8_t* pDataOld, size_t size)
+{
+    size_t first, last;
+
+    /* One write from the first to the last changed register */
+    for (first = 0U; (first < size) && (pDataNew[first] == pDataOld[first]); first++)
+    {
+    }
+
+    if (first == size)
+    {
+        return;
+    }
+
+    for (last = size - 1U; pDataNew[last] == pDataOld[last]; last--)
+    {
+    }
+
+    (void) memcpy(&pDataOld[first], &pDataNew[first], last - first + 1U);
+    RF215_HAL_SpiWrite((uint16_t) (addr + first), &pDataOld[first], last - first + 1U);
+}
+
+DRV_RF215_TX_BUFFER_OBJ* DRV_RF215_TxHandleValidate(DRV_RF215_TX_HANDLE txHandle) { (void) txHandle; return NULL; }
+void DRV_RF215_AbortTxByRx(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_AbortTxByPhyConfig(uint8_t trxIdx) { (void) trxIdx; }
+
+void DRV_RF215_NotifyRxInd(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* ind)
+{
+    (void) trxIdx;
+    sim.pInd = ind;
+}
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+uint64_t SYS_TIME_Counter64Get(void) { return _sysTimeCount(sim.now); }
+uint32_t SYS_TIME_FrequencyGet(void) { return 32000000U; }
+uint32_t SYS_TIME_USToCount(uint32_t us) { return us * 32U; }
+
+SYS_TIME_HANDLE SYS_TIME_TimerCreate(uint32_t count, uint32_t period, SYS_TIME_CALLBACK callBack,
+    uintptr_t context, SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) count; (void) period; (void) callBack; (void) context; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+SYS_TIME_RESULT SYS_TIME_TimerStart(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+SYS_TIME_RESULT SYS_TIME_TimerDestroy(SYS_TIME_HANDLE handle) { (void) handle; return SYS_TIME_ERROR; }
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterUS(SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t us,
+    SYS_TIME_CALLBACK_TYPE type)
+{
+    (void) callback; (void) context; (void) us; (void) type;
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+const RX_STREAM_SIM RX_STREAM_SIM_NAME =
+{
+    _rxFrame
+};
@@ -0,0 +1,58 @@
+/*******************************************************************************
+  RF215 RX simulation interface for the RX streaming test
+
+  File Name:
+    rx_stream_sim.h
+
+  Summary:
+    Reception of one frame by one build of rf215_phy.c.
+
+  Description:
+    rx_stream_sim.c is built twice, once with DRV_RF215_RX_STREAM_CHUNK_US 0
+    and once with the configured chunk duration. Each build exports only its
+    simulation object, so both copies of the PHY can be linked in the same
+    test.
+*******************************************************************************/
+
+#ifndef RX_STREAM_SIM_H
+#define RX_STREAM_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    RX_SIM_OK,
+    RX_SIM_INVALID_BAND,
+    RX_SIM_INVALID_MOD,
+    RX_SIM_INVALID_LEN
+} RX_SIM_STATUS;
+
+typedef struct
+{
+    uint32_t    phyKey;             /* Same for bands with the same PHY mode */
+    char        phyName[24];
+    char        modName[12];
+    uint16_t    psduLenMax;
+    uint16_t    streamChunk;        /* Bytes per FBLI, 0 without streaming */
+    double      payloadUS;          /* RXFS to RXFE */
+    double      latencyUS;          /* RXFE to RX indication pending */
+    uint16_t    fbliInts;           /* FBLI interrupts handled */
+    uint16_t    bytesAfterRxfe;     /* PSDU bytes read after RXFE */
+    uint16_t    lateFbli;           /* FBLI written below the buffer level */
+    uint16_t    earlyReads;         /* PSDU bytes read before received */
+    uint32_t    spiBytes;           /* SPI bytes of the whole reception */
+    bool        indOk;              /* Indication with the sent PSDU */
+} RX_SIM_RESULT;
+
+typedef struct
+{
+    /* Receive a PSDU of psduLen random bytes, generated from seed */
+    RX_SIM_STATUS (*rxFrame)(uint16_t bandOpMode, uint8_t modScheme, uint16_t psduLen, uint32_t seed,
+        RX_SIM_RESULT* pResult);
+} RX_STREAM_SIM;
+
+extern const RX_STREAM_SIM rxSimBase;
+extern const RX_STREAM_SIM rxSimStream;
+
+#endif // RX_STREAM_SIM_H
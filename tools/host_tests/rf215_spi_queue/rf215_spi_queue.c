@@ -0,0 +1,562 @@
+/*******************************************************************************
+  RF215 HAL SPI queue test
+
+  File Name:
+    rf215_spi_queue.c
+
+  Summary:
+    Host test of the SPI transfer queue of the RF215 driver HAL.
+
+  Description:
+    rf215_hal.c of the G3 metering demo is built for the host with the SPI
+    PLIB replaced by a model of the RF215 register file and of the SPI
+    timing: a transfer runs on the register file when it is launched, as the
+    DMA does, and finishes when the test says so, after the time of its
+    bytes plus the DMA restart.
+
+    Random register and frame buffer accesses are queued, some from tasks,
+    while transfers are launched and finished in random order; some read
+    callbacks queue more accesses, as the PHY does. Every access is also
+    applied to a reference register file in the order it was queued. At the
+    end the register file must match the reference, and every read must have
+    returned the reference data, in order, with the time of its first byte.
+    The IRQS registers must be read exactly as often as in the reference,
+    since they are cleared on read and must not be read in a coalesced gap.
+    After every step the queue size must match the queued SPI transfers, and
+    at the end the external interrupt must be enabled again. Accesses that do
+    not fit in the queue must be discarded without callback.
+
+    A sparse run (addresses spread over all register areas and the frame
+    buffer) and a dense run (short accesses to a few baseband registers,
+    often one after the other, as the PHY makes them) are made. For each one
+    the test prints the SPI transfers and the bus time against one SPI
+    transfer per access, and the queue statistics when
+    DRV_RF215_SPI_STATS_ENABLE is set.
+
+    Usage:
+      rf215_spi_queue [accesses]      accesses per run (200000 by default)
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "configuration.h"
+#include "system/ports/sys_ports.h"
+
+/* The PIO PLIB inlines the pin interrupt control, which writes to the PIO
+ * registers: the external interrupt is only counted by the HAL here */
+#define PIO_PinInterruptEnable(pin)     ((void)(pin))
+#define PIO_PinInterruptDisable(pin)    ((void)(pin))
+
+#include "driver/rf215/hal/rf215_hal.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEV_REGS_SIZE      0x4000U
+#define TEST_DEFAULT_ACCESSES   200000U
+#define TEST_ACCESS_MAX_SIZE    200U
+#define TEST_MAX_FAILS_SHOWN    10U
+
+/* SYS_TIME at 32 MHz: one count is 1/32 us, so a SPI byte takes
+ * RF215_SPI_BYTE_DURATION_US_Q5 counts. DMA interrupt and restart take as
+ * long as 2 bytes */
+#define TEST_SYS_TIME_FREQ      32000000U
+#define TEST_SPI_OVERHEAD       (2U * RF215_SPI_BYTE_DURATION_US_Q5)
+
+/* Context of a read callback for an access that must be discarded */
+#define TEST_DISCARDED          UINTPTR_MAX
+
+typedef struct
+{
+    uint8_t data[TEST_ACCESS_MAX_SIZE];
+    uint8_t expected[TEST_ACCESS_MAX_SIZE];
+    size_t size;
+    uint16_t addr;
+    bool read;
+    bool done;
+} TEST_ACCESS;
+
+/* Model of the RF215 SPI: transfer in progress */
+typedef struct
+{
+    FLEXCOM_SPI_CALLBACK callback;
+    uintptr_t context;
+    bool busy;
+    uint16_t addr;
+    size_t size;
+    uint64_t timeStart;
+    uint64_t timeEnd;
+    /* Transfer that finished last, whose callbacks are running */
+    uint16_t doneAddr;
+    uint64_t doneTimeStart;
+} TEST_SPI;
+
+typedef struct
+{
+    unsigned long transfers;
+    unsigned long accesses;
+    unsigned long discarded;
+    uint64_t busTime;
+    uint64_t busTimeSingle;
+} TEST_COUNTERS;
+
+static uint8_t testDevRegs[TEST_DEV_REGS_SIZE];
+static uint8_t testRefRegs[TEST_DEV_REGS_SIZE];
+static TEST_ACCESS *testAccesses;
+static uint32_t *testReadOrder;
+static uint32_t testNumAccesses, testMaxAccesses;
+static uint32_t testReadHead, testReadTail;
+static unsigned long testIrqsReads, testIrqsReadsRef;
+static TEST_SPI testSpi;
+static TEST_COUNTERS testCounters;
+static uint64_t testTime;
+static unsigned long testErrors;
+static bool testDense;
+static uint16_t testLastEnd;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SPI PLIB, Port and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+static bool _spiIsBusy(void)
+{
+    return testSpi.busy;
+}
+
+static bool _spiWriteRead(void* pTransmitData, size_t txSize, void* pReceiveData, size_t rxSize)
+{
+    uint8_t* pTx = pTransmitData;
+    uint8_t* pRx = pReceiveData;
+    uint16_t cmd = ((uint16_t)pTx[0] << 8) | pTx[1];
+    uint16_t addr = cmd & 0x3FFFU;
+    size_t idx;
+
+    if (testSpi.busy == true)
+    {
+        printf("FAIL: SPI transfer launched while another one is in progress\n");
+        testErrors++;
+        return false;
+    }
+
+    /* The RF215 executes the transfer as the bytes go through */
+    for (idx = 0; idx < (txSize - RF215_SPI_CMD_SIZE); idx++)
+    {
+        if ((cmd & RF215_SPI_CMD_MODE_WRITE) != 0U)
+        {
+            testDevRegs[addr + idx] = pTx[RF215_SPI_CMD_SIZE + idx];
+        }
+        else
+        {
+            pRx[RF215_SPI_CMD_SIZE + idx] = testDevRegs[addr + idx];
+            if ((addr + idx) < RF215_SPI_BURST_GAP_MIN_ADDR)
+            {
+                /* IRQS registers are cleared on read */
+                testDevRegs[addr + idx] = 0U;
+                testIrqsReads++;
+            }
+        }
+    }
+
+    testSpi.busy = true;
+    testSpi.addr = addr;
+    testSpi.size = txSize;
+    testSpi.timeStart = testTime;
+    testSpi.timeEnd = testTime + (txSize * RF215_SPI_BYTE_DURATION_US_Q5) + TEST_SPI_OVERHEAD;
+    testCounters.transfers++;
+    testCounters.busTime += testSpi.timeEnd - testSpi.timeStart;
+    (void) rxSize;
+    return true;
+}
+
+static void _spiSetCallback(FLEXCOM_SPI_CALLBACK callback, uintptr_t context)
+{
+    testSpi.callback = callback;
+    testSpi.context = context;
+}
+
+void PIO_PortSet(PIO_PORT port, uint32_t mask) { (void) port; (void) mask; }
+void PIO_PortClear(PIO_PORT port, uint32_t mask) { (void) port; (void) mask; }
+
+bool PIO_PinInterruptCallbackRegister(PIO_PIN pin, const PIO_PIN_CALLBACK callback, uintptr_t context)
+{
+    (void) pin; (void) callback; (void) context;
+    return true;
+}
+
+void DRV_RF215_ExtIntHandler(void) {}
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+bool SYS_INT_SourceDisable(INT_SOURCE source) { (void) source; return true; }
+void SYS_INT_SourceRestore(INT_SOURCE source, bool status) { (void) source; (void) status; }
+uint64_t SYS_TIME_Counter64Get(void) { return testTime; }
+uint32_t SYS_TIME_FrequencyGet(void) { return TEST_SYS_TIME_FREQ; }
+
+SYS_TIME_RESULT SYS_TIME_DelayUS(uint32_t us, SYS_TIME_HANDLE* handle)
+{
+    (void) us; (void) handle;
+    return SYS_TIME_ERROR;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _fail(const char *message, unsigned long value)
+{
+    if (testErrors < TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s (%lu)\n", message, value);
+    }
+    testErrors++;
+}
+
+static uint16_t _randomAddr(void)
+{
+    if (testDense)
+    {
+        /* Register blocks accessed in sequence, as the PHY does when it
+         * configures the transceiver or reads the RX status, and some IRQS */
+        if (((rand() % 2) == 0) && (testLastEnd < (RF215_BASE_ADDR_BBC0 + 0x80U)))
+        {
+            return testLastEnd + (uint16_t)(rand() % 3);
+        }
+
+        return (((rand() % 4) != 0) ? RF215_BASE_ADDR_BBC0 : 0U) + (uint16_t)(rand() % 0x18);
+    }
+
+    switch (rand() % 4)
+    {
+        case 0:
+            return (uint16_t)(rand() % 0x10);
+        case 1:
+            return RF215_BASE_ADDR_BBC0 + (uint16_t)(rand() % 0x60);
+        case 2:
+            return RF215_BASE_ADDR_BBC1 + (uint16_t)(rand() % 0x60);
+        default:
+            return RF215_BASE_ADDR_FRAME_BUF_BBC0 + (uint16_t)(rand() % 0x100);
+    }
+}
+
+static bool _queueFull(void)
+{
+    return ((rf215HalObj.spiQueueNum + rf215HalObj.spiQueueRelease) >= RF215_SPI_TRANSFER_POOL_SIZE);
+}
+
+static void _readCallback(uintptr_t context, void* pData, uint64_t time);
+
+/* Queues a random access, and applies it to the reference */
+static void _queueAccess(void)
+{
+    TEST_ACCESS* pAccess;
+    uint8_t discarded[TEST_ACCESS_MAX_SIZE];
+    uint32_t id;
+    size_t idx;
+
+    if (_queueFull())
+    {
+        /* Sometimes queue it anyway: it must be discarded, with no callback */
+        if ((rand() % 8) == 0)
+        {
+            RF215_HAL_SpiRead(_randomAddr(), discarded, 1U, _readCallback, TEST_DISCARDED);
+            testCounters.discarded++;
+        }
+        return;
+    }
+
+    if (testNumAccesses == testMaxAccesses)
+    {
+        return;
+    }
+
+    id = testNumAccesses++;
+    pAccess = &testAccesses[id];
+    pAccess->addr = _randomAddr();
+    if (testDense)
+    {
+        pAccess->size = 1U + (size_t)(rand() % 4);
+    }
+    else
+    {
+        pAccess->size = 1U + (size_t)(rand() % (((rand() % 10) != 0) ? 4 : TEST_ACCESS_MAX_SIZE));
+    }
+    pAccess->read = ((rand() % 2) == 0);
+    pAccess->done = false;
+
+    if ((pAccess->read == false) && (pAccess->addr < RF215_SPI_BURST_GAP_MIN_ADDR))
+    {
+        /* IRQS registers are read-only */
+        pAccess->addr += RF215_SPI_BURST_GAP_MIN_ADDR;
+    }
+
+    testLastEnd = pAccess->addr + (uint16_t)pAccess->size;
+    for (idx = 0; idx < pAccess->size; idx++)
+    {
+        uint16_t addr = pAccess->addr + (uint16_t)idx;
+
+        if (pAccess->read == true)
+        {
+            pAccess->expected[idx] = testRefRegs[addr];
+            if (addr < RF215_SPI_BURST_GAP_MIN_ADDR)
+            {
+                testRefRegs[addr] = 0U;
+                testIrqsReadsRef++;
+            }
+        }
+        else
+        {
+            pAccess->data[idx] = (uint8_t)rand();
+            testRefRegs[addr] = pAccess->data[idx];
+        }
+    }
+
+    testCounters.accesses++;
+    testCounters.busTimeSingle += ((pAccess->size + RF215_SPI_CMD_SIZE) * RF215_SPI_BYTE_DURATION_US_Q5) +
+            TEST_SPI_OVERHEAD;
+
+    if (pAccess->read == true)
+    {
+        testReadOrder[testReadTail++] = id;
+        if ((rand() % 5) == 0)
+        {
+            RF215_HAL_SpiReadFromTasks(pAccess->addr, pAccess->data, pAccess->size, _readCallback, id);
+        }
+        else
+        {
+            RF215_HAL_SpiRead(pAccess->addr, pAccess->data, pAccess->size, _readCallback, id);
+        }
+    }
+    else
+    {
+        RF215_HAL_SpiWrite(pAccess->addr, pAccess->data, pAccess->size);
+    }
+}
+
+static void _readCallback(uintptr_t context, void* pData, uint64_t time)
+{
+    TEST_ACCESS* pAccess;
+    uint64_t timeExpected;
+
+    if (context == TEST_DISCARDED)
+    {
+        _fail("callback of a discarded access", 0);
+        return;
+    }
+
+    pAccess = &testAccesses[context];
+    if ((testReadHead == testReadTail) || (context != testReadOrder[testReadHead]))
+    {
+        _fail("read callback out of order", (unsigned long)context);
+    }
+    else
+    {
+        testReadHead++;
+    }
+
+    if ((pData != pAccess->data) || (memcmp(pAccess->data, pAccess->expected, pAccess->size) != 0))
+    {
+        _fail("read data differs from the reference", (unsigned long)context);
+    }
+
+    /* Time of the first byte of the access in the SPI transfer. The next
+     * transfer is launched before the callbacks of the finished one */
+    timeExpected = testSpi.doneTimeStart +
+            ((uint64_t)(pAccess->addr - testSpi.doneAddr) * RF215_SPI_BYTE_DURATION_US_Q5);
+    if (time != timeExpected)
+    {
+        _fail("read callback time", (unsigned long)context);
+    }
+
+    pAccess->done = true;
+
+    /* The PHY queues more accesses from some callbacks */
+    if ((rand() % 8) == 0)
+    {
+        _queueAccess();
+    }
+}
+
+/* SPI transfer in progress finishes: DMA interrupt */
+static void _spiComplete(void)
+{
+    if (testSpi.busy == false)
+    {
+        return;
+    }
+
+    testTime = testSpi.timeEnd;
+    testSpi.busy = false;
+    testSpi.doneAddr = testSpi.addr;
+    testSpi.doneTimeStart = testSpi.timeStart;
+    testSpi.callback(testSpi.context);
+}
+
+/* Queue size against the SPI transfers in the queue */
+static void _checkQueueSize(void)
+{
+    RF215_SPI_TRANSFER_OBJ* burst;
+    size_t size = 0;
+    uint8_t pos = 0;
+
+    while (pos < rf215HalObj.spiQueueNum)
+    {
+        burst = &halSpiTransferPool[lRF215_HAL_SpiQueueIndex(rf215HalObj.spiQueueHead + pos)];
+        size += burst->burstSize + RF215_SPI_CMD_SIZE;
+        pos += burst->burstNum;
+    }
+
+    if (RF215_HAL_GetSpiQueueSize() != size)
+    {
+        _fail("queue size differs from the queued transfers", (unsigned long)RF215_HAL_GetSpiQueueSize());
+    }
+}
+
+static void _run(const char *name, bool dense)
+{
+    unsigned long notDone = 0;
+    uint32_t idx;
+    int action;
+
+    testDense = dense;
+    testNumAccesses = 0;
+    testReadHead = 0;
+    testReadTail = 0;
+    testIrqsReads = 0;
+    testIrqsReadsRef = 0;
+    (void) memset(&testCounters, 0, sizeof(testCounters));
+    (void) memset(&testSpi, 0, sizeof(testSpi));
+
+    for (idx = 0; idx < TEST_DEV_REGS_SIZE; idx++)
+    {
+        testDevRegs[idx] = (uint8_t)rand();
+    }
+    (void) memcpy(testRefRegs, testDevRegs, sizeof(testRefRegs));
+
+    DRV_RF215_INIT init = {0};
+    init.spiPlibIsBusy = _spiIsBusy;
+    init.spiPlibWriteRead = _spiWriteRead;
+    init.spiPlibSetCallback = _spiSetCallback;
+    RF215_HAL_Initialize(&init);
+
+    /* The external interrupt is enabled by the first reset */
+    rf215HalObj.extIntDisableCount = 0U;
+
+    while (testNumAccesses < testMaxAccesses)
+    {
+        action = rand() % 10;
+        if (action < 5)
+        {
+            _queueAccess();
+        }
+        else if (action < 8)
+        {
+            _spiComplete();
+        }
+        else
+        {
+            RF215_HAL_Tasks();
+        }
+
+        _checkQueueSize();
+    }
+
+    while (rf215HalObj.spiQueueNum > 0U)
+    {
+        RF215_HAL_Tasks();
+        _spiComplete();
+        _checkQueueSize();
+    }
+
+    for (idx = 0; idx < testNumAccesses; idx++)
+    {
+        if ((testAccesses[idx].read == true) && (testAccesses[idx].done == false))
+        {
+            notDone++;
+        }
+    }
+
+    if (notDone != 0U)
+    {
+        _fail("reads without callback", notDone);
+    }
+
+    if (RF215_HAL_GetSpiQueueSize() != 0U)
+    {
+        _fail("queue size not 0 with the queue empty", (unsigned long)RF215_HAL_GetSpiQueueSize());
+    }
+
+    if (rf215HalObj.extIntDisableCount != 0U)
+    {
+        _fail("external interrupt left disabled", rf215HalObj.extIntDisableCount);
+    }
+
+    if (memcmp(testDevRegs, testRefRegs, sizeof(testDevRegs)) != 0)
+    {
+        _fail("register file differs from the reference", 0);
+    }
+
+    if (testIrqsReads != testIrqsReadsRef)
+    {
+        _fail("IRQS register reads", testIrqsReads);
+    }
+
+    printf("%s: %lu accesses (%lu discarded), %lu SPI transfers, bus time %.1f ms (%.1f ms with one transfer per access)\n",
+            name, testCounters.accesses, testCounters.discarded, testCounters.transfers,
+            (double)testCounters.busTime / (TEST_SYS_TIME_FREQ / 1000.0),
+            (double)testCounters.busTimeSingle / (TEST_SYS_TIME_FREQ / 1000.0));
+
+#if (DRV_RF215_SPI_STATS_ENABLE != 0U)
+    RF215_HAL_SPI_STATS stats;
+    RF215_HAL_GetSpiStats(&stats, true);
+    printf("  stats: %u accesses, %u transfers, %u coalesced, %u dropped, queue max %u, latency max %.1f us, mean %.1f us\n",
+            (unsigned)stats.accesses, (unsigned)stats.bursts, (unsigned)stats.coalesced, (unsigned)stats.dropped,
+            (unsigned)stats.queueNumMax, (double)stats.latencyMax / (TEST_SYS_TIME_FREQ / 1000000.0),
+            (double)stats.latencySum / ((double)stats.accesses * (TEST_SYS_TIME_FREQ / 1000000.0)));
+
+    /* Every access that is not dropped starts a transfer or is coalesced */
+    if ((stats.bursts != testCounters.transfers) || (stats.dropped != testCounters.discarded) ||
+            ((stats.accesses - stats.dropped - stats.coalesced) != stats.bursts))
+    {
+        _fail("statistics differ from the SPI model", stats.accesses);
+    }
+#endif
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    testMaxAccesses = TEST_DEFAULT_ACCESSES;
+    if (argc > 1)
+    {
+        testMaxAccesses = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    testAccesses = calloc(testMaxAccesses, sizeof(TEST_ACCESS));
+    testReadOrder = calloc(testMaxAccesses, sizeof(uint32_t));
+    if ((testAccesses == NULL) || (testReadOrder == NULL))
+    {
+        printf("FAIL: out of memory\n");
+        return 1;
+    }
+
+    srand(1);
+    _run("sparse", false);
+    _run("dense", true);
+
+    free(testAccesses);
+    free(testReadOrder);
+    printf("%s\n", (testErrors == 0U) ? "PASS" : "FAIL");
+    return (testErrors == 0U) ? 0 : 1;
+}
@@ -0,0 +1,837 @@
+/*******************************************************************************
+  RF215 TX scheduling queue test
+
+  File Name:
+    rf215_tx_sched.c
+
+  Summary:
+    Host test of the RF215 PHY TX scheduling queue with scripted events.
+
+  Description:
+    rf215_phy.c of the G3 metering demo is built for the host with its own
+    configuration. SYS_TIME is simulated (1 count per microsecond) and runs
+    the timers of the PHY in time order, the TX buffers and the RX abort of
+    the driver are replaced by a small pool, and the air is modeled: a frame
+    starts when its start timer expires, stays on air for the PPDU duration
+    and is confirmed after it, and no frame may start before the previous
+    one plus the turnaround time has ended.
+
+    Each script is a list of timed events: TX requests (time, PSDU length,
+    CCA mode, cancel by RX), a received frame, a busy channel for the next
+    CCA, a delayed TX confirm and a TX cancel. The start time of every frame
+    and every TX confirm are logged in order, and the log must match the
+    expected one. Every request must get exactly one confirm, at most one TX
+    timer may run at a time, the queue must end empty and the statistics of
+    RF215_PHY_GetTxSchedStats must match the script.
+
+    Built with TEST_TX_SCHEDULE_ENABLE 0, the same scripts run without the
+    queue, for comparison: the logs, lost confirms and overlaps are printed
+    and the program does not fail.
+
+    Usage:
+      rf215_tx_sched
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "configuration.h"
+
+#ifdef TEST_TX_SCHEDULE_ENABLE
+#undef DRV_RF215_TX_SCHEDULE_ENABLE
+#define DRV_RF215_TX_SCHEDULE_ENABLE        TEST_TX_SCHEDULE_ENABLE
+#endif
+
+#include "driver/rf215/phy/rf215_phy.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Script times are relative to this SYS_TIME count */
+#define TEST_TIME_BASE          100000U
+
+#define TEST_TIMERS_NUM         32U
+#define TEST_LOG_SIZE           512U
+#define TEST_PSDU_LEN           20U
+#define TEST_TURNAROUND_US      1000U
+
+/* TX end interrupt and PHY status read before the TX confirm */
+#define TEST_TX_END_US          30U
+
+typedef enum
+{
+    TEST_EV_REQUEST,
+    TEST_EV_RX,
+    TEST_EV_CCA_BUSY,
+    TEST_EV_CFM_DELAY,
+    TEST_EV_CANCEL
+} TEST_EVENT_TYPE;
+
+/* Script event. time is the event time; arg is the TX time of a request,
+ * the end of a received frame or the extra delay of the next confirm. */
+typedef struct
+{
+    TEST_EVENT_TYPE             type;
+    const char*                 name;
+    uint32_t                    time;
+    uint32_t                    arg;
+    DRV_RF215_PHY_CCA_MODE      ccaMode;
+    bool                        cancelByRx;
+} TEST_EVENT;
+
+/* Expected statistics of a script */
+typedef struct
+{
+    uint32_t                    txQueued;
+    uint32_t                    txConflict;
+    uint32_t                    txLateStart;
+    uint32_t                    txAbortedByRx;
+    uint32_t                    txCcaBusy;
+    uint8_t                     queueNumMax;
+} TEST_STATS;
+
+typedef struct
+{
+    bool                        active;
+    uint64_t                    due;
+    SYS_TIME_CALLBACK           callback;
+    uintptr_t                   context;
+} TEST_TIMER;
+
+#define TEST_TX(name, time, txTime, cca, cbr)   {TEST_EV_REQUEST, (name), (time), (txTime), (cca), (cbr)}
+#define TEST_RX(time, rxEnd)                    {TEST_EV_RX, "", (time), (rxEnd), PHY_CCA_OFF, false}
+#define TEST_CCA_BUSY(time)                     {TEST_EV_CCA_BUSY, "", (time), 0U, PHY_CCA_OFF, false}
+#define TEST_CFM_DELAY(time, delay)             {TEST_EV_CFM_DELAY, "", (time), (delay), PHY_CCA_OFF, false}
+#define TEST_CANCEL(name, time)                 {TEST_EV_CANCEL, (name), (time), 0U, PHY_CCA_OFF, false}
+#define TEST_NUM(events)                        (sizeof(events) / sizeof((events)[0]))
+
+static const char* testResultNames[] =
+{
+    "OK", "UNDERRUN", "ABORTED", "BUSY_TX", "BUSY_RX", "BUSY_CHN", "TRX_SLEPT", "CANCEL_BY_RX",
+    "TIMEOUT", "FULL_BUFFERS", "INVALID_LEN", "INVALID_HANDLE", "INVALID_PARAM", "CANCELLED"
+};
+
+const RF215_REG_VALUES_OBJ rf215RegValues = {0};
+
+static uint64_t testNow;
+static TEST_TIMER testTimers[TEST_TIMERS_NUM];
+static DRV_RF215_CLIENT_OBJ testClient;
+static DRV_RF215_TX_BUFFER_OBJ testTxBuffers[DRV_RF215_TX_BUFFERS_NUMBER];
+static const char* testTxNames[DRV_RF215_TX_BUFFERS_NUMBER];
+
+/* Air model */
+static DRV_RF215_TX_BUFFER_OBJ* testOnAir;
+static uint64_t testAirEnd;
+static uint64_t testAirFree;
+static uint64_t testRxEnd;
+static bool testRxOn;
+static bool testCcaBusyNext;
+static uint32_t testCfmDelay;
+
+/* Script results */
+static char testLog[TEST_LOG_SIZE];
+static size_t testLogLen;
+static unsigned int testRequests;
+static unsigned int testConfirms;
+static unsigned int testOverlaps;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RF215 HAL, Driver and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+void RF215_HAL_EnterCritical(void) {}
+void RF215_HAL_LeaveCritical(void) {}
+bool RF215_HAL_SpiLock(void) { return true; }
+void RF215_HAL_SpiUnlock(void) {}
+size_t RF215_HAL_GetSpiQueueSize(void) { return 0U; }
+void RF215_HAL_LedTx(bool on) { (void) on; }
+void RF215_HAL_LedRx(bool on) { (void) on; }
+
+void RF215_HAL_SpiRead(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    (void) addr; (void) pData; (void) size; (void) callback; (void) context;
+}
+
+void RF215_HAL_SpiReadFromTasks(uint16_t addr, void* pData, size_t size, RF215_SPI_TRANSFER_CALLBACK callback,
+    uintptr_t context)
+{
+    (void) addr; (void) pData; (void) size; (void) callback; (void) context;
+}
+
+void RF215_HAL_SpiWrite(uint16_t addr, void* pData, size_t size)
+{
+    (void) addr; (void) pData; (void) size;
+}
+
+void RF215_HAL_SpiWriteUpdate(uint16_t addr, uint8_t* pDataNew, uint8_t* pDataOld, size_t size)
+{
+    (void) addr; (void) pDataNew; (void) pDataOld; (void) size;
+}
+
+DRV_RF215_TX_BUFFER_OBJ* DRV_RF215_TxHandleValidate(DRV_RF215_TX_HANDLE txHandle)
+{
+    if ((txHandle >= DRV_RF215_TX_BUFFERS_NUMBER) || (testTxBuffers[txHandle].inUse == false))
+    {
+        return NULL;
+    }
+
+    return &testTxBuffers[txHandle];
+}
+
+void DRV_RF215_AbortTxByRx(uint8_t trxIdx)
+{
+    uint8_t idx;
+
+    for (idx = 0U; idx < DRV_RF215_TX_BUFFERS_NUMBER; idx++)
+    {
+        DRV_RF215_TX_BUFFER_OBJ* txBufObj = &testTxBuffers[idx];
+
+        if ((txBufObj->inUse == true) && (txBufObj->clientObj->trxIndex == trxIdx) &&
+                (txBufObj->reqObj.cancelByRx == true))
+        {
+            RF215_PHY_SetTxCfm(txBufObj, RF215_TX_CANCEL_BY_RX);
+        }
+    }
+}
+
+void DRV_RF215_AbortTxByPhyConfig(uint8_t trxIdx) { (void) trxIdx; }
+void DRV_RF215_NotifyRxInd(uint8_t trxIdx, DRV_RF215_RX_INDICATION_OBJ* ind) { (void) trxIdx; (void) ind; }
+
+bool SYS_INT_Disable(void) { return true; }
+void SYS_INT_Restore(bool state) { (void) state; }
+uint64_t SYS_TIME_Counter64Get(void) { return testNow; }
+uint32_t SYS_TIME_FrequencyGet(void) { return 1000000U; }
+uint32_t SYS_TIME_USToCount(uint32_t us) { return us; }
+
+SYS_TIME_HANDLE SYS_TIME_TimerCreate(uint32_t count, uint32_t period, SYS_TIME_CALLBACK callBack,
+    uintptr_t context, SYS_TIME_CALLBACK_TYPE type)
+{
+    uint8_t idx;
+
+    (void) count;
+    (void) type;
+    for (idx = 0U; idx < TEST_TIMERS_NUM; idx++)
+    {
+        TEST_TIMER* timer = &testTimers[idx];
+
+        if (timer->callback == NULL)
+        {
+            timer->active = false;
+            timer->due = testNow + period;
+            timer->callback = callBack;
+            timer->context = context;
+            return (SYS_TIME_HANDLE) idx + 1;
+        }
+    }
+
+    return SYS_TIME_HANDLE_INVALID;
+}
+
+SYS_TIME_RESULT SYS_TIME_TimerStart(SYS_TIME_HANDLE handle)
+{
+    if ((handle <= 0) || (handle > (SYS_TIME_HANDLE) TEST_TIMERS_NUM) || (testTimers[handle - 1].callback == NULL))
+    {
+        return SYS_TIME_ERROR;
+    }
+
+    testTimers[handle - 1].active = true;
+    return SYS_TIME_SUCCESS;
+}
+
+SYS_TIME_RESULT SYS_TIME_TimerDestroy(SYS_TIME_HANDLE handle)
+{
+    if ((handle <= 0) || (handle > (SYS_TIME_HANDLE) TEST_TIMERS_NUM) || (testTimers[handle - 1].callback == NULL))
+    {
+        return SYS_TIME_ERROR;
+    }
+
+    testTimers[handle - 1].active = false;
+    testTimers[handle - 1].callback = NULL;
+    return SYS_TIME_SUCCESS;
+}
+
+SYS_TIME_HANDLE SYS_TIME_CallbackRegisterUS(SYS_TIME_CALLBACK callback, uintptr_t context, uint32_t us,
+    SYS_TIME_CALLBACK_TYPE type)
+{
+    SYS_TIME_HANDLE handle = SYS_TIME_TimerCreate(0U, us, callback, context, type);
+
+    (void) SYS_TIME_TimerStart(handle);
+    return handle;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _log(const char* format, ...)
+{
+    va_list args;
+
+    if (testLogLen < TEST_LOG_SIZE)
+    {
+        va_start(args, format);
+        testLogLen += (size_t) vsnprintf(&testLog[testLogLen], TEST_LOG_SIZE - testLogLen, format, args);
+        va_end(args);
+    }
+}
+
+/* TX preparation and start timers running */
+static int _txTimersActive(void)
+{
+    int num = 0;
+    uint8_t idx;
+
+    for (idx = 0U; idx < TEST_TIMERS_NUM; idx++)
+    {
+        if ((testTimers[idx].active == true) && ((testTimers[idx].callback == lRF215_TX_PrepareTimeExpired) ||
+                (testTimers[idx].callback == lRF215_TX_StartTimeExpired)))
+        {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+/* Start timer expired: the frame goes on air, unless it is too late or the
+ * channel is busy */
+static void _txStart(DRV_RF215_TX_BUFFER_OBJ* txBufObj)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    uint64_t txTime = txBufObj->reqObj.timeCount;
+    uint64_t start = (testNow > txTime) ? testNow : txTime;
+    uint16_t symbols;
+
+    if ((pObj->txStarted == false) || (pObj->txBufObj != txBufObj))
+    {
+        return;
+    }
+
+    if ((start - txTime) > DRV_RF215_MAX_TX_TIME_DELAY_ERROR_US)
+    {
+        lRF215_TRX_RxListen(RF215_TRX_RF09_IDX);
+        RF215_PHY_SetTxCfm(txBufObj, RF215_TX_TIMEOUT);
+        return;
+    }
+
+    if (testCcaBusyNext == true)
+    {
+        testCcaBusyNext = false;
+        lRF215_TRX_RxListen(RF215_TRX_RF09_IDX);
+        RF215_PHY_SetTxCfm(txBufObj, RF215_TX_BUSY_CHN);
+        return;
+    }
+
+    if (start < testAirFree)
+    {
+        _log("OVERLAP ");
+        testOverlaps++;
+    }
+
+    testNow = start;
+    testOnAir = txBufObj;
+    pObj->phyState = PHY_STATE_TX;
+    testAirEnd = start + lRF215_PHY_PpduDuration(&pObj->phyConfig, txBufObj->reqObj.modScheme,
+            txBufObj->reqObj.psduLen, &symbols);
+    _log((start != txTime) ? "%s@%lu(late) " : "%s@%lu ", testTxNames[txBufObj->txHandle],
+            (unsigned long) (start - TEST_TIME_BASE));
+}
+
+static void _txEnd(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    DRV_RF215_TX_BUFFER_OBJ* txBufObj = testOnAir;
+
+    testOnAir = NULL;
+    testAirFree = testAirEnd + pObj->turnaroundTimeUS;
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    testNow += TEST_TX_END_US + testCfmDelay;
+    testCfmDelay = 0U;
+    RF215_PHY_SetTxCfm(txBufObj, RF215_TX_SUCCESS);
+}
+
+/* TX confirms set by the PHY, in buffer order */
+static void _cfmDeliver(void)
+{
+    uint8_t idx;
+
+    for (idx = 0U; idx < DRV_RF215_TX_BUFFERS_NUMBER; idx++)
+    {
+        DRV_RF215_TX_BUFFER_OBJ* txBufObj = &testTxBuffers[idx];
+
+        if ((txBufObj->inUse == true) && (txBufObj->cfmPending == true))
+        {
+            DRV_RF215_TX_RESULT result = txBufObj->cfmObj.txResult;
+
+            _log("[%s:%s] ", testTxNames[idx], (result < (sizeof(testResultNames) / sizeof(testResultNames[0]))) ?
+                    testResultNames[result] : "?");
+            txBufObj->inUse = false;
+            txBufObj->cfmPending = false;
+            testConfirms++;
+        }
+    }
+}
+
+static void _txRequest(const TEST_EVENT* event)
+{
+    DRV_RF215_TX_BUFFER_OBJ* txBufObj;
+    DRV_RF215_TX_RESULT result;
+    uint8_t idx;
+
+    testRequests++;
+    for (idx = 0U; idx < DRV_RF215_TX_BUFFERS_NUMBER; idx++)
+    {
+        if (testTxBuffers[idx].inUse == false)
+        {
+            break;
+        }
+    }
+
+    if (idx == DRV_RF215_TX_BUFFERS_NUMBER)
+    {
+        _log("[%s:NO_BUFFER] ", event->name);
+        testConfirms++;
+        return;
+    }
+
+    txBufObj = &testTxBuffers[idx];
+    (void) memset(txBufObj, 0, sizeof(*txBufObj));
+    txBufObj->clientObj = &testClient;
+    txBufObj->inUse = true;
+    txBufObj->txHandle = (DRV_RF215_TX_HANDLE) idx;
+    txBufObj->reqObj.timeCount = (uint64_t) event->arg + TEST_TIME_BASE;
+    txBufObj->reqObj.timeMode = TX_TIME_ABSOLUTE;
+    txBufObj->reqObj.psduLen = TEST_PSDU_LEN;
+    txBufObj->reqObj.ccaMode = event->ccaMode;
+    txBufObj->reqObj.cancelByRx = event->cancelByRx;
+    txBufObj->reqObj.modScheme = FSK_FEC_OFF;
+    testTxNames[idx] = event->name;
+
+    result = RF215_PHY_TxRequest(txBufObj);
+    if (result != RF215_TX_SUCCESS)
+    {
+        txBufObj->cfmObj.txResult = result;
+        txBufObj->cfmPending = true;
+    }
+}
+
+static void _event(const TEST_EVENT* event)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    uint8_t idx;
+
+    switch (event->type)
+    {
+        case TEST_EV_REQUEST:
+            _txRequest(event);
+            break;
+
+        case TEST_EV_RX:
+            /* Frame detected while listening: cancel by RX */
+            if (pObj->phyState <= PHY_STATE_RX_LISTEN)
+            {
+                pObj->phyState = PHY_STATE_RX_HEADER;
+                testRxOn = true;
+                testRxEnd = (uint64_t) event->arg + TEST_TIME_BASE;
+                DRV_RF215_AbortTxByRx(RF215_TRX_RF09_IDX);
+            }
+            break;
+
+        case TEST_EV_CCA_BUSY:
+            testCcaBusyNext = true;
+            break;
+
+        case TEST_EV_CFM_DELAY:
+            testCfmDelay = event->arg;
+            break;
+
+        default:
+            for (idx = 0U; idx < DRV_RF215_TX_BUFFERS_NUMBER; idx++)
+            {
+                if ((testTxBuffers[idx].inUse == true) && (strcmp(testTxNames[idx], event->name) == 0))
+                {
+                    /* The buffer is freed without TX confirm */
+                    RF215_PHY_TxCancel(&testTxBuffers[idx]);
+                    if (testTxBuffers[idx].inUse == false)
+                    {
+                        _log("[%s:CANCELLED] ", event->name);
+                        testConfirms++;
+                    }
+                }
+            }
+            break;
+    }
+}
+
+static void _scriptInit(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+
+    (void) memset(testTimers, 0, sizeof(testTimers));
+    (void) memset(testTxBuffers, 0, sizeof(testTxBuffers));
+    testNow = TEST_TIME_BASE;
+    testOnAir = NULL;
+    testAirFree = 0U;
+    testRxOn = false;
+    testCcaBusyNext = false;
+    testCfmDelay = 0U;
+    testLog[0] = '\0';
+    testLogLen = 0U;
+    testRequests = 0U;
+    testConfirms = 0U;
+    testOverlaps = 0U;
+
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    (void) memset(&pObj->txSchedStats, 0, sizeof(pObj->txSchedStats));
+    pObj->txSchedNum = 0U;
+#endif
+    pObj->phyState = PHY_STATE_RX_LISTEN;
+    pObj->trxState = RF215_RFn_STATE_RF_RX;
+    pObj->trxRdy = true;
+    pObj->txStarted = false;
+    pObj->txPendingState = PHY_STATE_RESET;
+}
+
+/* Run the events and the timers in time order until nothing is pending */
+static int _scriptRun(const TEST_EVENT* events, size_t numEvents)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    size_t next = 0U;
+    int timersMax = 0;
+
+    while (true)
+    {
+        enum { NEXT_NONE, NEXT_TIMER, NEXT_TX_END, NEXT_RX_END, NEXT_EVENT } kind = NEXT_NONE;
+        uint64_t tNext = UINT64_MAX;
+        uint8_t idx, timerIdx = 0U;
+        int timers;
+
+        for (idx = 0U; idx < TEST_TIMERS_NUM; idx++)
+        {
+            if ((testTimers[idx].active == true) && (testTimers[idx].due < tNext))
+            {
+                tNext = testTimers[idx].due;
+                timerIdx = idx;
+                kind = NEXT_TIMER;
+            }
+        }
+
+        if ((testOnAir != NULL) && (testAirEnd <= tNext))
+        {
+            tNext = testAirEnd;
+            kind = NEXT_TX_END;
+        }
+
+        if ((testRxOn == true) && (testRxEnd <= tNext))
+        {
+            tNext = testRxEnd;
+            kind = NEXT_RX_END;
+        }
+
+        if ((next < numEvents) && (((uint64_t) events[next].time + TEST_TIME_BASE) <= tNext))
+        {
+            tNext = (uint64_t) events[next].time + TEST_TIME_BASE;
+            kind = NEXT_EVENT;
+        }
+
+        if (kind == NEXT_NONE)
+        {
+            break;
+        }
+
+        testNow = (tNext > testNow) ? tNext : testNow;
+        switch (kind)
+        {
+            case NEXT_TIMER:
+            {
+                TEST_TIMER timer = testTimers[timerIdx];
+
+                testTimers[timerIdx].active = false;
+                testTimers[timerIdx].callback = NULL;
+                if (timer.callback == lRF215_TX_StartTimeExpired)
+                {
+                    DRV_RF215_TX_BUFFER_OBJ* txBufObj = DRV_RF215_TxHandleValidate((DRV_RF215_TX_HANDLE) timer.context);
+                    if (txBufObj != NULL)
+                    {
+                        _txStart(txBufObj);
+                    }
+                }
+                else if (timer.callback != lRF215_TX_ReadCaptureTimeExpired)
+                {
+                    timer.callback(timer.context);
+                }
+                else
+                {
+                    /* TX time capture not modeled */
+                }
+                break;
+            }
+
+            case NEXT_TX_END:
+                _txEnd();
+                break;
+
+            case NEXT_RX_END:
+                testRxOn = false;
+                if (pObj->phyState == PHY_STATE_RX_HEADER)
+                {
+                    pObj->phyState = PHY_STATE_RX_LISTEN;
+                }
+                break;
+
+            default:
+                _event(&events[next]);
+                next++;
+                break;
+        }
+
+        timers = _txTimersActive();
+        timersMax = (timers > timersMax) ? timers : timersMax;
+        _cfmDeliver();
+    }
+
+    return timersMax;
+}
+
+static int _script(const char* title, const TEST_EVENT* events, size_t numEvents, const char* expected,
+    const TEST_STATS* pStats)
+{
+    int timersMax;
+    bool fail;
+
+    _scriptInit();
+    timersMax = _scriptRun(events, numEvents);
+    fail = (strcmp(testLog, expected) != 0) || (testConfirms != testRequests) || (testOverlaps != 0U);
+
+#if (DRV_RF215_TX_SCHEDULE_ENABLE != 0U)
+    RF215_PHY_TX_SCHED_STATS stats;
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+
+    RF215_PHY_GetTxSchedStats(RF215_TRX_RF09_IDX, &stats, false);
+    if ((stats.txQueued != pStats->txQueued) || (stats.txConflict != pStats->txConflict) ||
+            (stats.txLateStart != pStats->txLateStart) || (stats.txAbortedByRx != pStats->txAbortedByRx) ||
+            (stats.txCcaBusy != pStats->txCcaBusy) || (stats.queueNumMax != pStats->queueNumMax) ||
+            (pObj->txSchedNum != 0U) || (timersMax > 1))
+    {
+        fail = true;
+    }
+
+    printf("%-4s %-14s %s\n", (fail == true) ? "FAIL" : "ok", title, testLog);
+    if (fail == true)
+    {
+        printf("     expected       %s\n", expected);
+    }
+
+    printf("     queued %u, conflicts %u, late starts %u, aborted by RX %u, CCA busy %u, queue max %u, "
+            "TX timers %d, confirms %u/%u\n", (unsigned) stats.txQueued, (unsigned) stats.txConflict,
+            (unsigned) stats.txLateStart, (unsigned) stats.txAbortedByRx, (unsigned) stats.txCcaBusy,
+            (unsigned) stats.queueNumMax, timersMax, testConfirms, testRequests);
+    return (fail == true) ? 1 : 0;
+#else
+    (void) pStats;
+    printf("%-4s %-14s %s\n", (fail == true) ? "diff" : "same", title, testLog);
+    printf("     TX timers %d, confirms %u/%u\n", timersMax, testConfirms, testRequests);
+    return 0;
+#endif
+}
+
+static int _testScripts(void)
+{
+    RF215_PHY_OBJ* pObj = &rf215PhyObj[RF215_TRX_RF09_IDX];
+    const DRV_RF215_PHY_CCA_MODE cca = PHY_CCA_MODE_3;
+    const DRV_RF215_PHY_CCA_MODE off = PHY_CCA_OFF;
+    DRV_RF215_TX_BUFFER_OBJ txBufObj = {0};
+    char expected[TEST_LOG_SIZE];
+    uint32_t ppdu, delay, slot;
+    uint16_t symbols;
+    int nErrors = 0;
+
+    if (lRF215_PHY_BandOpModeToPhyCfg(SUN_FSK_BAND_863_OPM1, &pObj->phyConfig) == false)
+    {
+        printf("FAIL: no FSK 863 MHz operating mode 1\n");
+        return 1;
+    }
+
+    pObj->turnaroundTimeUS = TEST_TURNAROUND_US;
+    testClient.trxIndex = RF215_TRX_RF09_IDX;
+
+    /* Back to back slot: PPDU and turnaround time. Worst TX delay: CCA. */
+    ppdu = lRF215_PHY_PpduDuration(&pObj->phyConfig, FSK_FEC_OFF, TEST_PSDU_LEN, &symbols);
+    txBufObj.clientObj = &testClient;
+    txBufObj.reqObj.ccaMode = cca;
+    txBufObj.reqObj.psduLen = TEST_PSDU_LEN;
+    delay = lRF215_TX_TotalDelay(&txBufObj);
+    slot = ppdu + TEST_TURNAROUND_US;
+    printf("PPDU of %u bytes %u us, turnaround %u us, TX delay with CCA %u us, slot %u us\n",
+            TEST_PSDU_LEN, (unsigned) ppdu, TEST_TURNAROUND_US, (unsigned) delay, (unsigned) slot);
+
+    {
+        /* Beacon and ACK train: three frames requested at once, back to back */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("B", 1U, 20000U + slot, off, false),
+            TEST_TX("C", 2U, 20000U + (2U * slot), off, false)
+        };
+        const TEST_STATS stats = {3U, 0U, 0U, 0U, 0U, 3U};
+
+        (void) snprintf(expected, sizeof(expected), "A@20000 [A:OK] B@%u [B:OK] C@%u [C:OK] ",
+                (unsigned) (20000U + slot), (unsigned) (20000U + (2U * slot)));
+        nErrors += _script("train", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* 1 us overlap with a queued frame: rejected, the rest not affected */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("X", 1U, 20000U + slot - 1U, off, false),
+            TEST_TX("B", 2U, 20000U + slot, off, false)
+        };
+        const TEST_STATS stats = {2U, 1U, 0U, 0U, 0U, 2U};
+
+        (void) snprintf(expected, sizeof(expected), "[X:BUSY_TX] A@20000 [A:OK] B@%u [B:OK] ",
+                (unsigned) (20000U + slot));
+        nErrors += _script("conflict", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* Requested out of order: the earlier frame takes the timer */
+        const TEST_EVENT events[] = {
+            TEST_TX("B", 0U, 30000U, off, false),
+            TEST_TX("A", 1U, 20000U, off, false)
+        };
+        const TEST_STATS stats = {2U, 0U, 0U, 0U, 0U, 2U};
+
+        nErrors += _script("out-of-order", events, TEST_NUM(events), "A@20000 [A:OK] B@30000 [B:OK] ", &stats);
+    }
+
+    {
+        /* Request ending over the start of a scheduled frame */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("X", 19990U - (delay / 2U), 19990U - (delay / 2U) + delay, off, false)
+        };
+        const TEST_STATS stats = {1U, 1U, 0U, 0U, 0U, 1U};
+
+        nErrors += _script("overlap-next", events, TEST_NUM(events), "[X:BUSY_TX] A@20000 [A:OK] ", &stats);
+    }
+
+    {
+        /* Earlier request ending 1 us over a frame still waiting in the queue */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 40000U, off, false),
+            TEST_TX("X", 1U, 40000U - slot + 1U, off, false)
+        };
+        const TEST_STATS stats = {1U, 1U, 0U, 0U, 0U, 1U};
+
+        nErrors += _script("overlap-queued", events, TEST_NUM(events), "[X:BUSY_TX] A@40000 [A:OK] ", &stats);
+    }
+
+    {
+        /* RX in progress when a CCA frame is prepared: BUSY_RX, next one sent */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, cca, false),
+            TEST_TX("B", 1U, 20000U + slot, cca, false),
+            TEST_RX(19000U, 20500U)
+        };
+        const TEST_STATS stats = {2U, 0U, 0U, 1U, 0U, 2U};
+
+        (void) snprintf(expected, sizeof(expected), "[A:BUSY_RX] B@%u [B:OK] ", (unsigned) (20000U + slot));
+        nErrors += _script("rx-busy", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* A received frame cancels the queued cancel by RX frames only */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, cca, true),
+            TEST_TX("B", 1U, 20000U + slot, off, false),
+            TEST_TX("C", 2U, 20000U + (2U * slot), cca, true),
+            TEST_RX(5000U, 6000U)
+        };
+        const TEST_STATS stats = {3U, 0U, 0U, 2U, 0U, 3U};
+
+        (void) snprintf(expected, sizeof(expected), "[A:CANCEL_BY_RX] [C:CANCEL_BY_RX] B@%u [B:OK] ",
+                (unsigned) (20000U + slot));
+        nErrors += _script("cancel-by-rx", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* Busy channel for the first frame, the second one sent on time */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, cca, false),
+            TEST_TX("B", 1U, 20000U + slot, cca, false),
+            TEST_CCA_BUSY(2U)
+        };
+        const TEST_STATS stats = {2U, 0U, 0U, 0U, 1U, 2U};
+
+        (void) snprintf(expected, sizeof(expected), "[A:BUSY_CHN] B@%u [B:OK] ", (unsigned) (20000U + slot));
+        nErrors += _script("cca-busy", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* First frame cancelled: the timer passes to the next one */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("B", 1U, 20000U + slot, off, false),
+            TEST_CANCEL("A", 100U)
+        };
+        const TEST_STATS stats = {2U, 0U, 0U, 0U, 0U, 2U};
+
+        (void) snprintf(expected, sizeof(expected), "[A:CANCELLED] B@%u [B:OK] ", (unsigned) (20000U + slot));
+        nErrors += _script("cancel-head", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* Next frame prepared after the end of the previous one (TX delay
+         * longer than the turnaround time): late timer start, TX on time */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("B", 1U, 20000U + slot, cca, false)
+        };
+        const TEST_STATS stats = {2U, 0U, (delay > TEST_TURNAROUND_US) ? 1U : 0U, 0U, 0U, 2U};
+
+        (void) snprintf(expected, sizeof(expected), "A@20000 [A:OK] B@%u [B:OK] ", (unsigned) (20000U + slot));
+        nErrors += _script("late-start", events, TEST_NUM(events), expected, &stats);
+    }
+
+    {
+        /* Confirm of the first frame too late for the second: timeout, the
+         * third one sent */
+        const TEST_EVENT events[] = {
+            TEST_TX("A", 0U, 20000U, off, false),
+            TEST_TX("B", 1U, 20000U + slot, off, false),
+            TEST_TX("C", 2U, 20000U + slot + 15000U, off, false),
+            TEST_CFM_DELAY(3U, 12000U)
+        };
+        const TEST_STATS stats = {3U, 0U, 1U, 0U, 0U, 3U};
+
+        (void) snprintf(expected, sizeof(expected), "A@20000 [A:OK] [B:TIMEOUT] C@%u [C:OK] ",
+                (unsigned) (20000U + slot + 15000U));
+        nErrors += _script("late-confirm", events, TEST_NUM(events), expected, &stats);
+    }
+
+    return nErrors;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    int nErrors;
+
+    nErrors = _testScripts();
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,755 @@
+/*******************************************************************************
+  TOU calendar year test
+
+  File Name:
+    tou_year.c
+
+  Summary:
+    Host test of the compiled TOU schedule and the demand windows of
+    app_energy.c over a simulated year with DST changes.
+
+  Description:
+    app_energy.c of the G3 metering demo is built for the host with stubs of
+    the RTC and of the datalog. The RTC keeps local wall-clock time, as on the
+    meter, and follows the EU DST rules: it steps from 02:00 to 03:00 on the
+    last Sunday of March and from 03:00 back to 02:00 on the last Sunday of
+    October. Every minute the RTC minute event is raised, along with the
+    calendar event on the first minute of a month, and 4 energy samples are
+    queued and processed by APP_ENERGY_Tasks.
+
+    The TOU configuration is larger than the default one: 4 day profiles of up
+    to 8 unsorted zones, with zones at 00:00 and 23:59 and invalid zones, 4
+    seasons in no particular order, and 16 holidays, including Feb 29. The run
+    goes from December 2027 to January 2029, so it covers two year changes,
+    a leap day and both DST changes. The calendar and the demand window are
+    changed in the middle of the run.
+
+    A reference model evaluates the calendar and the zones by linear search
+    for every sample, accumulates the energy per tariff and keeps the maximum
+    demand from the last closed subintervals, without the transition table
+    or the running sums of app_energy.c. After every sample the current
+    tariff, the energy accumulators and the maximum demand of app_energy.c
+    must be equal to the ones of the model. The tariffs of some minutes are
+    also checked against values worked out by hand, and the full lookups of
+    the schedule must stay below 1% of the samples.
+
+    Usage:
+      tou_year
+*******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "definitions.h"
+#include "app_energy.h"
+
+/* app_energy.c checks the RTC interrupts and the tamper counter */
+static rtc_registers_t testRtc;
+#undef RTC_REGS
+#define RTC_REGS                            (&testRtc)
+
+#include "app_energy.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_SAMPLES_PER_MIN    4U
+#define TEST_SAMPLE_S           (60U / TEST_SAMPLES_PER_MIN)
+#define TEST_MAX_TASKS          64U
+#define TEST_MAX_FAILS_SHOWN    20U
+
+/* Tariff of a minute, worked out by hand from the configuration */
+typedef struct
+{
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    APP_ENERGY_TARIFF_TYPE tariff;
+} TEST_SPOT;
+
+/* Configuration change applied before the minute event of a local time */
+typedef struct
+{
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    APP_ENERGY_DEMAND_CONFIG demandConfig;
+    bool newCalendar;
+} TEST_CHANGE;
+
+typedef struct
+{
+    APP_ENERGY_ACCUMULATORS energy;
+    APP_ENERGY_MAX_DEMAND maxDemand;
+    APP_ENERGY_DEMAND_CONFIG demandConfig;
+    uint32_t minuteSum;
+    uint32_t minuteSamples;
+    uint32_t subintervalSum;
+    /* Closed subintervals, the last one at the end */
+    uint32_t subinterval[APP_ENERGY_DEMAND_MAX_SUBINTERVALS];
+    uint8_t numSubintervals;
+    uint32_t evaluations;
+} TEST_MODEL;
+
+static const APP_ENERGY_TOU_TIME_ZONE testDayProfile0[APP_ENERGY_TOU_MAX_ZONES] =
+{
+    {TARIFF_2, 7, 0},
+    {TARIFF_3, 9, 30},
+    {TARIFF_2, 13, 0},
+    {TARIFF_3, 17, 0},
+    {TARIFF_1, 21, 0},
+    {TARIFF_4, 23, 59},
+    {TARIFF_4, 1, 0},
+    {TARIFF_1, 0, 0},
+};
+
+static const APP_ENERGY_TOU_CALENDAR testCalendar =
+{
+    0,
+    {
+        /* Day profile 1: weekends, with a zone inside the DST hours */
+        {
+            {TARIFF_2, 10, 0},
+            {TARIFF_1, 0, 0},
+            {TARIFF_3, 2, 30},
+            {TARIFF_1, 14, 0},
+            {TARIFF_2, 18, 0},
+            {TARIFF_1, 22, 0},
+            {TARIFF_3, 24, 0},
+            {TARIFF_3, 12, 60},
+        },
+        /* Day profile 2: summer workdays */
+        {
+            {TARIFF_3, 6, 0},
+            {TARIFF_4, 8, 0},
+            {TARIFF_3, 11, 0},
+            {TARIFF_4, 14, 0},
+            {TARIFF_3, 16, 30},
+            {TARIFF_2, 19, 0},
+            {TARIFF_1, 22, 30},
+            {TARIFF_2, 3, 15},
+        },
+        /* Day profile 3: holidays */
+        {
+            {TARIFF_2, 12, 1},
+            {TARIFF_1, 12, 0},
+            {TARIFF_INVALID, 0, 0},
+            {TARIFF_INVALID, 0, 0},
+            {TARIFF_INVALID, 0, 0},
+            {TARIFF_INVALID, 0, 0},
+            {TARIFF_INVALID, 0, 0},
+            {TARIFF_INVALID, 0, 0},
+        },
+    },
+    {
+        {6, 1, {2, 1, 1}},
+        {11, 1, {0, 1, 1}},
+        {3, 20, {0, 1, 3}},
+        {9, 15, {2, 1, 1}},
+    },
+    {
+        {1, 1, 3}, {1, 6, 3}, {2, 29, 3}, {3, 19, 1},
+        {4, 1, 2}, {5, 1, 3}, {5, 31, 0}, {6, 1, 3},
+        {8, 15, 3}, {10, 12, 1}, {11, 1, 3}, {11, 9, 2},
+        {12, 8, 3}, {12, 24, 1}, {12, 25, 3}, {12, 31, 2},
+    },
+};
+
+static const TEST_SPOT testSpots[] =
+{
+    /* Holiday: 12:00 still belongs to the last zone of the day */
+    {2028, 1, 1, 12, 0, TARIFF_2},
+    {2028, 1, 1, 12, 1, TARIFF_1},
+    {2028, 1, 1, 12, 2, TARIFF_2},
+    /* Sunday before the first season of the year: season of November */
+    {2028, 1, 2, 2, 30, TARIFF_1},
+    {2028, 1, 2, 2, 31, TARIFF_3},
+    {2028, 2, 29, 12, 1, TARIFF_1},
+    /* DST day, Sunday of the spring season */
+    {2028, 3, 26, 3, 0, TARIFF_2},
+    {2028, 7, 4, 9, 0, TARIFF_4},
+    /* Both 02:45 of the DST day */
+    {2028, 10, 29, 2, 45, TARIFF_3},
+    /* Holiday of an emptied day profile: day profile 0 */
+    {2028, 12, 25, 0, 0, TARIFF_4},
+    {2028, 12, 25, 0, 1, TARIFF_1},
+    {2028, 12, 25, 1, 1, TARIFF_4},
+};
+
+static const TEST_CHANGE testChanges[] =
+{
+    {2028, 4, 1, 0, 0, {5, 3, true}, false},
+    {2028, 7, 1, 12, 0, {10, 6, false}, true},
+    {2028, 10, 1, 0, 0, {1, 15, true}, false},
+    {2029, 1, 1, 0, 0, {30, 2, false}, false},
+};
+
+static APP_ENERGY_TOU_TIME_ZONE testZones[APP_ENERGY_TOU_MAX_ZONES];
+static APP_ENERGY_TOU_CALENDAR testCal;
+static TEST_MODEL testModel;
+static time_t testWall;
+static RTC_CALLBACK testRtcCallback;
+static uint32_t testStores;
+static uint32_t testSpotHits;
+static uint32_t testFails;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool RTC_TimeSet(struct tm *sysTime)
+{
+    testWall = timegm(sysTime);
+    return true;
+}
+
+void RTC_TimeGet(struct tm *sysTime)
+{
+    (void) gmtime_r(&testWall, sysTime);
+}
+
+void RTC_LastTimeStampGet(struct tm *sysTime, RTC_TAMP_INPUT tamperInput)
+{
+    (void) tamperInput;
+    RTC_TimeGet(sysTime);
+}
+
+void RTC_CallbackRegister(RTC_CALLBACK callback, uintptr_t context)
+{
+    (void) context;
+    testRtcCallback = callback;
+}
+
+void RTC_InterruptEnable(RTC_INT_MASK interrupt)
+{
+    *(uint32_t *)&testRtc.RTC_IMR |= (uint32_t)interrupt;
+}
+
+void SYS_CMD_PRINT(const char *format, ...)
+{
+    (void) format;
+}
+
+APP_DATALOG_STATES APP_DATALOG_GetStatus(void)
+{
+    return APP_DATALOG_STATE_READY;
+}
+
+bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date)
+{
+    (void) userId;
+    (void) date;
+    return false;
+}
+
+void APP_DATALOG_ClearData(APP_DATALOG_USER userId)
+{
+    (void) userId;
+}
+
+bool APP_DATALOG_SendDatalogData(APP_DATALOG_QUEUE_DATA *datalogData)
+{
+    (void) datalogData;
+    testStores++;
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helpers
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _rand64(void)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return testRandState * 0x2545F4914F6CDD1DULL;
+}
+
+static void _fail(const char *name, const char *msg, uint32_t value)
+{
+    testFails++;
+    if (testFails <= TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s: %s %u\n", name, msg, (unsigned)value);
+    }
+}
+
+static time_t _time(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute)
+{
+    struct tm time;
+
+    memset(&time, 0, sizeof(time));
+    time.tm_year = year - 1900;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    return timegm(&time);
+}
+
+/* UTC time of the EU DST change: last Sunday of the month at 01:00 UTC */
+static time_t _dstChange(int year, uint8_t month)
+{
+    time_t change = _time((uint16_t)year, month, 31, 1, 0);
+    struct tm time;
+
+    (void) gmtime_r(&change, &time);
+    return change - ((time_t)time.tm_wday * 86400);
+}
+
+/* Local time of a UTC time in Central Europe */
+static time_t _localTime(time_t utc)
+{
+    struct tm time;
+
+    (void) gmtime_r(&utc, &time);
+    if ((utc >= _dstChange(time.tm_year + 1900, 3)) && (utc < _dstChange(time.tm_year + 1900, 10)))
+    {
+        return utc + 7200;
+    }
+
+    return utc + 3600;
+}
+
+static const char *_timeName(const struct tm *time)
+{
+    static char name[64];
+
+    (void) snprintf(name, sizeof(name), "%04d-%02d-%02d %02d:%02d:%02d", time->tm_year + 1900,
+            time->tm_mon + 1, time->tm_mday, time->tm_hour, time->tm_min, time->tm_sec);
+    return name;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Reference Model
+// *****************************************************************************
+// *****************************************************************************
+
+static const APP_ENERGY_TOU_TIME_ZONE *_modelZones(uint8_t profile)
+{
+    return (profile == 0U) ? testZones : testCal.dayProfile[profile - 1U];
+}
+
+static bool _modelZoneValid(const APP_ENERGY_TOU_TIME_ZONE *zone)
+{
+    return (zone->tariff >= TARIFF_1) && (zone->tariff <= TARIFF_NUM_TYPE) && (zone->hour <= 23U) &&
+            (zone->minute <= 59U);
+}
+
+static uint8_t _modelDayProfile(const struct tm *time)
+{
+    uint32_t date = ((uint32_t)(time->tm_mon + 1) * 100U) + (uint32_t)time->tm_mday;
+    uint32_t start, best = 0U, last = 0U;
+    int bestSeason = -1, lastSeason = -1;
+    uint8_t profile = 0U, dayType, idx;
+    bool holiday = false, valid = false;
+
+    for (idx = 0U; idx < APP_ENERGY_TOU_MAX_HOLIDAYS; idx++)
+    {
+        if ((testCal.holiday[idx].month != 0U) &&
+                ((((uint32_t)testCal.holiday[idx].month * 100U) + testCal.holiday[idx].day) == date))
+        {
+            profile = testCal.holiday[idx].dayProfile;
+            holiday = true;
+            break;
+        }
+    }
+
+    if (holiday == false)
+    {
+        dayType = (time->tm_wday == 6) ? APP_ENERGY_DAY_TYPE_SATURDAY :
+                ((time->tm_wday == 0) ? APP_ENERGY_DAY_TYPE_SUNDAY : APP_ENERGY_DAY_TYPE_WORKDAY);
+
+        /* Latest start date up to today, or the latest of the year */
+        for (idx = 0U; idx < APP_ENERGY_TOU_MAX_SEASONS; idx++)
+        {
+            if (testCal.season[idx].month == 0U)
+            {
+                continue;
+            }
+
+            start = ((uint32_t)testCal.season[idx].month * 100U) + testCal.season[idx].day;
+            if ((start <= date) && ((bestSeason < 0) || (start > best)))
+            {
+                bestSeason = idx;
+                best = start;
+            }
+
+            if ((lastSeason < 0) || (start > last))
+            {
+                lastSeason = idx;
+                last = start;
+            }
+        }
+
+        if (bestSeason < 0)
+        {
+            bestSeason = lastSeason;
+        }
+
+        if (bestSeason >= 0)
+        {
+            profile = testCal.season[bestSeason].dayProfile[dayType];
+        }
+    }
+
+    for (idx = 0U; (profile < APP_ENERGY_TOU_MAX_DAY_PROFILES) && (idx < APP_ENERGY_TOU_MAX_ZONES); idx++)
+    {
+        valid = valid || _modelZoneValid(&_modelZones(profile)[idx]);
+    }
+
+    return (valid == true) ? profile : 0U;
+}
+
+/* Zone with the latest start before the minute: the minute event at the start
+ * of a zone closes the last minute of the previous one. Before the first
+ * zone of the day, the last one applies */
+static uint8_t _modelTariffIndex(const struct tm *time)
+{
+    const APP_ENERGY_TOU_TIME_ZONE *zones = _modelZones(_modelDayProfile(time));
+    int32_t minute = (time->tm_hour * 60) + time->tm_min;
+    int32_t start, before = -1, latest = -1;
+    uint8_t tariffBefore = 0U, tariffLatest = 0U, idx;
+
+    for (idx = 0U; idx < APP_ENERGY_TOU_MAX_ZONES; idx++)
+    {
+        if (_modelZoneValid(&zones[idx]) == false)
+        {
+            continue;
+        }
+
+        start = ((int32_t)zones[idx].hour * 60) + zones[idx].minute;
+        if ((start < minute) && (start > before))
+        {
+            before = start;
+            tariffBefore = zones[idx].tariff - 1U;
+        }
+
+        if (start > latest)
+        {
+            latest = start;
+            tariffLatest = zones[idx].tariff - 1U;
+        }
+    }
+
+    return (before >= 0) ? tariffBefore : tariffLatest;
+}
+
+static void _modelSetDemandConfig(const APP_ENERGY_DEMAND_CONFIG *config)
+{
+    testModel.demandConfig = *config;
+    testModel.subintervalSum = 0U;
+    testModel.numSubintervals = 0U;
+}
+
+static void _modelSetMax(APP_ENERGY_DEMAND_DATA *data, uint32_t value, const struct tm *time)
+{
+    if (data->value < value)
+    {
+        data->value = value;
+        data->month = (uint8_t)time->tm_mon;
+        data->day = (uint8_t)time->tm_mday;
+        data->hour = (uint8_t)time->tm_hour;
+        data->minute = (uint8_t)time->tm_min;
+    }
+}
+
+static void _modelMinute(const struct tm *time, uint8_t tariffIndex)
+{
+    APP_ENERGY_DEMAND_CONFIG *config = &testModel.demandConfig;
+    uint32_t minute = (time->tm_min == 0) ? 60U : (uint32_t)time->tm_min;
+    uint32_t windowMin = (uint32_t)config->subintervalMin * config->numSubintervals;
+    uint64_t sum = 0U;
+    uint8_t idx;
+
+    testModel.subintervalSum += testModel.minuteSum / testModel.minuteSamples;
+    testModel.minuteSum = 0U;
+    testModel.minuteSamples = 0U;
+
+    if ((minute % config->subintervalMin) != 0U)
+    {
+        return;
+    }
+
+    if (testModel.numSubintervals == config->numSubintervals)
+    {
+        memmove(&testModel.subinterval[0], &testModel.subinterval[1],
+                (config->numSubintervals - 1U) * sizeof(uint32_t));
+        testModel.numSubintervals--;
+    }
+    testModel.subinterval[testModel.numSubintervals++] = testModel.subintervalSum;
+    testModel.subintervalSum = 0U;
+
+    if ((config->sliding == false) && ((minute % windowMin) != 0U))
+    {
+        return;
+    }
+
+    for (idx = 0U; idx < testModel.numSubintervals; idx++)
+    {
+        sum += testModel.subinterval[idx];
+    }
+
+    testModel.evaluations++;
+    _modelSetMax(&testModel.maxDemand.tariff[tariffIndex], (uint32_t)(sum / (windowMin * 10U)), time);
+    _modelSetMax(&testModel.maxDemand.maxDemad, (uint32_t)(sum / (windowMin * 10U)), time);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Test Run
+// *****************************************************************************
+// *****************************************************************************
+
+static bool _runUntilRunning(void)
+{
+    uint32_t tasks;
+
+    for (tasks = 0U; tasks < TEST_MAX_TASKS; tasks++)
+    {
+        APP_ENERGY_Tasks();
+        if (app_energyData.state == APP_ENERGY_STATE_RUNNING)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void _applyChanges(time_t local)
+{
+    const TEST_CHANGE *change;
+    size_t idx;
+
+    for (idx = 0U; idx < (sizeof(testChanges) / sizeof(testChanges[0])); idx++)
+    {
+        change = &testChanges[idx];
+        if (_time(change->year, change->month, change->day, change->hour, change->minute) != local)
+        {
+            continue;
+        }
+
+        if (change->newCalendar == true)
+        {
+            /* Holiday profile emptied and the autumn season removed */
+            memset(testCal.dayProfile[2], TARIFF_INVALID, sizeof(testCal.dayProfile[2]));
+            testCal.season[3].month = 0U;
+            testCal.holiday[8].dayProfile = 2U;
+            if (APP_ENERGY_SetTOUCalendar(&testCal) == false)
+            {
+                _fail("change", "calendar rejected, change", (uint32_t)idx);
+            }
+        }
+
+        if (APP_ENERGY_SetDemandConfig((APP_ENERGY_DEMAND_CONFIG *)&change->demandConfig) == false)
+        {
+            _fail("change", "demand window rejected, change", (uint32_t)idx);
+        }
+        _modelSetDemandConfig(&change->demandConfig);
+    }
+}
+
+static void _checkSpots(const struct tm *time)
+{
+    const TEST_SPOT *spot;
+    size_t idx;
+
+    for (idx = 0U; idx < (sizeof(testSpots) / sizeof(testSpots[0])); idx++)
+    {
+        spot = &testSpots[idx];
+        if ((spot->year == (time->tm_year + 1900)) && (spot->month == (time->tm_mon + 1)) &&
+                (spot->day == time->tm_mday) && (spot->hour == time->tm_hour) &&
+                (spot->minute == time->tm_min))
+        {
+            testSpotHits++;
+            if (app_energyData.currentTariffIndex != (spot->tariff - 1U))
+            {
+                _fail(_timeName(time), "tariff of the spot check, got", app_energyData.currentTariffIndex + 1U);
+            }
+        }
+    }
+}
+
+static void _sample(uint32_t second, bool minuteEvent, bool monthEvent)
+{
+    APP_ENERGY_QUEUE_DATA data;
+    struct tm time;
+    uint8_t tariffIndex;
+
+    (void) gmtime_r(&testWall, &time);
+    data.energy = (uint32_t)(_rand64() % 1000U);
+    data.Pt = 200000U + ((uint32_t)time.tm_hour * 10000U) + (uint32_t)(_rand64() % 300000U);
+
+    if (APP_ENERGY_SendEnergyData(&data) == false)
+    {
+        _fail(_timeName(&time), "sample not queued, second", second);
+        return;
+    }
+    APP_ENERGY_Tasks();
+
+    tariffIndex = _modelTariffIndex(&time);
+    testModel.energy.tariff[tariffIndex] += data.energy;
+    testModel.minuteSum += data.Pt;
+    testModel.minuteSamples++;
+    if (minuteEvent == true)
+    {
+        _modelMinute(&time, tariffIndex);
+    }
+    if (monthEvent == true)
+    {
+        memset(&testModel.energy, 0, sizeof(testModel.energy));
+        memset(&testModel.maxDemand, 0, sizeof(testModel.maxDemand));
+    }
+
+    if (app_energyData.currentTariffIndex != tariffIndex)
+    {
+        _fail(_timeName(&time), "tariff, expected", tariffIndex + 1U);
+    }
+
+    if (memcmp(&app_energyData.energyAccumulator, &testModel.energy, sizeof(testModel.energy)) != 0)
+    {
+        _fail(_timeName(&time), "energy accumulators differ, tariff", tariffIndex + 1U);
+        app_energyData.energyAccumulator = testModel.energy;
+    }
+
+    if (memcmp(&app_energyData.demand.maxDemand, &testModel.maxDemand, sizeof(testModel.maxDemand)) != 0)
+    {
+        _fail(_timeName(&time), "max demand differs, model total", testModel.maxDemand.maxDemad.value);
+        app_energyData.demand.maxDemand = testModel.maxDemand;
+    }
+
+    if (minuteEvent == true)
+    {
+        _checkSpots(&time);
+    }
+}
+
+static void _minute(time_t local)
+{
+    struct tm time;
+    uint32_t second;
+    bool monthEvent;
+
+    _applyChanges(local);
+
+    (void) gmtime_r(&local, &time);
+    monthEvent = (time.tm_mday == 1) && (time.tm_hour == 0) && (time.tm_min == 0);
+
+    testWall = local;
+    testRtcCallback(RTC_SR_TIMEV_Msk, 0);
+    if (monthEvent == true)
+    {
+        testRtcCallback(RTC_SR_CALEV_Msk, 0);
+    }
+
+    for (second = 0U; second < 60U; second += TEST_SAMPLE_S)
+    {
+        testWall = local + (time_t)second;
+        _sample(second, (second == 0U), ((second == 0U) && monthEvent));
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(void)
+{
+    time_t utc, start, end, local, previous;
+    uint32_t minutes = 0U, steps = 0U, lookups = 0U, samples;
+    uint32_t dayKey, current, next;
+    bool pass;
+
+    start = _time(2027, 12, 20, 0, 0) - 3600;
+    end = _time(2029, 1, 10, 0, 0) - 3600;
+
+    /* The RTC was running before the reset */
+    testWall = _localTime(start) - 60;
+    *(uint32_t *)&testRtc.RTC_IMR = RTC_INT_TIME | RTC_INT_CALENDAR;
+
+    APP_ENERGY_Initialize();
+    if (_runUntilRunning() == false)
+    {
+        printf("FAIL: initialization: state %u\n", (unsigned)app_energyData.state);
+        return 1;
+    }
+
+    memcpy(testZones, testDayProfile0, sizeof(testZones));
+    memcpy(&testCal, &testCalendar, sizeof(testCal));
+    APP_ENERGY_SetTOUTimeZone(testZones);
+    if (APP_ENERGY_SetTOUCalendar(&testCal) == false)
+    {
+        printf("FAIL: calendar rejected\n");
+        return 1;
+    }
+    APP_ENERGY_GetDemandConfig(&testModel.demandConfig);
+    _modelSetDemandConfig(&testModel.demandConfig);
+
+    previous = 0;
+    for (utc = start; utc < end; utc += 60)
+    {
+        local = _localTime(utc);
+        if ((previous != 0) && (local != (previous + 60)))
+        {
+            steps++;
+        }
+        previous = local;
+
+        dayKey = app_energyData.touSchedule.dayKey;
+        current = app_energyData.touSchedule.currentMinute;
+        next = app_energyData.touSchedule.nextMinute;
+
+        _minute(local);
+        minutes++;
+
+        if ((dayKey != app_energyData.touSchedule.dayKey) || (current != app_energyData.touSchedule.currentMinute) ||
+                (next != app_energyData.touSchedule.nextMinute))
+        {
+            lookups++;
+        }
+    }
+
+    samples = minutes * TEST_SAMPLES_PER_MIN;
+    if (steps != 2U)
+    {
+        _fail("run", "DST steps of the RTC", steps);
+    }
+
+    if (testSpotHits < (sizeof(testSpots) / sizeof(testSpots[0])))
+    {
+        _fail("run", "spot checks reached", testSpotHits);
+    }
+
+    if ((lookups * 100U) >= samples)
+    {
+        _fail("run", "full lookups of the schedule", lookups);
+    }
+
+    printf("minutes %u (RTC steps %u), samples %u, full lookups %u, demand evaluations %u, spot checks %u\n",
+            (unsigned)minutes, (unsigned)steps, (unsigned)samples, (unsigned)lookups,
+            (unsigned)testModel.evaluations, (unsigned)testSpotHits);
+
+    pass = (testFails == 0U);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,850 @@
+/*******************************************************************************
+  UDP batched send test
+
+  File Name:
+    udp_batch.c
+
+  Summary:
+    Host test of TCPIP_UDP_BatchSend and of the UDP local port index.
+
+  Description:
+    udp.c of the G3 coordinator UDP application is built for the host with
+    its own configuration. The IPv6 layer below it is replaced by a loopback:
+    a flushed packet is captured as a datagram (destination, ports, payload)
+    and then either acknowledged at once, as a packet handed to the MAC, or
+    kept queued until the test drains it, as a packet waiting for neighbor
+    resolution. The TCP/IP heap is replaced by the host heap, with a count
+    of the blocks in use to detect leaks.
+
+    The test checks that each item of a batch goes out as its own datagram,
+    in order, that a batch stops at the socket TX queue limit and resumes
+    from the returned count, that data already written to the socket is
+    never mixed with a batch and that the port index keeps the sockets
+    apart. It then measures the packets per second of a batch against the
+    same datagrams sent with the DestinationIPAddressSet, DestinationPortSet,
+    ArrayPut and Flush sequence.
+
+    Usage:
+      udp_batch [packets]           test and benchmark (100000 packets by default)
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tcpip/src/tcpip_private.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define LOOP_MAX_DATAGRAMS      64U
+#define LOOP_MAX_PAYLOAD        64U
+#define LOOP_MAX_QUEUED         16U
+
+#define TEST_REMOTE_PORT        0xF0B0U
+#define TEST_BATCH_ITEMS        10U
+
+/* IPv6 TX packet of the loopback: the stack packet plus the UDP header and
+ * payload references that the IPv6 layer would keep */
+typedef struct
+{
+    IPV6_PACKET                 v6Pkt;
+    IPV6_DATA_SEGMENT_HEADER    upperSeg;
+    uint8_t                     upperHeader[8];
+    const uint8_t*              pPayload;
+    uint16_t                    payloadLen;
+} LOOP_PACKET;
+
+/* Datagram captured by the loopback */
+typedef struct
+{
+    IPV6_ADDR   destAddress;
+    uint16_t    srcPort;
+    uint16_t    destPort;
+    uint16_t    dataLen;
+    uint8_t     data[LOOP_MAX_PAYLOAD];
+} LOOP_DATAGRAM;
+
+typedef struct
+{
+    LOOP_DATAGRAM   datagrams[LOOP_MAX_DATAGRAMS];
+    LOOP_PACKET*    queued[LOOP_MAX_QUEUED];
+    unsigned long   nFlushed;
+    unsigned int    nCaptured;
+    unsigned int    nQueued;
+    unsigned int    nPackets;
+    unsigned int    nHeapBlocks;
+    bool            queueMode;
+    bool            capture;
+} LOOP_DATA;
+
+static LOOP_DATA loopData;
+
+static TCPIP_NET_IF loopNet;
+static TCPIP_MAC_PACKET loopMacPkt;
+
+const IPV6_ADDR IPV6_FIXED_ADDR_UNSPECIFIED = {{0}};
+const IPV6_ADDR IPV6_FIXED_ADDR_ALL_NODES_MULTICAST = {{0xFF, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01}};
+const TCPIP_MAC_ADDR IPV6_MULTICAST_MAC_ADDRESS = {{0x33, 0x33, 0, 0, 0, 1}};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Host Heap
+// *****************************************************************************
+// *****************************************************************************
+
+static void* _loopMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    void* ptr = malloc(nBytes);
+
+    if (ptr != NULL)
+    {
+        loopData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static void* _loopCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* ptr = calloc(nElems, elemSize);
+
+    if (ptr != NULL)
+    {
+        loopData.nHeapBlocks++;
+    }
+
+    return ptr;
+}
+
+static size_t _loopFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff)
+{
+    if (pBuff != NULL)
+    {
+        loopData.nHeapBlocks--;
+        free((void*)pBuff);
+    }
+
+    return 0;
+}
+
+static const TCPIP_HEAP_OBJECT loopHeap =
+{
+    .TCPIP_HEAP_Malloc = _loopMalloc,
+    .TCPIP_HEAP_Calloc = _loopCalloc,
+    .TCPIP_HEAP_Free = _loopFree,
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Loopback IPv6 Layer
+// *****************************************************************************
+// *****************************************************************************
+
+IPV6_PACKET* TCPIP_IPV6_TxPacketAllocate(TCPIP_NET_HANDLE netH, IPV6_PACKET_ACK_FNC ackFnc, void* ackParam)
+{
+    LOOP_PACKET* pLoopPkt = (LOOP_PACKET*)calloc(1, sizeof(LOOP_PACKET));
+
+    if (pLoopPkt == NULL)
+    {
+        return NULL;
+    }
+
+    pLoopPkt->v6Pkt.netIfH = netH;
+    pLoopPkt->v6Pkt.ackFnc = ackFnc;
+    pLoopPkt->v6Pkt.ackParam = ackParam;
+    loopData.nPackets++;
+    return &pLoopPkt->v6Pkt;
+}
+
+void TCPIP_IPV6_PacketFree(IPV6_PACKET* pkt)
+{
+    loopData.nPackets--;
+    free(pkt);
+}
+
+IPV6_DATA_SEGMENT_HEADER* TCPIP_IPV6_UpperLayerHeaderPut(IPV6_PACKET* pkt, void* header, unsigned short len, unsigned char type, unsigned short checksumOffset)
+{
+    LOOP_PACKET* pLoopPkt = (LOOP_PACKET*)pkt;
+
+    memset(pLoopPkt->upperHeader, 0, sizeof(pLoopPkt->upperHeader));
+    pkt->upperLayerHeaderLen = len;
+    pkt->upperLayerHeaderType = type;
+    pkt->upperLayerChecksumOffset = checksumOffset;
+    return &pLoopPkt->upperSeg;
+}
+
+void* TCPIP_IPV6_UpperLayerHeaderPtrGet(IPV6_PACKET* pkt)
+{
+    return ((LOOP_PACKET*)pkt)->upperHeader;
+}
+
+void TCPIP_IPV6_SourceAddressSet(IPV6_PACKET* p, const IPV6_ADDR* addr)
+{
+    if (addr != NULL)
+    {
+        memcpy(&p->ipv6Header.SourceAddress, addr, sizeof(IPV6_ADDR));
+    }
+    else
+    {
+        memset(&p->ipv6Header.SourceAddress, 0, sizeof(IPV6_ADDR));
+    }
+}
+
+void TCPIP_IPV6_DestAddressSet(IPV6_PACKET* p, const IPV6_ADDR* addr)
+{
+    if (addr != NULL)
+    {
+        memcpy(&p->ipv6Header.DestAddress, addr, sizeof(IPV6_ADDR));
+    }
+    else
+    {
+        memset(&p->ipv6Header.DestAddress, 0, sizeof(IPV6_ADDR));
+    }
+}
+
+IPV6_ADDR* TCPIP_IPV6_SourceAddressGet(IPV6_PACKET* p)
+{
+    return &p->ipv6Header.SourceAddress;
+}
+
+IPV6_ADDR* TCPIP_IPV6_DestAddressGet(IPV6_PACKET* p)
+{
+    return &p->ipv6Header.DestAddress;
+}
+
+void TCPIP_IPV6_SetPacketMacAcknowledge(IPV6_PACKET* ptrPacket, TCPIP_MAC_PACKET_ACK_FUNC macAckFnc)
+{
+    ptrPacket->macAckFnc = macAckFnc;
+}
+
+void TCPIP_IPV6_SetRemoteMacAddress(IPV6_PACKET* ptrPacket, const TCPIP_MAC_ADDR* pMacAdd)
+{
+    memcpy(&ptrPacket->remoteMACAddr, pMacAdd, sizeof(TCPIP_MAC_ADDR));
+}
+
+bool TCPIP_IPV6_TxPacketStructCopy(IPV6_PACKET* destination, IPV6_PACKET* source)
+{
+    memcpy(&destination->remoteMACAddr, &source->remoteMACAddr, sizeof(TCPIP_MAC_ADDR));
+    memcpy(&destination->ipv6Header, &source->ipv6Header, sizeof(IPV6_HEADER));
+    destination->netIfH = source->netIfH;
+    return true;
+}
+
+void TCPIP_IPV6_TransmitPacketStateReset(IPV6_PACKET* pkt)
+{
+    LOOP_PACKET* pLoopPkt = (LOOP_PACKET*)pkt;
+
+    pLoopPkt->pPayload = NULL;
+    pLoopPkt->payloadLen = 0;
+    pkt->payloadLen = 0;
+}
+
+unsigned short TCPIP_IPV6_PayloadSet(IPV6_PACKET* pkt, uint8_t* payload, unsigned short len)
+{
+    LOOP_PACKET* pLoopPkt = (LOOP_PACKET*)pkt;
+
+    pLoopPkt->pPayload = payload;
+    pLoopPkt->payloadLen = len;
+    pkt->payloadLen = len;
+    return len;
+}
+
+void TCPIP_IPV6_HeaderPut(IPV6_PACKET* pkt, uint8_t protocol)
+{
+    pkt->ipv6Header.NextHeader = protocol;
+}
+
+void TCPIP_IPV6_PacketIPProtocolSet(IPV6_PACKET* pkt)
+{
+}
+
+bool TCPIP_IPV6_InterfaceIsReady(TCPIP_NET_HANDLE netH)
+{
+    return netH == &loopNet;
+}
+
+int TCPIP_IPV6_Flush(IPV6_PACKET* pkt)
+{
+    LOOP_PACKET* pLoopPkt = (LOOP_PACKET*)pkt;
+
+    loopData.nFlushed++;
+
+    if (loopData.capture && (loopData.nCaptured < LOOP_MAX_DATAGRAMS))
+    {
+        LOOP_DATAGRAM* pDgram = &loopData.datagrams[loopData.nCaptured++];
+        uint16_t dataLen = pLoopPkt->payloadLen;
+
+        if (dataLen > LOOP_MAX_PAYLOAD)
+        {
+            dataLen = LOOP_MAX_PAYLOAD;
+        }
+
+        memcpy(&pDgram->destAddress, &pkt->ipv6Header.DestAddress, sizeof(IPV6_ADDR));
+        pDgram->srcPort = ((uint16_t)pLoopPkt->upperHeader[0] << 8) | pLoopPkt->upperHeader[1];
+        pDgram->destPort = ((uint16_t)pLoopPkt->upperHeader[2] << 8) | pLoopPkt->upperHeader[3];
+        pDgram->dataLen = pLoopPkt->payloadLen;
+        memcpy(pDgram->data, pLoopPkt->pPayload, dataLen);
+    }
+
+    if (loopData.queueMode && (loopData.nQueued < LOOP_MAX_QUEUED))
+    {
+        /* Waiting for the neighbor: the packet stays with the IPv6 layer */
+        pkt->flags.queued = 1;
+        loopData.queued[loopData.nQueued++] = pLoopPkt;
+        return 1;
+    }
+
+    /* Handed to the MAC and sent */
+    loopMacPkt.pktIf = pkt->netIfH;
+    if (pkt->macAckFnc != NULL)
+    {
+        (*pkt->macAckFnc)(&loopMacPkt, pkt->ackParam);
+    }
+
+    return 1;
+}
+
+static void _loopDrain(void)
+{
+    unsigned int ix;
+
+    for (ix = 0; ix < loopData.nQueued; ix++)
+    {
+        IPV6_PACKET* pkt = &loopData.queued[ix]->v6Pkt;
+
+        pkt->flags.queued = 0;
+        loopMacPkt.pktIf = pkt->netIfH;
+        if (pkt->macAckFnc != NULL)
+        {
+            (*pkt->macAckFnc)(&loopMacPkt, pkt->ackParam);
+        }
+
+        (*pkt->ackFnc)(pkt, true, pkt->ackParam);
+    }
+
+    loopData.nQueued = 0;
+}
+
+/* Not used on the TX path */
+IPV6_ADDR_STRUCT* TCPIP_IPV6_AddressFind(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* addr, unsigned char listType)
+{
+    return NULL;
+}
+
+uint8_t TCPIP_IPV6_AddressTypeGet(TCPIP_NET_IF* pNetIf, const IPV6_ADDR* address)
+{
+    return 0;
+}
+
+bool TCPIP_IPV6_AddressesGet(const TCPIP_MAC_PACKET* pRxPkt, const IPV6_ADDR** pDestIPAddr, const IPV6_ADDR** pSourceIPAddr)
+{
+    return false;
+}
+
+void TCPIP_IPV6_ErrorSend(TCPIP_NET_IF* pNetIf, TCPIP_MAC_PACKET* pRxPkt, const IPV6_ADDR* localIP, const IPV6_ADDR* remoteIP, uint8_t code, uint8_t type, uint32_t additionalData, uint16_t packetLen)
+{
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Stack Manager, Packet and Helper Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+TCPIP_NET_HANDLE TCPIP_STACK_NetDefaultGet(void)
+{
+    return &loopNet;
+}
+
+TCPIP_NET_IF* _TCPIPStackIPv6AddToNet(IPV6_ADDR* pIPv6Address, IPV6_ADDR_TYPE addType, bool useDefault)
+{
+    return &loopNet;
+}
+
+tcpipSignalHandle _TCPIPStackSignalHandlerRegister(TCPIP_STACK_MODULE modId, tcpipModuleSignalHandler signalHandler, int16_t asyncTmoMs)
+{
+    return (tcpipSignalHandle)&loopNet;
+}
+
+void _TCPIPStackSignalHandlerDeregister(tcpipSignalHandle handle)
+{
+}
+
+TCPIP_MODULE_SIGNAL _TCPIPStackModuleSignalGet(TCPIP_STACK_MODULE modId, TCPIP_MODULE_SIGNAL clrMask)
+{
+    return TCPIP_MODULE_SIGNAL_NONE;
+}
+
+TCPIP_MAC_PACKET* _TCPIPStackModuleRxExtract(TCPIP_STACK_MODULE modId)
+{
+    return NULL;
+}
+
+void _TCPIP_PKT_PacketFree(TCPIP_MAC_PACKET* pPkt)
+{
+}
+
+void _TCPIP_PKT_PacketAcknowledge(TCPIP_MAC_PACKET* pPkt, TCPIP_MAC_PKT_ACK_RES ackRes, TCPIP_STACK_MODULE moduleId)
+{
+}
+
+void TCPIP_Helper_Memcpy(void* dst, const void* src, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+uint16_t TCPIP_Helper_CalcIPChecksum(const uint8_t* buffer, uint16_t len, uint16_t seed)
+{
+    return 0;
+}
+
+uint16_t TCPIP_Helper_PacketChecksum(TCPIP_MAC_PACKET* pPkt, uint8_t* startAdd, uint16_t len, uint16_t seed)
+{
+    return 0;
+}
+
+void TCPIP_Helper_SingleListTailAdd(SINGLE_LIST* pL, SGL_LIST_NODE* pN)
+{
+    pN->next = NULL;
+    if (pL->tail == NULL)
+    {
+        pL->head = pL->tail = pN;
+    }
+    else
+    {
+        pL->tail->next = pN;
+        pL->tail = pN;
+    }
+    pL->nNodes++;
+}
+
+SGL_LIST_NODE* TCPIP_Helper_SingleListHeadRemove(SINGLE_LIST* pL)
+{
+    SGL_LIST_NODE* pN = pL->head;
+
+    if (pN != NULL)
+    {
+        if (pL->head == pL->tail)
+        {
+            pL->head = pL->tail = NULL;
+        }
+        else
+        {
+            pL->head = pN->next;
+        }
+        pL->nNodes--;
+    }
+
+    return pN;
+}
+
+bool SYS_INT_Disable(void)
+{
+    return true;
+}
+
+void SYS_INT_Restore(bool state)
+{
+}
+
+SYS_ERROR_LEVEL SYS_DEBUG_ErrorLevelGet(void)
+{
+    return SYS_ERROR_ERROR;
+}
+
+SYS_MODULE_INDEX SYS_DEBUG_ConsoleInstanceGet(void)
+{
+    return 0;
+}
+
+void SYS_CONSOLE_Print(const SYS_CONSOLE_HANDLE handle, const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _setAddress(IP_MULTI_ADDRESS* pAddress, uint16_t shortAddress)
+{
+    /* Link-local address of a G3 device, as built by the cycles application */
+    memset(pAddress, 0, sizeof(*pAddress));
+    pAddress->v6Add.v[0] = 0xFE;
+    pAddress->v6Add.v[1] = 0x80;
+    pAddress->v6Add.v[8] = 0x78;
+    pAddress->v6Add.v[9] = 0x1D;
+    pAddress->v6Add.v[11] = 0xFF;
+    pAddress->v6Add.v[12] = 0xFE;
+    pAddress->v6Add.v[14] = (uint8_t)(shortAddress >> 8);
+    pAddress->v6Add.v[15] = (uint8_t)shortAddress;
+}
+
+static void _setItems(TCPIP_UDP_BATCH_ITEM* pItems, uint8_t (*payloads)[LOOP_MAX_PAYLOAD], unsigned int nItems)
+{
+    unsigned int ix;
+
+    for (ix = 0; ix < nItems; ix++)
+    {
+        _setAddress(&pItems[ix].destAddress, (uint16_t)(ix + 1U));
+        /* Odd items keep the socket remote port */
+        pItems[ix].destPort = ((ix & 1U) != 0U) ? 0U : (UDP_PORT)(TEST_REMOTE_PORT + ix);
+        pItems[ix].dataLen = (uint16_t)(8U + ix);
+        memset(payloads[ix], (int)(0xA0U + ix), LOOP_MAX_PAYLOAD);
+        payloads[ix][0] = (uint8_t)ix;
+        pItems[ix].pData = payloads[ix];
+    }
+}
+
+static int _checkDatagrams(const TCPIP_UDP_BATCH_ITEM* pItems, unsigned int firstDgram, unsigned int nItems,
+        UDP_PORT localPort, UDP_PORT* pRemotePort)
+{
+    unsigned int ix;
+
+    for (ix = 0; ix < nItems; ix++)
+    {
+        const LOOP_DATAGRAM* pDgram = &loopData.datagrams[firstDgram + ix];
+
+        if (pItems[ix].destPort != 0U)
+        {
+            *pRemotePort = pItems[ix].destPort;
+        }
+
+        if ((memcmp(&pDgram->destAddress, &pItems[ix].destAddress.v6Add, sizeof(IPV6_ADDR)) != 0) ||
+                (pDgram->srcPort != localPort) || (pDgram->destPort != *pRemotePort) ||
+                (pDgram->dataLen != pItems[ix].dataLen) ||
+                (memcmp(pDgram->data, pItems[ix].pData, pItems[ix].dataLen) != 0))
+        {
+            printf("FAIL: datagram %u does not match its item\n", firstDgram + ix);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static UDP_SOCKET _openClient(void)
+{
+    IP_MULTI_ADDRESS remoteAddress;
+
+    _setAddress(&remoteAddress, 0xFFFFU);
+    return TCPIP_UDP_ClientOpen(IP_ADDRESS_TYPE_IPV6, TEST_REMOTE_PORT, &remoteAddress);
+}
+
+static int _testBatch(void)
+{
+    static uint8_t payloads[TEST_BATCH_ITEMS][LOOP_MAX_PAYLOAD];
+    TCPIP_UDP_BATCH_ITEM items[TEST_BATCH_ITEMS];
+    UDP_SOCKET_INFO sktInfo;
+    UDP_PORT remotePort = TEST_REMOTE_PORT;
+    UDP_SOCKET skt;
+    uint16_t nSent;
+
+    _setItems(items, payloads, TEST_BATCH_ITEMS);
+    skt = _openClient();
+    if (skt == INVALID_UDP_SOCKET)
+    {
+        printf("FAIL: socket open\n");
+        return 1;
+    }
+
+    TCPIP_UDP_SocketInfoGet(skt, &sktInfo);
+    loopData.nCaptured = 0;
+    nSent = TCPIP_UDP_BatchSend(skt, items, TEST_BATCH_ITEMS);
+    if ((nSent != TEST_BATCH_ITEMS) || (loopData.nCaptured != TEST_BATCH_ITEMS))
+    {
+        printf("FAIL: batch sent %u of %u items\n", nSent, TEST_BATCH_ITEMS);
+        return 1;
+    }
+
+    if (_checkDatagrams(items, 0, TEST_BATCH_ITEMS, sktInfo.localPort, &remotePort) != 0)
+    {
+        return 1;
+    }
+
+    /* The socket keeps the destination of the last item */
+    TCPIP_UDP_SocketInfoGet(skt, &sktInfo);
+    if ((sktInfo.remotePort != remotePort) ||
+            (memcmp(&sktInfo.remoteIPaddress.v6Add, &items[TEST_BATCH_ITEMS - 1U].destAddress.v6Add, sizeof(IPV6_ADDR)) != 0))
+    {
+        printf("FAIL: socket destination after the batch\n");
+        return 1;
+    }
+
+    /* An item that does not fit in the TX buffer ends the batch */
+    items[3].dataLen = TCPIP_UDP_SOCKET_DEFAULT_TX_SIZE + 1U;
+    items[3].pData = malloc(items[3].dataLen);
+    memset((void*)items[3].pData, 0x55, items[3].dataLen);
+    loopData.nCaptured = 0;
+    nSent = TCPIP_UDP_BatchSend(skt, items, TEST_BATCH_ITEMS);
+    free((void*)items[3].pData);
+    if ((nSent != 3U) || (loopData.nCaptured != 3U) || (TCPIP_UDP_TxCountGet(skt) != 0U))
+    {
+        printf("FAIL: oversized item: %u items sent\n", nSent);
+        return 1;
+    }
+
+    /* Data written to the socket and not flushed is never mixed with a batch */
+    TCPIP_UDP_Put(skt, 0x01);
+    loopData.nCaptured = 0;
+    if ((TCPIP_UDP_BatchSend(skt, items, TEST_BATCH_ITEMS) != 0U) || (loopData.nCaptured != 0U))
+    {
+        printf("FAIL: batch sent with pending socket data\n");
+        return 1;
+    }
+    TCPIP_UDP_Flush(skt);
+
+    if ((TCPIP_UDP_BatchSend(INVALID_UDP_SOCKET, items, TEST_BATCH_ITEMS) != 0U) ||
+            (TCPIP_UDP_BatchSend(skt, NULL, TEST_BATCH_ITEMS) != 0U))
+    {
+        printf("FAIL: invalid arguments\n");
+        return 1;
+    }
+
+    TCPIP_UDP_Close(skt);
+    printf("batch: %u datagrams in order, oversized item and pending data stop the batch\n", TEST_BATCH_ITEMS);
+    return 0;
+}
+
+static int _testQueueLimit(void)
+{
+    static uint8_t payloads[TEST_BATCH_ITEMS][LOOP_MAX_PAYLOAD];
+    TCPIP_UDP_BATCH_ITEM items[TEST_BATCH_ITEMS];
+    UDP_SOCKET_INFO sktInfo;
+    UDP_PORT remotePort = TEST_REMOTE_PORT;
+    UDP_SOCKET skt;
+    unsigned int nDone, nCalls;
+    uint16_t nSent;
+
+    _setItems(items, payloads, TEST_BATCH_ITEMS);
+    skt = _openClient();
+    TCPIP_UDP_SocketInfoGet(skt, &sktInfo);
+
+    /* Packets stay queued until drained: each call sends up to the socket
+     * TX queue limit and the next one resumes from the returned count */
+    loopData.queueMode = true;
+    loopData.nCaptured = 0;
+    for (nDone = 0, nCalls = 0; (nDone < TEST_BATCH_ITEMS) && (nCalls < TEST_BATCH_ITEMS); nCalls++)
+    {
+        nSent = TCPIP_UDP_BatchSend(skt, items + nDone, (uint16_t)(TEST_BATCH_ITEMS - nDone));
+        if ((nSent == 0U) || ((nDone + nSent < TEST_BATCH_ITEMS) && (nSent != TCPIP_UDP_SOCKET_DEFAULT_TX_QUEUE_LIMIT)))
+        {
+            printf("FAIL: queue limit: call %u sent %u items\n", nCalls, nSent);
+            return 1;
+        }
+
+        nDone += nSent;
+        _loopDrain();
+    }
+    loopData.queueMode = false;
+
+    if ((nDone != TEST_BATCH_ITEMS) || (loopData.nCaptured != TEST_BATCH_ITEMS) ||
+            (_checkDatagrams(items, 0, TEST_BATCH_ITEMS, sktInfo.localPort, &remotePort) != 0))
+    {
+        printf("FAIL: queue limit: %u items sent\n", nDone);
+        return 1;
+    }
+
+    TCPIP_UDP_Close(skt);
+    printf("queue limit: %u items in %u calls of up to %u\n", TEST_BATCH_ITEMS, nCalls,
+            (unsigned int)TCPIP_UDP_SOCKET_DEFAULT_TX_QUEUE_LIMIT);
+    return 0;
+}
+
+static int _testSockets(void)
+{
+    UDP_SOCKET skts[TCPIP_UDP_MAX_SOCKETS];
+    UDP_PORT ports[TCPIP_UDP_MAX_SOCKETS];
+    UDP_SOCKET_INFO sktInfo;
+    int ix, jx;
+
+    /* Fill the socket table, half servers and half clients */
+    for (ix = 0; ix < TCPIP_UDP_MAX_SOCKETS; ix++)
+    {
+        if ((ix & 1) == 0)
+        {
+            skts[ix] = TCPIP_UDP_ServerOpen(IP_ADDRESS_TYPE_IPV6, (UDP_PORT)(0xF0B0 + ix), NULL);
+        }
+        else
+        {
+            skts[ix] = _openClient();
+        }
+
+        if (skts[ix] == INVALID_UDP_SOCKET)
+        {
+            printf("FAIL: sockets: open %d of %d\n", ix, TCPIP_UDP_MAX_SOCKETS);
+            return 1;
+        }
+
+        TCPIP_UDP_SocketInfoGet(skts[ix], &sktInfo);
+        ports[ix] = sktInfo.localPort;
+    }
+
+    if (_openClient() != INVALID_UDP_SOCKET)
+    {
+        printf("FAIL: sockets: open beyond TCPIP_UDP_MAX_SOCKETS\n");
+        return 1;
+    }
+
+    for (ix = 0; ix < TCPIP_UDP_MAX_SOCKETS; ix++)
+    {
+        for (jx = ix + 1; jx < TCPIP_UDP_MAX_SOCKETS; jx++)
+        {
+            if (ports[ix] == ports[jx])
+            {
+                printf("FAIL: sockets: port %u used twice\n", ports[ix]);
+                return 1;
+            }
+        }
+    }
+
+    /* A port in use cannot be bound again; a released one can */
+    if (TCPIP_UDP_Bind(skts[1], IP_ADDRESS_TYPE_IPV6, ports[0], NULL) == true)
+    {
+        printf("FAIL: sockets: bound to a port in use\n");
+        return 1;
+    }
+
+    TCPIP_UDP_Close(skts[0]);
+    if (TCPIP_UDP_Bind(skts[1], IP_ADDRESS_TYPE_IPV6, ports[0], NULL) == false)
+    {
+        printf("FAIL: sockets: bind to a released port\n");
+        return 1;
+    }
+
+    for (ix = 1; ix < TCPIP_UDP_MAX_SOCKETS; ix++)
+    {
+        TCPIP_UDP_Close(skts[ix]);
+    }
+
+    printf("sockets: %d open with distinct ports, %d port index buckets\n", TCPIP_UDP_MAX_SOCKETS,
+            TCPIP_UDP_PORT_HASH_BUCKETS);
+    return 0;
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static int _benchmark(unsigned long nPackets)
+{
+    static uint8_t payloads[TEST_BATCH_ITEMS][LOOP_MAX_PAYLOAD];
+    TCPIP_UDP_BATCH_ITEM items[TEST_BATCH_ITEMS];
+    UDP_SOCKET skt;
+    unsigned long nSent, nSingle, nBatch;
+    unsigned int ix;
+    double start, tSingle, tBatch;
+
+    _setItems(items, payloads, TEST_BATCH_ITEMS);
+    skt = _openClient();
+    loopData.capture = false;
+
+    loopData.nFlushed = 0;
+    start = _seconds();
+    for (nSent = 0; nSent < nPackets; nSent += TEST_BATCH_ITEMS)
+    {
+        for (ix = 0; ix < TEST_BATCH_ITEMS; ix++)
+        {
+            TCPIP_UDP_DestinationIPAddressSet(skt, IP_ADDRESS_TYPE_IPV6, &items[ix].destAddress);
+            if (items[ix].destPort != 0U)
+            {
+                TCPIP_UDP_DestinationPortSet(skt, items[ix].destPort);
+            }
+            TCPIP_UDP_ArrayPut(skt, items[ix].pData, items[ix].dataLen);
+            TCPIP_UDP_Flush(skt);
+        }
+    }
+    tSingle = _seconds() - start;
+    nSingle = loopData.nFlushed;
+
+    loopData.nFlushed = 0;
+    start = _seconds();
+    for (nSent = 0; nSent < nPackets; nSent += TEST_BATCH_ITEMS)
+    {
+        TCPIP_UDP_BatchSend(skt, items, TEST_BATCH_ITEMS);
+    }
+    tBatch = _seconds() - start;
+    nBatch = loopData.nFlushed;
+
+    loopData.capture = true;
+    TCPIP_UDP_Close(skt);
+
+    if ((nSingle != nSent) || (nBatch != nSent))
+    {
+        printf("FAIL: benchmark: %lu and %lu of %lu packets sent\n", nSingle, nBatch, nSent);
+        return 1;
+    }
+
+    printf("benchmark: %lu packets, batches of %u\n", nSent, TEST_BATCH_ITEMS);
+    printf("  address/port set, put, flush: %10.0f packets/s\n", (double)nSent / tSingle);
+    printf("  TCPIP_UDP_BatchSend:          %10.0f packets/s\n", (double)nSent / tBatch);
+    return 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char** argv)
+{
+    TCPIP_STACK_MODULE_CTRL stackCtrl;
+    TCPIP_UDP_MODULE_CONFIG udpConfig;
+    unsigned long nPackets = 100000UL;
+    unsigned int nInitBlocks;
+    int nErrors = 0;
+
+    if (argc > 1)
+    {
+        nPackets = strtoul(argv[1], NULL, 0);
+    }
+
+    memset(&stackCtrl, 0, sizeof(stackCtrl));
+    stackCtrl.memH = &loopHeap;
+    stackCtrl.nIfs = 1;
+    stackCtrl.pNetIf = &loopNet;
+    stackCtrl.stackAction = TCPIP_STACK_ACTION_INIT;
+
+    memset(&udpConfig, 0, sizeof(udpConfig));
+    udpConfig.nSockets = TCPIP_UDP_MAX_SOCKETS;
+    udpConfig.sktTxBuffSize = TCPIP_UDP_SOCKET_DEFAULT_TX_SIZE;
+
+    loopData.capture = true;
+    if (TCPIP_UDP_Initialize(&stackCtrl, &udpConfig) == false)
+    {
+        printf("FAIL: UDP initialization\n");
+        return 1;
+    }
+    nInitBlocks = loopData.nHeapBlocks;
+
+    nErrors += _testBatch();
+    nErrors += _testQueueLimit();
+    nErrors += _testSockets();
+    nErrors += _benchmark(nPackets);
+
+    if ((loopData.nHeapBlocks != nInitBlocks) || (loopData.nPackets != 0U))
+    {
+        printf("FAIL: %u heap blocks and %u packets not released\n",
+                loopData.nHeapBlocks - nInitBlocks, loopData.nPackets);
+        nErrors++;
+    }
+
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,898 @@
+/*******************************************************************************
+  UDP metrology subscription replay
+
+  File Name:
+    udp_metrology_replay.c
+
+  Summary:
+    Replays metrology snapshots through app_udp_metrology.c and compares the
+    bytes sent with subscription updates against polling.
+
+  Description:
+    app_udp_metrology.c of the G3 metering demo is built for the host with a
+    UDP layer that delivers every flushed datagram to a head-end model. A
+    trace of metrology snapshots, one per second, is replayed three times:
+
+      - poll:      the head-end sends a data request (0x01) every period and
+                   the meter answers with the full response (0x02)
+      - compact:   the head-end sends a compact data request (0x07) every
+                   period and the meter answers with the varint response (0x08)
+      - subscribe: the head-end subscribes once (0x03) with a period and
+                   deadbands, and the meter pushes data updates (0x06)
+
+    The head-end decodes every data update. After each period the decoded
+    value of every subscribed quantity must be within its deadband of the
+    snapshot value, and equal to it after a full update. Update sequence
+    numbers must be consecutive. The test also checks that an unsubscribe
+    request stops the updates.
+
+    The trace is either generated (one hour of a three phase load with
+    appliance switching, voltage and frequency drift) or read from a text
+    file with one snapshot per line: the 26 RMS values of the data response
+    in decimal, in the order of DRV_METROLOGY_RMS_TYPE.
+
+    Usage:
+      udp_metrology_replay [-s seconds] [-p period] [-d deadband scale] [trace file]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "definitions.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_SOCKETS_NUM        4U
+#define TEST_RX_SIZE            256U
+#define TEST_TX_SIZE            1280U
+#define TEST_DEFAULT_SECONDS    3600U
+#define TEST_MAX_FAILS_SHOWN    10U
+#define TEST_HEADEND_PORT       0xF0BFU
+
+typedef enum
+{
+    MODE_POLL = 0,
+    MODE_COMPACT,
+    MODE_SUBSCRIBE,
+    MODE_NUM
+} TEST_MODE;
+
+typedef struct
+{
+    bool open;
+    uint16_t localPort;
+    uint16_t remotePort;
+    TCPIP_UDP_SIGNAL_FUNCTION handler;
+    uint8_t rx[TEST_RX_SIZE];
+    uint16_t rxLen;
+    uint16_t rxPos;
+    uint8_t tx[TEST_TX_SIZE];
+    uint16_t txLen;
+} TEST_SOCKET;
+
+/* Traffic of one replay, UDP payload bytes */
+typedef struct
+{
+    unsigned long downBytes;
+    unsigned long downDatagrams;
+    unsigned long upBytes;
+    unsigned long upDatagrams;
+} TEST_TRAFFIC;
+
+/* Head-end view of the subscription */
+typedef struct
+{
+    int32_t value[APP_UDP_METROLOGY_QUANTITIES_NUM];
+    uint32_t deadband[APP_UDP_METROLOGY_QUANTITIES_NUM];
+    uint32_t mask;
+    uint32_t updates;
+    uint32_t fullUpdates;
+    uint8_t sequence;
+    bool synced;
+    bool fullReceived;
+    bool subscribed;
+} TEST_HEADEND;
+
+typedef struct
+{
+    int32_t (*rms)[RMS_TYPE_NUM];
+    size_t num;
+} TEST_TRACE;
+
+SYSTEM_OBJECTS sysObj;
+
+/* Application data of app_udp_metrology.c */
+extern APP_UDP_METROLOGY_DATA app_udp_metrologyData;
+
+static TEST_SOCKET testSockets[TEST_SOCKETS_NUM];
+static uint64_t testTimeMs;
+static int32_t *testSnapshot;
+static uint32_t testSequence;
+static TEST_TRAFFIC testTraffic;
+static TEST_HEADEND testHeadEnd;
+static unsigned long testErrors;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+static const char *modeNames[MODE_NUM] = {"poll (0x01/0x02)", "compact poll (0x07/0x08)", "subscribe (0x06)"};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Metrology, System and UDP Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+bool APP_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot)
+{
+    (void) memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->sequence = testSequence;
+    (void) memcpy(snapshot->RMS, testSnapshot, sizeof(snapshot->RMS));
+    return true;
+}
+
+bool APP_METROLOGY_GetRMS(DRV_METROLOGY_RMS_TYPE rmsId, uint32_t * rmsValue, DRV_METROLOGY_RMS_SIGN * sign)
+{
+    int32_t value = testSnapshot[rmsId];
+
+    *sign = (value < 0) ? RMS_SIGN_NEGATIVE : RMS_SIGN_POSITIVE;
+    *rmsValue = (value < 0) ? (uint32_t)(-value) : (uint32_t)value;
+    return true;
+}
+
+bool APP_METROLOGY_StartWaveformCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source, bool eventTrigger)
+{
+    (void) channels; (void) source; (void) eventTrigger;
+    return false;
+}
+
+void APP_METROLOGY_StopWaveformCapture(void) {}
+bool APP_METROLOGY_TriggerWaveformCapture(void) { return false; }
+void APP_METROLOGY_GetWaveformInfo(APP_METROLOGY_WAVEFORM_INFO * info) { (void) memset(info, 0, sizeof(*info)); }
+
+uint16_t APP_METROLOGY_GetWaveformChunk(uint32_t captureId, uint16_t chunkIndex, uint8_t * pData, uint16_t maxSize)
+{
+    (void) captureId; (void) chunkIndex; (void) pData; (void) maxSize;
+    return 0U;
+}
+
+uint64_t SYS_TIME_Counter64Get(void) { return testTimeMs; }
+uint32_t SYS_TIME_MSToCount(uint32_t ms) { return ms; }
+SYS_STATUS TCPIP_STACK_Status(SYS_MODULE_OBJ object) { (void) object; return SYS_STATUS_READY; }
+
+static UDP_SOCKET _socketOpen(uint16_t localPort, uint16_t remotePort)
+{
+    UDP_SOCKET s;
+
+    for (s = 0; s < (UDP_SOCKET)TEST_SOCKETS_NUM; s++)
+    {
+        if (testSockets[s].open == false)
+        {
+            (void) memset(&testSockets[s], 0, sizeof(testSockets[s]));
+            testSockets[s].open = true;
+            testSockets[s].localPort = localPort;
+            testSockets[s].remotePort = remotePort;
+            return s;
+        }
+    }
+
+    return INVALID_SOCKET;
+}
+
+static TEST_SOCKET *_socketGet(UDP_SOCKET s)
+{
+    if ((s < 0) || (s >= (UDP_SOCKET)TEST_SOCKETS_NUM) || (testSockets[s].open == false))
+    {
+        printf("FAIL: access to socket %d, not open\n", (int)s);
+        testErrors++;
+        return NULL;
+    }
+
+    return &testSockets[s];
+}
+
+UDP_SOCKET TCPIP_UDP_ServerOpen(IP_ADDRESS_TYPE addType, UDP_PORT localPort, IP_MULTI_ADDRESS* localAddress)
+{
+    (void) addType; (void) localAddress;
+    return _socketOpen(localPort, 0U);
+}
+
+UDP_SOCKET TCPIP_UDP_ClientOpen(IP_ADDRESS_TYPE addType, UDP_PORT remotePort, IP_MULTI_ADDRESS* remoteAddress)
+{
+    (void) addType; (void) remoteAddress;
+    return _socketOpen(0U, remotePort);
+}
+
+bool TCPIP_UDP_Bind(UDP_SOCKET s, IP_ADDRESS_TYPE addType, UDP_PORT localPort, IP_MULTI_ADDRESS* localAddress)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    (void) addType; (void) localAddress;
+    if (pSocket == NULL)
+    {
+        return false;
+    }
+
+    pSocket->localPort = localPort;
+    return true;
+}
+
+bool TCPIP_UDP_Close(UDP_SOCKET s)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    if (pSocket == NULL)
+    {
+        return false;
+    }
+
+    pSocket->open = false;
+    return true;
+}
+
+bool TCPIP_UDP_OptionsSet(UDP_SOCKET s, UDP_SOCKET_OPTION option, void* optParam)
+{
+    (void) option; (void) optParam;
+    return (_socketGet(s) != NULL);
+}
+
+TCPIP_UDP_SIGNAL_HANDLE TCPIP_UDP_SignalHandlerRegister(UDP_SOCKET s, TCPIP_UDP_SIGNAL_TYPE sigMask,
+    TCPIP_UDP_SIGNAL_FUNCTION handler, const void* hParam)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    (void) sigMask; (void) hParam;
+    if (pSocket == NULL)
+    {
+        return NULL;
+    }
+
+    pSocket->handler = handler;
+    return (TCPIP_UDP_SIGNAL_HANDLE) pSocket;
+}
+
+bool TCPIP_UDP_SocketInfoGet(UDP_SOCKET s, UDP_SOCKET_INFO* pInfo)
+{
+    (void) memset(pInfo, 0, sizeof(*pInfo));
+    pInfo->remoteIPaddress.v6Add.v[0] = 0xFDU;
+    pInfo->remoteIPaddress.v6Add.v[15] = 0x01U;
+    pInfo->remotePort = TEST_HEADEND_PORT;
+    return (_socketGet(s) != NULL);
+}
+
+uint16_t TCPIP_UDP_GetIsReady(UDP_SOCKET s)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    return (pSocket == NULL) ? 0U : (uint16_t)(pSocket->rxLen - pSocket->rxPos);
+}
+
+uint16_t TCPIP_UDP_ArrayGet(UDP_SOCKET s, uint8_t *cData, uint16_t wDataLen)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+    uint16_t len;
+
+    if (pSocket == NULL)
+    {
+        return 0U;
+    }
+
+    len = (uint16_t)(pSocket->rxLen - pSocket->rxPos);
+    len = (wDataLen < len) ? wDataLen : len;
+    if (cData != NULL)
+    {
+        (void) memcpy(cData, &pSocket->rx[pSocket->rxPos], len);
+    }
+    pSocket->rxPos += len;
+    return len;
+}
+
+uint16_t TCPIP_UDP_Get(UDP_SOCKET s, uint8_t *cData)
+{
+    return TCPIP_UDP_ArrayGet(s, cData, 1U);
+}
+
+uint16_t TCPIP_UDP_Discard(UDP_SOCKET s)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+    uint16_t len;
+
+    if (pSocket == NULL)
+    {
+        return 0U;
+    }
+
+    len = (uint16_t)(pSocket->rxLen - pSocket->rxPos);
+    pSocket->rxLen = 0U;
+    pSocket->rxPos = 0U;
+    return len;
+}
+
+uint16_t TCPIP_UDP_PutIsReady(UDP_SOCKET s)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    return (pSocket == NULL) ? 0U : (uint16_t)(TEST_TX_SIZE - pSocket->txLen);
+}
+
+uint16_t TCPIP_UDP_ArrayPut(UDP_SOCKET s, const uint8_t *cData, uint16_t wDataLen)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+
+    if ((pSocket == NULL) || ((pSocket->txLen + wDataLen) > TEST_TX_SIZE))
+    {
+        return 0U;
+    }
+
+    (void) memcpy(&pSocket->tx[pSocket->txLen], cData, wDataLen);
+    pSocket->txLen += wDataLen;
+    return wDataLen;
+}
+
+uint16_t TCPIP_UDP_Put(UDP_SOCKET s, uint8_t c)
+{
+    return TCPIP_UDP_ArrayPut(s, &c, 1U);
+}
+
+static void _headEndReceive(TEST_SOCKET *pSocket, const uint8_t *pData, uint16_t len);
+
+uint16_t TCPIP_UDP_Flush(UDP_SOCKET s)
+{
+    TEST_SOCKET *pSocket = _socketGet(s);
+    uint16_t len;
+
+    if ((pSocket == NULL) || (pSocket->txLen == 0U))
+    {
+        return 0U;
+    }
+
+    len = pSocket->txLen;
+    pSocket->txLen = 0U;
+    testTraffic.upBytes += len;
+    testTraffic.upDatagrams++;
+    _headEndReceive(pSocket, pSocket->tx, len);
+    return len;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Head-end Model
+// *****************************************************************************
+// *****************************************************************************
+
+static uint8_t _getVarint(const uint8_t *pData, uint16_t len, int32_t *pDelta)
+{
+    uint32_t value = 0U;
+    uint8_t idx = 0U;
+
+    do
+    {
+        if ((idx >= len) || (idx >= 5U))
+        {
+            return 0U;
+        }
+        value |= (uint32_t)(pData[idx] & 0x7FU) << (7U * idx);
+    } while ((pData[idx++] & 0x80U) != 0U);
+
+    /* Zigzag decoding */
+    *pDelta = (int32_t)((value >> 1) ^ (0U - (value & 1U)));
+    return idx;
+}
+
+static void _headEndUpdate(const uint8_t *pData, uint16_t len)
+{
+    uint32_t changedMask;
+    uint16_t pos = 7U;
+    int32_t delta;
+    uint8_t idx, n;
+    bool full;
+
+    if ((len < 7U) || (testHeadEnd.subscribed == false))
+    {
+        printf("FAIL: unexpected data update\n");
+        testErrors++;
+        return;
+    }
+
+    full = ((pData[2] & APP_UDP_METROLOGY_UPDATE_FLAG_FULL) != 0U);
+    (void) memcpy(&changedMask, &pData[3], sizeof(changedMask));
+
+    if ((testHeadEnd.synced == true) && (pData[1] != (uint8_t)(testHeadEnd.sequence + 1U)))
+    {
+        printf("FAIL: update sequence %u after %u\n", pData[1], testHeadEnd.sequence);
+        testErrors++;
+    }
+    testHeadEnd.sequence = pData[1];
+    testHeadEnd.synced = true;
+
+    if ((changedMask & ~testHeadEnd.mask) != 0U)
+    {
+        printf("FAIL: update mask 0x%08x outside subscription 0x%08x\n", changedMask, testHeadEnd.mask);
+        testErrors++;
+    }
+
+    for (idx = 0U; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        if ((changedMask & (1UL << idx)) == 0U)
+        {
+            continue;
+        }
+
+        n = _getVarint(&pData[pos], (uint16_t)(len - pos), &delta);
+        if (n == 0U)
+        {
+            printf("FAIL: truncated data update\n");
+            testErrors++;
+            return;
+        }
+        pos += n;
+
+        if (full)
+        {
+            testHeadEnd.value[idx] = delta;
+        }
+        else
+        {
+            testHeadEnd.value[idx] = (int32_t)((uint32_t)testHeadEnd.value[idx] + (uint32_t)delta);
+        }
+    }
+
+    if (pos != len)
+    {
+        printf("FAIL: %u trailing bytes in data update\n", len - pos);
+        testErrors++;
+    }
+
+    testHeadEnd.updates++;
+    if (full)
+    {
+        testHeadEnd.fullUpdates++;
+        testHeadEnd.fullReceived = true;
+    }
+}
+
+static void _headEndReceive(TEST_SOCKET *pSocket, const uint8_t *pData, uint16_t len)
+{
+    switch (pData[0])
+    {
+        case APP_UDP_METROLOGY_MSG_DATA_RESPONSE:
+            if (len != (1U + sizeof(APP_UDP_METROLOGY_RESPONSE_DATA)) ||
+                    (memcmp(&pData[1], testSnapshot, sizeof(APP_UDP_METROLOGY_RESPONSE_DATA)) != 0))
+            {
+                printf("FAIL: data response does not match the snapshot\n");
+                testErrors++;
+            }
+            break;
+
+        case APP_UDP_METROLOGY_MSG_COMPACT_DATA_RESPONSE:
+            break;
+
+        case APP_UDP_METROLOGY_MSG_SUBSCRIBE_RESPONSE:
+            if ((len != 2U) || (pData[1] != 0U))
+            {
+                printf("FAIL: subscription rejected\n");
+                testErrors++;
+            }
+            break;
+
+        case APP_UDP_METROLOGY_MSG_DATA_UPDATE:
+            if ((pSocket->localPort != APP_UDP_METROLOGY_UPDATE_PORT) || (pSocket->remotePort != TEST_HEADEND_PORT))
+            {
+                printf("FAIL: data update sent from port 0x%04x to 0x%04x\n", pSocket->localPort, pSocket->remotePort);
+                testErrors++;
+            }
+            _headEndUpdate(pData, len);
+            break;
+
+        default:
+            printf("FAIL: unexpected message 0x%02x\n", pData[0]);
+            testErrors++;
+            break;
+    }
+}
+
+/* Request from the head-end to the metrology server socket */
+static void _headEndSend(const uint8_t *pData, uint16_t len)
+{
+    TEST_SOCKET *pSocket = &testSockets[app_udp_metrologyData.socket];
+
+    (void) memcpy(pSocket->rx, pData, len);
+    pSocket->rxLen = len;
+    pSocket->rxPos = 0U;
+    testTraffic.downBytes += len;
+    testTraffic.downDatagrams++;
+    pSocket->handler(app_udp_metrologyData.socket, NULL, TCPIP_UDP_SIGNAL_RX_DATA, NULL);
+}
+
+static void _headEndSubscribe(uint32_t mask, uint16_t periodS, const uint32_t *deadband)
+{
+    uint8_t buffer[1U + 4U + 2U + (4U * APP_UDP_METROLOGY_QUANTITIES_NUM)];
+    uint16_t len = 7U;
+    uint8_t idx;
+
+    buffer[0] = APP_UDP_METROLOGY_MSG_SUBSCRIBE_REQUEST;
+    (void) memcpy(&buffer[1], &mask, sizeof(mask));
+    (void) memcpy(&buffer[5], &periodS, sizeof(periodS));
+    for (idx = 0U; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        testHeadEnd.deadband[idx] = 0U;
+        if ((mask & (1UL << idx)) != 0U)
+        {
+            testHeadEnd.deadband[idx] = deadband[idx];
+            (void) memcpy(&buffer[len], &deadband[idx], sizeof(uint32_t));
+            len += sizeof(uint32_t);
+        }
+    }
+
+    testHeadEnd.mask = mask;
+    testHeadEnd.synced = false;
+    testHeadEnd.fullReceived = false;
+    testHeadEnd.subscribed = true;
+    _headEndSend(buffer, len);
+}
+
+static void _headEndCheck(size_t period)
+{
+    uint32_t diff;
+    uint8_t idx;
+
+    if (testHeadEnd.fullReceived == false)
+    {
+        printf("FAIL: period %zu: no full update received\n", period);
+        testErrors++;
+        return;
+    }
+
+    for (idx = 0U; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        if ((testHeadEnd.mask & (1UL << idx)) == 0U)
+        {
+            continue;
+        }
+
+        diff = (uint32_t)testSnapshot[idx] - (uint32_t)testHeadEnd.value[idx];
+        diff = ((int32_t)diff < 0) ? (0U - diff) : diff;
+        if (diff > testHeadEnd.deadband[idx])
+        {
+            if (testErrors < TEST_MAX_FAILS_SHOWN)
+            {
+                printf("FAIL: period %zu quantity %u: head-end %d, meter %d, deadband %u\n", period, idx,
+                        testHeadEnd.value[idx], testSnapshot[idx], testHeadEnd.deadband[idx]);
+            }
+            testErrors++;
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Trace
+// *****************************************************************************
+// *****************************************************************************
+
+static double _uniform(double min, double max)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return min + ((max - min) * ((double)((testRandState * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0));
+}
+
+static int32_t _round(double value)
+{
+    return (int32_t)lround(value);
+}
+
+/* Three phase household load: appliances switch on and off every few
+ * minutes, voltage and frequency drift slowly, readings have some noise */
+static void _traceGenerate(TEST_TRACE *trace, size_t seconds)
+{
+    double u[3], i[3], phi[3], freq = 50.0;
+    double p, q, pt = 0, qt = 0, st = 0;
+    int32_t *rms;
+    size_t t;
+    uint8_t ph;
+
+    trace->num = seconds;
+    trace->rms = calloc(seconds, sizeof(*trace->rms));
+    for (ph = 0U; ph < 3U; ph++)
+    {
+        u[ph] = 230.0;
+        i[ph] = _uniform(0.5, 5.0);
+        phi[ph] = _uniform(5.0, 30.0);
+    }
+
+    for (t = 0U; t < seconds; t++)
+    {
+        rms = trace->rms[t];
+        pt = 0.0;
+        qt = 0.0;
+        st = 0.0;
+        freq += _uniform(-0.005, 0.005);
+        freq = (freq < 49.9) ? 49.9 : ((freq > 50.1) ? 50.1 : freq);
+
+        for (ph = 0U; ph < 3U; ph++)
+        {
+            /* About one switching event per phase every two minutes */
+            if (_uniform(0.0, 120.0) < 1.0)
+            {
+                i[ph] += _uniform(-8.0, 8.0);
+                i[ph] = (i[ph] < 0.2) ? 0.2 : ((i[ph] > 60.0) ? 60.0 : i[ph]);
+                phi[ph] = _uniform(-10.0, 40.0);
+            }
+
+            u[ph] += _uniform(-0.05, 0.05);
+            u[ph] = (u[ph] < 220.0) ? 220.0 : ((u[ph] > 240.0) ? 240.0 : u[ph]);
+
+            {
+                double uNow = u[ph] + _uniform(-0.05, 0.05);
+                double iNow = i[ph] * (1.0 + _uniform(-0.002, 0.002));
+                double phiNow = phi[ph] + _uniform(-0.05, 0.05);
+
+                p = uNow * iNow * cos((phiNow * M_PI) / 180.0);
+                q = uNow * iNow * sin((phiNow * M_PI) / 180.0);
+                rms[RMS_UA + ph] = _round(uNow * 10000.0);
+                rms[RMS_IA + ph] = _round(iNow * 10000.0);
+                rms[RMS_PA + ph] = _round(p * 10.0);
+                rms[RMS_QA + ph] = _round(q * 10.0);
+                rms[RMS_SA + ph] = _round(uNow * iNow * 10.0);
+                rms[RMS_ANGLEA + ph] = _round(phiNow * 100000.0);
+                pt += p;
+                qt += q;
+                st += uNow * iNow;
+            }
+        }
+
+        rms[RMS_INI] = _round(fabs(i[0] - i[1]) * 10000.0);
+        rms[RMS_INM] = _round(fabs(i[0] - i[1]) * 10000.0 * (1.0 + _uniform(-0.01, 0.01)));
+        rms[RMS_INMI] = _round(fabs(i[1] - i[2]) * 10000.0);
+        rms[RMS_PT] = _round(pt * 10.0);
+        rms[RMS_QT] = _round(qt * 10.0);
+        rms[RMS_ST] = _round(st * 10.0);
+        rms[RMS_FREQ] = _round(freq * 100.0);
+        rms[RMS_ANGLEN] = _round(_uniform(-180.0, 180.0) * 100000.0);
+    }
+}
+
+static int _traceRead(TEST_TRACE *trace, const char *fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    size_t size = 0U;
+    char line[1024];
+    char *pos, *end;
+    uint8_t idx;
+
+    if (file == NULL)
+    {
+        printf("FAIL: can not open %s\n", fileName);
+        return 1;
+    }
+
+    trace->num = 0U;
+    trace->rms = NULL;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (trace->num == size)
+        {
+            size = (size == 0U) ? 1024U : (size * 2U);
+            trace->rms = realloc(trace->rms, size * sizeof(*trace->rms));
+        }
+
+        pos = line;
+        for (idx = 0U; idx < RMS_TYPE_NUM; idx++)
+        {
+            trace->rms[trace->num][idx] = (int32_t)strtol(pos, &end, 10);
+            if (end == pos)
+            {
+                break;
+            }
+            pos = end;
+        }
+
+        if (idx == RMS_TYPE_NUM)
+        {
+            trace->num++;
+        }
+    }
+
+    (void) fclose(file);
+    printf("%s: %zu snapshots\n", fileName, trace->num);
+    return (trace->num == 0U) ? 1 : 0;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void _appStart(void)
+{
+    (void) memset(testSockets, 0, sizeof(testSockets));
+    (void) memset(&testTraffic, 0, sizeof(testTraffic));
+    (void) memset(&testHeadEnd, 0, sizeof(testHeadEnd));
+    (void) memset(&app_udp_metrologyData, 0, sizeof(app_udp_metrologyData));
+    testTimeMs = 0U;
+
+    APP_UDP_METROLOGY_Initialize();
+    APP_UDP_METROLOGY_Tasks();
+    if (app_udp_metrologyData.state != APP_UDP_METROLOGY_STATE_SERVING_CONNECTION)
+    {
+        printf("FAIL: metrology server not open\n");
+        testErrors++;
+    }
+}
+
+/* Typical deadbands: 0.5 V, 0.1 A, 10 W/VAr/VA, 0.05 Hz, 1 degree */
+static void _deadbands(uint32_t *deadband, double scale)
+{
+    uint8_t idx;
+
+    for (idx = 0U; idx < APP_UDP_METROLOGY_QUANTITIES_NUM; idx++)
+    {
+        if (idx <= RMS_UC)
+        {
+            deadband[idx] = 5000U;
+        }
+        else if (idx <= RMS_INMI)
+        {
+            deadband[idx] = 1000U;
+        }
+        else if (idx <= RMS_SC)
+        {
+            deadband[idx] = 100U;
+        }
+        else if (idx == RMS_FREQ)
+        {
+            deadband[idx] = 5U;
+        }
+        else
+        {
+            deadband[idx] = 100000U;
+        }
+
+        deadband[idx] = (uint32_t)((double)deadband[idx] * scale);
+    }
+}
+
+static void _replay(TEST_MODE mode, TEST_TRACE *trace, uint16_t periodS, double deadbandScale, TEST_TRAFFIC *pResult)
+{
+    uint32_t deadband[APP_UDP_METROLOGY_QUANTITIES_NUM];
+    uint8_t request[5];
+    uint32_t mask = APP_UDP_METROLOGY_QUANTITIES_MASK;
+    size_t t;
+
+    _appStart();
+    _deadbands(deadband, deadbandScale);
+
+    for (t = 0U; t < trace->num; t++)
+    {
+        /* New integration period every second */
+        testSnapshot = trace->rms[t];
+        testSequence = (uint32_t)t + 1U;
+        testTimeMs = (uint64_t)t * 1000U;
+
+        if ((mode == MODE_SUBSCRIBE) && (t == 0U))
+        {
+            _headEndSubscribe(mask, periodS, deadband);
+        }
+
+        if ((t % periodS) == 0U)
+        {
+            if (mode == MODE_POLL)
+            {
+                request[0] = APP_UDP_METROLOGY_MSG_DATA_REQUEST;
+                _headEndSend(request, 1U);
+            }
+            else if (mode == MODE_COMPACT)
+            {
+                request[0] = APP_UDP_METROLOGY_MSG_COMPACT_DATA_REQUEST;
+                (void) memcpy(&request[1], &mask, sizeof(mask));
+                _headEndSend(request, 5U);
+            }
+        }
+
+        APP_UDP_METROLOGY_Tasks();
+
+        if ((mode == MODE_SUBSCRIBE) && ((t % periodS) == 0U))
+        {
+            _headEndCheck(t);
+        }
+    }
+
+    if (mode == MODE_SUBSCRIBE)
+    {
+        unsigned long updates = testHeadEnd.updates;
+
+        /* No updates after unsubscribing */
+        request[0] = APP_UDP_METROLOGY_MSG_UNSUBSCRIBE_REQUEST;
+        _headEndSend(request, 1U);
+        testHeadEnd.subscribed = false;
+        for (t = 0U; t < (3U * periodS); t++)
+        {
+            testTimeMs += 1000U;
+            APP_UDP_METROLOGY_Tasks();
+        }
+
+        if ((testHeadEnd.updates != updates) || (app_udp_metrologyData.updateSocket != INVALID_SOCKET))
+        {
+            printf("FAIL: data updates after unsubscribing\n");
+            testErrors++;
+        }
+    }
+
+    *pResult = testTraffic;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    TEST_TRACE trace = {NULL, 0U};
+    TEST_TRAFFIC traffic[MODE_NUM];
+    unsigned long seconds = TEST_DEFAULT_SECONDS;
+    unsigned long periodS = 1U;
+    double deadbandScale = 1.0;
+    int nErrors = 0;
+    int arg, mode;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((strcmp(argv[arg], "-s") == 0) && ((arg + 1) < argc))
+        {
+            seconds = strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((strcmp(argv[arg], "-p") == 0) && ((arg + 1) < argc))
+        {
+            periodS = strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((strcmp(argv[arg], "-d") == 0) && ((arg + 1) < argc))
+        {
+            deadbandScale = strtod(argv[++arg], NULL);
+        }
+        else
+        {
+            nErrors += _traceRead(&trace, argv[arg]);
+        }
+    }
+
+    if ((periodS < APP_UDP_METROLOGY_PERIOD_MIN_S) || (periodS > APP_UDP_METROLOGY_PERIOD_MAX_S))
+    {
+        printf("FAIL: period out of range\n");
+        return 1;
+    }
+
+    if (trace.rms == NULL)
+    {
+        _traceGenerate(&trace, seconds);
+    }
+
+    if (nErrors == 0)
+    {
+        for (mode = 0; mode < MODE_NUM; mode++)
+        {
+            _replay((TEST_MODE)mode, &trace, (uint16_t)periodS, deadbandScale, &traffic[mode]);
+        }
+
+        printf("replay: %zu snapshots, period %lu s, deadband scale %.2f\n", trace.num, periodS, deadbandScale);
+        for (mode = 0; mode < MODE_NUM; mode++)
+        {
+            printf("  %-26s up %8lu bytes in %6lu datagrams, down %7lu bytes, up bytes %6.1f%% of poll\n",
+                    modeNames[mode], traffic[mode].upBytes, traffic[mode].upDatagrams, traffic[mode].downBytes,
+                    (100.0 * (double)traffic[mode].upBytes) / (double)traffic[MODE_POLL].upBytes);
+        }
+        printf("  %lu data updates, %lu full\n", (unsigned long)testHeadEnd.updates, (unsigned long)testHeadEnd.fullUpdates);
+    }
+
+    free(trace.rms);
+    nErrors += (testErrors > 0U) ? 1 : 0;
+    printf("%s\n", (nErrors == 0) ? "PASS" : "FAIL");
+    return (nErrors == 0) ? 0 : 1;
+}
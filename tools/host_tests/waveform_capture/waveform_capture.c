@@ -0,0 +1,689 @@
+/*******************************************************************************
+  Waveform capture compression round-trip test
+
+  File Name:
+    waveform_capture.c
+
+  Summary:
+    Host test of the triggered waveform capture of the metrology application.
+
+  Description:
+    app_metrology.c of the G3 metering demo is built for the host with the
+    capture API of the metrology driver replaced by a model of the capture
+    buffer: every millisecond of test time writes the samples of the selected
+    channels to the circular buffer, as the metrology core does. The samples
+    are 50 Hz waveforms with harmonics and noise, computed from the index of
+    the sample, so the test knows every sample ever captured.
+
+    For every case (source, channels, amplitude) the capture is started and
+    triggered at random times, with the waveform task run every millisecond.
+    The chunks of each compressed window are read with
+    APP_METROLOGY_GetWaveformChunk and decoded one by one; the decoded
+    samples must be the captured ones, from preSamples before the trigger.
+    The test also checks the pre-trigger samples of a trigger right after
+    the start, the truncation of a window that does not compress, sag event
+    triggers and that a window overwritten before it is compressed is counted
+    as lost. It then prints the compression ratio of each case and the time
+    to compress a window.
+
+    Usage:
+      waveform_capture [windows]      windows per case (20 by default)
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "app_metrology.c"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define TEST_DEFAULT_WINDOWS    20U
+#define TEST_MAX_FAILS_SHOWN    10U
+#define TEST_BENCHMARK_WINDOWS  2000U
+
+typedef struct
+{
+    const char *name;
+    uint8_t channels;
+    DRV_METROLOGY_CAPTURE_SOURCE source;
+    /* Peak of the fundamental, in LSB of the capture format */
+    double amplitude;
+    /* Peak of the uniform noise, in LSB */
+    double noise;
+    /* Whole window fits in the compressed buffer */
+    bool complete;
+} TEST_CASE;
+
+/* Model of the capture buffer of the metrology core */
+typedef struct
+{
+    uint32_t buffer[DRV_METROLOGY_CAPTURE_BUF_SIZE];
+    uint32_t offset;
+    bool wrapped;
+    bool enabled;
+    uint8_t channels;
+    uint8_t channelId[APP_METROLOGY_WAVEFORM_MAX_CHANNELS];
+    uint8_t numChannels;
+    uint32_t samplesPerMs;
+    /* Samples per channel captured since the start */
+    uint64_t numSamples;
+    double amplitude;
+    double noise;
+    /* Index of the first sample of a sag, and its depth */
+    uint64_t sagSample;
+    double sagDepth;
+} TEST_CAPTURE;
+
+DRV_METROLOGY_INIT drvMetrologyInitData;
+SYSTEM_OBJECTS sysObj;
+
+static TEST_CAPTURE testCapture;
+static DRV_METROLOGY_AFE_EVENTS testEvents;
+static uint64_t testTimeMs;
+static unsigned long testErrors;
+static uint64_t testRandState = 0x9E3779B97F4A7C15ULL;
+
+static const TEST_CASE testCases[] = {
+    {"16 kHz, 6 ch, 24 bit", DRV_METROLOGY_CAPTURE_CH_MASK, CAPTURE_SOURCE_16KHZ, 8388608.0, 64.0, true},
+    {"16 kHz, VA, full scale", DRV_METROLOGY_CAPTURE_CH_VA, CAPTURE_SOURCE_16KHZ, 1000000000.0, 4096.0, true},
+    {"4 kHz FBW, VA VB VC", DRV_METROLOGY_CAPTURE_CH_VA | DRV_METROLOGY_CAPTURE_CH_VB | DRV_METROLOGY_CAPTURE_CH_VC,
+            CAPTURE_SOURCE_4KHZ_FBW, 400000000.0, 1024.0, true},
+    {"4 kHz NBW, IA VA", DRV_METROLOGY_CAPTURE_CH_IA | DRV_METROLOGY_CAPTURE_CH_VA, CAPTURE_SOURCE_4KHZ_NBW,
+            400000000.0, 0.0, true},
+    {"16 kHz, 6 ch, noise", DRV_METROLOGY_CAPTURE_CH_MASK, CAPTURE_SOURCE_16KHZ, 0.0, 2147483647.0, false},
+};
+
+#define TEST_CASES_NUM          (sizeof(testCases) / sizeof(testCases[0]))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Metrology Driver, Application and System Stubs
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _hash(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* Sample of a channel, from its index since the start of the capture */
+static uint32_t _sample(uint64_t n, uint8_t channelId)
+{
+    double fs = (double)testCapture.samplesPerMs * 1000.0;
+    double w = (2.0 * M_PI * 50.0 * (double)n) / fs;
+    double phase = (2.0 * M_PI * (double)(channelId >> 1)) / 3.0;
+    double amplitude = testCapture.amplitude;
+    double value, noise;
+
+    if ((channelId & 1U) == 0U)
+    {
+        /* Current: lower, lagging and with more harmonics */
+        amplitude *= 0.3;
+        phase += 0.5;
+        value = sin(w - phase) + (0.1 * sin((3.0 * w) - phase)) + (0.05 * sin((5.0 * w) - phase));
+    }
+    else
+    {
+        value = sin(w - phase) + (0.02 * sin((3.0 * w) - phase));
+    }
+
+    if (n >= testCapture.sagSample)
+    {
+        value *= testCapture.sagDepth;
+    }
+
+    noise = testCapture.noise * (((double)(_hash((n << 3) | channelId) >> 11) / 4503599627370496.0) - 1.0);
+
+    return (uint32_t)(int32_t)llround((amplitude * value) + noise);
+}
+
+void DRV_METROLOGY_StartCapture(uint8_t channels, DRV_METROLOGY_CAPTURE_SOURCE source)
+{
+    uint8_t index;
+
+    testCapture.channels = channels;
+    testCapture.numChannels = 0;
+    for (index = 0; index < APP_METROLOGY_WAVEFORM_MAX_CHANNELS; index++)
+    {
+        if ((channels & (1U << index)) != 0U)
+        {
+            testCapture.channelId[testCapture.numChannels++] = index;
+        }
+    }
+
+    testCapture.samplesPerMs = (source == CAPTURE_SOURCE_16KHZ) ? 16U : 4U;
+    testCapture.offset = 0;
+    testCapture.wrapped = false;
+    testCapture.numSamples = 0;
+    testCapture.enabled = true;
+}
+
+void DRV_METROLOGY_StopCapture(void)
+{
+    testCapture.enabled = false;
+}
+
+uint32_t DRV_METROLOGY_GetCaptureOffset(bool * wrapped)
+{
+    if (wrapped != NULL)
+    {
+        *wrapped = testCapture.wrapped;
+    }
+
+    return testCapture.offset;
+}
+
+uint32_t DRV_METROLOGY_GetCaptureBufferSize(void)
+{
+    return DRV_METROLOGY_CAPTURE_BUF_SIZE;
+}
+
+uint32_t DRV_METROLOGY_GetCaptureData(uint32_t offset, uint32_t * pData, uint32_t numWords)
+{
+    uint32_t index;
+
+    for (index = 0; index < numWords; index++)
+    {
+        pData[index] = testCapture.buffer[(offset + index) % DRV_METROLOGY_CAPTURE_BUF_SIZE];
+    }
+
+    return numWords;
+}
+
+void DRV_METROLOGY_GetEventsData(DRV_METROLOGY_AFE_EVENTS * events)
+{
+    *events = testEvents;
+}
+
+DRV_METROLOGY_RESULT DRV_METROLOGY_CalibrationCallbackRegister(DRV_METROLOGY_CALIBRATION_CALLBACK callback) { return DRV_METROLOGY_SUCCESS; }
+DRV_METROLOGY_RESULT DRV_METROLOGY_Close(void) { return DRV_METROLOGY_SUCCESS; }
+DRV_METROLOGY_REGS_ACCUMULATORS * DRV_METROLOGY_GetAccData(void) { return NULL; }
+DRV_METROLOGY_CALIBRATION_REFS * DRV_METROLOGY_GetCalibrationReferences(void) { return NULL; }
+DRV_METROLOGY_REGS_CONTROL * DRV_METROLOGY_GetControlByDefault(void) { return NULL; }
+DRV_METROLOGY_REGS_CONTROL * DRV_METROLOGY_GetControlData(void) { return NULL; }
+uint32_t DRV_METROLOGY_GetEnergyValue(bool restartEnergy) { return 0; }
+DRV_METROLOGY_REGS_HARMONICS * DRV_METROLOGY_GetHarData(void) { return NULL; }
+DRV_METROLOGY_RMS_SIGN DRV_METROLOGY_GetRMSSign(DRV_METROLOGY_RMS_TYPE type) { return RMS_SIGN_POSITIVE; }
+uint32_t DRV_METROLOGY_GetRMSValue(DRV_METROLOGY_RMS_TYPE type) { return 0; }
+bool DRV_METROLOGY_GetSnapshot(DRV_METROLOGY_SNAPSHOT * snapshot) { return false; }
+DRV_METROLOGY_STATUS DRV_METROLOGY_GetStatus(void) { return DRV_METROLOGY_STATUS_READY; }
+DRV_METROLOGY_REGS_STATUS * DRV_METROLOGY_GetStatusData(void) { return NULL; }
+DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicAnalysisCallbackRegister(DRV_METROLOGY_HARMONICS_CALLBACK callback) { return DRV_METROLOGY_SUCCESS; }
+DRV_METROLOGY_RESULT DRV_METROLOGY_HarmonicBatchCallbackRegister(DRV_METROLOGY_HARMONICS_BATCH_CALLBACK callback) { return DRV_METROLOGY_SUCCESS; }
+DRV_METROLOGY_RESULT DRV_METROLOGY_IntegrationCallbackRegister(DRV_METROLOGY_CALLBACK callback) { return DRV_METROLOGY_SUCCESS; }
+DRV_METROLOGY_RESULT DRV_METROLOGY_Open(DRV_METROLOGY_START_MODE mode, DRV_METROLOGY_REGS_CONTROL * pConfiguration) { return DRV_METROLOGY_SUCCESS; }
+SYS_MODULE_OBJ DRV_METROLOGY_Reinitialize(SYS_MODULE_INIT * init) { return SYS_MODULE_OBJ_INVALID; }
+void DRV_METROLOGY_SetConfiguration(DRV_METROLOGY_CONFIGURATION * config) {}
+void DRV_METROLOGY_SetControl(DRV_METROLOGY_REGS_CONTROL * pControl) {}
+DRV_METROLOGY_RESULT DRV_METROLOGY_Start(void) { return DRV_METROLOGY_SUCCESS; }
+void DRV_METROLOGY_StartCalibration(void) {}
+void DRV_METROLOGY_StartHarmonicAnalysis(uint8_t harmonicNum, DRV_METROLOGY_HARMONICS_RMS *pHarmonicResponse) {}
+DRV_METROLOGY_RESULT DRV_METROLOGY_StartHarmonicAnalysisBatch(uint64_t harmonicBitmap, DRV_METROLOGY_HARMONICS_RMS *pHarmonicTable,
+        uint8_t tableSize, DRV_METROLOGY_HARMONICS_THD *pThd) { return DRV_METROLOGY_ERROR; }
+
+APP_DATALOG_STATES APP_DATALOG_GetStatus(void) { return APP_DATALOG_STATE_READY; }
+bool APP_DATALOG_FileExists(APP_DATALOG_USER userId, APP_DATALOG_DATE *date) { return false; }
+bool APP_DATALOG_SendDatalogData(APP_DATALOG_QUEUE_DATA *datalogData) { return true; }
+bool APP_ENERGY_SendEnergyData(APP_ENERGY_QUEUE_DATA *energyData) { return true; }
+bool APP_EVENTS_SendEventsData(APP_EVENTS_QUEUE_DATA *eventsData) { return true; }
+
+RSTC_RESET_CAUSE RSTC_ResetCauseGet(void) { return (RSTC_RESET_CAUSE)0; }
+void RTC_TimeGet(struct tm *sysTime) { (void) memset(sysTime, 0, sizeof(*sysTime)); }
+void SUPC_BackupModeEnter(void) {}
+void SYS_CMD_MESSAGE(const char* message) {}
+
+uint64_t SYS_TIME_Counter64Get(void) { return testTimeMs; }
+uint32_t SYS_TIME_MSToCount(uint32_t ms) { return ms; }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t _rand(uint32_t range)
+{
+    testRandState ^= testRandState >> 12;
+    testRandState ^= testRandState << 25;
+    testRandState ^= testRandState >> 27;
+    return (uint32_t)(((testRandState * 0x2545F4914F6CDD1DULL) >> 32) % range);
+}
+
+static void _fail(const char *name, const char *message, unsigned long value)
+{
+    if (testErrors < TEST_MAX_FAILS_SHOWN)
+    {
+        printf("FAIL: %s: %s (%lu)\n", name, message, value);
+    }
+    testErrors++;
+}
+
+/* Test time goes on: the metrology core writes the samples of every
+ * millisecond, and the metrology task runs */
+static void _advance(uint32_t ms, bool runTasks)
+{
+    uint32_t sample;
+    uint8_t channel;
+
+    while (ms-- > 0U)
+    {
+        testTimeMs++;
+        if (testCapture.enabled == false)
+        {
+            continue;
+        }
+
+        for (sample = 0; sample < testCapture.samplesPerMs; sample++)
+        {
+            for (channel = 0; channel < testCapture.numChannels; channel++)
+            {
+                testCapture.buffer[testCapture.offset++] = _sample(testCapture.numSamples,
+                        testCapture.channelId[channel]);
+                if (testCapture.offset == DRV_METROLOGY_CAPTURE_BUF_SIZE)
+                {
+                    testCapture.offset = 0;
+                    testCapture.wrapped = true;
+                }
+            }
+            testCapture.numSamples++;
+        }
+
+        if (runTasks)
+        {
+            _APP_METROLOGY_CheckWaveformEvents();
+            _APP_METROLOGY_WaveformTasks();
+        }
+    }
+}
+
+static uint8_t _getVarint(const uint8_t *pData, uint16_t length, uint32_t *pValue)
+{
+    uint32_t value = 0;
+    uint8_t index = 0;
+
+    do
+    {
+        if ((index >= length) || (index >= 5U))
+        {
+            return 0;
+        }
+        value |= (uint32_t)(pData[index] & 0x7FU) << (7U * index);
+    } while ((pData[index++] & 0x80U) != 0U);
+
+    *pValue = value;
+    return index;
+}
+
+/* Decodes one chunk into the window, returns the samples per channel in it */
+static uint16_t _decodeChunk(const uint8_t *pData, uint16_t length, uint8_t numChannels,
+        uint16_t numSamples, uint32_t *pWindow, uint16_t *pFirstSample)
+{
+    uint32_t value, residual, sample, prev1 = 0, prev2 = 0;
+    uint16_t first, index, blockSamples, pos = 2;
+    uint16_t samples = 0;
+    uint8_t channel, n;
+
+    if (length < 2U)
+    {
+        return 0;
+    }
+
+    (void) memcpy(&first, pData, sizeof(first));
+    *pFirstSample = first;
+
+    while ((pos < length) && ((first + samples) < numSamples))
+    {
+        blockSamples = numSamples - (first + samples);
+        if (blockSamples > APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES)
+        {
+            blockSamples = APP_METROLOGY_WAVEFORM_BLOCK_SAMPLES;
+        }
+
+        for (channel = 0; channel < numChannels; channel++)
+        {
+            for (index = 0; index < blockSamples; index++)
+            {
+                n = _getVarint(&pData[pos], length - pos, &value);
+                if (n == 0U)
+                {
+                    return 0;
+                }
+                pos += n;
+
+                residual = (value >> 1) ^ (0U - (value & 1U));
+                if (index == 0U)
+                {
+                    sample = residual;
+                    prev2 = sample;
+                }
+                else
+                {
+                    sample = residual + (2U * prev1) - prev2;
+                    prev2 = prev1;
+                }
+                prev1 = sample;
+
+                pWindow[((uint32_t)(first + samples + index) * numChannels) + channel] = sample;
+            }
+        }
+
+        samples += blockSamples;
+    }
+
+    return (pos == length) ? samples : 0;
+}
+
+/* Reads and decodes the last window, and compares it with the samples from
+ * triggerSample - preSamples. Returns the compressed size */
+static uint32_t _checkWindow(const char *name, uint64_t triggerSample, uint16_t expectedPre)
+{
+    static uint32_t window[(APP_METROLOGY_WAVEFORM_PRE_SAMPLES + APP_METROLOGY_WAVEFORM_POST_SAMPLES) *
+            APP_METROLOGY_WAVEFORM_MAX_CHANNELS];
+    static uint8_t chunk[APP_METROLOGY_WAVEFORM_CHUNK_SIZE];
+    APP_METROLOGY_WAVEFORM_INFO info;
+    uint32_t compressedSize = 0;
+    uint16_t chunkIndex, length, firstSample, samples;
+    uint16_t decoded = 0;
+    uint16_t index;
+    uint8_t channel;
+
+    APP_METROLOGY_GetWaveformInfo(&info);
+    if (info.captureId == 0U)
+    {
+        _fail(name, "no window", 0);
+        return 0;
+    }
+
+    if ((info.preSamples != expectedPre) || (info.channels != testCapture.channels) ||
+            (info.numSamples > (expectedPre + APP_METROLOGY_WAVEFORM_POST_SAMPLES)))
+    {
+        _fail(name, "window info", info.numSamples);
+        return 0;
+    }
+
+    for (chunkIndex = 0; chunkIndex < info.numChunks; chunkIndex++)
+    {
+        length = APP_METROLOGY_GetWaveformChunk(info.captureId, chunkIndex, chunk, sizeof(chunk));
+        if ((length == 0U) || (length > APP_METROLOGY_WAVEFORM_CHUNK_SIZE))
+        {
+            _fail(name, "chunk not read", chunkIndex);
+            return 0;
+        }
+
+        /* Chunks are decoded alone, and follow each other */
+        samples = _decodeChunk(chunk, length, testCapture.numChannels, info.numSamples, window, &firstSample);
+        if ((samples == 0U) || (firstSample != decoded))
+        {
+            _fail(name, "chunk not decoded", chunkIndex);
+            return 0;
+        }
+
+        decoded += samples;
+        compressedSize += length;
+    }
+
+    if (APP_METROLOGY_GetWaveformChunk(info.captureId, info.numChunks, chunk, sizeof(chunk)) != 0U)
+    {
+        _fail(name, "chunk read past the window", info.numChunks);
+    }
+
+    if (APP_METROLOGY_GetWaveformChunk(info.captureId + 1U, 0, chunk, sizeof(chunk)) != 0U)
+    {
+        _fail(name, "chunk of another window read", info.captureId + 1U);
+    }
+
+    if (decoded != info.numSamples)
+    {
+        _fail(name, "samples in the chunks", decoded);
+        return 0;
+    }
+
+    for (index = 0; index < info.numSamples; index++)
+    {
+        for (channel = 0; channel < testCapture.numChannels; channel++)
+        {
+            if (window[((uint32_t)index * testCapture.numChannels) + channel] !=
+                    _sample(triggerSample - info.preSamples + index, testCapture.channelId[channel]))
+            {
+                _fail(name, "decoded sample differs", index);
+                return 0;
+            }
+        }
+    }
+
+    return compressedSize;
+}
+
+/* Triggers a window after some milliseconds, and waits for it to be
+ * compressed. Returns the sample index of the trigger */
+static uint64_t _triggerWindow(uint32_t delayMs)
+{
+    uint64_t triggerSample = 0;
+
+    _advance(delayMs, true);
+    (void) APP_METROLOGY_TriggerWaveformCapture();
+
+    /* The task takes the trigger on its next run */
+    triggerSample = testCapture.numSamples + testCapture.samplesPerMs;
+    _advance(1, true);
+    if (app_metrologyData.waveform.state != APP_METROLOGY_WAVEFORM_TRIGGERED)
+    {
+        return 0;
+    }
+
+    while (app_metrologyData.waveform.state == APP_METROLOGY_WAVEFORM_TRIGGERED)
+    {
+        _advance(1, true);
+    }
+
+    return triggerSample;
+}
+
+static void _startCase(const TEST_CASE *pCase, bool eventTrigger)
+{
+    testCapture.amplitude = pCase->amplitude;
+    testCapture.noise = pCase->noise;
+    testCapture.sagSample = UINT64_MAX;
+    testCapture.sagDepth = 1.0;
+    (void) memset(&testEvents, 0, sizeof(testEvents));
+
+    if (APP_METROLOGY_StartWaveformCapture(pCase->channels, pCase->source, eventTrigger) == false)
+    {
+        _fail(pCase->name, "capture not started", pCase->channels);
+    }
+}
+
+static void _testCase(const TEST_CASE *pCase, uint32_t windows)
+{
+    APP_METROLOGY_WAVEFORM_INFO info;
+    uint64_t rawSize = 0, compressedSize = 0;
+    uint64_t triggerSample;
+    uint32_t window, size;
+    uint16_t preSamples;
+
+    _startCase(pCase, false);
+
+    /* Trigger before the pre-trigger samples are captured */
+    triggerSample = _triggerWindow(2);
+    preSamples = (uint16_t)triggerSample;
+    if (triggerSample == 0U)
+    {
+        _fail(pCase->name, "early trigger not taken", 0);
+    }
+    else
+    {
+        (void) _checkWindow(pCase->name, triggerSample, preSamples);
+    }
+
+    /* Triggers at random times, with windows across the end of the buffer */
+    for (window = 0; window < windows; window++)
+    {
+        triggerSample = _triggerWindow(1U + _rand(700U));
+        if (triggerSample == 0U)
+        {
+            _fail(pCase->name, "trigger not taken", window);
+            continue;
+        }
+
+        size = _checkWindow(pCase->name, triggerSample, APP_METROLOGY_WAVEFORM_PRE_SAMPLES);
+        APP_METROLOGY_GetWaveformInfo(&info);
+        compressedSize += size;
+        rawSize += (uint64_t)info.numSamples * testCapture.numChannels * sizeof(uint32_t);
+    }
+
+    APP_METROLOGY_GetWaveformInfo(&info);
+    printf("  %-24s ratio %.2f, %u of %u samples per window, %u lost\n", pCase->name,
+            (compressedSize != 0U) ? ((double)rawSize / (double)compressedSize) : 0.0,
+            info.numSamples, APP_METROLOGY_WAVEFORM_PRE_SAMPLES + APP_METROLOGY_WAVEFORM_POST_SAMPLES,
+            info.lostCount);
+
+    if (info.lostCount != 0U)
+    {
+        _fail(pCase->name, "windows lost", info.lostCount);
+    }
+
+    if ((info.numSamples == (APP_METROLOGY_WAVEFORM_PRE_SAMPLES + APP_METROLOGY_WAVEFORM_POST_SAMPLES)) !=
+            pCase->complete)
+    {
+        _fail(pCase->name, "window truncation", info.numSamples);
+    }
+
+    APP_METROLOGY_StopWaveformCapture();
+}
+
+static void _testEventTrigger(void)
+{
+    const TEST_CASE *pCase = &testCases[0];
+    uint64_t triggerSample;
+
+    _startCase(pCase, true);
+    _advance(500, true);
+
+    /* A sag starts: the metrology core flags it at the end of the cycle */
+    testCapture.sagSample = testCapture.numSamples;
+    testCapture.sagDepth = 0.6;
+    _advance(20, true);
+    testEvents.sagA = 1;
+    triggerSample = testCapture.numSamples + testCapture.samplesPerMs;
+    _advance(1, true);
+    if (app_metrologyData.waveform.state != APP_METROLOGY_WAVEFORM_TRIGGERED)
+    {
+        _fail("sag event", "trigger not taken", 0);
+    }
+    else
+    {
+        while (app_metrologyData.waveform.state == APP_METROLOGY_WAVEFORM_TRIGGERED)
+        {
+            _advance(1, true);
+        }
+        (void) _checkWindow("sag event", triggerSample, APP_METROLOGY_WAVEFORM_PRE_SAMPLES);
+    }
+
+    /* No new trigger while the event lasts */
+    _advance(100, true);
+    if (app_metrologyData.waveform.state != APP_METROLOGY_WAVEFORM_ARMED)
+    {
+        _fail("sag event", "trigger while the event lasts", 0);
+    }
+
+    APP_METROLOGY_StopWaveformCapture();
+}
+
+static void _testLostWindow(void)
+{
+    const TEST_CASE *pCase = &testCases[0];
+    APP_METROLOGY_WAVEFORM_INFO before, after;
+    uint32_t bufferMs;
+
+    _startCase(pCase, false);
+    (void) _triggerWindow(500);
+    APP_METROLOGY_GetWaveformInfo(&before);
+
+    /* The task does not run until the window has been overwritten */
+    (void) APP_METROLOGY_TriggerWaveformCapture();
+    _advance(1, true);
+    bufferMs = DRV_METROLOGY_CAPTURE_BUF_SIZE / (testCapture.numChannels * testCapture.samplesPerMs);
+    _advance(bufferMs, false);
+    _advance(1, true);
+
+    APP_METROLOGY_GetWaveformInfo(&after);
+    if ((after.lostCount != (before.lostCount + 1U)) || (after.captureId != before.captureId) ||
+            (app_metrologyData.waveform.state != APP_METROLOGY_WAVEFORM_ARMED))
+    {
+        _fail("lost window", "not counted", after.lostCount);
+    }
+
+    APP_METROLOGY_StopWaveformCapture();
+    if (APP_METROLOGY_TriggerWaveformCapture() != false)
+    {
+        _fail("stopped capture", "trigger accepted", 0);
+    }
+}
+
+static double _seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+static void _benchmark(void)
+{
+    uint32_t window;
+    double start, elapsed;
+
+    _startCase(&testCases[0], false);
+    (void) _triggerWindow(500);
+
+    start = _seconds();
+    for (window = 0; window < TEST_BENCHMARK_WINDOWS; window++)
+    {
+        _APP_METROLOGY_CompressWaveform();
+    }
+    elapsed = _seconds() - start;
+
+    printf("compression of a %s window: %.1f us\n", testCases[0].name,
+            (elapsed * 1e6) / (double)TEST_BENCHMARK_WINDOWS);
+
+    APP_METROLOGY_StopWaveformCapture();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main Entry Point
+// *****************************************************************************
+// *****************************************************************************
+
+int main(int argc, char **argv)
+{
+    uint32_t windows = TEST_DEFAULT_WINDOWS;
+    size_t index;
+
+    if (argc > 1)
+    {
+        windows = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    printf("waveform windows of %u + %u samples per channel, %u windows per case\n",
+            APP_METROLOGY_WAVEFORM_PRE_SAMPLES, APP_METROLOGY_WAVEFORM_POST_SAMPLES, windows);
+    for (index = 0; index < TEST_CASES_NUM; index++)
+    {
+        _testCase(&testCases[index], windows);
+    }
+
+    _testEventTrigger();
+    _testLostWindow();
+    _benchmark();
+
+    printf("%s\n", (testErrors == 0U) ? "PASS" : "FAIL");
+    return (testErrors == 0U) ? 0 : 1;
+}